@@ -0,0 +1,411 @@
+#include "SyntheticXFile.h"
+#include "BinaryXFileParser.h"
+#include "MszipDecoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace X2FBX {
+namespace Bench {
+
+namespace {
+
+const float IDENTITY[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+// Bones form a binary tree: bone i parents 2i+1 and 2i+2
+template <typename Visitor>
+void VisitChildren(size_t bone, size_t boneCount, Visitor&& visit) {
+    for (size_t child = 2 * bone + 1; child <= 2 * bone + 2 && child < boneCount; ++child) {
+        visit(child);
+    }
+}
+
+std::string BoneName(size_t bone) {
+    return "Bone" + std::to_string(bone);
+}
+
+float BoneTranslation(size_t bone) {
+    return bone == 0 ? 0.0f : 1.0f;
+}
+
+// Key values vary smoothly so keyframe reduction and interpolation see
+// motion rather than constants
+void RotationKey(size_t bone, size_t clip, size_t key, float out[4]) {
+    float angle = 0.05f * static_cast<float>(key) + 0.1f * static_cast<float>(bone + clip);
+    float halfAngle = 0.5f * std::sin(angle);
+    out[0] = std::cos(halfAngle);   // w first, as .x stores it
+    out[1] = 0.0f;
+    out[2] = std::sin(halfAngle);
+    out[3] = 0.0f;
+}
+
+void TranslationKey(size_t bone, size_t clip, size_t key, float out[3]) {
+    out[0] = BoneTranslation(bone);
+    out[1] = 0.1f * std::sin(0.03f * static_cast<float>(key) + static_cast<float>(clip));
+    out[2] = 0.0f;
+}
+
+uint32_t KeyTime(const SyntheticScale& scale, size_t key) {
+    return static_cast<uint32_t>(std::lround(key * scale.ticksPerSecond / scale.keysPerSecond));
+}
+
+class TextWriter {
+public:
+    std::string text;
+
+    void Line(const char* format, ...);
+};
+
+void TextWriter::Line(const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length > 0) {
+        text.append(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+    }
+    text += '\n';
+}
+
+void WriteTextMatrix(TextWriter& out, const float* m, float tx) {
+    out.Line("FrameTransformMatrix { %g, %g, %g, %g, %g, %g, %g, %g, %g, %g, %g, %g, %g, %g, %g, %g;; }",
+             m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11], tx, m[13], m[14], m[15]);
+}
+
+void WriteTextMesh(TextWriter& out, const SyntheticScale& scale) {
+    const size_t side = scale.GridSide();
+    const size_t vertexCount = side * side;
+    const size_t quads = (side - 1) * (side - 1);
+
+    out.Line("Mesh body {");
+    out.Line("%zu;", vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        out.Line("%.6f; %.6f; %.6f;%s", (v % side) * 0.1f, (v / side) * 0.1f, std::sin(v * 0.01f) * 0.1f,
+                 v + 1 < vertexCount ? "," : ";");
+    }
+    out.Line("%zu;", quads * 2);
+    for (size_t q = 0; q < quads; ++q) {
+        size_t v = (q / (side - 1)) * side + q % (side - 1);
+        out.Line("3; %zu, %zu, %zu;,", v, v + 1, v + side + 1);
+        out.Line("3; %zu, %zu, %zu;%s", v, v + side + 1, v + side, q + 1 < quads ? "," : ";");
+    }
+
+    out.Line("MeshTextureCoords {");
+    out.Line("%zu;", vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        out.Line("%.6f; %.6f;%s", static_cast<float>(v % side) / (side - 1), static_cast<float>(v / side) / (side - 1),
+                 v + 1 < vertexCount ? "," : ";");
+    }
+    out.Line("}");
+
+    // Every vertex is bound to one bone, round robin
+    for (size_t bone = 0; bone < scale.bones; ++bone) {
+        size_t influenced = vertexCount > bone ? (vertexCount - bone + scale.bones - 1) / scale.bones : 0;
+        if (influenced == 0) {
+            continue;
+        }
+        out.Line("SkinWeights {");
+        out.Line("\"%s\";", BoneName(bone).c_str());
+        out.Line("%zu;", influenced);
+        for (size_t i = 0, v = bone; v < vertexCount; ++i, v += scale.bones) {
+            out.Line("%zu%s", v, i + 1 < influenced ? "," : ";");
+        }
+        for (size_t i = 0; i < influenced; ++i) {
+            out.Line("1.0%s", i + 1 < influenced ? "," : ";");
+        }
+        out.Line("1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0;;");
+        out.Line("}");
+    }
+    out.Line("}");
+}
+
+void WriteTextFrame(TextWriter& out, const SyntheticScale& scale, size_t bone) {
+    out.Line("Frame %s {", BoneName(bone).c_str());
+    WriteTextMatrix(out, IDENTITY, BoneTranslation(bone));
+    if (bone == 0) {
+        WriteTextMesh(out, scale);
+    }
+    VisitChildren(bone, scale.bones, [&](size_t child) { WriteTextFrame(out, scale, child); });
+    out.Line("}");
+}
+
+// Writes binary .x tokens (little-endian, 32-bit floats)
+class BinaryWriter {
+public:
+    std::vector<uint8_t> bytes;
+
+    BinaryWriter() {
+        const std::string header = "xof 0303bin 0032";
+        bytes.assign(header.begin(), header.end());
+    }
+
+    void Token(uint16_t token) { Raw(&token, 2); }
+    void Name(const std::string& name) {
+        Token(BinaryXFileUtils::BINARY_TOKEN_NAME);
+        Count(name.size());
+        Raw(name.data(), name.size());
+    }
+    void String(const std::string& text) {
+        Token(BinaryXFileUtils::BINARY_TOKEN_STRING);
+        Count(text.size());
+        Raw(text.data(), text.size());
+        Token(BinaryXFileUtils::BINARY_TOKEN_SEMICOLON);
+    }
+    void Integers(const std::vector<uint32_t>& values) {
+        Token(BinaryXFileUtils::BINARY_TOKEN_INTEGER_LIST);
+        Count(values.size());
+        Raw(values.data(), values.size() * 4);
+    }
+    void Floats(const float* values, size_t count) {
+        Token(BinaryXFileUtils::BINARY_TOKEN_FLOAT_LIST);
+        Count(count);
+        Raw(values, count * 4);
+    }
+    void Floats(const std::vector<float>& values) { Floats(values.data(), values.size()); }
+    void Open(const std::string& type, const std::string& name = "") {
+        Name(type);
+        if (!name.empty()) Name(name);
+        Token(BinaryXFileUtils::BINARY_TOKEN_OBRACE);
+    }
+    void Close() { Token(BinaryXFileUtils::BINARY_TOKEN_CBRACE); }
+
+private:
+    void Count(size_t count) {
+        uint32_t value = static_cast<uint32_t>(count);
+        Raw(&value, 4);
+    }
+    void Raw(const void* data, size_t size) {
+        const uint8_t* begin = static_cast<const uint8_t*>(data);
+        bytes.insert(bytes.end(), begin, begin + size);
+    }
+};
+
+void WriteBinaryMesh(BinaryWriter& out, const SyntheticScale& scale) {
+    const size_t side = scale.GridSide();
+    const size_t vertexCount = side * side;
+    const size_t quads = (side - 1) * (side - 1);
+
+    out.Open("Mesh", "body");
+    out.Integers({static_cast<uint32_t>(vertexCount)});
+    std::vector<float> floats;
+    floats.reserve(vertexCount * 3);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        floats.insert(floats.end(), {(v % side) * 0.1f, (v / side) * 0.1f, std::sin(v * 0.01f) * 0.1f});
+    }
+    out.Floats(floats);
+
+    std::vector<uint32_t> faces;
+    faces.reserve(1 + quads * 8);
+    faces.push_back(static_cast<uint32_t>(quads * 2));
+    for (size_t q = 0; q < quads; ++q) {
+        uint32_t v = static_cast<uint32_t>((q / (side - 1)) * side + q % (side - 1));
+        uint32_t s = static_cast<uint32_t>(side);
+        faces.insert(faces.end(), {3, v, v + 1, v + s + 1, 3, v, v + s + 1, v + s});
+    }
+    out.Integers(faces);
+
+    out.Open("MeshTextureCoords");
+    out.Integers({static_cast<uint32_t>(vertexCount)});
+    floats.clear();
+    for (size_t v = 0; v < vertexCount; ++v) {
+        floats.insert(floats.end(), {static_cast<float>(v % side) / (side - 1), static_cast<float>(v / side) / (side - 1)});
+    }
+    out.Floats(floats);
+    out.Close();
+
+    for (size_t bone = 0; bone < scale.bones; ++bone) {
+        std::vector<uint32_t> indices(1, 0);
+        for (size_t v = bone; v < vertexCount; v += scale.bones) {
+            indices.push_back(static_cast<uint32_t>(v));
+        }
+        size_t influenced = indices.size() - 1;
+        if (influenced == 0) {
+            continue;
+        }
+        indices[0] = static_cast<uint32_t>(influenced);
+
+        out.Open("SkinWeights");
+        out.String(BoneName(bone));
+        out.Integers(indices);
+        floats.assign(influenced, 1.0f);
+        floats.insert(floats.end(), IDENTITY, IDENTITY + 16);
+        out.Floats(floats);
+        out.Close();
+    }
+    out.Close();
+}
+
+void WriteBinaryFrame(BinaryWriter& out, const SyntheticScale& scale, size_t bone) {
+    out.Open("Frame", BoneName(bone));
+    out.Open("FrameTransformMatrix");
+    float matrix[16];
+    std::copy(IDENTITY, IDENTITY + 16, matrix);
+    matrix[12] = BoneTranslation(bone);
+    out.Floats(matrix, 16);
+    out.Close();
+    if (bone == 0) {
+        WriteBinaryMesh(out, scale);
+    }
+    VisitChildren(bone, scale.bones, [&](size_t child) { WriteBinaryFrame(out, scale, child); });
+    out.Close();
+}
+
+} // namespace
+
+size_t SyntheticScale::GridSide() const {
+    size_t side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(std::max<size_t>(vertices, 4)))));
+    return std::max<size_t>(side, 2);
+}
+
+size_t SyntheticScale::KeysPerChannel() const {
+    return static_cast<size_t>(std::max(0.0f, clipSeconds * keysPerSecond)) + 1;
+}
+
+std::string GenerateTextXFile(const SyntheticScale& scale) {
+    TextWriter out;
+    out.text.reserve(scale.GridSide() * scale.GridSide() * 64 + scale.clips * scale.bones * scale.KeysPerChannel() * 64);
+    out.Line("xof 0303txt 0032");
+    out.Line("AnimTicksPerSecond { %u; }", scale.ticksPerSecond);
+    if (scale.bones > 0) {
+        WriteTextFrame(out, scale, 0);
+    } else {
+        WriteTextMesh(out, scale);
+    }
+
+    const size_t keys = scale.KeysPerChannel();
+    for (size_t clip = 0; clip < scale.clips; ++clip) {
+        out.Line("AnimationSet Clip%zu {", clip);
+        for (size_t bone = 0; bone < scale.bones; ++bone) {
+            out.Line("Animation {");
+            out.Line("{ %s }", BoneName(bone).c_str());
+            out.Line("AnimationKey {");
+            out.Line("0;");
+            out.Line("%zu;", keys);
+            for (size_t key = 0; key < keys; ++key) {
+                float q[4];
+                RotationKey(bone, clip, key, q);
+                out.Line("%u; 4; %.6f, %.6f, %.6f, %.6f;;%s", KeyTime(scale, key), q[0], q[1], q[2], q[3],
+                         key + 1 < keys ? "," : ";");
+            }
+            out.Line("}");
+            out.Line("AnimationKey {");
+            out.Line("2;");
+            out.Line("%zu;", keys);
+            for (size_t key = 0; key < keys; ++key) {
+                float t[3];
+                TranslationKey(bone, clip, key, t);
+                out.Line("%u; 3; %.6f, %.6f, %.6f;;%s", KeyTime(scale, key), t[0], t[1], t[2],
+                         key + 1 < keys ? "," : ";");
+            }
+            out.Line("}");
+            out.Line("}");
+        }
+        out.Line("}");
+    }
+    return std::move(out.text);
+}
+
+std::vector<uint8_t> GenerateBinaryXFile(const SyntheticScale& scale) {
+    BinaryWriter out;
+    out.Open("AnimTicksPerSecond");
+    out.Integers({scale.ticksPerSecond});
+    out.Close();
+    if (scale.bones > 0) {
+        WriteBinaryFrame(out, scale, 0);
+    } else {
+        WriteBinaryMesh(out, scale);
+    }
+
+    // Key lists interleave integers (time, value count) with float values
+    const size_t keys = scale.KeysPerChannel();
+    for (size_t clip = 0; clip < scale.clips; ++clip) {
+        out.Open("AnimationSet", "Clip" + std::to_string(clip));
+        for (size_t bone = 0; bone < scale.bones; ++bone) {
+            out.Open("Animation");
+            out.Token(BinaryXFileUtils::BINARY_TOKEN_OBRACE);
+            out.Name(BoneName(bone));
+            out.Token(BinaryXFileUtils::BINARY_TOKEN_CBRACE);
+
+            for (uint32_t keyType : {0u, 2u}) {
+                const uint32_t components = keyType == 0 ? 4 : 3;
+                out.Open("AnimationKey");
+                for (size_t key = 0; key < keys; ++key) {
+                    float values[4];
+                    if (keyType == 0) {
+                        RotationKey(bone, clip, key, values);
+                    } else {
+                        TranslationKey(bone, clip, key, values);
+                    }
+                    if (key == 0) {
+                        out.Integers({keyType, static_cast<uint32_t>(keys), KeyTime(scale, key), components});
+                    } else {
+                        out.Integers({KeyTime(scale, key), components});
+                    }
+                    out.Floats(values, components);
+                }
+                out.Close();
+            }
+            out.Close();
+        }
+        out.Close();
+    }
+    return std::move(out.bytes);
+}
+
+std::vector<uint8_t> CompressXFile(const std::vector<uint8_t>& file) {
+#ifdef HAVE_ZLIB
+    if (file.size() < 16) {
+        return {};
+    }
+    // "txt " becomes "tzip", "bin " becomes "bzip"
+    std::string header(file.begin(), file.begin() + 16);
+    header.replace(8, 4, header.compare(8, 3, "txt") == 0 ? "tzip" : "bzip");
+    std::vector<uint8_t> compressed(header.begin(), header.end());
+
+    const uint8_t* payload = file.data() + 16;
+    const size_t payloadSize = file.size() - 16;
+    uint32_t declaredSize = static_cast<uint32_t>(file.size());
+    compressed.insert(compressed.end(), reinterpret_cast<uint8_t*>(&declaredSize),
+                      reinterpret_cast<uint8_t*>(&declaredSize) + 4);
+
+    // 32 KB blocks, each deflated with the previous 32 KB as its dictionary
+    std::vector<uint8_t> block;
+    for (size_t offset = 0; offset < payloadSize; offset += Mszip::HISTORY_SIZE) {
+        size_t blockSize = std::min(Mszip::HISTORY_SIZE, payloadSize - offset);
+        size_t historySize = std::min(Mszip::HISTORY_SIZE, offset);
+
+        z_stream stream{};
+        deflateInit2(&stream, 6, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        if (historySize > 0) {
+            deflateSetDictionary(&stream, payload + offset - historySize, static_cast<uInt>(historySize));
+        }
+        block.resize(deflateBound(&stream, blockSize));
+        stream.next_in = const_cast<Bytef*>(payload + offset);
+        stream.avail_in = static_cast<uInt>(blockSize);
+        stream.next_out = block.data();
+        stream.avail_out = static_cast<uInt>(block.size());
+        deflate(&stream, Z_FINISH);
+        block.resize(stream.total_out);
+        deflateEnd(&stream);
+
+        uint16_t sizes[2] = {static_cast<uint16_t>(blockSize), static_cast<uint16_t>(block.size() + 2)};
+        compressed.insert(compressed.end(), reinterpret_cast<uint8_t*>(sizes), reinterpret_cast<uint8_t*>(sizes) + 4);
+        compressed.push_back('C');
+        compressed.push_back('K');
+        compressed.insert(compressed.end(), block.begin(), block.end());
+    }
+    return compressed;
+#else
+    (void)file;
+    return {};
+#endif
+}
+
+} // namespace Bench
+} // namespace X2FBX
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace X2FBX {
+namespace Bench {
+
+// Size of a generated scene: one skinned grid mesh under a bone tree, and
+// clips keying every bone's rotation and translation.
+struct SyntheticScale {
+    size_t vertices = 10000;          // Rounded up to a square grid
+    size_t bones = 32;
+    size_t clips = 4;
+    float clipSeconds = 2.0f;
+    float keysPerSecond = 30.0f;
+    uint32_t ticksPerSecond = 4800;
+
+    size_t GridSide() const;
+    size_t KeysPerChannel() const;
+};
+
+// The same scene as text, binary, and MSZIP-compressed binary or text
+std::string GenerateTextXFile(const SyntheticScale& scale);
+std::vector<uint8_t> GenerateBinaryXFile(const SyntheticScale& scale);
+
+// Compress a complete .x file (header included) the way D3DX writes
+// tzip/bzip files. Returns an empty vector when zlib is not compiled in.
+std::vector<uint8_t> CompressXFile(const std::vector<uint8_t>& file);
+
+} // namespace Bench
+} // namespace X2FBX
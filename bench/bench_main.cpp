@@ -0,0 +1,407 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Project headers
+#include "SyntheticXFile.h"
+#include "XFileParser.h"
+#include "BinaryXFileParser.h"
+#include "AnimationTimingCorrector.h"
+#include "FBXExporter.h"
+#include "Logger.h"
+#include "ProcessMemory.h"
+
+using namespace X2FBX;
+using namespace X2FBX::Bench;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct BenchOptions {
+    SyntheticScale scale;
+    size_t iterations = 5;
+    size_t decompressionWorkers = 1;
+    std::vector<std::string> stages;  // Empty runs every stage
+    std::string csvPath;
+    std::string jsonPath;
+    std::string baselinePath;         // CSV from an earlier run to compare against
+    double maxRegression = 0.10;      // Allowed MB/s drop against the baseline
+};
+
+struct StageResult {
+    std::string stage;
+    size_t iterations = 0;
+    uint64_t bytes = 0;               // Bytes processed per iteration
+    uint64_t items = 0;               // Stage-specific unit: vertices, keys or files
+    std::string itemName;
+    double bestMs = 0.0;
+    double meanMs = 0.0;
+    uint64_t peakRssKB = 0;           // Process peak after the stage
+
+    double MBPerSecond() const { return bestMs > 0.0 ? bytes / (1024.0 * 1024.0) / (bestMs / 1000.0) : 0.0; }
+    double ItemsPerSecond() const { return bestMs > 0.0 ? items / (bestMs / 1000.0) : 0.0; }
+};
+
+// One benchmark stage. setup runs untimed before every iteration; run is
+// timed and reports the bytes and items it processed.
+struct Stage {
+    std::string name;
+    std::string itemName;
+    std::function<void()> setup;
+    std::function<bool(uint64_t& bytes, uint64_t& items)> run;
+};
+
+bool RunStage(const Stage& stage, size_t iterations, StageResult& result) {
+    result.stage = stage.name;
+    result.itemName = stage.itemName;
+    result.iterations = iterations;
+
+    double totalMs = 0.0;
+    for (size_t i = 0; i <= iterations; ++i) {
+        if (stage.setup) {
+            stage.setup();
+        }
+        uint64_t bytes = 0;
+        uint64_t items = 0;
+        auto start = std::chrono::steady_clock::now();
+        bool ok = stage.run(bytes, items);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (!ok) {
+            std::cerr << "Stage " << stage.name << " failed" << std::endl;
+            return false;
+        }
+
+        // Iteration 0 warms caches and allocators and is not counted
+        if (i == 0) {
+            continue;
+        }
+        result.bytes = bytes;
+        result.items = items;
+        result.bestMs = i == 1 ? ms : std::min(result.bestMs, ms);
+        totalMs += ms;
+    }
+    result.meanMs = iterations > 0 ? totalMs / iterations : 0.0;
+    result.peakRssKB = ProcessMemory::GetPeakRssBytes() / 1024;
+    return true;
+}
+
+uint64_t DirectoryBytes(const fs::path& directory) {
+    uint64_t bytes = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file(ec)) {
+            bytes += entry.file_size(ec);
+        }
+    }
+    return bytes;
+}
+
+uint64_t CountKeys(const std::vector<XAnimationSet>& animations) {
+    uint64_t keys = 0;
+    for (const auto& animation : animations) {
+        keys += animation.GetKeyCount();
+    }
+    return keys;
+}
+
+const char* CSV_HEADER = "stage,iterations,bytes,items,item,best_ms,mean_ms,mb_per_s,items_per_s,peak_rss_kb";
+
+bool WriteCsv(const std::string& path, const std::vector<StageResult>& results) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot write " << path << std::endl;
+        return false;
+    }
+    out << std::fixed << std::setprecision(3);
+    out << CSV_HEADER << "\n";
+    for (const auto& r : results) {
+        out << r.stage << "," << r.iterations << "," << r.bytes << "," << r.items << "," << r.itemName << ","
+            << r.bestMs << "," << r.meanMs << "," << r.MBPerSecond() << "," << r.ItemsPerSecond() << ","
+            << r.peakRssKB << "\n";
+    }
+    return true;
+}
+
+bool WriteJson(const std::string& path, const BenchOptions& options, const std::vector<StageResult>& results) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot write " << path << std::endl;
+        return false;
+    }
+    const SyntheticScale& scale = options.scale;
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"scale\": {\"vertices\": " << scale.GridSide() * scale.GridSide() << ", \"bones\": " << scale.bones
+        << ", \"clips\": " << scale.clips << ", \"clipSeconds\": " << scale.clipSeconds
+        << ", \"keysPerSecond\": " << scale.keysPerSecond << ", \"ticksPerSecond\": " << scale.ticksPerSecond << "},\n";
+    out << "  \"iterations\": " << options.iterations << ",\n  \"stages\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const StageResult& r = results[i];
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"stage\": \"" << r.stage << "\", \"bytes\": " << r.bytes << ", \"items\": " << r.items
+            << ", \"item\": \"" << r.itemName << "\", \"bestMs\": " << r.bestMs << ", \"meanMs\": " << r.meanMs
+            << ", \"mbPerSecond\": " << r.MBPerSecond() << ", \"itemsPerSecond\": " << r.ItemsPerSecond()
+            << ", \"peakRssKB\": " << r.peakRssKB << "}";
+    }
+    out << "\n  ]\n}\n";
+    return true;
+}
+
+// Stage name -> MB/s from a CSV written by an earlier run
+std::map<std::string, double> ReadBaseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);   // Header
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields.size() >= 8) {
+            try {
+                baseline[fields[0]] = std::stod(fields[7]);
+            } catch (const std::exception&) {
+            }
+        }
+    }
+    return baseline;
+}
+
+// Returns the number of stages slower than the baseline allows
+int CompareWithBaseline(const BenchOptions& options, const std::vector<StageResult>& results) {
+    std::map<std::string, double> baseline = ReadBaseline(options.baselinePath);
+    if (baseline.empty()) {
+        std::cerr << "Warning: No baseline results in " << options.baselinePath << std::endl;
+        return 0;
+    }
+
+    int regressions = 0;
+    std::cout << std::endl << "Against baseline " << options.baselinePath << ":" << std::endl;
+    for (const auto& r : results) {
+        auto it = baseline.find(r.stage);
+        if (it == baseline.end() || it->second <= 0.0) {
+            continue;
+        }
+        double change = r.MBPerSecond() / it->second - 1.0;
+        bool regressed = change < -options.maxRegression;
+        regressions += regressed ? 1 : 0;
+        std::cout << "  " << (regressed ? "✗ " : "✓ ") << std::left << std::setw(18) << r.stage << std::right
+                  << std::showpos << std::setw(8) << change * 100.0 << std::noshowpos << "%" << std::endl;
+    }
+    return regressions;
+}
+
+void PrintUsage(const std::string& programName) {
+    std::cout << "Usage: " << programName << " [OPTIONS]" << std::endl << std::endl;
+    std::cout << "Benchmark the conversion stages on generated .x scenes" << std::endl << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --vertices <n>                Mesh vertices (default: 10000)" << std::endl;
+    std::cout << "  --bones <n>                   Bones in the skeleton (default: 32)" << std::endl;
+    std::cout << "  --clips <n>                   Animation clips (default: 4)" << std::endl;
+    std::cout << "  --seconds <s>                 Clip length in seconds (default: 2)" << std::endl;
+    std::cout << "  --keys-per-sec <n>            Keys per second on every channel (default: 30)" << std::endl;
+    std::cout << "  --iterations <n>              Timed iterations per stage (default: 5)" << std::endl;
+    std::cout << "  --decompression-workers <n>   Threads for MSZIP decoding (default: 1)" << std::endl;
+    std::cout << "  --stage <name>                Run only this stage; repeatable" << std::endl;
+    std::cout << "  --csv <file>                  Write results as CSV" << std::endl;
+    std::cout << "  --json <file>                 Write results as JSON" << std::endl;
+    std::cout << "  --baseline <file.csv>         Compare MB/s against an earlier CSV run" << std::endl;
+    std::cout << "  --max-regression <fraction>   Allowed MB/s drop before failing (default: 0.10)" << std::endl;
+    std::cout << std::endl << "Stages: text-parse, binary-parse, mszip-decompress, compressed-parse," << std::endl;
+    std::cout << "        timing-correct, export-static, export-clips" << std::endl;
+}
+
+bool ParseCommandLine(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&](const char* what) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: " << arg << " requires " << what << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        try {
+            if (arg == "--help" || arg == "-h") {
+                return false;
+            } else if (arg == "--vertices" || arg == "--bones" || arg == "--clips" || arg == "--iterations" ||
+                       arg == "--decompression-workers") {
+                const char* text = value("a number");
+                if (!text) return false;
+                size_t number = static_cast<size_t>(std::stoul(text));
+                if (arg == "--vertices") options.scale.vertices = number;
+                else if (arg == "--bones") options.scale.bones = number;
+                else if (arg == "--clips") options.scale.clips = number;
+                else if (arg == "--iterations") options.iterations = std::max<size_t>(number, 1);
+                else options.decompressionWorkers = number;
+            } else if (arg == "--seconds" || arg == "--keys-per-sec" || arg == "--max-regression") {
+                const char* text = value("a number");
+                if (!text) return false;
+                float number = std::stof(text);
+                if (number <= 0.0f && arg != "--max-regression") throw std::out_of_range("non-positive");
+                if (arg == "--seconds") options.scale.clipSeconds = number;
+                else if (arg == "--keys-per-sec") options.scale.keysPerSecond = number;
+                else options.maxRegression = number;
+            } else if (arg == "--stage") {
+                const char* text = value("a stage name");
+                if (!text) return false;
+                options.stages.push_back(text);
+            } else if (arg == "--csv" || arg == "--json" || arg == "--baseline") {
+                const char* text = value("a file path");
+                if (!text) return false;
+                (arg == "--csv" ? options.csvPath : arg == "--json" ? options.jsonPath : options.baselinePath) = text;
+            } else {
+                std::cerr << "Error: Unknown option: " << arg << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value for " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!ParseCommandLine(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // Stage log lines would dominate the timings; keep warnings only
+    Logger::Initialize("x2fbx_bench.log", LogLevel::WARNING);
+    Logger::GetInstance().EnableConsoleOutput(false);
+
+    const SyntheticScale& scale = options.scale;
+    std::cout << "Generating scene: " << scale.GridSide() * scale.GridSide() << " vertices, " << scale.bones
+              << " bones, " << scale.clips << " clips x " << scale.KeysPerChannel() << " keys" << std::endl;
+
+    const std::string text = GenerateTextXFile(scale);
+    const std::vector<uint8_t> binary = GenerateBinaryXFile(scale);
+    const std::vector<uint8_t> compressed = CompressXFile(binary);
+    std::cout << "  text " << text.size() / 1024 << " KB, binary " << binary.size() / 1024 << " KB, compressed "
+              << compressed.size() / 1024 << " KB" << std::endl;
+
+    // Parsed once for the stages that start from scene data
+    BinaryXFileParser sceneParser;
+    if (!sceneParser.ParseBinaryData(binary)) {
+        std::cerr << "Error: Generated binary scene does not parse" << std::endl;
+        return 1;
+    }
+    const XFileData scene = sceneParser.TakeParsedData();
+
+    const fs::path exportDirectory = fs::temp_directory_path() / "x2fbx-bench";
+    std::error_code ec;
+    fs::create_directories(exportDirectory, ec);
+
+    std::vector<XAnimationSet> animations;
+    AnimationTimingCorrector corrector;
+    FBXExporter exporter;
+    FBXExportOptions exportOptions;
+
+    std::vector<Stage> stages;
+    stages.push_back({"text-parse", "vertices", nullptr, [&](uint64_t& bytes, uint64_t& items) {
+        XFileParser parser;
+        parser.SetVerboseLogging(false);
+        bytes = text.size();
+        bool ok = parser.ParseFromString(text);
+        items = parser.GetParsedData().meshData.GetVertexCount();
+        return ok;
+    }});
+    stages.push_back({"binary-parse", "vertices", nullptr, [&](uint64_t& bytes, uint64_t& items) {
+        BinaryXFileParser parser;
+        bytes = binary.size();
+        bool ok = parser.ParseBinaryData(binary);
+        items = parser.GetParsedData().meshData.GetVertexCount();
+        return ok;
+    }});
+    if (!compressed.empty()) {
+        stages.push_back({"mszip-decompress", "blocks", nullptr, [&](uint64_t& bytes, uint64_t& items) {
+            XFileDecompressor decompressor;
+            std::vector<uint8_t> output;
+            bool ok = decompressor.DecompressMszip(ByteView(compressed).Subview(16), output,
+                                                   options.decompressionWorkers);
+            bytes = output.size();
+            items = (output.size() + 32767) / 32768;
+            return ok;
+        }});
+        stages.push_back({"compressed-parse", "vertices", nullptr, [&](uint64_t& bytes, uint64_t& items) {
+            BinaryXFileParser parser;
+            parser.SetDecompressionWorkers(options.decompressionWorkers);
+            bytes = compressed.size();
+            bool ok = parser.ParseCompressedData(compressed);
+            items = parser.GetParsedData().meshData.GetVertexCount();
+            return ok;
+        }});
+    }
+    stages.push_back({"timing-correct", "keys", [&]() { animations = scene.meshData.animations; },
+                      [&](uint64_t& bytes, uint64_t& items) {
+        bytes = 0;
+        for (const auto& animation : animations) {
+            bytes += animation.GetMemoryUsage();
+        }
+        items = CountKeys(animations);
+        corrector.CorrectAllAnimations(animations);
+        return true;
+    }});
+    stages.push_back({"export-static", "files", nullptr, [&](uint64_t& bytes, uint64_t& items) {
+        fs::path output = exportDirectory / "static.fbx";
+        FBXExportResult result = exporter.ExportStaticMesh(scene.meshData, output.string(), exportOptions);
+        bytes = fs::file_size(output, ec);
+        items = 1;
+        return result.success;
+    }});
+    stages.push_back({"export-clips", "files", nullptr, [&](uint64_t& bytes, uint64_t& items) {
+        std::vector<FBXExportResult> results =
+            exporter.ExportAllAnimations(scene.meshData, exportDirectory.string(), "clip", exportOptions);
+        items = results.size();
+        bytes = DirectoryBytes(exportDirectory);
+        return std::all_of(results.begin(), results.end(), [](const FBXExportResult& r) { return r.success; });
+    }});
+
+    std::vector<StageResult> results;
+    std::cout << std::endl << std::left << std::setw(18) << "stage" << std::right << std::setw(12) << "best ms"
+              << std::setw(12) << "MB/s" << std::setw(16) << "items/s" << std::setw(14) << "peak RSS KB" << std::endl;
+    for (const auto& stage : stages) {
+        if (!options.stages.empty() &&
+            std::find(options.stages.begin(), options.stages.end(), stage.name) == options.stages.end()) {
+            continue;
+        }
+        StageResult result;
+        if (!RunStage(stage, options.iterations, result)) {
+            fs::remove_all(exportDirectory, ec);
+            return 1;
+        }
+        std::cout << std::left << std::setw(18) << result.stage << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << result.bestMs << std::setw(12) << result.MBPerSecond() << std::setw(16)
+                  << std::setprecision(0) << result.ItemsPerSecond() << std::setw(14) << result.peakRssKB << std::endl;
+        results.push_back(result);
+    }
+    fs::remove_all(exportDirectory, ec);
+
+    if (!options.csvPath.empty() && !WriteCsv(options.csvPath, results)) {
+        return 1;
+    }
+    if (!options.jsonPath.empty() && !WriteJson(options.jsonPath, options, results)) {
+        return 1;
+    }
+    if (!options.baselinePath.empty() && CompareWithBaseline(options, results) > 0) {
+        std::cerr << "Throughput regression beyond " << options.maxRegression * 100.0 << "%" << std::endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,781 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_BZIP2
+#include <bzlib.h>
+#endif
+
+// Project headers
+#include "SyntheticXFile.h"
+#include "BinaryXFileParser.h"
+#include "ByteSource.h"
+#include "Logger.h"
+#include "MszipDecoder.h"
+#include "ProcessMemory.h"
+
+using namespace X2FBX;
+using namespace X2FBX::Bench;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct CorpusOptions {
+    SyntheticScale scale;
+    std::vector<std::string> corpusPaths;  // Files or directories of compressed .x files
+    bool synthetic = true;                 // Also generate one seed per codec
+    size_t mutations = 32;                 // Mutants per seed
+    uint64_t seed = 1;
+    std::vector<std::string> methods;      // Empty runs every method
+    double timeBudgetMs = 2000.0;
+    double memoryBudgetMB = 1024.0;
+    size_t decompressionWorkers = 4;
+    bool inProcess = false;                // No child processes; budgets are only checked afterwards
+    std::string csvPath;
+    std::string jsonPath;
+    std::string failureDirectory;          // Where inputs over budget are saved
+};
+
+// One input: a corpus file or generated seed, or a mutant of one
+struct CorpusCase {
+    std::string name;
+    std::string mutation;                  // "none" for the seed itself
+    std::vector<uint8_t> data;
+};
+
+// One decompressor as the parser reaches it; returns false when it rejects the input
+struct Method {
+    std::string name;
+    std::function<bool(ByteView input, uint64_t& outputBytes)> run;
+};
+
+enum class Outcome { OK, REJECTED, TIMEOUT, MEMORY, CRASH };
+
+const char* OutcomeName(Outcome outcome) {
+    switch (outcome) {
+        case Outcome::OK: return "ok";
+        case Outcome::REJECTED: return "rejected";
+        case Outcome::TIMEOUT: return "timeout";
+        case Outcome::MEMORY: return "memory";
+        case Outcome::CRASH: return "crash";
+    }
+    return "unknown";
+}
+
+bool IsViolation(Outcome outcome) {
+    return outcome == Outcome::TIMEOUT || outcome == Outcome::MEMORY || outcome == Outcome::CRASH;
+}
+
+struct CaseResult {
+    std::string method;
+    std::string input;
+    std::string mutation;
+    uint64_t inputBytes = 0;
+    Outcome outcome = Outcome::OK;
+    double ms = 0.0;
+    uint64_t outputBytes = 0;
+    uint64_t memoryKB = 0;                 // Peak resident growth while the case ran
+};
+
+struct MethodSummary {
+    std::string method;
+    size_t runs = 0;
+    size_t counts[5] = {};                 // Per Outcome
+    uint64_t okOutputBytes = 0;
+    double okMs = 0.0;
+    double totalMs = 0.0;
+    double worstMs = 0.0;
+    std::string worstCase;
+    uint64_t worstMemoryKB = 0;
+
+    double MBPerSecond() const { return okMs > 0.0 ? okOutputBytes / (1024.0 * 1024.0) / (okMs / 1000.0) : 0.0; }
+    double MeanMs() const { return runs > 0 ? totalMs / runs : 0.0; }
+};
+
+// The payload after the 16-byte header, for the MSZIP entry points
+ByteView MszipPayload(ByteView input) {
+    return input.size() >= 16 && input.StartsWith("xof ") ? input.Subview(16) : input;
+}
+
+std::vector<Method> BuildMethods(const CorpusOptions& options) {
+    std::vector<Method> methods;
+    if (InflateByteSource::IsAvailable()) {
+        methods.push_back({"mszip-stream", [](ByteView input, uint64_t& outputBytes) {
+            std::unique_ptr<ByteSource> stream = XFileDecompressor().OpenMszipStream(MszipPayload(input));
+            if (!stream) {
+                return false;
+            }
+            // Drained through a fixed buffer, as the parser does
+            uint8_t buffer[64 * 1024];
+            while (size_t read = stream->Read(buffer, sizeof(buffer))) {
+                outputBytes += read;
+            }
+            return !stream->HasError();
+        }});
+        methods.push_back({"mszip-parallel", [&options](ByteView input, uint64_t& outputBytes) {
+            std::vector<uint8_t> output;
+            bool ok = XFileDecompressor().DecompressMszip(MszipPayload(input), output, options.decompressionWorkers);
+            outputBytes = output.size();
+            return ok;
+        }});
+        methods.push_back({"zlib", [](ByteView input, uint64_t& outputBytes) {
+            std::vector<uint8_t> output;
+            bool ok = XFileDecompressor().DecompressZipped(input, output);
+            outputBytes = output.size();
+            return ok;
+        }});
+        methods.push_back({"raw-deflate", [](ByteView input, uint64_t& outputBytes) {
+            std::vector<uint8_t> output;
+            bool ok = XFileDecompressor().DecompressRawDeflate(input, output);
+            outputBytes = output.size();
+            return ok;
+        }});
+    }
+    if (Bzip2ByteSource::IsAvailable()) {
+        methods.push_back({"bzip2", [](ByteView input, uint64_t& outputBytes) {
+            std::vector<uint8_t> output;
+            bool ok = XFileDecompressor().DecompressBzip2(input, output);
+            outputBytes = output.size();
+            return ok;
+        }});
+    }
+    methods.push_back({"directx-lz", [](ByteView input, uint64_t& outputBytes) {
+        std::vector<uint8_t> output;
+        bool ok = XFileDecompressor().DecompressDirectXLZ(input, output);
+        outputBytes = output.size();
+        return ok;
+    }});
+    // The whole compressed-file path, format detection and fallbacks included
+    methods.push_back({"compressed-parse", [&options](ByteView input, uint64_t& outputBytes) {
+        BinaryXFileParser parser;
+        parser.SetDecompressionWorkers(options.decompressionWorkers);
+        // Counted in input bytes, like the compressed-parse bench stage
+        outputBytes = input.size();
+        return parser.ParseCompressedData(input);
+    }});
+
+    if (!options.methods.empty()) {
+        methods.erase(std::remove_if(methods.begin(), methods.end(), [&](const Method& method) {
+            return std::find(options.methods.begin(), options.methods.end(), method.name) == options.methods.end();
+        }), methods.end());
+    }
+    return methods;
+}
+
+// Generated seeds
+
+#ifdef HAVE_ZLIB
+std::vector<uint8_t> Deflate(const std::vector<uint8_t>& input, int windowBits) {
+    z_stream stream{};
+    deflateInit2(&stream, 6, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+    std::vector<uint8_t> output(deflateBound(&stream, input.size()));
+    stream.next_in = const_cast<Bytef*>(input.data());
+    stream.avail_in = static_cast<uInt>(input.size());
+    stream.next_out = output.data();
+    stream.avail_out = static_cast<uInt>(output.size());
+    deflate(&stream, Z_FINISH);
+    output.resize(stream.total_out);
+    deflateEnd(&stream);
+    return output;
+}
+#endif
+
+// The LZSS variant DecompressDirectXLZ reads: a 0x00038760 signature, then
+// flag bytes whose set bits mark literals and clear bits 16-bit matches of
+// a 12-bit offset and a 4-bit length
+std::vector<uint8_t> EncodeDirectXLZ(const std::vector<uint8_t>& input) {
+    std::vector<uint8_t> output = {0x60, 0x87, 0x03, 0x00};
+    std::vector<int64_t> lastSeen(1 << 16, -1);
+    size_t flagPosition = 0;
+    int bit = 8;
+    for (size_t i = 0; i < input.size();) {
+        if (bit == 8) {
+            flagPosition = output.size();
+            output.push_back(0);
+            bit = 0;
+        }
+        size_t length = 0;
+        size_t offset = 0;
+        if (i + 3 <= input.size()) {
+            uint32_t hash = (input[i] * 2654435761u ^ input[i + 1] * 40503u ^ input[i + 2]) & 0xFFFF;
+            int64_t candidate = lastSeen[hash];
+            lastSeen[hash] = static_cast<int64_t>(i);
+            if (candidate >= 0 && i - candidate <= 4096) {
+                while (length < 18 && i + length < input.size() && input[candidate + length] == input[i + length]) {
+                    length++;
+                }
+                offset = i - candidate;
+            }
+        }
+        if (length >= 3) {
+            uint16_t match = static_cast<uint16_t>(((offset - 1) << 4) | (length - 3));
+            output.push_back(static_cast<uint8_t>(match));
+            output.push_back(static_cast<uint8_t>(match >> 8));
+            i += length;
+        } else {
+            output[flagPosition] |= static_cast<uint8_t>(1 << bit);
+            output.push_back(input[i++]);
+        }
+        bit++;
+    }
+    return output;
+}
+
+std::vector<CorpusCase> GenerateSeeds(const SyntheticScale& scale) {
+    const std::string text = GenerateTextXFile(scale);
+    const std::vector<uint8_t> textFile(text.begin(), text.end());
+    const std::vector<uint8_t> binary = GenerateBinaryXFile(scale);
+
+    std::vector<CorpusCase> seeds;
+    auto add = [&](const char* name, std::vector<uint8_t> data) {
+        if (!data.empty()) {
+            seeds.push_back({std::string("synthetic:") + name, "none", std::move(data)});
+        }
+    };
+    add("bzip", CompressXFile(binary));
+    add("tzip", CompressXFile(textFile));
+#ifdef HAVE_ZLIB
+    add("zlib", Deflate(binary, 15));
+    add("deflate", Deflate(binary, -15));
+#endif
+#ifdef HAVE_BZIP2
+    std::vector<uint8_t> bzip2(binary.size() + binary.size() / 100 + 600);
+    unsigned int bzip2Size = static_cast<unsigned int>(bzip2.size());
+    if (BZ2_bzBuffToBuffCompress(reinterpret_cast<char*>(bzip2.data()), &bzip2Size,
+                                 const_cast<char*>(reinterpret_cast<const char*>(binary.data())),
+                                 static_cast<unsigned int>(binary.size()), 9, 0, 0) == BZ_OK) {
+        bzip2.resize(bzip2Size);
+        add("bzip2", std::move(bzip2));
+    }
+#endif
+    add("directx-lz", EncodeDirectXLZ(textFile));
+    return seeds;
+}
+
+bool LoadCorpus(const std::vector<std::string>& paths, std::vector<CorpusCase>& cases) {
+    for (const auto& path : paths) {
+        std::error_code ec;
+        std::vector<fs::path> files;
+        if (fs::is_directory(path, ec)) {
+            for (const auto& entry : fs::recursive_directory_iterator(path, ec)) {
+                if (entry.is_regular_file(ec)) {
+                    files.push_back(entry.path());
+                }
+            }
+            std::sort(files.begin(), files.end());
+        } else if (fs::is_regular_file(path, ec)) {
+            files.push_back(path);
+        } else {
+            std::cerr << "Error: Corpus path not found: " << path << std::endl;
+            return false;
+        }
+        for (const auto& file : files) {
+            std::ifstream in(file, std::ios::binary);
+            std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            cases.push_back({file.string(), "none", std::move(data)});
+        }
+    }
+    return true;
+}
+
+// Mutations aimed at what decompressors trust: single bits, boundary
+// bytes, length fields, truncation and repeated runs
+
+const char* MUTATIONS[] = {"bitflip", "bytes", "size-field", "truncate", "repeat", "zero-run"};
+constexpr size_t MUTATION_COUNT = sizeof(MUTATIONS) / sizeof(MUTATIONS[0]);
+
+CorpusCase Mutate(const CorpusCase& seed, size_t index, uint64_t baseSeed) {
+    std::mt19937_64 rng(baseSeed * 0x9E3779B97F4A7C15ull + std::hash<std::string>()(seed.name) + index);
+    auto below = [&](size_t limit) { return limit > 0 ? static_cast<size_t>(rng() % limit) : 0; };
+
+    CorpusCase mutant;
+    mutant.name = seed.name + "#" + std::to_string(index);
+    mutant.mutation = MUTATIONS[index % MUTATION_COUNT];
+    mutant.data = seed.data;
+    std::vector<uint8_t>& data = mutant.data;
+    if (data.empty()) {
+        return mutant;
+    }
+
+    // Past the 16-byte header when there is one, so the codecs see the damage
+    const size_t start = data.size() > 32 && seed.data[0] == 'x' ? 16 : 0;
+    const size_t span = data.size() - start;
+    switch (index % MUTATION_COUNT) {
+        case 0:
+            for (size_t flips = 1 + below(8); flips > 0; --flips) {
+                data[start + below(span)] ^= static_cast<uint8_t>(1u << below(8));
+            }
+            break;
+        case 1: {
+            const uint8_t boundary[] = {0x00, 0xFF, 0x7F, 0x80, 0x01};
+            for (size_t writes = 1 + below(4); writes > 0; --writes) {
+                data[start + below(span)] = below(3) == 0 ? static_cast<uint8_t>(rng()) : boundary[below(5)];
+            }
+            break;
+        }
+        case 2: {
+            // A 16- or 32-bit size: the declared MSZIP size is at 16, block
+            // headers follow; anywhere else it is simply a large value
+            size_t offset = below(3) == 0 && data.size() >= 20 ? 16 : start + below(span);
+            size_t width = std::min<size_t>(below(2) == 0 ? 2 : 4, data.size() - offset);
+            uint32_t value = below(2) == 0 ? 0xFFFFFFFFu : static_cast<uint32_t>(rng());
+            std::memcpy(data.data() + offset, &value, width);
+            break;
+        }
+        case 3:
+            data.resize(start + below(span));
+            break;
+        case 4: {
+            size_t from = start + below(span);
+            size_t length = std::min<size_t>(1 + below(4096), data.size() - from);
+            std::vector<uint8_t> chunk(data.begin() + from, data.begin() + from + length);
+            for (size_t copies = 1 + below(8); copies > 0; --copies) {
+                data.insert(data.begin() + from, chunk.begin(), chunk.end());
+            }
+            break;
+        }
+        default: {
+            size_t from = start + below(span);
+            size_t length = std::min<size_t>(1 + below(1024), data.size() - from);
+            std::fill(data.begin() + from, data.begin() + from + length, 0);
+            break;
+        }
+    }
+    return mutant;
+}
+
+// Running one case
+
+struct ChildReport {
+    int outcome;
+    double ms;
+    uint64_t outputBytes;
+};
+
+ChildReport RunCase(const Method& method, ByteView input) {
+    ChildReport report{static_cast<int>(Outcome::REJECTED), 0.0, 0};
+    auto start = std::chrono::steady_clock::now();
+    try {
+        if (method.run(input, report.outputBytes)) {
+            report.outcome = static_cast<int>(Outcome::OK);
+        }
+    } catch (const std::bad_alloc&) {
+        report.outcome = static_cast<int>(Outcome::MEMORY);
+    } catch (const std::exception&) {
+        report.outcome = static_cast<int>(Outcome::REJECTED);
+    }
+    report.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+void RunInProcess(const Method& method, const CorpusCase& input, const CorpusOptions& options, CaseResult& result) {
+    uint64_t peakBefore = ProcessMemory::GetPeakRssBytes();
+    ChildReport report = RunCase(method, input.data);
+    result.outcome = static_cast<Outcome>(report.outcome);
+    result.ms = report.ms;
+    result.outputBytes = report.outputBytes;
+
+    // Peak RSS only moves past the previous high-water mark, so growth is a lower bound
+    uint64_t peakAfter = ProcessMemory::GetPeakRssBytes();
+    result.memoryKB = peakAfter > peakBefore ? (peakAfter - peakBefore) / 1024 : 0;
+    if (result.outcome == Outcome::OK && result.ms > options.timeBudgetMs) {
+        result.outcome = Outcome::TIMEOUT;
+    } else if (result.outcome == Outcome::OK && result.memoryKB > options.memoryBudgetMB * 1024.0) {
+        result.outcome = Outcome::MEMORY;
+    }
+}
+
+#ifndef _WIN32
+// Address space of this process, or 0 where /proc is not available
+uint64_t GetVirtualBytes() {
+    std::ifstream statm("/proc/self/statm");
+    uint64_t pages = 0;
+    if (!(statm >> pages)) {
+        return 0;
+    }
+    return pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+// The case runs in a forked child, so a hang is killed at the time budget
+// and a runaway allocation fails against an address-space limit instead of
+// taking the runner down with it
+void RunIsolated(const Method& method, const CorpusCase& input, const CorpusOptions& options, CaseResult& result) {
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) {
+        RunInProcess(method, input, options, result);
+        return;
+    }
+    const uint64_t residentAtFork = ProcessMemory::GetCurrentRssBytes();
+    const uint64_t budgetBytes = static_cast<uint64_t>(options.memoryBudgetMB * 1024.0 * 1024.0);
+    const uint64_t addressLimit = GetVirtualBytes();
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        RunInProcess(method, input, options, result);
+        return;
+    }
+    if (pid == 0) {
+        close(pipeFds[0]);
+        if (addressLimit > 0) {
+            // Worker threads reserve their stacks up front; leave room for them
+            rlimit limit;
+            limit.rlim_cur = limit.rlim_max = addressLimit + budgetBytes + options.decompressionWorkers * (16u << 20);
+            setrlimit(RLIMIT_AS, &limit);
+        }
+        ChildReport report = RunCase(method, input.data);
+        ssize_t written = write(pipeFds[1], &report, sizeof(report));
+        _exit(written == sizeof(report) ? 0 : 1);
+    }
+    close(pipeFds[1]);
+
+    auto start = std::chrono::steady_clock::now();
+    int status = 0;
+    rusage usage{};
+    bool timedOut = false;
+    while (true) {
+        pid_t done = wait4(pid, &status, WNOHANG, &usage);
+        if (done == pid || done < 0) {
+            break;
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed > options.timeBudgetMs) {
+            kill(pid, SIGKILL);
+            wait4(pid, &status, 0, &usage);
+            timedOut = true;
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    ChildReport report{static_cast<int>(Outcome::CRASH), elapsed, 0};
+    bool reported = read(pipeFds[0], &report, sizeof(report)) == sizeof(report);
+    close(pipeFds[0]);
+
+#ifdef __APPLE__
+    uint64_t peakBytes = static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    uint64_t peakBytes = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+    result.memoryKB = peakBytes > residentAtFork ? (peakBytes - residentAtFork) / 1024 : 0;
+    result.outputBytes = report.outputBytes;
+    if (timedOut) {
+        result.outcome = Outcome::TIMEOUT;
+        result.ms = elapsed;
+    } else if (!reported || !WIFEXITED(status)) {
+        result.outcome = Outcome::CRASH;
+        result.ms = elapsed;
+    } else {
+        result.outcome = static_cast<Outcome>(report.outcome);
+        result.ms = report.ms;
+    }
+    if (result.outcome == Outcome::OK && result.memoryKB * 1024 > budgetBytes) {
+        result.outcome = Outcome::MEMORY;
+    }
+}
+#endif
+
+// Output
+
+const char* CSV_HEADER = "method,input,mutation,input_bytes,outcome,ms,output_bytes,memory_kb";
+
+std::string CsvField(const std::string& text) {
+    if (text.find_first_of(",\"") == std::string::npos) {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (char c : text) {
+        quoted += c == '"' ? "\"\"" : std::string(1, c);
+    }
+    return quoted + "\"";
+}
+
+std::string JsonString(const std::string& text) {
+    std::string escaped = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+bool WriteCsv(const std::string& path, const std::vector<CaseResult>& results) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot write " << path << std::endl;
+        return false;
+    }
+    out << std::fixed << std::setprecision(3);
+    out << CSV_HEADER << "\n";
+    for (const auto& r : results) {
+        out << r.method << "," << CsvField(r.input) << "," << r.mutation << "," << r.inputBytes << ","
+            << OutcomeName(r.outcome) << "," << r.ms << "," << r.outputBytes << "," << r.memoryKB << "\n";
+    }
+    return true;
+}
+
+bool WriteJson(const std::string& path, const CorpusOptions& options, const std::vector<MethodSummary>& summaries,
+               const std::vector<CaseResult>& results) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot write " << path << std::endl;
+        return false;
+    }
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"seed\": " << options.seed << ", \"mutations\": " << options.mutations
+        << ", \"timeBudgetMs\": " << options.timeBudgetMs << ", \"memoryBudgetMB\": " << options.memoryBudgetMB
+        << ",\n  \"methods\": [";
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        const MethodSummary& s = summaries[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"method\": \"" << s.method << "\", \"runs\": " << s.runs;
+        for (int outcome = 0; outcome < 5; ++outcome) {
+            out << ", \"" << OutcomeName(static_cast<Outcome>(outcome)) << "\": " << s.counts[outcome];
+        }
+        out << ", \"mbPerSecond\": " << s.MBPerSecond() << ", \"meanMs\": " << s.MeanMs()
+            << ", \"worstMs\": " << s.worstMs << ", \"worstCase\": " << JsonString(s.worstCase)
+            << ", \"worstMemoryKB\": " << s.worstMemoryKB << "}";
+    }
+    out << "\n  ],\n  \"violations\": [";
+    bool first = true;
+    for (const auto& r : results) {
+        if (!IsViolation(r.outcome)) {
+            continue;
+        }
+        out << (first ? "\n" : ",\n") << "    {\"method\": \"" << r.method << "\", \"input\": " << JsonString(r.input)
+            << ", \"mutation\": \"" << r.mutation << "\", \"outcome\": \"" << OutcomeName(r.outcome)
+            << "\", \"ms\": " << r.ms << ", \"memoryKB\": " << r.memoryKB << "}";
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+    return true;
+}
+
+void SaveFailure(const std::string& directory, const CaseResult& result, const CorpusCase& input) {
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    std::string name = fs::path(input.name).filename().string();
+    std::replace_if(name.begin(), name.end(), [](char c) { return c == ':' || c == '#'; }, '_');
+    fs::path path = fs::path(directory) / (result.method + "-" + OutcomeName(result.outcome) + "-" + name);
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(input.data.data()), static_cast<std::streamsize>(input.data.size()));
+}
+
+void PrintUsage(const std::string& programName) {
+    std::cout << "Usage: " << programName << " [OPTIONS]" << std::endl << std::endl;
+    std::cout << "Run every decompressor over compressed .x files and mutants of them, within time and" << std::endl;
+    std::cout << "memory budgets, and report throughput and worst-case latency per method" << std::endl << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --corpus <path>               File or directory of inputs; repeatable" << std::endl;
+    std::cout << "  --no-synthetic                Do not generate a seed per codec" << std::endl;
+    std::cout << "  --vertices <n>                Vertices in the generated seeds (default: 2000)" << std::endl;
+    std::cout << "  --mutations <n>               Mutants per seed (default: 32)" << std::endl;
+    std::cout << "  --seed <n>                    Mutation seed (default: 1)" << std::endl;
+    std::cout << "  --method <name>               Run only this method; repeatable" << std::endl;
+    std::cout << "  --time-budget-ms <ms>         Time allowed per case (default: 2000)" << std::endl;
+    std::cout << "  --memory-budget-mb <mb>       Memory allowed per case (default: 1024)" << std::endl;
+    std::cout << "  --decompression-workers <n>   Threads for the parallel MSZIP decoder (default: 4)" << std::endl;
+    std::cout << "  --in-process                  Run cases in this process (for debuggers and sanitizers)" << std::endl;
+    std::cout << "  --csv <file>                  Write every case as CSV" << std::endl;
+    std::cout << "  --json <file>                 Write per-method results and violations as JSON" << std::endl;
+    std::cout << "  --save-failures <dir>         Save inputs that went over budget or crashed" << std::endl;
+    std::cout << std::endl << "Methods: mszip-stream, mszip-parallel, zlib, raw-deflate, bzip2, directx-lz," << std::endl;
+    std::cout << "         compressed-parse" << std::endl;
+    std::cout << std::endl << "Exits with status 2 when any case times out, runs out of memory or crashes." << std::endl;
+}
+
+bool ParseCommandLine(int argc, char* argv[], CorpusOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&](const char* what) -> const char* {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: " << arg << " requires " << what << std::endl;
+                return nullptr;
+            }
+            return argv[++i];
+        };
+
+        try {
+            if (arg == "--help" || arg == "-h") {
+                return false;
+            } else if (arg == "--no-synthetic") {
+                options.synthetic = false;
+            } else if (arg == "--in-process") {
+                options.inProcess = true;
+            } else if (arg == "--vertices" || arg == "--mutations" || arg == "--seed" ||
+                       arg == "--decompression-workers") {
+                const char* text = value("a number");
+                if (!text) return false;
+                uint64_t number = std::stoull(text);
+                if (arg == "--vertices") options.scale.vertices = static_cast<size_t>(number);
+                else if (arg == "--mutations") options.mutations = static_cast<size_t>(number);
+                else if (arg == "--seed") options.seed = number;
+                else options.decompressionWorkers = std::max<size_t>(static_cast<size_t>(number), 1);
+            } else if (arg == "--time-budget-ms" || arg == "--memory-budget-mb") {
+                const char* text = value("a number");
+                if (!text) return false;
+                double number = std::stod(text);
+                if (number <= 0.0) throw std::out_of_range("non-positive");
+                (arg == "--time-budget-ms" ? options.timeBudgetMs : options.memoryBudgetMB) = number;
+            } else if (arg == "--corpus" || arg == "--method") {
+                const char* text = value(arg == "--corpus" ? "a path" : "a method name");
+                if (!text) return false;
+                (arg == "--corpus" ? options.corpusPaths : options.methods).push_back(text);
+            } else if (arg == "--csv" || arg == "--json" || arg == "--save-failures") {
+                const char* text = value("a path");
+                if (!text) return false;
+                (arg == "--csv" ? options.csvPath : arg == "--json" ? options.jsonPath : options.failureDirectory) = text;
+            } else {
+                std::cerr << "Error: Unknown option: " << arg << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value for " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    CorpusOptions options;
+    options.scale.vertices = 2000;
+    options.scale.bones = 8;
+    options.scale.clips = 2;
+    if (!ParseCommandLine(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // Nothing below CRITICAL is queued, so a forked child never waits on
+    // the log writer thread it does not have
+    Logger::Initialize("x2fbx_corpus.log", LogLevel::CRITICAL);
+    Logger::GetInstance().EnableConsoleOutput(false);
+
+    std::vector<CorpusCase> seeds;
+    if (!LoadCorpus(options.corpusPaths, seeds)) {
+        return 1;
+    }
+    if (options.synthetic) {
+        std::vector<CorpusCase> generated = GenerateSeeds(options.scale);
+        std::move(generated.begin(), generated.end(), std::back_inserter(seeds));
+    }
+    std::vector<Method> methods = BuildMethods(options);
+    if (seeds.empty() || methods.empty()) {
+        std::cerr << "Error: No inputs or no methods to run" << std::endl;
+        return 1;
+    }
+
+    std::vector<CorpusCase> cases;
+    for (const auto& seed : seeds) {
+        cases.push_back(seed);
+        for (size_t i = 0; i < options.mutations; ++i) {
+            cases.push_back(Mutate(seed, i, options.seed));
+        }
+    }
+#ifdef _WIN32
+    options.inProcess = true;
+#endif
+    std::cout << seeds.size() << " seeds, " << cases.size() << " inputs, " << methods.size() << " methods, budget "
+              << options.timeBudgetMs << " ms / " << options.memoryBudgetMB << " MB per case"
+              << (options.inProcess ? " (checked afterwards)" : "") << std::endl;
+
+    std::vector<CaseResult> results;
+    std::vector<MethodSummary> summaries;
+    for (const auto& method : methods) {
+        MethodSummary summary;
+        summary.method = method.name;
+        for (const auto& input : cases) {
+            CaseResult result;
+            result.method = method.name;
+            result.input = input.name;
+            result.mutation = input.mutation;
+            result.inputBytes = input.data.size();
+#ifndef _WIN32
+            if (!options.inProcess) {
+                RunIsolated(method, input, options, result);
+            } else
+#endif
+            {
+                RunInProcess(method, input, options, result);
+            }
+
+            summary.runs++;
+            summary.counts[static_cast<int>(result.outcome)]++;
+            summary.totalMs += result.ms;
+            if (result.outcome == Outcome::OK) {
+                summary.okOutputBytes += result.outputBytes;
+                summary.okMs += result.ms;
+            }
+            if (result.ms > summary.worstMs) {
+                summary.worstMs = result.ms;
+                summary.worstCase = input.name + " (" + input.mutation + ")";
+            }
+            summary.worstMemoryKB = std::max(summary.worstMemoryKB, result.memoryKB);
+            if (IsViolation(result.outcome)) {
+                std::cout << "  ✗ " << method.name << ": " << OutcomeName(result.outcome) << " on " << input.name
+                          << " (" << input.mutation << ", " << std::fixed << std::setprecision(1) << result.ms
+                          << " ms, " << result.memoryKB << " KB)" << std::endl;
+                if (!options.failureDirectory.empty()) {
+                    SaveFailure(options.failureDirectory, result, input);
+                }
+            }
+            results.push_back(std::move(result));
+        }
+        summaries.push_back(std::move(summary));
+    }
+
+    size_t violations = 0;
+    std::cout << std::endl << std::left << std::setw(18) << "method" << std::right << std::setw(7) << "ok"
+              << std::setw(10) << "rejected" << std::setw(9) << "over" << std::setw(12) << "MB/s" << std::setw(11)
+              << "mean ms" << std::setw(11) << "worst ms" << "  worst input" << std::endl;
+    for (const auto& s : summaries) {
+        size_t over = s.counts[static_cast<int>(Outcome::TIMEOUT)] + s.counts[static_cast<int>(Outcome::MEMORY)] +
+                      s.counts[static_cast<int>(Outcome::CRASH)];
+        violations += over;
+        std::cout << std::left << std::setw(18) << s.method << std::right << std::setw(7)
+                  << s.counts[static_cast<int>(Outcome::OK)] << std::setw(10)
+                  << s.counts[static_cast<int>(Outcome::REJECTED)] << std::setw(9) << over << std::fixed
+                  << std::setprecision(1) << std::setw(12) << s.MBPerSecond() << std::setprecision(3) << std::setw(11)
+                  << s.MeanMs() << std::setw(11) << s.worstMs << "  " << s.worstCase << std::endl;
+    }
+
+    if (!options.csvPath.empty() && !WriteCsv(options.csvPath, results)) {
+        return 1;
+    }
+    if (!options.jsonPath.empty() && !WriteJson(options.jsonPath, options, summaries, results)) {
+        return 1;
+    }
+    if (violations > 0) {
+        std::cerr << violations << " cases over budget or crashed" << std::endl;
+        return 2;
+    }
+    return 0;
+}
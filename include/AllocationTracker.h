@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace X2FBX {
+
+// Counts heap allocations between Start and Stop, to check that a stage
+// moves its buffers rather than copying them. Only built in with
+// -DX2FBX_TRACK_ALLOCATIONS, which replaces the global operator new;
+// otherwise IsAvailable is false and Stop returns zeros.
+// Counts are process-wide, so measure with other threads quiet.
+namespace AllocationTracker {
+
+    struct Stats {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        uint64_t largeAllocations = 0;  // At or above the threshold given to Start
+        uint64_t largestBytes = 0;
+    };
+
+    bool IsAvailable();
+
+    void Start(size_t largeThreshold = 1024 * 1024);
+    Stats Stop();
+}
+
+} // namespace X2FBX
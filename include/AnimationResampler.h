@@ -0,0 +1,71 @@
+#pragma once
+
+#include "XFileData.h"
+#include "Logger.h"
+#include <cstddef>
+#include <vector>
+
+namespace X2FBX {
+
+struct AnimationResampleOptions {
+    float frameRate = 30.0f;            // Output samples per second
+    size_t threads = 0;                 // Bone tracks resampled in parallel (0 = hardware threads)
+
+    AnimationResampleOptions() = default;
+};
+
+// What a resampling pass produced
+struct AnimationResampleResult {
+    size_t animations = 0;
+    size_t tracks = 0;
+    size_t channels = 0;
+    size_t frames = 0;                  // Output frames summed over the animations
+    size_t originalKeys = 0;
+    size_t resampledKeys = 0;
+
+    void Add(const AnimationResampleResult& other) {
+        animations += other.animations;
+        tracks += other.tracks;
+        channels += other.channels;
+        frames += other.frames;
+        originalKeys += other.originalKeys;
+        resampledKeys += other.resampledKeys;
+    }
+};
+
+// Evaluates bone tracks at a fixed rate: frame f of an animation is at
+// f / frameRate seconds, from 0 up to the first frame at or past the end of
+// the clip. Translation and scale are interpolated linearly, rotation by
+// shortest-path slerp; times before the first and after the last key hold
+// that key. Every keyed channel of a clip comes out with the same dense
+// key times, ready for bulk curve insertion; unkeyed channels stay empty.
+// The blends run on SSE2 where available, with results identical to the
+// scalar versions (CoordinateKernels::SetScalarOnly selects those).
+class AnimationResampler {
+private:
+    Logger& logger_;
+    AnimationResampleOptions options_;
+
+public:
+    explicit AnimationResampler(const AnimationResampleOptions& options = AnimationResampleOptions());
+
+    // Resample every bone track of the animations in place
+    AnimationResampleResult ResampleAnimation(XAnimationSet& animation) const;
+    AnimationResampleResult ResampleAllAnimations(std::vector<XAnimationSet>& animations) const;
+
+    // Frame times of an animation in its own ticks
+    std::vector<float> ComputeFrameTimes(const XAnimationSet& animation) const;
+
+    void GenerateResampleReport(const AnimationResampleResult& result) const;
+
+private:
+    struct TrackJob {
+        XBoneTrack* track;
+        const std::vector<float>* frameTimes;
+    };
+
+    AnimationResampleResult ResampleTracks(const std::vector<TrackJob>& jobs) const;
+    AnimationResampleResult ResampleTrack(XBoneTrack& track, const std::vector<float>& frameTimes) const;
+};
+
+} // namespace X2FBX
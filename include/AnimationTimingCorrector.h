@@ -19,6 +19,13 @@ using FbxScene = fbxsdk::FbxScene;
 
 namespace X2FBX {
 
+// One line of a timing report. Kept as data so a cached conversion can
+// replay the report without re-running the correction.
+struct TimingReportLine {
+    LogLevel level;
+    std::string text;
+};
+
 // Result of timing correction validation
 struct TimingCorrectionResult {
     bool isValid;
@@ -43,9 +50,24 @@ struct TimingAnalysis {
     TimingAnalysis() : detectedTicksPerSecond(4800.0f), confidenceLevel(0.0f) {}
 };
 
+// Key interval statistics of one animation, gathered in a single pass over
+// its densest channel and shared by every candidate tick rate
+struct KeyIntervalSummary {
+    static constexpr int HISTOGRAM_BINS = 16;   // floor(log2(interval ticks)), last bin open-ended
+
+    size_t intervalCount;
+    float minInterval;
+    float maxInterval;
+    float medianInterval;
+    unsigned int histogram[HISTOGRAM_BINS];
+
+    KeyIntervalSummary() : intervalCount(0), minInterval(0), maxInterval(0), medianInterval(0), histogram() {}
+};
+
 class AnimationTimingCorrector {
 private:
     Logger& logger_;
+    size_t threads_;                // CorrectAllAnimations workers (0 = hardware threads)
 
     // Common tick rates found in DirectX .x files
     static const std::vector<float> COMMON_TICK_RATES;
@@ -60,6 +82,10 @@ private:
 public:
     AnimationTimingCorrector();
 
+    // Animations are independent, so CorrectAllAnimations spreads them
+    // across this many threads (0 = hardware threads)
+    void SetThreadCount(size_t threads) { threads_ = threads; }
+
     // Main timing correction methods
     TimingAnalysis AnalyzeAnimationTiming(const XAnimationSet& animation) const;
     TimingCorrectionResult CorrectAnimationTiming(XAnimationSet& animation) const;
@@ -79,12 +105,18 @@ public:
     std::vector<float> GetCandidateTickRates(const XAnimationSet& animation) const;
     float CalculateConfidence(float tickRate, const XAnimationSet& animation) const;
 
-    // Keyframe time conversion
-    std::vector<XKeyframe> ConvertKeyframeTiming(
-        const std::vector<XKeyframe>& originalKeyframes,
+    // One pass over the key times; candidates are scored against the result
+    KeyIntervalSummary SummarizeKeyIntervals(const XAnimationSet& animation) const;
+
+    // Keyframe time conversion, in place
+    void ConvertKeyframeTiming(
+        XAnimationChannel& channel,
         float originalTicksPerSecond,
         float targetTicksPerSecond) const;
 
+    // Multiply every key time of every bone track, and the duration, by timeScale
+    void RescaleAnimationTimes(XAnimationSet& animation, float timeScale) const;
+
 #ifdef FBXSDK_FOUND
     // FBX-specific timing correction (when FBX SDK is available)
     bool ApplyTimingToFBXLayer(const XAnimationSet& animation, FbxAnimLayer* layer) const;
@@ -97,6 +129,8 @@ public:
 
     // Reporting
     void GenerateTimingReport(const std::vector<TimingCorrectionResult>& results) const;
+    std::vector<TimingReportLine> BuildTimingReport(const std::vector<TimingCorrectionResult>& results) const;
+    static void LogTimingReport(const std::vector<TimingReportLine>& lines);
 
 private:
     // Internal helper methods
@@ -105,13 +139,9 @@ private:
     std::string GetDetectionMethodDescription(float tickRate,
                                             const XAnimationSet& animation) const;
 
-    // Statistical analysis
-    float CalculateVariance(const std::vector<float>& values) const;
-    float CalculateMedian(std::vector<float> values) const;
-
     // Keyframe analysis
-    std::vector<float> ExtractKeyframeTimes(const XAnimationSet& animation) const;
-    float AnalyzeKeyframePattern(const std::vector<float>& keyframeTimes) const;
+    std::vector<float> GetCandidateTickRates(const KeyIntervalSummary& intervals) const;
+    float AnalyzeKeyframePattern(const KeyIntervalSummary& intervals) const;
 };
 
 // Utility functions for timing conversion
@@ -126,6 +156,10 @@ namespace TimingUtils {
     double FbxTimeToSeconds(const FbxTime& fbxTime);
 #endif
 
+    // times[i] *= scale over a contiguous array, four lanes at a time
+    // where SSE2 or NEON is available
+    void ScaleTimes(float* times, size_t count, float scale);
+
     // Validation helpers
     bool IsValidTickRate(float tickRate);
     bool IsValidDuration(float durationSeconds);
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "AnimationResampler.h"
+#include "AnimationTimingCorrector.h"
+#include "BatchPipeline.h"
+#include "BinaryXFileParser.h"
+#include "ConversionCache.h"
+#include "ConversionMetrics.h"
+#include "ConversionReport.h"
+#include "FBXExporter.h"
+#include "FBXExporterPool.h"
+#include "KeyframeReducer.h"
+#include "Logger.h"
+#include "StreamQuantizer.h"
+#include "TextureLibrary.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace X2FBX {
+
+// Options for converting many .x files in one process
+struct BatchOptions {
+    std::string source;                      // Directory to scan or a text file listing inputs
+    std::string outputDirectory = "./output";
+    size_t jobs = 0;                         // Worker threads (0 = one per hardware thread)
+    bool recursive = true;                   // Descend into subdirectories when scanning
+    bool strictMode = false;
+    bool verboseLogging = false;
+    bool validateTiming = true;
+    bool reduceKeyframes = false;            // Simplify bone tracks before export
+    bool optimizeMesh = true;                // Weld and cache-order meshes before export
+    bool batchMaterials = false;             // With optimizeMesh: merge identical materials and static meshes
+    bool quantize = false;                   // Carry streams and rotation keys quantized; errors logged per file
+    FBXExportOptions::Backend fbxBackend = FBXExportOptions::Backend::AUTO;
+    bool compressArrays = true;              // Deflate FBX arrays, on the file's worker
+    int compressionLevel = -1;               // zlib level 0-9 (-1 = zlib default)
+    std::vector<std::string> animationNames; // Only these animation sets are decoded (all when empty)
+    DecompressionLimits decompressionLimits; // Per-file caps on compressed inputs
+    ConversionCacheOptions cache;            // Shared by every worker when a directory is set
+    KeyframeReductionOptions keyReduction;   // Tracks are reduced on the file's worker
+    bool resampleAnimations = false;         // Evaluate bone tracks at resampling.frameRate before export
+    AnimationResampleOptions resampling;     // Also sets the exported frame rate when enabled
+    bool resolveTextures = false;            // Find material textures next to inputs or in textures.searchDirectories
+    bool embedTextures = false;              // Also embed them (implies resolveTextures)
+    bool embedTexturesInClips = true;        // Embed into every clip file too; false references the files
+    TextureLibraryOptions textures;          // One library, shared by every worker, per batch
+    InputPrefetchOptions prefetch;           // Inputs read ahead of the workers (maxBytes 0 = off)
+    OutputWriterOptions writes;              // Native FBX files written on a writer thread (maxQueuedBytes 0 = off)
+    FBXExportOptions::Validation validation = FBXExportOptions::Validation::CHEAP;   // FULL reads files back on a validator thread
+
+    BatchOptions() = default;
+};
+
+// Outcome of a single file within a batch
+struct BatchFileResult {
+    std::string inputPath;
+    bool success = false;
+    bool cacheHit = false;                   // Outputs restored without converting
+    bool parseSkipped = false;               // Parsed or prepared data loaded from a cached stage
+    size_t clipsRestored = 0;                // FBX files restored from a cached export of the same content
+    std::string errorMessage;
+    size_t inputBytes = 0;
+    int filesWritten = 0;
+    size_t arenaPeakBytes = 0;               // Parser scratch memory for this file
+    size_t keyframesRemoved = 0;
+    size_t keyBytesSaved = 0;
+    size_t meshVerticesRemoved = 0;
+    size_t materialsMerged = 0;              // Duplicates dropped by batchMaterials
+    size_t meshesMerged = 0;
+    size_t keysResampled = 0;                // Channel keys written by the resampler
+    QuantizationResult quantization;         // Error bounds of the quantize pass, when it ran
+    double elapsedMs = 0.0;
+    std::vector<FBXExportResult> exports;    // One per FBX file; only paths on a cache hit
+    ConversionRecord report;                 // Stage costs and counts for --report json
+};
+
+// Aggregate statistics for a whole batch run
+struct BatchSummary {
+    size_t totalFiles = 0;
+    size_t succeeded = 0;
+    size_t failed = 0;
+    size_t totalInputBytes = 0;
+    size_t filesWritten = 0;
+    size_t cacheHits = 0;
+    size_t parsesSkipped = 0;
+    size_t clipsRestored = 0;
+    size_t workerCount = 0;
+    size_t peakArenaBytes = 0;               // Largest per-file parse arena (per-worker memory sizing)
+    size_t keyframesRemoved = 0;
+    size_t keyBytesSaved = 0;
+    size_t meshVerticesRemoved = 0;
+    size_t materialsMerged = 0;
+    size_t meshesMerged = 0;
+    size_t keysResampled = 0;
+    QuantizationResult quantization;         // Largest errors over the batch
+    FBXExporterPoolStatistics exporterPool;  // Process-wide totals when the batch finished
+    TextureLibraryStatistics textures;       // Lookups and reads of the batch's texture library
+    PipelineStageStatistics readStage;       // Input read-ahead; waitSeconds is time on the byte budget
+    PipelineStageStatistics convertStage;    // Workers; waitSeconds is time waiting for a read-ahead input
+    PipelineStageStatistics writeStage;      // FBX writer; waitSeconds is exporter time on a full queue
+    PipelineStageStatistics validateStage;   // FULL validation of the written files
+    double elapsedSeconds = 0.0;
+    std::vector<BatchFileResult> results;    // In input order
+
+    double FilesPerSecond() const {
+        return elapsedSeconds > 0.0 ? totalFiles / elapsedSeconds : 0.0;
+    }
+    double MegabytesPerSecond() const {
+        return elapsedSeconds > 0.0 ? (totalInputBytes / (1024.0 * 1024.0)) / elapsedSeconds : 0.0;
+    }
+};
+
+// Per-thread conversion state. Constructed once per worker and reused for
+// every file that worker picks up; the exporter is leased from
+// FBXExporterPool, so FBX SDK setup is paid once per concurrent worker in
+// the process rather than per file or per batch. Each worker reports its
+// file and stage to ConversionMetrics. Not thread-safe; give each thread
+// its own.
+struct BatchWorker {
+    EnhancedXFileParser parser;
+    AnimationTimingCorrector timingCorrector;
+    FBXExporterPool::Lease exporter;
+    MetricsWorkerSlot metrics;
+
+    BatchWorker();
+
+    // Convert one file into outputDirectory; never throws. Textures are
+    // resolved through textures when options ask for it. input holds the
+    // file's bytes when they were read ahead (it is dropped once parsed);
+    // with a writer, native FBX files and the cache stores that copy them
+    // are left to its thread, which reports write errors. A validator
+    // likewise takes the FULL checks of the written files, and the cache
+    // stores wait for them.
+    BatchFileResult Convert(const std::string& inputPath, const std::string& outputDirectory,
+                            const BatchOptions& options, ConversionCache& cache,
+                            TextureLibrary* textures = nullptr, InputBuffer input = nullptr,
+                            OutputWriter* writer = nullptr, OutputValidator* validator = nullptr);
+};
+
+// Converts a set of .x files on a pool of worker threads.
+// Every worker owns its own parser, timing corrector and FBX exporter so no
+// conversion state is shared between threads; only the Logger, the
+// conversion cache and the texture library are common. The workers are the
+// middle of a three-stage pipeline: an InputPrefetcher reads the next
+// inputs while they parse and an OutputWriter writes the FBX files they
+// export, each bounded in bytes so memory stays capped whichever stage is
+// the slowest. FULL validation adds an OutputValidator after the writer.
+class BatchConverter {
+private:
+    Logger& logger_;
+    BatchOptions options_;
+
+public:
+    explicit BatchConverter(const BatchOptions& options);
+
+    // Resolve the batch source into a sorted list of input files
+    static std::vector<std::string> CollectInputFiles(const std::string& source, bool recursive = true);
+
+    // Convert every input; never throws for per-file failures
+    BatchSummary Run();
+    BatchSummary Run(const std::vector<std::string>& inputFiles);
+
+    static void PrintSummary(const BatchSummary& summary);
+
+    // NDJSON: every file's record in input order, then one "batch" line
+    // with the totals. path "-" writes to stdout.
+    static bool WriteReport(const BatchSummary& summary, const std::string& path);
+
+private:
+    // Output directory of every input, mirroring its location below the
+    // scanned directory or, for a list file, below the deepest directory
+    // the listed inputs share. An input whose outputs would overwrite an
+    // earlier input's (same directory and base name) gets an empty entry,
+    // and that earlier input in collisions.
+    std::vector<std::string> ResolveOutputDirectories(const std::vector<std::string>& inputFiles,
+                                                      std::vector<std::string>& collisions) const;
+};
+
+} // namespace X2FBX
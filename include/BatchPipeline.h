@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Logger.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace X2FBX {
+
+// What one stage of the batch pipeline did, summed over its threads
+struct PipelineStageStatistics {
+    size_t threads = 0;
+    size_t items = 0;             // Files read, converted or written
+    uint64_t bytes = 0;
+    double busySeconds = 0.0;     // Reading, converting or writing
+    double waitSeconds = 0.0;     // Held up by a neighbouring stage (see each stage)
+
+    // Busy share of the stage's threads over elapsedSeconds
+    double Utilization(double elapsedSeconds) const {
+        return elapsedSeconds > 0.0 && threads > 0 ? busySeconds / (elapsedSeconds * threads) : 0.0;
+    }
+};
+
+// An input read into memory ahead of its worker
+using InputBuffer = std::shared_ptr<const std::vector<uint8_t>>;
+
+struct InputPrefetchOptions {
+    size_t threads = 1;                    // Reader threads
+    uint64_t maxBytes = 256ull << 20;      // Read but not yet parsed input bytes (0 = no read-ahead)
+
+    InputPrefetchOptions() = default;
+};
+
+// Reads a batch's inputs in order ahead of the workers, so disk and
+// network reads overlap with parsing. Files are admitted in input order
+// while their bytes fit maxBytes; a worker frees its file's share when it
+// drops the buffer, so read-ahead stalls instead of growing when workers
+// fall behind. Inputs larger than maxBytes are left to the worker.
+// Take may be called from any thread, once per index, in roughly
+// increasing order (as ParallelUtils::ParallelFor hands them out).
+class InputPrefetcher {
+public:
+    InputPrefetcher(const std::vector<std::string>& inputFiles, const InputPrefetchOptions& options);
+    ~InputPrefetcher();   // Stops reading; taken buffers stay valid
+
+    InputPrefetcher(const InputPrefetcher&) = delete;
+    InputPrefetcher& operator=(const InputPrefetcher&) = delete;
+
+    // The bytes of inputFiles[index], waiting until they are read. Null when
+    // the file is not prefetched (too large, unreadable); the caller then
+    // opens it itself.
+    InputBuffer Take(size_t index);
+
+    // Readers: waitSeconds is time blocked on maxBytes
+    PipelineStageStatistics GetStatistics() const;
+
+    // Time callers of Take spent waiting for a read, summed
+    double GetTakeWaitSeconds() const;
+
+private:
+    struct State;
+
+    void RunReader();
+
+    std::shared_ptr<State> state_;   // Also held by the buffers handed out
+    std::vector<std::thread> threads_;
+};
+
+struct OutputWriterOptions {
+    uint64_t maxQueuedBytes = 256ull << 20;   // Exporters wait once this much is queued (0 = no writer stage)
+
+    OutputWriterOptions() = default;
+};
+
+// The write stage of a batch: files handed over by the exporters are
+// written on a dedicated thread, in the order they were queued, so the
+// workers go on to the next clip or input instead of waiting on the disk.
+// Cache stores that copy written files go through Then, which runs them
+// on the same thread once those files are written. Thread-safe.
+class OutputWriter {
+public:
+    explicit OutputWriter(const OutputWriterOptions& options = OutputWriterOptions());
+    ~OutputWriter();   // Writes everything queued first
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    // Queue bytes for path, replacing the file. Blocks while maxQueuedBytes
+    // are already queued; one file is always accepted into an empty queue.
+    void Write(const std::string& path, std::vector<uint8_t>&& bytes);
+
+    // Run job on the writer thread after everything queued so far, unless
+    // writing one of paths failed
+    void Then(const std::vector<std::string>& paths, std::function<void()> job);
+
+    // Wait until everything queued so far is written
+    void Flush();
+
+    // Why writing path failed; empty when it was written or never queued
+    std::string GetError(const std::string& path) const;
+
+    // waitSeconds is exporter time blocked on a full queue
+    PipelineStageStatistics GetStatistics() const;
+
+private:
+    struct Task {
+        std::string path;
+        std::vector<uint8_t> bytes;
+        std::vector<std::string> dependencies;   // Of a Then job
+        std::function<void()> job;
+    };
+
+    void Enqueue(Task&& task);
+    void Run();
+
+    Logger& logger_;
+    OutputWriterOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;      // Writer: work queued or stopping
+    std::condition_variable drained_;   // Producers: room in the queue, or idle
+    std::deque<Task> queue_;
+    uint64_t queuedBytes_;
+    bool writing_;
+    bool stopping_;
+    std::map<std::string, std::string> errors_;
+    PipelineStageStatistics statistics_;
+    std::thread thread_;
+};
+
+// The FULL validation stage of a batch: written files are read back and
+// checked (FBXUtils::CheckFBXFile) on a dedicated thread, so exporters go
+// on to the next clip or input instead of re-reading what they wrote.
+// Checks run in submission order; a file queued on an OutputWriter is
+// checked once it is on disk, so the validator must outlive the writer.
+// Thread-safe.
+class OutputValidator {
+public:
+    OutputValidator();
+    ~OutputValidator();   // Finishes queued checks first
+
+    OutputValidator(const OutputValidator&) = delete;
+    OutputValidator& operator=(const OutputValidator&) = delete;
+
+    // Check path, after writer has written it when given (a file the
+    // writer failed to write is not checked; the writer reports it)
+    void Submit(const std::string& path, OutputWriter* writer = nullptr);
+
+    // Run job on the validator thread after everything submitted so far,
+    // unless one of paths failed a check (or, with writer, to be written)
+    void Then(const std::vector<std::string>& paths, std::function<void()> job, OutputWriter* writer = nullptr);
+
+    // Wait until everything submitted so far is checked. Flush the writer
+    // first, or files still queued there are checked later.
+    void Flush();
+
+    // Why path failed its check; empty when it passed or was never checked
+    std::string GetError(const std::string& path) const;
+
+    // Checks never wait on a neighbouring stage; waitSeconds stays 0
+    PipelineStageStatistics GetStatistics() const;
+
+private:
+    struct Task {
+        std::string path;                        // Of a check
+        std::vector<std::string> dependencies;   // Of a Then job
+        std::function<void()> job;
+    };
+
+    void Enqueue(Task&& task);
+    void Run();
+
+    Logger& logger_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;      // Validator: work queued or stopping
+    std::condition_variable drained_;   // Flush: idle
+    std::deque<Task> queue_;
+    bool checking_;
+    bool stopping_;
+    std::map<std::string, std::string> errors_;
+    PipelineStageStatistics statistics_;
+    std::thread thread_;
+};
+
+// Run job once every file of paths is written and checked: through the
+// validator when there is one, else after the writer, else right away
+void RunAfterOutputs(const std::vector<std::string>& paths, std::function<void()> job, OutputWriter* writer,
+                     OutputValidator* validator);
+
+} // namespace X2FBX
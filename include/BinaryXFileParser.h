@@ -3,13 +3,70 @@
 #include "XFileData.h"
 #include "XFileParser.h"
 #include "Logger.h"
+#include "MappedFile.h"
+#include "ByteSource.h"
+#include <chrono>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <fstream>
 
 namespace X2FBX {
 
-// Binary data reader utility
+// Standard templates the binary parser recognizes (see STANDARD_TEMPLATES
+// in BinaryXFileParser.cpp). Object type names are resolved to these ids
+// once, through a table built at compile time, and dispatched with a
+// switch; any other name is CUSTOM.
+namespace BinaryXFileUtils {
+    enum class XTemplate : uint8_t {
+        CUSTOM = 0,
+        HEADER,
+        VECTOR,
+        COORDS2D,
+        MATRIX4X4,
+        COLOR_RGBA,
+        COLOR_RGB,
+        INDEXED_COLOR,
+        BOOLEAN,
+        BOOLEAN2D,
+        MATERIAL_WRAP,
+        TEXTURE_FILENAME,
+        MATERIAL,
+        MESH_FACE,
+        MESH_FACE_WRAPS,
+        MESH_TEXTURE_COORDS,
+        MESH_MATERIAL_LIST,
+        MESH_NORMALS,
+        MESH_VERTEX_COLORS,
+        MESH,
+        FRAME_TRANSFORM_MATRIX,
+        FRAME,
+        FLOAT_KEYS,
+        TIMED_FLOAT_KEYS,
+        ANIMATION_KEY,
+        ANIMATION_OPTIONS,
+        ANIMATION,
+        ANIMATION_SET,
+        XSKIN_MESH_HEADER,
+        VERTEX_DUPLICATION_INDICES,
+        SKIN_WEIGHTS,
+        ANIM_TICKS_PER_SECOND,
+        DECL_DATA,
+        NORMALMAP_FILENAME,     // Exporter extension, no published GUID
+        COUNT
+    };
+
+    // Spelling variants (TextureFileName, NormalMapFilename) resolve to
+    // the same id
+    XTemplate FindStandardTemplate(std::string_view name);
+    const char* GetTemplateName(XTemplate id);
+    // The template's GUID in file byte order; false when it has none
+    bool GetTemplateGuid(XTemplate id, uint8_t guid[16]);
+}
+
+// Binary data reader utility. Reads either from memory or from a
+// ByteSource through a bounded sliding window; in streaming mode only the
+// next windowSize bytes are resident.
 class BinaryReader {
 private:
     const uint8_t* data_;
@@ -17,8 +74,15 @@ private:
     size_t position_;
     bool littleEndian_;
 
+    // Streaming mode
+    ByteSource* source_;
+    std::vector<uint8_t> window_;
+    size_t windowSize_;
+    size_t windowOffset_;          // Stream offset of data_[0]
+
 public:
     BinaryReader(const uint8_t* data, size_t size, bool littleEndian = true);
+    BinaryReader(ByteSource& source, size_t windowSize, bool littleEndian = true);
 
     // Basic type reading
     uint8_t ReadUInt8();
@@ -34,6 +98,8 @@ public:
 
     // String reading
     std::string ReadString(size_t length);
+    // View of the next length bytes, valid until the next read
+    std::string_view ReadStringView(size_t length);
     std::string ReadNullTerminatedString();
     std::string ReadLengthPrefixedString();
 
@@ -42,71 +108,138 @@ public:
     std::vector<float> ReadFloatArray(size_t count);
     std::vector<uint32_t> ReadUInt32Array(size_t count);
 
-    // Position management
+    // Bulk reads into caller storage: one bounds check, then a memcpy
+    // (plus a byte swap when the file and host byte orders differ)
+    void ReadFloats(float* output, size_t count);
+    void ReadUInt32s(uint32_t* output, size_t count);
+
+    // The same with the file byte order fixed at compile time, for count
+    // words of WordBytes (4 or 8) each; the swap, if any, is unconditional
+    template <bool LittleEndian, size_t WordBytes>
+    void ReadWords(void* output, size_t count);
+
+    // Append everything that is left to output (pulls the rest of a stream)
+    void ReadRemaining(std::vector<uint8_t>& output);
+
+    // Position management. Positions are absolute stream offsets; a
+    // streaming reader can only seek within its window or forward.
     void Seek(size_t position);
     void Skip(size_t bytes);
-    size_t GetPosition() const { return position_; }
-    size_t GetSize() const { return size_; }
+    size_t GetPosition() const { return windowOffset_ + position_; }
+    size_t GetSize() const { return windowOffset_ + size_; }   // Bytes received so far when streaming
     size_t GetRemainingBytes() const { return size_ - position_; }
-    bool IsAtEnd() const { return position_ >= size_; }
+    bool IsAtEnd() { return position_ >= size_ && !Refill(1); }
+    bool IsStreaming() const { return source_ != nullptr; }
+    bool IsLittleEndian() const { return littleEndian_; }
 
     // Peek without advancing position
     uint8_t PeekUInt8();
+    uint16_t PeekUInt16();
     uint32_t PeekUInt32();
 
     // Validation
-    bool CanRead(size_t bytes) const;
+    bool CanRead(size_t bytes) { return size_ - position_ >= bytes || Refill(bytes); }
+
+private:
+    // Make at least bytes readable at position_; false at end of data
+    bool Refill(size_t bytes);
+    void Require(size_t bytes, const char* operation) {
+        if (size_ - position_ < bytes && !Refill(bytes)) {
+            ThrowOutOfData(operation);
+        }
+    }
+    [[noreturn]] void ThrowOutOfData(const char* operation) const;
+};
+
+// Reads the elements of binary value lists for one file, specialized at
+// compile time on its byte order and float width (32 or 64). The parser
+// picks one after the header, so list decoding carries no per-value
+// branches; 64-bit floats are narrowed to float as they are read.
+struct BinaryValueDecoder {
+    void (*readFloats)(BinaryReader& reader, float* output, size_t count);            // FLOAT_LIST elements
+    void (*readFloatsAsUInts)(BinaryReader& reader, uint32_t* output, size_t count);
+    void (*readUInts)(BinaryReader& reader, uint32_t* output, size_t count);          // INTEGER_LIST elements
+    void (*readUIntsAsFloats)(BinaryReader& reader, float* output, size_t count);    // As signed integers
+    size_t floatBytes;
+
+    static BinaryValueDecoder For(bool littleEndian, uint32_t floatSize);
+};
+
+// Per-file caps on decompression, so one corrupt or hostile compressed
+// file fails instead of occupying a worker. Zero turns a cap off.
+struct DecompressionLimits {
+    double maxSeconds = 0.0;        // Wall time from the start of the file until its payload is consumed
+    uint64_t maxOutputBytes = 0;    // Decompressed bytes
+    size_t checkBytes = 4096;       // Output checked before the rest is inflated (0 = no early check)
+
+    // time_point::max() when maxSeconds is off
+    std::chrono::steady_clock::time_point DeadlineFrom(std::chrono::steady_clock::time_point start) const;
 };
 
 // Compressed file decompressor
 class XFileDecompressor {
 private:
     Logger& logger_;
+    DecompressionLimits limits_;
+    const char* method_;
+    size_t attempts_;
 
 public:
     XFileDecompressor();
 
+    // Only the whole-buffer methods and the MSZIP declared size are checked
+    // here; streams are wrapped in a LimitedByteSource by their reader
+    void SetLimits(const DecompressionLimits& limits) { limits_ = limits; }
+
+    // Decoder of the last attempt ("mszip", "zip", "bzip2", "deflate",
+    // "directx-lz", "lzss"; empty before any) and the decoders tried so
+    // far, fallbacks and DirectX LZ variants included
+    const char* GetMethod() const { return method_; }
+    size_t GetAttempts() const { return attempts_; }
+
     // Decompression methods
-    bool DecompressZipped(const std::vector<uint8_t>& compressedData,
+    bool DecompressZipped(ByteView compressedData,
+                          std::vector<uint8_t>& decompressedData);
+    bool DecompressBzip2(ByteView compressedData,
                          std::vector<uint8_t>& decompressedData);
-    bool DecompressBzip2(const std::vector<uint8_t>& compressedData,
-                        std::vector<uint8_t>& decompressedData);
-    bool DecompressRawDeflate(const std::vector<uint8_t>& input,
-                             std::vector<uint8_t>& output);
-    bool DecompressDirectXBzip(const std::vector<uint8_t>& input,
+    bool DecompressRawDeflate(ByteView input,
                               std::vector<uint8_t>& output);
-    bool DecompressDirectXLZ(const std::vector<uint8_t>& input,
-                            std::vector<uint8_t>& output);
-    bool DecompressBzip0032(const std::vector<uint8_t>& input,
-                           std::vector<uint8_t>& output);
+    bool DecompressDirectXLZ(ByteView input,
+                             std::vector<uint8_t>& output);
+
+    // DirectX "tzip"/"bzip" payload (the bytes after the 16-byte header)
+    bool DecompressMszip(ByteView payload,
+                         std::vector<uint8_t>& output,
+                         size_t workerCount = 1);
+
+    // Streaming decompression; the returned source inflates on demand.
+    // Returns nullptr if the codec is unavailable or the input is invalid.
+    std::unique_ptr<ByteSource> OpenBzip2Stream(ByteView compressedData);
+    std::unique_ptr<ByteSource> OpenZipStream(ByteView compressedData);   // zip entry, zlib or gzip
+    std::unique_ptr<ByteSource> OpenRawDeflateStream(ByteView compressedData);
+    std::unique_ptr<ByteSource> OpenMszipStream(ByteView payload);
+
+    // Whether the first bytes of a decompressed payload can be what the
+    // parser expects: an "xof " header, .x text, or binary tokens starting
+    // a template or data object. Passes when the prefix ends mid-token.
+    static bool CheckPayloadPrefix(ByteView prefix, uint32_t floatSize, bool textPayload, std::string& error);
 
     // Detection
-    bool IsZipCompressed(const std::vector<uint8_t>& data);
-    bool IsBzip2Compressed(const std::vector<uint8_t>& data);
-    bool IsDirectXLZCompressed(const std::vector<uint8_t>& data);
+    static bool IsZipCompressed(ByteView data);
+    static bool IsBzip2Compressed(ByteView data);
+    static bool IsDirectXLZCompressed(ByteView data);
 
     // Utility
     static bool IsCompressionSupported();
 
 private:
-    bool DecompressWithZlib(const std::vector<uint8_t>& input,
-                           std::vector<uint8_t>& output);
-    bool DecompressWithBzip2(const std::vector<uint8_t>& input,
-                            std::vector<uint8_t>& output);
+    void BeginAttempt(const char* method) { method_ = method; attempts_++; }
+    std::unique_ptr<ByteSource> CreateInflateStream(ByteView compressedData, int windowBits, const char* kind);
 
-    // New helper methods for bzip0032 format
-    bool TryMultipleDecompressionMethods(const std::vector<uint8_t>& data,
-                                       std::vector<uint8_t>& output);
-    bool TryZlibDecompression(const std::vector<uint8_t>& data,
+    bool DecompressWithZlib(ByteView input,
                             std::vector<uint8_t>& output);
-    bool TryDeflateWithParams(const std::vector<uint8_t>& data,
-                            std::vector<uint8_t>& output,
-                            size_t offset, int windowBits);
-    bool TryLZ77Decompression(const std::vector<uint8_t>& data,
-                            std::vector<uint8_t>& output);
-    bool TryPatternBasedDecompression(const std::vector<uint8_t>& data,
-                                   std::vector<uint8_t>& output);
-    bool ValidateDecompressedContent(const std::vector<uint8_t>& data);
+    bool DecompressWithBzip2(ByteView input,
+                             std::vector<uint8_t>& output);
 };
 
 // Binary .x file parser
@@ -116,18 +249,59 @@ private:
     std::unique_ptr<BinaryReader> reader_;
     XFileData parsedData_;
 
-    // Template system for binary parsing
+    // Templates declared by the file, in declaration order. Objects are
+    // dispatched on the standard template ids (see BinaryXFileUtils);
+    // declarations are only kept for their identity.
     struct BinaryTemplate {
         std::string name;
-        std::string guid;
-        std::vector<std::string> members;
-        bool isOpen;  // Can contain other templates
+        uint8_t guid[16] = {};
+        bool hasGuid = false;
+        BinaryXFileUtils::XTemplate standard = BinaryXFileUtils::XTemplate::CUSTOM;
+    };
+
+    std::vector<BinaryTemplate> templates_;
 
-        BinaryTemplate() : isOpen(false) {}
+    // Value cursor: numbers arrive as INTEGER / INTEGER_LIST / FLOAT_LIST
+    // tokens, and one list usually spans several fields of an object
+    uint16_t listToken_;
+    uint32_t listRemaining_;
+    uint32_t floatSize_;           // 32 or 64, from the file header
+    BinaryValueDecoder decoder_;   // For floatSize_, chosen in ParseBinaryContent
+
+    // Per-parse lookup state
+    std::map<std::string, XMaterial> materialLibrary_;
+    float fileTicksPerSecond_;
+
+    struct PendingSkinWeights {
+        std::string boneName;
+        std::vector<uint32_t> vertexIndices;
+        std::vector<float> weights;
+        XMatrix4x4 offsetMatrix;
+    };
+    std::vector<PendingSkinWeights> pendingSkinWeights_;
+
+    // Polygon layout of the mesh being parsed (see XFileParser)
+    struct MeshParseContext {
+        size_t baseVertex = 0;
+        size_t baseMaterial = 0;
+        size_t vertexCount = 0;
+        std::vector<uint32_t> polygonIndices;
+        std::vector<size_t> polygonOffsets;
+        std::vector<size_t> polygonFirstFace;
     };
 
-    std::map<std::string, BinaryTemplate> templates_;
-    std::map<std::string, uint32_t> templateIds_;
+    // Streaming configuration
+    size_t streamWindowBytes_;
+    bool backgroundDecompression_;
+    size_t decompressionWorkers_;
+    DecompressionLimits decompressionLimits_;
+    std::chrono::steady_clock::time_point decompressionDeadline_;   // Of the file being parsed
+
+    // Animation selection (see XFileParser). Lazy indexing needs the whole
+    // input in memory, so streamed payloads decode selected sets eagerly.
+    std::vector<std::string> animationFilter_;
+    bool lazyAnimations_;
+    ByteView animationSource_;
 
 public:
     BinaryXFileParser();
@@ -135,12 +309,36 @@ public:
 
     // Main parsing methods
     bool ParseBinaryFile(const std::string& filepath);
-    bool ParseBinaryData(const std::vector<uint8_t>& data);
+    bool ParseBinaryData(ByteView data);
     bool ParseCompressedFile(const std::string& filepath);
+    bool ParseCompressedData(ByteView data);
+    // Skips detection, using a probe of the same data (see ProbeXFileData)
+    bool ParseCompressedData(ByteView data, const XFileHeader& header);
+
+    // Parse a decompressed payload as it is produced. The payload may start
+    // with its own "xof " header; otherwise it holds text (textPayload) or
+    // binary tokens using floatSize-bit floats.
+    bool ParseBinaryStream(ByteSource& source, uint32_t floatSize = 32, bool textPayload = false);
+
+    // Window kept resident while streaming, and whether decompression runs
+    // on its own thread while tokens are parsed
+    void SetStreamingOptions(size_t windowBytes, bool backgroundDecompression);
+
+    // More than one worker decodes MSZIP blocks in parallel into memory
+    // instead of streaming them through the window
+    void SetDecompressionWorkers(size_t workers);
+
+    // Caps for each compressed file parsed after this
+    void SetDecompressionLimits(const DecompressionLimits& limits) { decompressionLimits_ = limits; }
+
+    void SetAnimationFilter(const std::vector<std::string>& names) { animationFilter_ = names; }
+    // The data given to ParseBinaryData must stay alive until DecodeAnimations
+    void SetLazyAnimations(bool lazy) { lazyAnimations_ = lazy; }
+    bool DecodeAnimations(const std::vector<std::string>& names);
 
     // Access parsed data
     const XFileData& GetParsedData() const { return parsedData_; }
-    XFileData TakeParsedData() { return std::move(parsedData_); }
+    XFileData TakeParsedData() { animationSource_ = ByteView(); return std::move(parsedData_); }
 
     // Format detection
     static bool IsBinaryXFile(const std::string& filepath);
@@ -148,61 +346,92 @@ public:
 
 private:
     // Core parsing
-    bool ParseBinaryHeader();
+    bool ParseBinaryHeader(ByteView header);
     bool ParseBinaryContent();
+    bool ParseDecompressedStream(std::unique_ptr<ByteSource> source, uint32_t floatSize, bool textPayload);
+    bool ParseCompressedPayload(ByteView data, const XFileHeader& header, XFileDecompressor& decompressor);
+    // Wrap a payload stream in the size and time caps and the early check
+    std::unique_ptr<ByteSource> LimitPayload(std::unique_ptr<ByteSource> source, uint32_t floatSize, bool textPayload);
+
+    // Token level
+    uint16_t ReadToken();
+    uint16_t PeekToken();
+    void SkipTokenData(uint16_t token);
+    bool SkipObjectBody();
+    bool ReadObjectHeader(std::string& name);
+    std::string ReadName();
+    // Object type of a NAME token's payload, resolved without a copy
+    BinaryXFileUtils::XTemplate ReadObjectType();
+
+    // Values inside data objects
+    bool NextValue();
+    bool FillList();
+    bool ReadUInt(uint32_t& value);
+    bool ReadFloat(float& value);
+    bool ReadUInts(uint32_t* values, size_t count);    // Spans list tokens
+    bool ReadFloats(float* values, size_t count);
+    bool ReadString(std::string& value);
+    void DiscardList();
 
     // Template parsing
-    bool ParseTemplateDefinitions();
-    bool ParseTemplate(BinaryTemplate& templ);
+    bool ParseTemplate();
 
     // Data object parsing
     bool ParseDataObjects();
-    bool ParseDataObject();
+    bool ParseDataObject(BinaryXFileUtils::XTemplate type, const std::string& name, int parentBone);
 
     // Specific object parsers
-    bool ParseBinaryMesh();
-    bool ParseBinaryFrame();
-    bool ParseBinaryAnimationSet();
-    bool ParseBinaryAnimation();
-    bool ParseBinaryAnimationKey();
-    bool ParseBinaryMaterial();
-    bool ParseBinarySkinWeights();
+    bool ParseBinaryMesh(const std::string& name);
+    bool ParseBinaryFrame(const std::string& name, int parentBone);
+    bool ParseBinaryAnimationSet(const std::string& name);
+    bool ParseBinaryAnimationSetBody(XAnimationSet& animSet);
+    bool IndexBinaryAnimationSetBody(XAnimationSetInfo& info);
+    bool ParseBinaryAnimation(XAnimationSet& animSet);
+    bool ParseBinaryAnimationKey(XBoneTrack& track);
+    bool ParseBinaryMaterial(const std::string& name, XMaterial& material);
+    bool ParseBinaryMaterialList(const MeshParseContext& mesh);
+    bool ParseBinaryNormals(const MeshParseContext& mesh);
+    bool ParseBinaryTextureCoords(const MeshParseContext& mesh);
+    bool ParseBinarySkinWeights(const MeshParseContext& mesh);
 
     // Binary data conversion
-    XVector3 ReadVector3();
-    XVector2 ReadVector2();
-    XQuaternion ReadQuaternion();
-    XMatrix4x4 ReadMatrix4x4();
+    bool ReadVector3(XVector3& value);
+    bool ReadMatrix4x4(XMatrix4x4& matrix);
 
     // Array parsers
-    std::vector<XVector3> ReadVector3Array(uint32_t count);
-    std::vector<XVector2> ReadVector2Array(uint32_t count);
-    std::vector<uint32_t> ReadIndexArray(uint32_t count);
-    std::vector<float> ReadFloatArray(uint32_t count);
+    bool ReadVector3Array(uint32_t count, std::vector<XVector3>& values);  // Appends
+    bool ReadVector2Array(uint32_t count, XVector2* values);
 
-    // Animation parsing helpers
-    bool ParseKeyframeData(XAnimationSet& animSet);
-    bool ParseBoneAnimation(const std::string& boneName, XAnimationSet& animSet);
-
-    // Timing extraction for binary files
-    bool ExtractBinaryTimingInformation();
-
-    // Template system
-    uint32_t GetTemplateId(const std::string& templateName);
-    bool IsKnownTemplate(uint32_t templateId);
-    std::string GetTemplateName(uint32_t templateId);
+    // Post-processing
+    void ResolveSkinWeights();
+    bool FinishBinaryParse();
 
     // Validation
-    bool ValidateBinaryData();
     void AddBinaryParseError(const std::string& error);
     void AddBinaryParseWarning(const std::string& warning);
 
     // Utility
     void ResetBinaryParser();
-    std::string ReadBinaryString();
-    bool SkipUnknownData(uint32_t size);
 };
 
+// What the first bytes of an input say about it: enough to pick the parse
+// path without reading the rest of the file
+struct XFileProbe {
+    bool readable;        // The file could be opened
+    bool recognized;      // A "xof " header, a compressed container or a snapshot
+    bool snapshot;        // An XFileSnapshot of parsed data rather than a .x file
+    XFileHeader header;   // Format, version, float size and compression
+
+    XFileProbe() : readable(false), recognized(false), snapshot(false) {}
+};
+
+// The 16-byte "xof " header also covers the snapshot magic
+constexpr size_t XFILE_PROBE_BYTES = 16;
+
+// Only looks at the first XFILE_PROBE_BYTES; ProbeXFile reads just those
+XFileProbe ProbeXFileData(ByteView data);
+XFileProbe ProbeXFile(const std::string& filepath);
+
 // Enhanced X File Parser that supports all formats
 class EnhancedXFileParser {
 private:
@@ -210,6 +439,11 @@ private:
     XFileParser textParser_;
     BinaryXFileParser binaryParser_;
     XFileDecompressor decompressor_;
+    bool usedTextParser_;  // Which parser holds the last result
+    bool usedSnapshot_;    // Last input was an XFileSnapshot, loaded into snapshotData_
+    XFileData snapshotData_;
+    MappedFile input_;     // Kept open for lazy animation decoding
+    bool lazyAnimations_;
 
 public:
     EnhancedXFileParser();
@@ -217,29 +451,53 @@ public:
 
     // Main parsing method that auto-detects format
     bool ParseFile(const std::string& filepath);
-    bool ParseFromData(const std::vector<uint8_t>& data);
+    // Takes a probe of the same file instead of detecting the format again
+    bool ParseFile(const std::string& filepath, const XFileProbe& probe);
+    bool ParseFromData(ByteView data);
 
     // Get parsed data
     const XFileData& GetParsedData() const;
     XFileData TakeParsedData();
 
     // Format detection
+    // Only reads the 16-byte header
     XFileHeader::Format DetectFileFormat(const std::string& filepath);
-    XFileHeader::Format DetectDataFormat(const std::vector<uint8_t>& data);
+    XFileHeader::Format DetectDataFormat(ByteView data);
 
     // Configuration
     void SetStrictMode(bool strict);
     void SetVerboseLogging(bool verbose);
+    void SetStreamingOptions(size_t windowBytes, bool backgroundDecompression);
+    void SetDecompressionWorkers(size_t workers);
+    void SetDecompressionLimits(const DecompressionLimits& limits);
+
+    // Only decode AnimationSets with these names (all when empty); the
+    // others are indexed in XFileData::animationSets
+    void SetAnimationFilter(const std::vector<std::string>& names);
+    // Index every AnimationSet and decode keys only in DecodeAnimations.
+    // Text and binary files are kept mapped until the data is taken (bytes
+    // given to ParseFromData must stay alive as long); compressed inputs
+    // are streamed and decode selected sets up front.
+    void SetLazyAnimations(bool lazy);
+
+    // Decode indexed sets with the given names (all when empty)
+    bool DecodeAnimations(const std::vector<std::string>& names);
+
+    // Workers for the top-level objects of large text files
+    void SetParseThreads(size_t threads);
 
 private:
-    // Format-specific parsing
-    bool ParseTextFormat(const std::string& filepath);
-    bool ParseBinaryFormat(const std::string& filepath);
-    bool ParseCompressedFormat(const std::string& filepath);
+    // Dispatch on the probed format
+    bool ParseProbedData(ByteView data, const XFileProbe& probe);
+
+    // Format-specific parsing over the mapped input
+    bool ParseTextFormat(ByteView data);
+    bool ParseBinaryFormat(ByteView data);
+    bool ParseCompressedFormat(ByteView data, const XFileHeader& header);
+    bool LoadSnapshot(ByteView data);
 
     // Helper methods
-    std::vector<uint8_t> ReadFileToBytes(const std::string& filepath);
-    bool ValidateFileSignature(const std::vector<uint8_t>& data);
+    bool ValidateFileSignature(ByteView data);
 };
 
 // Utility functions for binary .x file handling
@@ -259,39 +517,39 @@ namespace BinaryXFileUtils {
     bool ValidateBinaryHeader(const std::vector<uint8_t>& data);
     bool ValidateCompressedHeader(const std::vector<uint8_t>& data);
 
-    // Template GUID definitions (binary .x files use GUIDs instead of names)
-    extern const std::map<std::string, std::string> STANDARD_TEMPLATE_GUIDS;
-
-    // Common binary .x file constants
-    extern const uint32_t BINARY_TOKEN_NAME;
-    extern const uint32_t BINARY_TOKEN_STRING;
-    extern const uint32_t BINARY_TOKEN_INTEGER;
-    extern const uint32_t BINARY_TOKEN_FLOAT;
-    extern const uint32_t BINARY_TOKEN_OBRACE;
-    extern const uint32_t BINARY_TOKEN_CBRACE;
-    extern const uint32_t BINARY_TOKEN_OPAREN;
-    extern const uint32_t BINARY_TOKEN_CPAREN;
-    extern const uint32_t BINARY_TOKEN_OBRACKET;
-    extern const uint32_t BINARY_TOKEN_CBRACKET;
-    extern const uint32_t BINARY_TOKEN_OANGLE;
-    extern const uint32_t BINARY_TOKEN_CANGLE;
-    extern const uint32_t BINARY_TOKEN_DOT;
-    extern const uint32_t BINARY_TOKEN_COMMA;
-    extern const uint32_t BINARY_TOKEN_SEMICOLON;
-    extern const uint32_t BINARY_TOKEN_TEMPLATE;
-    extern const uint32_t BINARY_TOKEN_WORD;
-    extern const uint32_t BINARY_TOKEN_DWORD;
-    extern const uint32_t BINARY_TOKEN_FLOAT_TOKEN;
-    extern const uint32_t BINARY_TOKEN_DOUBLE;
-    extern const uint32_t BINARY_TOKEN_CHAR;
-    extern const uint32_t BINARY_TOKEN_UCHAR;
-    extern const uint32_t BINARY_TOKEN_SWORD;
-    extern const uint32_t BINARY_TOKEN_SDWORD;
-    extern const uint32_t BINARY_TOKEN_VOID;
-    extern const uint32_t BINARY_TOKEN_LPSTR;
-    extern const uint32_t BINARY_TOKEN_UNICODE;
-    extern const uint32_t BINARY_TOKEN_CSTRING;
-    extern const uint32_t BINARY_TOKEN_ARRAY;
+
+    // Binary .x token identifiers (16-bit in the file)
+    constexpr uint16_t BINARY_TOKEN_NAME = 1;
+    constexpr uint16_t BINARY_TOKEN_STRING = 2;
+    constexpr uint16_t BINARY_TOKEN_INTEGER = 3;
+    constexpr uint16_t BINARY_TOKEN_GUID = 5;
+    constexpr uint16_t BINARY_TOKEN_INTEGER_LIST = 6;
+    constexpr uint16_t BINARY_TOKEN_FLOAT_LIST = 7;
+    constexpr uint16_t BINARY_TOKEN_OBRACE = 10;
+    constexpr uint16_t BINARY_TOKEN_CBRACE = 11;
+    constexpr uint16_t BINARY_TOKEN_OPAREN = 12;
+    constexpr uint16_t BINARY_TOKEN_CPAREN = 13;
+    constexpr uint16_t BINARY_TOKEN_OBRACKET = 14;
+    constexpr uint16_t BINARY_TOKEN_CBRACKET = 15;
+    constexpr uint16_t BINARY_TOKEN_OANGLE = 16;
+    constexpr uint16_t BINARY_TOKEN_CANGLE = 17;
+    constexpr uint16_t BINARY_TOKEN_DOT = 18;
+    constexpr uint16_t BINARY_TOKEN_COMMA = 19;
+    constexpr uint16_t BINARY_TOKEN_SEMICOLON = 20;
+    constexpr uint16_t BINARY_TOKEN_TEMPLATE = 31;
+    constexpr uint16_t BINARY_TOKEN_WORD = 40;
+    constexpr uint16_t BINARY_TOKEN_DWORD = 41;
+    constexpr uint16_t BINARY_TOKEN_FLOAT = 42;
+    constexpr uint16_t BINARY_TOKEN_DOUBLE = 43;
+    constexpr uint16_t BINARY_TOKEN_CHAR = 44;
+    constexpr uint16_t BINARY_TOKEN_UCHAR = 45;
+    constexpr uint16_t BINARY_TOKEN_SWORD = 46;
+    constexpr uint16_t BINARY_TOKEN_SDWORD = 47;
+    constexpr uint16_t BINARY_TOKEN_VOID = 48;
+    constexpr uint16_t BINARY_TOKEN_LPSTR = 49;
+    constexpr uint16_t BINARY_TOKEN_UNICODE = 50;
+    constexpr uint16_t BINARY_TOKEN_CSTRING = 51;
+    constexpr uint16_t BINARY_TOKEN_ARRAY = 52;
 }
 
 } // namespace X2FBX
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "MappedFile.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace X2FBX {
+
+// Pull-based byte stream. Decompressors implement this so a BinaryReader
+// can consume their output chunk by chunk instead of from one big buffer.
+class ByteSource {
+public:
+    virtual ~ByteSource() = default;
+
+    // Copy up to maxBytes into buffer; returns 0 at end of stream or on error
+    virtual size_t Read(uint8_t* buffer, size_t maxBytes) = 0;
+
+    bool HasError() const { return !error_.empty(); }
+    const std::string& GetError() const { return error_; }
+
+    // Bytes produced so far
+    size_t GetBytesProduced() const { return bytesProduced_; }
+
+protected:
+    std::string error_;
+    size_t bytesProduced_ = 0;
+};
+
+// Serves bytes straight from memory (a MappedFile view or a buffer)
+class MemoryByteSource : public ByteSource {
+private:
+    ByteView data_;
+    size_t position_;
+
+public:
+    explicit MemoryByteSource(ByteView data) : data_(data), position_(0) {}
+    size_t Read(uint8_t* buffer, size_t maxBytes) override;
+};
+
+// zlib inflate over a compressed view. windowBits follows inflateInit2:
+// 15 for zlib streams, -15 for raw deflate, 31 for gzip.
+class InflateByteSource : public ByteSource {
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+
+public:
+    InflateByteSource(ByteView compressed, int windowBits);
+    ~InflateByteSource() override;
+    size_t Read(uint8_t* buffer, size_t maxBytes) override;
+
+    static bool IsAvailable();
+};
+
+// libbzip2 decompression over a compressed view
+class Bzip2ByteSource : public ByteSource {
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+
+public:
+    explicit Bzip2ByteSource(ByteView compressed);
+    ~Bzip2ByteSource() override;
+    size_t Read(uint8_t* buffer, size_t maxBytes) override;
+
+    static bool IsAvailable();
+};
+
+// Runs another source on a background thread so decompression overlaps
+// with whatever consumes the bytes. At most maxChunks chunks of chunkSize
+// bytes are buffered, which bounds memory regardless of the stream length.
+class ThreadedByteSource : public ByteSource {
+private:
+    std::unique_ptr<ByteSource> inner_;
+    size_t chunkSize_;
+    size_t maxChunks_;
+
+    std::mutex mutex_;
+    std::condition_variable produced_;
+    std::condition_variable consumed_;
+    std::deque<std::vector<uint8_t>> chunks_;
+    bool finished_;
+    bool cancelled_;
+    std::string innerError_;
+
+    std::vector<uint8_t> current_;
+    size_t currentPosition_;
+    std::thread worker_;
+
+public:
+    ThreadedByteSource(std::unique_ptr<ByteSource> inner, size_t chunkSize = 256 * 1024, size_t maxChunks = 4);
+    ~ThreadedByteSource() override;
+
+    ThreadedByteSource(const ThreadedByteSource&) = delete;
+    ThreadedByteSource& operator=(const ThreadedByteSource&) = delete;
+
+    size_t Read(uint8_t* buffer, size_t maxBytes) override;
+
+private:
+    void Produce();
+};
+
+// Passes another source through and fails it once it has produced more
+// than maxBytes or runs past deadline (0 and time_point::max() are no
+// limit). When a check is given, the first checkBytes are read and checked
+// before anything is returned, so a payload that is clearly not what the
+// reader expects is dropped without inflating the rest.
+class LimitedByteSource : public ByteSource {
+public:
+    // Returns false and sets error to reject the prefix
+    using PrefixCheck = std::function<bool(ByteView prefix, std::string& error)>;
+
+private:
+    std::unique_ptr<ByteSource> inner_;
+    uint64_t maxBytes_;
+    std::chrono::steady_clock::time_point deadline_;
+    size_t checkBytes_;
+    PrefixCheck check_;
+    bool checked_;
+    std::vector<uint8_t> prefix_;
+    size_t prefixPosition_;
+
+public:
+    LimitedByteSource(std::unique_ptr<ByteSource> inner, uint64_t maxBytes,
+                      std::chrono::steady_clock::time_point deadline,
+                      size_t checkBytes = 0, PrefixCheck check = nullptr);
+
+    size_t Read(uint8_t* buffer, size_t maxBytes) override;
+
+private:
+    bool CheckPrefix();
+};
+
+// Drain a source into a vector (for consumers that need contiguous data)
+bool ReadAllBytes(ByteSource& source, std::vector<uint8_t>& output, size_t sizeHint = 0);
+
+// The same, after what output already holds, so a prefix needs no second buffer
+bool AppendAllBytes(ByteSource& source, std::vector<uint8_t>& output, size_t sizeHint = 0);
+
+} // namespace X2FBX
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "AnimationTimingCorrector.h"
+#include "Logger.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace X2FBX {
+
+struct FBXExportOptions;
+struct KeyframeReductionOptions;
+struct AnimationResampleOptions;
+
+struct ConversionCacheOptions {
+    std::string directory;                   // Empty disables the cache
+    uint64_t maxBytes = 1024ull * 1024 * 1024;  // Least recently used entries are evicted past this
+
+    ConversionCacheOptions() = default;
+};
+
+// One cached conversion: the FBX files it wrote and its timing report
+struct CachedConversion {
+    std::vector<std::string> outputPaths;    // Where the files were restored (or stored from)
+    std::vector<TimingReportLine> timingReport;
+};
+
+struct ConversionCacheStatistics {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t stores = 0;
+    size_t evictions = 0;
+    uint64_t bytes = 0;                      // Running size of the entries
+};
+
+// Persistent content-addressed store of conversion outputs. An entry is
+// keyed by a hash of the input bytes and of every option that changes the
+// output, and lives in its own directory under the cache root:
+//
+//   <root>/<key>/manifest     outputs and timing report, written last
+//   <root>/<key>/out<N>       the N-th output file
+//
+// Entries are staged in a private temporary directory and renamed into
+// place, so concurrent writers (threads or processes) never expose a
+// partial entry. A restore that loses a race with eviction is a miss.
+// Besides whole conversions, ConversionStages keeps its intermediate
+// results here under keys derived from their upstream stage.
+class ConversionCache {
+private:
+    Logger& logger_;
+    ConversionCacheOptions options_;
+    std::mutex evictionMutex_;               // One eviction scan at a time in this process
+
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+    std::atomic<size_t> stores_;
+    std::atomic<size_t> evictions_;
+    std::atomic<uint64_t> totalBytes_;       // Size of the entries: scanned at open, then kept by Store
+
+public:
+    // Bumped whenever the entry layout or the conversion output changes
+    static constexpr int FORMAT_VERSION = 3;
+
+    explicit ConversionCache(const ConversionCacheOptions& options);
+
+    bool IsEnabled() const { return !options_.directory.empty(); }
+
+    // Everything besides the input bytes that changes what a conversion
+    // writes; keyReduction and resampling are null when that pass is off,
+    // an empty animation filter selects every animation set
+    static std::string Fingerprint(const FBXExportOptions& exportOptions, bool strictMode,
+                                   const KeyframeReductionOptions* keyReduction,
+                                   const std::vector<std::string>& animationFilter = {},
+                                   const AnimationResampleOptions* resampling = nullptr);
+
+    // The part of Fingerprint that the FBX export itself reads (mesh
+    // optimization runs before it)
+    static std::string ExportFingerprint(const FBXExportOptions& exportOptions);
+
+    // Key of an input file under an options fingerprint; empty when the
+    // input cannot be read
+    std::string ComputeKey(const std::string& inputPath, const std::string& fingerprint) const;
+    // The same key from input bytes already in memory
+    std::string ComputeKey(ByteView input, const std::string& fingerprint) const;
+
+    // Key of already hashed content under a fingerprint
+    static std::string MakeKey(uint64_t contentHash, const std::string& fingerprint);
+
+    // Key of a result computed from the entry under parentKey
+    static std::string DeriveKey(const std::string& parentKey, const std::string& fingerprint);
+
+    // Copy a cached entry's outputs into outputDirectory, renamed for
+    // baseName. Returns false on a miss.
+    bool Restore(const std::string& key, const std::string& outputDirectory, const std::string& baseName,
+                 CachedConversion& conversion);
+
+    // Like Restore, but outputPaths point at the files inside the entry.
+    // They are read-only and may be evicted once the caller has opened them.
+    bool Lookup(const std::string& key, CachedConversion& conversion);
+
+    // Record the outputs of a fresh conversion of baseName, then evict down
+    // to the size limit. The directory is only rescanned once the running
+    // total passes maxBytes. moveOutputs renames the files into the entry where
+    // it can instead of copying them (for files from TemporaryPath, which
+    // the caller removes afterwards either way).
+    bool Store(const std::string& key, const std::string& baseName, const CachedConversion& conversion,
+               bool moveOutputs = false);
+
+    // A unique path in the cache directory for a file that is about to be
+    // stored with moveOutputs; empty when the directory cannot be created
+    std::string TemporaryPath(const std::string& key, const std::string& extension);
+
+    ConversionCacheStatistics GetStatistics() const;
+
+    // 64-bit content hash (XXH64)
+    static uint64_t HashBytes(const uint8_t* data, size_t size, uint64_t seed = 0);
+
+private:
+    std::string EntryPath(const std::string& key) const;
+    // Restore into outputDirectory, or Lookup in place when it is null
+    bool Fetch(const std::string& key, const std::string* outputDirectory, const std::string& baseName,
+               CachedConversion& conversion);
+    // Scan the entries, evict least recently used ones past maxBytes and
+    // reset totalBytes_ to what remains
+    void EnforceSizeLimit();
+};
+
+} // namespace X2FBX
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace X2FBX {
+
+// Where a worker is within one file
+enum class ConversionStage {
+    IDLE = 0,
+    CACHE,          // Whole-conversion cache lookup
+    PARSE,          // Parsing, or loading a cached parse/prepare snapshot
+    PREPARE,        // Mesh optimization, timing correction, key reduction, resampling
+    EXPORT,         // FBX export or restoring cached clips
+    COUNT
+};
+
+const char* ConversionStageName(ConversionStage stage);
+
+// One worker as seen by a poll
+struct WorkerMetrics {
+    size_t id = 0;
+    bool busy = false;
+    ConversionStage stage = ConversionStage::IDLE;
+    std::string file;                   // Input being converted, empty when idle
+    double fileSeconds = 0.0;           // Time on the current file
+    double secondsSinceProgress = 0.0;  // Time since it last read, parsed or exported anything
+    uint64_t files = 0;                 // Files finished, successful or not
+    double busySeconds = 0.0;           // Time spent on files, summed
+};
+
+// Copy of every counter at one point in time
+struct MetricsSnapshot {
+    double uptimeSeconds = 0.0;
+    uint64_t bytesRead = 0;             // Input file bytes opened by the parsers
+    uint64_t bytesDecompressed = 0;     // Bytes pulled out of decompression streams
+    uint64_t objectsParsed = 0;         // Top-level data objects
+    uint64_t keysExported = 0;          // Animation keys written to FBX files
+    uint64_t filesQueued = 0;
+    uint64_t filesStarted = 0;
+    uint64_t filesConverted = 0;
+    uint64_t filesFailed = 0;
+    double stageSeconds[static_cast<size_t>(ConversionStage::COUNT)] = {};
+    uint64_t stageRuns[static_cast<size_t>(ConversionStage::COUNT)] = {};
+    std::vector<WorkerMetrics> workers;
+};
+
+struct MetricsWorkerState;
+
+// Process-wide conversion counters for long jobs: cheap enough to stay on
+// (one relaxed atomic add per file, object, decompressed chunk or clip)
+// and read by polling rather than from the log. Workers register a slot
+// and report the stage they are in, so a stalled or underused worker shows
+// up as a long time since progress or a low busy share of the uptime.
+class ConversionMetrics {
+private:
+    std::chrono::steady_clock::time_point origin_;
+    std::atomic<uint64_t> bytesRead_;
+    std::atomic<uint64_t> bytesDecompressed_;
+    std::atomic<uint64_t> objectsParsed_;
+    std::atomic<uint64_t> keysExported_;
+    std::atomic<uint64_t> filesQueued_;
+    std::atomic<uint64_t> filesStarted_;
+    std::atomic<uint64_t> filesConverted_;
+    std::atomic<uint64_t> filesFailed_;
+    std::atomic<uint64_t> stageNanoseconds_[static_cast<size_t>(ConversionStage::COUNT)];
+    std::atomic<uint64_t> stageRuns_[static_cast<size_t>(ConversionStage::COUNT)];
+
+    mutable std::mutex workersMutex_;
+    std::vector<std::unique_ptr<MetricsWorkerState>> workers_;
+
+    ConversionMetrics();
+
+    friend class MetricsWorkerSlot;
+
+public:
+    static ConversionMetrics& GetInstance();
+
+    ConversionMetrics(const ConversionMetrics&) = delete;
+    ConversionMetrics& operator=(const ConversionMetrics&) = delete;
+    ~ConversionMetrics();
+
+    // Also mark progress of the worker converting on this thread
+    void AddBytesRead(uint64_t bytes);
+    void AddBytesDecompressed(uint64_t bytes);
+    void AddObjectsParsed(uint64_t objects);
+    void AddKeysExported(uint64_t keys);
+
+    void AddFilesQueued(uint64_t files) { filesQueued_.fetch_add(files, std::memory_order_relaxed); }
+
+    MetricsSnapshot GetSnapshot() const;
+
+    // Prometheus text exposition format
+    std::string FormatPrometheus() const;
+
+    // Replace path with the current metrics, atomically for readers
+    bool WriteFile(const std::string& path) const;
+
+private:
+    void RecordStage(ConversionStage stage, std::chrono::steady_clock::duration elapsed);
+    uint64_t NowTicks() const;
+};
+
+// A worker's registration: reports which file and stage it is on.
+// Construct one per worker thread; released slots are reused, so worker
+// ids stay small across batches.
+class MetricsWorkerSlot {
+private:
+    ConversionMetrics& metrics_;
+    MetricsWorkerState* state_;
+
+public:
+    MetricsWorkerSlot();
+    ~MetricsWorkerSlot();
+
+    MetricsWorkerSlot(const MetricsWorkerSlot&) = delete;
+    MetricsWorkerSlot& operator=(const MetricsWorkerSlot&) = delete;
+
+    size_t GetId() const;
+
+    // Bracket one file; counters added on this thread in between count as
+    // this worker's progress
+    void BeginFile(const std::string& inputPath);
+    void EnterStage(ConversionStage stage);
+    void EndFile(bool success);
+};
+
+// Rewrites a metrics file every interval on a background thread, and
+// once more when destroyed
+class MetricsFileWriter {
+private:
+    std::string path_;
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_;
+    std::thread thread_;
+
+public:
+    MetricsFileWriter(const std::string& path, double intervalSeconds);
+    ~MetricsFileWriter();
+
+    MetricsFileWriter(const MetricsFileWriter&) = delete;
+    MetricsFileWriter& operator=(const MetricsFileWriter&) = delete;
+};
+
+} // namespace X2FBX
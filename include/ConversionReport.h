@@ -0,0 +1,139 @@
+#pragma once
+
+#include "XFileData.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace X2FBX {
+
+// CPU time consumed so far, for charging stages. 0 where the platform does
+// not expose the value.
+namespace CpuTime {
+
+    // By the calling thread
+    double GetThreadMilliseconds();
+
+    // By every thread of the process
+    double GetProcessMilliseconds();
+}
+
+// Wall and CPU time of one stage of a conversion
+struct StageCost {
+    double wallMs = 0.0;
+    double cpuMs = 0.0;
+
+    void Add(const StageCost& other) {
+        wallMs += other.wallMs;
+        cpuMs += other.cpuMs;
+    }
+};
+
+// Times consecutive stages: each Lap returns what passed since the previous
+// one (or construction). Thread CPU time leaves out helper threads (parallel
+// parse, background inflate, the writer stage) but stays right when files
+// convert side by side; process CPU time counts everything a lone
+// conversion does.
+class StageClock {
+public:
+    enum class Scope { THREAD, PROCESS };
+
+    explicit StageClock(Scope scope = Scope::THREAD);
+
+    StageCost Lap();
+    Scope GetScope() const { return scope_; }
+
+private:
+    double CpuNow() const;
+
+    Scope scope_;
+    std::chrono::steady_clock::time_point wallStart_;
+    double cpuStartMs_;
+};
+
+// What converting one file took and produced, one line of a --report json
+// file. Counts are taken after preparation, just before export.
+struct ConversionRecord {
+    std::string input;
+    bool success = false;
+    std::string error;
+    uint64_t inputBytes = 0;
+    std::string format;                  // "text", "binary", "compressed" or "snapshot"
+    std::string decompressionMethod;     // Compressed inputs (see XParseStatistics)
+    size_t decompressionAttempts = 0;
+    bool cacheHit = false;               // Outputs restored from the cache; no stage ran
+    bool parseSkipped = false;           // Parsed or prepared data loaded from a cached stage
+    StageClock::Scope cpuScope = StageClock::Scope::THREAD;
+    StageCost parse;                     // Cache lookups, parsing or a cached stage load
+    StageCost correct;                   // Mesh optimization, timing correction, key reduction, resampling, quantization
+    StageCost exported;                  // FBX export; files queued on a writer thread are written there
+    StageCost total;
+    uint64_t peakRssBytes = 0;           // Process high-water mark when the file finished
+    size_t arenaPeakBytes = 0;           // Parser scratch memory
+    size_t vertices = 0;
+    size_t faces = 0;
+    size_t materials = 0;
+    size_t bones = 0;
+    size_t animations = 0;
+    size_t keys = 0;
+    size_t outputs = 0;                  // FBX files written or restored
+
+    // Format from a probe's header and the decompression fields from the parse
+    void SetInput(const XFileHeader& header, bool snapshot, const XParseStatistics& statistics);
+    // Geometry summed over the static mesh and every entry of meshes;
+    // animations are the static mesh's, the ones exported as clips
+    void SetCounts(const XFileData& fileData);
+
+    // One JSON object, no trailing newline
+    std::string ToJson() const;
+};
+
+// Charges a conversion's time to the stage of record it is in: Enter
+// closes the current stage and opens the next one (nullptr closes the
+// last, as destruction does on an early return). Every lap also adds to
+// the record's total.
+class StageRecorder {
+public:
+    StageRecorder(ConversionRecord& record, StageClock::Scope scope, StageCost* first);
+    ~StageRecorder();
+
+    StageRecorder(const StageRecorder&) = delete;
+    StageRecorder& operator=(const StageRecorder&) = delete;
+
+    void Enter(StageCost* stage);
+
+private:
+    ConversionRecord& record_;
+    StageClock clock_;
+    StageCost* stage_;
+};
+
+// Appends JSON lines to a file, or to stdout for "-". Thread-safe.
+class ConversionReportWriter {
+public:
+    explicit ConversionReportWriter(const std::string& path);
+
+    // Points std::cout at stderr so that "-" writers are the only output on
+    // the process's standard output. Call before anything else is printed.
+    static void ReserveStdout();
+
+    ConversionReportWriter(const ConversionReportWriter&) = delete;
+    ConversionReportWriter& operator=(const ConversionReportWriter&) = delete;
+
+    bool IsOpen() const { return out_ != nullptr; }
+
+    void WriteLine(const std::string& json);
+    void Write(const ConversionRecord& record) { WriteLine(record.ToJson()); }
+
+private:
+    std::mutex mutex_;
+    std::ofstream file_;
+    std::ostream stdout_;   // On the real standard output
+    std::ostream* out_;
+};
+
+} // namespace X2FBX
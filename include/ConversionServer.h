@@ -0,0 +1,88 @@
+#pragma once
+
+#include "BatchConverter.h"
+#include "ConversionCache.h"
+#include "Logger.h"
+#include "TextureLibrary.h"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+
+namespace X2FBX {
+
+// Options for a long-running converter that takes requests over a socket
+struct ConversionServerOptions {
+    std::string socketPath;                  // Unix-domain socket to listen on
+    size_t workers = 0;                      // Warm workers, one connection each (0 = hardware threads)
+    BatchOptions defaults;                   // What a request gets for the fields it leaves out
+
+    ConversionServerOptions() = default;
+};
+
+// Keeps parsers and FBX exporters warm between conversions so a request
+// only pays for its own file. Clients connect to the socket and send one
+// JSON object per line:
+//
+//   {"id": 7, "input": "a.x", "output": "out", "backend": "native"}
+//
+// and read back one JSON line per request with the per-file
+// FBXExportResult fields and, under "report", the file's ConversionRecord.
+// Besides "input" and "output", a request may set
+// "optimize", "batchMaterials", "quantize", "strict", "validateTiming", "reduceKeys", "resample" (fps,
+// 0 = off), "backend" (auto|sdk|native), "compressArrays",
+// "compressionLevel", "validation" (none|cheap|full), "resolveTextures", "embedTextures",
+// "embedClipTextures" and "animations" (array of set names). "command" is "convert" (default),
+// "ping" (request, cache and exporter pool counters), "metrics" (the
+// ConversionMetrics Prometheus text as a string) or "shutdown". Each
+// worker thread owns one BatchWorker and serves one connection at a time;
+// the conversion cache and texture library are shared. "id" (a string or
+// a number) is echoed back; a request line longer than MAX_REQUEST_BYTES
+// gets a failure and the connection is closed.
+class ConversionServer {
+public:
+    static constexpr size_t MAX_REQUEST_BYTES = 1 << 20;
+
+private:
+    Logger& logger_;
+    ConversionServerOptions options_;
+    ConversionCache cache_;
+    TextureLibrary textures_;
+    std::atomic<bool> running_;
+    std::atomic<size_t> requestsHandled_;
+    std::mutex socketMutex_;                 // Guards listenFd_ between Stop and CloseSocket
+    int listenFd_;
+    std::string error_;
+
+public:
+    explicit ConversionServer(const ConversionServerOptions& options);
+    ~ConversionServer();
+
+    ConversionServer(const ConversionServer&) = delete;
+    ConversionServer& operator=(const ConversionServer&) = delete;
+
+    // Local sockets are only implemented on POSIX systems
+    static bool IsSupported();
+
+    // Bind and listen on the socket, replacing a stale socket file
+    bool Start();
+
+    // Accept connections on the worker threads until Stop or a shutdown request
+    void Serve();
+
+    // Stop accepting and remove the socket file; safe from any thread. The
+    // socket itself is closed when Serve returns (or on destruction).
+    void Stop();
+
+    // Answer one request line with its response line (no trailing newline)
+    std::string HandleRequest(const std::string& requestLine, BatchWorker& worker);
+
+    size_t GetRequestsHandled() const { return requestsHandled_.load(); }
+    const std::string& GetError() const { return error_; }
+
+private:
+    void ServeConnection(int clientFd, BatchWorker& worker);
+    void CloseSocket();
+};
+
+} // namespace X2FBX
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "AnimationTimingCorrector.h"
+#include "ConversionCache.h"
+#include "FBXExporter.h"
+#include "MappedFile.h"
+#include "XFileData.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace X2FBX {
+
+struct KeyframeReductionOptions;
+struct AnimationResampleOptions;
+struct MeshOptimizationOptions;
+
+// Keys of the data stages of one input; both empty when it cannot be read
+struct StageKeys {
+    std::string parse;      // Input bytes, strict mode and animation filter
+    std::string prepare;    // parse plus mesh optimization, keyframe reduction and resampling
+
+    bool IsValid() const { return !parse.empty(); }
+};
+
+// The conversion as a chain of cached stages:
+//
+//   parse -> prepare -> export, one entry per clip (or the static mesh)
+//
+// parse caches the parser output and prepare the data after mesh
+// optimization, timing correction, keyframe reduction and resampling,
+// both as XFileSnapshots keyed by their upstream stage and the options
+// they read.
+// Exports are keyed by content instead: a hash of the prepared mesh, of the
+// clip and of the export options. A re-run after only export settings
+// changed (frame rate, axes, backend) loads the prepared snapshot and skips
+// parsing and mesh work; an edited input re-parses but restores every clip
+// whose mesh and keys came out the same. Stage entries live in the
+// conversion cache and are evicted with everything else.
+class ConversionStages {
+private:
+    ConversionCache& cache_;
+
+public:
+    explicit ConversionStages(ConversionCache& cache);
+
+    bool IsEnabled() const { return cache_.IsEnabled(); }
+
+    // meshOptimization, keyReduction and resampling are null when that pass
+    // is off; quantize is the StreamQuantizer pass, last of the prepare stage
+    StageKeys ComputeKeys(const std::string& inputPath, bool strictMode,
+                          const std::vector<std::string>& animationFilter,
+                          const MeshOptimizationOptions* meshOptimization,
+                          const KeyframeReductionOptions* keyReduction,
+                          const AnimationResampleOptions* resampling = nullptr, bool quantize = false) const;
+    // The same keys from input bytes already in memory
+    StageKeys ComputeKeys(ByteView input, bool strictMode, const std::vector<std::string>& animationFilter,
+                          const MeshOptimizationOptions* meshOptimization, const KeyframeReductionOptions* keyReduction,
+                          const AnimationResampleOptions* resampling = nullptr, bool quantize = false) const;
+
+    // Load the data cached under a stage key, with its timing report when
+    // timingReport is given. Returns false on a miss.
+    bool LoadData(const std::string& key, XFileData& fileData,
+                  std::vector<TimingReportLine>* timingReport = nullptr);
+
+    // Cache the output of a data stage; quantize stores a quantized
+    // snapshot, for data the StreamQuantizer pass went over
+    bool StoreData(const std::string& key, const XFileData& fileData,
+                   const std::vector<TimingReportLine>& timingReport = {}, bool quantize = false);
+
+    // ExportAllAnimations, restoring every clip exported before from the
+    // same mesh and keys with the same options; the others are exported and
+    // cached. Results are in clip order; restored ones carry only their path.
+    std::vector<FBXExportResult> ExportAnimations(FBXExporter& exporter, XMeshData& meshData,
+                                                  const std::string& outputDirectory, const std::string& baseName,
+                                                  const FBXExportOptions& options, size_t& restoredClips);
+
+    // ExportStaticMesh to <outputDirectory>/<baseName>.fbx the same way
+    FBXExportResult ExportStaticMesh(FBXExporter& exporter, XMeshData&& meshData,
+                                     const std::string& outputDirectory, const std::string& baseName,
+                                     const FBXExportOptions& options, bool& restored);
+
+    // Content hashes behind the export keys. HashMesh covers everything
+    // the exporters read except the animations, HashAnimation one clip.
+    static uint64_t HashMesh(const XMeshData& meshData);
+    static uint64_t HashAnimation(const XAnimationSet& animation);
+};
+
+} // namespace X2FBX
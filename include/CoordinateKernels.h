@@ -0,0 +1,57 @@
+#pragma once
+
+#include "XFileData.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace X2FBX {
+
+// Batched DirectX to FBX conversion of whole arrays. DirectX is left-handed
+// Y-up; the exporters map (x, y, z) -> (x, z, -y), the same basis change for
+// positions, normals, quaternion axes and, as B^T * M * B, matrices. The
+// SSE2 versions give bit-identical results to the scalar ones, which are
+// kept for builds without SSE2 and as the reference in tests.
+namespace CoordinateKernels {
+    // "SSE2" or "scalar": what the kernels below run on this build and setting
+    const char* GetActiveKernels();
+
+    // Route every kernel through the scalar versions (for comparisons);
+    // AnimationResampler's blends follow the same switch
+    void SetScalarOnly(bool scalarOnly);
+
+    // Whether the SSE2 versions run: built with SSE2 and not scalar-only
+    bool UseSimd();
+
+    // count vectors to (x, z, -y) doubles, stride 3, or stride 4 with w in
+    // the fourth component (the FbxVector4 layout)
+    void ConvertVectors(const XVector3* input, size_t count, double* output);
+    void ConvertVectors4(const XVector3* input, size_t count, double* output, double w = 1.0);
+
+    // count interleaved x, y, z keys to three curves: x, z and y, the last
+    // negated for translations and left as is for scales
+    void SplitVectorKeys(const float* xyz, size_t count, float* outX, float* outY, float* outZ, bool negateZ);
+
+    // count interleaved x, y, z, w quaternions to (x, z, -y, w), normalized;
+    // zero quaternions become the identity. input may equal output.
+    void ConvertQuaternions(const float* input, size_t count, float* output);
+
+    // count row-vector matrices to B^T * M * B; input may equal output
+    void ConvertMatrices(const XMatrix4x4* input, size_t count, XMatrix4x4* output);
+
+    // Triangle list to FBX PolygonVertexIndex: the last index of every
+    // triangle stored as ~index, optionally with the winding reversed.
+    // Returns the largest index compared unsigned, so a negative one is
+    // out of range too (0 for no indices).
+    uint32_t TrianglesToPolygonIndices(const int* indices, size_t indexCount, int32_t* output, bool reverseWinding);
+
+    // The portable versions the kernels above are checked against
+    namespace Scalar {
+        void ConvertVectors(const XVector3* input, size_t count, double* output);
+        void ConvertVectors4(const XVector3* input, size_t count, double* output, double w);
+        void SplitVectorKeys(const float* xyz, size_t count, float* outX, float* outY, float* outZ, bool negateZ);
+        void ConvertQuaternions(const float* input, size_t count, float* output);
+        void ConvertMatrices(const XMatrix4x4* input, size_t count, XMatrix4x4* output);
+    }
+}
+
+} // namespace X2FBX
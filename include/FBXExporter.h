@@ -2,6 +2,7 @@
 
 #include "XFileData.h"
 #include "Logger.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
@@ -13,6 +14,14 @@
 
 namespace X2FBX {
 
+namespace FBXUtils {
+struct SkeletonPose;
+}
+
+class TextureSet;
+class OutputWriter;
+class OutputValidator;
+
 // Export result information
 struct FBXExportResult {
     bool success;
@@ -26,10 +35,11 @@ struct FBXExportResult {
     int bonesExported;
     int animationsExported;
     float exportTimeMs;
+    uint64_t peakRssBytes;      // Process high-water mark when the export finished
 
     FBXExportResult() : success(false), verticesExported(0), facesExported(0),
                        materialsExported(0), bonesExported(0), animationsExported(0),
-                       exportTimeMs(0.0f) {}
+                       exportTimeMs(0.0f), peakRssBytes(0) {}
 };
 
 // Export options
@@ -38,23 +48,76 @@ struct FBXExportOptions {
     bool exportMaterials = true;
     bool exportTextures = true;
     bool embedTextures = false;
+
+    // Texture files of the mesh found by a TextureLibrary. Materials then
+    // reference the resolved files and embedding reads their shared
+    // content; without a set texture paths are written as parsed and
+    // nothing is embedded.
+    std::shared_ptr<const TextureSet> textures;
+
+    // With embedTextures, also embed into the per-clip files of
+    // ExportAllAnimations; false makes clips reference the resolved files
+    bool embedTexturesInClips = true;
     bool optimizeMesh = true;
-    bool validateOutput = true;
+    bool batchMaterials = false;   // With optimizeMesh: merge identical materials, one submesh each
+    bool quantize = false;         // Streams and rotation keys carried quantized (StreamQuantizer)
+
+    // How much of the output is checked. CHEAP checks index ranges and
+    // stream counts while the mesh is copied into the file, with no extra
+    // pass; an invalid mesh fails the export. FULL also reads every written
+    // file back (FBXUtils::CheckFBXFile), on the validator's thread when
+    // one is set, otherwise before the export returns.
+    enum class Validation {
+        NONE,
+        CHEAP,
+        FULL
+    } validation = Validation::CHEAP;
+    OutputValidator* validator = nullptr;
 
     // Coordinate system conversion
     bool convertCoordinateSystem = true;
     bool flipYZ = true;              // DirectX to FBX coordinate conversion
+    bool reverseWinding = false;     // Flip every triangle, for sources with inverted winding
 
     // Animation settings
     bool separateAnimationFiles = true;
     float animationFrameRate = 30.0f;
 
+    // Clips exported concurrently when writing one file per animation; each
+    // worker has its own FBX manager and scene (0 = one per hardware thread)
+    size_t animationExportThreads = 1;
+
+    // Skin clusters filled concurrently once created (0 = hardware threads)
+    size_t skinClusterThreads = 1;
+
     // File format
     enum class FileFormat {
         BINARY,
         ASCII
     } fileFormat = FileFormat::BINARY;
 
+    // Deflate the large array properties of binary files (vertices,
+    // indices, normals, UVs and keys) at zlib level 0-9, -1 for zlib's
+    // default. Higher levels trade export CPU for smaller files.
+    bool compressArrays = true;
+    int compressionLevel = -1;
+
+    // Threads deflating one large array in chunks (0 = hardware threads);
+    // native backend only
+    size_t compressionThreads = 1;
+
+    // Write stage that takes the finished files (native backend only); the
+    // export then returns before the file is on disk
+    OutputWriter* outputWriter = nullptr;
+
+    // Writer: the FBX SDK, or the built-in binary writer (NativeFBXWriter),
+    // which always writes binary. AUTO picks the SDK when it was compiled in.
+    enum class Backend {
+        AUTO,
+        FBX_SDK,
+        NATIVE
+    } backend = Backend::AUTO;
+
     FBXExportOptions() = default;
 };
 
@@ -69,10 +132,17 @@ private:
     FbxExporter* fbxExporter_;
 
     // Current export state
-    std::vector<FbxNode*> boneNodes_;
-    std::map<std::string, FbxNode*> boneNodeMap_;
+    std::vector<FbxNode*> boneNodes_;                    // Indexed like XMeshData::bones
+    std::unique_ptr<FBXUtils::SkeletonPose> ownedPose_;  // Built by CreateSkeleton without a shared pose
+
+    // The scene holds the mesh, skeleton and skin of the clips being
+    // exported; each clip only adds and removes its animation stack
+    bool clipSceneReady_;
 #endif
 
+    // Skeleton pose computed once by ExportAllAnimations for all its clips
+    const FBXUtils::SkeletonPose* sharedPose_;
+
     // Export statistics
     mutable FBXExportResult lastExportResult_;
 
@@ -89,26 +159,44 @@ public:
                                      const std::string& outputPath,
                                      const FBXExportOptions& options = FBXExportOptions());
 
+    // Streaming export for very large scenes: each stream of meshData is
+    // freed as soon as it is in the FBX scene, and the scene is destroyed
+    // right after it is written, so the X data, the scene and the writer's
+    // buffers are never all resident at once. meshData is left empty.
+    FBXExportResult ExportStaticMesh(XMeshData&& meshData,
+                                     const std::string& outputPath,
+                                     const FBXExportOptions& options = FBXExportOptions());
+
     FBXExportResult ExportAnimatedMesh(const XMeshData& meshData,
                                       const XAnimationSet& animation,
                                       const std::string& outputPath,
                                       const FBXExportOptions& options = FBXExportOptions());
 
+    // One file per animation, <outputDirectory>/<baseFileName>_<clip>.fbx.
+    // Results are in animation order.
     std::vector<FBXExportResult> ExportAllAnimations(const XMeshData& meshData,
                                                      const std::string& outputDirectory,
                                                      const std::string& baseFileName,
                                                      const FBXExportOptions& options = FBXExportOptions());
 
-    // Validation
+    // Read a written file back and log what CheckFBXFile found
     bool ValidateExportedFile(const std::string& filePath) const;
 
     // Get last export result
     const FBXExportResult& GetLastExportResult() const { return lastExportResult_; }
 
+    // Empty the scene and forget the last export, keeping the FBX manager,
+    // IO settings and writer for the next job (see FBXExporterPool)
+    void ResetForReuse();
+
     // SDK availability
     static bool IsFBXSDKAvailable();
     static std::string GetFBXSDKVersion();
 
+    // The backend an export with these options uses; never AUTO. FBX_SDK
+    // without the SDK compiled in writes placeholder files.
+    static FBXExportOptions::Backend ResolveBackend(const FBXExportOptions& options);
+
 private:
 #ifdef FBXSDK_FOUND
     // Initialization
@@ -122,37 +210,41 @@ private:
     FBXExportResult ExportWithFBXSDK(const XFileData& xData, const std::string& outputPath, const FBXExportOptions& options);
     bool ExportMeshes(const XFileData& xData, const FBXExportOptions& options);
     bool CreateMesh(const XMeshData& meshData, const FBXExportOptions& options);
-    bool SaveFBXFile(const std::string& outputPath);
+    bool SaveFBXFile(const std::string& outputPath, const FBXExportOptions& options);
     bool ExportSeparateAnimations(const XFileData& xData, const std::string& basePath, const FBXExportOptions& options);
     bool ExportCombinedAnimations(const XFileData& xData, const FBXExportOptions& options);
-#endif
-
-    // Placeholder export when SDK not available
-    FBXExportResult ExportPlaceholder(const XFileData& xData, const std::string& outputPath, const FBXExportOptions& options);
-
-    // Mesh conversion
-    FbxMesh* CreateFBXMesh(const XMeshData& meshData, const std::string& meshName);
+    bool BuildClipScene(const XMeshData& meshData, const FBXExportOptions& options);
+
+    // Mesh conversion. With release set (to &meshData), every source
+    // stream is freed once it has been copied into the mesh. validate
+    // checks the triangle indices as they are copied and fails on bad ones.
+    // convertAxes applies the DirectX to FBX axis conversion.
+    FbxMesh* CreateFBXMesh(const XMeshData& meshData, const std::string& meshName, bool reverseWinding,
+                           XMeshData* release = nullptr, bool validate = false, bool convertAxes = true);
     bool ConvertVertices(const XMeshData& meshData, FbxMesh* fbxMesh);
     bool ConvertFaces(const XMeshData& meshData, FbxMesh* fbxMesh);
     bool ConvertNormals(const XMeshData& meshData, FbxMesh* fbxMesh);
     bool ConvertUVs(const XMeshData& meshData, FbxMesh* fbxMesh);
 
     // Material conversion
-    std::vector<FbxSurfacePhong*> ConvertMaterials(const XMeshData& meshData);
+    std::vector<FbxSurfacePhong*> ConvertMaterials(const XMeshData& meshData, const FBXExportOptions& options);
     FbxSurfacePhong* CreateFBXMaterial(const XMaterial& xMaterial);
     FbxFileTexture* CreateFBXTexture(const std::string& texturePath);
 
     // Skeleton conversion
-    bool CreateSkeleton(const XMeshData& meshData);
-    FbxNode* CreateBoneNode(const XBone& bone, FbxNode* parentNode = nullptr);
-    bool ApplySkinWeights(const XMeshData& meshData, FbxMesh* fbxMesh);
+    bool CreateSkeleton(const XMeshData& meshData, bool convertAxes);
+    FbxNode* CreateBoneNode(const std::string& name, const XBone& bone, const XMatrix4x4& localTransform,
+                            FbxNode* parentNode);
+    const FBXUtils::SkeletonPose* GetSkeletonPose() const;
+    bool ApplySkinWeights(const XMeshData& meshData, FbxMesh* fbxMesh, size_t threads = 1);
 
     // Animation conversion
-    bool CreateAnimation(const XAnimationSet& animation, float frameRate);
+    bool CreateAnimation(const XAnimationSet& animation, float frameRate, bool convertAxes,
+                         FbxAnimStack** createdStack = nullptr);
     FbxAnimStack* CreateAnimationStack(const XAnimationSet& animation);
     FbxAnimLayer* CreateAnimationLayer(FbxAnimStack* animStack);
     bool CreateKeyframes(const XAnimationSet& animation, FbxAnimLayer* animLayer);
-    bool CreateNodeAnimation(FbxNode* node, const std::vector<XKeyframe>& keyframes, FbxAnimLayer* animLayer);
+    bool CreateNodeAnimation(FbxNode* node, const XBoneTrack& track, FbxAnimLayer* animLayer);
 
     // Coordinate system conversion
     void ConvertCoordinateSystem(FbxVector4& vector) const;
@@ -169,6 +261,31 @@ private:
     bool ValidateScene() const;
     bool ValidateMesh(FbxMesh* mesh) const;
     bool ValidateAnimation(FbxAnimStack* animStack) const;
+#endif
+
+    // One clip of ExportAllAnimations, reusing the clip scene when there is one
+    FBXExportResult ExportClip(const XMeshData& meshData, const XAnimationSet& animation,
+                               const std::string& outputPath, const FBXExportOptions& options);
+
+    // Shared by both ExportStaticMesh overloads
+    FBXExportResult ExportStaticMeshImpl(const XMeshData& meshData, const std::string& outputPath,
+                                         const FBXExportOptions& options, XMeshData* release);
+
+    // Built-in writer backend. Only reads this exporter's shared pose, so
+    // clips may be written concurrently. Without a pose one is built when
+    // the skeleton is exported.
+    FBXExportResult ExportNative(const XMeshData& meshData, const std::string& meshName, bool exportSkeleton,
+                                 const std::vector<const XAnimationSet*>& animations,
+                                 const std::string& outputPath, const FBXExportOptions& options) const;
+
+    // Placeholder export when SDK not available; it only reports counts,
+    // so callers pass those instead of building data to count
+    FBXExportResult ExportPlaceholder(size_t meshCount, size_t materialCount, size_t animationCount,
+                                      const std::string& outputPath, const FBXExportOptions& options);
+
+    // FULL validation of a file an export wrote: queued on options.validator
+    // or checked now. Fails with error only when checked now.
+    bool CheckWrittenFile(const std::string& outputPath, const FBXExportOptions& options, std::string& error) const;
 
     // Utility functions
     std::string GenerateUniqueNodeName(const std::string& baseName) const;
@@ -182,11 +299,80 @@ namespace FBXUtils {
     XQuaternion DirectXToFBXRotation(const XQuaternion& dxRot);
     XMatrix4x4 DirectXToFBXMatrix(const XMatrix4x4& dxMatrix);
 
+    // Translation, XYZ Euler angles in degrees and scale of an affine
+    // row-vector matrix: the Lcl properties of an FBX node
+    void DecomposeMatrix(const XMatrix4x4& matrix, XVector3& translation, XVector3& rotation, XVector3& scale);
+
+    // Inverse of an affine row-vector matrix (last column 0, 0, 0, 1)
+    XMatrix4x4 InvertAffineMatrix(const XMatrix4x4& matrix);
+
+    // Bind pose of a skeleton in FBX conventions, indexed like
+    // XMeshData::bones. Built in one pass over the parents-first bones and
+    // shared by every clip exported from the same mesh.
+    struct SkeletonPose {
+        std::vector<XMatrix4x4> local;      // Relative to the parent bone
+        std::vector<XMatrix4x4> world;      // Bind matrices of the skin clusters
+    };
+
+    // Fails when the bones are not in parents-first order. Without
+    // convertAxes the matrices keep the DirectX axes.
+    bool BuildSkeletonPose(const XMeshData& meshData, SkeletonPose& pose, bool convertAxes = true);
+
+    // A bone track converted to FBX conventions in one pass: the DirectX
+    // axis swap, quaternion to XYZ Euler and radians to degrees. One value
+    // array per animation curve; the three curves of a transform share the
+    // key times of their channel. Unkeyed channels stay empty. Without
+    // convertAxes the keys keep the DirectX axes (rotations are still
+    // normalized).
+    struct CurveChannels {
+        enum Channel { TX, TY, TZ, RX, RY, RZ, SX, SY, SZ, CHANNEL_COUNT };
+        enum Transform { TRANSLATION, ROTATION, SCALE, TRANSFORM_COUNT };   // Channel / 3
+
+        std::vector<double> times[TRANSFORM_COUNT];  // Seconds
+        std::vector<float> values[CHANNEL_COUNT];
+        std::vector<float> quaternions;              // Scratch: FBX-axis unit quaternions
+    };
+
+    void BuildCurveChannels(const XBoneTrack& track, float ticksPerSecond, CurveChannels& channels,
+                            bool convertAxes = true);
+
+    // Skin influences regrouped per bone with one pass over the vertices.
+    // Bone b owns controlPoints/weights [offsets[b], offsets[b + 1]), in
+    // vertex order, ready to hand to its FbxCluster in bulk.
+    struct SkinClusters {
+        std::vector<size_t> offsets;        // Bone count + 1 entries
+        std::vector<int> controlPoints;
+        std::vector<double> weights;
+
+        size_t GetInfluenceCount(size_t bone) const { return offsets[bone + 1] - offsets[bone]; }
+    };
+
+    void BuildSkinClusters(const XMeshData& meshData, SkinClusters& clusters);
+
     // Animation timing conversion
     double ConvertXTimeToFBXTime(float xTime, float xTicksPerSecond);
     float ConvertFBXTimeToXTime(double fbxTime, float xTicksPerSecond);
 
-    // Validation utilities
+    // What CheckFBXFile found in a file
+    struct FBXFileCheck {
+        bool valid = false;
+        std::string error;             // First problem found
+        uint32_t version = 0;          // 7400 for FBX 7.4
+        bool binary = false;
+        size_t topLevel = 0;           // Top-level records
+        size_t geometries = 0;
+        size_t vertices = 0;           // Control points of all geometries
+        size_t polygons = 0;
+        uint64_t fileBytes = 0;
+    };
+
+    // Read a file back in one pass: every binary record up to the footer,
+    // every property (deflated arrays inflated when built with zlib), and
+    // the control points and polygon indices of each Geometry. ASCII files
+    // only get their header checked.
+    FBXFileCheck CheckFBXFile(const std::string& filePath);
+
+    // Validation utilities, on top of CheckFBXFile
     bool IsValidFBXFile(const std::string& filePath);
     std::string GetFBXFileInfo(const std::string& filePath);
 
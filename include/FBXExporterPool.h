@@ -0,0 +1,80 @@
+#pragma once
+
+#include "FBXExporter.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace X2FBX {
+
+struct FBXExporterPoolStatistics {
+    size_t hits = 0;          // Acquires served by an idle exporter
+    size_t misses = 0;        // Acquires that had to construct one (and its FbxManager)
+    size_t sceneResets = 0;   // Scenes cleared for the next export instead of recreated
+    size_t idle = 0;          // Exporters waiting in the pool right now
+};
+
+// Process-wide pool of FBX exporters. Constructing an FBXExporter creates an
+// FbxManager, its IO settings and an FbxExporter, which costs more than
+// exporting a small file, so exporters are handed out as leases and go back
+// to the pool, scene cleared, when the lease ends. Batch workers, the
+// conversion server and the clip workers of ExportAllAnimations all draw
+// from it, so a second batch, the next request or the next file's clips
+// find their exporters warm. Thread-safe.
+class FBXExporterPool {
+public:
+    // Exclusive use of one exporter until destroyed or reset
+    class Lease {
+    public:
+        Lease() : pool_(nullptr) {}
+        Lease(Lease&& other) noexcept : pool_(other.pool_), exporter_(std::move(other.exporter_)) {}
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease() { Reset(); }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        FBXExporter* get() const { return exporter_.get(); }
+        FBXExporter* operator->() const { return exporter_.get(); }
+        FBXExporter& operator*() const { return *exporter_; }
+        explicit operator bool() const { return exporter_ != nullptr; }
+
+        // Return the exporter to the pool now
+        void Reset();
+
+    private:
+        friend class FBXExporterPool;
+        Lease(FBXExporterPool* pool, std::unique_ptr<FBXExporter> exporter)
+            : pool_(pool), exporter_(std::move(exporter)) {}
+
+        FBXExporterPool* pool_;
+        std::unique_ptr<FBXExporter> exporter_;
+    };
+
+    static FBXExporterPool& GetInstance();
+
+    // An idle exporter if there is one, otherwise a new one
+    Lease Acquire();
+
+    // Destroy the idle exporters; leased ones return to the pool as usual
+    void Clear();
+
+    // Called by exporters that reuse their scene; only the SDK backend has one
+    void RecordSceneReset() { sceneResets_.fetch_add(1, std::memory_order_relaxed); }
+
+    FBXExporterPoolStatistics GetStatistics() const;
+
+private:
+    FBXExporterPool();
+    void Release(std::unique_ptr<FBXExporter> exporter);
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<FBXExporter>> idle_;
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+    std::atomic<size_t> sceneResets_;
+};
+
+} // namespace X2FBX
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+namespace X2FBX {
+
+// Escapes text for a JSON string literal (without the quotes): quote,
+// backslash and every control character, the common ones by their short
+// form and the rest as \u00XX. Used by the hand-written JSON of the
+// profiler, the conversion server and the conversion report.
+std::string EscapeJson(const std::string& text);
+
+} // namespace X2FBX
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "XFileData.h"
+#include "Logger.h"
+#include <cstddef>
+#include <vector>
+
+namespace X2FBX {
+
+// Error tolerances for dropping keys. A key is removed only when
+// interpolating its neighbours reproduces it within its channel's tolerance.
+struct KeyframeReductionOptions {
+    float positionTolerance = 0.001f;   // Model units
+    float rotationTolerance = 0.05f;    // Degrees
+    float scaleTolerance = 0.001f;
+    size_t threads = 0;                 // Bone tracks reduced in parallel (0 = hardware threads)
+
+    KeyframeReductionOptions() = default;
+};
+
+// What a reduction pass removed
+struct KeyframeReductionResult {
+    size_t tracks = 0;
+    size_t channels = 0;
+    size_t constantChannels = 0;        // Collapsed to a single key
+    size_t originalKeys = 0;
+    size_t remainingKeys = 0;
+
+    // Estimated FBX payload: a channel key is a time and a value on each
+    // of its three curves
+    static constexpr size_t BYTES_PER_EXPORTED_KEY = 3 * (sizeof(long long) + sizeof(float));
+
+    size_t RemovedKeys() const { return originalKeys - remainingKeys; }
+    size_t BytesSaved() const { return RemovedKeys() * BYTES_PER_EXPORTED_KEY; }
+
+    void Add(const KeyframeReductionResult& other) {
+        tracks += other.tracks;
+        channels += other.channels;
+        constantChannels += other.constantChannels;
+        originalKeys += other.originalKeys;
+        remainingKeys += other.remainingKeys;
+    }
+};
+
+// Curve simplification for per-bone keyframe tracks. Each channel is
+// reduced on its own: translation and scale against linear interpolation,
+// rotation against slerp.
+class KeyframeReducer {
+private:
+    Logger& logger_;
+    KeyframeReductionOptions options_;
+
+public:
+    explicit KeyframeReducer(const KeyframeReductionOptions& options = KeyframeReductionOptions());
+
+    // Reduce every bone track of the animations in place
+    KeyframeReductionResult ReduceAnimation(XAnimationSet& animation) const;
+    KeyframeReductionResult ReduceAllAnimations(std::vector<XAnimationSet>& animations) const;
+
+    // Reduce every channel of one track in place
+    KeyframeReductionResult ReduceTrack(XBoneTrack& track) const;
+
+    void GenerateReductionReport(const KeyframeReductionResult& result) const;
+
+private:
+    KeyframeReductionResult ReduceTracks(const std::vector<XBoneTrack*>& tracks) const;
+
+    // Returns the keys removed; components selects the error metric
+    size_t ReduceChannel(XAnimationChannel& channel, size_t components, float tolerance) const;
+};
+
+} // namespace X2FBX
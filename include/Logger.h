@@ -5,7 +5,11 @@
 #include <memory>
 #include <chrono>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
 #include <vector>
+#include <cstdint>
 
 namespace X2FBX {
 
@@ -17,16 +21,32 @@ enum class LogLevel {
     CRITICAL = 4
 };
 
+class LogRingBuffer;
+
+// Messages are queued on a lock-free ring and written by a background
+// thread in batches. Producers only take the timestamp and move the
+// message in; formatting and I/O happen on the writer thread.
 class Logger {
 private:
-    static std::unique_ptr<Logger> instance_;
-    static std::mutex mutex_;
+    std::atomic<int> currentLevel_;
+    std::atomic<bool> enableConsole_;
+    std::atomic<bool> enableFile_;
+    std::string logFilePath_;
 
+    // Writer side: logFile_ is only touched by the writer thread, or by
+    // Initialize under fileMutex_
     std::ofstream logFile_;
-    LogLevel currentLevel_;
-    bool enableConsole_;
-    bool enableFile_;
-    std::string logFilePath_;
+    std::mutex fileMutex_;
+
+    std::unique_ptr<LogRingBuffer> queue_;
+    std::thread writer_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;   // Wakes the writer
+    std::condition_variable drainedCondition_; // Wakes Flush() callers
+    std::atomic<bool> writerSleeping_;
+    std::atomic<bool> stopping_;
+    std::atomic<size_t> enqueued_;
+    std::atomic<size_t> written_;
 
     Logger();
 
@@ -43,9 +63,14 @@ public:
     ~Logger();
 
     // Configuration
-    void SetLogLevel(LogLevel level) { currentLevel_ = level; }
-    void EnableConsoleOutput(bool enable) { enableConsole_ = enable; }
-    void EnableFileOutput(bool enable) { enableFile_ = enable; }
+    void SetLogLevel(LogLevel level) { currentLevel_.store(static_cast<int>(level), std::memory_order_relaxed); }
+    void EnableConsoleOutput(bool enable) { enableConsole_.store(enable, std::memory_order_relaxed); }
+    void EnableFileOutput(bool enable) { enableFile_.store(enable, std::memory_order_relaxed); }
+
+    // Cheap filter check; callers test it before building a message
+    bool IsEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= currentLevel_.load(std::memory_order_relaxed);
+    }
 
     // Logging methods
     void Log(LogLevel level, const std::string& message,
@@ -67,32 +92,52 @@ public:
     // Progress reporting
     void LogProgress(const std::string& operation, int current, int total);
 
-    // Flush logs
+    // Block until every message logged so far has been written
     void Flush();
 
 private:
-    std::string GetCurrentTimestamp() const;
+    void Enqueue(LogLevel level, std::string message, const std::string& file, int line);
+    void WakeWriter();
+    void WriterLoop();
+    size_t WriteBatch(std::string& consoleOut, std::string& consoleErr, std::string& fileOut);
+
+    std::string FormatTimestamp(std::chrono::system_clock::time_point time) const;
     std::string LogLevelToString(LogLevel level) const;
-    std::string FormatLogMessage(LogLevel level, const std::string& message,
-                                const std::string& file, int line) const;
+    std::string FormatLogMessage(LogLevel level, std::chrono::system_clock::time_point time,
+                                const std::string& message, const std::string& file, int line) const;
 };
 
-// Convenience macros for logging with file and line info
-#define LOG_DEBUG(msg) Logger::GetInstance().Debug(msg, __FILE__, __LINE__)
-#define LOG_INFO(msg) Logger::GetInstance().Info(msg, __FILE__, __LINE__)
-#define LOG_WARNING(msg) Logger::GetInstance().Warning(msg, __FILE__, __LINE__)
-#define LOG_ERROR(msg) Logger::GetInstance().Error(msg, __FILE__, __LINE__)
-#define LOG_CRITICAL(msg) Logger::GetInstance().Critical(msg, __FILE__, __LINE__)
-
-// Timing helper class
+// Convenience macros for logging with file and line info. The message
+// expression is only evaluated when the level is enabled.
+#define X2FBX_LOG(level, method, msg)                                          \
+    do {                                                                       \
+        ::X2FBX::Logger& x2fbxLogger_ = ::X2FBX::Logger::GetInstance();        \
+        if (x2fbxLogger_.IsEnabled(level)) {                                   \
+            x2fbxLogger_.method(msg, __FILE__, __LINE__);                      \
+        }                                                                      \
+    } while (0)
+
+#define LOG_DEBUG(msg) X2FBX_LOG(::X2FBX::LogLevel::DEBUG, Debug, msg)
+#define LOG_INFO(msg) X2FBX_LOG(::X2FBX::LogLevel::INFO, Info, msg)
+#define LOG_WARNING(msg) X2FBX_LOG(::X2FBX::LogLevel::WARNING, Warning, msg)
+#define LOG_ERROR(msg) X2FBX_LOG(::X2FBX::LogLevel::ERROR, Error, msg)
+#define LOG_CRITICAL(msg) X2FBX_LOG(::X2FBX::LogLevel::CRITICAL, Critical, msg)
+
+// Timing helper class. Logs the elapsed time and, when the profiler is
+// enabled, records the scope (nested under any enclosing TimingLogger).
 class TimingLogger {
 private:
     std::string operation_;
     std::chrono::high_resolution_clock::time_point startTime_;
+    uint64_t bytes_;
+    bool profiled_;
 
 public:
     explicit TimingLogger(const std::string& operation);
     ~TimingLogger();
+
+    // Bytes processed by this scope, for throughput in the profile
+    void AddBytes(uint64_t bytes) { bytes_ += bytes; }
 };
 
 // Macro for easy timing
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace X2FBX {
+
+// Non-owning view over a contiguous block of bytes.
+// Used to hand the same input buffer (usually a MappedFile) to detection,
+// text parsing, binary parsing and decompression without copying it.
+class ByteView {
+private:
+    const uint8_t* data_;
+    size_t size_;
+
+public:
+    ByteView() : data_(nullptr), size_(0) {}
+    ByteView(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+    ByteView(const std::vector<uint8_t>& bytes) : data_(bytes.data()), size_(bytes.size()) {}
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const uint8_t* begin() const { return data_; }
+    const uint8_t* end() const { return data_ + size_; }
+    uint8_t operator[](size_t index) const { return data_[index]; }
+
+    // Clamped sub-range; never reads past the end of the view
+    ByteView Subview(size_t offset, size_t length = static_cast<size_t>(-1)) const {
+        if (offset >= size_) return ByteView(data_ + size_, 0);
+        size_t available = size_ - offset;
+        return ByteView(data_ + offset, length < available ? length : available);
+    }
+
+    std::string_view AsStringView() const {
+        return std::string_view(reinterpret_cast<const char*>(data_), size_);
+    }
+
+    // True if the view starts with the given literal bytes
+    bool StartsWith(std::string_view prefix, size_t offset = 0) const {
+        return offset <= size_ && size_ - offset >= prefix.size() &&
+               AsStringView().compare(offset, prefix.size(), prefix) == 0;
+    }
+};
+
+// Read-only file mapping (mmap on POSIX, MapViewOfFile on Windows).
+// Falls back to reading the file into an owned buffer when the platform
+// refuses to map it (pipes, special files), so callers always get a ByteView.
+class MappedFile {
+private:
+    const uint8_t* data_;
+    size_t size_;
+    bool mapped_;
+    bool isOpen_;
+    std::vector<uint8_t> fallbackBuffer_;
+
+#ifdef _WIN32
+    void* fileHandle_;
+    void* mappingHandle_;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool Open(const std::string& filepath);
+    void Close();
+
+    bool IsOpen() const { return isOpen_; }
+    bool IsMapped() const { return mapped_; }
+    size_t GetSize() const { return size_; }
+    ByteView View() const { return ByteView(data_, size_); }
+
+    // Read at most maxBytes from the start of a file without mapping it.
+    // Format detection only needs the 16-byte .x header.
+    static std::vector<uint8_t> ReadPrefix(const std::string& filepath, size_t maxBytes);
+
+private:
+    bool ReadIntoBuffer(const std::string& filepath);
+    void MoveFrom(MappedFile& other) noexcept;
+};
+
+} // namespace X2FBX
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "XFileData.h"
+#include "Logger.h"
+#include <cstddef>
+#include <vector>
+
+namespace X2FBX {
+
+// Stages of the pre-export mesh pass. Every stage is lossless: welding
+// only merges vertices whose streams are bit-identical.
+struct MeshOptimizationOptions {
+    bool weldVertices = true;
+    bool removeDegenerateTriangles = true;
+    bool reorderForVertexCache = true;
+    size_t cacheSize = 32;              // Post-transform cache modelled by the reorder
+
+    // Merge bit-identical materials and make each material's triangles
+    // contiguous (one submesh per material); the cache reorder then works
+    // within each submesh. Off by default: it changes material numbering.
+    bool batchMaterials = false;
+
+    MeshOptimizationOptions() = default;
+};
+
+// What an optimization pass changed
+struct MeshOptimizationResult {
+    bool applied = false;               // False when the mesh was left untouched
+    size_t originalVertices = 0;
+    size_t remainingVertices = 0;
+    size_t weldedVertices = 0;          // Merged into an identical vertex
+    size_t originalTriangles = 0;
+    size_t remainingTriangles = 0;
+    size_t degenerateTriangles = 0;
+    double acmrBefore = 0.0;            // Average cache misses per triangle
+    double acmrAfter = 0.0;
+    size_t originalMaterials = 0;
+    size_t remainingMaterials = 0;
+    size_t submeshes = 0;               // Runs of one material, with batchMaterials
+
+    size_t RemovedVertices() const { return originalVertices - remainingVertices; }
+    size_t MergedMaterials() const { return originalMaterials - remainingMaterials; }
+};
+
+// What MergeMeshes combined
+struct MeshMergeResult {
+    size_t originalMeshes = 0;
+    size_t remainingMeshes = 0;
+    size_t originalMaterials = 0;       // Summed over the meshes
+    size_t remainingMaterials = 0;
+};
+
+// Vertex welding, degenerate triangle removal and vertex-cache ordering for
+// XMeshData. Runs before export so the FBX mesh and its skin clusters are
+// built from the smaller vertex set. Every stage is linear in the mesh size.
+class MeshOptimizer {
+private:
+    Logger& logger_;
+    MeshOptimizationOptions options_;
+
+public:
+    explicit MeshOptimizer(const MeshOptimizationOptions& options = MeshOptimizationOptions());
+
+    // Run the enabled stages in place. Meshes with out-of-range indices or
+    // mismatched streams are left unchanged.
+    MeshOptimizationResult Optimize(XMeshData& meshData) const;
+
+    // Merge vertices with identical position, normal, uv and skin
+    // influences; returns the vertices removed
+    size_t WeldVertices(XMeshData& meshData) const;
+
+    // Drop triangles with repeated vertices or zero area; returns the
+    // triangles removed
+    size_t RemoveDegenerateTriangles(XMeshData& meshData) const;
+
+    // Reorder triangles for the post-transform cache (Forsyth's linear-speed
+    // algorithm), then renumber vertices in first-use order
+    void ReorderForVertexCache(XMeshData& meshData) const;
+
+    // Average cache misses per triangle for a FIFO cache of cacheSize entries
+    static double ComputeACMR(const std::vector<int>& indices, size_t vertexCount, size_t cacheSize);
+
+    // Point every face at the first of its bit-identical materials and drop
+    // the others; returns the materials removed
+    size_t DeduplicateMaterials(XMeshData& meshData) const;
+
+    // Stable sort of the triangles by material, faces without one first;
+    // returns the number of material runs (submeshes)
+    size_t GroupFacesByMaterial(XMeshData& meshData) const;
+
+    // Combine the static meshes (no bones, skin or animations) that carry
+    // the same vertex streams into one mesh each, in place of the first of
+    // them, with their materials deduplicated (and, with batchMaterials,
+    // their faces grouped). Skinned and animated meshes are kept as they
+    // are, and so are meshes with inconsistent streams or indices.
+    MeshMergeResult MergeMeshes(std::vector<XMeshData>& meshes) const;
+
+    void GenerateOptimizationReport(const MeshOptimizationResult& result) const;
+
+private:
+    bool CanOptimize(const XMeshData& meshData) const;
+
+    // Keep vertices in first-use order and drop the unreferenced ones
+    void CompactVertices(XMeshData& meshData) const;
+};
+
+} // namespace X2FBX
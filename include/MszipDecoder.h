@@ -0,0 +1,74 @@
+#pragma once
+
+#include "ByteSource.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace X2FBX {
+
+// DirectX compressed .x files ("tzip"/"bzip") use MSZIP, the deflate
+// framing from cabinet files. After the 16-byte xof header the payload is
+//
+//   DWORD  decompressed size, including the 16-byte header
+//   blocks until that size is reached:
+//     WORD  decompressed block size (at most 32 KB)
+//     WORD  compressed block size, including the signature
+//     "CK"  signature, then one raw deflate stream
+//
+// Each block may reference the previous 32 KB of output, so blocks are
+// inflated with that history as the deflate dictionary.
+namespace Mszip {
+
+    constexpr size_t HISTORY_SIZE = 32 * 1024;
+
+    struct Block {
+        size_t offset;               // Start of the deflate data in the payload
+        size_t compressedSize;       // Deflate bytes, without the signature
+        size_t decompressedSize;
+        size_t outputOffset;         // Position of the block in the decompressed data
+    };
+
+    // Read and check the block table without inflating anything. Fails on
+    // a missing signature, blocks running past the input, or block sizes
+    // that do not add up to the declared size.
+    bool ReadBlockTable(ByteView payload, std::vector<Block>& blocks,
+                        size_t& decompressedSize, std::string& error);
+
+    // Decode the whole payload into output. Blocks are first inflated in
+    // parallel without history; the ones that turn out to reference earlier
+    // output are then inflated again, in order, with their dictionary.
+    bool DecodeParallel(ByteView payload, std::vector<uint8_t>& output,
+                        size_t workerCount, std::string& error);
+}
+
+// Streams an MSZIP payload one block at a time; each block is inflated
+// exactly once and only the current block plus history stay resident.
+class MszipByteSource : public ByteSource {
+private:
+    struct State;
+
+    ByteView payload_;
+    std::vector<Mszip::Block> blocks_;
+    size_t decompressedSize_;
+    size_t nextBlock_;
+    std::vector<uint8_t> history_;
+    std::vector<uint8_t> block_;
+    size_t blockPosition_;
+    std::unique_ptr<State> state_;
+
+public:
+    explicit MszipByteSource(ByteView payload);
+    ~MszipByteSource() override;
+
+    size_t Read(uint8_t* buffer, size_t maxBytes) override;
+
+    size_t GetDecompressedSize() const { return decompressedSize_; }
+    size_t GetBlockCount() const { return blocks_.size(); }
+
+private:
+    bool DecodeNextBlock();
+};
+
+} // namespace X2FBX
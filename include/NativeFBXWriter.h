@@ -0,0 +1,86 @@
+#pragma once
+
+#include "XFileData.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace X2FBX {
+
+namespace FBXUtils {
+struct SkeletonPose;
+}
+
+class TextureSet;
+class OutputWriter;
+
+// What NativeFBXWriter puts into one file. Everything is borrowed from the
+// caller and only read while Write runs.
+struct NativeFBXScene {
+    const XMeshData* mesh = nullptr;
+    std::string meshName = "Mesh";                   // Geometry; the model is <meshName>Node
+    bool exportMaterials = true;
+    bool exportTextures = true;                      // Diffuse, normal and specular textures of the materials
+    const TextureSet* textures = nullptr;            // Resolved files; without, paths are written as parsed
+    bool embedTextures = false;                      // Loaded images as Video objects, one per distinct file
+    bool exportSkeleton = false;                     // Bones, skin clusters and bind pose
+    bool reverseWinding = false;                     // Flip every triangle
+    bool convertAxes = true;                         // DirectX to FBX axes; pose must match
+    bool validate = false;                           // Check indices and stream counts while writing
+    const FBXUtils::SkeletonPose* pose = nullptr;    // Required with exportSkeleton
+    std::vector<const XAnimationSet*> animations;    // One animation stack each, needs the skeleton
+    float frameRate = 30.0f;                         // Scene time mode
+};
+
+// Binary FBX 7.4 writer for the subset the converter produces: one mesh
+// with normals, UVs and textured materials (images optionally embedded),
+// the skeleton with its skin clusters and bind pose, and animation stacks
+// of linear curves. Geometry and keys go
+// straight from the XMeshData streams into the node records, with the same
+// axis conversion as the FBX SDK backend; large arrays are deflated when
+// zlib is available (see SetCompression). A writer has no shared state, so
+// writers on different threads never contend.
+class NativeFBXWriter {
+public:
+    // The newest version whose node records use 32-bit offsets
+    static constexpr uint32_t FBX_VERSION = 7400;
+    // Array properties at least this large are deflated
+    static constexpr size_t COMPRESS_MIN_BYTES = 128;
+
+    NativeFBXWriter()
+        : compressArrays_(true), compressionLevel_(-1), compressionThreads_(1), outputWriter_(nullptr),
+          bytesWritten_(0) {}
+
+    // Deflate array properties of at least COMPRESS_MIN_BYTES at zlib level
+    // (0-9, -1 for zlib's default). Arrays larger than a chunk are split
+    // across up to threads threads (0 = hardware threads); the written
+    // bytes do not depend on the thread count.
+    void SetCompression(bool compressArrays, int level = -1, size_t threads = 1) {
+        compressArrays_ = compressArrays;
+        compressionLevel_ = level;
+        compressionThreads_ = threads;
+    }
+
+    // Hand finished files to a write stage instead of writing them on the
+    // calling thread; Write then only fails on scenes it cannot encode and
+    // write errors are reported by the OutputWriter
+    void SetOutputWriter(OutputWriter* writer) { outputWriter_ = writer; }
+
+    // Fails without writing anything when scene.validate finds the mesh
+    // invalid; the error then starts with "Validation failed"
+    bool Write(const NativeFBXScene& scene, const std::string& outputPath);
+
+    const std::string& GetError() const { return error_; }
+    uint64_t GetBytesWritten() const { return bytesWritten_; }
+
+private:
+    bool compressArrays_;
+    int compressionLevel_;
+    size_t compressionThreads_;
+    OutputWriter* outputWriter_;
+    std::string error_;
+    uint64_t bytesWritten_;
+};
+
+} // namespace X2FBX
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace X2FBX {
+
+// zlib compression of large buffers across cores. The input is cut into
+// fixed-size chunks that are deflated independently (each primed with the
+// 32 KiB of input before it) and joined into one zlib stream that any
+// inflater reads. Chunk boundaries depend only on the input size, never on
+// the thread count, so the output is the same however many threads run.
+namespace ParallelDeflate {
+
+    constexpr size_t DEFAULT_CHUNK_BYTES = 256 * 1024;
+
+    // True when the build has zlib (HAVE_ZLIB)
+    bool IsAvailable();
+
+    // Compress size bytes at zlib level (0-9, -1 for zlib's default) on up
+    // to threads threads (0 = hardware threads) into out. Fails without
+    // zlib or on a zlib error, leaving out unspecified.
+    bool Compress(const uint8_t* data, size_t size, int level, size_t threads, std::vector<uint8_t>& out,
+                  size_t chunkBytes = DEFAULT_CHUNK_BYTES);
+}
+
+} // namespace X2FBX
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace X2FBX {
+
+// Small helpers for spreading independent work items across threads
+namespace ParallelUtils {
+
+    // Number of workers to use when the caller does not specify one
+    size_t GetDefaultThreadCount();
+
+    // Clamp a requested worker count to [1, itemCount]; 0 means "use the default"
+    size_t ResolveThreadCount(size_t requested, size_t itemCount);
+
+    // Run body(index, workerId) for every index in [0, count).
+    // Items are pulled from a shared atomic counter, so uneven item costs balance
+    // out across workers. workerId is stable per thread and lies in [0, threads),
+    // which lets callers keep per-worker state in a plain vector.
+    // With a single worker the body runs on the calling thread.
+    void ParallelFor(size_t count, size_t threads,
+                     const std::function<void(size_t index, size_t workerId)>& body);
+}
+
+} // namespace X2FBX
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <utility>
+
+namespace X2FBX {
+
+// Monotonic arena for parse-time scratch data (object trees, names, index
+// lists). Allocations are bump-pointer cheap and nothing is freed until
+// Release(), which drops the whole parse in one shot. Peak usage is tracked
+// so callers can report how much memory a parse needed.
+class ParseArena {
+private:
+    // Upstream resource that counts the bytes held by the arena
+    class TrackingResource : public std::pmr::memory_resource {
+    public:
+        size_t bytesInUse = 0;
+        size_t peakBytes = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    TrackingResource upstream_;
+    std::pmr::monotonic_buffer_resource arena_;
+
+public:
+    explicit ParseArena(size_t initialBlockSize = 64 * 1024);
+    ~ParseArena() = default;
+
+    ParseArena(const ParseArena&) = delete;
+    ParseArena& operator=(const ParseArena&) = delete;
+
+    // Resource for std::pmr containers that live for one parse
+    std::pmr::memory_resource* Resource() { return &arena_; }
+
+    // Copy text into the arena; the view stays valid until Release()
+    std::string_view CopyString(std::string_view text);
+
+    // Construct an object in the arena. Its destructor is never run, so T
+    // must only own memory that also comes from this arena.
+    template <typename T, typename... Args>
+    T* Create(Args&&... args) {
+        void* memory = arena_.allocate(sizeof(T), alignof(T));
+        return new (memory) T(std::forward<Args>(args)...);
+    }
+
+    // Return all blocks to the system. Every container using Resource()
+    // must be empty (or destroyed) first.
+    void Release() { arena_.release(); }
+
+    // Usage statistics
+    size_t GetBytesInUse() const { return upstream_.bytesInUse; }
+    size_t GetPeakBytes() const { return upstream_.peakBytes; }
+    void ResetPeak() { upstream_.peakBytes = upstream_.bytesInUse; }
+};
+
+} // namespace X2FBX
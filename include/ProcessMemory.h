@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+namespace X2FBX {
+
+// Resident memory of the converter process, for reporting what a stage
+// cost. 0 where the platform does not expose the value.
+namespace ProcessMemory {
+
+    // High-water mark of the resident set since the process started
+    uint64_t GetPeakRssBytes();
+
+    // Resident set right now
+    uint64_t GetCurrentRssBytes();
+}
+
+} // namespace X2FBX
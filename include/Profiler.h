@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace X2FBX {
+
+// Aggregated timings of one scope path, e.g.
+// "XFileParser::ParseFile/ParseTextFormat/ParseMeshObject"
+struct ProfileStats {
+    uint64_t count = 0;
+    double totalMs = 0.0;
+    double childMs = 0.0;               // Time spent in nested scopes
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    uint64_t bytes = 0;                 // Bytes processed, when the scope reports them
+
+    double SelfMs() const { return totalMs - childMs; }
+    void Add(const ProfileStats& other);
+};
+
+struct ProfileThread;
+
+// Hierarchical phase profiler fed by TimingLogger scopes. Each thread keeps
+// its own scope stack and totals, so recording never contends across
+// threads; summaries merge them. Disabled (the default) it costs one
+// relaxed load per scope.
+class Profiler {
+private:
+    std::atomic<bool> enabled_;
+    std::atomic<bool> recordTrace_;
+    std::chrono::steady_clock::time_point origin_;
+
+    mutable std::mutex threadsMutex_;
+    std::vector<std::unique_ptr<ProfileThread>> threads_;
+
+    Profiler();
+
+public:
+    // Trace events kept per thread; later scopes are counted but not traced
+    static constexpr size_t MAX_TRACE_EVENTS_PER_THREAD = 1000000;
+
+    static Profiler& GetInstance();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+    ~Profiler();
+
+    // Enable before the work starts; recordTrace also keeps every scope
+    // instance for a Chrome trace
+    void Enable(bool enable, bool recordTrace = false);
+    bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Drop everything recorded so far
+    void Reset();
+
+    void BeginScope(const std::string& name);
+    void EndScope(uint64_t bytes = 0);
+
+    // Totals per scope path, merged over threads
+    std::map<std::string, ProfileStats> GetTotals() const;
+
+    // Machine-readable summary: totals plus per-thread breakdown
+    bool WriteSummary(const std::string& path) const;
+
+    // Chrome trace-event JSON (chrome://tracing, Perfetto)
+    bool WriteChromeTrace(const std::string& path) const;
+
+private:
+    ProfileThread& CurrentThread();
+};
+
+} // namespace X2FBX
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "XFileData.h"
+#include "Logger.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace X2FBX {
+
+// Compact encodings for vertex streams and rotation keys:
+//   - positions and UVs: 16-bit unsigned normalized over the mesh's bounds
+//   - normals: octahedral, two 16-bit signed normalized components
+//   - rotations: smallest three, the largest component dropped and the
+//     others stored as 20-bit values with its 2-bit index in 64 bits
+// Decoding an encoded value and encoding it again gives the same code, so
+// quantized data survives further round trips unchanged.
+namespace Quantization {
+
+constexpr uint32_t UNORM16_MAX = 0xFFFF;
+constexpr int32_t SNORM16_MAX = 0x7FFF;
+constexpr uint32_t ROTATION_BITS = 20;
+
+// Range covered by one stream's codes, per component
+struct Bounds {
+    float min[3] = {0.0f, 0.0f, 0.0f};
+    float extent[3] = {0.0f, 0.0f, 0.0f};   // 0 when every value is min
+};
+
+// Streams of one mesh in their quantized form; an empty vector is a
+// stream the mesh lacks
+struct QuantizedStreams {
+    Bounds positionBounds;
+    Bounds texCoordBounds;                  // u and v
+    std::vector<uint16_t> positions;        // 3 per vertex
+    std::vector<int16_t> normals;           // 2 per vertex
+    std::vector<uint16_t> texCoords;        // 2 per vertex
+};
+
+uint16_t EncodeUnorm16(float value, float min, float extent);
+float DecodeUnorm16(uint16_t code, float min, float extent);
+
+void EncodeOctahedral(const XVector3& normal, int16_t code[2]);
+XVector3 DecodeOctahedral(const int16_t code[2]);
+
+// q is x, y, z, w (XBoneTrack order); q and -q encode alike
+uint64_t EncodeSmallestThree(const float q[4]);
+void DecodeSmallestThree(uint64_t code, float q[4]);
+
+QuantizedStreams EncodeStreams(const XMeshData& meshData);
+// Replaces the streams that are present in streams
+void DecodeStreams(const QuantizedStreams& streams, XMeshData& meshData);
+
+std::vector<uint64_t> EncodeRotations(const XAnimationChannel& rotation);
+void DecodeRotations(const uint64_t* codes, size_t keyCount, XAnimationChannel& rotation);
+
+} // namespace Quantization
+
+// Largest error of a quantize pass, per stream, and the bytes the streams
+// take as floats and quantized
+struct QuantizationResult {
+    size_t meshes = 0;
+    size_t vertices = 0;
+    size_t rotationKeys = 0;
+    double maxPositionError = 0.0;        // Distance, in mesh units
+    double maxTexCoordError = 0.0;        // Per component
+    double maxNormalErrorDegrees = 0.0;
+    double maxRotationErrorDegrees = 0.0;
+    uint64_t floatBytes = 0;
+    uint64_t quantizedBytes = 0;
+
+    void Merge(const QuantizationResult& other);
+};
+
+// Carries a file's vertex streams and rotation keys at quantized precision:
+// every value is replaced by the decode of its code, so exports, caches and
+// snapshots (XFileSnapshot::Write with quantize) all see the same values.
+class StreamQuantizer {
+private:
+    Logger& logger_;
+
+public:
+    StreamQuantizer();
+
+    // Every mesh and animation set of the file
+    QuantizationResult Quantize(XFileData& fileData) const;
+
+    // One mesh's streams and its animation sets
+    QuantizationResult QuantizeMesh(XMeshData& meshData) const;
+
+    QuantizationResult QuantizeAnimations(std::vector<XAnimationSet>& animations) const;
+
+    // One line with the error bounds of asset
+    void GenerateQuantizationReport(const QuantizationResult& result, const std::string& asset) const;
+};
+
+} // namespace X2FBX
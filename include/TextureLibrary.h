@@ -0,0 +1,122 @@
+#pragma once
+
+#include "XFileData.h"
+#include "Logger.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace X2FBX {
+
+// One texture file as the exporters see it
+struct TextureImage {
+    std::string resolvedPath;                            // Absolute path of the file found; empty when missing
+    uint64_t fileBytes = 0;
+    int64_t modifiedTime = 0;                            // File time, only compared for cache keys
+    std::shared_ptr<const std::vector<uint8_t>> content; // File bytes, when read for embedding
+
+    bool IsResolved() const { return !resolvedPath.empty(); }
+};
+
+// The textures of one mesh, keyed by the paths written in its materials.
+// Entries are filled on the library's I/O threads; Get waits for its own.
+class TextureSet {
+public:
+    // Null when texturePath was not requested
+    std::shared_ptr<const TextureImage> Get(const std::string& texturePath) const;
+
+    // Resolved path, size and time of every entry, for export cache keys
+    std::string Fingerprint() const;
+
+    size_t GetCount() const { return entries_.size(); }
+
+private:
+    friend class TextureLibrary;
+    using ImageFuture = std::shared_future<std::shared_ptr<const TextureImage>>;
+
+    std::vector<std::pair<std::string, ImageFuture>> entries_;   // Few per mesh; scanned
+};
+
+struct TextureLibraryOptions {
+    std::vector<std::string> searchDirectories;   // Tried after the input file's directory
+    size_t ioThreads = 2;                         // Files read at once (0 = hardware threads)
+    uint64_t maxEmbedBytes = 256ull << 20;        // Larger files are referenced, never embedded
+    uint64_t maxCachedBytes = 1024ull << 20;      // Loaded content kept for later meshes
+
+    TextureLibraryOptions() = default;
+};
+
+struct TextureLibraryStatistics {
+    size_t requests = 0;          // Texture paths asked for, counted per mesh
+    size_t lookups = 0;           // Distinct paths resolved against the file system
+    size_t missing = 0;           // Lookups that found no file
+    size_t loads = 0;             // Files read for embedding
+    uint64_t bytesLoaded = 0;
+};
+
+// Shared texture resolution for a batch. Material texture paths are
+// written on the artist's machine, so each one is looked up as written,
+// next to the input file, by file name next to the input file, and then in
+// the search directories. Every distinct path is resolved once, and each
+// file is read at most once while it stays cached, however many meshes and
+// clip files use it. Lookups and reads run on the library's I/O threads,
+// so they overlap with parsing and mesh preparation; exporters wait on the
+// TextureSet only when they write the texture. Thread-safe.
+class TextureLibrary {
+public:
+    explicit TextureLibrary(const TextureLibraryOptions& options = TextureLibraryOptions());
+    ~TextureLibrary();   // Finishes queued lookups first
+
+    TextureLibrary(const TextureLibrary&) = delete;
+    TextureLibrary& operator=(const TextureLibrary&) = delete;
+
+    // Queue every texture of meshData's materials (diffuse, normal and
+    // specular); loadContent also reads the files for embedding
+    std::shared_ptr<const TextureSet> Request(const XMeshData& meshData, const std::string& inputPath,
+                                              bool loadContent);
+
+    TextureLibraryStatistics GetStatistics() const;
+
+    // Files tried for texturePath, in order
+    static std::vector<std::string> CandidatePaths(const std::string& texturePath, const std::string& inputDirectory,
+                                                   const std::vector<std::string>& searchDirectories);
+
+private:
+    using ImageFuture = TextureSet::ImageFuture;
+    using ContentFuture = std::shared_future<std::shared_ptr<const std::vector<uint8_t>>>;
+
+    ImageFuture Lookup(const std::string& texturePath, const std::string& inputDirectory, bool loadContent);
+    std::shared_ptr<const TextureImage> Resolve(const std::string& key, const std::string& texturePath,
+                                                const std::string& inputDirectory, bool loadContent);
+    std::shared_ptr<const std::vector<uint8_t>> LoadContent(const std::string& resolvedPath, uint64_t fileBytes,
+                                                            bool& cached);
+
+    void Submit(std::function<void()> job);
+    void RunIoThread();
+
+    Logger& logger_;
+    TextureLibraryOptions options_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, ImageFuture> images_;        // By lookup key (input directory, path, content flag)
+    std::map<std::string, ContentFuture> contents_;    // By resolved path
+    uint64_t cachedBytes_;
+    TextureLibraryStatistics statistics_;
+
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> jobs_;
+    std::vector<std::thread> threads_;                 // Started with the first job
+    bool stopping_;
+};
+
+} // namespace X2FBX
@@ -2,8 +2,11 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <deque>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 namespace X2FBX {
 
@@ -56,14 +59,43 @@ struct XMaterial {
     std::string specularTexture;
 };
 
-// Keyframe data for animations
-struct XKeyframe {
-    float time;                    // Time in .x file ticks
-    XVector3 position;
-    XQuaternion rotation;
-    XVector3 scale;
+// Keys of one transform channel as parallel arrays: the key times and the
+// channel's components for every key, packed
+struct XAnimationChannel {
+    std::vector<float> times;          // In .x file ticks, ascending
+    std::vector<float> values;         // components floats per key
+
+    size_t GetKeyCount() const { return times.size(); }
+    bool IsEmpty() const { return times.empty(); }
+    const float* GetValue(size_t key, size_t components) const { return &values[key * components]; }
+
+    void Reserve(size_t keys, size_t components);
+    void AddKey(float time, const float* value, size_t components);
+
+    // Stable reorder by time, for files that list keys out of order
+    void SortByTime(size_t components);
+
+    size_t GetMemoryUsage() const;
+};
 
-    XKeyframe() : time(0), scale(1, 1, 1) {}
+// The channels one Animation object keys for a bone. A channel the file
+// does not key stays empty instead of carrying default values.
+struct XBoneTrack {
+    static constexpr size_t ROTATION_COMPONENTS = 4;   // Quaternion x, y, z, w
+    static constexpr size_t VECTOR_COMPONENTS = 3;     // Translation and scale x, y, z
+
+    int boneId;                        // Index into XMeshData::bones, -1 = no target frame
+    XAnimationChannel rotation;
+    XAnimationChannel translation;
+    XAnimationChannel scale;
+
+    XBoneTrack() : boneId(-1) {}
+
+    size_t GetKeyCount() const {
+        return rotation.GetKeyCount() + translation.GetKeyCount() + scale.GetKeyCount();
+    }
+    float GetEndTime() const;
+    size_t GetMemoryUsage() const;
 };
 
 // Animation set representing one named animation
@@ -71,8 +103,7 @@ struct XAnimationSet {
     std::string name;
     float duration;                // Total duration in .x file ticks
     float ticksPerSecond;         // Ticks per second (critical for timing!)
-    std::vector<XKeyframe> keyframes;
-    std::map<std::string, std::vector<XKeyframe>> boneKeyframes; // Per-bone keyframes
+    std::vector<XBoneTrack> tracks; // At most one per bone; unbound tracks have bone id -1
 
     XAnimationSet() : duration(0), ticksPerSecond(4800.0f) {} // Default DirectX value
 
@@ -80,13 +111,60 @@ struct XAnimationSet {
     float GetDurationInSeconds() const {
         return ticksPerSecond > 0 ? duration / ticksPerSecond : 0;
     }
+
+    // Replaces an earlier track of the same bone, like a repeated Animation
+    // object in the file
+    void AddTrack(XBoneTrack track);
+
+    size_t GetKeyCount() const;
+    size_t GetMemoryUsage() const;
 };
 
-// Bone/Joint data
-struct XBone {
+// An AnimationSet as seen by the first parse pass. A set that was not
+// decoded keeps the byte range of its body in the parser input, so its
+// keys can still be decoded on request (EnhancedXFileParser::DecodeAnimations).
+struct XAnimationSetInfo {
     std::string name;
-    std::string parentName;
-    int parentIndex;
+    size_t offset;                // First byte after the opening brace
+    size_t length;                // Up to and including the closing brace
+    size_t trackCount;            // Animation objects
+    size_t keyCount;              // Keys declared by their AnimationKey objects
+    float ticksPerSecond;
+    bool decoded;                 // Present in XMeshData::animations
+
+    XAnimationSetInfo() : offset(0), length(0), trackCount(0), keyCount(0),
+                          ticksPerSecond(4800.0f), decoded(false) {}
+};
+
+// Interned names with dense integer ids in first-seen order. Each name is
+// stored once and looked up by hash.
+class XNameTable {
+private:
+    std::deque<std::string> names_;                     // Stable storage for the views below
+    std::unordered_map<std::string_view, int> ids_;
+
+public:
+    XNameTable() = default;
+    XNameTable(const XNameTable& other);
+    XNameTable& operator=(const XNameTable& other);
+    XNameTable(XNameTable&&) = default;
+    XNameTable& operator=(XNameTable&&) = default;
+
+    // Id of name, added when it is new
+    int Intern(std::string_view name);
+    // -1 when the name was never interned
+    int Find(std::string_view name) const;
+    const std::string& GetName(int id) const { return names_[id]; }
+
+    size_t size() const { return names_.size(); }
+    bool empty() const { return names_.empty(); }
+    void clear();
+};
+
+// Bone/Joint data. The name lives in XMeshData::boneNames under the
+// bone's index.
+struct XBone {
+    int parentIndex;              // Parsed bones come parents first
     XMatrix4x4 bindPose;          // Bind pose transformation
     XMatrix4x4 offsetMatrix;      // Inverse bind pose
     std::vector<int> childIndices;
@@ -94,45 +172,73 @@ struct XBone {
     XBone() : parentIndex(-1) {}
 };
 
-// Vertex data
+// Fixed-width skin influences for one vertex. Unused slots have bone -1
+// and weight 0; slots are filled in insertion order.
+struct XVertexInfluences {
+    static constexpr int MAX_INFLUENCES = 4;
+
+    int boneIndices[MAX_INFLUENCES];
+    float boneWeights[MAX_INFLUENCES];
+
+    XVertexInfluences() {
+        for (int i = 0; i < MAX_INFLUENCES; i++) {
+            boneIndices[i] = -1;
+            boneWeights[i] = 0.0f;
+        }
+    }
+
+    int GetCount() const {
+        int count = 0;
+        while (count < MAX_INFLUENCES && boneIndices[count] >= 0) count++;
+        return count;
+    }
+
+    // Returns false if all slots were taken; the weakest influence is
+    // replaced when the new one is stronger
+    bool Add(int boneIndex, float weight);
+
+    // Scale weights so they sum to one (after influences were dropped)
+    void Normalize();
+};
+
+// Vertex data (compatibility view; meshes store vertices as streams)
 struct XVertex {
     XVector3 position;
     XVector3 normal;
     XVector2 texCoord;
-    std::vector<int> boneIndices;     // Up to 4 bone influences
-    std::vector<float> boneWeights;   // Corresponding weights
-
-    XVertex() {
-        boneIndices.reserve(4);
-        boneWeights.reserve(4);
-    }
+    XVertexInfluences influences;
 };
 
-// Face/Triangle data
+// Face/Triangle data (compatibility view; meshes store a flat index buffer)
 struct XFace {
     int indices[3];               // Triangle vertex indices
-    std::vector<int> vertexIndices; // Alternative access as vector
     int materialIndex;
 
     XFace() : materialIndex(-1) {
         indices[0] = indices[1] = indices[2] = 0;
-        vertexIndices = {0, 0, 0};
     }
 
-    // Update both representations when indices change
     void SetIndices(int i0, int i1, int i2) {
         indices[0] = i0; indices[1] = i1; indices[2] = i2;
-        vertexIndices = {i0, i1, i2};
     }
 };
 
-// Complete mesh data from .x file
+// Complete mesh data from .x file.
+// Geometry is stored structure-of-arrays: positions, normals and texCoords
+// are parallel per-vertex streams, triangles are a flat index buffer with
+// one material index per face. normals, texCoords and skinInfluences are
+// either empty (not present in the file) or sized to the vertex count.
 struct XMeshData {
     std::string name;
-    std::vector<XVertex> vertices;
-    std::vector<XFace> faces;
+    std::vector<XVector3> positions;
+    std::vector<XVector3> normals;
+    std::vector<XVector2> texCoords;
+    std::vector<XVertexInfluences> skinInfluences;
+    std::vector<int> indices;           // 3 per triangle
+    std::vector<int> faceMaterials;     // 1 per triangle, -1 = none
     std::vector<XMaterial> materials;
     std::vector<XBone> bones;
+    XNameTable boneNames;               // Bone i is named by id i
     std::vector<XAnimationSet> animations;
 
     // File-level timing information
@@ -140,16 +246,68 @@ struct XMeshData {
     bool hasTimingInfo;
 
     XMeshData() : globalTicksPerSecond(4800.0f), hasTimingInfo(false) {}
+    XMeshData(XMeshData&&) = default;
+    XMeshData& operator=(XMeshData&&) = default;
+    XMeshData& operator=(const XMeshData&) = delete;
+
+    // Streams are only ever moved between stages; a copy has to be asked for
+    XMeshData Clone() const { return XMeshData(*this); }
 
     // Utility functions
-    size_t GetVertexCount() const { return vertices.size(); }
-    size_t GetFaceCount() const { return faces.size(); }
+    size_t GetVertexCount() const { return positions.size(); }
+    size_t GetFaceCount() const { return faceMaterials.size(); }
     size_t GetBoneCount() const { return bones.size(); }
     size_t GetAnimationCount() const { return animations.size(); }
 
+    bool HasNormals() const { return !normals.empty(); }
+    bool HasTexCoords() const { return !texCoords.empty(); }
+    bool HasSkinWeights() const { return !skinInfluences.empty(); }
+
+    // Stream management
+    void ReserveVertices(size_t count);
+    void ReserveFaces(size_t count);
+    void ResizeVertices(size_t count);
+    void EnsureNormals() { normals.resize(positions.size()); }
+    void EnsureTexCoords() { texCoords.resize(positions.size()); }
+    void EnsureSkinInfluences() { skinInfluences.resize(positions.size()); }
+
+    // Append one triangle to the index buffer
+    void AddTriangle(int i0, int i1, int i2, int materialIndex = -1) {
+        indices.push_back(i0);
+        indices.push_back(i1);
+        indices.push_back(i2);
+        faceMaterials.push_back(materialIndex);
+    }
+
+    // Compatibility accessors for code written against per-vertex structs
+    XVertex GetVertex(size_t index) const;
+    XFace GetFace(size_t index) const;
+    void AddVertex(const XVertex& vertex);
+    void AddFace(const XFace& face) {
+        AddTriangle(face.indices[0], face.indices[1], face.indices[2], face.materialIndex);
+    }
+
+    // Bones by name: the index of the bone, appended when new
+    int AddBone(std::string_view name);
+    int FindBone(std::string_view name) const { return boneNames.Find(name); }
+    const std::string& GetBoneName(size_t bone) const;
+
+    // Skeleton order: reorder bones so every parent precedes its children
+    // and each subtree is contiguous, rewriting parent and child links,
+    // track bone ids and skin influences. newIndex maps old to new bone
+    // indices. Fails, leaving the order unchanged, on a parent cycle.
+    bool SortBonesTopologically(std::vector<int>& newIndex);
+
+    // Bind-pose world matrices in one pass over parents-first bones; fails
+    // when a bone precedes its parent
+    bool ComputeBoneWorldMatrices(std::vector<XMatrix4x4>& world) const;
+
     // Validation
     bool IsValid() const;
     std::vector<std::string> GetValidationErrors() const;
+
+private:
+    XMeshData(const XMeshData&) = default;
 };
 
 // File header information
@@ -160,14 +318,38 @@ struct XFileHeader {
         COMPRESSED
     };
 
+    // How COMPRESSED inputs are packed: MSZIP for DirectX "tzip"/"bzip",
+    // the others for a whole .x file inside a generic container
+    enum Compression {
+        NONE,
+        MSZIP,
+        ZIP,
+        BZIP2,
+        DIRECTX_LZ
+    };
+
     Format format;
+    Compression compression;
     int majorVersion;
     int minorVersion;
+    int floatSize;                // 32 or 64
+    bool textPayload;             // "tzip": the compressed payload is text
     bool hasAnimationTimingInfo;
     float ticksPerSecond;
 
-    XFileHeader() : format(TEXT), majorVersion(3), minorVersion(3),
-                   hasAnimationTimingInfo(false), ticksPerSecond(4800.0f) {}
+    XFileHeader() : format(TEXT), compression(NONE), majorVersion(3), minorVersion(3), floatSize(32),
+                   textPayload(false), hasAnimationTimingInfo(false), ticksPerSecond(4800.0f) {}
+};
+
+// Resource usage of the parse that produced an XFileData
+struct XParseStatistics {
+    size_t inputBytes;
+    size_t arenaPeakBytes;        // Peak parse arena usage (scratch memory only)
+    double parseMilliseconds;
+    std::string decompressionMethod;   // Decoder of a compressed input (see XFileDecompressor::GetMethod)
+    size_t decompressionAttempts;      // Decoders tried on it, that one included
+
+    XParseStatistics() : inputBytes(0), arenaPeakBytes(0), parseMilliseconds(0.0), decompressionAttempts(0) {}
 };
 
 // Complete .x file data
@@ -177,7 +359,9 @@ struct XFileData {
     std::vector<XMeshData> meshes;           // Multiple meshes support
     std::vector<XMaterial> materials;        // Materials
     std::vector<XAnimationSet> animations;   // Animations
+    std::vector<XAnimationSetInfo> animationSets;  // Every AnimationSet in the file, decoded or not
     std::map<std::string, std::string> metadata;
+    XParseStatistics statistics;
 
     // Parse result information
     bool parseSuccessful;
@@ -186,6 +370,12 @@ struct XFileData {
 
     XFileData() : parseSuccessful(false) {}
 
+    // Handed from parser to exporter by move only
+    XFileData(XFileData&&) = default;
+    XFileData& operator=(XFileData&&) = default;
+    XFileData(const XFileData&) = delete;
+    XFileData& operator=(const XFileData&) = delete;
+
     bool IsValid() const {
         return parseSuccessful && meshData.IsValid();
     }
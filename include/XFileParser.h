@@ -2,9 +2,11 @@
 
 #include "XFileData.h"
 #include "Logger.h"
-#include <fstream>
-#include <memory>
-#include <regex>
+#include "MappedFile.h"
+#include "ParseArena.h"
+#include <map>
+#include <memory_resource>
+#include <string_view>
 
 namespace X2FBX {
 
@@ -34,104 +36,165 @@ enum class XDataObjectType {
     UNKNOWN
 };
 
-// Template for parsing .x file data objects
+// Generic .x data object node. Nodes, their names and payloads all live in
+// the parser's ParseArena and are released together with it.
 struct XDataObject {
     XDataObjectType type;
-    std::string name;
-    std::string guid;
-    std::vector<uint8_t> data;
-    std::vector<std::shared_ptr<XDataObject>> children;
-    std::map<std::string, std::string> properties;
-
-    XDataObject() : type(XDataObjectType::UNKNOWN) {}
+    std::string_view name;
+    std::string_view guid;
+    std::pmr::vector<uint8_t> data;
+    std::pmr::vector<XDataObject*> children;
+    std::pmr::vector<std::pair<std::string_view, std::string_view>> properties;
+
+    explicit XDataObject(std::pmr::memory_resource* resource)
+        : type(XDataObjectType::UNKNOWN), data(resource), children(resource), properties(resource) {}
 };
 
+class XFileTokenizer;
+struct XToken;
+
 class XFileParser {
 private:
     Logger& logger_;
-    std::unique_ptr<std::ifstream> fileStream_;
-    std::string currentLine_;
     size_t lineNumber_;
     ParseState currentState_;
 
     // Parsed data
     XFileData parsedData_;
-    std::vector<std::shared_ptr<XDataObject>> dataObjects_;
+
+    // Parse-time scratch memory; everything below that takes a
+    // memory_resource allocates from it and is dropped by ReleaseParseArena()
+    ParseArena arena_;
+    std::pmr::vector<XDataObject*> dataObjects_;
 
     // Parser configuration
     bool strictMode_;
     bool verboseLogging_;
 
+    // Animation selection. Sets outside the filter (or every set, when
+    // lazy) are only indexed; animationSource_ is the input their recorded
+    // ranges refer to, kept only in lazy mode.
+    std::vector<std::string> animationFilter_;
+    bool lazyAnimations_;
+    std::string_view animationSource_;
+
+    // Parallel parsing of top-level objects. A partial parser handles one
+    // object of a larger file: sourceOffset_ is where its input starts in
+    // that file and animationIndexBase_ counts the AnimationSets before it;
+    // unnamed frames get placeholder names that are fixed when merged.
+    size_t parseThreads_;
+    bool partialParse_;
+    size_t sourceOffset_;
+    size_t animationIndexBase_;
+
+    // Per-parse lookup state (keys are arena copies); bones are found by
+    // name through XMeshData::boneNames
+    std::pmr::vector<uint8_t> boneFields_;                          // BONE_HAS_* flags per bone
+    std::pmr::map<std::string_view, XMaterial> materialLibrary_;   // Top-level named materials
+
+    // Skin weights are resolved after parsing because the referenced frames
+    // may appear after the mesh in the file
+    struct PendingSkinWeights {
+        std::string_view boneName;
+        std::pmr::vector<uint32_t> vertexIndices;
+        std::pmr::vector<float> weights;
+        XMatrix4x4 offsetMatrix;
+
+        explicit PendingSkinWeights(std::pmr::memory_resource* resource)
+            : vertexIndices(resource), weights(resource) {}
+    };
+    std::pmr::vector<PendingSkinWeights> pendingSkinWeights_;
+
+    // Per-mesh bookkeeping for nested Mesh* objects
+    struct MeshParseContext {
+        size_t baseVertex = 0;
+        size_t vertexCount = 0;
+        size_t baseMaterial = 0;
+        std::pmr::vector<size_t> polygonOffsets;     // Start of each polygon in polygonIndices (+ end)
+        std::pmr::vector<uint32_t> polygonIndices;   // Mesh-local vertex indices of every polygon
+        std::pmr::vector<size_t> polygonFirstFace;   // First triangle of each polygon (+ end)
+
+        explicit MeshParseContext(std::pmr::memory_resource* resource)
+            : polygonOffsets(resource), polygonIndices(resource), polygonFirstFace(resource) {}
+    };
+
 public:
+    // Text inputs at least this large are split into top-level objects that
+    // are parsed concurrently
+    static constexpr size_t PARALLEL_PARSE_MIN_BYTES = 1024 * 1024;
+
     XFileParser();
     ~XFileParser();
 
     // Main parsing methods
     bool ParseFile(const std::string& filepath);
-    bool ParseFromString(const std::string& content);
+    // Parses directly from the given bytes; the view only has to outlive the call
+    bool ParseFromString(std::string_view content);
 
-    // Access parsed data
+    // Access parsed data. Taking the data also releases the parse arena.
     const XFileData& GetParsedData() const { return parsedData_; }
-    XFileData TakeParsedData() { return std::move(parsedData_); }
+    XFileData TakeParsedData();
 
     // Configuration
     void SetStrictMode(bool strict) { strictMode_ = strict; }
     void SetVerboseLogging(bool verbose) { verboseLogging_ = verbose; }
 
+    // Only AnimationSets with these names are decoded (all when empty)
+    void SetAnimationFilter(const std::vector<std::string>& names) { animationFilter_ = names; }
+    // Index every AnimationSet without decoding its keys. The content given
+    // to ParseFromString must then stay alive until DecodeAnimations.
+    void SetLazyAnimations(bool lazy) { lazyAnimations_ = lazy; }
+    // Workers for the top-level objects of large text inputs (0 = hardware
+    // threads, 1 = parse sequentially). Results do not depend on it.
+    void SetParseThreads(size_t threads) { parseThreads_ = threads; }
+
+    // Decode indexed sets with the given names (all when empty) into the
+    // parsed data. Must be called before TakeParsedData.
+    bool DecodeAnimations(const std::vector<std::string>& names);
+
     // Utility methods
     static bool IsValidXFile(const std::string& filepath);
     static XFileHeader::Format DetectFileFormat(const std::string& filepath);
 
 private:
     // Core parsing methods
-    bool ParseHeader(const std::string& content);
-    bool ParseDataObjects(const std::string& content);
-    std::shared_ptr<XDataObject> ParseDataObject(std::istream& stream);
-
-    // Specific object parsers
-    bool ParseMesh(const XDataObject& meshObject);
-    bool ParseFrame(const XDataObject& frameObject);
-    bool ParseAnimationSet(const XDataObject& animSetObject);
-    bool ParseAnimation(const XDataObject& animObject, XAnimationSet& animSet);
-    bool ParseAnimationKey(const XDataObject& keyObject, XAnimationSet& animSet);
-    bool ParseMaterial(const XDataObject& materialObject);
-    bool ParseSkinWeights(const XDataObject& skinObject);
-
-    // New stream-based parsing methods
-    bool ParseMeshObject(std::stringstream& stream);
-    bool ParseFrameObject(std::stringstream& stream);
-    bool ParseAnimationSetObject(std::stringstream& stream);
-    bool ParseAnimationObject(std::stringstream& stream, XAnimationSet& animSet);
-    bool ParseAnimationKeyObject(std::stringstream& stream, XAnimationSet& animSet);
-    bool ParseMaterialObject(std::stringstream& stream);
+    bool ParseContent(std::string_view content);
+    bool ParseHeader(std::string_view content);
+    bool ParseDataObjects(XFileTokenizer& tokenizer);
+    bool ParseTopLevelObject(XFileTokenizer& tokenizer, const XToken& keyword, std::string_view name);
+
+    // Two-phase parse: split the input into top-level object ranges with a
+    // brace scan, parse Mesh/Frame/AnimationSet ranges on worker parsers,
+    // then merge their results in file order
+    bool ParseDataObjectsParallel(XFileTokenizer& tokenizer, size_t threads);
+    void MergePartialParse(XFileParser& part);
+
+    // Reads "[name] [<guid>] {" after an object's type identifier
+    bool ReadObjectHeader(XFileTokenizer& tokenizer, std::string_view& name);
+
+    // Object parsers; the opening brace has already been consumed
+    bool ParseMeshObject(XFileTokenizer& tokenizer, std::string_view name);
+    bool ParseFrameObject(XFileTokenizer& tokenizer, std::string_view name, int parentBone);
+    bool ParseAnimationSetObject(XFileTokenizer& tokenizer, std::string_view name);
+    bool ParseAnimationSetBody(XFileTokenizer& tokenizer, XAnimationSet& animSet);
+    bool IndexAnimationSetBody(XFileTokenizer& tokenizer, XAnimationSetInfo& info);
+    bool ParseAnimationObject(XFileTokenizer& tokenizer, XAnimationSet& animSet);
+    bool ParseAnimationKeyObject(XFileTokenizer& tokenizer, XBoneTrack& track);
+    bool ParseMaterialObject(XFileTokenizer& tokenizer, std::string_view name, XMaterial& material);
 
     // Nested mesh object parsers
-    bool ParseMeshMaterialList(std::stringstream& stream);
-    bool ParseMeshNormals(std::stringstream& stream);
-    bool ParseMeshTextureCoords(std::stringstream& stream);
-    bool ParseSkinMeshHeader(std::stringstream& stream);
-    bool ParseSkinWeights(std::stringstream& stream);
-
-    // Helper parsing methods
-    XVertex ParseVertexLine(const std::string& line);
-    XFace ParseFaceLine(const std::string& line);
-    XKeyframe ParseKeyframeLine(const std::string& line, int keyType);
-    std::string ParseStringLine(const std::string& line);
-    bool SkipToClosingBrace(std::stringstream& stream);
-
-    // Data extraction methods
-    std::vector<XVector3> ParseVector3Array(const std::string& data);
-    std::vector<XVector2> ParseVector2Array(const std::string& data);
-    std::vector<XFace> ParseFaceArray(const std::string& data);
-    std::vector<float> ParseFloatArray(const std::string& data);
-    std::vector<int> ParseIntArray(const std::string& data);
-    XMatrix4x4 ParseMatrix(const std::string& data);
-    XQuaternion ParseQuaternion(const std::string& data);
+    bool ParseMeshMaterialList(XFileTokenizer& tokenizer, const MeshParseContext& mesh);
+    bool ParseMeshNormals(XFileTokenizer& tokenizer, const MeshParseContext& mesh);
+    bool ParseMeshTextureCoords(XFileTokenizer& tokenizer, const MeshParseContext& mesh);
+    bool ParseSkinWeights(XFileTokenizer& tokenizer, const MeshParseContext& mesh);
+
+    // Value helpers
+    bool ReadVector3(XFileTokenizer& tokenizer, XVector3& value);
+    bool ReadMatrix(XFileTokenizer& tokenizer, XMatrix4x4& matrix);
+    bool ReadColor(XFileTokenizer& tokenizer, XVector3& color, float* alpha = nullptr);
 
     // Timing extraction
     bool ExtractTimingInformation();
-    bool ParseAnimTicksPerSecond(const std::string& content);
-    bool ParseFrameRate(const std::string& content);
 
     // Validation and error handling
     bool ValidateParsedData();
@@ -139,33 +202,29 @@ private:
     void AddParseWarning(const std::string& warning);
 
     // Utility methods
-    std::string TrimWhitespace(const std::string& str);
-    std::vector<std::string> SplitString(const std::string& str, char delimiter);
-    bool IsNumeric(const std::string& str);
     XDataObjectType StringToDataObjectType(const std::string& typeName);
     std::string DataObjectTypeToString(XDataObjectType type);
+    int FindOrAddBone(std::string_view name);
 
     // File format specific parsers
-    bool ParseTextFormat(const std::string& content);
-    bool ParseBinaryFormat(const std::string& content);
+    bool ParseTextFormat(std::string_view content);
+    bool ParseBinaryFormat(std::string_view content);
 
-    // Template handling
-    bool ParseTemplateDefinitions(const std::string& content);
-    std::map<std::string, std::string> templates_;
+    // Template and file metadata handling, collected during the object pass
+    bool ParseTemplateObject(XFileTokenizer& tokenizer, const XToken& keyword, std::string_view name);
+    std::pmr::map<std::string_view, std::string_view> templates_;
+    float fileTicksPerSecond_;  // AnimTicksPerSecond object, 0 if absent
 
     // Animation-specific parsing helpers
     void ProcessAnimationHierarchy();
-    void LinkAnimationsToSkeleton();
-    bool ValidateAnimationConsistency();
 
     // Bone/skeleton processing
     void BuildSkeletonHierarchy();
-    void CalculateBindPoses();
-    void ValidateSkinWeights();
+    void ResolveSkinWeights();
 
     // Error recovery
-    bool AttemptErrorRecovery();
     void ResetParserState();
+    void ReleaseParseArena();
 
     // Progress reporting
     void ReportProgress(const std::string& operation, float percentage);
@@ -183,8 +242,8 @@ namespace XFileUtils {
     bool IsCompressedFormat(const std::string& content);
 
     // Content preprocessing
-    std::string PreprocessTextContent(const std::string& content);
-    std::string RemoveComments(const std::string& content);
+    std::string PreprocessTextContent(std::string_view content);
+    std::string RemoveComments(std::string_view content);
     std::string NormalizeWhitespace(const std::string& content);
 
     // Data parsing helpers
@@ -205,6 +264,9 @@ namespace XFileUtils {
 
     CoordinateSystem DetectCoordinateSystem(const XMeshData& meshData);
 
+    // Animation selection; an empty filter selects every set
+    bool MatchesAnimationFilter(const std::vector<std::string>& filter, const std::string& name);
+
     // Common .x file templates and GUIDs
     extern const std::map<std::string, XDataObjectType> STANDARD_TEMPLATES;
     extern const std::map<std::string, std::string> TEMPLATE_GUIDS;
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "XFileData.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace X2FBX {
+
+// Binary snapshot of a parsed XFileData. Every mesh stream, bone, material
+// and animation key lives in one flat, 16-byte-aligned array per kind, so
+// a mapped snapshot is loaded with bulk copies instead of parsing:
+//
+//   header | section table | FILE_INFO | STRINGS | MESHES | POSITIONS | ...
+//
+// Records refer to the shared arrays by [begin, begin + count) ranges and
+// to names by offset/length into STRINGS. Snapshots are written in host
+// byte order; a file from a host of the other byte order is rejected.
+//
+// A quantized snapshot stores positions, UVs, normals and rotation keys in
+// the QUANTIZED_* sections (see Quantization); each record flags which of
+// its ranges point there, and mesh records carry the bounds.
+namespace Snapshot {
+
+constexpr char MAGIC[8] = {'X', '2', 'F', 'B', 'X', 'S', 'N', 'P'};
+constexpr uint32_t VERSION = 4;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr size_t SECTION_ALIGNMENT = 16;
+
+enum class SectionId : uint32_t {
+    FILE_INFO = 1,
+    STRINGS,
+    MESHES,
+    POSITIONS,
+    NORMALS,
+    TEXCOORDS,
+    SKIN_INFLUENCES,
+    INDICES,
+    FACE_MATERIALS,
+    MATERIALS,
+    BONES,
+    BONE_CHILDREN,
+    ANIMATIONS,
+    TRACKS,
+    KEY_TIMES,
+    KEY_VALUES,
+    METADATA,               // Key/value string pairs
+    MESSAGES,               // Parse errors, then parse warnings
+    QUANTIZED_POSITIONS,    // 3 unorm16 per vertex
+    QUANTIZED_NORMALS,      // 2 octahedral snorm16 per vertex
+    QUANTIZED_TEXCOORDS,    // 2 unorm16 per vertex
+    QUANTIZED_ROTATIONS     // One smallest-three code per key
+};
+
+// MeshRecord::quantized
+constexpr uint32_t MESH_QUANTIZED_POSITIONS = 1;
+constexpr uint32_t MESH_QUANTIZED_NORMALS = 2;
+constexpr uint32_t MESH_QUANTIZED_TEXCOORDS = 4;
+
+// TrackRecord::flags
+constexpr uint32_t TRACK_QUANTIZED_ROTATIONS = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t fileSize;
+    uint32_t sectionCount;
+    uint32_t reserved;
+    uint64_t sectionTableOffset;
+};
+
+struct Section {
+    uint32_t id;
+    uint32_t elementSize;   // Checked on load, so a layout change cannot be misread
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct StringRef {
+    uint64_t offset;
+    uint64_t length;
+};
+
+struct Range {
+    uint64_t begin;
+    uint64_t count;
+};
+
+struct FileInfoRecord {
+    uint32_t format;
+    int32_t majorVersion;
+    int32_t minorVersion;
+    uint32_t hasAnimationTimingInfo;
+    float ticksPerSecond;
+    uint32_t parseSuccessful;
+    uint64_t inputBytes;
+    uint64_t arenaPeakBytes;
+    double parseMilliseconds;
+    Range meshes;           // First is XFileData::meshData, then XFileData::meshes
+    Range materials;        // XFileData::materials
+    Range animations;       // XFileData::animations
+    Range metadata;
+    Range errors;
+    Range warnings;
+};
+
+struct MeshRecord {
+    StringRef name;
+    float globalTicksPerSecond;
+    uint32_t hasTimingInfo;
+    Range positions;
+    Range normals;
+    Range texCoords;
+    Range skinInfluences;
+    Range indices;
+    Range faceMaterials;
+    Range materials;
+    Range bones;
+    Range animations;
+    uint32_t quantized;     // MESH_QUANTIZED_* streams; their ranges count components
+    uint32_t reserved;
+    float positionMin[3];
+    float positionExtent[3];
+    float texCoordMin[2];
+    float texCoordExtent[2];
+};
+
+struct MaterialRecord {
+    StringRef name;
+    float diffuseColor[3];
+    float specularColor[3];
+    float emissiveColor[3];
+    float shininess;
+    float transparency;
+    float reserved;
+    StringRef diffuseTexture;
+    StringRef normalTexture;
+    StringRef specularTexture;
+};
+
+struct BoneRecord {
+    StringRef name;         // Id i of XMeshData::boneNames
+    int32_t parentIndex;
+    uint32_t reserved;
+    float bindPose[16];
+    float offsetMatrix[16];
+    Range children;
+};
+
+struct AnimationRecord {
+    StringRef name;
+    float duration;
+    float ticksPerSecond;
+    Range tracks;
+};
+
+// Keys [keyBegin, keyBegin + keyCount) of KEY_TIMES; the values start at
+// valueBegin in KEY_VALUES, components per key
+struct ChannelRecord {
+    uint64_t keyBegin;
+    uint64_t keyCount;
+    uint64_t valueBegin;
+};
+
+struct TrackRecord {
+    int32_t boneId;
+    uint32_t flags;         // TRACK_QUANTIZED_ROTATIONS: rotation values are in QUANTIZED_ROTATIONS
+    ChannelRecord rotation;
+    ChannelRecord translation;
+    ChannelRecord scale;
+};
+
+} // namespace Snapshot
+
+// Validated, read-only view over snapshot bytes. Arrays are handed out in
+// place; Load copies them into an XFileData.
+class XFileSnapshotView {
+private:
+    ByteView data_;
+    const Snapshot::Section* sections_;
+    size_t sectionCount_;
+    std::string error_;
+
+public:
+    XFileSnapshotView();
+
+    // Checks the header, the section table and every section's bounds
+    bool Open(ByteView data);
+    const std::string& GetError() const { return error_; }
+
+    // Elements of one section. Null with count 0 when the section is absent.
+    template <typename T>
+    const T* GetArray(Snapshot::SectionId id, size_t& count) const {
+        const Snapshot::Section* section = FindSection(id);
+        if (!section || section->elementSize != sizeof(T)) {
+            count = 0;
+            return nullptr;
+        }
+        count = static_cast<size_t>(section->count);
+        return reinterpret_cast<const T*>(data_.data() + section->offset);
+    }
+
+    // Rebuild the parsed data; fails on any out-of-range reference
+    bool Load(XFileData& fileData);
+
+private:
+    const Snapshot::Section* FindSection(Snapshot::SectionId id) const;
+};
+
+class XFileSnapshot {
+public:
+    static constexpr const char* FILE_EXTENSION = ".x2s";
+
+    static bool IsSnapshot(ByteView data);
+    static bool IsSnapshotFile(const std::string& filepath);
+
+    // Write a snapshot of fileData; the file is complete or absent. With
+    // quantize, streams and rotation keys are stored quantized: lossy once,
+    // exact for data already carried at that precision (StreamQuantizer).
+    static bool Write(const XFileData& fileData, const std::string& filepath, bool quantize = false);
+
+    // Map and load a snapshot file
+    static bool Read(const std::string& filepath, XFileData& fileData);
+};
+
+} // namespace X2FBX
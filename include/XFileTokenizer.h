@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace X2FBX {
+
+// Token kinds produced by the text .x lexer
+enum class XTokenType {
+    END,            // End of input
+    IDENTIFIER,     // Template/object/type names, keywords
+    NUMBER,         // Integer or floating point literal
+    STRING,         // "quoted" text, quotes stripped
+    GUID,           // <...> text, angle brackets stripped
+    OPEN_BRACE,     // {
+    CLOSE_BRACE,    // }
+    OPEN_BRACKET,   // [
+    CLOSE_BRACKET,  // ]
+    SEPARATOR,      // ; or ,
+    INVALID         // Any other character
+};
+
+// A token is a view into the tokenizer input; nothing is copied
+struct XToken {
+    XTokenType type = XTokenType::END;
+    std::string_view text;
+    size_t line = 0;
+
+    bool Is(XTokenType t) const { return type == t; }
+    bool IsIdentifier(std::string_view name) const { return type == XTokenType::IDENTIFIER && text == name; }
+};
+
+// Pointer-based lexer for the text .x format.
+// Works directly on a std::string_view (typically a MappedFile), skips
+// whitespace and '//' / '#' comments inline and never allocates.
+class XFileTokenizer {
+private:
+    const char* begin_;
+    const char* cur_;
+    const char* end_;
+    size_t line_;
+
+    XToken lookahead_;
+    bool hasLookahead_;
+
+public:
+    explicit XFileTokenizer(std::string_view input, size_t startLine = 1);
+
+    // Token access
+    XToken Next();
+    const XToken& Peek();
+    bool AtEnd() { return Peek().type == XTokenType::END; }
+
+    // Consume the next token if it has the given type
+    bool Accept(XTokenType type);
+
+    // Skip any run of ';' and ',' tokens. Data lists in .x files are
+    // count-driven, so separators carry no information for the parser.
+    void SkipSeparators();
+
+    // Typed value readers: skip leading separators, then read one value
+    bool ReadInt(int& value);
+    bool ReadUInt(uint32_t& value);
+    bool ReadFloat(float& value);
+    bool ReadString(std::string_view& value);
+
+    // Skip the remainder of a block whose '{' has already been consumed
+    bool SkipBlock();
+    // Same, but matches braces on raw characters (honoring strings and
+    // comments) instead of lexing every token
+    bool ScanBlock();
+
+    // Position information
+    size_t GetLine() const { return hasLookahead_ ? lookahead_.line : line_; }
+    size_t GetOffset() const;
+    size_t GetSize() const { return static_cast<size_t>(end_ - begin_); }
+    size_t OffsetOf(const XToken& token) const { return static_cast<size_t>(token.text.data() - begin_); }
+
+    // Raw input between two offsets (e.g. a whole template block)
+    std::string_view Slice(size_t from, size_t to) const;
+
+    // Locale-independent number conversion (std::from_chars)
+    static bool ParseInt(std::string_view text, int& value);
+    static bool ParseFloat(std::string_view text, float& value);
+
+private:
+    XToken Lex();
+    void SkipWhitespaceAndComments();
+};
+
+} // namespace X2FBX
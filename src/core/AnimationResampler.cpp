@@ -0,0 +1,283 @@
+#include "AnimationResampler.h"
+#include "CoordinateKernels.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define X2FBX_RESAMPLER_SSE2 1
+#endif
+
+namespace X2FBX {
+
+namespace {
+
+// Frames closer than this to the end of the clip count as the end, so
+// float noise in the duration does not add a frame
+constexpr double END_FRAME_EPSILON = 1e-3;
+
+// Where a frame falls between two keys: weight 0 holds key, 1 reaches next
+struct Sample {
+    size_t key;
+    size_t next;
+    float weight;
+};
+
+// Per thread scratch, reused across tracks
+struct Scratch {
+    std::vector<Sample> samples;
+    std::vector<float> unitRotations;
+    std::vector<float> values;
+};
+
+void LocateSamples(const std::vector<float>& keyTimes, const std::vector<float>& frameTimes,
+                   std::vector<Sample>& samples) {
+    const size_t keyCount = keyTimes.size();
+    samples.resize(frameTimes.size());
+    size_t cursor = 0;
+    for (size_t frame = 0; frame < frameTimes.size(); ++frame) {
+        const float time = frameTimes[frame];
+        while (cursor + 1 < keyCount && keyTimes[cursor + 1] <= time) {
+            cursor++;
+        }
+        Sample& sample = samples[frame];
+        sample.key = cursor;
+        sample.next = cursor;
+        sample.weight = 0.0f;
+        if (cursor + 1 < keyCount && time > keyTimes[cursor]) {
+            sample.next = cursor + 1;
+            sample.weight = (time - keyTimes[cursor]) / (keyTimes[cursor + 1] - keyTimes[cursor]);
+        }
+    }
+}
+
+void LerpVectors(const std::vector<float>& keys, const std::vector<Sample>& samples, float* output) {
+    const size_t frames = samples.size();
+    const float* source = keys.data();
+    size_t frame = 0;
+#ifdef X2FBX_RESAMPLER_SSE2
+    if (CoordinateKernels::UseSimd()) {
+        // A 4-float load or store touches one float past the vector: fine
+        // inside the key array, and the next frame overwrites the stored one
+        const size_t lastLoad = keys.size() >= 4 ? keys.size() - 4 : 0;
+        for (; frame + 1 < frames; ++frame) {
+            const Sample& sample = samples[frame];
+            const size_t a = sample.key * 3;
+            const size_t b = sample.next * 3;
+            if (keys.size() < 4 || a > lastLoad || b > lastLoad) {
+                break;
+            }
+            const __m128 from = _mm_loadu_ps(source + a);
+            const __m128 to = _mm_loadu_ps(source + b);
+            const __m128 blended = _mm_add_ps(from, _mm_mul_ps(_mm_set1_ps(sample.weight), _mm_sub_ps(to, from)));
+            _mm_storeu_ps(output + frame * 3, blended);
+        }
+    }
+#endif
+    for (; frame < frames; ++frame) {
+        const Sample& sample = samples[frame];
+        const float* from = source + sample.key * 3;
+        const float* to = source + sample.next * 3;
+        float* out = output + frame * 3;
+        for (int c = 0; c < 3; ++c) {
+            out[c] = from[c] + sample.weight * (to[c] - from[c]);
+        }
+    }
+}
+
+float Dot4(const float* a, const float* b) {
+    return ((a[0] * b[0] + a[1] * b[1]) + a[2] * b[2]) + a[3] * b[3];
+}
+
+void NormalizeRotations(const std::vector<float>& keys, std::vector<float>& unit) {
+    unit.resize(keys.size());
+    for (size_t i = 0; i < keys.size(); i += 4) {
+        const float* q = &keys[i];
+        float* out = &unit[i];
+        const float length = std::sqrt(Dot4(q, q));
+        if (length > 0.0f) {
+            for (int c = 0; c < 4; ++c) out[c] = q[c] / length;
+        } else {
+            out[0] = out[1] = out[2] = 0.0f;
+            out[3] = 1.0f;
+        }
+    }
+}
+
+// Shortest-path slerp of unit rotations, normalized like KeyframeReducer's
+void SlerpRotations(const std::vector<float>& unit, const std::vector<Sample>& samples, float* output) {
+    const bool simd = CoordinateKernels::UseSimd();
+    for (size_t frame = 0; frame < samples.size(); ++frame, output += 4) {
+        const Sample& sample = samples[frame];
+        const float* a = &unit[sample.key * 4];
+        const float* b = &unit[sample.next * 4];
+
+        float cosTheta = Dot4(a, b);
+        float sign = 1.0f;
+        if (cosTheta < 0.0f) {
+            sign = -1.0f;
+            cosTheta = -cosTheta;
+        }
+        float wa = 1.0f - sample.weight;
+        float wb = sample.weight;
+        if (cosTheta < 0.9995f) {
+            const float theta = std::acos(cosTheta);
+            const float sinTheta = std::sin(theta);
+            wa = std::sin((1.0f - sample.weight) * theta) / sinTheta;
+            wb = std::sin(sample.weight * theta) / sinTheta;
+        }
+        wb *= sign;
+
+#ifdef X2FBX_RESAMPLER_SSE2
+        if (simd) {
+            const __m128 q = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(wa)),
+                                        _mm_mul_ps(_mm_loadu_ps(b), _mm_set1_ps(wb)));
+            // Summed in the scalar order so the length is bit-identical
+            const __m128 squares = _mm_mul_ps(q, q);
+            __m128 sum = _mm_add_ss(squares, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(1, 1, 1, 1)));
+            sum = _mm_add_ss(sum, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(2, 2, 2, 2)));
+            sum = _mm_add_ss(sum, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(3, 3, 3, 3)));
+            const __m128 length = _mm_sqrt_ss(sum);
+            if (_mm_cvtss_f32(length) > 0.0f) {
+                _mm_storeu_ps(output, _mm_div_ps(q, _mm_shuffle_ps(length, length, _MM_SHUFFLE(0, 0, 0, 0))));
+            } else {
+                _mm_storeu_ps(output, _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f));
+            }
+            continue;
+        }
+#else
+        (void)simd;
+#endif
+        float q[4];
+        for (int c = 0; c < 4; ++c) {
+            q[c] = a[c] * wa + b[c] * wb;
+        }
+        const float length = std::sqrt(Dot4(q, q));
+        if (length > 0.0f) {
+            for (int c = 0; c < 4; ++c) output[c] = q[c] / length;
+        } else {
+            output[0] = output[1] = output[2] = 0.0f;
+            output[3] = 1.0f;
+        }
+    }
+}
+
+} // namespace
+
+AnimationResampler::AnimationResampler(const AnimationResampleOptions& options)
+    : logger_(Logger::GetInstance())
+    , options_(options) {
+}
+
+std::vector<float> AnimationResampler::ComputeFrameTimes(const XAnimationSet& animation) const {
+    float endTicks = animation.duration;
+    if (endTicks <= 0.0f) {
+        for (const auto& track : animation.tracks) {
+            endTicks = std::max(endTicks, track.GetEndTime());
+        }
+    }
+
+    std::vector<float> frameTimes;
+    if (options_.frameRate <= 0.0f || animation.ticksPerSecond <= 0.0f) {
+        return frameTimes;
+    }
+    const double ticksPerFrame = static_cast<double>(animation.ticksPerSecond) / options_.frameRate;
+    const double lastFrame = std::ceil(endTicks / ticksPerFrame - END_FRAME_EPSILON);
+    const size_t frameCount = static_cast<size_t>(std::max(0.0, lastFrame)) + 1;
+    frameTimes.resize(frameCount);
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        frameTimes[frame] = static_cast<float>(frame * ticksPerFrame);
+    }
+    return frameTimes;
+}
+
+AnimationResampleResult AnimationResampler::ResampleAnimation(XAnimationSet& animation) const {
+    std::vector<float> frameTimes = ComputeFrameTimes(animation);
+    std::vector<TrackJob> jobs;
+    for (auto& track : animation.tracks) {
+        jobs.push_back({&track, &frameTimes});
+    }
+    AnimationResampleResult result = ResampleTracks(jobs);
+    result.animations = 1;
+    result.frames = frameTimes.size();
+    return result;
+}
+
+AnimationResampleResult AnimationResampler::ResampleAllAnimations(std::vector<XAnimationSet>& animations) const {
+    // Frame times are per clip; one pool over the tracks of every clip
+    // balances better than a pool per clip
+    std::vector<std::vector<float>> frameTimes(animations.size());
+    std::vector<TrackJob> jobs;
+    size_t frames = 0;
+    for (size_t i = 0; i < animations.size(); ++i) {
+        frameTimes[i] = ComputeFrameTimes(animations[i]);
+        frames += frameTimes[i].size();
+        for (auto& track : animations[i].tracks) {
+            jobs.push_back({&track, &frameTimes[i]});
+        }
+    }
+    AnimationResampleResult result = ResampleTracks(jobs);
+    result.animations = animations.size();
+    result.frames = frames;
+    return result;
+}
+
+AnimationResampleResult AnimationResampler::ResampleTracks(const std::vector<TrackJob>& jobs) const {
+    std::vector<AnimationResampleResult> trackResults(jobs.size());
+    size_t threads = ParallelUtils::ResolveThreadCount(options_.threads, jobs.size());
+
+    ParallelUtils::ParallelFor(jobs.size(), threads, [&](size_t index, size_t) {
+        trackResults[index] = ResampleTrack(*jobs[index].track, *jobs[index].frameTimes);
+    });
+
+    AnimationResampleResult result;
+    for (const auto& trackResult : trackResults) {
+        result.Add(trackResult);
+    }
+    return result;
+}
+
+AnimationResampleResult AnimationResampler::ResampleTrack(XBoneTrack& track, const std::vector<float>& frameTimes) const {
+    AnimationResampleResult result;
+    result.tracks = 1;
+    if (frameTimes.empty()) {
+        return result;
+    }
+
+    thread_local Scratch scratch;
+    XAnimationChannel* channels[3] = {&track.rotation, &track.translation, &track.scale};
+    for (XAnimationChannel* channel : channels) {
+        if (channel->IsEmpty()) {
+            continue;
+        }
+        const bool rotation = channel == &track.rotation;
+        const size_t components = rotation ? XBoneTrack::ROTATION_COMPONENTS : XBoneTrack::VECTOR_COMPONENTS;
+        result.channels++;
+        result.originalKeys += channel->GetKeyCount();
+        result.resampledKeys += frameTimes.size();
+
+        LocateSamples(channel->times, frameTimes, scratch.samples);
+        scratch.values.resize(frameTimes.size() * components);
+        if (rotation) {
+            NormalizeRotations(channel->values, scratch.unitRotations);
+            SlerpRotations(scratch.unitRotations, scratch.samples, scratch.values.data());
+        } else {
+            LerpVectors(channel->values, scratch.samples, scratch.values.data());
+        }
+        channel->times = frameTimes;
+        channel->values.swap(scratch.values);
+    }
+    return result;
+}
+
+void AnimationResampler::GenerateResampleReport(const AnimationResampleResult& result) const {
+    std::ostringstream report;
+    report << "Animation resampling at " << options_.frameRate << " fps: " << result.animations << " animations, "
+           << result.tracks << " tracks, " << result.channels << " channels, " << result.frames << " frames; "
+           << result.originalKeys << " keys in, " << result.resampledKeys << " keys out";
+    logger_.Info(report.str());
+}
+
+} // namespace X2FBX
@@ -1,10 +1,20 @@
 #include "AnimationTimingCorrector.h"
+#include "ParallelUtils.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <numeric>
 #include <sstream>
 #include <iomanip>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define X2FBX_TIMING_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define X2FBX_TIMING_NEON 1
+#endif
+
 namespace X2FBX {
 
 // Static constants
@@ -22,7 +32,8 @@ const std::vector<float> AnimationTimingCorrector::COMMON_TICK_RATES = {
 };
 
 AnimationTimingCorrector::AnimationTimingCorrector()
-    : logger_(Logger::GetInstance()) {
+    : logger_(Logger::GetInstance())
+    , threads_(0) {
     LOG_DEBUG("AnimationTimingCorrector initialized");
 }
 
@@ -31,7 +42,7 @@ TimingAnalysis AnimationTimingCorrector::AnalyzeAnimationTiming(const XAnimation
 
     TimingAnalysis analysis;
 
-    if (animation.keyframes.empty()) {
+    if (animation.GetKeyCount() == 0) {
         LOG_WARNING("Animation '" + animation.name + "' has no keyframes for timing analysis");
         return analysis;
     }
@@ -48,10 +59,21 @@ TimingAnalysis AnimationTimingCorrector::AnalyzeAnimationTiming(const XAnimation
         }
     }
 
-    // Method 2: Analyze keyframe patterns
-    std::vector<float> candidateRates = GetCandidateTickRates(animation);
+    // Method 2: Analyze keyframe patterns. The intervals are summarized
+    // once and every candidate is scored against the summary.
+    KeyIntervalSummary intervals = SummarizeKeyIntervals(animation);
+    std::vector<float> candidateRates = GetCandidateTickRates(intervals);
     analysis.candidateTickRates = candidateRates;
 
+    if (intervals.intervalCount > 0) {
+        int dominantBin = static_cast<int>(std::max_element(intervals.histogram,
+            intervals.histogram + KeyIntervalSummary::HISTOGRAM_BINS) - intervals.histogram);
+        LOG_DEBUG("Key intervals of '" + animation.name + "': " + std::to_string(intervals.intervalCount) +
+                  " (min " + std::to_string(intervals.minInterval) + ", median " +
+                  std::to_string(intervals.medianInterval) + ", max " + std::to_string(intervals.maxInterval) +
+                  ", mostly " + std::to_string(1 << dominantBin) + "+ ticks)");
+    }
+
     float bestTickRate = 4800.0f;
     float bestScore = 0.0f;
 
@@ -97,19 +119,14 @@ TimingCorrectionResult AnimationTimingCorrector::CorrectAnimationTiming(XAnimati
         animation.ticksPerSecond = analysis.detectedTicksPerSecond;
 
         // Convert keyframes if necessary
-        if (!animation.keyframes.empty()) {
+        if (animation.GetKeyCount() > 0) {
             // The keyframe times stay the same, only the interpretation changes
             // But we might need to validate and adjust them
 
             float timeScale = originalTicksPerSecond / analysis.detectedTicksPerSecond;
             if (std::abs(timeScale - 1.0f) > 0.01f) {
                 // Only scale if there's a significant difference
-                for (auto& keyframe : animation.keyframes) {
-                    keyframe.time *= timeScale;
-                }
-
-                // Update duration
-                animation.duration *= timeScale;
+                RescaleAnimationTimes(animation, timeScale);
             }
         }
     }
@@ -141,15 +158,7 @@ TimingCorrectionResult AnimationTimingCorrector::CorrectAnimationTiming(XAnimati
 }
 
 float AnimationTimingCorrector::DetectTicksPerSecondFromKeyframes(const XAnimationSet& animation) const {
-    if (animation.keyframes.size() < 2) {
-        return 4800.0f; // Default
-    }
-
-    // Extract keyframe times
-    std::vector<float> keyframeTimes = ExtractKeyframeTimes(animation);
-
-    // Analyze the pattern
-    return AnalyzeKeyframePattern(keyframeTimes);
+    return AnalyzeKeyframePattern(SummarizeKeyIntervals(animation));
 }
 
 float AnimationTimingCorrector::DetectTicksPerSecondFromDuration(const XAnimationSet& animation) const {
@@ -216,11 +225,15 @@ TimingCorrectionResult AnimationTimingCorrector::ValidateTimingCorrection(
 }
 
 std::vector<float> AnimationTimingCorrector::GetCandidateTickRates(const XAnimationSet& animation) const {
+    return GetCandidateTickRates(SummarizeKeyIntervals(animation));
+}
+
+std::vector<float> AnimationTimingCorrector::GetCandidateTickRates(const KeyIntervalSummary& intervals) const {
     std::vector<float> candidates = COMMON_TICK_RATES;
 
     // Add analysis-based candidates
-    if (!animation.keyframes.empty()) {
-        float keyframeBasedRate = DetectTicksPerSecondFromKeyframes(animation);
+    if (intervals.intervalCount > 0) {
+        float keyframeBasedRate = AnalyzeKeyframePattern(intervals);
         if (std::find(candidates.begin(), candidates.end(), keyframeBasedRate) == candidates.end()) {
             candidates.push_back(keyframeBasedRate);
         }
@@ -243,42 +256,48 @@ float AnimationTimingCorrector::CalculateConfidence(float tickRate, const XAnima
     return ScoreTickRate(tickRate, animation);
 }
 
-std::vector<XKeyframe> AnimationTimingCorrector::ConvertKeyframeTiming(
-    const std::vector<XKeyframe>& originalKeyframes,
+void AnimationTimingCorrector::ConvertKeyframeTiming(
+    XAnimationChannel& channel,
     float originalTicksPerSecond,
     float targetTicksPerSecond) const {
 
-    std::vector<XKeyframe> convertedKeyframes = originalKeyframes;
-
-    if (std::abs(originalTicksPerSecond - targetTicksPerSecond) > 0.1f) {
-        float timeScale = originalTicksPerSecond / targetTicksPerSecond;
+    // Same instant in seconds: ticks scale by target / original
+    if (std::abs(originalTicksPerSecond - targetTicksPerSecond) > 0.1f && originalTicksPerSecond > 0.0f) {
+        float timeScale = targetTicksPerSecond / originalTicksPerSecond;
+        TimingUtils::ScaleTimes(channel.times.data(), channel.times.size(), timeScale);
+    }
+}
 
-        for (auto& keyframe : convertedKeyframes) {
-            keyframe.time *= timeScale;
+void AnimationTimingCorrector::RescaleAnimationTimes(XAnimationSet& animation, float timeScale) const {
+    // Times are contiguous per channel, so each is one vector multiply
+    for (auto& track : animation.tracks) {
+        for (XAnimationChannel* channel : {&track.rotation, &track.translation, &track.scale}) {
+            TimingUtils::ScaleTimes(channel->times.data(), channel->times.size(), timeScale);
         }
     }
-
-    return convertedKeyframes;
+    animation.duration *= timeScale;
 }
 
 std::vector<TimingCorrectionResult> AnimationTimingCorrector::CorrectAllAnimations(
     std::vector<XAnimationSet>& animations) const {
 
-    std::vector<TimingCorrectionResult> results;
-    results.reserve(animations.size());
+    std::vector<TimingCorrectionResult> results(animations.size());
 
     LOG_INFO("Correcting timing for " + std::to_string(animations.size()) + " animations");
 
-    for (size_t i = 0; i < animations.size(); i++) {
-        logger_.LogProgress("Animation timing correction", static_cast<int>(i + 1),
+    // Each animation set is corrected independently into its own slot
+    std::atomic<int> completed(0);
+    size_t threads = ParallelUtils::ResolveThreadCount(threads_, animations.size());
+    ParallelUtils::ParallelFor(animations.size(), threads, [&](size_t i, size_t) {
+        results[i] = CorrectAnimationTiming(animations[i]);
+        logger_.LogProgress("Animation timing correction", ++completed,
                            static_cast<int>(animations.size()));
+    });
 
-        TimingCorrectionResult result = CorrectAnimationTiming(animations[i]);
-        results.push_back(result);
-
-        if (!result.isValid) {
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!results[i].isValid) {
             LOG_ERROR("Failed to correct timing for animation '" + animations[i].name +
-                     "': " + result.errorDescription);
+                     "': " + results[i].errorDescription);
         }
     }
 
@@ -286,7 +305,13 @@ std::vector<TimingCorrectionResult> AnimationTimingCorrector::CorrectAllAnimatio
 }
 
 void AnimationTimingCorrector::GenerateTimingReport(const std::vector<TimingCorrectionResult>& results) const {
-    LOG_INFO("=== TIMING CORRECTION REPORT ===");
+    LogTimingReport(BuildTimingReport(results));
+}
+
+std::vector<TimingReportLine> AnimationTimingCorrector::BuildTimingReport(
+    const std::vector<TimingCorrectionResult>& results) const {
+    std::vector<TimingReportLine> lines;
+    lines.push_back({LogLevel::INFO, "=== TIMING CORRECTION REPORT ==="});
 
     int successCount = 0;
     int failureCount = 0;
@@ -301,24 +326,32 @@ void AnimationTimingCorrector::GenerateTimingReport(const std::vector<TimingCorr
         totalTimingError += result.timingErrorSeconds;
     }
 
-    LOG_INFO("Successfully corrected: " + std::to_string(successCount) + " animations");
+    lines.push_back({LogLevel::INFO, "Successfully corrected: " + std::to_string(successCount) + " animations"});
     if (failureCount > 0) {
-        LOG_ERROR("Failed to correct: " + std::to_string(failureCount) + " animations");
+        lines.push_back({LogLevel::ERROR, "Failed to correct: " + std::to_string(failureCount) + " animations"});
     }
 
     if (!results.empty()) {
         float averageError = totalTimingError / results.size();
-        LOG_INFO("Average timing error: " + std::to_string(averageError) + " seconds");
+        lines.push_back({LogLevel::INFO, "Average timing error: " + std::to_string(averageError) + " seconds"});
     }
 
     // Detailed results for failures
     for (size_t i = 0; i < results.size(); i++) {
         const auto& result = results[i];
         if (!result.isValid) {
-            LOG_ERROR("Animation " + std::to_string(i) + " timing correction failed: " +
-                     result.errorDescription);
+            lines.push_back({LogLevel::ERROR, "Animation " + std::to_string(i) + " timing correction failed: " +
+                                              result.errorDescription});
         }
     }
+    return lines;
+}
+
+void AnimationTimingCorrector::LogTimingReport(const std::vector<TimingReportLine>& lines) {
+    Logger& logger = Logger::GetInstance();
+    for (const auto& line : lines) {
+        logger.Log(line.level, line.text, __FILE__, __LINE__);
+    }
 }
 
 // Private helper methods
@@ -371,57 +404,65 @@ std::string AnimationTimingCorrector::GetDetectionMethodDescription(float tickRa
     return ss.str();
 }
 
-std::vector<float> AnimationTimingCorrector::ExtractKeyframeTimes(const XAnimationSet& animation) const {
-    std::vector<float> times;
-    times.reserve(animation.keyframes.size());
+KeyIntervalSummary AnimationTimingCorrector::SummarizeKeyIntervals(const XAnimationSet& animation) const {
+    // Key intervals come from the densest channel; merging the channels
+    // would interleave unrelated sampling patterns
+    const XAnimationChannel* densest = nullptr;
+    for (const auto& track : animation.tracks) {
+        for (const XAnimationChannel* channel : {&track.rotation, &track.translation, &track.scale}) {
+            if (!densest || channel->GetKeyCount() > densest->GetKeyCount()) {
+                densest = channel;
+            }
+        }
+    }
 
-    for (const auto& keyframe : animation.keyframes) {
-        times.push_back(keyframe.time);
+    KeyIntervalSummary summary;
+    if (!densest || densest->GetKeyCount() < 2) {
+        return summary;
+    }
+
+    const std::vector<float>& times = densest->times;
+    std::vector<float> intervals(times.size() - 1);
+    summary.minInterval = summary.maxInterval = times[1] - times[0];
+    for (size_t i = 0; i < intervals.size(); i++) {
+        float interval = times[i + 1] - times[i];
+        intervals[i] = interval;
+        summary.minInterval = std::min(summary.minInterval, interval);
+        summary.maxInterval = std::max(summary.maxInterval, interval);
+
+        int bin = interval >= 1.0f ? std::min(KeyIntervalSummary::HISTOGRAM_BINS - 1, std::ilogb(interval)) : 0;
+        summary.histogram[bin]++;
+    }
+    summary.intervalCount = intervals.size();
+
+    // Median by selection instead of a full sort
+    size_t middle = intervals.size() / 2;
+    std::nth_element(intervals.begin(), intervals.begin() + middle, intervals.end());
+    summary.medianInterval = intervals[middle];
+    if (intervals.size() % 2 == 0) {
+        float lower = *std::max_element(intervals.begin(), intervals.begin() + middle);
+        summary.medianInterval = (lower + summary.medianInterval) / 2.0f;
     }
 
-    return times;
+    return summary;
 }
 
-float AnimationTimingCorrector::AnalyzeKeyframePattern(const std::vector<float>& keyframeTimes) const {
-    if (keyframeTimes.size() < 2) {
+float AnimationTimingCorrector::AnalyzeKeyframePattern(const KeyIntervalSummary& intervals) const {
+    if (intervals.intervalCount == 0) {
         return 4800.0f;
     }
 
-    // Calculate intervals between keyframes
-    std::vector<float> intervals;
-    for (size_t i = 1; i < keyframeTimes.size(); i++) {
-        intervals.push_back(keyframeTimes[i] - keyframeTimes[i-1]);
-    }
-
-    // Find common intervals (suggesting frame-based timing)
-    if (!intervals.empty()) {
-        float medianInterval = CalculateMedian(intervals);
-
-        // If median interval suggests frame-based timing
-        for (float fps : {24.0f, 25.0f, 30.0f, 60.0f}) {
-            float expectedInterval = 4800.0f / fps; // Assuming 4800 base rate
-            if (std::abs(medianInterval - expectedInterval) < expectedInterval * 0.1f) {
-                return 4800.0f;
-            }
+    // If median interval suggests frame-based timing
+    for (float fps : {24.0f, 25.0f, 30.0f, 60.0f}) {
+        float expectedInterval = 4800.0f / fps; // Assuming 4800 base rate
+        if (std::abs(intervals.medianInterval - expectedInterval) < expectedInterval * 0.1f) {
+            return 4800.0f;
         }
     }
 
     return 4800.0f; // Default fallback
 }
 
-float AnimationTimingCorrector::CalculateMedian(std::vector<float> values) const {
-    if (values.empty()) return 0.0f;
-
-    std::sort(values.begin(), values.end());
-    size_t middle = values.size() / 2;
-
-    if (values.size() % 2 == 0) {
-        return (values[middle - 1] + values[middle]) / 2.0f;
-    } else {
-        return values[middle];
-    }
-}
-
 // TimingUtils namespace implementation
 namespace TimingUtils {
     const float DIRECTX_DEFAULT_TICKS = 4800.0f;
@@ -438,6 +479,30 @@ namespace TimingUtils {
         return static_cast<float>(seconds * ticksPerSecond);
     }
 
+    void ScaleTimes(float* times, size_t count, float scale) {
+        size_t i = 0;
+#if defined(X2FBX_TIMING_SSE2)
+        const __m128 factor = _mm_set1_ps(scale);
+        for (; i + 8 <= count; i += 8) {
+            __m128 a = _mm_loadu_ps(times + i);
+            __m128 b = _mm_loadu_ps(times + i + 4);
+            _mm_storeu_ps(times + i, _mm_mul_ps(a, factor));
+            _mm_storeu_ps(times + i + 4, _mm_mul_ps(b, factor));
+        }
+#elif defined(X2FBX_TIMING_NEON)
+        for (; i + 8 <= count; i += 8) {
+            float32x4_t a = vld1q_f32(times + i);
+            float32x4_t b = vld1q_f32(times + i + 4);
+            vst1q_f32(times + i, vmulq_n_f32(a, scale));
+            vst1q_f32(times + i + 4, vmulq_n_f32(b, scale));
+        }
+#endif
+        // Lane-wise multiply is exact IEEE, so the tail matches the vector part
+        for (; i < count; i++) {
+            times[i] *= scale;
+        }
+    }
+
     bool IsValidTickRate(float tickRate) {
         return tickRate > 0 && tickRate <= 1000000.0f; // Reasonable upper bound
     }
@@ -0,0 +1,701 @@
+#include "BatchConverter.h"
+#include "BinaryXFileParser.h"
+#include "ConversionStages.h"
+#include "FBXExporter.h"
+#include "MeshOptimizer.h"
+#include "AnimationTimingCorrector.h"
+#include "ParallelUtils.h"
+#include "ProcessMemory.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace X2FBX {
+
+namespace {
+
+BatchFileResult& Finish(BatchFileResult& result, std::chrono::high_resolution_clock::time_point startTime,
+                        MetricsWorkerSlot& metrics, StageRecorder& costs) {
+    auto endTime = std::chrono::high_resolution_clock::now();
+    result.elapsedMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+    metrics.EndFile(result.success);
+
+    // Success is final only once the writer and validator are done (see Run)
+    costs.Enter(nullptr);
+    ConversionRecord& report = result.report;
+    report.input = result.inputPath;
+    report.success = result.success;
+    report.error = result.errorMessage;
+    report.inputBytes = result.inputBytes;
+    report.cacheHit = result.cacheHit;
+    report.parseSkipped = result.parseSkipped;
+    report.outputs = static_cast<size_t>(result.filesWritten);
+    report.peakRssBytes = ProcessMemory::GetPeakRssBytes();
+    return result;
+}
+
+bool HasXExtension(const fs::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension == ".x";
+}
+
+std::string Trim(const std::string& str) {
+    const char* whitespace = " \t\r\n";
+    size_t start = str.find_first_not_of(whitespace);
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = str.find_last_not_of(whitespace);
+    return str.substr(start, end - start + 1);
+}
+
+} // namespace
+
+BatchWorker::BatchWorker()
+    : exporter(FBXExporterPool::GetInstance().Acquire()) {
+    timingCorrector.SetThreadCount(1);   // Files already run in parallel
+}
+
+BatchFileResult BatchWorker::Convert(const std::string& inputPath, const std::string& outputDirectory,
+                                     const BatchOptions& options, ConversionCache& cache,
+                                     TextureLibrary* textures, InputBuffer input, OutputWriter* writer,
+                                     OutputValidator* validator) {
+    TIME_OPERATION("BatchConverter::ConvertFile");
+    BatchFileResult result;
+    result.inputPath = inputPath;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    metrics.BeginFile(inputPath);
+    // Files convert side by side, so only this thread's CPU time is theirs
+    StageRecorder costs(result.report, StageClock::Scope::THREAD, &result.report.parse);
+
+    try {
+        std::error_code ec;
+        result.inputBytes = input ? input->size() : static_cast<size_t>(fs::file_size(inputPath, ec));
+        timer.AddBytes(result.inputBytes);
+        const XFileProbe probe = input ? ProbeXFileData(ByteView(*input)) : ProbeXFile(inputPath);
+        result.report.SetInput(probe.header, probe.snapshot, XParseStatistics());
+
+        fs::create_directories(outputDirectory, ec);
+        if (!fs::is_directory(outputDirectory)) {
+            result.errorMessage = "Cannot create output directory: " + outputDirectory;
+            return Finish(result, startTime, metrics, costs);
+        }
+
+        std::string baseName = fs::path(inputPath).stem().string();
+        FBXExportOptions exportOptions;
+        exportOptions.optimizeMesh = options.optimizeMesh;
+        exportOptions.batchMaterials = options.batchMaterials;
+        exportOptions.quantize = options.quantize;
+        exportOptions.backend = options.fbxBackend;
+        exportOptions.compressArrays = options.compressArrays;
+        exportOptions.compressionLevel = options.compressionLevel;
+        exportOptions.embedTextures = options.embedTextures;
+        exportOptions.embedTexturesInClips = options.embedTexturesInClips;
+        exportOptions.outputWriter = writer;
+        exportOptions.validation = options.validation;
+        exportOptions.validator = validator;
+        if (options.resampleAnimations) {
+            exportOptions.animationFrameRate = options.resampling.frameRate;
+        }
+        const AnimationResampleOptions* resampling = options.resampleAnimations ? &options.resampling : nullptr;
+
+        // Texture files are only known after parsing, so a conversion that
+        // uses them relies on the stage keys, which include them
+        const bool resolveTextures = textures && (options.resolveTextures || options.embedTextures);
+        std::string cacheKey;
+        if (cache.IsEnabled() && !resolveTextures) {
+            std::string fingerprint = ConversionCache::Fingerprint(exportOptions, options.strictMode,
+                                                                   options.reduceKeyframes ? &options.keyReduction : nullptr,
+                                                                   options.animationNames, resampling);
+            cacheKey = input ? cache.ComputeKey(ByteView(*input), fingerprint) : cache.ComputeKey(inputPath, fingerprint);
+            CachedConversion cached;
+            if (cache.Restore(cacheKey, outputDirectory, baseName, cached)) {
+                result.cacheHit = true;
+                result.filesWritten = static_cast<int>(cached.outputPaths.size());
+                for (const auto& path : cached.outputPaths) {
+                    FBXExportResult restored;
+                    restored.success = true;
+                    restored.outputPath = path;
+                    result.exports.push_back(restored);
+                }
+                result.success = true;
+                return Finish(result, startTime, metrics, costs);
+            }
+        }
+        CachedConversion produced;
+
+        // A miss on the whole conversion can still reuse earlier stages
+        metrics.EnterStage(ConversionStage::PARSE);
+        ConversionStages stages(cache);
+        const KeyframeReductionOptions* reduction = options.reduceKeyframes ? &options.keyReduction : nullptr;
+        MeshOptimizationOptions meshOptions;
+        meshOptions.batchMaterials = options.batchMaterials;
+        const MeshOptimizationOptions* optimization = options.optimizeMesh ? &meshOptions : nullptr;
+        StageKeys stageKeys = input ? stages.ComputeKeys(ByteView(*input), options.strictMode, options.animationNames,
+                                                         optimization, reduction, resampling, options.quantize)
+                                    : stages.ComputeKeys(inputPath, options.strictMode, options.animationNames,
+                                                         optimization, reduction, resampling, options.quantize);
+        XFileData fileData;
+        bool prepared = stageKeys.IsValid() && stages.LoadData(stageKeys.prepare, fileData, &produced.timingReport);
+        if (!prepared && !(stageKeys.IsValid() && stages.LoadData(stageKeys.parse, fileData))) {
+            parser.SetStrictMode(options.strictMode);
+            parser.SetVerboseLogging(options.verboseLogging);
+            parser.SetAnimationFilter(options.animationNames);
+            parser.SetParseThreads(1);   // Files are already spread across the workers
+            parser.SetDecompressionLimits(options.decompressionLimits);
+            bool parsed;
+            if (input) {
+                ConversionMetrics::GetInstance().AddBytesRead(input->size());
+                parsed = parser.ParseFromData(*input);
+            } else {
+                parsed = parser.ParseFile(inputPath, probe);
+            }
+            result.report.SetInput(probe.header, probe.snapshot, parser.GetParsedData().statistics);
+            if (!parsed) {
+                result.errorMessage = "Failed to parse .x file";
+                return Finish(result, startTime, metrics, costs);
+            }
+            fileData = parser.TakeParsedData();
+            result.arenaPeakBytes = fileData.statistics.arenaPeakBytes;
+            if (stageKeys.IsValid()) {
+                stages.StoreData(stageKeys.parse, fileData);
+            }
+        } else {
+            result.parseSkipped = true;
+        }
+        input.reset();   // Frees its share of the read-ahead budget
+        XMeshData& meshData = fileData.meshData;
+        if (resolveTextures) {
+            // Read on the library's threads while this one prepares the mesh
+            exportOptions.textures = textures->Request(meshData, inputPath, options.embedTextures);
+        }
+
+        costs.Enter(&result.report.correct);
+        if (!prepared) {
+            metrics.EnterStage(ConversionStage::PREPARE);
+            // Before export, so skin clusters are built from the welded vertices
+            if (optimization) {
+                MeshOptimizer optimizer(meshOptions);
+                MeshOptimizationResult optimized = optimizer.Optimize(meshData);
+                result.meshVerticesRemoved = optimized.RemovedVertices();
+                result.materialsMerged = optimized.MergedMaterials();
+                if (options.batchMaterials && !fileData.meshes.empty()) {
+                    MeshMergeResult merged = optimizer.MergeMeshes(fileData.meshes);
+                    result.meshesMerged = merged.originalMeshes - merged.remainingMeshes;
+                    result.materialsMerged += merged.originalMaterials - merged.remainingMaterials;
+                }
+            }
+
+            if (!meshData.animations.empty()) {
+                std::vector<TimingCorrectionResult> timingResults =
+                    timingCorrector.CorrectAllAnimations(meshData.animations);
+                produced.timingReport = timingCorrector.BuildTimingReport(timingResults);
+
+                if (options.validateTiming) {
+                    for (const auto& timing : timingResults) {
+                        if (!timing.isValid) {
+                            Logger::GetInstance().Warning(inputPath + ": animation timing correction failed: " +
+                                                          timing.errorDescription);
+                        }
+                    }
+                }
+
+                if (options.reduceKeyframes) {
+                    // Files already run in parallel; one thread per file's tracks
+                    KeyframeReductionOptions reduction = options.keyReduction;
+                    reduction.threads = 1;
+                    KeyframeReductionResult reduced = KeyframeReducer(reduction).ReduceAllAnimations(meshData.animations);
+                    result.keyframesRemoved = reduced.RemovedKeys();
+                    result.keyBytesSaved = reduced.BytesSaved();
+                }
+
+                // Last, so reduced tracks still come out uniformly sampled
+                if (resampling) {
+                    AnimationResampleOptions resample = *resampling;
+                    resample.threads = 1;
+                    AnimationResampleResult resampled = AnimationResampler(resample).ResampleAllAnimations(meshData.animations);
+                    result.keysResampled = resampled.resampledKeys;
+                }
+            }
+
+            // Last, so every pass above works at full precision
+            if (options.quantize) {
+                StreamQuantizer quantizer;
+                result.quantization = quantizer.Quantize(fileData);
+                quantizer.GenerateQuantizationReport(result.quantization, inputPath);
+            }
+
+            if (stageKeys.IsValid()) {
+                stages.StoreData(stageKeys.prepare, fileData, produced.timingReport, options.quantize);
+            }
+        }
+
+        // Before the static mesh is moved into its export
+        result.report.SetCounts(fileData);
+        costs.Enter(&result.report.exported);
+        metrics.EnterStage(ConversionStage::EXPORT);
+        if (!meshData.animations.empty()) {
+            // Files are already spread across workers, so clips stay on this one
+            std::vector<FBXExportResult> exportResults =
+                stages.ExportAnimations(*exporter, meshData, outputDirectory, baseName, exportOptions,
+                                        result.clipsRestored);
+            for (size_t i = 0; i < exportResults.size(); i++) {
+                if (!exportResults[i].success) {
+                    result.errorMessage = "Export failed for animation '" + meshData.animations[i].name + "': " +
+                                          exportResults[i].errorMessage;
+                    return Finish(result, startTime, metrics, costs);
+                }
+                produced.outputPaths.push_back(exportResults[i].outputPath);
+                result.filesWritten++;
+            }
+            result.exports = std::move(exportResults);
+        } else {
+            // Nothing below needs the mesh, so its streams go as they reach the scene
+            bool restored = false;
+            FBXExportResult exportResult = stages.ExportStaticMesh(*exporter, std::move(meshData), outputDirectory,
+                                                                   baseName, exportOptions, restored);
+            if (!exportResult.success) {
+                result.errorMessage = "Static mesh export failed: " + exportResult.errorMessage;
+                return Finish(result, startTime, metrics, costs);
+            }
+            result.clipsRestored += restored ? 1 : 0;
+            produced.outputPaths.push_back(exportResult.outputPath);
+            result.filesWritten++;
+            result.exports.push_back(exportResult);
+        }
+
+        if (!cacheKey.empty()) {
+            // Stored once every file is on disk and passed validation
+            RunAfterOutputs(produced.outputPaths, [&cache, cacheKey, baseName, produced]() {
+                cache.Store(cacheKey, baseName, produced);
+            }, writer, validator);
+        }
+        result.success = true;
+    } catch (const std::exception& e) {
+        result.errorMessage = "Exception during conversion: " + std::string(e.what());
+    }
+
+    return Finish(result, startTime, metrics, costs);
+}
+
+BatchConverter::BatchConverter(const BatchOptions& options)
+    : logger_(Logger::GetInstance())
+    , options_(options) {
+}
+
+std::vector<std::string> BatchConverter::CollectInputFiles(const std::string& source, bool recursive) {
+    std::vector<std::string> files;
+    std::error_code ec;
+
+    if (fs::is_directory(source, ec)) {
+        auto options = fs::directory_options::skip_permission_denied;
+        if (recursive) {
+            for (fs::recursive_directory_iterator it(source, options, ec), end; it != end; it.increment(ec)) {
+                if (ec) break;
+                if (it->is_regular_file(ec) && HasXExtension(it->path())) {
+                    files.push_back(it->path().string());
+                }
+            }
+        } else {
+            for (fs::directory_iterator it(source, options, ec), end; it != end; it.increment(ec)) {
+                if (ec) break;
+                if (it->is_regular_file(ec) && HasXExtension(it->path())) {
+                    files.push_back(it->path().string());
+                }
+            }
+        }
+        std::sort(files.begin(), files.end());
+    } else if (fs::is_regular_file(source, ec)) {
+        // List file: one path per line, blank lines and '#' comments ignored
+        std::ifstream list(source);
+        std::string line;
+        while (std::getline(list, line)) {
+            line = Trim(line);
+            if (!line.empty() && line[0] != '#') {
+                files.push_back(line);
+            }
+        }
+    } else {
+        LOG_ERROR("Batch source is neither a directory nor a list file: " + source);
+    }
+
+    return files;
+}
+
+BatchSummary BatchConverter::Run() {
+    std::vector<std::string> inputFiles = CollectInputFiles(options_.source, options_.recursive);
+    if (inputFiles.empty()) {
+        logger_.Warning("No .x files found in batch source: " + options_.source);
+    }
+    return Run(inputFiles);
+}
+
+BatchSummary BatchConverter::Run(const std::vector<std::string>& inputFiles) {
+    BatchSummary summary;
+    summary.totalFiles = inputFiles.size();
+    summary.results.resize(inputFiles.size());
+    summary.workerCount = ParallelUtils::ResolveThreadCount(options_.jobs, inputFiles.size());
+
+    if (inputFiles.empty()) {
+        return summary;
+    }
+
+    logger_.Info("Batch conversion of " + std::to_string(inputFiles.size()) + " files using " +
+                 std::to_string(summary.workerCount) + " workers");
+
+    // Two inputs writing the same FBX files would race on them; the later one fails instead
+    std::vector<std::string> collisions;
+    std::vector<std::string> outputDirectories = ResolveOutputDirectories(inputFiles, collisions);
+    for (size_t i = 0; i < inputFiles.size(); i++) {
+        if (!outputDirectories[i].empty()) {
+            continue;
+        }
+        BatchFileResult& result = summary.results[i];
+        result.inputPath = inputFiles[i];
+        result.report.input = inputFiles[i];
+        result.errorMessage = "Outputs would overwrite those of " + collisions[i] + "; rename one of the inputs";
+        logger_.Error("Batch: " + inputFiles[i] + ": " + result.errorMessage);
+    }
+
+    // Workers are created lazily on their own thread so FBX SDK managers
+    // are constructed in parallel as well
+    std::vector<std::unique_ptr<BatchWorker>> workers(summary.workerCount);
+    ConversionCache cache(options_.cache);
+    std::unique_ptr<TextureLibrary> textures;
+    if (options_.resolveTextures || options_.embedTextures) {
+        textures = std::make_unique<TextureLibrary>(options_.textures);
+    }
+    std::unique_ptr<InputPrefetcher> prefetcher;
+    if (options_.prefetch.maxBytes > 0) {
+        prefetcher = std::make_unique<InputPrefetcher>(inputFiles, options_.prefetch);
+    }
+    // Declared before the writer, whose last jobs queue checks on it
+    std::unique_ptr<OutputValidator> validator;
+    if (options_.validation == FBXExportOptions::Validation::FULL) {
+        validator = std::make_unique<OutputValidator>();
+    }
+    std::unique_ptr<OutputWriter> writer;
+    if (options_.writes.maxQueuedBytes > 0) {
+        writer = std::make_unique<OutputWriter>(options_.writes);
+    }
+    ConversionMetrics::GetInstance().AddFilesQueued(inputFiles.size());
+    std::atomic<size_t> completed(0);
+    const size_t progressStep = std::max<size_t>(1, inputFiles.size() / 20);
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    ParallelUtils::ParallelFor(inputFiles.size(), summary.workerCount,
+        [&](size_t index, size_t workerId) {
+            if (!workers[workerId]) {
+                workers[workerId] = std::make_unique<BatchWorker>();
+            }
+
+            const std::string& inputPath = inputFiles[index];
+            InputBuffer input = prefetcher ? prefetcher->Take(index) : nullptr;
+            if (outputDirectories[index].empty()) {
+                // Filled in as a failure before the workers started
+                completed.fetch_add(1);
+                return;
+            }
+            summary.results[index] = workers[workerId]->Convert(inputPath, outputDirectories[index], options_, cache,
+                                                                textures.get(), std::move(input), writer.get(),
+                                                                validator.get());
+            if (!summary.results[index].success) {
+                logger_.Error("Batch: " + inputPath + ": " + summary.results[index].errorMessage);
+            }
+
+            size_t done = completed.fetch_add(1) + 1;
+            if (done % progressStep == 0 || done == inputFiles.size()) {
+                logger_.LogProgress("Batch conversion", static_cast<int>(done), static_cast<int>(inputFiles.size()));
+            }
+        });
+
+    if (writer) {
+        // A file only succeeded once everything it exported is on disk
+        writer->Flush();
+        for (auto& result : summary.results) {
+            for (const auto& exported : result.exports) {
+                std::string error = result.success ? writer->GetError(exported.outputPath) : std::string();
+                if (!error.empty()) {
+                    result.success = false;
+                    result.errorMessage = error;
+                    logger_.Error("Batch: " + result.inputPath + ": " + error);
+                }
+            }
+        }
+        summary.writeStage = writer->GetStatistics();
+    }
+    if (validator) {
+        // After the writer: its last jobs submit the last checks
+        validator->Flush();
+        for (auto& result : summary.results) {
+            for (const auto& exported : result.exports) {
+                std::string error = result.success ? validator->GetError(exported.outputPath) : std::string();
+                if (!error.empty()) {
+                    result.success = false;
+                    result.errorMessage = error;
+                    logger_.Error("Batch: " + result.inputPath + ": " + error);
+                }
+            }
+        }
+        summary.validateStage = validator->GetStatistics();
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    summary.elapsedSeconds = std::chrono::duration<double>(endTime - startTime).count();
+    workers.clear();   // Their exporters go back to the pool
+    if (prefetcher) {
+        summary.readStage = prefetcher->GetStatistics();
+        summary.convertStage.waitSeconds = prefetcher->GetTakeWaitSeconds();
+    }
+    summary.exporterPool = FBXExporterPool::GetInstance().GetStatistics();
+    if (textures) {
+        summary.textures = textures->GetStatistics();
+    }
+
+    for (auto& result : summary.results) {
+        result.report.success = result.success;
+        result.report.error = result.errorMessage;
+        if (result.success) {
+            summary.succeeded++;
+        } else {
+            summary.failed++;
+        }
+        summary.totalInputBytes += result.inputBytes;
+        summary.filesWritten += static_cast<size_t>(result.filesWritten);
+        summary.cacheHits += result.cacheHit ? 1 : 0;
+        summary.parsesSkipped += result.parseSkipped ? 1 : 0;
+        summary.clipsRestored += result.clipsRestored;
+        summary.peakArenaBytes = std::max(summary.peakArenaBytes, result.arenaPeakBytes);
+        summary.keyframesRemoved += result.keyframesRemoved;
+        summary.keyBytesSaved += result.keyBytesSaved;
+        summary.meshVerticesRemoved += result.meshVerticesRemoved;
+        summary.materialsMerged += result.materialsMerged;
+        summary.meshesMerged += result.meshesMerged;
+        summary.quantization.Merge(result.quantization);
+        summary.keysResampled += result.keysResampled;
+        summary.convertStage.busySeconds += result.elapsedMs / 1000.0;
+    }
+    summary.convertStage.threads = summary.workerCount;
+    summary.convertStage.items = summary.totalFiles;
+    summary.convertStage.bytes = summary.totalInputBytes;
+
+    return summary;
+}
+
+std::vector<std::string> BatchConverter::ResolveOutputDirectories(const std::vector<std::string>& inputFiles,
+                                                                  std::vector<std::string>& collisions) const {
+    auto normalized = [](const fs::path& path) {
+        std::error_code ec;
+        fs::path absolute = fs::absolute(path, ec);
+        return (ec ? path : absolute).lexically_normal();
+    };
+
+    std::vector<fs::path> parents;
+    parents.reserve(inputFiles.size());
+    for (const auto& inputPath : inputFiles) {
+        parents.push_back(normalized(fs::path(inputPath).parent_path()));
+    }
+
+    std::error_code ec;
+    fs::path root;
+    if (fs::is_directory(options_.source, ec)) {
+        root = normalized(options_.source);
+    } else if (!parents.empty()) {
+        // Deepest directory every listed input is below
+        root = parents[0];
+        for (const auto& parent : parents) {
+            fs::path shared;
+            for (auto a = root.begin(), b = parent.begin(); a != root.end() && b != parent.end() && *a == *b; ++a, ++b) {
+                shared /= *a;
+            }
+            root = shared;
+        }
+    }
+
+    std::vector<std::string> directories;
+    directories.reserve(inputFiles.size());
+    collisions.assign(inputFiles.size(), std::string());
+    std::map<std::string, size_t> owners;   // Output directory and base name -> input
+    for (size_t i = 0; i < inputFiles.size(); i++) {
+        fs::path directory = options_.outputDirectory;
+        fs::path relative = parents[i].lexically_relative(root);
+        // Dot-prefixed directories such as .assets are mirrored; only a path
+        // that leaves the root is not
+        if (!relative.empty() && relative != "." && *relative.begin() != "..") {
+            directory /= relative;
+        }
+        std::string output = (directory / fs::path(inputFiles[i]).stem()).lexically_normal().string();
+        auto owner = owners.emplace(output, i);
+        if (owner.second) {
+            directories.push_back(directory.string());
+        } else {
+            directories.push_back(std::string());
+            collisions[i] = inputFiles[owner.first->second];
+        }
+    }
+    return directories;
+}
+
+void BatchConverter::PrintSummary(const BatchSummary& summary) {
+    std::cout << std::endl << "=== BATCH SUMMARY ===" << std::endl;
+    std::cout << "  - Input files: " << summary.totalFiles << std::endl;
+    std::cout << "  - Succeeded: " << summary.succeeded << std::endl;
+    std::cout << "  - Failed: " << summary.failed << std::endl;
+    std::cout << "  - FBX files written: " << summary.filesWritten << std::endl;
+    if (summary.cacheHits > 0) {
+        std::cout << "  - Cache hits: " << summary.cacheHits << "/" << summary.totalFiles << std::endl;
+    }
+    if (summary.parsesSkipped > 0 || summary.clipsRestored > 0) {
+        std::cout << "  - Reused stages: " << summary.parsesSkipped << " parses skipped, "
+                  << summary.clipsRestored << " FBX files restored from earlier exports" << std::endl;
+    }
+    std::cout << "  - Workers: " << summary.workerCount << std::endl;
+    std::cout << "  - FBX exporter pool: " << summary.exporterPool.hits << " hits, "
+              << summary.exporterPool.misses << " misses, " << summary.exporterPool.sceneResets
+              << " scene resets" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  - Elapsed: " << summary.elapsedSeconds << " s" << std::endl;
+    std::cout << "  - Throughput: " << summary.FilesPerSecond() << " files/s, "
+              << summary.MegabytesPerSecond() << " MB/s" << std::endl;
+    std::cout << "  - Peak parse arena: " << summary.peakArenaBytes / 1024.0 << " KB" << std::endl;
+    if (summary.keyframesRemoved > 0) {
+        std::cout << "  - Keyframes removed: " << summary.keyframesRemoved << " (~"
+                  << summary.keyBytesSaved / 1024.0 << " KB of key data)" << std::endl;
+    }
+    if (summary.meshVerticesRemoved > 0) {
+        std::cout << "  - Mesh vertices removed: " << summary.meshVerticesRemoved << std::endl;
+    }
+    if (summary.materialsMerged > 0 || summary.meshesMerged > 0) {
+        std::cout << "  - Materials merged: " << summary.materialsMerged << ", meshes merged: " << summary.meshesMerged
+                  << std::endl;
+    }
+    if (summary.quantization.meshes > 0) {
+        const QuantizationResult& quantized = summary.quantization;
+        std::cout << "  - Quantized: " << quantized.floatBytes / 1024 << " KB -> " << quantized.quantizedBytes / 1024
+                  << " KB of streams and rotation keys (max error position " << std::defaultfloat
+                  << quantized.maxPositionError << ", normal " << quantized.maxNormalErrorDegrees << " deg, rotation "
+                  << quantized.maxRotationErrorDegrees << " deg)" << std::fixed << std::endl;
+    }
+    if (summary.keysResampled > 0) {
+        std::cout << "  - Keys resampled: " << summary.keysResampled << std::endl;
+    }
+    if (summary.readStage.threads > 0 || summary.writeStage.threads > 0 || summary.validateStage.threads > 0) {
+        const struct { const char* name; const PipelineStageStatistics& stage; } stages[] = {
+            {"read", summary.readStage}, {"convert", summary.convertStage}, {"write", summary.writeStage},
+            {"validate", summary.validateStage}
+        };
+        const char* bottleneck = "convert";
+        double highest = 0.0;
+        std::cout << "  - Pipeline utilization:";
+        for (const auto& entry : stages) {
+            double utilization = entry.stage.Utilization(summary.elapsedSeconds);
+            if (entry.stage.threads == 0) {
+                std::cout << " " << entry.name << " off,";
+                continue;
+            }
+            std::cout << " " << entry.name << " " << utilization * 100.0 << "% (" << entry.stage.threads << "),";
+            if (utilization > highest) {
+                highest = utilization;
+                bottleneck = entry.name;
+            }
+        }
+        std::cout << " bottleneck: " << bottleneck << std::endl;
+        std::cout << "  - Pipeline waits: workers " << summary.convertStage.waitSeconds << " s for input, readers "
+                  << summary.readStage.waitSeconds << " s on the read-ahead limit, exporters "
+                  << summary.writeStage.waitSeconds << " s on the write queue" << std::endl;
+    }
+    if (summary.textures.requests > 0) {
+        std::cout << "  - Textures: " << summary.textures.requests << " requested, " << summary.textures.lookups
+                  << " looked up (" << summary.textures.missing << " missing), " << summary.textures.loads
+                  << " files read (" << summary.textures.bytesLoaded / 1024.0 << " KB)" << std::endl;
+    }
+
+    if (summary.failed > 0) {
+        std::cout << std::endl << "Failed files:" << std::endl;
+        for (const auto& result : summary.results) {
+            if (!result.success) {
+                std::cout << "  - " << result.inputPath << ": " << result.errorMessage << std::endl;
+            }
+        }
+    }
+
+    std::cout << "=====================" << std::endl;
+}
+
+bool BatchConverter::WriteReport(const BatchSummary& summary, const std::string& path) {
+    ConversionReportWriter writer(path);
+    if (!writer.IsOpen()) {
+        LOG_ERROR("Cannot write conversion report: " + path);
+        return false;
+    }
+
+    ConversionRecord totals;
+    size_t decompressed = 0;
+    for (const auto& result : summary.results) {
+        const ConversionRecord& report = result.report;
+        writer.Write(report);
+
+        totals.parse.Add(report.parse);
+        totals.correct.Add(report.correct);
+        totals.exported.Add(report.exported);
+        totals.total.Add(report.total);
+        totals.peakRssBytes = std::max(totals.peakRssBytes, report.peakRssBytes);
+        totals.decompressionAttempts += report.decompressionAttempts;
+        decompressed += report.decompressionMethod.empty() ? 0 : 1;
+        totals.vertices += report.vertices;
+        totals.faces += report.faces;
+        totals.bones += report.bones;
+        totals.animations += report.animations;
+        totals.keys += report.keys;
+        totals.outputs += report.outputs;
+    }
+
+    // Stage costs are sums over the files; elapsedMs is the batch's wall time
+    auto cost = [](const StageCost& stage) {
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(3) << "{\"wallMs\": " << stage.wallMs << ", \"cpuMs\": " << stage.cpuMs
+             << "}";
+        return json.str();
+    };
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\"type\": \"batch\""
+         << ", \"files\": " << summary.totalFiles
+         << ", \"succeeded\": " << summary.succeeded
+         << ", \"failed\": " << summary.failed
+         << ", \"cacheHits\": " << summary.cacheHits
+         << ", \"parsesSkipped\": " << summary.parsesSkipped
+         << ", \"inputBytes\": " << summary.totalInputBytes
+         << ", \"workers\": " << summary.workerCount
+         << ", \"elapsedMs\": " << summary.elapsedSeconds * 1000.0
+         << ", \"filesPerSecond\": " << summary.FilesPerSecond()
+         << ", \"megabytesPerSecond\": " << summary.MegabytesPerSecond()
+         << ", \"decompressedFiles\": " << decompressed
+         << ", \"decompressionAttempts\": " << totals.decompressionAttempts
+         << ", \"parse\": " << cost(totals.parse)
+         << ", \"correct\": " << cost(totals.correct)
+         << ", \"export\": " << cost(totals.exported)
+         << ", \"total\": " << cost(totals.total)
+         << ", \"peakRssBytes\": " << totals.peakRssBytes
+         << ", \"peakArenaBytes\": " << summary.peakArenaBytes
+         << ", \"vertices\": " << totals.vertices
+         << ", \"faces\": " << totals.faces
+         << ", \"bones\": " << totals.bones
+         << ", \"animations\": " << totals.animations
+         << ", \"keys\": " << totals.keys
+         << ", \"outputs\": " << totals.outputs << "}";
+    writer.WriteLine(json.str());
+    return true;
+}
+
+} // namespace X2FBX
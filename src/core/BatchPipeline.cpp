@@ -0,0 +1,430 @@
+#include "BatchPipeline.h"
+#include "FBXExporter.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace X2FBX {
+
+namespace {
+
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+struct InputPrefetcher::State {
+    enum class Slot : uint8_t { PENDING, READY, SKIPPED, TAKEN };
+
+    std::vector<std::string> files;
+    InputPrefetchOptions options;
+
+    std::mutex mutex;
+    std::condition_variable changed;   // A slot, the budget or the admission order moved
+    std::vector<Slot> slots;
+    std::vector<InputBuffer> buffers;  // READY slots until taken
+    size_t nextToRead = 0;             // Claimed by a reader
+    size_t nextToAdmit = 0;            // Files enter the budget in input order
+    uint64_t heldBytes = 0;            // Read or being read, not yet dropped by a worker
+    bool stopping = false;
+    PipelineStageStatistics statistics;
+    double takeWaitSeconds = 0.0;
+};
+
+InputPrefetcher::InputPrefetcher(const std::vector<std::string>& inputFiles, const InputPrefetchOptions& options)
+    : state_(std::make_shared<State>()) {
+    state_->files = inputFiles;
+    state_->options = options;
+    state_->slots.assign(inputFiles.size(), State::Slot::PENDING);
+    state_->buffers.resize(inputFiles.size());
+
+    size_t threads = inputFiles.empty() ? 0 : std::max<size_t>(1, std::min(options.threads, inputFiles.size()));
+    state_->statistics.threads = threads;
+    for (size_t t = 0; t < threads; t++) {
+        threads_.emplace_back(&InputPrefetcher::RunReader, this);
+    }
+}
+
+InputPrefetcher::~InputPrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stopping = true;
+    }
+    state_->changed.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+
+    // Untaken buffers release their budget under the lock when destroyed
+    std::vector<InputBuffer> untaken;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        untaken.swap(state_->buffers);
+    }
+}
+
+InputBuffer InputPrefetcher::Take(size_t index) {
+    State& state = *state_;
+    auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(state.mutex);
+    if (index >= state.slots.size()) {
+        return nullptr;
+    }
+    state.changed.wait(lock, [&]() { return state.stopping || state.slots[index] != State::Slot::PENDING; });
+    state.takeWaitSeconds += SecondsSince(start);
+
+    InputBuffer buffer;
+    if (state.slots[index] == State::Slot::READY) {
+        buffer = std::move(state.buffers[index]);
+    }
+    state.slots[index] = State::Slot::TAKEN;
+    return buffer;
+}
+
+PipelineStageStatistics InputPrefetcher::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->statistics;
+}
+
+double InputPrefetcher::GetTakeWaitSeconds() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->takeWaitSeconds;
+}
+
+void InputPrefetcher::RunReader() {
+    State& state = *state_;
+    while (true) {
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            if (state.stopping || state.nextToRead >= state.files.size()) {
+                return;
+            }
+            index = state.nextToRead++;
+        }
+
+        std::error_code ec;
+        const uint64_t size = fs::file_size(state.files[index], ec);
+        const bool prefetch = !ec && size <= state.options.maxBytes;
+
+        // In input order, so a later file never holds the budget an earlier
+        // one (which some worker is waiting for) needs
+        auto waitStart = std::chrono::steady_clock::now();
+        {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            state.changed.wait(lock, [&]() {
+                return state.stopping ||
+                       (state.nextToAdmit == index &&
+                        (!prefetch || state.heldBytes == 0 || state.heldBytes + size <= state.options.maxBytes));
+            });
+            if (state.stopping) {
+                return;
+            }
+            state.statistics.waitSeconds += SecondsSince(waitStart);
+            state.nextToAdmit++;
+            if (prefetch) {
+                state.heldBytes += size;
+            } else {
+                state.slots[index] = State::Slot::SKIPPED;
+            }
+        }
+        state.changed.notify_all();
+        if (!prefetch) {
+            continue;
+        }
+
+        auto readStart = std::chrono::steady_clock::now();
+        std::shared_ptr<State> owner = state_;
+        std::shared_ptr<std::vector<uint8_t>> buffer(new std::vector<uint8_t>(static_cast<size_t>(size)),
+            [owner, size](std::vector<uint8_t>* bytes) {
+                delete bytes;
+                {
+                    std::lock_guard<std::mutex> lock(owner->mutex);
+                    owner->heldBytes -= size;
+                }
+                owner->changed.notify_all();
+            });
+        std::ifstream file(state.files[index], std::ios::binary);
+        file.read(reinterpret_cast<char*>(buffer->data()), static_cast<std::streamsize>(buffer->size()));
+        const bool complete = file && static_cast<uint64_t>(file.gcount()) == size;
+
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            state.statistics.busySeconds += SecondsSince(readStart);
+            if (complete) {
+                state.statistics.items++;
+                state.statistics.bytes += size;
+                state.buffers[index] = std::move(buffer);
+                state.slots[index] = State::Slot::READY;
+            } else {
+                state.slots[index] = State::Slot::SKIPPED;   // The worker reports the error
+            }
+        }
+        buffer.reset();   // Outside the lock: the deleter takes it
+        state.changed.notify_all();
+    }
+}
+
+OutputWriter::OutputWriter(const OutputWriterOptions& options)
+    : logger_(Logger::GetInstance())
+    , options_(options)
+    , queuedBytes_(0)
+    , writing_(false)
+    , stopping_(false) {
+    statistics_.threads = 1;
+    thread_ = std::thread(&OutputWriter::Run, this);
+}
+
+OutputWriter::~OutputWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+}
+
+void OutputWriter::Write(const std::string& path, std::vector<uint8_t>&& bytes) {
+    Task task;
+    task.path = path;
+    task.bytes = std::move(bytes);
+    Enqueue(std::move(task));
+}
+
+void OutputWriter::Then(const std::vector<std::string>& paths, std::function<void()> job) {
+    Task task;
+    task.dependencies = paths;
+    task.job = std::move(job);
+    Enqueue(std::move(task));
+}
+
+void OutputWriter::Enqueue(Task&& task) {
+    const uint64_t size = task.bytes.size();
+    auto waitStart = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        drained_.wait(lock, [&]() {
+            return queuedBytes_ == 0 || queuedBytes_ + size <= options_.maxQueuedBytes;
+        });
+        statistics_.waitSeconds += SecondsSince(waitStart);
+        queuedBytes_ += size;
+        queue_.push_back(std::move(task));
+    }
+    wake_.notify_one();
+}
+
+void OutputWriter::Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this]() { return queue_.empty() && !writing_; });
+}
+
+std::string OutputWriter::GetError(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = errors_.find(path);
+    return found != errors_.end() ? found->second : std::string();
+}
+
+PipelineStageStatistics OutputWriter::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+void OutputWriter::Run() {
+    while (true) {
+        Task task;
+        bool runJob = true;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;   // Stopping, and everything is written
+            }
+            task = std::move(queue_.front());
+            queue_.pop_front();
+            writing_ = true;
+            for (const auto& path : task.dependencies) {
+                runJob = runJob && errors_.find(path) == errors_.end();
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::string error;
+        const uint64_t size = task.bytes.size();
+        if (task.job) {
+            if (runJob) {
+                try {
+                    task.job();
+                } catch (const std::exception& e) {
+                    logger_.Warning(std::string("Write stage job failed: ") + e.what());
+                }
+            }
+        } else {
+            TIME_OPERATION("OutputWriter::Write");
+            timer.AddBytes(size);
+            std::ofstream file(task.path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                error = "Cannot create output file: " + task.path;
+            } else {
+                file.write(reinterpret_cast<const char*>(task.bytes.data()), static_cast<std::streamsize>(size));
+                file.close();
+                if (!file) {
+                    error = "Failed to write FBX file: " + task.path;
+                }
+            }
+            if (!error.empty()) {
+                logger_.Error(error);
+            }
+            task.bytes = std::vector<uint8_t>();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            statistics_.busySeconds += SecondsSince(start);
+            if (!task.job) {
+                queuedBytes_ -= size;
+                if (error.empty()) {
+                    statistics_.items++;
+                    statistics_.bytes += size;
+                    errors_.erase(task.path);
+                } else {
+                    errors_[task.path] = error;
+                }
+            }
+            writing_ = false;
+        }
+        drained_.notify_all();
+    }
+}
+
+OutputValidator::OutputValidator()
+    : logger_(Logger::GetInstance())
+    , checking_(false)
+    , stopping_(false) {
+    statistics_.threads = 1;
+    thread_ = std::thread(&OutputValidator::Run, this);
+}
+
+OutputValidator::~OutputValidator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+}
+
+void OutputValidator::Submit(const std::string& path, OutputWriter* writer) {
+    if (writer) {
+        writer->Then({path}, [this, path]() { Submit(path); });
+        return;
+    }
+    Task task;
+    task.path = path;
+    Enqueue(std::move(task));
+}
+
+void OutputValidator::Then(const std::vector<std::string>& paths, std::function<void()> job, OutputWriter* writer) {
+    if (writer) {
+        writer->Then(paths, [this, paths, job]() { Then(paths, job); });
+        return;
+    }
+    Task task;
+    task.dependencies = paths;
+    task.job = std::move(job);
+    Enqueue(std::move(task));
+}
+
+void OutputValidator::Enqueue(Task&& task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+    wake_.notify_one();
+}
+
+void OutputValidator::Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this]() { return queue_.empty() && !checking_; });
+}
+
+std::string OutputValidator::GetError(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = errors_.find(path);
+    return found != errors_.end() ? found->second : std::string();
+}
+
+PipelineStageStatistics OutputValidator::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+void OutputValidator::Run() {
+    while (true) {
+        Task task;
+        bool runJob = true;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;   // Stopping, and everything is checked
+            }
+            task = std::move(queue_.front());
+            queue_.pop_front();
+            checking_ = true;
+            for (const auto& path : task.dependencies) {
+                runJob = runJob && errors_.find(path) == errors_.end();
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        FBXUtils::FBXFileCheck check;
+        if (task.job) {
+            if (runJob) {
+                try {
+                    task.job();
+                } catch (const std::exception& e) {
+                    logger_.Warning(std::string("Validation stage job failed: ") + e.what());
+                }
+            }
+        } else {
+            check = FBXUtils::CheckFBXFile(task.path);
+            if (!check.valid) {
+                logger_.Error("FBX validation failed for " + task.path + ": " + check.error);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            statistics_.busySeconds += SecondsSince(start);
+            if (!task.job) {
+                statistics_.items++;
+                statistics_.bytes += check.fileBytes;
+                if (check.valid) {
+                    errors_.erase(task.path);
+                } else {
+                    errors_[task.path] = "Validation failed: " + check.error;
+                }
+            }
+            checking_ = false;
+        }
+        drained_.notify_all();
+    }
+}
+
+void RunAfterOutputs(const std::vector<std::string>& paths, std::function<void()> job, OutputWriter* writer,
+                     OutputValidator* validator) {
+    if (validator) {
+        validator->Then(paths, std::move(job), writer);
+    } else if (writer) {
+        writer->Then(paths, std::move(job));
+    } else {
+        job();
+    }
+}
+
+} // namespace X2FBX
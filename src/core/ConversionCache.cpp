@@ -0,0 +1,475 @@
+#include "ConversionCache.h"
+#include "AnimationResampler.h"
+#include "FBXExporter.h"
+#include "KeyframeReducer.h"
+#include "MappedFile.h"
+#include "TextureLibrary.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace X2FBX {
+
+namespace {
+
+constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ull;
+constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ull;
+
+const char* const MANIFEST_NAME = "manifest";
+const char* const MANIFEST_MAGIC = "x2fbx-cache";
+const char* const STAGING_PREFIX = ".tmp-";
+
+// Staging directories this old belong to a writer that died
+constexpr auto STALE_STAGING_AGE = std::chrono::hours(1);
+
+uint64_t RotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t Read64(const uint8_t* data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint32_t Read32(const uint8_t* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint64_t Round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * PRIME64_2;
+    accumulator = RotateLeft(accumulator, 31);
+    return accumulator * PRIME64_1;
+}
+
+uint64_t MergeRound(uint64_t accumulator, uint64_t value) {
+    accumulator ^= Round(0, value);
+    return accumulator * PRIME64_1 + PRIME64_4;
+}
+
+std::string ToHex(uint64_t value) {
+    std::ostringstream hex;
+    hex << std::hex << std::setw(16) << std::setfill('0') << value;
+    return hex.str();
+}
+
+// Output file names are stored relative to the converted file's base name,
+// so a renamed copy of the same input still hits
+std::string OutputSuffix(const std::string& fileName, const std::string& baseName, bool& relative) {
+    relative = !baseName.empty() && fileName.compare(0, baseName.size(), baseName) == 0;
+    return relative ? fileName.substr(baseName.size()) : fileName;
+}
+
+void ReplaceNewlines(std::string& text) {
+    std::replace(text.begin(), text.end(), '\n', ' ');
+    std::replace(text.begin(), text.end(), '\r', ' ');
+}
+
+std::string UniqueStagingName(const std::string& key) {
+    static std::atomic<uint64_t> sequence(0);
+    std::random_device random;
+    uint64_t token = (uint64_t(random()) << 32) ^ random() ^
+                     uint64_t(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                     std::hash<std::thread::id>()(std::this_thread::get_id()) ^ (sequence.fetch_add(1) << 48);
+    return STAGING_PREFIX + key + "-" + ToHex(token);
+}
+
+} // namespace
+
+ConversionCache::ConversionCache(const ConversionCacheOptions& options)
+    : logger_(Logger::GetInstance())
+    , options_(options)
+    , hits_(0)
+    , misses_(0)
+    , stores_(0)
+    , evictions_(0)
+    , totalBytes_(0) {
+    if (IsEnabled()) {
+        EnforceSizeLimit();
+    }
+}
+
+uint64_t ConversionCache::HashBytes(const uint8_t* data, size_t size, uint64_t seed) {
+    const uint8_t* cursor = data;
+    const uint8_t* end = data + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = seed + PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME64_1;
+        const uint8_t* limit = end - 32;
+        do {
+            v1 = Round(v1, Read64(cursor));
+            v2 = Round(v2, Read64(cursor + 8));
+            v3 = Round(v3, Read64(cursor + 16));
+            v4 = Round(v4, Read64(cursor + 24));
+            cursor += 32;
+        } while (cursor <= limit);
+
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    } else {
+        hash = seed + PRIME64_5;
+    }
+
+    hash += static_cast<uint64_t>(size);
+
+    for (; cursor + 8 <= end; cursor += 8) {
+        hash ^= Round(0, Read64(cursor));
+        hash = RotateLeft(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (cursor + 4 <= end) {
+        hash ^= uint64_t(Read32(cursor)) * PRIME64_1;
+        hash = RotateLeft(hash, 23) * PRIME64_2 + PRIME64_3;
+        cursor += 4;
+    }
+    for (; cursor < end; cursor++) {
+        hash ^= (*cursor) * PRIME64_5;
+        hash = RotateLeft(hash, 11) * PRIME64_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::string ConversionCache::ExportFingerprint(const FBXExportOptions& exportOptions) {
+    // Thread counts are left out: they never change what is written
+    std::ostringstream fingerprint;
+    fingerprint << std::setprecision(9);
+    fingerprint << MANIFEST_MAGIC << " v" << FORMAT_VERSION;
+    switch (FBXExporter::ResolveBackend(exportOptions)) {
+    case FBXExportOptions::Backend::NATIVE:
+        fingerprint << ";exporter=native";
+        break;
+    default:
+        fingerprint << ";exporter=" << (FBXExporter::IsFBXSDKAvailable() ? "sdk" : "placeholder");
+        break;
+    }
+    fingerprint << ";format=" << (exportOptions.fileFormat == FBXExportOptions::FileFormat::ASCII ? "ascii" : "binary")
+                << ";animations=" << exportOptions.exportAnimations
+                << ";materials=" << exportOptions.exportMaterials
+                << ";textures=" << exportOptions.exportTextures
+                << ";embed=" << exportOptions.embedTextures
+                << ";validate=" << static_cast<int>(exportOptions.validation)
+                << ";convertAxes=" << exportOptions.convertCoordinateSystem
+                << ";flipYZ=" << exportOptions.flipYZ
+                << ";reverseWinding=" << exportOptions.reverseWinding
+                << ";separate=" << exportOptions.separateAnimationFiles
+                << ";fps=" << exportOptions.animationFrameRate
+                << ";compress=" << exportOptions.compressArrays
+                << ";level=" << exportOptions.compressionLevel
+                << ";clipEmbed=" << exportOptions.embedTexturesInClips;
+    // Resolved files, with their sizes and times, stand in for the image bytes
+    if (exportOptions.textures) {
+        fingerprint << ";textureFiles=" << exportOptions.textures->Fingerprint();
+    }
+    return fingerprint.str();
+}
+
+std::string ConversionCache::Fingerprint(const FBXExportOptions& exportOptions, bool strictMode,
+                                         const KeyframeReductionOptions* keyReduction,
+                                         const std::vector<std::string>& animationFilter,
+                                         const AnimationResampleOptions* resampling) {
+    std::ostringstream fingerprint;
+    fingerprint << std::setprecision(9);
+    fingerprint << ExportFingerprint(exportOptions) << ";optimize=" << exportOptions.optimizeMesh
+                << ";batchMaterials=" << exportOptions.batchMaterials << ";quantize=" << exportOptions.quantize
+                << ";strict=" << strictMode;
+    if (keyReduction) {
+        fingerprint << ";reduce=" << keyReduction->positionTolerance << "," << keyReduction->rotationTolerance
+                    << "," << keyReduction->scaleTolerance;
+    } else {
+        fingerprint << ";reduce=off";
+    }
+    if (resampling) {
+        fingerprint << ";resample=" << resampling->frameRate;
+    } else {
+        fingerprint << ";resample=off";
+    }
+    // Length-prefixed, so no name can forge a separator
+    fingerprint << ";select=" << animationFilter.size();
+    for (const auto& name : animationFilter) {
+        fingerprint << "," << name.size() << ":" << name;
+    }
+    return fingerprint.str();
+}
+
+std::string ConversionCache::ComputeKey(const std::string& inputPath, const std::string& fingerprint) const {
+    TIME_OPERATION("ConversionCache::ComputeKey");
+    MappedFile input;
+    if (!input.Open(inputPath)) {
+        return "";
+    }
+    ByteView bytes = input.View();
+    timer.AddBytes(bytes.size());
+
+    return MakeKey(HashBytes(bytes.data(), bytes.size()), fingerprint);
+}
+
+std::string ConversionCache::ComputeKey(ByteView input, const std::string& fingerprint) const {
+    TIME_OPERATION("ConversionCache::ComputeKey");
+    timer.AddBytes(input.size());
+    return MakeKey(HashBytes(input.data(), input.size()), fingerprint);
+}
+
+std::string ConversionCache::MakeKey(uint64_t contentHash, const std::string& fingerprint) {
+    uint64_t optionsHash = HashBytes(reinterpret_cast<const uint8_t*>(fingerprint.data()), fingerprint.size());
+    return ToHex(contentHash) + ToHex(optionsHash);
+}
+
+std::string ConversionCache::DeriveKey(const std::string& parentKey, const std::string& fingerprint) {
+    return MakeKey(HashBytes(reinterpret_cast<const uint8_t*>(parentKey.data()), parentKey.size()), fingerprint);
+}
+
+std::string ConversionCache::TemporaryPath(const std::string& key, const std::string& extension) {
+    std::error_code ec;
+    fs::create_directories(options_.directory, ec);
+    if (!fs::is_directory(options_.directory, ec)) {
+        return "";
+    }
+    return (fs::path(options_.directory) / (UniqueStagingName(key) + extension)).string();
+}
+
+std::string ConversionCache::EntryPath(const std::string& key) const {
+    return (fs::path(options_.directory) / key).string();
+}
+
+bool ConversionCache::Restore(const std::string& key, const std::string& outputDirectory,
+                              const std::string& baseName, CachedConversion& conversion) {
+    TIME_OPERATION("ConversionCache::Restore");
+    return Fetch(key, &outputDirectory, baseName, conversion);
+}
+
+bool ConversionCache::Lookup(const std::string& key, CachedConversion& conversion) {
+    return Fetch(key, nullptr, "", conversion);
+}
+
+bool ConversionCache::Fetch(const std::string& key, const std::string* outputDirectory, const std::string& baseName,
+                            CachedConversion& conversion) {
+    conversion = CachedConversion();
+    if (!IsEnabled() || key.empty()) {
+        return false;
+    }
+
+    fs::path entry = EntryPath(key);
+    fs::path manifestPath = entry / MANIFEST_NAME;
+    std::ifstream manifest(manifestPath);
+    std::string line;
+    if (!manifest.is_open() || !std::getline(manifest, line) ||
+        line != std::string(MANIFEST_MAGIC) + " " + std::to_string(FORMAT_VERSION)) {
+        misses_++;
+        return false;
+    }
+
+    std::error_code ec;
+    size_t outputIndex = 0;
+    while (std::getline(manifest, line)) {
+        if (line.compare(0, 7, "output ") == 0 && line.size() > 9) {
+            // "output s <suffix>" (after the base name) or "output n <file name>"
+            fs::path source = entry / ("out" + std::to_string(outputIndex));
+            outputIndex++;
+            if (!outputDirectory) {
+                conversion.outputPaths.push_back(source.string());
+                continue;
+            }
+            std::string name = line.substr(9);
+            std::string fileName = line[7] == 's' ? baseName + name : name;
+            fs::path target = fs::path(*outputDirectory) / fileName;
+            fs::copy_file(source, target, fs::copy_options::overwrite_existing, ec);
+            if (ec) {
+                // Evicted while we were reading it
+                logger_.Debug("Cache entry " + key + " vanished during restore: " + ec.message());
+                misses_++;
+                return false;
+            }
+            conversion.outputPaths.push_back(target.string());
+        } else if (line.compare(0, 7, "report ") == 0) {
+            std::istringstream fields(line.substr(7));
+            int level = 0;
+            fields >> level;
+            std::string text;
+            std::getline(fields >> std::ws, text);
+            conversion.timingReport.push_back({static_cast<LogLevel>(level), text});
+        }
+    }
+
+    // Mark the entry as recently used for eviction
+    fs::last_write_time(manifestPath, fs::file_time_type::clock::now(), ec);
+    hits_++;
+    logger_.Debug("Cache hit " + key + ": restored " + std::to_string(conversion.outputPaths.size()) + " files");
+    return true;
+}
+
+bool ConversionCache::Store(const std::string& key, const std::string& baseName, const CachedConversion& conversion,
+                            bool moveOutputs) {
+    if (!IsEnabled() || key.empty()) {
+        return false;
+    }
+    TIME_OPERATION("ConversionCache::Store");
+
+    std::error_code ec;
+    fs::create_directories(options_.directory, ec);
+    fs::path entry = EntryPath(key);
+    if (fs::exists(entry / MANIFEST_NAME, ec)) {
+        return true;
+    }
+
+    fs::path staging = fs::path(options_.directory) / UniqueStagingName(key);
+    if (!fs::create_directory(staging, ec)) {
+        logger_.Warning("Cannot create cache staging directory " + staging.string() + ": " + ec.message());
+        return false;
+    }
+
+    uint64_t entryBytes = 0;
+    std::ofstream manifest(staging / MANIFEST_NAME);
+    manifest << MANIFEST_MAGIC << " " << FORMAT_VERSION << "\n";
+    for (size_t i = 0; i < conversion.outputPaths.size(); i++) {
+        fs::path output = conversion.outputPaths[i];
+        fs::path stored = staging / ("out" + std::to_string(i));
+        if (moveOutputs) {
+            fs::rename(output, stored, ec);
+        }
+        if (!moveOutputs || ec) {
+            ec.clear();
+            fs::copy_file(output, stored, ec);
+        }
+        if (ec) {
+            logger_.Warning("Cannot cache " + output.string() + ": " + ec.message());
+            manifest.close();
+            fs::remove_all(staging, ec);
+            return false;
+        }
+        std::error_code sizeError;
+        uint64_t size = fs::file_size(stored, sizeError);
+        entryBytes += sizeError ? 0 : size;
+        bool relative = false;
+        std::string name = OutputSuffix(output.filename().string(), baseName, relative);
+        manifest << "output " << (relative ? 's' : 'n') << " " << name << "\n";
+    }
+    for (const auto& reportLine : conversion.timingReport) {
+        std::string text = reportLine.text;
+        ReplaceNewlines(text);
+        manifest << "report " << static_cast<int>(reportLine.level) << " " << text << "\n";
+    }
+    entryBytes += static_cast<uint64_t>(std::max<std::streamoff>(manifest.tellp(), 0));
+    manifest.close();
+    if (!manifest) {
+        logger_.Warning("Cannot write cache manifest for " + key);
+        fs::remove_all(staging, ec);
+        return false;
+    }
+
+    // Publishing is one rename; if another writer got there first its entry is kept
+    fs::rename(staging, entry, ec);
+    if (ec) {
+        fs::remove_all(staging, ec);
+        return fs::exists(entry / MANIFEST_NAME, ec);
+    }
+
+    stores_++;
+    if (totalBytes_.fetch_add(entryBytes) + entryBytes > options_.maxBytes) {
+        EnforceSizeLimit();
+    }
+    return true;
+}
+
+void ConversionCache::EnforceSizeLimit() {
+    std::lock_guard<std::mutex> lock(evictionMutex_);
+
+    struct Entry {
+        fs::path path;
+        uint64_t bytes;
+        fs::file_time_type lastUsed;
+    };
+    std::vector<Entry> entries;
+    uint64_t totalBytes = 0;
+    auto now = fs::file_time_type::clock::now();
+
+    std::error_code ec;
+    for (fs::directory_iterator it(options_.directory, ec), end; it != end; it.increment(ec)) {
+        if (ec) break;
+        std::error_code entryError;
+        std::string name = it->path().filename().string();
+        if (name.compare(0, std::strlen(STAGING_PREFIX), STAGING_PREFIX) == 0) {
+            // Staging directories and TemporaryPath files alike
+            auto modified = fs::last_write_time(it->path(), entryError);
+            if (!entryError && now - modified > STALE_STAGING_AGE) {
+                fs::remove_all(it->path(), entryError);
+            }
+            continue;
+        }
+        if (!it->is_directory(entryError)) {
+            continue;
+        }
+
+        Entry entry{it->path(), 0, fs::last_write_time(it->path() / MANIFEST_NAME, entryError)};
+        if (entryError) {
+            continue;
+        }
+        for (fs::directory_iterator file(it->path(), entryError), fileEnd; file != fileEnd; file.increment(entryError)) {
+            if (entryError) break;
+            std::error_code sizeError;
+            uint64_t size = file->file_size(sizeError);
+            if (!sizeError) {
+                entry.bytes += size;
+            }
+        }
+        totalBytes += entry.bytes;
+        entries.push_back(std::move(entry));
+    }
+
+    if (totalBytes <= options_.maxBytes) {
+        totalBytes_ = totalBytes;
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+    for (const auto& entry : entries) {
+        if (totalBytes <= options_.maxBytes) {
+            break;
+        }
+        std::error_code removeError;
+        fs::remove_all(entry.path, removeError);
+        if (!removeError) {
+            totalBytes -= entry.bytes;
+            evictions_++;
+            logger_.Debug("Cache evicted " + entry.path.filename().string());
+        }
+    }
+    totalBytes_ = totalBytes;
+}
+
+ConversionCacheStatistics ConversionCache::GetStatistics() const {
+    ConversionCacheStatistics statistics;
+    statistics.hits = hits_.load();
+    statistics.misses = misses_.load();
+    statistics.stores = stores_.load();
+    statistics.evictions = evictions_.load();
+    statistics.bytes = totalBytes_.load();
+    return statistics;
+}
+
+} // namespace X2FBX
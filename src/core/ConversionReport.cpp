@@ -0,0 +1,204 @@
+#include "ConversionReport.h"
+#include "JsonUtils.h"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace X2FBX {
+
+namespace {
+
+// Standard output's buffer once ReserveStdout has taken it from std::cout
+std::streambuf* reservedStdout = nullptr;
+
+#ifdef _WIN32
+double FileTimeMilliseconds(const FILETIME& kernel, const FILETIME& user) {
+    auto ticks = [](const FILETIME& time) {
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    return (ticks(kernel) + ticks(user)) / 10000.0;   // 100 ns units
+}
+#else
+double ClockMilliseconds(clockid_t clock) {
+    struct timespec now;
+    if (clock_gettime(clock, &now) != 0) {
+        return 0.0;
+    }
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+}
+#endif
+
+void WriteCost(std::ostream& json, const char* name, const StageCost& cost) {
+    json << ", \"" << name << "\": {\"wallMs\": " << cost.wallMs << ", \"cpuMs\": " << cost.cpuMs << "}";
+}
+
+} // namespace
+
+namespace CpuTime {
+
+double GetThreadMilliseconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    return FileTimeMilliseconds(kernel, user);
+#else
+    return ClockMilliseconds(CLOCK_THREAD_CPUTIME_ID);
+#endif
+}
+
+double GetProcessMilliseconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    return FileTimeMilliseconds(kernel, user);
+#else
+    return ClockMilliseconds(CLOCK_PROCESS_CPUTIME_ID);
+#endif
+}
+
+} // namespace CpuTime
+
+StageClock::StageClock(Scope scope)
+    : scope_(scope), wallStart_(std::chrono::steady_clock::now()), cpuStartMs_(CpuNow()) {
+}
+
+StageCost StageClock::Lap() {
+    auto wallNow = std::chrono::steady_clock::now();
+    double cpuNow = CpuNow();
+
+    StageCost cost;
+    cost.wallMs = std::chrono::duration<double, std::milli>(wallNow - wallStart_).count();
+    cost.cpuMs = cpuNow - cpuStartMs_;
+    wallStart_ = wallNow;
+    cpuStartMs_ = cpuNow;
+    return cost;
+}
+
+double StageClock::CpuNow() const {
+    return scope_ == Scope::PROCESS ? CpuTime::GetProcessMilliseconds() : CpuTime::GetThreadMilliseconds();
+}
+
+StageRecorder::StageRecorder(ConversionRecord& record, StageClock::Scope scope, StageCost* first)
+    : record_(record), clock_(scope), stage_(first) {
+    record_.cpuScope = scope;
+}
+
+StageRecorder::~StageRecorder() {
+    if (stage_) {
+        Enter(nullptr);
+    }
+}
+
+void StageRecorder::Enter(StageCost* stage) {
+    StageCost lap = clock_.Lap();
+    record_.total.Add(lap);
+    if (stage_) {
+        stage_->Add(lap);
+    }
+    stage_ = stage;
+}
+
+void ConversionRecord::SetInput(const XFileHeader& header, bool snapshot, const XParseStatistics& statistics) {
+    if (snapshot) {
+        format = "snapshot";
+    } else {
+        switch (header.format) {
+            case XFileHeader::TEXT: format = "text"; break;
+            case XFileHeader::BINARY: format = "binary"; break;
+            case XFileHeader::COMPRESSED: format = "compressed"; break;
+        }
+    }
+    decompressionMethod = statistics.decompressionMethod;
+    decompressionAttempts = statistics.decompressionAttempts;
+    arenaPeakBytes = statistics.arenaPeakBytes;
+}
+
+void ConversionRecord::SetCounts(const XFileData& fileData) {
+    const XMeshData& meshData = fileData.meshData;
+    vertices = meshData.GetVertexCount();
+    faces = meshData.GetFaceCount();
+    materials = meshData.materials.size();
+    bones = meshData.GetBoneCount();
+    for (const auto& mesh : fileData.meshes) {
+        vertices += mesh.GetVertexCount();
+        faces += mesh.GetFaceCount();
+        materials += mesh.materials.size();
+        bones += mesh.GetBoneCount();
+    }
+    animations = meshData.GetAnimationCount();
+    keys = 0;
+    for (const auto& animation : meshData.animations) {
+        keys += animation.GetKeyCount();
+    }
+}
+
+std::string ConversionRecord::ToJson() const {
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\"type\": \"file\""
+         << ", \"input\": \"" << EscapeJson(input) << "\""
+         << ", \"success\": " << (success ? "true" : "false")
+         << ", \"error\": \"" << EscapeJson(error) << "\""
+         << ", \"inputBytes\": " << inputBytes
+         << ", \"format\": \"" << format << "\""
+         << ", \"decompressionMethod\": \"" << decompressionMethod << "\""
+         << ", \"decompressionAttempts\": " << decompressionAttempts
+         << ", \"cacheHit\": " << (cacheHit ? "true" : "false")
+         << ", \"parseSkipped\": " << (parseSkipped ? "true" : "false")
+         << ", \"cpuScope\": \"" << (cpuScope == StageClock::Scope::PROCESS ? "process" : "thread") << "\"";
+    WriteCost(json, "parse", parse);
+    WriteCost(json, "correct", correct);
+    WriteCost(json, "export", exported);
+    WriteCost(json, "total", total);
+    json << ", \"peakRssBytes\": " << peakRssBytes
+         << ", \"arenaPeakBytes\": " << arenaPeakBytes
+         << ", \"vertices\": " << vertices
+         << ", \"faces\": " << faces
+         << ", \"materials\": " << materials
+         << ", \"bones\": " << bones
+         << ", \"animations\": " << animations
+         << ", \"keys\": " << keys
+         << ", \"outputs\": " << outputs << "}";
+    return json.str();
+}
+
+ConversionReportWriter::ConversionReportWriter(const std::string& path) : stdout_(nullptr), out_(nullptr) {
+    if (path == "-") {
+        stdout_.rdbuf(reservedStdout ? reservedStdout : std::cout.rdbuf());
+        out_ = &stdout_;
+        return;
+    }
+    file_.open(path, std::ios::out | std::ios::trunc);
+    if (file_.is_open()) {
+        out_ = &file_;
+    }
+}
+
+void ConversionReportWriter::ReserveStdout() {
+    if (!reservedStdout) {
+        std::cout.flush();
+        reservedStdout = std::cout.rdbuf(std::cerr.rdbuf());
+    }
+}
+
+void ConversionReportWriter::WriteLine(const std::string& json) {
+    if (!out_) {
+        return;
+    }
+    // One record per line; concurrent writers never interleave
+    std::lock_guard<std::mutex> lock(mutex_);
+    *out_ << json << '\n';
+    out_->flush();
+}
+
+} // namespace X2FBX
@@ -0,0 +1,615 @@
+#include "ConversionServer.h"
+#include "ConversionMetrics.h"
+#include "JsonUtils.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace X2FBX {
+
+namespace {
+
+// JSON number grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+// (strtod also takes hex, inf and nan, which are not JSON)
+bool IsJsonNumber(const std::string& text) {
+    size_t pos = 0;
+    auto digits = [&]() {
+        size_t start = pos;
+        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+            pos++;
+        }
+        return pos > start;
+    };
+    if (pos < text.size() && text[pos] == '-') {
+        pos++;
+    }
+    if (pos < text.size() && text[pos] == '0') {
+        pos++;
+    } else if (!digits()) {
+        return false;
+    }
+    if (pos < text.size() && text[pos] == '.') {
+        pos++;
+        if (!digits()) {
+            return false;
+        }
+    }
+    if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+        pos++;
+        if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+            pos++;
+        }
+        if (!digits()) {
+            return false;
+        }
+    }
+    return pos == text.size();
+}
+
+// A request value: strings keep their unescaped text, numbers and
+// literals their source text, arrays their string items
+struct RequestValue {
+    enum class Kind { STRING, NUMBER, LITERAL, ARRAY } kind = Kind::LITERAL;
+    std::string text;
+    std::vector<std::string> items;
+};
+
+// Reader for the flat JSON objects a request consists of. Nested objects
+// are rejected; arrays may only hold strings.
+class RequestReader {
+public:
+    explicit RequestReader(const std::string& text) : text_(text), pos_(0) {}
+
+    bool ReadObject(std::map<std::string, RequestValue>& fields, std::string& error) {
+        if (!Expect('{')) {
+            error = "Request is not a JSON object";
+            return false;
+        }
+        SkipSpace();
+        if (Peek() == '}') {
+            pos_++;
+            return AtEnd(error);
+        }
+        while (true) {
+            std::string key;
+            RequestValue value;
+            if (!ReadString(key) || !Expect(':') || !ReadValue(value)) {
+                error = "Malformed request near offset " + std::to_string(pos_);
+                return false;
+            }
+            fields[key] = std::move(value);
+            SkipSpace();
+            char next = Peek();
+            pos_++;
+            if (next == '}') {
+                return AtEnd(error);
+            }
+            if (next != ',') {
+                error = "Malformed request near offset " + std::to_string(pos_ - 1);
+                return false;
+            }
+        }
+    }
+
+private:
+    const std::string& text_;
+    size_t pos_;
+
+    char Peek() const { return pos_ < text_.size() ? text_[pos_] : '\0'; }
+
+    void SkipSpace() {
+        while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' ||
+                                       text_[pos_] == '\r' || text_[pos_] == '\n')) {
+            pos_++;
+        }
+    }
+
+    bool Expect(char c) {
+        SkipSpace();
+        if (Peek() != c) {
+            return false;
+        }
+        pos_++;
+        return true;
+    }
+
+    bool AtEnd(std::string& error) {
+        SkipSpace();
+        if (pos_ != text_.size()) {
+            error = "Unexpected text after the request object";
+            return false;
+        }
+        return true;
+    }
+
+    bool ReadString(std::string& out) {
+        if (!Expect('"')) {
+            return false;
+        }
+        out.clear();
+        while (pos_ < text_.size()) {
+            char c = text_[pos_++];
+            if (c == '"') {
+                return true;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                return false;
+            }
+            char escaped = text_[pos_++];
+            switch (escaped) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    // Paths are expected to be UTF-8 already; only escaped ASCII is decoded
+                    if (pos_ + 4 > text_.size() ||
+                        !std::all_of(text_.begin() + pos_, text_.begin() + pos_ + 4,
+                                     [](char digit) { return std::isxdigit(static_cast<unsigned char>(digit)) != 0; })) {
+                        return false;
+                    }
+                    unsigned long code = std::strtoul(text_.substr(pos_, 4).c_str(), nullptr, 16);
+                    if (code > 0x7F) {
+                        return false;
+                    }
+                    out += static_cast<char>(code);
+                    pos_ += 4;
+                    break;
+                }
+                default: out += escaped; break;
+            }
+        }
+        return false;
+    }
+
+    bool ReadValue(RequestValue& value) {
+        SkipSpace();
+        char c = Peek();
+        if (c == '"') {
+            value.kind = RequestValue::Kind::STRING;
+            return ReadString(value.text);
+        }
+        if (c == '[') {
+            value.kind = RequestValue::Kind::ARRAY;
+            pos_++;
+            SkipSpace();
+            if (Peek() == ']') {
+                pos_++;
+                return true;
+            }
+            while (true) {
+                std::string item;
+                if (!ReadString(item)) {
+                    return false;
+                }
+                value.items.push_back(std::move(item));
+                SkipSpace();
+                char next = Peek();
+                pos_++;
+                if (next == ']') {
+                    return true;
+                }
+                if (next != ',') {
+                    return false;
+                }
+            }
+        }
+        size_t start = pos_;
+        while (pos_ < text_.size() && (std::isalnum(static_cast<unsigned char>(text_[pos_])) ||
+                                       text_[pos_] == '-' || text_[pos_] == '+' || text_[pos_] == '.')) {
+            pos_++;
+        }
+        value.text = text_.substr(start, pos_ - start);
+        if (value.text == "true" || value.text == "false" || value.text == "null") {
+            value.kind = RequestValue::Kind::LITERAL;
+            return true;
+        }
+        value.kind = RequestValue::Kind::NUMBER;
+        return IsJsonNumber(value.text);
+    }
+};
+
+// Apply the fields of a convert request on top of the server defaults
+bool ApplyRequest(const std::map<std::string, RequestValue>& fields, BatchOptions& options,
+                  std::string& inputPath, std::string& error) {
+    for (const auto& field : fields) {
+        const std::string& key = field.first;
+        const RequestValue& value = field.second;
+        bool isString = value.kind == RequestValue::Kind::STRING;
+        bool isBool = value.kind == RequestValue::Kind::LITERAL && value.text != "null";
+        bool flag = value.text == "true";
+
+        if (key == "id" || key == "command") {
+            continue;
+        } else if (key == "input" && isString) {
+            inputPath = value.text;
+        } else if (key == "output" && isString) {
+            options.outputDirectory = value.text;
+        } else if (key == "optimize" && isBool) {
+            options.optimizeMesh = flag;
+        } else if (key == "batchMaterials" && isBool) {
+            options.batchMaterials = flag;
+        } else if (key == "quantize" && isBool) {
+            options.quantize = flag;
+        } else if (key == "strict" && isBool) {
+            options.strictMode = flag;
+        } else if (key == "validateTiming" && isBool) {
+            options.validateTiming = flag;
+        } else if (key == "reduceKeys" && isBool) {
+            options.reduceKeyframes = flag;
+        } else if (key == "compressArrays" && isBool) {
+            options.compressArrays = flag;
+        } else if (key == "resolveTextures" && isBool) {
+            options.resolveTextures = flag;
+        } else if (key == "embedTextures" && isBool) {
+            options.embedTextures = flag;
+        } else if (key == "embedClipTextures" && isBool) {
+            options.embedTexturesInClips = flag;
+        } else if (key == "compressionLevel" && value.kind == RequestValue::Kind::NUMBER) {
+            int level = std::atoi(value.text.c_str());
+            if (level < -1 || level > 9) {
+                error = "compressionLevel must be between -1 (zlib default) and 9";
+                return false;
+            }
+            options.compressionLevel = level;
+        } else if (key == "resample" && value.kind == RequestValue::Kind::NUMBER) {
+            // Frames per second; 0 turns resampling off
+            double frameRate = std::atof(value.text.c_str());
+            if (frameRate < 0.0 || frameRate > 1000.0) {
+                error = "resample must be a frame rate between 0 and 1000";
+                return false;
+            }
+            options.resampleAnimations = frameRate > 0.0;
+            if (options.resampleAnimations) {
+                options.resampling.frameRate = static_cast<float>(frameRate);
+            }
+        } else if (key == "backend" && isString) {
+            if (value.text == "auto") {
+                options.fbxBackend = FBXExportOptions::Backend::AUTO;
+            } else if (value.text == "sdk") {
+                options.fbxBackend = FBXExportOptions::Backend::FBX_SDK;
+            } else if (value.text == "native") {
+                options.fbxBackend = FBXExportOptions::Backend::NATIVE;
+            } else {
+                error = "Unknown backend: " + value.text;
+                return false;
+            }
+        } else if (key == "validation" && isString) {
+            if (value.text == "none") {
+                options.validation = FBXExportOptions::Validation::NONE;
+            } else if (value.text == "cheap") {
+                options.validation = FBXExportOptions::Validation::CHEAP;
+            } else if (value.text == "full") {
+                options.validation = FBXExportOptions::Validation::FULL;
+            } else {
+                error = "Unknown validation: " + value.text;
+                return false;
+            }
+        } else if (key == "animations" && value.kind == RequestValue::Kind::ARRAY) {
+            options.animationNames = value.items;
+        } else {
+            error = "Unknown or mistyped request field: " + key;
+            return false;
+        }
+    }
+    if (inputPath.empty()) {
+        error = "Request has no input path";
+        return false;
+    }
+    return true;
+}
+
+std::string FormatExport(const FBXExportResult& result) {
+    std::ostringstream json;
+    json << "{\"success\": " << (result.success ? "true" : "false")
+         << ", \"outputPath\": \"" << EscapeJson(result.outputPath) << "\""
+         << ", \"errorMessage\": \"" << EscapeJson(result.errorMessage) << "\""
+         << ", \"verticesExported\": " << result.verticesExported
+         << ", \"facesExported\": " << result.facesExported
+         << ", \"materialsExported\": " << result.materialsExported
+         << ", \"bonesExported\": " << result.bonesExported
+         << ", \"animationsExported\": " << result.animationsExported
+         << ", \"exportTimeMs\": " << result.exportTimeMs
+         << ", \"peakRssBytes\": " << result.peakRssBytes << "}";
+    return json.str();
+}
+
+// Response of a request that never reached a conversion
+std::string FormatFailure(const std::string& id, const std::string& error) {
+    return "{\"id\": " + id + ", \"success\": false, \"error\": \"" + EscapeJson(error) + "\"}";
+}
+
+} // namespace
+
+ConversionServer::ConversionServer(const ConversionServerOptions& options)
+    : logger_(Logger::GetInstance())
+    , options_(options)
+    , cache_(options.defaults.cache)
+    , textures_(options.defaults.textures)
+    , running_(false)
+    , requestsHandled_(0)
+    , listenFd_(-1) {
+}
+
+ConversionServer::~ConversionServer() {
+    Stop();
+    CloseSocket();
+}
+
+bool ConversionServer::IsSupported() {
+#ifdef _WIN32
+    return false;
+#else
+    return true;
+#endif
+}
+
+bool ConversionServer::Start() {
+#ifdef _WIN32
+    error_ = "Server mode needs Unix-domain sockets, which this build does not support";
+    return false;
+#else
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (options_.socketPath.empty() || options_.socketPath.size() >= sizeof(address.sun_path)) {
+        error_ = "Socket path is empty or longer than " + std::to_string(sizeof(address.sun_path) - 1) + " bytes";
+        return false;
+    }
+    std::memcpy(address.sun_path, options_.socketPath.c_str(), options_.socketPath.size());
+
+    // A socket file left by a server that did not shut down cleanly
+    struct stat status;
+    if (stat(options_.socketPath.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) {
+        unlink(options_.socketPath.c_str());
+    }
+
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        error_ = std::string("Cannot create socket: ") + std::strerror(errno);
+        return false;
+    }
+    if (bind(listenFd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenFd_, SOMAXCONN) != 0) {
+        error_ = "Cannot listen on " + options_.socketPath + ": " + std::strerror(errno);
+        close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    logger_.Info("Conversion server listening on " + options_.socketPath);
+    return true;
+#endif
+}
+
+void ConversionServer::Serve() {
+#ifndef _WIN32
+    if (!running_) {
+        return;
+    }
+    size_t workerCount = options_.workers > 0 ? options_.workers : ParallelUtils::GetDefaultThreadCount();
+    logger_.Info("Conversion server running " + std::to_string(workerCount) + " workers");
+
+    int listenFd = listenFd_;
+    auto acceptLoop = [this, listenFd]() {
+        // Constructed on its own thread, like the batch workers, and kept
+        // for every connection this thread serves
+        BatchWorker worker;
+        while (running_) {
+            int clientFd = accept(listenFd, nullptr, nullptr);
+            if (clientFd < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;   // Stop shut the listening socket down
+            }
+            ServeConnection(clientFd, worker);
+            close(clientFd);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workerCount; i++) {
+        threads.emplace_back(acceptLoop);
+    }
+    acceptLoop();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // No accept loop holds the descriptor any more, so it cannot be reused under one
+    CloseSocket();
+    logger_.Info("Conversion server stopped after " + std::to_string(requestsHandled_.load()) + " requests");
+#endif
+}
+
+void ConversionServer::Stop() {
+#ifndef _WIN32
+    if (!running_.exchange(false)) {
+        return;
+    }
+    // Wakes every thread blocked in accept; Serve closes the socket once
+    // they have all returned
+    {
+        std::lock_guard<std::mutex> lock(socketMutex_);
+        if (listenFd_ >= 0) {
+            shutdown(listenFd_, SHUT_RDWR);
+        }
+    }
+    unlink(options_.socketPath.c_str());
+#endif
+}
+
+void ConversionServer::CloseSocket() {
+#ifndef _WIN32
+    std::lock_guard<std::mutex> lock(socketMutex_);
+    if (listenFd_ >= 0) {
+        close(listenFd_);
+        listenFd_ = -1;
+    }
+#endif
+}
+
+void ConversionServer::ServeConnection(int clientFd, BatchWorker& worker) {
+#ifdef _WIN32
+    (void)clientFd;
+    (void)worker;
+#else
+    auto sendLine = [clientFd](const std::string& line) {
+        std::string response = line + "\n";
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t written = send(clientFd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;   // Client went away
+            }
+            sent += static_cast<size_t>(written);
+        }
+        return true;
+    };
+    const std::string tooLong = FormatFailure("null", "Request longer than " +
+                                              std::to_string(MAX_REQUEST_BYTES) + " bytes");
+
+    std::string pending;
+    char buffer[4096];
+    while (true) {
+        ssize_t received = recv(clientFd, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return;
+        }
+        pending.append(buffer, static_cast<size_t>(received));
+
+        size_t lineEnd;
+        while ((lineEnd = pending.find('\n')) != std::string::npos) {
+            if (lineEnd > MAX_REQUEST_BYTES) {
+                sendLine(tooLong);
+                return;
+            }
+            std::string line = pending.substr(0, lineEnd);
+            pending.erase(0, lineEnd + 1);
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+
+            if (!sendLine(HandleRequest(line, worker))) {
+                return;
+            }
+            if (!running_) {
+                return;
+            }
+        }
+        // A client that never ends its line cannot hold on to unbounded memory
+        if (pending.size() > MAX_REQUEST_BYTES) {
+            sendLine(tooLong);
+            return;
+        }
+    }
+#endif
+}
+
+std::string ConversionServer::HandleRequest(const std::string& requestLine, BatchWorker& worker) {
+    requestsHandled_++;
+
+    std::map<std::string, RequestValue> fields;
+    std::string error;
+    if (!RequestReader(requestLine).ReadObject(fields, error)) {
+        return FormatFailure("null", error);
+    }
+
+    // Echoed back so clients can match out-of-order responses; numbers keep
+    // their (validated) source text
+    std::string id = "null";
+    auto idField = fields.find("id");
+    if (idField != fields.end()) {
+        const RequestValue& idValue = idField->second;
+        if (idValue.kind == RequestValue::Kind::STRING) {
+            id = "\"" + EscapeJson(idValue.text) + "\"";
+        } else if (idValue.kind == RequestValue::Kind::NUMBER) {
+            id = idValue.text;
+        } else if (idValue.kind != RequestValue::Kind::LITERAL || idValue.text != "null") {
+            return FormatFailure("null", "id must be a string or a number");
+        }
+    }
+
+    std::string command = "convert";
+    auto commandField = fields.find("command");
+    if (commandField != fields.end()) {
+        command = commandField->second.text;
+    }
+    if (command == "ping") {
+        FBXExporterPoolStatistics pool = FBXExporterPool::GetInstance().GetStatistics();
+        return "{\"id\": " + id + ", \"success\": true, \"requests\": " + std::to_string(requestsHandled_.load()) +
+               ", \"cacheHits\": " + std::to_string(cache_.GetStatistics().hits) +
+               ", \"exporterPool\": {\"hits\": " + std::to_string(pool.hits) +
+               ", \"misses\": " + std::to_string(pool.misses) +
+               ", \"sceneResets\": " + std::to_string(pool.sceneResets) +
+               ", \"idle\": " + std::to_string(pool.idle) + "}}";
+    }
+    if (command == "metrics") {
+        return "{\"id\": " + id + ", \"success\": true, \"metrics\": \"" +
+               EscapeJson(ConversionMetrics::GetInstance().FormatPrometheus()) + "\"}";
+    }
+    if (command == "shutdown") {
+        logger_.Info("Conversion server shutdown requested");
+        Stop();
+        return "{\"id\": " + id + ", \"success\": true}";
+    }
+    if (command != "convert") {
+        return FormatFailure(id, "Unknown command: " + command);
+    }
+
+    BatchOptions options = options_.defaults;
+    std::string inputPath;
+    if (!ApplyRequest(fields, options, inputPath, error)) {
+        return FormatFailure(id, error);
+    }
+
+    BatchFileResult result = worker.Convert(inputPath, options.outputDirectory, options, cache_, &textures_);
+    if (!result.success) {
+        logger_.Error("Server: " + inputPath + ": " + result.errorMessage);
+    }
+
+    std::ostringstream json;
+    json << "{\"id\": " << id
+         << ", \"success\": " << (result.success ? "true" : "false")
+         << ", \"input\": \"" << EscapeJson(inputPath) << "\""
+         << ", \"error\": \"" << EscapeJson(result.errorMessage) << "\""
+         << ", \"cacheHit\": " << (result.cacheHit ? "true" : "false")
+         << ", \"parseSkipped\": " << (result.parseSkipped ? "true" : "false")
+         << ", \"clipsRestored\": " << result.clipsRestored
+         << ", \"elapsedMs\": " << result.elapsedMs
+         << ", \"exports\": [";
+    for (size_t i = 0; i < result.exports.size(); i++) {
+        json << (i > 0 ? ", " : "") << FormatExport(result.exports[i]);
+    }
+    json << "], \"report\": " << result.report.ToJson() << "}";
+    return json.str();
+}
+
+} // namespace X2FBX
@@ -0,0 +1,303 @@
+#include "ConversionStages.h"
+#include "AnimationResampler.h"
+#include "BatchPipeline.h"
+#include "KeyframeReducer.h"
+#include "MeshOptimizer.h"
+#include "XFileSnapshot.h"
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace X2FBX {
+
+namespace {
+
+// Seeds chain the fields, so equal bytes in different fields never collide
+template <typename T>
+uint64_t HashArray(const std::vector<T>& values, uint64_t seed) {
+    return ConversionCache::HashBytes(reinterpret_cast<const uint8_t*>(values.data()), values.size() * sizeof(T), seed);
+}
+
+uint64_t HashString(const std::string& text, uint64_t seed) {
+    return ConversionCache::HashBytes(reinterpret_cast<const uint8_t*>(text.data()), text.size(), seed);
+}
+
+template <typename T>
+uint64_t HashValue(const T& value, uint64_t seed) {
+    return ConversionCache::HashBytes(reinterpret_cast<const uint8_t*>(&value), sizeof(T), seed);
+}
+
+uint64_t HashChannel(const XAnimationChannel& channel, uint64_t seed) {
+    return HashArray(channel.values, HashArray(channel.times, seed));
+}
+
+std::string StageFingerprint(const char* stage) {
+    std::ostringstream fingerprint;
+    fingerprint << "x2fbx-stage v" << ConversionCache::FORMAT_VERSION << ";snapshot=" << Snapshot::VERSION
+                << ";stage=" << stage;
+    return fingerprint.str();
+}
+
+std::string ExportKey(uint64_t meshHash, const XAnimationSet* animation, const FBXExportOptions& options) {
+    uint64_t contentHash = animation ? ConversionStages::HashAnimation(*animation) ^ (meshHash * 0x9E3779B185EBCA87ull)
+                                     : meshHash;
+    return ConversionCache::MakeKey(contentHash, StageFingerprint(animation ? "clip" : "static") + ";" +
+                                                 ConversionCache::ExportFingerprint(options));
+}
+
+// Cache an exported file; one still queued on a write or validation
+// stage is cached once it is on disk and has passed its check
+void StoreExport(ConversionCache& cache, const std::string& key, const std::string& baseName,
+                 const std::string& outputPath, const FBXExportOptions& options) {
+    CachedConversion produced;
+    produced.outputPaths.push_back(outputPath);
+    RunAfterOutputs(produced.outputPaths, [&cache, key, baseName, produced]() { cache.Store(key, baseName, produced); },
+                    options.outputWriter, options.validator);
+}
+
+} // namespace
+
+ConversionStages::ConversionStages(ConversionCache& cache)
+    : cache_(cache) {
+}
+
+StageKeys ConversionStages::ComputeKeys(const std::string& inputPath, bool strictMode,
+                                        const std::vector<std::string>& animationFilter,
+                                        const MeshOptimizationOptions* meshOptimization,
+                                        const KeyframeReductionOptions* keyReduction,
+                                        const AnimationResampleOptions* resampling, bool quantize) const {
+    MappedFile input;
+    if (!IsEnabled() || !input.Open(inputPath)) {
+        return StageKeys();
+    }
+    return ComputeKeys(input.View(), strictMode, animationFilter, meshOptimization, keyReduction, resampling, quantize);
+}
+
+StageKeys ConversionStages::ComputeKeys(ByteView input, bool strictMode,
+                                        const std::vector<std::string>& animationFilter,
+                                        const MeshOptimizationOptions* meshOptimization,
+                                        const KeyframeReductionOptions* keyReduction,
+                                        const AnimationResampleOptions* resampling, bool quantize) const {
+    StageKeys keys;
+    if (!IsEnabled()) {
+        return keys;
+    }
+
+    std::ostringstream parse;
+    parse << StageFingerprint("parse") << ";strict=" << strictMode << ";select=" << animationFilter.size();
+    for (const auto& name : animationFilter) {
+        parse << "," << name.size() << ":" << name;
+    }
+    keys.parse = cache_.ComputeKey(input, parse.str());
+    if (keys.parse.empty()) {
+        return keys;
+    }
+
+    // Timing correction has no options; validation only logs
+    std::ostringstream prepare;
+    prepare << std::setprecision(9) << StageFingerprint("prepare");
+    if (meshOptimization) {
+        prepare << ";optimize=" << meshOptimization->weldVertices << meshOptimization->removeDegenerateTriangles
+                << meshOptimization->reorderForVertexCache << "," << meshOptimization->cacheSize << ","
+                << meshOptimization->batchMaterials;
+    } else {
+        prepare << ";optimize=off";
+    }
+    if (keyReduction) {
+        prepare << ";reduce=" << keyReduction->positionTolerance << "," << keyReduction->rotationTolerance
+                << "," << keyReduction->scaleTolerance;
+    } else {
+        prepare << ";reduce=off";
+    }
+    if (resampling) {
+        prepare << ";resample=" << resampling->frameRate;
+    } else {
+        prepare << ";resample=off";
+    }
+    prepare << ";quantize=" << quantize;
+    keys.prepare = ConversionCache::DeriveKey(keys.parse, prepare.str());
+    return keys;
+}
+
+bool ConversionStages::LoadData(const std::string& key, XFileData& fileData,
+                                std::vector<TimingReportLine>* timingReport) {
+    TIME_OPERATION("ConversionStages::LoadData");
+    CachedConversion entry;
+    if (!cache_.Lookup(key, entry) || entry.outputPaths.size() != 1) {
+        return false;
+    }
+
+    XFileData loaded;
+    if (!XFileSnapshot::Read(entry.outputPaths[0], loaded)) {
+        return false;
+    }
+    fileData = std::move(loaded);
+    if (timingReport) {
+        *timingReport = std::move(entry.timingReport);
+    }
+    return true;
+}
+
+bool ConversionStages::StoreData(const std::string& key, const XFileData& fileData,
+                                 const std::vector<TimingReportLine>& timingReport, bool quantize) {
+    TIME_OPERATION("ConversionStages::StoreData");
+    std::string snapshotPath = cache_.TemporaryPath(key, XFileSnapshot::FILE_EXTENSION);
+    if (snapshotPath.empty() || !XFileSnapshot::Write(fileData, snapshotPath, quantize)) {
+        return false;
+    }
+
+    CachedConversion entry;
+    entry.outputPaths.push_back(snapshotPath);
+    entry.timingReport = timingReport;
+    bool stored = cache_.Store(key, "", entry, true);
+
+    std::error_code ec;
+    fs::remove(snapshotPath, ec);
+    return stored;
+}
+
+std::vector<FBXExportResult> ConversionStages::ExportAnimations(FBXExporter& exporter, XMeshData& meshData,
+                                                                const std::string& outputDirectory,
+                                                                const std::string& baseName,
+                                                                const FBXExportOptions& options,
+                                                                size_t& restoredClips) {
+    TIME_OPERATION("ConversionStages::ExportAnimations");
+    restoredClips = 0;
+    if (!IsEnabled()) {
+        return exporter.ExportAllAnimations(meshData, outputDirectory, baseName, options);
+    }
+
+    const size_t clipCount = meshData.animations.size();
+    const uint64_t meshHash = HashMesh(meshData);
+    std::vector<FBXExportResult> results(clipCount);
+    std::vector<std::string> keys(clipCount);
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < clipCount; i++) {
+        keys[i] = ExportKey(meshHash, &meshData.animations[i], options);
+        CachedConversion cached;
+        if (cache_.Restore(keys[i], outputDirectory, baseName, cached) && cached.outputPaths.size() == 1) {
+            results[i].success = true;
+            results[i].outputPath = cached.outputPaths[0];
+            restoredClips++;
+        } else {
+            pending.push_back(i);
+        }
+    }
+    if (pending.empty()) {
+        return results;
+    }
+
+    // Only the clips that missed go to the exporter; sets move out and back,
+    // so the mesh is never copied
+    std::vector<XAnimationSet> animations = std::move(meshData.animations);
+    meshData.animations.clear();
+    for (size_t index : pending) {
+        meshData.animations.push_back(std::move(animations[index]));
+    }
+    auto putBack = [&]() {
+        for (size_t i = 0; i < pending.size(); i++) {
+            animations[pending[i]] = std::move(meshData.animations[i]);
+        }
+        meshData.animations = std::move(animations);
+    };
+    std::vector<FBXExportResult> exported;
+    try {
+        exported = exporter.ExportAllAnimations(meshData, outputDirectory, baseName, options);
+    } catch (...) {
+        putBack();
+        throw;
+    }
+    putBack();
+
+    for (size_t i = 0; i < pending.size(); i++) {
+        size_t index = pending[i];
+        results[index] = std::move(exported[i]);
+        if (results[index].success) {
+            StoreExport(cache_, keys[index], baseName, results[index].outputPath, options);
+        }
+    }
+    return results;
+}
+
+FBXExportResult ConversionStages::ExportStaticMesh(FBXExporter& exporter, XMeshData&& meshData,
+                                                   const std::string& outputDirectory, const std::string& baseName,
+                                                   const FBXExportOptions& options, bool& restored) {
+    TIME_OPERATION("ConversionStages::ExportStaticMesh");
+    restored = false;
+    std::string outputPath = (fs::path(outputDirectory) / (baseName + ".fbx")).string();
+    if (!IsEnabled()) {
+        return exporter.ExportStaticMesh(std::move(meshData), outputPath, options);
+    }
+
+    std::string key = ExportKey(HashMesh(meshData), nullptr, options);
+    CachedConversion cached;
+    if (cache_.Restore(key, outputDirectory, baseName, cached) && cached.outputPaths.size() == 1) {
+        FBXExportResult result;
+        result.success = true;
+        result.outputPath = cached.outputPaths[0];
+        restored = true;
+        return result;
+    }
+
+    FBXExportResult result = exporter.ExportStaticMesh(std::move(meshData), outputPath, options);
+    if (result.success) {
+        StoreExport(cache_, key, baseName, outputPath, options);
+    }
+    return result;
+}
+
+uint64_t ConversionStages::HashMesh(const XMeshData& meshData) {
+    TIME_OPERATION("ConversionStages::HashMesh");
+    uint64_t hash = HashString(meshData.name, 0);
+    hash = HashArray(meshData.positions, hash);
+    hash = HashArray(meshData.normals, hash);
+    hash = HashArray(meshData.texCoords, hash);
+    hash = HashArray(meshData.skinInfluences, hash);
+    hash = HashArray(meshData.indices, hash);
+    hash = HashArray(meshData.faceMaterials, hash);
+    timer.AddBytes(meshData.positions.size() * sizeof(XVector3) + meshData.indices.size() * sizeof(int));
+
+    hash = HashValue(meshData.materials.size(), hash);
+    for (const auto& material : meshData.materials) {
+        hash = HashString(material.name, hash);
+        hash = HashValue(material.diffuseColor, hash);
+        hash = HashValue(material.specularColor, hash);
+        hash = HashValue(material.emissiveColor, hash);
+        hash = HashValue(material.shininess, hash);
+        hash = HashValue(material.transparency, hash);
+        hash = HashString(material.diffuseTexture, hash);
+        hash = HashString(material.normalTexture, hash);
+        hash = HashString(material.specularTexture, hash);
+    }
+
+    hash = HashValue(meshData.bones.size(), hash);
+    for (size_t i = 0; i < meshData.bones.size(); i++) {
+        const XBone& bone = meshData.bones[i];
+        hash = HashString(meshData.GetBoneName(i), hash);
+        hash = HashValue(bone.parentIndex, hash);
+        hash = HashValue(bone.bindPose, hash);
+        hash = HashValue(bone.offsetMatrix, hash);
+        hash = HashArray(bone.childIndices, hash);
+    }
+
+    hash = HashValue(meshData.globalTicksPerSecond, hash);
+    return HashValue(meshData.hasTimingInfo, hash);
+}
+
+uint64_t ConversionStages::HashAnimation(const XAnimationSet& animation) {
+    uint64_t hash = HashString(animation.name, 0);
+    hash = HashValue(animation.duration, hash);
+    hash = HashValue(animation.ticksPerSecond, hash);
+    hash = HashValue(animation.tracks.size(), hash);
+    for (const auto& track : animation.tracks) {
+        hash = HashValue(track.boneId, hash);
+        hash = HashChannel(track.rotation, hash);
+        hash = HashChannel(track.translation, hash);
+        hash = HashChannel(track.scale, hash);
+    }
+    return hash;
+}
+
+} // namespace X2FBX
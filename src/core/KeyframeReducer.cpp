@@ -0,0 +1,218 @@
+#include "KeyframeReducer.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace X2FBX {
+
+namespace {
+
+// Longest run of keys one segment may replace. Bounds the cost of
+// re-checking a segment each time it grows.
+constexpr size_t MAX_SEGMENT_KEYS = 256;
+
+constexpr float RADIANS_TO_DEGREES = 180.0f / 3.14159265358979f;
+
+float Distance(const float* a, const float* b) {
+    float dx = a[0] - b[0];
+    float dy = a[1] - b[1];
+    float dz = a[2] - b[2];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+XQuaternion LoadRotation(const float* value) {
+    XQuaternion q(value[0], value[1], value[2], value[3]);
+    float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    if (length <= 0.0f) {
+        return XQuaternion();
+    }
+    return XQuaternion(q.x / length, q.y / length, q.z / length, q.w / length);
+}
+
+float Dot(const XQuaternion& a, const XQuaternion& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+// Shortest-path slerp of unit quaternions
+XQuaternion Slerp(const XQuaternion& a, XQuaternion b, float t) {
+    float cosTheta = Dot(a, b);
+    if (cosTheta < 0.0f) {
+        b = XQuaternion(-b.x, -b.y, -b.z, -b.w);
+        cosTheta = -cosTheta;
+    }
+
+    float wa = 1.0f - t;
+    float wb = t;
+    if (cosTheta < 0.9995f) {
+        float theta = std::acos(cosTheta);
+        float sinTheta = std::sin(theta);
+        wa = std::sin((1.0f - t) * theta) / sinTheta;
+        wb = std::sin(t * theta) / sinTheta;
+    }
+    const float blended[4] = {a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb, a.w * wa + b.w * wb};
+    return LoadRotation(blended);
+}
+
+// Rotation between two unit quaternions; q and -q are the same rotation
+float AngleDegrees(const XQuaternion& a, const XQuaternion& b) {
+    float cosHalf = std::min(1.0f, std::fabs(Dot(a, b)));
+    return 2.0f * std::acos(cosHalf) * RADIANS_TO_DEGREES;
+}
+
+// How far two key values are apart: degrees for rotations, model units
+// for translation and scale
+float Difference(const float* a, const float* b, size_t components) {
+    if (components == XBoneTrack::ROTATION_COMPONENTS) {
+        return AngleDegrees(LoadRotation(a), LoadRotation(b));
+    }
+    return Distance(a, b);
+}
+
+// Error of reproducing key by interpolating from..to at t
+float InterpolationError(const float* from, const float* to, const float* key, float t, size_t components) {
+    if (components == XBoneTrack::ROTATION_COMPONENTS) {
+        return AngleDegrees(Slerp(LoadRotation(from), LoadRotation(to), t), LoadRotation(key));
+    }
+    const float lerped[3] = {
+        from[0] + (to[0] - from[0]) * t, from[1] + (to[1] - from[1]) * t, from[2] + (to[2] - from[2]) * t
+    };
+    return Distance(lerped, key);
+}
+
+} // namespace
+
+KeyframeReducer::KeyframeReducer(const KeyframeReductionOptions& options)
+    : logger_(Logger::GetInstance())
+    , options_(options) {
+}
+
+KeyframeReductionResult KeyframeReducer::ReduceAnimation(XAnimationSet& animation) const {
+    std::vector<XBoneTrack*> tracks;
+    tracks.reserve(animation.tracks.size());
+    for (auto& track : animation.tracks) {
+        tracks.push_back(&track);
+    }
+    return ReduceTracks(tracks);
+}
+
+KeyframeReductionResult KeyframeReducer::ReduceAllAnimations(std::vector<XAnimationSet>& animations) const {
+    // One pool over the tracks of every animation balances better than a
+    // pool per animation
+    std::vector<XBoneTrack*> tracks;
+    for (auto& animation : animations) {
+        for (auto& track : animation.tracks) {
+            tracks.push_back(&track);
+        }
+    }
+    return ReduceTracks(tracks);
+}
+
+KeyframeReductionResult KeyframeReducer::ReduceTracks(const std::vector<XBoneTrack*>& tracks) const {
+    std::vector<KeyframeReductionResult> trackResults(tracks.size());
+    size_t threads = ParallelUtils::ResolveThreadCount(options_.threads, tracks.size());
+
+    ParallelUtils::ParallelFor(tracks.size(), threads, [&](size_t index, size_t) {
+        trackResults[index] = ReduceTrack(*tracks[index]);
+    });
+
+    KeyframeReductionResult result;
+    for (const auto& trackResult : trackResults) {
+        result.Add(trackResult);
+    }
+    return result;
+}
+
+KeyframeReductionResult KeyframeReducer::ReduceTrack(XBoneTrack& track) const {
+    KeyframeReductionResult result;
+    result.tracks = 1;
+
+    struct ChannelTolerance {
+        XAnimationChannel* channel;
+        size_t components;
+        float tolerance;
+    };
+    const ChannelTolerance channels[3] = {
+        {&track.rotation, XBoneTrack::ROTATION_COMPONENTS, options_.rotationTolerance},
+        {&track.translation, XBoneTrack::VECTOR_COMPONENTS, options_.positionTolerance},
+        {&track.scale, XBoneTrack::VECTOR_COMPONENTS, options_.scaleTolerance},
+    };
+    for (const auto& entry : channels) {
+        if (entry.channel->IsEmpty()) {
+            continue;
+        }
+        const size_t original = entry.channel->GetKeyCount();
+        ReduceChannel(*entry.channel, entry.components, entry.tolerance);
+
+        result.channels++;
+        result.originalKeys += original;
+        result.remainingKeys += entry.channel->GetKeyCount();
+        if (original > 1 && entry.channel->GetKeyCount() == 1) {
+            result.constantChannels++;
+        }
+    }
+    return result;
+}
+
+size_t KeyframeReducer::ReduceChannel(XAnimationChannel& channel, size_t components, float tolerance) const {
+    const size_t original = channel.GetKeyCount();
+    if (original < 2) {
+        return 0;
+    }
+
+    // A channel that never changes needs a single key
+    const float* first = channel.GetValue(0, components);
+    bool constant = true;
+    for (size_t i = 1; i < original && constant; ++i) {
+        constant = Difference(first, channel.GetValue(i, components), components) <= tolerance;
+    }
+    if (constant) {
+        channel.times.resize(1);
+        channel.values.resize(components);
+        channel.times.shrink_to_fit();
+        channel.values.shrink_to_fit();
+        return original - 1;
+    }
+
+    // Grow a segment from the last kept key while every key inside it can
+    // be interpolated; the key before the first failure is kept. Kept keys
+    // are compacted to the front in place.
+    size_t anchor = 0;
+    size_t kept = 1;
+    auto keep = [&](size_t key) {
+        channel.times[kept] = channel.times[key];
+        std::copy_n(channel.GetValue(key, components), components, &channel.values[kept * components]);
+        kept++;
+    };
+    for (size_t end = 2; end < original; ++end) {
+        const float span = channel.times[end] - channel.times[anchor];
+        bool fits = span > 0.0f && end - anchor <= MAX_SEGMENT_KEYS;
+        for (size_t i = anchor + 1; i < end && fits; ++i) {
+            float t = (channel.times[i] - channel.times[anchor]) / span;
+            fits = InterpolationError(channel.GetValue(anchor, components), channel.GetValue(end, components),
+                                      channel.GetValue(i, components), t, components) <= tolerance;
+        }
+        if (!fits) {
+            anchor = end - 1;
+            keep(anchor);
+        }
+    }
+    keep(original - 1);
+
+    channel.times.resize(kept);
+    channel.values.resize(kept * components);
+    channel.times.shrink_to_fit();
+    channel.values.shrink_to_fit();
+    return original - kept;
+}
+
+void KeyframeReducer::GenerateReductionReport(const KeyframeReductionResult& result) const {
+    double percent = result.originalKeys > 0 ? 100.0 * result.RemovedKeys() / result.originalKeys : 0.0;
+    logger_.Info("KEYFRAME_REDUCTION: " + std::to_string(result.tracks) + " tracks, " +
+                 std::to_string(result.channels) + " channels (" +
+                 std::to_string(result.constantChannels) + " constant), " +
+                 std::to_string(result.RemovedKeys()) + "/" + std::to_string(result.originalKeys) +
+                 " keys removed (" + std::to_string(percent) + "%), ~" +
+                 std::to_string(result.BytesSaved() / 1024) + " KB of key data saved");
+}
+
+} // namespace X2FBX
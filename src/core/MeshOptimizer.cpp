@@ -0,0 +1,615 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace X2FBX {
+
+namespace {
+
+// Forsyth's scoring constants
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+// Valence boosts are tabulated up to here; busier vertices share the last entry
+constexpr size_t MAX_SCORED_VALENCE = 64;
+
+// Words of the largest weld key: position, normal, uv, bone indices, weights
+constexpr size_t MAX_KEY_WORDS = 3 + 3 + 2 + 2 * XVertexInfluences::MAX_INFLUENCES;
+
+// Bits of a float with -0 folded into +0, so both weld together
+uint32_t FloatBits(float value) {
+    if (value == 0.0f) {
+        return 0;
+    }
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Every vertex stream the mesh carries, flattened to words
+size_t BuildWeldKey(const XMeshData& meshData, size_t vertex, uint32_t* key) {
+    size_t count = 0;
+    const XVector3& position = meshData.positions[vertex];
+    key[count++] = FloatBits(position.x);
+    key[count++] = FloatBits(position.y);
+    key[count++] = FloatBits(position.z);
+    if (meshData.HasNormals()) {
+        const XVector3& normal = meshData.normals[vertex];
+        key[count++] = FloatBits(normal.x);
+        key[count++] = FloatBits(normal.y);
+        key[count++] = FloatBits(normal.z);
+    }
+    if (meshData.HasTexCoords()) {
+        const XVector2& uv = meshData.texCoords[vertex];
+        key[count++] = FloatBits(uv.u);
+        key[count++] = FloatBits(uv.v);
+    }
+    if (meshData.HasSkinWeights()) {
+        const XVertexInfluences& influences = meshData.skinInfluences[vertex];
+        for (int i = 0; i < XVertexInfluences::MAX_INFLUENCES; i++) {
+            key[count++] = static_cast<uint32_t>(influences.boneIndices[i]);
+            key[count++] = FloatBits(influences.boneWeights[i]);
+        }
+    }
+    return count;
+}
+
+uint64_t HashWords(const uint32_t* words, size_t count) {
+    uint64_t hash = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < count; i++) {
+        hash ^= words[i];
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+void AppendFloat(std::string& key, float value) {
+    uint32_t bits = FloatBits(value);
+    key.append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+}
+
+void AppendString(std::string& key, const std::string& value) {
+    uint32_t size = static_cast<uint32_t>(value.size());
+    key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    key += value;
+}
+
+// Every field of a material, so only bit-identical ones share a key
+std::string BuildMaterialKey(const XMaterial& material) {
+    std::string key;
+    AppendString(key, material.name);
+    for (const XVector3* color : {&material.diffuseColor, &material.specularColor, &material.emissiveColor}) {
+        AppendFloat(key, color->x);
+        AppendFloat(key, color->y);
+        AppendFloat(key, color->z);
+    }
+    AppendFloat(key, material.shininess);
+    AppendFloat(key, material.transparency);
+    AppendString(key, material.diffuseTexture);
+    AppendString(key, material.normalTexture);
+    AppendString(key, material.specularTexture);
+    return key;
+}
+
+// Meshes MergeMeshes may combine: nothing moves them apart at runtime
+bool IsStaticMesh(const XMeshData& meshData) {
+    return meshData.bones.empty() && !meshData.HasSkinWeights() && meshData.animations.empty();
+}
+
+template <typename T>
+void AppendStream(std::vector<T>& stream, const std::vector<T>& other) {
+    stream.insert(stream.end(), other.begin(), other.end());
+}
+
+template <typename T>
+void RemapStream(std::vector<T>& stream, const std::vector<int>& remap, size_t newCount) {
+    if (stream.empty()) {
+        return;
+    }
+    // Backwards, so the first of several vertices sharing a slot wins
+    std::vector<T> remapped(newCount);
+    for (size_t vertex = remap.size(); vertex-- > 0;) {
+        if (remap[vertex] >= 0) {
+            remapped[remap[vertex]] = stream[vertex];
+        }
+    }
+    stream.swap(remapped);
+}
+
+// Move every vertex stream to its new slot (-1 = dropped; welded vertices
+// share one) and rewrite the index buffer to match
+void RemapVertices(XMeshData& meshData, const std::vector<int>& remap, size_t newCount) {
+    RemapStream(meshData.positions, remap, newCount);
+    RemapStream(meshData.normals, remap, newCount);
+    RemapStream(meshData.texCoords, remap, newCount);
+    RemapStream(meshData.skinInfluences, remap, newCount);
+    for (int& index : meshData.indices) {
+        index = remap[index];
+    }
+}
+
+bool SamePosition(const XVector3& a, const XVector3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+bool IsDegenerate(const XMeshData& meshData, const int* triangle) {
+    if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) {
+        return true;
+    }
+    const XVector3& a = meshData.positions[triangle[0]];
+    const XVector3& b = meshData.positions[triangle[1]];
+    const XVector3& c = meshData.positions[triangle[2]];
+    if (SamePosition(a, b) || SamePosition(b, c) || SamePosition(a, c)) {
+        return true;
+    }
+
+    // Collinear corners; doubles keep thin but valid slivers
+    double e1x = double(b.x) - a.x, e1y = double(b.y) - a.y, e1z = double(b.z) - a.z;
+    double e2x = double(c.x) - a.x, e2y = double(c.y) - a.y, e2z = double(c.z) - a.z;
+    double cx = e1y * e2z - e1z * e2y;
+    double cy = e1z * e2x - e1x * e2z;
+    double cz = e1x * e2y - e1y * e2x;
+    return cx * cx + cy * cy + cz * cz == 0.0;
+}
+
+// Per-vertex score of Forsyth's algorithm: recently used vertices and
+// vertices with few remaining triangles score high
+class VertexScorer {
+private:
+    std::vector<float> cacheScores_;
+    std::vector<float> valenceScores_;
+
+public:
+    explicit VertexScorer(size_t cacheSize)
+        : cacheScores_(cacheSize)
+        , valenceScores_(MAX_SCORED_VALENCE + 1, 0.0f) {
+        for (size_t position = 0; position < cacheSize; position++) {
+            if (position < 3) {
+                // The last triangle's corners score alike, so the result
+                // does not depend on their winding order
+                cacheScores_[position] = LAST_TRIANGLE_SCORE;
+            } else {
+                float scaler = 1.0f - float(position - 3) / float(cacheSize - 3);
+                cacheScores_[position] = std::pow(scaler, CACHE_DECAY_POWER);
+            }
+        }
+        for (size_t valence = 1; valence <= MAX_SCORED_VALENCE; valence++) {
+            valenceScores_[valence] = VALENCE_BOOST_SCALE * std::pow(float(valence), -VALENCE_BOOST_POWER);
+        }
+    }
+
+    float Score(int cachePosition, uint32_t liveTriangles) const {
+        if (liveTriangles == 0) {
+            return -1.0f;
+        }
+        float score = cachePosition >= 0 ? cacheScores_[cachePosition] : 0.0f;
+        return score + valenceScores_[std::min<size_t>(liveTriangles, MAX_SCORED_VALENCE)];
+    }
+};
+
+// Triangle order for a post-transform cache of cacheSize entries. Only
+// triangles touching the simulated cache are rescored after each pick;
+// when none is left the next unused triangle in input order starts over.
+// With groups (one per triangle) a pick stays in the last pick's group, so
+// triangles grouped in the input stay grouped.
+std::vector<uint32_t> OrderTriangles(const std::vector<int>& indices, size_t vertexCount, size_t cacheSize,
+                                     const int* groups = nullptr) {
+    const size_t triangleCount = indices.size() / 3;
+
+    // Triangles of each vertex; each vertex's live ones are kept at the front
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (int index : indices) {
+        offsets[index + 1]++;
+    }
+    for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+        offsets[vertex + 1] += offsets[vertex];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (size_t i = 0; i < indices.size(); i++) {
+        int vertex = indices[i];
+        adjacency[offsets[vertex] + liveTriangles[vertex]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    VertexScorer scorer(cacheSize);
+    std::vector<int> cachePositions(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+        vertexScores[vertex] = scorer.Score(-1, liveTriangles[vertex]);
+    }
+
+    std::vector<char> emitted(triangleCount, 0);
+    std::vector<uint32_t> order;
+    order.reserve(triangleCount);
+    std::vector<int> cache;
+    std::vector<int> nextCache;
+    cache.reserve(cacheSize + 3);
+    nextCache.reserve(cacheSize + 3);
+
+    size_t best = triangleCount;
+    size_t scanCursor = 0;
+    while (order.size() < triangleCount) {
+        if (best == triangleCount) {
+            while (emitted[scanCursor]) {
+                scanCursor++;
+            }
+            best = scanCursor;
+        }
+
+        order.push_back(static_cast<uint32_t>(best));
+        emitted[best] = 1;
+        const int* triangle = &indices[best * 3];
+
+        // Retire the triangle from its vertices and put them at the cache front
+        nextCache.clear();
+        for (int corner = 0; corner < 3; corner++) {
+            int vertex = triangle[corner];
+            if (std::find(nextCache.begin(), nextCache.end(), vertex) != nextCache.end()) {
+                continue;
+            }
+            uint32_t* live = &adjacency[offsets[vertex]];
+            uint32_t* last = live + liveTriangles[vertex] - 1;
+            std::iter_swap(std::find(live, last, static_cast<uint32_t>(best)), last);
+            liveTriangles[vertex]--;
+            nextCache.push_back(vertex);
+        }
+        for (int vertex : cache) {
+            if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2]) {
+                nextCache.push_back(vertex);
+            }
+        }
+
+        for (size_t position = 0; position < nextCache.size(); position++) {
+            int vertex = nextCache[position];
+            cachePositions[vertex] = position < cacheSize ? static_cast<int>(position) : -1;
+            vertexScores[vertex] = scorer.Score(cachePositions[vertex], liveTriangles[vertex]);
+        }
+        if (nextCache.size() > cacheSize) {
+            nextCache.resize(cacheSize);
+        }
+        cache.swap(nextCache);
+
+        // The best next triangle shares a vertex with the cache
+        const int group = groups ? groups[best] : 0;
+        best = triangleCount;
+        float bestScore = -1.0f;
+        for (int vertex : cache) {
+            const uint32_t* live = &adjacency[offsets[vertex]];
+            for (uint32_t i = 0; i < liveTriangles[vertex]; i++) {
+                if (groups && groups[live[i]] != group) {
+                    continue;
+                }
+                const int* candidate = &indices[size_t(live[i]) * 3];
+                float score = vertexScores[candidate[0]] + vertexScores[candidate[1]] + vertexScores[candidate[2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = live[i];
+                }
+            }
+        }
+    }
+    return order;
+}
+
+} // namespace
+
+MeshOptimizer::MeshOptimizer(const MeshOptimizationOptions& options)
+    : logger_(Logger::GetInstance())
+    , options_(options) {
+    // The reorder scores the three newest entries apart from the rest
+    options_.cacheSize = std::max<size_t>(options_.cacheSize, 4);
+}
+
+bool MeshOptimizer::CanOptimize(const XMeshData& meshData) const {
+    const size_t vertexCount = meshData.GetVertexCount();
+    if (vertexCount >= static_cast<size_t>(std::numeric_limits<int>::max()) ||
+        meshData.indices.size() != meshData.GetFaceCount() * 3 ||
+        (meshData.HasNormals() && meshData.normals.size() != vertexCount) ||
+        (meshData.HasTexCoords() && meshData.texCoords.size() != vertexCount) ||
+        (meshData.HasSkinWeights() && meshData.skinInfluences.size() != vertexCount)) {
+        return false;
+    }
+    for (int index : meshData.indices) {
+        if (index < 0 || static_cast<size_t>(index) >= vertexCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+MeshOptimizationResult MeshOptimizer::Optimize(XMeshData& meshData) const {
+    TIME_OPERATION("MeshOptimizer::Optimize");
+    MeshOptimizationResult result;
+    result.originalVertices = meshData.GetVertexCount();
+    result.remainingVertices = result.originalVertices;
+    result.originalTriangles = meshData.GetFaceCount();
+    result.remainingTriangles = result.originalTriangles;
+    result.originalMaterials = meshData.materials.size();
+    result.remainingMaterials = result.originalMaterials;
+
+    if (!CanOptimize(meshData)) {
+        logger_.Warning("Mesh '" + meshData.name + "' has inconsistent streams or indices; skipping optimization");
+        return result;
+    }
+    result.acmrBefore = ComputeACMR(meshData.indices, meshData.GetVertexCount(), options_.cacheSize);
+
+    if (options_.weldVertices) {
+        result.weldedVertices = WeldVertices(meshData);
+    }
+    if (options_.removeDegenerateTriangles) {
+        result.degenerateTriangles = RemoveDegenerateTriangles(meshData);
+    }
+    if (options_.batchMaterials) {
+        DeduplicateMaterials(meshData);
+        result.submeshes = GroupFacesByMaterial(meshData);
+    }
+    if (options_.reorderForVertexCache) {
+        ReorderForVertexCache(meshData);
+    } else if (result.degenerateTriangles > 0) {
+        // Removed triangles can leave vertices nothing references
+        CompactVertices(meshData);
+    }
+
+    result.applied = true;
+    result.remainingVertices = meshData.GetVertexCount();
+    result.remainingTriangles = meshData.GetFaceCount();
+    result.remainingMaterials = meshData.materials.size();
+    result.acmrAfter = ComputeACMR(meshData.indices, meshData.GetVertexCount(), options_.cacheSize);
+    timer.AddBytes(result.originalVertices * sizeof(XVector3) + result.originalTriangles * 3 * sizeof(int));
+    return result;
+}
+
+size_t MeshOptimizer::WeldVertices(XMeshData& meshData) const {
+    const size_t vertexCount = meshData.GetVertexCount();
+    if (vertexCount == 0) {
+        return 0;
+    }
+
+    // Open addressing over vertex numbers, at most half full
+    size_t capacity = 1;
+    while (capacity < vertexCount * 2) {
+        capacity <<= 1;
+    }
+    const size_t mask = capacity - 1;
+    std::vector<int> table(capacity, -1);
+    std::vector<int> remap(vertexCount);
+    int slots = 0;
+
+    uint32_t key[MAX_KEY_WORDS];
+    uint32_t other[MAX_KEY_WORDS];
+    for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+        size_t words = BuildWeldKey(meshData, vertex, key);
+        size_t slot = HashWords(key, words) & mask;
+        while (true) {
+            int candidate = table[slot];
+            if (candidate < 0) {
+                table[slot] = static_cast<int>(vertex);
+                remap[vertex] = slots++;
+                break;
+            }
+            BuildWeldKey(meshData, candidate, other);
+            if (std::memcmp(key, other, words * sizeof(uint32_t)) == 0) {
+                remap[vertex] = remap[candidate];
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    size_t welded = vertexCount - static_cast<size_t>(slots);
+    if (welded > 0) {
+        RemapVertices(meshData, remap, static_cast<size_t>(slots));
+    }
+    return welded;
+}
+
+size_t MeshOptimizer::RemoveDegenerateTriangles(XMeshData& meshData) const {
+    size_t kept = 0;
+    const size_t triangleCount = meshData.GetFaceCount();
+    for (size_t face = 0; face < triangleCount; face++) {
+        const int* triangle = &meshData.indices[face * 3];
+        if (IsDegenerate(meshData, triangle)) {
+            continue;
+        }
+        if (kept != face) {
+            std::copy_n(triangle, 3, &meshData.indices[kept * 3]);
+            meshData.faceMaterials[kept] = meshData.faceMaterials[face];
+        }
+        kept++;
+    }
+    meshData.indices.resize(kept * 3);
+    meshData.faceMaterials.resize(kept);
+    return triangleCount - kept;
+}
+
+void MeshOptimizer::ReorderForVertexCache(XMeshData& meshData) const {
+    // Grouped faces keep their material runs
+    std::vector<uint32_t> order = OrderTriangles(meshData.indices, meshData.GetVertexCount(), options_.cacheSize,
+                                                 options_.batchMaterials ? meshData.faceMaterials.data() : nullptr);
+
+    std::vector<int> indices(meshData.indices.size());
+    std::vector<int> faceMaterials(meshData.faceMaterials.size());
+    for (size_t face = 0; face < order.size(); face++) {
+        std::copy_n(&meshData.indices[size_t(order[face]) * 3], 3, &indices[face * 3]);
+        faceMaterials[face] = meshData.faceMaterials[order[face]];
+    }
+    meshData.indices.swap(indices);
+    meshData.faceMaterials.swap(faceMaterials);
+
+    // Vertex fetches then walk the streams forwards
+    CompactVertices(meshData);
+}
+
+void MeshOptimizer::CompactVertices(XMeshData& meshData) const {
+    std::vector<int> remap(meshData.GetVertexCount(), -1);
+    int next = 0;
+    for (int index : meshData.indices) {
+        if (remap[index] < 0) {
+            remap[index] = next++;
+        }
+    }
+    RemapVertices(meshData, remap, static_cast<size_t>(next));
+}
+
+size_t MeshOptimizer::DeduplicateMaterials(XMeshData& meshData) const {
+    std::unordered_map<std::string, int> firstByKey;
+    std::vector<int> remap(meshData.materials.size());
+    std::vector<XMaterial> kept;
+    for (size_t material = 0; material < meshData.materials.size(); material++) {
+        auto inserted = firstByKey.emplace(BuildMaterialKey(meshData.materials[material]), static_cast<int>(kept.size()));
+        if (inserted.second) {
+            kept.push_back(std::move(meshData.materials[material]));
+        }
+        remap[material] = inserted.first->second;
+    }
+
+    size_t merged = meshData.materials.size() - kept.size();
+    if (merged > 0) {
+        // Faces without a material, or with one the mesh lacks, keep their index
+        for (int& material : meshData.faceMaterials) {
+            if (material >= 0 && static_cast<size_t>(material) < remap.size()) {
+                material = remap[material];
+            }
+        }
+    }
+    meshData.materials.swap(kept);
+    return merged;
+}
+
+size_t MeshOptimizer::GroupFacesByMaterial(XMeshData& meshData) const {
+    const size_t triangleCount = meshData.GetFaceCount();
+    std::vector<uint32_t> order(triangleCount);
+    for (size_t face = 0; face < triangleCount; face++) {
+        order[face] = static_cast<uint32_t>(face);
+    }
+    std::stable_sort(order.begin(), order.end(), [&meshData](uint32_t a, uint32_t b) {
+        return meshData.faceMaterials[a] < meshData.faceMaterials[b];
+    });
+
+    std::vector<int> indices(meshData.indices.size());
+    std::vector<int> faceMaterials(triangleCount);
+    size_t runs = 0;
+    for (size_t face = 0; face < triangleCount; face++) {
+        std::copy_n(&meshData.indices[size_t(order[face]) * 3], 3, &indices[face * 3]);
+        faceMaterials[face] = meshData.faceMaterials[order[face]];
+        if (face == 0 || faceMaterials[face] != faceMaterials[face - 1]) {
+            runs++;
+        }
+    }
+    meshData.indices.swap(indices);
+    meshData.faceMaterials.swap(faceMaterials);
+    return runs;
+}
+
+MeshMergeResult MeshOptimizer::MergeMeshes(std::vector<XMeshData>& meshes) const {
+    TIME_OPERATION("MeshOptimizer::MergeMeshes");
+    MeshMergeResult result;
+    result.originalMeshes = meshes.size();
+    for (const auto& meshData : meshes) {
+        result.originalMaterials += meshData.materials.size();
+    }
+
+    // Meshes merged into each kept one carry the same streams
+    std::vector<XMeshData> merged;
+    std::vector<int> streams;   // Of merged[i]; -1 = kept as it was
+    for (auto& meshData : meshes) {
+        int layout = -1;
+        if (IsStaticMesh(meshData) && CanOptimize(meshData)) {
+            layout = (meshData.HasNormals() ? 1 : 0) | (meshData.HasTexCoords() ? 2 : 0);
+        }
+        // The newest mesh of the layout; an older one may be full
+        auto newest = std::find(streams.rbegin(), streams.rend(), layout);
+        const size_t target = streams.rend() - newest - 1;
+        if (layout < 0 || newest == streams.rend() ||
+            merged[target].GetVertexCount() + meshData.GetVertexCount() >=
+                static_cast<size_t>(std::numeric_limits<int>::max())) {
+            if (layout >= 0) {
+                // Materials merged in later must not be named by this mesh's faces
+                const int materialCount = static_cast<int>(meshData.materials.size());
+                for (int& material : meshData.faceMaterials) {
+                    material = material < materialCount ? material : -1;
+                }
+            }
+            streams.push_back(layout);
+            merged.push_back(std::move(meshData));
+            continue;
+        }
+
+        XMeshData& into = merged[target];
+        const int vertexOffset = static_cast<int>(into.GetVertexCount());
+        const int materialOffset = static_cast<int>(into.materials.size());
+        AppendStream(into.positions, meshData.positions);
+        AppendStream(into.normals, meshData.normals);
+        AppendStream(into.texCoords, meshData.texCoords);
+        into.indices.reserve(into.indices.size() + meshData.indices.size());
+        for (int index : meshData.indices) {
+            into.indices.push_back(index + vertexOffset);
+        }
+        into.faceMaterials.reserve(into.faceMaterials.size() + meshData.faceMaterials.size());
+        const int materialCount = static_cast<int>(meshData.materials.size());
+        for (int material : meshData.faceMaterials) {
+            // A material the mesh lacks would name one of the other mesh's
+            into.faceMaterials.push_back(material >= 0 && material < materialCount ? material + materialOffset : -1);
+        }
+        AppendStream(into.materials, meshData.materials);
+        timer.AddBytes(meshData.GetVertexCount() * sizeof(XVector3) + meshData.indices.size() * sizeof(int));
+    }
+
+    for (size_t i = 0; i < merged.size(); i++) {
+        if (streams[i] >= 0) {
+            DeduplicateMaterials(merged[i]);
+            if (options_.batchMaterials) {
+                GroupFacesByMaterial(merged[i]);
+            }
+        }
+        result.remainingMaterials += merged[i].materials.size();
+    }
+    meshes.swap(merged);
+    result.remainingMeshes = meshes.size();
+    return result;
+}
+
+double MeshOptimizer::ComputeACMR(const std::vector<int>& indices, size_t vertexCount, size_t cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || cacheSize == 0) {
+        return 0.0;
+    }
+
+    // A vertex is cached while fewer than cacheSize loads followed its own
+    const int64_t size = static_cast<int64_t>(cacheSize);
+    std::vector<int64_t> loadedAt(vertexCount, -(size + 1));
+    int64_t loads = 0;
+    for (int index : indices) {
+        if (index < 0 || static_cast<size_t>(index) >= vertexCount) {
+            continue;
+        }
+        if (loads - loadedAt[index] > size) {
+            loadedAt[index] = loads++;
+        }
+    }
+    return static_cast<double>(loads) / triangleCount;
+}
+
+void MeshOptimizer::GenerateOptimizationReport(const MeshOptimizationResult& result) const {
+    logger_.Info("MESH_OPTIMIZATION: " + std::to_string(result.remainingVertices) + "/" +
+                 std::to_string(result.originalVertices) + " vertices (" +
+                 std::to_string(result.weldedVertices) + " welded), " +
+                 std::to_string(result.remainingTriangles) + "/" + std::to_string(result.originalTriangles) +
+                 " triangles (" + std::to_string(result.degenerateTriangles) + " degenerate), ACMR " +
+                 std::to_string(result.acmrBefore) + " -> " + std::to_string(result.acmrAfter));
+    if (options_.batchMaterials) {
+        logger_.Info("MESH_OPTIMIZATION: " + std::to_string(result.remainingMaterials) + "/" +
+                     std::to_string(result.originalMaterials) + " materials, " + std::to_string(result.submeshes) +
+                     " submeshes");
+    }
+}
+
+} // namespace X2FBX
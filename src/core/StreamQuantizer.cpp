@@ -0,0 +1,386 @@
+#include "StreamQuantizer.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace X2FBX {
+
+namespace Quantization {
+
+namespace {
+
+constexpr double ROTATION_RANGE = 0.70710678118654752;   // Largest magnitude of a dropped-from component
+constexpr uint64_t ROTATION_MASK = (1ull << ROTATION_BITS) - 1;
+constexpr double ROTATION_TIE = 1e-5;     // Components this close count as tied
+constexpr int SETTLE_PASSES = 4;          // Bounds and rotation codes
+
+double SignNotZero(double value) {
+    return value < 0.0 ? -1.0 : 1.0;
+}
+
+float Extent(float min, float max) {
+    return static_cast<float>(double(max) - double(min));
+}
+
+// Bounds of each component of count interleaved values. The extent is settled so
+// that the decoded top code yields the same extent again: data decoded
+// with these bounds has them as its own bounds, and re-encodes bit-exactly.
+bool ComputeBounds(const float* values, size_t count, size_t components, Bounds& bounds) {
+    for (size_t c = 0; c < components; c++) {
+        float min = 0.0f, max = 0.0f;
+        for (size_t i = 0; i < count; i++) {
+            float value = values[i * components + c];
+            if (!std::isfinite(value)) {
+                return false;
+            }
+            min = i == 0 ? value : std::min(min, value);
+            max = i == 0 ? value : std::max(max, value);
+        }
+        float extent = Extent(min, max);
+        for (int pass = 0; pass < SETTLE_PASSES; pass++) {
+            float settled = Extent(min, DecodeUnorm16(static_cast<uint16_t>(UNORM16_MAX), min, extent));
+            if (settled == extent) {
+                break;
+            }
+            extent = settled;
+        }
+        bounds.min[c] = min;
+        bounds.extent[c] = extent;
+    }
+    return true;
+}
+
+// One encode, without settling
+void EncodeOctahedralOnce(const XVector3& normal, int16_t code[2]) {
+    double sum = std::fabs(double(normal.x)) + std::fabs(double(normal.y)) + std::fabs(double(normal.z));
+    double x = sum > 0.0 ? normal.x / sum : 0.0;
+    double y = sum > 0.0 ? normal.y / sum : 0.0;
+    if (normal.z < 0.0f) {
+        // Fold the lower hemisphere over the diagonals
+        double foldedX = (1.0 - std::fabs(y)) * SignNotZero(x);
+        y = (1.0 - std::fabs(x)) * SignNotZero(y);
+        x = foldedX;
+    }
+    code[0] = static_cast<int16_t>(std::lround(std::min(std::max(x, -1.0), 1.0) * SNORM16_MAX));
+    code[1] = static_cast<int16_t>(std::lround(std::min(std::max(y, -1.0), 1.0) * SNORM16_MAX));
+}
+
+// One encode. Of components tied for largest (within more than the
+// rounding of a decode) the first is dropped, so a decoded quaternion
+// drops the same one again.
+uint64_t EncodeLargestDropped(const float q[4]) {
+    double norm = std::sqrt(double(q[0]) * q[0] + double(q[1]) * q[1] + double(q[2]) * q[2] + double(q[3]) * q[3]);
+    if (!(norm > 0.0) || !std::isfinite(norm)) {
+        static const float identity[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        return EncodeLargestDropped(identity);
+    }
+    float top = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        top = std::max(top, std::fabs(q[i]));
+    }
+    uint64_t largest = 0;
+    while (std::fabs(q[largest]) < top - ROTATION_TIE * norm) {
+        largest++;
+    }
+    // The dropped component is rebuilt as positive
+    double scale = (q[largest] < 0.0f ? -1.0 : 1.0) / norm;
+    uint64_t code = largest << (3 * ROTATION_BITS);
+    int shift = 2 * ROTATION_BITS;
+    for (uint64_t i = 0; i < 4; i++) {
+        if (i == largest) {
+            continue;
+        }
+        double unit = (q[i] * scale / ROTATION_RANGE) * 0.5 + 0.5;
+        auto component = static_cast<uint64_t>(std::llround(std::min(std::max(unit, 0.0), 1.0) * ROTATION_MASK));
+        code |= component << shift;
+        shift -= ROTATION_BITS;
+    }
+    return code;
+}
+
+} // namespace
+
+uint16_t EncodeUnorm16(float value, float min, float extent) {
+    if (!(extent > 0.0f)) {
+        return 0;
+    }
+    double scaled = (double(value) - min) / extent * UNORM16_MAX;
+    return static_cast<uint16_t>(std::lround(std::min<double>(std::max(scaled, 0.0), UNORM16_MAX)));
+}
+
+float DecodeUnorm16(uint16_t code, float min, float extent) {
+    return static_cast<float>(double(min) + double(code) * extent / UNORM16_MAX);
+}
+
+void EncodeOctahedral(const XVector3& normal, int16_t code[2]) {
+    // Settled like EncodeSmallestThree; a code on a fold edge can map to
+    // its mirror image
+    EncodeOctahedralOnce(normal, code);
+    for (int pass = 0; pass < SETTLE_PASSES; pass++) {
+        int16_t settled[2];
+        EncodeOctahedralOnce(DecodeOctahedral(code), settled);
+        if (settled[0] == code[0] && settled[1] == code[1]) {
+            break;
+        }
+        code[0] = settled[0];
+        code[1] = settled[1];
+    }
+}
+
+XVector3 DecodeOctahedral(const int16_t code[2]) {
+    double x = std::max(code[0] / double(SNORM16_MAX), -1.0);
+    double y = std::max(code[1] / double(SNORM16_MAX), -1.0);
+    double z = 1.0 - std::fabs(x) - std::fabs(y);
+    if (z < 0.0) {
+        double unfoldedX = (1.0 - std::fabs(y)) * SignNotZero(x);
+        y = (1.0 - std::fabs(x)) * SignNotZero(y);
+        x = unfoldedX;
+    }
+    double length = std::sqrt(x * x + y * y + z * z);
+    return XVector3(float(x / length), float(y / length), float(z / length));
+}
+
+void DecodeSmallestThree(uint64_t code, float q[4]) {
+    const uint64_t largest = (code >> (3 * ROTATION_BITS)) & 3;
+    double values[4];
+    double sum = 0.0;
+    int shift = 2 * ROTATION_BITS;
+    for (uint64_t i = 0; i < 4; i++) {
+        if (i == largest) {
+            continue;
+        }
+        double unit = double((code >> shift) & ROTATION_MASK) / ROTATION_MASK;
+        values[i] = (unit * 2.0 - 1.0) * ROTATION_RANGE;
+        sum += values[i] * values[i];
+        shift -= ROTATION_BITS;
+    }
+    values[largest] = std::sqrt(std::max(0.0, 1.0 - sum));
+    double length = std::sqrt(sum + values[largest] * values[largest]);
+    for (int i = 0; i < 4; i++) {
+        q[i] = static_cast<float>(values[i] / length);
+    }
+}
+
+uint64_t EncodeSmallestThree(const float q[4]) {
+    // Settle on a code that its own decode encodes to again, so a second
+    // round trip is exact even where two components were nearly tied
+    uint64_t code = EncodeLargestDropped(q);
+    for (int pass = 0; pass < SETTLE_PASSES; pass++) {
+        float decoded[4];
+        DecodeSmallestThree(code, decoded);
+        uint64_t settled = EncodeLargestDropped(decoded);
+        if (settled == code) {
+            break;
+        }
+        code = settled;
+    }
+    return code;
+}
+
+QuantizedStreams EncodeStreams(const XMeshData& meshData) {
+    QuantizedStreams streams;
+    const size_t vertexCount = meshData.GetVertexCount();
+    if (vertexCount > 0 && ComputeBounds(&meshData.positions[0].x, vertexCount, 3, streams.positionBounds)) {
+        streams.positions.resize(vertexCount * 3);
+        for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+            const float* position = &meshData.positions[vertex].x;
+            for (size_t c = 0; c < 3; c++) {
+                streams.positions[vertex * 3 + c] = EncodeUnorm16(position[c], streams.positionBounds.min[c],
+                                                                  streams.positionBounds.extent[c]);
+            }
+        }
+    }
+    const size_t uvCount = meshData.texCoords.size();
+    if (uvCount > 0 && ComputeBounds(&meshData.texCoords[0].u, uvCount, 2, streams.texCoordBounds)) {
+        streams.texCoords.resize(uvCount * 2);
+        for (size_t vertex = 0; vertex < uvCount; vertex++) {
+            const float* uv = &meshData.texCoords[vertex].u;
+            for (size_t c = 0; c < 2; c++) {
+                streams.texCoords[vertex * 2 + c] = EncodeUnorm16(uv[c], streams.texCoordBounds.min[c],
+                                                                  streams.texCoordBounds.extent[c]);
+            }
+        }
+    }
+    streams.normals.resize(meshData.normals.size() * 2);
+    for (size_t vertex = 0; vertex < meshData.normals.size(); vertex++) {
+        EncodeOctahedral(meshData.normals[vertex], &streams.normals[vertex * 2]);
+    }
+    return streams;
+}
+
+void DecodeStreams(const QuantizedStreams& streams, XMeshData& meshData) {
+    if (!streams.positions.empty()) {
+        meshData.positions.resize(streams.positions.size() / 3);
+        for (size_t vertex = 0; vertex < meshData.positions.size(); vertex++) {
+            float* position = &meshData.positions[vertex].x;
+            for (size_t c = 0; c < 3; c++) {
+                position[c] = DecodeUnorm16(streams.positions[vertex * 3 + c], streams.positionBounds.min[c],
+                                            streams.positionBounds.extent[c]);
+            }
+        }
+    }
+    if (!streams.texCoords.empty()) {
+        meshData.texCoords.resize(streams.texCoords.size() / 2);
+        for (size_t vertex = 0; vertex < meshData.texCoords.size(); vertex++) {
+            float* uv = &meshData.texCoords[vertex].u;
+            for (size_t c = 0; c < 2; c++) {
+                uv[c] = DecodeUnorm16(streams.texCoords[vertex * 2 + c], streams.texCoordBounds.min[c],
+                                      streams.texCoordBounds.extent[c]);
+            }
+        }
+    }
+    if (!streams.normals.empty()) {
+        meshData.normals.resize(streams.normals.size() / 2);
+        for (size_t vertex = 0; vertex < meshData.normals.size(); vertex++) {
+            meshData.normals[vertex] = DecodeOctahedral(&streams.normals[vertex * 2]);
+        }
+    }
+}
+
+std::vector<uint64_t> EncodeRotations(const XAnimationChannel& rotation) {
+    std::vector<uint64_t> codes(rotation.GetKeyCount());
+    for (size_t key = 0; key < codes.size(); key++) {
+        codes[key] = EncodeSmallestThree(rotation.GetValue(key, XBoneTrack::ROTATION_COMPONENTS));
+    }
+    return codes;
+}
+
+void DecodeRotations(const uint64_t* codes, size_t keyCount, XAnimationChannel& rotation) {
+    rotation.values.resize(keyCount * XBoneTrack::ROTATION_COMPONENTS);
+    for (size_t key = 0; key < keyCount; key++) {
+        DecodeSmallestThree(codes[key], &rotation.values[key * XBoneTrack::ROTATION_COMPONENTS]);
+    }
+}
+
+} // namespace Quantization
+
+namespace {
+
+// Angle between unit vectors of count components, from their chord, which
+// unlike the dot product stays accurate for tiny angles
+double AngleDegrees(const double* a, const float* b, size_t count) {
+    double chord = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        chord += (a[i] - b[i]) * (a[i] - b[i]);
+    }
+    return 2.0 * std::asin(std::min(std::sqrt(chord) * 0.5, 1.0)) * 180.0 / 3.14159265358979323846;
+}
+
+} // namespace
+
+void QuantizationResult::Merge(const QuantizationResult& other) {
+    meshes += other.meshes;
+    vertices += other.vertices;
+    rotationKeys += other.rotationKeys;
+    maxPositionError = std::max(maxPositionError, other.maxPositionError);
+    maxTexCoordError = std::max(maxTexCoordError, other.maxTexCoordError);
+    maxNormalErrorDegrees = std::max(maxNormalErrorDegrees, other.maxNormalErrorDegrees);
+    maxRotationErrorDegrees = std::max(maxRotationErrorDegrees, other.maxRotationErrorDegrees);
+    floatBytes += other.floatBytes;
+    quantizedBytes += other.quantizedBytes;
+}
+
+StreamQuantizer::StreamQuantizer()
+    : logger_(Logger::GetInstance()) {
+}
+
+QuantizationResult StreamQuantizer::Quantize(XFileData& fileData) const {
+    TIME_OPERATION("StreamQuantizer::Quantize");
+    QuantizationResult result = QuantizeMesh(fileData.meshData);
+    for (auto& meshData : fileData.meshes) {
+        result.Merge(QuantizeMesh(meshData));
+    }
+    result.Merge(QuantizeAnimations(fileData.animations));
+    timer.AddBytes(result.floatBytes);
+    return result;
+}
+
+QuantizationResult StreamQuantizer::QuantizeMesh(XMeshData& meshData) const {
+    QuantizationResult result;
+    result.meshes = 1;
+    result.vertices = meshData.GetVertexCount();
+
+    Quantization::QuantizedStreams streams = Quantization::EncodeStreams(meshData);
+    std::vector<XVector3> positions = streams.positions.empty() ? std::vector<XVector3>() : meshData.positions;
+    std::vector<XVector2> texCoords = streams.texCoords.empty() ? std::vector<XVector2>() : meshData.texCoords;
+    std::vector<XVector3> normals = streams.normals.empty() ? std::vector<XVector3>() : meshData.normals;
+    Quantization::DecodeStreams(streams, meshData);
+
+    for (size_t vertex = 0; vertex < positions.size(); vertex++) {
+        const XVector3& before = positions[vertex];
+        const XVector3& after = meshData.positions[vertex];
+        double dx = double(after.x) - before.x, dy = double(after.y) - before.y, dz = double(after.z) - before.z;
+        result.maxPositionError = std::max(result.maxPositionError, std::sqrt(dx * dx + dy * dy + dz * dz));
+    }
+    for (size_t vertex = 0; vertex < texCoords.size(); vertex++) {
+        result.maxTexCoordError = std::max({result.maxTexCoordError,
+                                            std::fabs(double(meshData.texCoords[vertex].u) - texCoords[vertex].u),
+                                            std::fabs(double(meshData.texCoords[vertex].v) - texCoords[vertex].v)});
+    }
+    for (size_t vertex = 0; vertex < normals.size(); vertex++) {
+        const XVector3& before = normals[vertex];
+        double length = std::sqrt(double(before.x) * before.x + double(before.y) * before.y + double(before.z) * before.z);
+        if (length > 0.0) {
+            const double unit[3] = {before.x / length, before.y / length, before.z / length};
+            result.maxNormalErrorDegrees = std::max(result.maxNormalErrorDegrees,
+                                                    AngleDegrees(unit, &meshData.normals[vertex].x, 3));
+        }
+    }
+
+    // Streams left as floats (non-finite values) count at full size
+    result.floatBytes = positions.size() * sizeof(XVector3) + texCoords.size() * sizeof(XVector2) +
+                        normals.size() * sizeof(XVector3);
+    result.quantizedBytes = (streams.positions.size() + streams.texCoords.size()) * sizeof(uint16_t) +
+                            streams.normals.size() * sizeof(int16_t);
+    const uint64_t unquantized = (meshData.positions.size() - positions.size()) * sizeof(XVector3) +
+                                 (meshData.texCoords.size() - texCoords.size()) * sizeof(XVector2);
+    result.floatBytes += unquantized;
+    result.quantizedBytes += unquantized;
+
+    result.Merge(QuantizeAnimations(meshData.animations));
+    return result;
+}
+
+QuantizationResult StreamQuantizer::QuantizeAnimations(std::vector<XAnimationSet>& animations) const {
+    QuantizationResult result;
+    const size_t components = XBoneTrack::ROTATION_COMPONENTS;
+    for (auto& animation : animations) {
+        for (auto& track : animation.tracks) {
+            XAnimationChannel& rotation = track.rotation;
+            std::vector<float> before = rotation.values;
+            std::vector<uint64_t> codes = Quantization::EncodeRotations(rotation);
+            Quantization::DecodeRotations(codes.data(), codes.size(), rotation);
+
+            for (size_t key = 0; key < codes.size(); key++) {
+                const float* a = &before[key * components];
+                const float* b = rotation.GetValue(key, components);
+                double length = std::sqrt(double(a[0]) * a[0] + double(a[1]) * a[1] + double(a[2]) * a[2] +
+                                          double(a[3]) * a[3]);
+                if (length > 0.0) {
+                    // q and -q are one rotation; a rotation turns twice the quaternions' angle
+                    double dot = double(a[0]) * b[0] + double(a[1]) * b[1] + double(a[2]) * b[2] + double(a[3]) * b[3];
+                    double scale = (dot < 0.0 ? -1.0 : 1.0) / length;
+                    const double unit[4] = {a[0] * scale, a[1] * scale, a[2] * scale, a[3] * scale};
+                    result.maxRotationErrorDegrees = std::max(result.maxRotationErrorDegrees,
+                                                              2.0 * AngleDegrees(unit, b, components));
+                }
+            }
+            result.rotationKeys += codes.size();
+            result.floatBytes += codes.size() * components * sizeof(float);
+            result.quantizedBytes += codes.size() * sizeof(uint64_t);
+        }
+    }
+    return result;
+}
+
+void StreamQuantizer::GenerateQuantizationReport(const QuantizationResult& result, const std::string& asset) const {
+    std::ostringstream report;
+    report << "QUANTIZATION: " << asset << ": " << result.vertices << " vertices, " << result.rotationKeys
+           << " rotation keys, " << result.floatBytes << " -> " << result.quantizedBytes
+           << " bytes; max error position " << result.maxPositionError << ", uv " << result.maxTexCoordError
+           << ", normal " << result.maxNormalErrorDegrees << " deg, rotation " << result.maxRotationErrorDegrees
+           << " deg";
+    logger_.Info(report.str());
+}
+
+} // namespace X2FBX
@@ -0,0 +1,262 @@
+#include "TextureLibrary.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace X2FBX {
+
+namespace {
+
+// .x files written on Windows use backslashes
+std::string NormalizeSeparators(std::string path) {
+    std::replace(path.begin(), path.end(), '\\', '/');
+    return path;
+}
+
+std::string AbsolutePath(const fs::path& path) {
+    std::error_code ec;
+    fs::path absolute = fs::absolute(path, ec);
+    return (ec ? path : absolute).lexically_normal().string();
+}
+
+} // namespace
+
+std::shared_ptr<const TextureImage> TextureSet::Get(const std::string& texturePath) const {
+    for (const auto& entry : entries_) {
+        if (entry.first == texturePath) {
+            return entry.second.get();
+        }
+    }
+    return nullptr;
+}
+
+std::string TextureSet::Fingerprint() const {
+    std::ostringstream fingerprint;
+    for (const auto& entry : entries_) {
+        std::shared_ptr<const TextureImage> image = entry.second.get();
+        fingerprint << entry.first.size() << ":" << entry.first << "=";
+        if (image && image->IsResolved()) {
+            fingerprint << image->resolvedPath.size() << ":" << image->resolvedPath << "," << image->fileBytes
+                        << "," << image->modifiedTime << "," << (image->content ? "embedded" : "referenced");
+        } else {
+            fingerprint << "missing";
+        }
+        fingerprint << ";";
+    }
+    return fingerprint.str();
+}
+
+TextureLibrary::TextureLibrary(const TextureLibraryOptions& options)
+    : logger_(Logger::GetInstance())
+    , options_(options)
+    , cachedBytes_(0)
+    , stopping_(false) {
+}
+
+TextureLibrary::~TextureLibrary() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+std::shared_ptr<const TextureSet> TextureLibrary::Request(const XMeshData& meshData, const std::string& inputPath,
+                                                          bool loadContent) {
+    auto textures = std::make_shared<TextureSet>();
+    const std::string inputDirectory = AbsolutePath(fs::path(inputPath).parent_path());
+    for (const auto& material : meshData.materials) {
+        for (const std::string* path : {&material.diffuseTexture, &material.normalTexture, &material.specularTexture}) {
+            if (path->empty() || textures->Get(*path)) {
+                continue;
+            }
+            textures->entries_.emplace_back(*path, Lookup(*path, inputDirectory, loadContent));
+        }
+    }
+    return textures;
+}
+
+TextureLibraryStatistics TextureLibrary::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+std::vector<std::string> TextureLibrary::CandidatePaths(const std::string& texturePath,
+                                                        const std::string& inputDirectory,
+                                                        const std::vector<std::string>& searchDirectories) {
+    std::vector<std::string> candidates;
+    auto add = [&](const fs::path& path) {
+        std::string candidate = path.lexically_normal().string();
+        if (std::find(candidates.begin(), candidates.end(), candidate) == candidates.end()) {
+            candidates.push_back(candidate);
+        }
+    };
+
+    const fs::path path(NormalizeSeparators(texturePath));
+    const fs::path fileName = path.filename();
+    if (fileName.empty()) {
+        return candidates;
+    }
+
+    if (path.is_absolute()) {
+        add(path);
+    } else {
+        add(fs::path(inputDirectory) / path);
+    }
+    add(fs::path(inputDirectory) / fileName);
+    for (const auto& directory : searchDirectories) {
+        if (!path.is_absolute()) {
+            add(fs::path(directory) / path);
+        }
+        add(fs::path(directory) / fileName);
+    }
+    return candidates;
+}
+
+TextureLibrary::ImageFuture TextureLibrary::Lookup(const std::string& texturePath, const std::string& inputDirectory,
+                                                   bool loadContent) {
+    std::string key = inputDirectory;
+    key.push_back('\0');
+    key += texturePath;
+    key.push_back(loadContent ? '1' : '0');
+
+    auto promise = std::make_shared<std::promise<std::shared_ptr<const TextureImage>>>();
+    ImageFuture future;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        statistics_.requests++;
+        auto found = images_.find(key);
+        if (found != images_.end()) {
+            return found->second;
+        }
+        future = promise->get_future().share();
+        images_.emplace(key, future);
+        statistics_.lookups++;
+    }
+
+    Submit([this, promise, key, texturePath, inputDirectory, loadContent]() {
+        std::shared_ptr<const TextureImage> image;
+        try {
+            image = Resolve(key, texturePath, inputDirectory, loadContent);
+        } catch (const std::exception& e) {
+            logger_.Warning("Texture " + texturePath + ": " + e.what());
+        }
+        promise->set_value(image ? image : std::make_shared<TextureImage>());
+    });
+    return future;
+}
+
+std::shared_ptr<const TextureImage> TextureLibrary::Resolve(const std::string& key, const std::string& texturePath,
+                                                            const std::string& inputDirectory, bool loadContent) {
+    auto image = std::make_shared<TextureImage>();
+    for (const auto& candidate : CandidatePaths(texturePath, inputDirectory, options_.searchDirectories)) {
+        std::error_code ec;
+        if (!fs::is_regular_file(candidate, ec)) {
+            continue;
+        }
+        image->resolvedPath = AbsolutePath(candidate);
+        image->fileBytes = fs::file_size(candidate, ec);
+        image->modifiedTime = static_cast<int64_t>(fs::last_write_time(candidate, ec).time_since_epoch().count());
+        break;
+    }
+
+    if (!image->IsResolved()) {
+        logger_.Warning("Texture not found: " + texturePath + " (referenced as written)");
+        std::lock_guard<std::mutex> lock(mutex_);
+        statistics_.missing++;
+        return image;
+    }
+
+    if (loadContent) {
+        if (image->fileBytes > options_.maxEmbedBytes) {
+            logger_.Warning("Texture " + image->resolvedPath + " is larger than the embedding limit; referenced instead");
+        } else {
+            bool cached = true;
+            image->content = LoadContent(image->resolvedPath, image->fileBytes, cached);
+            if (!cached) {
+                // Over the cache budget: later meshes look the file up again
+                std::lock_guard<std::mutex> lock(mutex_);
+                images_.erase(key);
+            }
+        }
+    }
+    return image;
+}
+
+std::shared_ptr<const std::vector<uint8_t>> TextureLibrary::LoadContent(const std::string& resolvedPath,
+                                                                        uint64_t fileBytes, bool& cached) {
+    std::promise<std::shared_ptr<const std::vector<uint8_t>>> promise;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto found = contents_.find(resolvedPath);
+        if (found != contents_.end()) {
+            // Read by another lookup of the same file (maybe still reading)
+            ContentFuture content = found->second;
+            lock.unlock();
+            return content.get();
+        }
+        cached = cachedBytes_ + fileBytes <= options_.maxCachedBytes;
+        if (cached) {
+            contents_.emplace(resolvedPath, promise.get_future().share());
+            cachedBytes_ += fileBytes;
+        }
+    }
+
+    std::shared_ptr<std::vector<uint8_t>> content;
+    std::ifstream file(resolvedPath, std::ios::binary);
+    if (file.is_open()) {
+        content = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(fileBytes));
+        file.read(reinterpret_cast<char*>(content->data()), static_cast<std::streamsize>(content->size()));
+        content->resize(static_cast<size_t>(file.gcount()));
+    }
+    if (!content || content->size() != fileBytes) {
+        logger_.Warning("Failed to read texture " + resolvedPath + "; referenced instead");
+        content.reset();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (content) {
+            statistics_.loads++;
+            statistics_.bytesLoaded += content->size();
+        }
+    }
+    promise.set_value(content);
+    return content;
+}
+
+void TextureLibrary::Submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+        if (threads_.size() < ParallelUtils::ResolveThreadCount(options_.ioThreads, static_cast<size_t>(-1))) {
+            threads_.emplace_back(&TextureLibrary::RunIoThread, this);
+        }
+    }
+    wake_.notify_one();
+}
+
+void TextureLibrary::RunIoThread() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty()) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+
+} // namespace X2FBX
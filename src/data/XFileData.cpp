@@ -3,6 +3,11 @@
 #include <cmath>
 #include <algorithm>
 
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define X2FBX_MATRIX_SSE 1
+#endif
+
 namespace X2FBX {
 
 // XMatrix4x4 implementation
@@ -21,17 +26,350 @@ XMatrix4x4 XMatrix4x4::Identity() {
 
 XMatrix4x4 XMatrix4x4::operator*(const XMatrix4x4& other) const {
     XMatrix4x4 result;
+#ifdef X2FBX_MATRIX_SSE
+    // Row i of the product is the rows of other weighted by row i of this
+    const __m128 b0 = _mm_loadu_ps(other.m[0]);
+    const __m128 b1 = _mm_loadu_ps(other.m[1]);
+    const __m128 b2 = _mm_loadu_ps(other.m[2]);
+    const __m128 b3 = _mm_loadu_ps(other.m[3]);
+    for (int i = 0; i < 4; i++) {
+        __m128 row = _mm_mul_ps(_mm_set1_ps(m[i][0]), b0);
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i][1]), b1));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i][2]), b2));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(m[i][3]), b3));
+        _mm_storeu_ps(result.m[i], row);
+    }
+#else
     for (int i = 0; i < 4; i++) {
         for (int j = 0; j < 4; j++) {
-            result.m[i][j] = 0;
-            for (int k = 0; k < 4; k++) {
-                result.m[i][j] += m[i][k] * other.m[k][j];
-            }
+            result.m[i][j] = m[i][0] * other.m[0][j] + m[i][1] * other.m[1][j] +
+                             m[i][2] * other.m[2][j] + m[i][3] * other.m[3][j];
         }
     }
+#endif
     return result;
 }
 
+// XNameTable implementation
+XNameTable::XNameTable(const XNameTable& other) {
+    *this = other;
+}
+
+XNameTable& XNameTable::operator=(const XNameTable& other) {
+    if (this != &other) {
+        // The views must point into this table's own storage
+        clear();
+        for (const auto& name : other.names_) {
+            Intern(name);
+        }
+    }
+    return *this;
+}
+
+int XNameTable::Intern(std::string_view name) {
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    int id = static_cast<int>(names_.size());
+    names_.emplace_back(name);
+    ids_.emplace(names_.back(), id);
+    return id;
+}
+
+int XNameTable::Find(std::string_view name) const {
+    auto it = ids_.find(name);
+    return it != ids_.end() ? it->second : -1;
+}
+
+void XNameTable::clear() {
+    ids_.clear();
+    names_.clear();
+}
+
+// XVertexInfluences implementation
+bool XVertexInfluences::Add(int boneIndex, float weight) {
+    int weakest = 0;
+    for (int i = 0; i < MAX_INFLUENCES; i++) {
+        if (boneIndices[i] < 0) {
+            boneIndices[i] = boneIndex;
+            boneWeights[i] = weight;
+            return true;
+        }
+        if (boneWeights[i] < boneWeights[weakest]) {
+            weakest = i;
+        }
+    }
+
+    if (weight > boneWeights[weakest]) {
+        boneIndices[weakest] = boneIndex;
+        boneWeights[weakest] = weight;
+    }
+    return false;
+}
+
+void XVertexInfluences::Normalize() {
+    float sum = 0.0f;
+    for (int i = 0; i < MAX_INFLUENCES; i++) {
+        sum += boneWeights[i];
+    }
+    for (int i = 0; sum > 0.0f && i < MAX_INFLUENCES; i++) {
+        boneWeights[i] /= sum;
+    }
+}
+
+// XMeshData stream management
+void XAnimationChannel::Reserve(size_t keys, size_t components) {
+    times.reserve(keys);
+    values.reserve(keys * components);
+}
+
+void XAnimationChannel::AddKey(float time, const float* value, size_t components) {
+    times.push_back(time);
+    values.insert(values.end(), value, value + components);
+}
+
+void XAnimationChannel::SortByTime(size_t components) {
+    if (std::is_sorted(times.begin(), times.end())) {
+        return;
+    }
+
+    std::vector<size_t> order(times.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return times[a] < times[b]; });
+
+    std::vector<float> sortedTimes(times.size());
+    std::vector<float> sortedValues(values.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        sortedTimes[i] = times[order[i]];
+        std::memcpy(&sortedValues[i * components], &values[order[i] * components], components * sizeof(float));
+    }
+    times.swap(sortedTimes);
+    values.swap(sortedValues);
+}
+
+size_t XAnimationChannel::GetMemoryUsage() const {
+    return sizeof(XAnimationChannel) + (times.capacity() + values.capacity()) * sizeof(float);
+}
+
+float XBoneTrack::GetEndTime() const {
+    float endTime = 0.0f;
+    for (const XAnimationChannel* channel : {&rotation, &translation, &scale}) {
+        if (!channel->IsEmpty()) {
+            endTime = std::max(endTime, channel->times.back());
+        }
+    }
+    return endTime;
+}
+
+size_t XBoneTrack::GetMemoryUsage() const {
+    return sizeof(boneId) + rotation.GetMemoryUsage() + translation.GetMemoryUsage() + scale.GetMemoryUsage();
+}
+
+void XAnimationSet::AddTrack(XBoneTrack track) {
+    if (track.boneId >= 0) {
+        for (auto& existing : tracks) {
+            if (existing.boneId == track.boneId) {
+                existing = std::move(track);
+                return;
+            }
+        }
+    }
+    tracks.push_back(std::move(track));
+}
+
+size_t XAnimationSet::GetKeyCount() const {
+    size_t count = 0;
+    for (const auto& track : tracks) {
+        count += track.GetKeyCount();
+    }
+    return count;
+}
+
+size_t XAnimationSet::GetMemoryUsage() const {
+    size_t bytes = (tracks.capacity() - tracks.size()) * sizeof(XBoneTrack);
+    for (const auto& track : tracks) {
+        bytes += track.GetMemoryUsage();
+    }
+    return bytes;
+}
+
+void XMeshData::ReserveVertices(size_t count) {
+    positions.reserve(count);
+    if (HasNormals()) normals.reserve(count);
+    if (HasTexCoords()) texCoords.reserve(count);
+    if (HasSkinWeights()) skinInfluences.reserve(count);
+}
+
+void XMeshData::ReserveFaces(size_t count) {
+    indices.reserve(count * 3);
+    faceMaterials.reserve(count);
+}
+
+void XMeshData::ResizeVertices(size_t count) {
+    positions.resize(count);
+    if (HasNormals()) normals.resize(count);
+    if (HasTexCoords()) texCoords.resize(count);
+    if (HasSkinWeights()) skinInfluences.resize(count);
+}
+
+XVertex XMeshData::GetVertex(size_t index) const {
+    XVertex vertex;
+    vertex.position = positions[index];
+    if (HasNormals()) vertex.normal = normals[index];
+    if (HasTexCoords()) vertex.texCoord = texCoords[index];
+    if (HasSkinWeights()) vertex.influences = skinInfluences[index];
+    return vertex;
+}
+
+XFace XMeshData::GetFace(size_t index) const {
+    XFace face;
+    face.SetIndices(indices[index * 3], indices[index * 3 + 1], indices[index * 3 + 2]);
+    face.materialIndex = faceMaterials[index];
+    return face;
+}
+
+void XMeshData::AddVertex(const XVertex& vertex) {
+    const XVector3& n = vertex.normal;
+    const XVector2& uv = vertex.texCoord;
+    if (!HasNormals() && (n.x != 0.0f || n.y != 0.0f || n.z != 0.0f)) EnsureNormals();
+    if (!HasTexCoords() && (uv.u != 0.0f || uv.v != 0.0f)) EnsureTexCoords();
+    if (!HasSkinWeights() && vertex.influences.GetCount() > 0) EnsureSkinInfluences();
+
+    positions.push_back(vertex.position);
+    if (HasNormals()) normals.push_back(n);
+    if (HasTexCoords()) texCoords.push_back(uv);
+    if (HasSkinWeights()) skinInfluences.push_back(vertex.influences);
+}
+
+// XMeshData bones
+int XMeshData::AddBone(std::string_view name) {
+    int index = boneNames.Intern(name);
+    if (index == static_cast<int>(bones.size())) {
+        XBone bone;
+        bone.bindPose = XMatrix4x4::Identity();
+        bone.offsetMatrix = XMatrix4x4::Identity();
+        bones.push_back(bone);
+    }
+    return index;
+}
+
+const std::string& XMeshData::GetBoneName(size_t bone) const {
+    static const std::string unnamed;
+    return bone < boneNames.size() ? boneNames.GetName(static_cast<int>(bone)) : unnamed;
+}
+
+// XMeshData skeleton order
+bool XMeshData::SortBonesTopologically(std::vector<int>& newIndex) {
+    const size_t count = bones.size();
+    newIndex.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        newIndex[i] = static_cast<int>(i);
+    }
+
+    // Children per bone in index order, as offsets into one array
+    std::vector<int> childOffsets(count + 1, 0);
+    for (const XBone& bone : bones) {
+        if (bone.parentIndex >= 0 && bone.parentIndex < static_cast<int>(count)) {
+            childOffsets[bone.parentIndex + 1]++;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        childOffsets[i + 1] += childOffsets[i];
+    }
+    std::vector<int> children(childOffsets[count]);
+    std::vector<int> fill(childOffsets.begin(), childOffsets.end() - 1);
+    for (size_t i = 0; i < count; i++) {
+        int parent = bones[i].parentIndex;
+        if (parent >= 0 && parent < static_cast<int>(count)) {
+            children[fill[parent]++] = static_cast<int>(i);
+        }
+    }
+
+    // Depth-first from every root keeps each subtree contiguous
+    std::vector<int> order;
+    order.reserve(count);
+    std::vector<int> stack;
+    for (size_t root = 0; root < count; root++) {
+        int parent = bones[root].parentIndex;
+        if (parent >= 0 && parent < static_cast<int>(count)) {
+            continue;
+        }
+        stack.push_back(static_cast<int>(root));
+        while (!stack.empty()) {
+            int bone = stack.back();
+            stack.pop_back();
+            order.push_back(bone);
+            for (int c = childOffsets[bone + 1]; c-- > childOffsets[bone];) {
+                stack.push_back(children[c]);
+            }
+        }
+    }
+    if (order.size() != count) {
+        // Bones on a parent cycle are never reached from a root; keep file
+        // order but still link the children
+        for (size_t i = 0; i < count; i++) {
+            bones[i].childIndices.assign(children.begin() + childOffsets[i], children.begin() + childOffsets[i + 1]);
+        }
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        newIndex[order[i]] = static_cast<int>(i);
+    }
+    auto remap = [&newIndex](int bone) {
+        return bone >= 0 && bone < static_cast<int>(newIndex.size()) ? newIndex[bone] : bone;
+    };
+
+    std::vector<XBone> sorted(count);
+    XNameTable sortedNames;
+    const bool named = boneNames.size() == count;
+    for (size_t i = 0; i < count; i++) {
+        if (named) {
+            sortedNames.Intern(boneNames.GetName(order[i]));
+        }
+        sorted[i] = std::move(bones[order[i]]);
+        sorted[i].parentIndex = remap(sorted[i].parentIndex);
+        sorted[i].childIndices.clear();
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (sorted[i].parentIndex >= 0) {
+            sorted[sorted[i].parentIndex].childIndices.push_back(static_cast<int>(i));
+        }
+    }
+    bones.swap(sorted);
+    if (named) {
+        boneNames = std::move(sortedNames);
+    }
+
+    for (auto& animation : animations) {
+        for (auto& track : animation.tracks) {
+            track.boneId = remap(track.boneId);
+        }
+    }
+    for (auto& influences : skinInfluences) {
+        for (int k = 0; k < XVertexInfluences::MAX_INFLUENCES; k++) {
+            influences.boneIndices[k] = remap(influences.boneIndices[k]);
+        }
+    }
+    return true;
+}
+
+bool XMeshData::ComputeBoneWorldMatrices(std::vector<XMatrix4x4>& world) const {
+    world.resize(bones.size());
+    for (size_t i = 0; i < bones.size(); i++) {
+        int parent = bones[i].parentIndex;
+        if (parent >= static_cast<int>(i)) {
+            return false;
+        }
+        // Row vectors: the local transform applies first, then the parent's
+        world[i] = parent >= 0 ? bones[i].bindPose * world[parent] : bones[i].bindPose;
+    }
+    return true;
+}
+
 // XMeshData validation
 bool XMeshData::IsValid() const {
     auto errors = GetValidationErrors();
@@ -42,31 +380,43 @@ std::vector<std::string> XMeshData::GetValidationErrors() const {
     std::vector<std::string> errors;
 
     // Check vertex data
-    if (vertices.empty()) {
+    if (positions.empty()) {
         errors.push_back("No vertices found in mesh");
         return errors; // No point checking further
     }
 
+    // Check stream consistency
+    if ((HasNormals() && normals.size() != positions.size()) ||
+        (HasTexCoords() && texCoords.size() != positions.size()) ||
+        (HasSkinWeights() && skinInfluences.size() != positions.size())) {
+        errors.push_back("Vertex attribute streams do not match vertex count");
+    }
+
+    if (indices.size() != faceMaterials.size() * 3) {
+        errors.push_back("Index buffer does not match face count");
+        return errors;
+    }
+
     // Check face data
-    if (faces.empty()) {
+    if (faceMaterials.empty()) {
         errors.push_back("No faces found in mesh");
     }
 
     // Validate face indices
-    int maxVertexIndex = static_cast<int>(vertices.size()) - 1;
-    for (size_t i = 0; i < faces.size(); i++) {
-        const XFace& face = faces[i];
+    int maxVertexIndex = static_cast<int>(positions.size()) - 1;
+    for (size_t i = 0; i < faceMaterials.size(); i++) {
         for (int j = 0; j < 3; j++) {
-            if (face.indices[j] < 0 || face.indices[j] > maxVertexIndex) {
+            int index = indices[i * 3 + j];
+            if (index < 0 || index > maxVertexIndex) {
                 errors.push_back("Face " + std::to_string(i) + " has invalid vertex index: " +
-                                std::to_string(face.indices[j]));
+                                std::to_string(index));
             }
         }
 
         // Check material index
-        if (face.materialIndex >= static_cast<int>(materials.size()) && face.materialIndex != -1) {
+        if (faceMaterials[i] >= static_cast<int>(materials.size()) && faceMaterials[i] != -1) {
             errors.push_back("Face " + std::to_string(i) + " has invalid material index: " +
-                           std::to_string(face.materialIndex));
+                           std::to_string(faceMaterials[i]));
         }
     }
 
@@ -77,38 +427,34 @@ std::vector<std::string> XMeshData::GetValidationErrors() const {
 
             // Check parent index
             if (bone.parentIndex >= static_cast<int>(bones.size())) {
-                errors.push_back("Bone '" + bone.name + "' has invalid parent index: " +
+                errors.push_back("Bone '" + GetBoneName(i) + "' has invalid parent index: " +
                                std::to_string(bone.parentIndex));
             }
 
             // Check for circular references (basic check)
             if (bone.parentIndex == static_cast<int>(i)) {
-                errors.push_back("Bone '" + bone.name + "' references itself as parent");
+                errors.push_back("Bone '" + GetBoneName(i) + "' references itself as parent");
             }
         }
 
         // Validate vertex bone weights
-        for (size_t i = 0; i < vertices.size(); i++) {
-            const XVertex& vertex = vertices[i];
-
-            if (vertex.boneIndices.size() != vertex.boneWeights.size()) {
-                errors.push_back("Vertex " + std::to_string(i) +
-                               " has mismatched bone indices and weights count");
-            }
+        for (size_t i = 0; i < skinInfluences.size(); i++) {
+            const XVertexInfluences& influences = skinInfluences[i];
+            int count = influences.GetCount();
 
             // Check bone indices validity
-            for (int boneIndex : vertex.boneIndices) {
-                if (boneIndex >= static_cast<int>(bones.size())) {
+            for (int k = 0; k < count; k++) {
+                if (influences.boneIndices[k] >= static_cast<int>(bones.size())) {
                     errors.push_back("Vertex " + std::to_string(i) +
-                                   " references invalid bone index: " + std::to_string(boneIndex));
+                                   " references invalid bone index: " + std::to_string(influences.boneIndices[k]));
                 }
             }
 
             // Check weights sum (should be close to 1.0 for skinned vertices)
-            if (!vertex.boneWeights.empty()) {
+            if (count > 0) {
                 float weightSum = 0;
-                for (float weight : vertex.boneWeights) {
-                    weightSum += weight;
+                for (int k = 0; k < count; k++) {
+                    weightSum += influences.boneWeights[k];
                 }
 
                 if (std::abs(weightSum - 1.0f) > 0.01f) {
@@ -132,34 +478,29 @@ std::vector<std::string> XMeshData::GetValidationErrors() const {
                            std::to_string(anim.ticksPerSecond));
         }
 
-        if (anim.keyframes.empty() && anim.boneKeyframes.empty()) {
+        if (anim.GetKeyCount() == 0) {
             errors.push_back("Animation '" + anim.name + "' has no keyframes");
         }
 
-        // Validate keyframe timing
-        for (size_t j = 1; j < anim.keyframes.size(); j++) {
-            if (anim.keyframes[j].time < anim.keyframes[j-1].time) {
-                errors.push_back("Animation '" + anim.name + "' has keyframes out of order at index " +
-                               std::to_string(j));
-                break;
+        for (const auto& track : anim.tracks) {
+            if (track.boneId < -1 || track.boneId >= static_cast<int>(bones.size())) {
+                errors.push_back("Animation '" + anim.name + "' references non-existent bone id: " +
+                               std::to_string(track.boneId));
             }
-        }
 
-        // Validate bone keyframes references
-        for (const auto& boneAnim : anim.boneKeyframes) {
-            const std::string& boneName = boneAnim.first;
-            bool boneExists = false;
-
-            for (const XBone& bone : bones) {
-                if (bone.name == boneName) {
-                    boneExists = true;
-                    break;
+            // Validate keyframe timing
+            const size_t componentCounts[3] = {
+                XBoneTrack::ROTATION_COMPONENTS, XBoneTrack::VECTOR_COMPONENTS, XBoneTrack::VECTOR_COMPONENTS
+            };
+            const XAnimationChannel* channels[3] = {&track.rotation, &track.translation, &track.scale};
+            for (int c = 0; c < 3; c++) {
+                const XAnimationChannel& channel = *channels[c];
+                if (channel.values.size() != channel.times.size() * componentCounts[c]) {
+                    errors.push_back("Animation '" + anim.name + "' has a channel with mismatched key values");
+                } else if (!std::is_sorted(channel.times.begin(), channel.times.end())) {
+                    errors.push_back("Animation '" + anim.name + "' has keyframes out of order");
                 }
             }
-
-            if (!boneExists) {
-                errors.push_back("Animation '" + anim.name + "' references non-existent bone: " + boneName);
-            }
         }
     }
 
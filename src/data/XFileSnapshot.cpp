@@ -0,0 +1,730 @@
+#include "XFileSnapshot.h"
+#include "Logger.h"
+#include "StreamQuantizer.h"
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <type_traits>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace X2FBX {
+
+using namespace Snapshot;
+
+// Stream elements are stored exactly as they sit in memory
+static_assert(sizeof(XVector3) == 12 && sizeof(XVector2) == 8, "Snapshot expects packed float vectors");
+static_assert(sizeof(XVertexInfluences) == 32, "Snapshot expects four int/float influence slots");
+static_assert(sizeof(int) == 4, "Snapshot stores indices as 32-bit integers");
+static_assert(std::is_trivially_copyable<XVector3>::value && std::is_trivially_copyable<XVertexInfluences>::value,
+              "Snapshot streams are copied as raw bytes");
+
+namespace {
+
+size_t AlignUp(size_t value) {
+    return (value + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+// Collects section payloads without copying the large streams: a section
+// is a list of chunks pointing into the source XFileData or into record
+// arrays owned here, written back to back.
+class SnapshotWriter {
+private:
+    struct Chunk {
+        const void* data;
+        size_t bytes;
+    };
+
+    struct PendingSection {
+        uint32_t elementSize = 0;
+        uint64_t count = 0;
+        std::vector<Chunk> chunks;
+    };
+
+    std::map<SectionId, PendingSection> sections_;
+    std::string strings_;
+
+    std::vector<FileInfoRecord> fileInfo_;
+    std::vector<MeshRecord> meshes_;
+    std::vector<MaterialRecord> materials_;
+    std::vector<BoneRecord> bones_;
+    std::vector<AnimationRecord> animations_;
+    std::vector<TrackRecord> tracks_;
+    std::vector<StringRef> metadata_;
+    std::vector<StringRef> messages_;
+
+    // Encoded streams and keys, kept here until written; deques so the
+    // chunks pointing into them stay valid
+    bool quantize_;
+    std::deque<Quantization::QuantizedStreams> quantizedStreams_;
+    std::deque<std::vector<uint64_t>> quantizedRotations_;
+
+    template <typename T>
+    Range Append(SectionId id, const T* data, size_t count) {
+        PendingSection& section = sections_[id];
+        section.elementSize = sizeof(T);
+        Range range{section.count, count};
+        if (count > 0) {
+            section.chunks.push_back({data, count * sizeof(T)});
+            section.count += count;
+        }
+        return range;
+    }
+
+    template <typename T>
+    Range Append(SectionId id, const std::vector<T>& values) {
+        return Append(id, values.data(), values.size());
+    }
+
+    // Owned records are appended by index and attached once complete, since
+    // the vectors still grow while the data is walked
+    template <typename T>
+    Range Reserve(std::vector<T>& records, size_t count) {
+        Range range{records.size(), count};
+        records.resize(records.size() + count);
+        return range;
+    }
+
+    StringRef AddString(const std::string& text) {
+        StringRef ref{strings_.size(), text.size()};
+        strings_ += text;
+        return ref;
+    }
+
+    ChannelRecord AddChannel(const XAnimationChannel& channel, bool quantized = false) {
+        ChannelRecord record;
+        Range times = Append(SectionId::KEY_TIMES, channel.times);
+        Range values;
+        if (quantized) {
+            quantizedRotations_.push_back(Quantization::EncodeRotations(channel));
+            values = Append(SectionId::QUANTIZED_ROTATIONS, quantizedRotations_.back());
+        } else {
+            values = Append(SectionId::KEY_VALUES, channel.values);
+        }
+        record.keyBegin = times.begin;
+        record.keyCount = times.count;
+        record.valueBegin = values.begin;
+        return record;
+    }
+
+    Range AddMaterials(const std::vector<XMaterial>& materials) {
+        Range range = Reserve(materials_, materials.size());
+        for (size_t i = 0; i < materials.size(); i++) {
+            const XMaterial& material = materials[i];
+            MaterialRecord& record = materials_[range.begin + i];
+            std::memset(&record, 0, sizeof(record));
+            record.name = AddString(material.name);
+            std::memcpy(record.diffuseColor, &material.diffuseColor, sizeof(record.diffuseColor));
+            std::memcpy(record.specularColor, &material.specularColor, sizeof(record.specularColor));
+            std::memcpy(record.emissiveColor, &material.emissiveColor, sizeof(record.emissiveColor));
+            record.shininess = material.shininess;
+            record.transparency = material.transparency;
+            record.diffuseTexture = AddString(material.diffuseTexture);
+            record.normalTexture = AddString(material.normalTexture);
+            record.specularTexture = AddString(material.specularTexture);
+        }
+        return range;
+    }
+
+    Range AddBones(const XMeshData& mesh) {
+        Range range = Reserve(bones_, mesh.bones.size());
+        for (size_t i = 0; i < mesh.bones.size(); i++) {
+            const XBone& bone = mesh.bones[i];
+            BoneRecord& record = bones_[range.begin + i];
+            std::memset(&record, 0, sizeof(record));
+            record.name = AddString(mesh.GetBoneName(i));
+            record.parentIndex = bone.parentIndex;
+            std::memcpy(record.bindPose, bone.bindPose.m, sizeof(record.bindPose));
+            std::memcpy(record.offsetMatrix, bone.offsetMatrix.m, sizeof(record.offsetMatrix));
+            record.children = Append(SectionId::BONE_CHILDREN, bone.childIndices);
+        }
+        return range;
+    }
+
+    Range AddAnimations(const std::vector<XAnimationSet>& animations) {
+        Range range = Reserve(animations_, animations.size());
+        for (size_t i = 0; i < animations.size(); i++) {
+            const XAnimationSet& animation = animations[i];
+            Range tracks = Reserve(tracks_, animation.tracks.size());
+            for (size_t t = 0; t < animation.tracks.size(); t++) {
+                const XBoneTrack& track = animation.tracks[t];
+                TrackRecord& record = tracks_[tracks.begin + t];
+                record.boneId = track.boneId;
+                record.flags = quantize_ ? TRACK_QUANTIZED_ROTATIONS : 0;
+                record.rotation = AddChannel(track.rotation, quantize_);
+                record.translation = AddChannel(track.translation);
+                record.scale = AddChannel(track.scale);
+            }
+
+            AnimationRecord& record = animations_[range.begin + i];
+            record.name = AddString(animation.name);
+            record.duration = animation.duration;
+            record.ticksPerSecond = animation.ticksPerSecond;
+            record.tracks = tracks;
+        }
+        return range;
+    }
+
+    void AddMesh(const XMeshData& mesh, size_t slot) {
+        MeshRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.name = AddString(mesh.name);
+        record.globalTicksPerSecond = mesh.globalTicksPerSecond;
+        record.hasTimingInfo = mesh.hasTimingInfo ? 1 : 0;
+        if (quantize_) {
+            AddQuantizedStreams(mesh, record);
+        }
+        if (!(record.quantized & MESH_QUANTIZED_POSITIONS)) {
+            record.positions = Append(SectionId::POSITIONS, mesh.positions);
+        }
+        if (!(record.quantized & MESH_QUANTIZED_NORMALS)) {
+            record.normals = Append(SectionId::NORMALS, mesh.normals);
+        }
+        if (!(record.quantized & MESH_QUANTIZED_TEXCOORDS)) {
+            record.texCoords = Append(SectionId::TEXCOORDS, mesh.texCoords);
+        }
+        record.skinInfluences = Append(SectionId::SKIN_INFLUENCES, mesh.skinInfluences);
+        record.indices = Append(SectionId::INDICES, mesh.indices);
+        record.faceMaterials = Append(SectionId::FACE_MATERIALS, mesh.faceMaterials);
+        record.materials = AddMaterials(mesh.materials);
+        record.bones = AddBones(mesh);
+        record.animations = AddAnimations(mesh.animations);
+        meshes_[slot] = record;
+    }
+
+    // Streams with non-finite values stay in the float sections
+    void AddQuantizedStreams(const XMeshData& mesh, MeshRecord& record) {
+        quantizedStreams_.push_back(Quantization::EncodeStreams(mesh));
+        const Quantization::QuantizedStreams& streams = quantizedStreams_.back();
+        if (!streams.positions.empty()) {
+            record.quantized |= MESH_QUANTIZED_POSITIONS;
+            record.positions = Append(SectionId::QUANTIZED_POSITIONS, streams.positions);
+            std::memcpy(record.positionMin, streams.positionBounds.min, sizeof(record.positionMin));
+            std::memcpy(record.positionExtent, streams.positionBounds.extent, sizeof(record.positionExtent));
+        }
+        if (!streams.normals.empty()) {
+            record.quantized |= MESH_QUANTIZED_NORMALS;
+            record.normals = Append(SectionId::QUANTIZED_NORMALS, streams.normals);
+        }
+        if (!streams.texCoords.empty()) {
+            record.quantized |= MESH_QUANTIZED_TEXCOORDS;
+            record.texCoords = Append(SectionId::QUANTIZED_TEXCOORDS, streams.texCoords);
+            std::memcpy(record.texCoordMin, streams.texCoordBounds.min, sizeof(record.texCoordMin));
+            std::memcpy(record.texCoordExtent, streams.texCoordBounds.extent, sizeof(record.texCoordExtent));
+        }
+    }
+
+    Range AddStrings(std::vector<StringRef>& refs, const std::vector<std::string>& values) {
+        Range range{refs.size(), values.size()};
+        for (const auto& value : values) {
+            refs.push_back(AddString(value));
+        }
+        return range;
+    }
+
+public:
+    SnapshotWriter(const XFileData& fileData, bool quantize)
+        : quantize_(quantize) {
+        FileInfoRecord info;
+        std::memset(&info, 0, sizeof(info));
+        info.format = static_cast<uint32_t>(fileData.header.format);
+        info.majorVersion = fileData.header.majorVersion;
+        info.minorVersion = fileData.header.minorVersion;
+        info.hasAnimationTimingInfo = fileData.header.hasAnimationTimingInfo ? 1 : 0;
+        info.ticksPerSecond = fileData.header.ticksPerSecond;
+        info.parseSuccessful = fileData.parseSuccessful ? 1 : 0;
+        info.inputBytes = fileData.statistics.inputBytes;
+        info.arenaPeakBytes = fileData.statistics.arenaPeakBytes;
+        info.parseMilliseconds = fileData.statistics.parseMilliseconds;
+
+        info.meshes = Reserve(meshes_, 1 + fileData.meshes.size());
+        AddMesh(fileData.meshData, 0);
+        for (size_t i = 0; i < fileData.meshes.size(); i++) {
+            AddMesh(fileData.meshes[i], 1 + i);
+        }
+        info.materials = AddMaterials(fileData.materials);
+        info.animations = AddAnimations(fileData.animations);
+
+        info.metadata = Range{0, fileData.metadata.size()};
+        for (const auto& entry : fileData.metadata) {
+            metadata_.push_back(AddString(entry.first));
+            metadata_.push_back(AddString(entry.second));
+        }
+        info.errors = AddStrings(messages_, fileData.parseErrors);
+        info.warnings = AddStrings(messages_, fileData.parseWarnings);
+        fileInfo_.push_back(info);
+
+        Append(SectionId::FILE_INFO, fileInfo_);
+        Append(SectionId::STRINGS, strings_.data(), strings_.size());
+        Append(SectionId::MESHES, meshes_);
+        Append(SectionId::MATERIALS, materials_);
+        Append(SectionId::BONES, bones_);
+        Append(SectionId::ANIMATIONS, animations_);
+        Append(SectionId::TRACKS, tracks_);
+        Append(SectionId::METADATA, metadata_);
+        Append(SectionId::MESSAGES, messages_);
+    }
+
+    bool WriteTo(std::ostream& out) const {
+        std::vector<Section> table;
+        size_t offset = AlignUp(sizeof(FileHeader) + sections_.size() * sizeof(Section));
+        for (const auto& entry : sections_) {
+            Section section;
+            section.id = static_cast<uint32_t>(entry.first);
+            section.elementSize = entry.second.elementSize;
+            section.offset = offset;
+            section.count = entry.second.count;
+            table.push_back(section);
+            offset = AlignUp(offset + static_cast<size_t>(section.count) * section.elementSize);
+        }
+
+        FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.byteOrder = BYTE_ORDER_MARK;
+        header.fileSize = offset;
+        header.sectionCount = static_cast<uint32_t>(table.size());
+        header.sectionTableOffset = sizeof(FileHeader);
+
+        static const char padding[SECTION_ALIGNMENT] = {};
+        size_t written = 0;
+        auto write = [&](const void* data, size_t bytes) {
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+            written += bytes;
+        };
+        auto pad = [&]() { write(padding, AlignUp(written) - written); };
+
+        write(&header, sizeof(header));
+        write(table.data(), table.size() * sizeof(Section));
+        pad();
+        for (const auto& entry : sections_) {
+            for (const auto& chunk : entry.second.chunks) {
+                write(chunk.data, chunk.bytes);
+            }
+            pad();
+        }
+        return out.good() && written == header.fileSize;
+    }
+};
+
+} // namespace
+
+XFileSnapshotView::XFileSnapshotView()
+    : sections_(nullptr)
+    , sectionCount_(0) {
+}
+
+bool XFileSnapshotView::Open(ByteView data) {
+    data_ = data;
+    sections_ = nullptr;
+    sectionCount_ = 0;
+    error_.clear();
+
+    FileHeader header;
+    if (data.size() < sizeof(header)) {
+        error_ = "file too small for a snapshot header";
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        error_ = "not a snapshot";
+        return false;
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        error_ = "snapshot was written with the other byte order";
+        return false;
+    }
+    if (header.version != VERSION) {
+        error_ = "unsupported snapshot version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.fileSize != data.size()) {
+        error_ = "snapshot is truncated or has trailing data";
+        return false;
+    }
+    // Arrays are used in place, which needs the base as aligned as the sections
+    if (reinterpret_cast<uintptr_t>(data.data()) % SECTION_ALIGNMENT != 0) {
+        error_ = "snapshot data is not 16-byte aligned";
+        return false;
+    }
+    if (header.sectionTableOffset % alignof(Section) != 0 || header.sectionTableOffset > data.size() ||
+        header.sectionCount > (data.size() - header.sectionTableOffset) / sizeof(Section)) {
+        error_ = "section table out of range";
+        return false;
+    }
+
+    sections_ = reinterpret_cast<const Section*>(data.data() + header.sectionTableOffset);
+    sectionCount_ = header.sectionCount;
+    for (size_t i = 0; i < sectionCount_; i++) {
+        const Section& section = sections_[i];
+        if (section.offset % SECTION_ALIGNMENT != 0 || section.offset > data.size() ||
+            (section.elementSize > 0 && section.count > (data.size() - section.offset) / section.elementSize)) {
+            error_ = "section " + std::to_string(section.id) + " out of range";
+            sections_ = nullptr;
+            sectionCount_ = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+const Section* XFileSnapshotView::FindSection(SectionId id) const {
+    for (size_t i = 0; i < sectionCount_; i++) {
+        if (sections_[i].id == static_cast<uint32_t>(id)) {
+            return &sections_[i];
+        }
+    }
+    return nullptr;
+}
+
+namespace {
+
+// Typed arrays of an opened snapshot, with checked range copies
+struct SnapshotArrays {
+    const char* strings = nullptr;
+    size_t stringBytes = 0;
+
+    template <typename T>
+    struct Array {
+        const T* data = nullptr;
+        size_t count = 0;
+
+        bool Contains(const Range& range) const {
+            return range.begin <= count && range.count <= count - range.begin;
+        }
+        const T* At(const Range& range) const { return data + range.begin; }
+    };
+
+    Array<MeshRecord> meshes;
+    Array<XVector3> positions;
+    Array<XVector3> normals;
+    Array<XVector2> texCoords;
+    Array<XVertexInfluences> skinInfluences;
+    Array<int32_t> indices;
+    Array<int32_t> faceMaterials;
+    Array<MaterialRecord> materials;
+    Array<BoneRecord> bones;
+    Array<int32_t> boneChildren;
+    Array<AnimationRecord> animations;
+    Array<TrackRecord> tracks;
+    Array<float> keyTimes;
+    Array<float> keyValues;
+    Array<StringRef> metadata;
+    Array<StringRef> messages;
+    Array<uint16_t> quantizedPositions;
+    Array<int16_t> quantizedNormals;
+    Array<uint16_t> quantizedTexCoords;
+    Array<uint64_t> quantizedRotations;
+
+    bool ReadString(const StringRef& ref, std::string& text) const {
+        if (ref.offset > stringBytes || ref.length > stringBytes - ref.offset) {
+            return false;
+        }
+        text.assign(strings + ref.offset, static_cast<size_t>(ref.length));
+        return true;
+    }
+
+    template <typename T, typename U>
+    static bool Copy(const Array<T>& array, const Range& range, std::vector<U>& values) {
+        static_assert(sizeof(T) == sizeof(U), "Snapshot element size mismatch");
+        if (!array.Contains(range)) {
+            return false;
+        }
+        values.resize(static_cast<size_t>(range.count));
+        if (range.count > 0) {
+            std::memcpy(values.data(), array.At(range), static_cast<size_t>(range.count) * sizeof(T));
+        }
+        return true;
+    }
+
+    bool LoadChannel(const ChannelRecord& record, size_t components, XAnimationChannel& channel) const {
+        Range times{record.keyBegin, record.keyCount};
+        if (record.keyCount > keyValues.count / components) {
+            return false;
+        }
+        Range values{record.valueBegin, record.keyCount * components};
+        return Copy(keyTimes, times, channel.times) && Copy(keyValues, values, channel.values);
+    }
+
+    // Rotation keys whose values are smallest-three codes, one per key
+    bool LoadQuantizedRotations(const ChannelRecord& record, XAnimationChannel& channel) const {
+        Range times{record.keyBegin, record.keyCount};
+        Range codes{record.valueBegin, record.keyCount};
+        if (!quantizedRotations.Contains(codes) || !Copy(keyTimes, times, channel.times)) {
+            return false;
+        }
+        Quantization::DecodeRotations(quantizedRotations.At(codes), channel.times.size(), channel);
+        return true;
+    }
+
+    bool LoadMaterials(const Range& range, std::vector<XMaterial>& result) const {
+        if (!materials.Contains(range)) {
+            return false;
+        }
+        result.resize(static_cast<size_t>(range.count));
+        for (size_t i = 0; i < result.size(); i++) {
+            const MaterialRecord& record = materials.At(range)[i];
+            XMaterial& material = result[i];
+            std::memcpy(&material.diffuseColor, record.diffuseColor, sizeof(record.diffuseColor));
+            std::memcpy(&material.specularColor, record.specularColor, sizeof(record.specularColor));
+            std::memcpy(&material.emissiveColor, record.emissiveColor, sizeof(record.emissiveColor));
+            material.shininess = record.shininess;
+            material.transparency = record.transparency;
+            if (!ReadString(record.name, material.name) ||
+                !ReadString(record.diffuseTexture, material.diffuseTexture) ||
+                !ReadString(record.normalTexture, material.normalTexture) ||
+                !ReadString(record.specularTexture, material.specularTexture)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool LoadBones(const Range& range, XMeshData& mesh) const {
+        if (!bones.Contains(range)) {
+            return false;
+        }
+        mesh.bones.clear();
+        mesh.boneNames.clear();
+        std::string name;
+        for (size_t i = 0; i < static_cast<size_t>(range.count); i++) {
+            const BoneRecord& record = bones.At(range)[i];
+            // Bone names are unique; a repeated one would shift every id
+            if (!ReadString(record.name, name) || mesh.AddBone(name) != static_cast<int>(i)) {
+                return false;
+            }
+            XBone& bone = mesh.bones[i];
+            bone.parentIndex = record.parentIndex;
+            std::memcpy(bone.bindPose.m, record.bindPose, sizeof(record.bindPose));
+            std::memcpy(bone.offsetMatrix.m, record.offsetMatrix, sizeof(record.offsetMatrix));
+            if (!Copy(boneChildren, record.children, bone.childIndices)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool LoadAnimations(const Range& range, std::vector<XAnimationSet>& result) const {
+        if (!animations.Contains(range)) {
+            return false;
+        }
+        result.resize(static_cast<size_t>(range.count));
+        for (size_t i = 0; i < result.size(); i++) {
+            const AnimationRecord& record = animations.At(range)[i];
+            XAnimationSet& animation = result[i];
+            animation.duration = record.duration;
+            animation.ticksPerSecond = record.ticksPerSecond;
+            if (!ReadString(record.name, animation.name) || !tracks.Contains(record.tracks)) {
+                return false;
+            }
+            animation.tracks.resize(static_cast<size_t>(record.tracks.count));
+            for (size_t t = 0; t < animation.tracks.size(); t++) {
+                const TrackRecord& trackRecord = tracks.At(record.tracks)[t];
+                XBoneTrack& track = animation.tracks[t];
+                track.boneId = trackRecord.boneId;
+                const bool rotated = (trackRecord.flags & TRACK_QUANTIZED_ROTATIONS)
+                                         ? LoadQuantizedRotations(trackRecord.rotation, track.rotation)
+                                         : LoadChannel(trackRecord.rotation, XBoneTrack::ROTATION_COMPONENTS, track.rotation);
+                if (!rotated ||
+                    !LoadChannel(trackRecord.translation, XBoneTrack::VECTOR_COMPONENTS, track.translation) ||
+                    !LoadChannel(trackRecord.scale, XBoneTrack::VECTOR_COMPONENTS, track.scale)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // The quantized streams of record, decoded into mesh
+    bool LoadQuantizedStreams(const MeshRecord& record, XMeshData& mesh) const {
+        Quantization::QuantizedStreams streams;
+        std::memcpy(streams.positionBounds.min, record.positionMin, sizeof(record.positionMin));
+        std::memcpy(streams.positionBounds.extent, record.positionExtent, sizeof(record.positionExtent));
+        std::memcpy(streams.texCoordBounds.min, record.texCoordMin, sizeof(record.texCoordMin));
+        std::memcpy(streams.texCoordBounds.extent, record.texCoordExtent, sizeof(record.texCoordExtent));
+        if (record.quantized & MESH_QUANTIZED_POSITIONS) {
+            if (record.positions.count % 3 != 0 || !Copy(quantizedPositions, record.positions, streams.positions)) {
+                return false;
+            }
+        }
+        if (record.quantized & MESH_QUANTIZED_NORMALS) {
+            if (record.normals.count % 2 != 0 || !Copy(quantizedNormals, record.normals, streams.normals)) {
+                return false;
+            }
+        }
+        if (record.quantized & MESH_QUANTIZED_TEXCOORDS) {
+            if (record.texCoords.count % 2 != 0 || !Copy(quantizedTexCoords, record.texCoords, streams.texCoords)) {
+                return false;
+            }
+        }
+        Quantization::DecodeStreams(streams, mesh);
+        return true;
+    }
+
+    bool LoadMesh(const MeshRecord& record, XMeshData& mesh) const {
+        mesh.globalTicksPerSecond = record.globalTicksPerSecond;
+        mesh.hasTimingInfo = record.hasTimingInfo != 0;
+        return ReadString(record.name, mesh.name) &&
+               ((record.quantized & MESH_QUANTIZED_POSITIONS) || Copy(positions, record.positions, mesh.positions)) &&
+               ((record.quantized & MESH_QUANTIZED_NORMALS) || Copy(normals, record.normals, mesh.normals)) &&
+               ((record.quantized & MESH_QUANTIZED_TEXCOORDS) || Copy(texCoords, record.texCoords, mesh.texCoords)) &&
+               LoadQuantizedStreams(record, mesh) &&
+               Copy(skinInfluences, record.skinInfluences, mesh.skinInfluences) &&
+               Copy(indices, record.indices, mesh.indices) &&
+               Copy(faceMaterials, record.faceMaterials, mesh.faceMaterials) &&
+               LoadMaterials(record.materials, mesh.materials) &&
+               LoadBones(record.bones, mesh) &&
+               LoadAnimations(record.animations, mesh.animations);
+    }
+
+    bool LoadStrings(const Range& range, std::vector<std::string>& result) const {
+        if (!messages.Contains(range)) {
+            return false;
+        }
+        result.resize(static_cast<size_t>(range.count));
+        for (size_t i = 0; i < result.size(); i++) {
+            if (!ReadString(messages.At(range)[i], result[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+bool XFileSnapshotView::Load(XFileData& fileData) {
+    TIME_OPERATION("XFileSnapshot::Load");
+    timer.AddBytes(data_.size());
+    fileData = XFileData();
+
+    size_t infoCount = 0;
+    const FileInfoRecord* info = GetArray<FileInfoRecord>(SectionId::FILE_INFO, infoCount);
+    if (!info || infoCount != 1) {
+        error_ = "missing file record";
+        return false;
+    }
+
+    SnapshotArrays arrays;
+    arrays.strings = GetArray<char>(SectionId::STRINGS, arrays.stringBytes);
+    arrays.meshes.data = GetArray<MeshRecord>(SectionId::MESHES, arrays.meshes.count);
+    arrays.positions.data = GetArray<XVector3>(SectionId::POSITIONS, arrays.positions.count);
+    arrays.normals.data = GetArray<XVector3>(SectionId::NORMALS, arrays.normals.count);
+    arrays.texCoords.data = GetArray<XVector2>(SectionId::TEXCOORDS, arrays.texCoords.count);
+    arrays.skinInfluences.data = GetArray<XVertexInfluences>(SectionId::SKIN_INFLUENCES, arrays.skinInfluences.count);
+    arrays.indices.data = GetArray<int32_t>(SectionId::INDICES, arrays.indices.count);
+    arrays.faceMaterials.data = GetArray<int32_t>(SectionId::FACE_MATERIALS, arrays.faceMaterials.count);
+    arrays.materials.data = GetArray<MaterialRecord>(SectionId::MATERIALS, arrays.materials.count);
+    arrays.bones.data = GetArray<BoneRecord>(SectionId::BONES, arrays.bones.count);
+    arrays.boneChildren.data = GetArray<int32_t>(SectionId::BONE_CHILDREN, arrays.boneChildren.count);
+    arrays.animations.data = GetArray<AnimationRecord>(SectionId::ANIMATIONS, arrays.animations.count);
+    arrays.tracks.data = GetArray<TrackRecord>(SectionId::TRACKS, arrays.tracks.count);
+    arrays.keyTimes.data = GetArray<float>(SectionId::KEY_TIMES, arrays.keyTimes.count);
+    arrays.keyValues.data = GetArray<float>(SectionId::KEY_VALUES, arrays.keyValues.count);
+    arrays.metadata.data = GetArray<StringRef>(SectionId::METADATA, arrays.metadata.count);
+    arrays.messages.data = GetArray<StringRef>(SectionId::MESSAGES, arrays.messages.count);
+    arrays.quantizedPositions.data = GetArray<uint16_t>(SectionId::QUANTIZED_POSITIONS, arrays.quantizedPositions.count);
+    arrays.quantizedNormals.data = GetArray<int16_t>(SectionId::QUANTIZED_NORMALS, arrays.quantizedNormals.count);
+    arrays.quantizedTexCoords.data = GetArray<uint16_t>(SectionId::QUANTIZED_TEXCOORDS, arrays.quantizedTexCoords.count);
+    arrays.quantizedRotations.data = GetArray<uint64_t>(SectionId::QUANTIZED_ROTATIONS, arrays.quantizedRotations.count);
+
+    fileData.header.format = static_cast<XFileHeader::Format>(info->format);
+    fileData.header.majorVersion = info->majorVersion;
+    fileData.header.minorVersion = info->minorVersion;
+    fileData.header.hasAnimationTimingInfo = info->hasAnimationTimingInfo != 0;
+    fileData.header.ticksPerSecond = info->ticksPerSecond;
+    fileData.parseSuccessful = info->parseSuccessful != 0;
+    fileData.statistics.inputBytes = static_cast<size_t>(info->inputBytes);
+    fileData.statistics.arenaPeakBytes = static_cast<size_t>(info->arenaPeakBytes);
+    fileData.statistics.parseMilliseconds = info->parseMilliseconds;
+
+    bool loaded = arrays.meshes.Contains(info->meshes) && info->meshes.count >= 1;
+    if (loaded) {
+        const MeshRecord* meshes = arrays.meshes.At(info->meshes);
+        loaded = arrays.LoadMesh(meshes[0], fileData.meshData);
+        fileData.meshes.resize(static_cast<size_t>(info->meshes.count - 1));
+        for (size_t i = 0; loaded && i < fileData.meshes.size(); i++) {
+            loaded = arrays.LoadMesh(meshes[1 + i], fileData.meshes[i]);
+        }
+    }
+    loaded = loaded && arrays.LoadMaterials(info->materials, fileData.materials) &&
+             arrays.LoadAnimations(info->animations, fileData.animations) &&
+             arrays.LoadStrings(info->errors, fileData.parseErrors) &&
+             arrays.LoadStrings(info->warnings, fileData.parseWarnings);
+
+    // Two string references per metadata entry
+    loaded = loaded && info->metadata.begin <= arrays.metadata.count && info->metadata.count <= arrays.metadata.count;
+    Range metadata{info->metadata.begin * 2, info->metadata.count * 2};
+    loaded = loaded && arrays.metadata.Contains(metadata);
+    for (uint64_t i = 0; loaded && i < info->metadata.count; i++) {
+        const StringRef* pair = arrays.metadata.At(metadata) + i * 2;
+        std::string key, value;
+        loaded = arrays.ReadString(pair[0], key) && arrays.ReadString(pair[1], value);
+        fileData.metadata[key] = value;
+    }
+
+    if (!loaded) {
+        error_ = "snapshot record refers outside its arrays";
+        fileData = XFileData();
+        return false;
+    }
+    return true;
+}
+
+bool XFileSnapshot::IsSnapshot(ByteView data) {
+    return data.size() >= sizeof(MAGIC) && std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool XFileSnapshot::IsSnapshotFile(const std::string& filepath) {
+    return IsSnapshot(MappedFile::ReadPrefix(filepath, sizeof(MAGIC)));
+}
+
+bool XFileSnapshot::Write(const XFileData& fileData, const std::string& filepath, bool quantize) {
+    TIME_OPERATION("XFileSnapshot::Write");
+    SnapshotWriter writer(fileData, quantize);
+
+    // Written beside the target and renamed, so readers never see a partial file
+    std::string temporaryPath = filepath + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open() || !writer.WriteTo(out)) {
+            LOG_ERROR("Failed to write snapshot: " + filepath);
+            out.close();
+            std::error_code ec;
+            fs::remove(temporaryPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(temporaryPath, filepath, ec);
+    if (ec) {
+        LOG_ERROR("Failed to write snapshot: " + filepath + ": " + ec.message());
+        fs::remove(temporaryPath, ec);
+        return false;
+    }
+    timer.AddBytes(static_cast<uint64_t>(fs::file_size(filepath, ec)));
+    LOG_INFO("Snapshot written: " + filepath);
+    return true;
+}
+
+bool XFileSnapshot::Read(const std::string& filepath, XFileData& fileData) {
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        LOG_ERROR("Failed to open snapshot: " + filepath);
+        return false;
+    }
+
+    XFileSnapshotView view;
+    if (!view.Open(file.View()) || !view.Load(fileData)) {
+        LOG_ERROR("Invalid snapshot " + filepath + ": " + view.GetError());
+        return false;
+    }
+    return true;
+}
+
+} // namespace X2FBX
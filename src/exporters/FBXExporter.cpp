@@ -1,11 +1,70 @@
 #include "FBXExporter.h"
 #include "AnimationTimingCorrector.h"
+#include "BatchPipeline.h"
+#include "ConversionMetrics.h"
+#include "CoordinateKernels.h"
+#include "FBXExporterPool.h"
+#include "NativeFBXWriter.h"
+#include "ParallelUtils.h"
+#include "ProcessMemory.h"
+#include "TextureLibrary.h"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <cmath>
+#include <filesystem>
+
+namespace fs = std::filesystem;
 
 namespace X2FBX {
 
+namespace {
+
+// Animation names end up in file names; replace characters that are not
+// valid in a path component
+std::string SanitizeFileName(const std::string& name) {
+    std::string sanitized = name;
+    for (char& c : sanitized) {
+        if (c == ' ' || c == '/' || c == '\\' || c == ':' || c == '*' || c == '?' || c == '"' || c == '<' || c == '>' || c == '|') {
+            c = '_';
+        }
+    }
+    return sanitized;
+}
+
+// Frees a stream's storage, not just its elements
+template <typename T>
+void ReleaseStream(std::vector<T>& stream) {
+    std::vector<T>().swap(stream);
+}
+
+#ifdef FBXSDK_FOUND
+// Append one channel's keys to a curve inside a single modify bracket.
+// The keys arrive in time order, so the last-key hint makes every add O(1).
+void EmitCurve(FbxAnimCurve* curve, const std::vector<FbxTime>& times, const std::vector<float>& values) {
+    curve->KeyModifyBegin();
+    int lastIndex = 0;
+    for (size_t i = 0; i < times.size(); ++i) {
+        int keyIndex = curve->KeyAdd(times[i], &lastIndex);
+        curve->KeySet(keyIndex, times[i], values[i], FbxAnimCurveDef::eInterpolationLinear);
+    }
+    curve->KeyModifyEnd();
+}
+
+FbxAMatrix ToFbxMatrix(const XMatrix4x4& matrix) {
+    FbxAMatrix result;
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            result[row][column] = matrix.m[row][column];
+        }
+    }
+    return result;
+}
+#endif
+
+} // namespace
+
 // Constructor
 FBXExporter::FBXExporter()
     : logger_(Logger::GetInstance())
@@ -13,7 +72,9 @@ FBXExporter::FBXExporter()
     , fbxManager_(nullptr)
     , fbxScene_(nullptr)
     , fbxExporter_(nullptr)
+    , clipSceneReady_(false)
 #endif
+    , sharedPose_(nullptr)
 {
 #ifdef FBXSDK_FOUND
     InitializeFBX();
@@ -27,6 +88,20 @@ FBXExporter::~FBXExporter() {
 #endif
 }
 
+void FBXExporter::ResetForReuse() {
+#ifdef FBXSDK_FOUND
+    // The scene object and the manager stay; only the content goes
+    if (fbxScene_) {
+        fbxScene_->Clear();
+    }
+    boneNodes_.clear();
+    ownedPose_.reset();
+    clipSceneReady_ = false;
+#endif
+    sharedPose_ = nullptr;
+    lastExportResult_ = FBXExportResult();
+}
+
 #ifdef FBXSDK_FOUND
 bool FBXExporter::InitializeFBX() {
     fbxManager_ = FbxManager::Create();
@@ -73,17 +148,30 @@ FBXExportResult FBXExporter::ExportToFBX(const XFileData& xData, const std::stri
     FBXExportResult result;
     result.outputPath = outputPath;
 
+    if (ResolveBackend(options) == FBXExportOptions::Backend::NATIVE) {
+        // One file: the mesh and, with animations, one stack per clip
+        std::vector<const XAnimationSet*> animations;
+        if (options.exportAnimations) {
+            for (const auto& animation : xData.meshData.animations) {
+                animations.push_back(&animation);
+            }
+        }
+        result = ExportNative(xData.meshData, "Mesh", options.exportAnimations, animations, outputPath, options);
+    } else {
 #ifdef FBXSDK_FOUND
-    // Real FBX export when SDK is available
-    result = ExportWithFBXSDK(xData, outputPath, options);
+        // Real FBX export when SDK is available
+        result = ExportWithFBXSDK(xData, outputPath, options);
 #else
-    // Placeholder export when SDK is not available
-    result = ExportPlaceholder(xData, outputPath, options);
+        // Placeholder export when SDK is not available
+        result = ExportPlaceholder(xData.meshes.size(), xData.materials.size(), xData.animations.size(),
+                                   outputPath, options);
 #endif
+    }
 
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
     result.exportTimeMs = static_cast<float>(duration.count());
+    result.peakRssBytes = ProcessMemory::GetPeakRssBytes();
 
     return result;
 }
@@ -93,22 +181,11 @@ FBXExportResult FBXExporter::ExportWithFBXSDK(const XFileData& xData, const std:
     FBXExportResult result;
 
     // Create scene
-    fbxScene_ = FbxScene::Create(fbxManager_, "XFileScene");
-    if (!fbxScene_) {
+    if (!CreateScene("XFileScene")) {
         result.errorMessage = "Failed to create FBX scene";
         return result;
     }
 
-    // Set scene info
-    FbxDocumentInfo* sceneInfo = FbxDocumentInfo::Create(fbxManager_, "SceneInfo");
-    sceneInfo->mTitle = "X File Converted to FBX";
-    sceneInfo->mSubject = "Converted using X2FBX Converter";
-    sceneInfo->mAuthor = "X2FBX Converter";
-    sceneInfo->mRevision = "1.0";
-    sceneInfo->mKeywords = "DirectX X file FBX conversion";
-    sceneInfo->mComment = "Converted from DirectX .x format with animation timing correction";
-    fbxScene_->SetSceneInfo(sceneInfo);
-
     // Export mesh data
     if (!xData.meshes.empty()) {
         result.success = ExportMeshes(xData, options);
@@ -133,7 +210,7 @@ FBXExportResult FBXExporter::ExportWithFBXSDK(const XFileData& xData, const std:
     }
 
     // Save the file
-    result.success = SaveFBXFile(outputPath);
+    result.success = SaveFBXFile(outputPath, options);
     if (!result.success) {
         result.errorMessage = "Failed to save FBX file";
     }
@@ -142,11 +219,15 @@ FBXExportResult FBXExporter::ExportWithFBXSDK(const XFileData& xData, const std:
 }
 #endif
 
-FBXExportResult FBXExporter::ExportPlaceholder(const XFileData& xData, const std::string& outputPath, const FBXExportOptions& options) {
+FBXExportResult FBXExporter::ExportPlaceholder(size_t meshCount, size_t materialCount, size_t animationCount,
+                                               const std::string& outputPath, const FBXExportOptions& options) {
+    TIME_OPERATION("ExportPlaceholder");
+
     // Suppress unused parameter warning
     (void)options;
 
     FBXExportResult result;
+    result.outputPath = outputPath;
 
     LOG_WARNING("FBX SDK not available - creating placeholder file");
 
@@ -159,19 +240,20 @@ FBXExportResult FBXExporter::ExportPlaceholder(const XFileData& xData, const std
     file << "; FBX PLACEHOLDER FILE\n";
     file << "; Generated by X2FBX Converter\n";
     file << "; Original file contains:\n";
-    file << ";   Meshes: " << xData.meshes.size() << "\n";
-    file << ";   Materials: " << xData.materials.size() << "\n";
-    file << ";   Animations: " << xData.animations.size() << "\n";
+    file << ";   Meshes: " << meshCount << "\n";
+    file << ";   Materials: " << materialCount << "\n";
+    file << ";   Animations: " << animationCount << "\n";
     file << "\n";
     file << "; To generate real FBX files, install FBX SDK and recompile\n";
     file << "; FBX SDK download: https://www.autodesk.com/developer-network/platform-technologies/fbx-sdk\n";
+    timer.AddBytes(static_cast<uint64_t>(file.tellp()));
     file.close();
 
     result.success = true;
     result.verticesExported = 0;
     result.facesExported = 0;
-    result.materialsExported = static_cast<int>(xData.materials.size());
-    result.animationsExported = static_cast<int>(xData.animations.size());
+    result.materialsExported = static_cast<int>(materialCount);
+    result.animationsExported = static_cast<int>(animationCount);
 
     LOG_INFO("Placeholder FBX file created: " + outputPath);
     return result;
@@ -193,31 +275,34 @@ bool FBXExporter::CreateMesh(const XMeshData& meshData, const FBXExportOptions&
     FbxMesh* fbxMesh = FbxMesh::Create(fbxScene_, (meshData.name + "_mesh").c_str());
 
     // Set vertices
-    fbxMesh->InitControlPoints(static_cast<int>(meshData.vertices.size()));
+    fbxMesh->InitControlPoints(static_cast<int>(meshData.GetVertexCount()));
     FbxVector4* controlPoints = fbxMesh->GetControlPoints();
 
-    for (size_t i = 0; i < meshData.vertices.size(); ++i) {
-        const auto& vertex = meshData.vertices[i];
-        if (options.convertCoordinateSystem && options.flipYZ) {
-            // Convert DirectX to FBX coordinate system
-            controlPoints[i] = FbxVector4(vertex.position.x, vertex.position.z, -vertex.position.y);
-        } else {
-            controlPoints[i] = FbxVector4(vertex.position.x, vertex.position.y, vertex.position.z);
+    if (options.convertCoordinateSystem && options.flipYZ) {
+        // Convert DirectX to FBX coordinate system
+        CoordinateKernels::ConvertVectors4(meshData.positions.data(), meshData.positions.size(),
+                                           reinterpret_cast<double*>(controlPoints));
+    } else {
+        for (size_t i = 0; i < meshData.positions.size(); ++i) {
+            const XVector3& position = meshData.positions[i];
+            controlPoints[i] = FbxVector4(position.x, position.y, position.z);
         }
     }
 
     // Set faces
-    for (const auto& face : meshData.faces) {
+    const size_t second = options.reverseWinding ? 2 : 1;
+    const size_t third = options.reverseWinding ? 1 : 2;
+    for (size_t i = 0; i < meshData.indices.size(); i += 3) {
         fbxMesh->BeginPolygon();
-        for (int vertexIndex : face.vertexIndices) {
-            fbxMesh->AddPolygon(vertexIndex);
-        }
+        fbxMesh->AddPolygon(meshData.indices[i]);
+        fbxMesh->AddPolygon(meshData.indices[i + second]);
+        fbxMesh->AddPolygon(meshData.indices[i + third]);
         fbxMesh->EndPolygon();
     }
 
     // Create skeleton if bones exist
     if (!meshData.bones.empty() && options.exportAnimations) {
-        CreateSkeleton(meshData);
+        CreateSkeleton(meshData, options.convertCoordinateSystem && options.flipYZ);
     }
 
     meshNode->SetNodeAttribute(fbxMesh);
@@ -226,22 +311,81 @@ bool FBXExporter::CreateMesh(const XMeshData& meshData, const FBXExportOptions&
     return true;
 }
 
-bool FBXExporter::CreateSkeleton(const XMeshData& meshData) {
+bool FBXExporter::CreateSkeleton(const XMeshData& meshData, bool convertAxes) {
     if (meshData.bones.empty()) {
         return false;
     }
 
     LOG_INFO("Creating skeleton with " + std::to_string(meshData.bones.size()) + " bones");
 
-    // Implementation for skeleton creation would go here
-    // This is a complex process involving bone nodes, clusters, etc.
+    // The clips of ExportAllAnimations share one pose; other exports
+    // compute their own
+    const FBXUtils::SkeletonPose* pose = sharedPose_;
+    if (!pose) {
+        if (!ownedPose_) {
+            ownedPose_ = std::make_unique<FBXUtils::SkeletonPose>();
+        }
+        if (!FBXUtils::BuildSkeletonPose(meshData, *ownedPose_, convertAxes)) {
+            LOG_ERROR("Bones are not stored parents first; skeleton not created");
+            ownedPose_.reset();
+            boneNodes_.clear();
+            return false;
+        }
+        pose = ownedPose_.get();
+    }
+
+    // Parents precede their children, so every parent node exists already
+    boneNodes_.assign(meshData.bones.size(), nullptr);
+    for (size_t i = 0; i < meshData.bones.size(); ++i) {
+        const XBone& bone = meshData.bones[i];
+        FbxNode* parentNode = bone.parentIndex >= 0 ? boneNodes_[bone.parentIndex] : fbxScene_->GetRootNode();
+        boneNodes_[i] = CreateBoneNode(meshData.GetBoneName(i), bone, pose->local[i], parentNode);
+    }
 
     return true;
 }
 
-bool FBXExporter::SaveFBXFile(const std::string& outputPath) {
+FbxNode* FBXExporter::CreateBoneNode(const std::string& name, const XBone& bone, const XMatrix4x4& localTransform,
+                                     FbxNode* parentNode) {
+    FbxSkeleton* skeleton = FbxSkeleton::Create(fbxScene_, (name + "_skeleton").c_str());
+    FbxNode* node = FbxNode::Create(fbxScene_, name.c_str());
+    if (!skeleton || !node) {
+        LOG_WARNING("Failed to create node for bone: " + name);
+        return nullptr;
+    }
+    skeleton->SetSkeletonType(bone.parentIndex >= 0 ? FbxSkeleton::eLimbNode : FbxSkeleton::eRoot);
+    node->SetNodeAttribute(skeleton);
+
+    FbxAMatrix local = ToFbxMatrix(localTransform);
+    const FbxVector4 translation = local.GetT();
+    const FbxVector4 rotation = local.GetR();
+    const FbxVector4 scaling = local.GetS();
+    node->LclTranslation.Set(FbxDouble3(translation[0], translation[1], translation[2]));
+    node->LclRotation.Set(FbxDouble3(rotation[0], rotation[1], rotation[2]));
+    node->LclScaling.Set(FbxDouble3(scaling[0], scaling[1], scaling[2]));
+
+    if (parentNode) {
+        parentNode->AddChild(node);
+    }
+    return node;
+}
+
+const FBXUtils::SkeletonPose* FBXExporter::GetSkeletonPose() const {
+    return sharedPose_ ? sharedPose_ : ownedPose_.get();
+}
+
+bool FBXExporter::SaveFBXFile(const std::string& outputPath, const FBXExportOptions& options) {
+    TIME_OPERATION("SaveFBXFile");
     int fileFormat = fbxManager_->GetIOPluginRegistry()->GetNativeWriterFormat();
 
+    FbxIOSettings* ios = fbxManager_->GetIOSettings();
+    ios->SetBoolProp(EXP_FBX_COMPRESS_ARRAYS, options.compressArrays);
+    // The SDK reads and embeds the files the textures point at
+    ios->SetBoolProp(EXP_FBX_EMBEDDED, options.embedTextures && options.textures != nullptr);
+    if (options.compressionLevel >= 0) {
+        ios->SetIntProp(EXP_FBX_COMPRESS_LEVEL, options.compressionLevel);
+    }
+
     if (!fbxExporter_->Initialize(outputPath.c_str(), fileFormat, fbxManager_->GetIOSettings())) {
         LOG_ERROR("Failed to initialize FBX exporter for: " + outputPath);
         return false;
@@ -252,6 +396,13 @@ bool FBXExporter::SaveFBXFile(const std::string& outputPath) {
         LOG_ERROR("Failed to export FBX file: " + outputPath);
     } else {
         LOG_INFO("FBX file exported successfully: " + outputPath);
+        std::error_code ec;
+        uintmax_t written = fs::file_size(outputPath, ec);
+        if (!ec) {
+            timer.AddBytes(written);
+        }
+        std::string error;
+        success = CheckWrittenFile(outputPath, options, error);
     }
 
     return success;
@@ -275,40 +426,23 @@ bool FBXExporter::ExportSeparateAnimations(const XFileData& xData, const std::st
 
     logger_.Info("Exporting " + std::to_string(meshData.animations.size()) + " animations as separate files");
 
+    fs::path base(basePath);
+    std::vector<FBXExportResult> results =
+        ExportAllAnimations(meshData, base.parent_path().string(), base.filename().string(), options);
+
     bool allSuccess = true;
     int exportedCount = 0;
-
-    // Export each animation as a separate file
-    for (const auto& animation : meshData.animations) {
-        std::string animationFileName = basePath + "_" + animation.name + ".fbx";
-
-        // Sanitize filename - remove invalid characters
-        std::string sanitizedName = animation.name;
-        for (char& c : sanitizedName) {
-            if (c == ' ' || c == '/' || c == '\\' || c == ':' || c == '*' || c == '?' || c == '"' || c == '<' || c == '>' || c == '|') {
-                c = '_';
-            }
-        }
-        animationFileName = basePath + "_" + sanitizedName + ".fbx";
-
-        logger_.Info("Exporting animation: " + animation.name + " -> " + animationFileName);
-
-        try {
-            FBXExportResult result = ExportAnimatedMesh(meshData, animation, animationFileName, options);
-
-            if (result.success) {
-                exportedCount++;
-                logger_.Info("Successfully exported animation: " + animation.name +
-                           " (Duration: " + std::to_string(animation.GetDurationInSeconds()) + "s, " +
-                           "Keyframes: " + std::to_string(animation.keyframes.size()) + ")");
-            } else {
-                allSuccess = false;
-                logger_.Error("Failed to export animation: " + animation.name +
-                           " - Error: " + result.errorMessage);
-            }
-        } catch (const std::exception& e) {
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& animation = meshData.animations[i];
+        if (results[i].success) {
+            exportedCount++;
+            logger_.Info("Successfully exported animation: " + animation.name +
+                       " (Duration: " + std::to_string(animation.GetDurationInSeconds()) + "s, " +
+                       "Keyframes: " + std::to_string(animation.GetKeyCount()) + ")");
+        } else {
             allSuccess = false;
-            logger_.Error("Exception while exporting animation " + animation.name + ": " + e.what());
+            logger_.Error("Failed to export animation: " + animation.name +
+                       " - Error: " + results[i].errorMessage);
         }
     }
 
@@ -365,7 +499,9 @@ bool FBXExporter::ExportCombinedAnimations(const XFileData& xData, const FBXExpo
         }
 
         // Create and attach the mesh
-        FbxMesh* fbxMesh = CreateFBXMesh(meshData, "CombinedMesh");
+        FbxMesh* fbxMesh = CreateFBXMesh(meshData, "CombinedMesh", options.reverseWinding, nullptr,
+                                          options.validation != FBXExportOptions::Validation::NONE,
+                                          options.convertCoordinateSystem && options.flipYZ);
         if (!fbxMesh) {
             logger_.Error("Failed to create FBX mesh for combined animations");
             return false;
@@ -377,12 +513,12 @@ bool FBXExporter::ExportCombinedAnimations(const XFileData& xData, const FBXExpo
 
         // Create skeleton if bones exist
         if (!meshData.bones.empty()) {
-            if (!CreateSkeleton(meshData)) {
+            if (!CreateSkeleton(meshData, options.convertCoordinateSystem && options.flipYZ)) {
                 logger_.Warning("Failed to create skeleton for combined animations");
             }
 
             // Apply skin weights
-            if (!ApplySkinWeights(meshData, fbxMesh)) {
+            if (!ApplySkinWeights(meshData, fbxMesh, options.skinClusterThreads)) {
                 logger_.Warning("Failed to apply skin weights for combined animations");
             }
         }
@@ -392,14 +528,15 @@ bool FBXExporter::ExportCombinedAnimations(const XFileData& xData, const FBXExpo
             logger_.Info("Adding animation: " + animation.name +
                        " (Duration: " + std::to_string(animation.GetDurationInSeconds()) + "s)");
 
-            if (!CreateAnimation(animation, options.animationFrameRate)) {
+            if (!CreateAnimation(animation, options.animationFrameRate,
+                                 options.convertCoordinateSystem && options.flipYZ)) {
                 logger_.Warning("Failed to create animation: " + animation.name);
             }
         }
 
         // Set up materials
         if (options.exportMaterials && !meshData.materials.empty()) {
-            auto fbxMaterials = ConvertMaterials(meshData);
+            auto fbxMaterials = ConvertMaterials(meshData, options);
             for (size_t i = 0; i < fbxMaterials.size() && i < meshData.materials.size(); ++i) {
                 if (fbxMaterials[i]) {
                     meshNode->AddMaterial(fbxMaterials[i]);
@@ -407,8 +544,8 @@ bool FBXExporter::ExportCombinedAnimations(const XFileData& xData, const FBXExpo
             }
         }
 
-        // Validate the scene
-        if (!ValidateScene()) {
+        // Walks every polygon; only worth it when the file is checked anyway
+        if (options.validation == FBXExportOptions::Validation::FULL && !ValidateScene()) {
             logger_.Warning("Scene validation failed for combined animations");
         }
 
@@ -435,14 +572,16 @@ bool FBXExporter::ExportCombinedAnimations(const XFileData& xData, const FBXExpo
         for (const auto& animation : meshData.animations) {
             file << "Animation: " << animation.name << "\n";
             file << "  Duration: " << animation.GetDurationInSeconds() << " seconds\n";
-            file << "  Keyframes: " << animation.keyframes.size() << "\n";
+            file << "  Keyframes: " << animation.GetKeyCount() << "\n";
             file << "  Ticks per second: " << animation.ticksPerSecond << "\n";
 
             // List bones with keyframes
-            if (!animation.boneKeyframes.empty()) {
+            if (!animation.tracks.empty()) {
                 file << "  Animated bones:\n";
-                for (const auto& boneAnim : animation.boneKeyframes) {
-                    file << "    - " << boneAnim.first << " (" << boneAnim.second.size() << " keyframes)\n";
+                for (const auto& track : animation.tracks) {
+                    std::string boneName = track.boneId >= 0 && track.boneId < static_cast<int>(meshData.bones.size())
+                        ? meshData.GetBoneName(track.boneId) : "(no target frame)";
+                    file << "    - " << boneName << " (" << track.GetKeyCount() << " keyframes)\n";
                 }
             }
             file << "\n";
@@ -470,9 +609,37 @@ bool FBXExporter::ExportCombinedAnimations(const XFileData& xData, const FBXExpo
 FBXExportResult FBXExporter::ExportStaticMesh(const XMeshData& meshData,
                                               const std::string& outputPath,
                                               const FBXExportOptions& options) {
+    return ExportStaticMeshImpl(meshData, outputPath, options, nullptr);
+}
+
+FBXExportResult FBXExporter::ExportStaticMesh(XMeshData&& meshData,
+                                              const std::string& outputPath,
+                                              const FBXExportOptions& options) {
+    FBXExportResult result = ExportStaticMeshImpl(meshData, outputPath, options, &meshData);
+    meshData = XMeshData();   // Names, bones and whatever else was not released on the way
+    return result;
+}
+
+FBXExportResult FBXExporter::ExportStaticMeshImpl(const XMeshData& meshData, const std::string& outputPath,
+                                                  const FBXExportOptions& options, XMeshData* release) {
+    TIME_OPERATION("FBXExporter::ExportStaticMesh");
     FBXExportResult result;
     result.outputPath = outputPath;
 
+    if (ResolveBackend(options) == FBXExportOptions::Backend::NATIVE) {
+        // The writer reads the streams in place; they are freed once written
+        result = ExportNative(meshData, "StaticMesh", false, {}, outputPath, options);
+        if (release) {
+            *release = XMeshData();
+        }
+        result.peakRssBytes = ProcessMemory::GetPeakRssBytes();
+        return result;
+    }
+
+    // Counted up front; a streaming export frees the streams as it goes
+    const int vertexCount = static_cast<int>(meshData.GetVertexCount());
+    const int faceCount = static_cast<int>(meshData.GetFaceCount());
+
 #ifdef FBXSDK_FOUND
     try {
         // Create a new scene for this export
@@ -482,7 +649,9 @@ FBXExportResult FBXExporter::ExportStaticMesh(const XMeshData& meshData,
         }
 
         // Create the mesh
-        FbxMesh* fbxMesh = CreateFBXMesh(meshData, "StaticMesh");
+        FbxMesh* fbxMesh = CreateFBXMesh(meshData, "StaticMesh", options.reverseWinding, release,
+                                          options.validation != FBXExportOptions::Validation::NONE,
+                                          options.convertCoordinateSystem && options.flipYZ);
         if (!fbxMesh) {
             result.errorMessage = "Failed to create FBX mesh";
             return result;
@@ -495,7 +664,7 @@ FBXExportResult FBXExporter::ExportStaticMesh(const XMeshData& meshData,
 
         // Add materials if requested
         if (options.exportMaterials && !meshData.materials.empty()) {
-            auto fbxMaterials = ConvertMaterials(meshData);
+            auto fbxMaterials = ConvertMaterials(meshData, options);
             for (auto* material : fbxMaterials) {
                 if (material) {
                     meshNode->AddMaterial(material);
@@ -503,28 +672,40 @@ FBXExportResult FBXExporter::ExportStaticMesh(const XMeshData& meshData,
             }
             result.materialsExported = static_cast<int>(fbxMaterials.size());
         }
+        if (release) {
+            ReleaseStream(release->materials);
+            ReleaseStream(release->skinInfluences);
+        }
 
         // Save the file
-        if (SaveFBXFile(outputPath)) {
+        if (SaveFBXFile(outputPath, options)) {
             result.success = true;
-            result.verticesExported = static_cast<int>(meshData.vertices.size());
-            result.facesExported = static_cast<int>(meshData.faces.size());
+            result.verticesExported = vertexCount;
+            result.facesExported = faceCount;
         } else {
             result.errorMessage = "Failed to save FBX file";
         }
 
+        if (release) {
+            // Written; the scene's copy of the geometry is no longer needed
+            fbxScene_->Clear();
+            boneNodes_.clear();
+        }
+
     } catch (const std::exception& e) {
         result.errorMessage = "Exception during static mesh export: " + std::string(e.what());
     }
 #else
-    // Placeholder export - create empty XFileData for static mesh
-    XFileData emptyData;
-    emptyData.meshData.vertices.resize(meshData.vertices.size());
-    emptyData.meshData.faces.resize(meshData.faces.size());
-    emptyData.materials = meshData.materials;
-    result = ExportPlaceholder(emptyData, outputPath, options);
+    (void)vertexCount;
+    (void)faceCount;
+    const size_t materialCount = meshData.materials.size();
+    if (release) {
+        *release = XMeshData();
+    }
+    result = ExportPlaceholder(0, materialCount, 0, outputPath, options);
 #endif
 
+    result.peakRssBytes = ProcessMemory::GetPeakRssBytes();
     return result;
 }
 
@@ -535,6 +716,12 @@ FBXExportResult FBXExporter::ExportAnimatedMesh(const XMeshData& meshData,
     FBXExportResult result;
     result.outputPath = outputPath;
 
+    if (ResolveBackend(options) == FBXExportOptions::Backend::NATIVE) {
+        result = ExportNative(meshData, "AnimatedMesh", true, {&animation}, outputPath, options);
+        result.peakRssBytes = ProcessMemory::GetPeakRssBytes();
+        return result;
+    }
+
 #ifdef FBXSDK_FOUND
     try {
         // Create a new scene for this export
@@ -544,7 +731,9 @@ FBXExportResult FBXExporter::ExportAnimatedMesh(const XMeshData& meshData,
         }
 
         // Create the mesh
-        FbxMesh* fbxMesh = CreateFBXMesh(meshData, "AnimatedMesh");
+        FbxMesh* fbxMesh = CreateFBXMesh(meshData, "AnimatedMesh", options.reverseWinding, nullptr,
+                                          options.validation != FBXExportOptions::Validation::NONE,
+                                          options.convertCoordinateSystem && options.flipYZ);
         if (!fbxMesh) {
             result.errorMessage = "Failed to create FBX mesh";
             return result;
@@ -557,18 +746,19 @@ FBXExportResult FBXExporter::ExportAnimatedMesh(const XMeshData& meshData,
 
         // Create skeleton if bones exist
         if (!meshData.bones.empty()) {
-            CreateSkeleton(meshData);
-            ApplySkinWeights(meshData, fbxMesh);
+            CreateSkeleton(meshData, options.convertCoordinateSystem && options.flipYZ);
+            ApplySkinWeights(meshData, fbxMesh, options.skinClusterThreads);
         }
 
         // Create animation
-        if (CreateAnimation(animation, options.animationFrameRate)) {
+        if (CreateAnimation(animation, options.animationFrameRate,
+                            options.convertCoordinateSystem && options.flipYZ)) {
             result.animationsExported = 1;
         }
 
         // Add materials if requested
         if (options.exportMaterials && !meshData.materials.empty()) {
-            auto fbxMaterials = ConvertMaterials(meshData);
+            auto fbxMaterials = ConvertMaterials(meshData, options);
             for (auto* material : fbxMaterials) {
                 if (material) {
                     meshNode->AddMaterial(material);
@@ -578,10 +768,10 @@ FBXExportResult FBXExporter::ExportAnimatedMesh(const XMeshData& meshData,
         }
 
         // Save the file
-        if (SaveFBXFile(outputPath)) {
+        if (SaveFBXFile(outputPath, options)) {
             result.success = true;
-            result.verticesExported = static_cast<int>(meshData.vertices.size());
-            result.facesExported = static_cast<int>(meshData.faces.size());
+            result.verticesExported = static_cast<int>(meshData.GetVertexCount());
+            result.facesExported = static_cast<int>(meshData.GetFaceCount());
             result.bonesExported = static_cast<int>(meshData.bones.size());
         } else {
             result.errorMessage = "Failed to save FBX file";
@@ -591,28 +781,136 @@ FBXExportResult FBXExporter::ExportAnimatedMesh(const XMeshData& meshData,
         result.errorMessage = "Exception during animated mesh export: " + std::string(e.what());
     }
 #else
-    // Placeholder export - create empty XFileData for animated mesh
-    XFileData emptyData;
-    emptyData.meshData.vertices.resize(meshData.vertices.size());
-    emptyData.meshData.faces.resize(meshData.faces.size());
-    emptyData.materials = meshData.materials;
-    emptyData.meshData.animations.push_back(animation);
-    result = ExportPlaceholder(emptyData, outputPath, options);
+    (void)animation;
+    result = ExportPlaceholder(0, meshData.materials.size(), 1, outputPath, options);
 #endif
 
+    result.peakRssBytes = ProcessMemory::GetPeakRssBytes();
     return result;
 }
 
+std::vector<FBXExportResult> FBXExporter::ExportAllAnimations(const XMeshData& meshData,
+                                                           const std::string& outputDirectory,
+                                                           const std::string& baseFileName,
+                                                           const FBXExportOptions& options) {
+    const auto& animations = meshData.animations;
+    std::vector<FBXExportResult> results(animations.size());
+    size_t threads = ParallelUtils::ResolveThreadCount(options.animationExportThreads, animations.size());
+
+    if (threads > 1) {
+        logger_.Info("Exporting " + std::to_string(animations.size()) + " animations on " +
+                     std::to_string(threads) + " threads");
+    }
+
 #ifdef FBXSDK_FOUND
-bool FBXExporter::CreateScene(const std::string& sceneName) {
-    if (fbxScene_) {
-        fbxScene_->Destroy();
+    // The mesh from an earlier export may be gone; rebuild the clip scene
+    clipSceneReady_ = false;
+#endif
+
+    // Clip files may point at the texture files instead of each carrying a copy
+    FBXExportOptions clipOptions = options;
+    clipOptions.embedTextures = options.embedTextures && options.embedTexturesInClips;
+
+    // Every clip shares one skeleton pose, computed here once
+    FBXUtils::SkeletonPose pose;
+    if (!meshData.bones.empty() &&
+        FBXUtils::BuildSkeletonPose(meshData, pose, options.convertCoordinateSystem && options.flipYZ)) {
+        sharedPose_ = &pose;
     }
 
-    fbxScene_ = FbxScene::Create(fbxManager_, sceneName.c_str());
-    if (!fbxScene_) {
-        LOG_ERROR("Failed to create FBX scene: " + sceneName);
-        return false;
+    // Worker 0 is this exporter; with the SDK every other worker leases
+    // its own exporter (and with it its own FbxManager and scene) from the
+    // pool on first use. Native clips keep no exporter state and all share
+    // this one.
+    const bool native = ResolveBackend(options) == FBXExportOptions::Backend::NATIVE;
+    std::vector<FBXExporterPool::Lease> workers(threads);
+    ParallelUtils::ParallelFor(animations.size(), threads, [&](size_t index, size_t workerId) {
+        FBXExporter* exporter = this;
+        if (workerId > 0 && !native) {
+            if (!workers[workerId]) {
+                workers[workerId] = FBXExporterPool::GetInstance().Acquire();
+                workers[workerId]->sharedPose_ = sharedPose_;
+            }
+            exporter = workers[workerId].get();
+        }
+
+        const XAnimationSet& animation = animations[index];
+        std::string outputPath =
+            (fs::path(outputDirectory) / (baseFileName + "_" + SanitizeFileName(animation.name) + ".fbx")).string();
+        try {
+            results[index] = exporter->ExportClip(meshData, animation, outputPath, clipOptions);
+            if (results[index].success) {
+                ConversionMetrics::GetInstance().AddKeysExported(animation.GetKeyCount());
+            }
+        } catch (const std::exception& e) {
+            results[index].outputPath = outputPath;
+            results[index].errorMessage = "Exception while exporting animation " + animation.name + ": " + e.what();
+        }
+        results[index].peakRssBytes = ProcessMemory::GetPeakRssBytes();
+    });
+
+    sharedPose_ = nullptr;
+    return results;
+}
+
+FBXExportResult FBXExporter::ExportClip(const XMeshData& meshData, const XAnimationSet& animation,
+                                        const std::string& outputPath, const FBXExportOptions& options) {
+    TIME_OPERATION("FBXExporter::ExportClip");
+    if (ResolveBackend(options) == FBXExportOptions::Backend::NATIVE) {
+        return ExportNative(meshData, "AnimatedMesh", true, {&animation}, outputPath, options);
+    }
+
+#ifdef FBXSDK_FOUND
+    FBXExportResult result;
+    result.outputPath = outputPath;
+
+    if (!clipSceneReady_ && !BuildClipScene(meshData, options)) {
+        result.errorMessage = "Failed to create FBX scene";
+        return result;
+    }
+
+    // Only the animation stack differs between clips
+    FbxAnimStack* animStack = nullptr;
+    if (CreateAnimation(animation, options.animationFrameRate,
+                        options.convertCoordinateSystem && options.flipYZ, &animStack)) {
+        result.animationsExported = 1;
+    }
+
+    if (SaveFBXFile(outputPath, options)) {
+        result.success = true;
+        result.verticesExported = static_cast<int>(meshData.GetVertexCount());
+        result.facesExported = static_cast<int>(meshData.GetFaceCount());
+        result.bonesExported = static_cast<int>(meshData.bones.size());
+        if (options.exportMaterials) {
+            result.materialsExported = static_cast<int>(meshData.materials.size());
+        }
+    } else {
+        result.errorMessage = "Failed to save FBX file";
+    }
+
+    if (animStack) {
+        animStack->Destroy(true);
+    }
+    return result;
+#else
+    return ExportAnimatedMesh(meshData, animation, outputPath, options);
+#endif
+}
+
+#ifdef FBXSDK_FOUND
+bool FBXExporter::CreateScene(const std::string& sceneName) {
+    if (fbxScene_) {
+        // Emptying the scene keeps the object and its manager bookkeeping,
+        // which is cheaper than destroying it and creating another
+        fbxScene_->Clear();
+        fbxScene_->SetName(sceneName.c_str());
+        FBXExporterPool::GetInstance().RecordSceneReset();
+    } else {
+        fbxScene_ = FbxScene::Create(fbxManager_, sceneName.c_str());
+        if (!fbxScene_) {
+            LOG_ERROR("Failed to create FBX scene: " + sceneName);
+            return false;
+        }
     }
 
     // Set scene info
@@ -627,13 +925,48 @@ bool FBXExporter::CreateScene(const std::string& sceneName) {
 
     // Clear bone node tracking
     boneNodes_.clear();
-    boneNodeMap_.clear();
+    clipSceneReady_ = false;
 
     LOG_INFO("Created FBX scene: " + sceneName);
     return true;
 }
 
-FbxMesh* FBXExporter::CreateFBXMesh(const XMeshData& meshData, const std::string& meshName) {
+bool FBXExporter::BuildClipScene(const XMeshData& meshData, const FBXExportOptions& options) {
+    TIME_OPERATION("BuildClipScene");
+    if (!CreateScene("AnimatedMesh")) {
+        return false;
+    }
+
+    FbxMesh* fbxMesh = CreateFBXMesh(meshData, "AnimatedMesh", options.reverseWinding, nullptr,
+                                      options.validation != FBXExportOptions::Validation::NONE,
+                                      options.convertCoordinateSystem && options.flipYZ);
+    if (!fbxMesh) {
+        return false;
+    }
+
+    FbxNode* meshNode = FbxNode::Create(fbxScene_, "AnimatedMeshNode");
+    meshNode->SetNodeAttribute(fbxMesh);
+    fbxScene_->GetRootNode()->AddChild(meshNode);
+
+    if (!meshData.bones.empty()) {
+        CreateSkeleton(meshData, options.convertCoordinateSystem && options.flipYZ);
+        ApplySkinWeights(meshData, fbxMesh, options.skinClusterThreads);
+    }
+
+    if (options.exportMaterials && !meshData.materials.empty()) {
+        for (auto* material : ConvertMaterials(meshData, options)) {
+            if (material) {
+                meshNode->AddMaterial(material);
+            }
+        }
+    }
+
+    clipSceneReady_ = true;
+    return true;
+}
+
+FbxMesh* FBXExporter::CreateFBXMesh(const XMeshData& meshData, const std::string& meshName, bool reverseWinding,
+                                    XMeshData* release, bool validate, bool convertAxes) {
     if (!fbxScene_) {
         LOG_ERROR("No FBX scene available for mesh creation");
         return nullptr;
@@ -646,62 +979,118 @@ FbxMesh* FBXExporter::CreateFBXMesh(const XMeshData& meshData, const std::string
         return nullptr;
     }
 
+    const size_t vertexCount = meshData.GetVertexCount();
+    const size_t faceCount = meshData.GetFaceCount();
+    if (validate && meshData.indices.size() % 3 != 0) {
+        LOG_ERROR("Validation failed: " + meshName + ": " + std::to_string(meshData.indices.size()) +
+                  " triangle indices is not a whole number of triangles");
+        fbxMesh->Destroy();
+        return nullptr;
+    }
+
     // Set vertices
-    fbxMesh->InitControlPoints(static_cast<int>(meshData.vertices.size()));
+    fbxMesh->InitControlPoints(static_cast<int>(vertexCount));
     FbxVector4* controlPoints = fbxMesh->GetControlPoints();
 
-    for (size_t i = 0; i < meshData.vertices.size(); ++i) {
-        const auto& vertex = meshData.vertices[i];
-        // Convert DirectX to FBX coordinate system (flip Y and Z)
-        controlPoints[i] = FbxVector4(vertex.position.x, vertex.position.z, -vertex.position.y);
+    // Convert DirectX to FBX coordinate system (flip Y and Z) straight into
+    // the control points, which are plain (x, y, z, w) doubles
+    static_assert(sizeof(FbxVector4) == 4 * sizeof(double), "FbxVector4 layout");
+    if (convertAxes) {
+        CoordinateKernels::ConvertVectors4(meshData.positions.data(), meshData.positions.size(),
+                                           reinterpret_cast<double*>(controlPoints));
+    } else {
+        for (size_t i = 0; i < meshData.positions.size(); ++i) {
+            const XVector3& position = meshData.positions[i];
+            controlPoints[i] = FbxVector4(position.x, position.y, position.z);
+        }
+    }
+    if (release) {
+        ReleaseStream(release->positions);
     }
 
-    // Set faces
-    for (const auto& face : meshData.faces) {
+    // Set faces; reserved up front so the polygon arrays never regrow
+    // (a regrow briefly holds the old and the new array)
+    fbxMesh->ReservePolygonCount(static_cast<int>(faceCount));
+    fbxMesh->ReservePolygonVertexCount(static_cast<int>(meshData.indices.size()));
+    // The largest index (compared unsigned, so negative ones count) is
+    // tracked in the same loop for validation
+    const size_t second = reverseWinding ? 2 : 1;
+    const size_t third = reverseWinding ? 1 : 2;
+    const size_t triangleEnd = meshData.indices.size() - meshData.indices.size() % 3;
+    uint32_t largestIndex = 0;
+    for (size_t i = 0; i < triangleEnd; i += 3) {
+        const int a = meshData.indices[i];
+        const int b = meshData.indices[i + second];
+        const int c = meshData.indices[i + third];
+        largestIndex = std::max({largestIndex, static_cast<uint32_t>(a), static_cast<uint32_t>(b),
+                                 static_cast<uint32_t>(c)});
         fbxMesh->BeginPolygon();
-        for (int vertexIndex : face.vertexIndices) {
-            fbxMesh->AddPolygon(vertexIndex);
-        }
+        fbxMesh->AddPolygon(a);
+        fbxMesh->AddPolygon(b);
+        fbxMesh->AddPolygon(c);
         fbxMesh->EndPolygon();
     }
+    if (release) {
+        ReleaseStream(release->indices);
+        ReleaseStream(release->faceMaterials);
+    }
+    if (validate && triangleEnd > 0 && largestIndex >= vertexCount) {
+        LOG_ERROR("Validation failed: " + meshName + ": triangle index " +
+                  std::to_string(static_cast<int32_t>(largestIndex)) + " out of range (" +
+                  std::to_string(vertexCount) + " vertices)");
+        fbxMesh->Destroy();
+        return nullptr;
+    }
 
     // Add normals if available
-    if (!meshData.vertices.empty() && meshData.vertices[0].normal.x != 0.0f ||
-        meshData.vertices[0].normal.y != 0.0f || meshData.vertices[0].normal.z != 0.0f) {
-
+    if (meshData.HasNormals()) {
         FbxGeometryElementNormal* normalElement = fbxMesh->CreateElementNormal();
         normalElement->SetMappingMode(FbxGeometryElement::eByControlPoint);
         normalElement->SetReferenceMode(FbxGeometryElement::eDirect);
 
-        for (const auto& vertex : meshData.vertices) {
-            // Convert normal coordinates
-            FbxVector4 normal(vertex.normal.x, vertex.normal.z, -vertex.normal.y);
-            normalElement->GetDirectArray().Add(normal);
+        auto& normals = normalElement->GetDirectArray();
+        normals.Resize(static_cast<int>(meshData.normals.size()));
+        FbxVector4* normalData = normals.GetLocked(FbxLayerElementArray::eWriteLock);
+        if (convertAxes) {
+            CoordinateKernels::ConvertVectors4(meshData.normals.data(), meshData.normals.size(),
+                                               reinterpret_cast<double*>(normalData));
+        } else {
+            for (size_t i = 0; i < meshData.normals.size(); ++i) {
+                const XVector3& normal = meshData.normals[i];
+                normalData[i] = FbxVector4(normal.x, normal.y, normal.z, 1.0);
+            }
         }
+        normals.Release(&normalData);
+    }
+    if (release) {
+        ReleaseStream(release->normals);
     }
 
     // Add UVs if available
-    if (!meshData.vertices.empty() && (meshData.vertices[0].texCoord.u != 0.0f ||
-        meshData.vertices[0].texCoord.v != 0.0f)) {
-
+    if (meshData.HasTexCoords()) {
         FbxGeometryElementUV* uvElement = fbxMesh->CreateElementUV("UVSet");
         uvElement->SetMappingMode(FbxGeometryElement::eByControlPoint);
         uvElement->SetReferenceMode(FbxGeometryElement::eDirect);
 
-        for (const auto& vertex : meshData.vertices) {
-            FbxVector2 uv(vertex.texCoord.u, 1.0 - vertex.texCoord.v); // Flip V coordinate
-            uvElement->GetDirectArray().Add(uv);
+        auto& uvs = uvElement->GetDirectArray();
+        uvs.Resize(static_cast<int>(meshData.texCoords.size()));
+        for (size_t i = 0; i < meshData.texCoords.size(); ++i) {
+            const XVector2& uv = meshData.texCoords[i];
+            uvs.SetAt(static_cast<int>(i), FbxVector2(uv.u, 1.0 - uv.v)); // Flip V coordinate
         }
     }
+    if (release) {
+        ReleaseStream(release->texCoords);
+    }
 
     LOG_INFO("Created FBX mesh '" + meshName + "' with " +
-             std::to_string(meshData.vertices.size()) + " vertices and " +
-             std::to_string(meshData.faces.size()) + " faces");
+             std::to_string(vertexCount) + " vertices and " +
+             std::to_string(faceCount) + " faces");
 
     return fbxMesh;
 }
 
-std::vector<FbxSurfacePhong*> FBXExporter::ConvertMaterials(const XMeshData& meshData) {
+std::vector<FbxSurfacePhong*> FBXExporter::ConvertMaterials(const XMeshData& meshData, const FBXExportOptions& options) {
     std::vector<FbxSurfacePhong*> fbxMaterials;
 
     for (size_t i = 0; i < meshData.materials.size(); ++i) {
@@ -725,20 +1114,21 @@ std::vector<FbxSurfacePhong*> FBXExporter::ConvertMaterials(const XMeshData& mes
         fbxMaterial->Shininess.Set(xMaterial.shininess);
         fbxMaterial->TransparencyFactor.Set(xMaterial.transparency);
 
-        // Add texture if available
-        if (!xMaterial.diffuseTexture.empty()) {
-            FbxFileTexture* texture = FbxFileTexture::Create(fbxScene_, (materialName + "_texture").c_str());
-            texture->SetFileName(xMaterial.diffuseTexture.c_str());
-            texture->SetTextureUse(FbxTexture::eStandard);
-            texture->SetMappingType(FbxTexture::eUV);
-            texture->SetMaterialUse(FbxFileTexture::eModelMaterial);
-            texture->SetSwapUV(false);
-            texture->SetTranslation(0.0, 0.0);
-            texture->SetScale(1.0, 1.0);
-            texture->SetRotation(0.0, 0.0);
-
-            // Connect texture to material
-            fbxMaterial->Diffuse.ConnectSrcObject(texture);
+        if (options.exportTextures) {
+            const struct { const std::string& path; const char* suffix; FbxProperty& property; } slots[] = {
+                {xMaterial.diffuseTexture, "_texture", fbxMaterial->Diffuse},
+                {xMaterial.normalTexture, "_normal", fbxMaterial->NormalMap},
+                {xMaterial.specularTexture, "_specular", fbxMaterial->Specular},
+            };
+            for (const auto& slot : slots) {
+                if (slot.path.empty()) {
+                    continue;
+                }
+                std::shared_ptr<const TextureImage> image = options.textures ? options.textures->Get(slot.path) : nullptr;
+                FbxFileTexture* texture = CreateFBXTexture(image && image->IsResolved() ? image->resolvedPath : slot.path);
+                texture->SetName((materialName + slot.suffix).c_str());
+                slot.property.ConnectSrcObject(texture);
+            }
         }
 
         fbxMaterials.push_back(fbxMaterial);
@@ -748,7 +1138,21 @@ std::vector<FbxSurfacePhong*> FBXExporter::ConvertMaterials(const XMeshData& mes
     return fbxMaterials;
 }
 
-bool FBXExporter::ApplySkinWeights(const XMeshData& meshData, FbxMesh* fbxMesh) {
+FbxFileTexture* FBXExporter::CreateFBXTexture(const std::string& texturePath) {
+    FbxFileTexture* texture = FbxFileTexture::Create(fbxScene_, "");
+    texture->SetFileName(texturePath.c_str());
+    texture->SetTextureUse(FbxTexture::eStandard);
+    texture->SetMappingType(FbxTexture::eUV);
+    texture->SetMaterialUse(FbxFileTexture::eModelMaterial);
+    texture->SetSwapUV(false);
+    texture->SetTranslation(0.0, 0.0);
+    texture->SetScale(1.0, 1.0);
+    texture->SetRotation(0.0, 0.0);
+    return texture;
+}
+
+bool FBXExporter::ApplySkinWeights(const XMeshData& meshData, FbxMesh* fbxMesh, size_t threads) {
+    TIME_OPERATION("ApplySkinWeights");
     if (meshData.bones.empty() || !fbxMesh) {
         return false;
     }
@@ -762,46 +1166,64 @@ bool FBXExporter::ApplySkinWeights(const XMeshData& meshData, FbxMesh* fbxMesh)
         return false;
     }
 
-    // Create clusters for each bone
-    for (const auto& bone : meshData.bones) {
-        FbxCluster* cluster = FbxCluster::Create(fbxScene_, (bone.name + "_cluster").c_str());
-        if (!cluster) {
-            LOG_WARNING("Failed to create cluster for bone: " + bone.name);
+    // One pass over the vertices groups every influence under its bone
+    FBXUtils::SkinClusters influences;
+    FBXUtils::BuildSkinClusters(meshData, influences);
+    timer.AddBytes(influences.controlPoints.size() * (sizeof(int) + sizeof(double)));
+
+    // SDK objects are created on this thread; each cluster is sized here
+    const FBXUtils::SkeletonPose* pose = GetSkeletonPose();
+    std::vector<FbxCluster*> clusters(meshData.bones.size(), nullptr);
+    for (size_t boneIndex = 0; boneIndex < meshData.bones.size(); ++boneIndex) {
+        const std::string& boneName = meshData.GetBoneName(boneIndex);
+        FbxNode* boneNode = boneIndex < boneNodes_.size() ? boneNodes_[boneIndex] : nullptr;
+        if (!boneNode) {
             continue;
         }
 
-        // Find corresponding bone node
-        auto it = boneNodeMap_.find(bone.name);
-        if (it != boneNodeMap_.end()) {
-            cluster->SetLink(it->second);
-            cluster->SetLinkMode(FbxCluster::eTotalOne);
-
-            // Add vertex weights from vertex bone data
-            for (size_t vertexIndex = 0; vertexIndex < meshData.vertices.size(); ++vertexIndex) {
-                const auto& vertex = meshData.vertices[vertexIndex];
-
-                // Find if this vertex has weight for this bone
-                for (size_t weightIndex = 0; weightIndex < vertex.boneIndices.size(); ++weightIndex) {
-                    if (weightIndex < vertex.boneWeights.size() &&
-                        vertex.boneIndices[weightIndex] == static_cast<int>(&bone - &meshData.bones[0]) &&
-                        vertex.boneWeights[weightIndex] > 0.0f) {
-                        cluster->AddControlPointIndex(static_cast<int>(vertexIndex), vertex.boneWeights[weightIndex]);
-                    }
-                }
-            }
-
-            skin->AddCluster(cluster);
+        FbxCluster* cluster = FbxCluster::Create(fbxScene_, (boneName + "_cluster").c_str());
+        if (!cluster) {
+            LOG_WARNING("Failed to create cluster for bone: " + boneName);
+            continue;
+        }
+        cluster->SetLink(boneNode);
+        cluster->SetLinkMode(FbxCluster::eTotalOne);
+        if (pose) {
+            // The mesh sits at the scene root, untransformed
+            FbxAMatrix meshTransform;
+            meshTransform.SetIdentity();
+            cluster->SetTransformMatrix(meshTransform);
+            cluster->SetTransformLinkMatrix(ToFbxMatrix(pose->world[boneIndex]));
         }
+        cluster->SetControlPointIWCount(static_cast<int>(influences.GetInfluenceCount(boneIndex)));
+        skin->AddCluster(cluster);
+        clusters[boneIndex] = cluster;
     }
 
+    // Filling a cluster only touches its own index and weight arrays, so
+    // clusters are filled in parallel
+    threads = ParallelUtils::ResolveThreadCount(threads, clusters.size());
+    ParallelUtils::ParallelFor(clusters.size(), threads, [&](size_t boneIndex, size_t) {
+        FbxCluster* cluster = clusters[boneIndex];
+        const size_t count = influences.GetInfluenceCount(boneIndex);
+        if (!cluster || count == 0) {
+            return;
+        }
+        const size_t begin = influences.offsets[boneIndex];
+        std::copy_n(influences.controlPoints.data() + begin, count, cluster->GetControlPointIndices());
+        std::copy_n(influences.weights.data() + begin, count, cluster->GetControlPointWeights());
+    });
+
     // Add skin to mesh
     fbxMesh->AddDeformer(skin);
 
-    LOG_INFO("Applied skin weights successfully");
+    LOG_INFO("Applied " + std::to_string(influences.controlPoints.size()) + " skin weights successfully");
     return true;
 }
 
-bool FBXExporter::CreateAnimation(const XAnimationSet& animation, float frameRate) {
+bool FBXExporter::CreateAnimation(const XAnimationSet& animation, float frameRate, bool convertAxes,
+                                  FbxAnimStack** createdStack) {
+    TIME_OPERATION("CreateAnimation");
     // Suppress unused parameter warning
     (void)frameRate;
 
@@ -828,6 +1250,9 @@ bool FBXExporter::CreateAnimation(const XAnimationSet& animation, float frameRat
     }
 
     animStack->AddMember(animLayer);
+    if (createdStack) {
+        *createdStack = animStack;
+    }
 
     // Set animation time span
     FbxTime startTime, endTime;
@@ -837,85 +1262,42 @@ bool FBXExporter::CreateAnimation(const XAnimationSet& animation, float frameRat
     FbxTimeSpan timeSpan(startTime, endTime);
     animStack->SetLocalTimeSpan(timeSpan);
 
-    // Create keyframes for each bone
-    for (const auto& boneAnim : animation.boneKeyframes) {
-        auto it = boneNodeMap_.find(boneAnim.first);
-        if (it == boneNodeMap_.end()) {
-            LOG_WARNING("Bone not found for animation: " + boneAnim.first);
+    // Create keyframes for each bone. Scratch arrays are reused across bones.
+    FBXUtils::CurveChannels channels;
+    std::vector<FbxTime> keyTimes;
+    for (const auto& track : animation.tracks) {
+        if (track.boneId < 0) {
+            continue;   // Keys without a target frame
+        }
+        if (track.boneId >= static_cast<int>(boneNodes_.size()) || !boneNodes_[track.boneId]) {
+            LOG_WARNING("Bone not found for animation track: bone id " + std::to_string(track.boneId));
             continue;
         }
 
-        FbxNode* boneNode = it->second;
-        const auto& keyframes = boneAnim.second;
-
-        // Create animation curves
-        FbxAnimCurve* translationCurveX = boneNode->LclTranslation.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_X, true);
-        FbxAnimCurve* translationCurveY = boneNode->LclTranslation.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_Y, true);
-        FbxAnimCurve* translationCurveZ = boneNode->LclTranslation.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_Z, true);
-
-        FbxAnimCurve* rotationCurveX = boneNode->LclRotation.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_X, true);
-        FbxAnimCurve* rotationCurveY = boneNode->LclRotation.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_Y, true);
-        FbxAnimCurve* rotationCurveZ = boneNode->LclRotation.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_Z, true);
-
-        FbxAnimCurve* scaleCurveX = boneNode->LclScaling.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_X, true);
-        FbxAnimCurve* scaleCurveY = boneNode->LclScaling.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_Y, true);
-        FbxAnimCurve* scaleCurveZ = boneNode->LclScaling.GetCurve(animLayer, FBXSDK_CURVENODE_COMPONENT_Z, true);
-
-        // Add keyframes
-        for (const auto& keyframe : keyframes) {
-            FbxTime fbxTime;
-            fbxTime.SetSecondDouble(keyframe.time);
-
-            // Translation
-            if (translationCurveX && translationCurveY && translationCurveZ) {
-                int keyIndex;
-                keyIndex = translationCurveX->KeyAdd(fbxTime);
-                translationCurveX->KeySetValue(keyIndex, static_cast<float>(keyframe.position.x));
-                translationCurveX->KeySetInterpolation(keyIndex, FbxAnimCurveDef::eInterpolationLinear);
-
-                keyIndex = translationCurveY->KeyAdd(fbxTime);
-                translationCurveY->KeySetValue(keyIndex, static_cast<float>(keyframe.position.z));
-                translationCurveY->KeySetInterpolation(keyIndex, FbxAnimCurveDef::eInterpolationLinear);
-
-                keyIndex = translationCurveZ->KeyAdd(fbxTime);
-                translationCurveZ->KeySetValue(keyIndex, static_cast<float>(-keyframe.position.y));
-                translationCurveZ->KeySetInterpolation(keyIndex, FbxAnimCurveDef::eInterpolationLinear);
+        FbxNode* boneNode = boneNodes_[track.boneId];
+        FBXUtils::BuildCurveChannels(track, animation.ticksPerSecond, channels, convertAxes);
+
+        FbxProperty* properties[FBXUtils::CurveChannels::TRANSFORM_COUNT] = {
+            &boneNode->LclTranslation, &boneNode->LclRotation, &boneNode->LclScaling
+        };
+        const char* components[3] = {
+            FBXSDK_CURVENODE_COMPONENT_X, FBXSDK_CURVENODE_COMPONENT_Y, FBXSDK_CURVENODE_COMPONENT_Z
+        };
+        for (int transform = 0; transform < FBXUtils::CurveChannels::TRANSFORM_COUNT; ++transform) {
+            const std::vector<double>& times = channels.times[transform];
+            if (times.empty()) {
+                continue;   // Channel not keyed; the node keeps its bind transform
             }
 
-            // Rotation (convert quaternion to Euler)
-            if (rotationCurveX && rotationCurveY && rotationCurveZ) {
-                // Simple quaternion to Euler conversion (simplified)
-                FbxVector4 euler = FbxQuaternion(keyframe.rotation.x, keyframe.rotation.z,
-                                               -keyframe.rotation.y, keyframe.rotation.w).DecomposeSphericalXYZ();
-
-                int keyIndex;
-                keyIndex = rotationCurveX->KeyAdd(fbxTime);
-                rotationCurveX->KeySetValue(keyIndex, static_cast<float>(euler[0] * 180.0 / 3.14159));
-                rotationCurveX->KeySetInterpolation(keyIndex, FbxAnimCurveDef::eInterpolationLinear);
-
-                keyIndex = rotationCurveY->KeyAdd(fbxTime);
-                rotationCurveY->KeySetValue(keyIndex, static_cast<float>(euler[1] * 180.0 / 3.14159));
-                rotationCurveY->KeySetInterpolation(keyIndex, FbxAnimCurveDef::eInterpolationLinear);
-
-                keyIndex = rotationCurveZ->KeyAdd(fbxTime);
-                rotationCurveZ->KeySetValue(keyIndex, static_cast<float>(euler[2] * 180.0 / 3.14159));
-                rotationCurveZ->KeySetInterpolation(keyIndex, FbxAnimCurveDef::eInterpolationLinear);
+            keyTimes.resize(times.size());
+            for (size_t i = 0; i < keyTimes.size(); ++i) {
+                keyTimes[i].SetSecondDouble(times[i]);
             }
-
-            // Scaling
-            if (scaleCurveX && scaleCurveY && scaleCurveZ) {
-                int keyIndex;
-                keyIndex = scaleCurveX->KeyAdd(fbxTime);
-                scaleCurveX->KeySetValue(keyIndex, static_cast<float>(keyframe.scale.x));
-                scaleCurveX->KeySetInterpolation(keyIndex, FbxAnimCurveDef::eInterpolationLinear);
-
-                keyIndex = scaleCurveY->KeyAdd(fbxTime);
-                scaleCurveY->KeySetValue(keyIndex, static_cast<float>(keyframe.scale.z));
-                scaleCurveY->KeySetInterpolation(keyIndex, FbxAnimCurveDef::eInterpolationLinear);
-
-                keyIndex = scaleCurveZ->KeyAdd(fbxTime);
-                scaleCurveZ->KeySetValue(keyIndex, static_cast<float>(keyframe.scale.y));
-                scaleCurveZ->KeySetInterpolation(keyIndex, FbxAnimCurveDef::eInterpolationLinear);
+            for (int axis = 0; axis < 3; ++axis) {
+                FbxAnimCurve* curve = properties[transform]->GetCurve(animLayer, components[axis], true);
+                if (curve) {
+                    EmitCurve(curve, keyTimes, channels.values[transform * 3 + axis]);
+                }
             }
         }
     }
@@ -1017,4 +1399,344 @@ std::string FBXExporter::GetFBXSDKVersion() {
 #endif
 }
 
+FBXExportOptions::Backend FBXExporter::ResolveBackend(const FBXExportOptions& options) {
+    if (options.backend != FBXExportOptions::Backend::AUTO) {
+        return options.backend;
+    }
+    return IsFBXSDKAvailable() ? FBXExportOptions::Backend::FBX_SDK : FBXExportOptions::Backend::NATIVE;
+}
+
+FBXExportResult FBXExporter::ExportNative(const XMeshData& meshData, const std::string& meshName, bool exportSkeleton,
+                                          const std::vector<const XAnimationSet*>& animations,
+                                          const std::string& outputPath, const FBXExportOptions& options) const {
+    FBXExportResult result;
+    result.outputPath = outputPath;
+
+    if (options.fileFormat == FBXExportOptions::FileFormat::ASCII) {
+        LOG_WARNING("The native FBX writer only writes binary files: " + outputPath);
+    }
+
+    NativeFBXScene scene;
+    scene.mesh = &meshData;
+    scene.meshName = meshName;
+    scene.exportMaterials = options.exportMaterials;
+    scene.exportTextures = options.exportTextures;
+    scene.textures = options.textures.get();
+    scene.embedTextures = options.embedTextures;
+    scene.reverseWinding = options.reverseWinding;
+    scene.convertAxes = options.convertCoordinateSystem && options.flipYZ;
+    scene.validate = options.validation != FBXExportOptions::Validation::NONE;
+    scene.frameRate = options.animationFrameRate;
+
+    FBXUtils::SkeletonPose ownedPose;
+    if (exportSkeleton && !meshData.bones.empty()) {
+        scene.pose = sharedPose_;
+        if (!scene.pose) {
+            if (FBXUtils::BuildSkeletonPose(meshData, ownedPose, scene.convertAxes)) {
+                scene.pose = &ownedPose;
+            } else {
+                LOG_ERROR("Bones are not stored parents first; skeleton not created");
+            }
+        }
+        scene.exportSkeleton = scene.pose != nullptr;
+    }
+    if (scene.exportSkeleton) {
+        scene.animations = animations;
+    }
+
+    NativeFBXWriter writer;
+    writer.SetCompression(options.compressArrays, options.compressionLevel, options.compressionThreads);
+    writer.SetOutputWriter(options.outputWriter);
+    if (!writer.Write(scene, outputPath)) {
+        result.errorMessage = writer.GetError();
+        LOG_ERROR("Failed to export FBX file: " + result.errorMessage);
+        return result;
+    }
+    if (!CheckWrittenFile(outputPath, options, result.errorMessage)) {
+        return result;
+    }
+
+    result.success = true;
+    result.verticesExported = static_cast<int>(meshData.GetVertexCount());
+    result.facesExported = static_cast<int>(meshData.GetFaceCount());
+    result.materialsExported = options.exportMaterials ? static_cast<int>(meshData.materials.size()) : 0;
+    result.bonesExported = scene.exportSkeleton ? static_cast<int>(meshData.bones.size()) : 0;
+    result.animationsExported = static_cast<int>(scene.animations.size());
+
+    LOG_INFO("FBX file exported successfully: " + outputPath + " (" +
+             std::to_string(writer.GetBytesWritten()) + " bytes)");
+    return result;
+}
+
+bool FBXExporter::ValidateExportedFile(const std::string& filePath) const {
+    FBXUtils::FBXFileCheck check = FBXUtils::CheckFBXFile(filePath);
+    if (!check.valid) {
+        LOG_ERROR("FBX validation failed for " + filePath + ": " + check.error);
+        return false;
+    }
+    LOG_DEBUG("FBX file valid: " + filePath + " (" + std::to_string(check.geometries) + " geometries, " +
+              std::to_string(check.polygons) + " polygons)");
+    return true;
+}
+
+bool FBXExporter::CheckWrittenFile(const std::string& outputPath, const FBXExportOptions& options,
+                                   std::string& error) const {
+    if (options.validation != FBXExportOptions::Validation::FULL) {
+        return true;
+    }
+    if (options.validator) {
+        options.validator->Submit(outputPath, options.outputWriter);
+        return true;
+    }
+    if (options.outputWriter) {
+        options.outputWriter->Flush();   // The file may still be queued
+    }
+    FBXUtils::FBXFileCheck check = FBXUtils::CheckFBXFile(outputPath);
+    if (!check.valid) {
+        error = "Validation failed: " + check.error;
+        LOG_ERROR("FBX validation failed for " + outputPath + ": " + check.error);
+        return false;
+    }
+    return true;
+}
+
+namespace FBXUtils {
+
+void BuildCurveChannels(const XBoneTrack& track, float ticksPerSecond, CurveChannels& channels, bool convertAxes) {
+    const double secondsPerTick = ticksPerSecond > 0.0f ? 1.0 / ticksPerSecond : 0.0;
+    const XAnimationChannel* sources[CurveChannels::TRANSFORM_COUNT] = {
+        &track.translation, &track.rotation, &track.scale
+    };
+    for (int transform = 0; transform < CurveChannels::TRANSFORM_COUNT; ++transform) {
+        const std::vector<float>& ticks = sources[transform]->times;
+        std::vector<double>& times = channels.times[transform];
+        times.resize(ticks.size());
+        for (size_t i = 0; i < ticks.size(); ++i) {
+            times[i] = ticks[i] * secondsPerTick;
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            channels.values[transform * 3 + axis].resize(ticks.size());
+        }
+    }
+
+    // DirectX is left-handed Y-up: (x, y, z) -> (x, z, -y); scale only swaps
+    const size_t rotationKeys = track.rotation.GetKeyCount();
+    channels.quaternions.resize(rotationKeys * XBoneTrack::ROTATION_COMPONENTS);
+    if (convertAxes) {
+        CoordinateKernels::SplitVectorKeys(track.translation.values.data(), track.translation.GetKeyCount(),
+                                           channels.values[CurveChannels::TX].data(),
+                                           channels.values[CurveChannels::TY].data(),
+                                           channels.values[CurveChannels::TZ].data(), true);
+        CoordinateKernels::SplitVectorKeys(track.scale.values.data(), track.scale.GetKeyCount(),
+                                           channels.values[CurveChannels::SX].data(),
+                                           channels.values[CurveChannels::SY].data(),
+                                           channels.values[CurveChannels::SZ].data(), false);
+
+        // Same swap for the rotation axis, normalized
+        CoordinateKernels::ConvertQuaternions(track.rotation.values.data(), rotationKeys,
+                                              channels.quaternions.data());
+    } else {
+        const XAnimationChannel* vectors[2] = {&track.translation, &track.scale};
+        const int firstChannels[2] = {CurveChannels::TX, CurveChannels::SX};
+        for (int v = 0; v < 2; ++v) {
+            const float* xyz = vectors[v]->values.data();
+            for (size_t i = 0; i < vectors[v]->GetKeyCount(); ++i, xyz += XBoneTrack::VECTOR_COMPONENTS) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    channels.values[firstChannels[v] + axis][i] = xyz[axis];
+                }
+            }
+        }
+
+        // Normalized only; zero quaternions become the identity
+        const float* source = track.rotation.values.data();
+        float* target = channels.quaternions.data();
+        for (size_t i = 0; i < rotationKeys; ++i, source += XBoneTrack::ROTATION_COMPONENTS,
+             target += XBoneTrack::ROTATION_COMPONENTS) {
+            const float length = std::sqrt(source[0] * source[0] + source[1] * source[1] +
+                                           source[2] * source[2] + source[3] * source[3]);
+            for (int c = 0; c < 4; ++c) {
+                target[c] = length > 0.0f ? source[c] / length : (c == 3 ? 1.0f : 0.0f);
+            }
+        }
+    }
+
+    // XYZ Euler angles (R = Rz * Ry * Rx) from the rotation matrix of the
+    // unit quaternion
+
+    const float radiansToDegrees = 180.0f / 3.14159265358979f;
+    const float* rotation = channels.quaternions.data();
+    float* rx = channels.values[CurveChannels::RX].data();
+    float* ry = channels.values[CurveChannels::RY].data();
+    float* rz = channels.values[CurveChannels::RZ].data();
+    for (size_t i = 0; i < rotationKeys; ++i, rotation += XBoneTrack::ROTATION_COMPONENTS) {
+        const float qx = rotation[0];
+        const float qy = rotation[1];
+        const float qz = rotation[2];
+        const float qw = rotation[3];
+
+        float m00 = 1.0f - 2.0f * (qy * qy + qz * qz);
+        float m10 = 2.0f * (qx * qy + qw * qz);
+        float m20 = 2.0f * (qx * qz - qw * qy);
+        float m21 = 2.0f * (qy * qz + qw * qx);
+        float m22 = 1.0f - 2.0f * (qx * qx + qy * qy);
+
+        float sinY = std::max(-1.0f, std::min(1.0f, -m20));
+        if (std::fabs(sinY) < 0.99999f) {
+            rx[i] = std::atan2(m21, m22) * radiansToDegrees;
+            ry[i] = std::asin(sinY) * radiansToDegrees;
+            rz[i] = std::atan2(m10, m00) * radiansToDegrees;
+        } else {
+            // Gimbal lock: fold the Z rotation into X
+            float m11 = 1.0f - 2.0f * (qx * qx + qz * qz);
+            float m12 = 2.0f * (qy * qz - qw * qx);
+            rx[i] = std::atan2(-m12, m11) * radiansToDegrees;
+            ry[i] = std::asin(sinY) * radiansToDegrees;
+            rz[i] = 0.0f;
+        }
+    }
+}
+
+XVector3 DirectXToFBXPosition(const XVector3& dxPos) {
+    return XVector3(dxPos.x, dxPos.z, -dxPos.y);
+}
+
+XQuaternion DirectXToFBXRotation(const XQuaternion& dxRot) {
+    const float source[4] = {dxRot.x, dxRot.y, dxRot.z, dxRot.w};
+    float converted[4];
+    CoordinateKernels::ConvertQuaternions(source, 1, converted);
+    return XQuaternion(converted[0], converted[1], converted[2], converted[3]);
+}
+
+XMatrix4x4 DirectXToFBXMatrix(const XMatrix4x4& dxMatrix) {
+    // The basis change of positions, (x, y, z) -> (x, z, -y), as a row
+    // vector transform B; a DirectX transform M becomes B^T * M * B
+    XMatrix4x4 converted;
+    CoordinateKernels::ConvertMatrices(&dxMatrix, 1, &converted);
+    return converted;
+}
+
+void DecomposeMatrix(const XMatrix4x4& matrix, XVector3& translation, XVector3& rotation, XVector3& scale) {
+    const float (*m)[4] = matrix.m;
+    translation = XVector3(m[3][0], m[3][1], m[3][2]);
+
+    // Row k is the image of axis k, so its length is the scale along k
+    double s[3];
+    for (int row = 0; row < 3; ++row) {
+        s[row] = std::sqrt(static_cast<double>(m[row][0]) * m[row][0] +
+                           static_cast<double>(m[row][1]) * m[row][1] +
+                           static_cast<double>(m[row][2]) * m[row][2]);
+    }
+    scale = XVector3(static_cast<float>(s[0]), static_cast<float>(s[1]), static_cast<float>(s[2]));
+
+    // The column-vector rotation R = Rz * Ry * Rx, R[r][c] = m[c][r] / s[c]
+    auto r = [&](int row, int column) {
+        return s[column] > 0.0 ? m[column][row] / s[column] : (row == column ? 1.0 : 0.0);
+    };
+    const double radiansToDegrees = 180.0 / 3.14159265358979323846;
+    double sinY = std::max(-1.0, std::min(1.0, -r(2, 0)));
+    double rx, rz;
+    if (std::fabs(sinY) < 0.99999) {
+        rx = std::atan2(r(2, 1), r(2, 2));
+        rz = std::atan2(r(1, 0), r(0, 0));
+    } else {
+        // Gimbal lock: fold the Z rotation into X
+        rx = std::atan2(-r(1, 2), r(1, 1));
+        rz = 0.0;
+    }
+    rotation = XVector3(static_cast<float>(rx * radiansToDegrees),
+                        static_cast<float>(std::asin(sinY) * radiansToDegrees),
+                        static_cast<float>(rz * radiansToDegrees));
+}
+
+XMatrix4x4 InvertAffineMatrix(const XMatrix4x4& matrix) {
+    // [A 0; t 1]^-1 = [A^-1 0; -t A^-1 1], A^-1 from the cofactors of A
+    const float (*m)[4] = matrix.m;
+    double cofactor[3][3];
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            int r0 = (row + 1) % 3, r1 = (row + 2) % 3;
+            int c0 = (column + 1) % 3, c1 = (column + 2) % 3;
+            cofactor[row][column] = static_cast<double>(m[r0][c0]) * m[r1][c1] -
+                                    static_cast<double>(m[r0][c1]) * m[r1][c0];
+        }
+    }
+    double determinant = m[0][0] * cofactor[0][0] + m[0][1] * cofactor[0][1] + m[0][2] * cofactor[0][2];
+    if (std::fabs(determinant) < 1e-12) {
+        return XMatrix4x4::Identity();
+    }
+
+    XMatrix4x4 inverse;
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            inverse.m[row][column] = static_cast<float>(cofactor[column][row] / determinant);
+        }
+    }
+    for (int column = 0; column < 3; ++column) {
+        inverse.m[3][column] = -(m[3][0] * inverse.m[0][column] + m[3][1] * inverse.m[1][column] +
+                                 m[3][2] * inverse.m[2][column]);
+    }
+    inverse.m[3][3] = 1.0f;
+    return inverse;
+}
+
+bool BuildSkeletonPose(const XMeshData& meshData, SkeletonPose& pose, bool convertAxes) {
+    std::vector<XMatrix4x4> world;
+    if (!meshData.ComputeBoneWorldMatrices(world)) {
+        return false;
+    }
+
+    // The basis change commutes with the hierarchy product, so local and
+    // world matrices convert independently
+    pose.local.resize(meshData.bones.size());
+    pose.world.resize(meshData.bones.size());
+    for (size_t i = 0; i < meshData.bones.size(); ++i) {
+        pose.local[i] = meshData.bones[i].bindPose;
+    }
+    if (convertAxes) {
+        CoordinateKernels::ConvertMatrices(pose.local.data(), pose.local.size(), pose.local.data());
+        CoordinateKernels::ConvertMatrices(world.data(), world.size(), pose.world.data());
+    } else {
+        pose.world = std::move(world);
+    }
+    return true;
+}
+
+void BuildSkinClusters(const XMeshData& meshData, SkinClusters& clusters) {
+    const size_t boneCount = meshData.bones.size();
+    const int lastBone = static_cast<int>(boneCount) - 1;
+
+    // Counting sort: count each bone's influences, turn the counts into
+    // offsets, then scatter every (vertex, weight) pair into its bucket
+    clusters.offsets.assign(boneCount + 1, 0);
+    for (const XVertexInfluences& influences : meshData.skinInfluences) {
+        for (int k = 0; k < XVertexInfluences::MAX_INFLUENCES; ++k) {
+            int bone = influences.boneIndices[k];
+            if (bone >= 0 && bone <= lastBone && influences.boneWeights[k] > 0.0f) {
+                clusters.offsets[bone + 1]++;
+            }
+        }
+    }
+    for (size_t bone = 0; bone < boneCount; ++bone) {
+        clusters.offsets[bone + 1] += clusters.offsets[bone];
+    }
+
+    const size_t total = clusters.offsets[boneCount];
+    clusters.controlPoints.resize(total);
+    clusters.weights.resize(total);
+    std::vector<size_t> cursor(clusters.offsets.begin(), clusters.offsets.end() - 1);
+    for (size_t vertex = 0; vertex < meshData.skinInfluences.size(); ++vertex) {
+        const XVertexInfluences& influences = meshData.skinInfluences[vertex];
+        for (int k = 0; k < XVertexInfluences::MAX_INFLUENCES; ++k) {
+            int bone = influences.boneIndices[k];
+            if (bone >= 0 && bone <= lastBone && influences.boneWeights[k] > 0.0f) {
+                size_t slot = cursor[bone]++;
+                clusters.controlPoints[slot] = static_cast<int>(vertex);
+                clusters.weights[slot] = influences.boneWeights[k];
+            }
+        }
+    }
+}
+
+} // namespace FBXUtils
+
 } // namespace X2FBX
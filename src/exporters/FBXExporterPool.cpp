@@ -0,0 +1,74 @@
+#include "FBXExporterPool.h"
+
+namespace X2FBX {
+
+FBXExporterPool::Lease& FBXExporterPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        pool_ = other.pool_;
+        exporter_ = std::move(other.exporter_);
+    }
+    return *this;
+}
+
+void FBXExporterPool::Lease::Reset() {
+    if (exporter_ && pool_) {
+        pool_->Release(std::move(exporter_));
+    }
+    exporter_.reset();
+}
+
+FBXExporterPool::FBXExporterPool()
+    : hits_(0)
+    , misses_(0)
+    , sceneResets_(0) {
+}
+
+FBXExporterPool& FBXExporterPool::GetInstance() {
+    static FBXExporterPool instance;
+    return instance;
+}
+
+FBXExporterPool::Lease FBXExporterPool::Acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idle_.empty()) {
+            std::unique_ptr<FBXExporter> exporter = std::move(idle_.back());
+            idle_.pop_back();
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return Lease(this, std::move(exporter));
+        }
+    }
+
+    // Constructed outside the lock so workers starting together build
+    // their FBX managers in parallel
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return Lease(this, std::make_unique<FBXExporter>());
+}
+
+void FBXExporterPool::Release(std::unique_ptr<FBXExporter> exporter) {
+    // Drop what the last export left in the scene before anyone else sees it
+    exporter->ResetForReuse();
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.push_back(std::move(exporter));
+}
+
+void FBXExporterPool::Clear() {
+    std::vector<std::unique_ptr<FBXExporter>> released;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released.swap(idle_);
+    }
+}
+
+FBXExporterPoolStatistics FBXExporterPool::GetStatistics() const {
+    FBXExporterPoolStatistics statistics;
+    statistics.hits = hits_.load(std::memory_order_relaxed);
+    statistics.misses = misses_.load(std::memory_order_relaxed);
+    statistics.sceneResets = sceneResets_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics.idle = idle_.size();
+    return statistics;
+}
+
+} // namespace X2FBX
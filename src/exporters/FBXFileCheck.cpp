@@ -0,0 +1,385 @@
+#include "FBXExporter.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace X2FBX {
+
+namespace {
+
+// "Kaydara FBX Binary  ", NUL, 0x1a, NUL, then the version
+constexpr std::string_view BINARY_MAGIC("Kaydara FBX Binary  \0\x1a\0", 23);
+constexpr size_t HEADER_BYTES = 27;
+constexpr size_t FOOTER_TRAILER_BYTES = 4 + 120 + 16;   // Version, zeros, magic
+constexpr int MAX_DEPTH = 64;                           // Far deeper than any writer nests
+
+const uint8_t FOOTER_MAGIC[16] = {0xf8, 0x5a, 0x8c, 0x6a, 0xde, 0xf5, 0xd9, 0x7e,
+                                  0xec, 0xe9, 0x0c, 0xe3, 0x75, 0x8f, 0x29, 0x0b};
+
+// The arrays of one Geometry object the checks look at
+struct GeometryArrays {
+    std::vector<double> vertices;
+    std::vector<int32_t> indices;
+};
+
+// Walks a binary FBX document record by record. Every offset is checked
+// against the record that contains it before it is followed, so a
+// truncated or corrupted file fails with the first bad record instead of
+// reading out of bounds.
+class BinaryFBXReader {
+public:
+    BinaryFBXReader(ByteView bytes, FBXUtils::FBXFileCheck& check)
+        : bytes_(bytes), check_(check), wide_(false), geometryUnread_(false) {}
+
+    bool Read() {
+        check_.version = U32(HEADER_BYTES - 4);
+        wide_ = check_.version >= 7500;   // 64-bit record headers
+
+        size_t offset = HEADER_BYTES;
+        const size_t documentEnd = bytes_.size() - FOOTER_TRAILER_BYTES;
+        while (true) {
+            bool isNull = false;
+            if (!ReadRecord(offset, documentEnd, "", 0, nullptr, isNull)) {
+                return false;
+            }
+            if (isNull) {
+                break;
+            }
+            check_.topLevel++;
+        }
+
+        if (U32(bytes_.size() - FOOTER_TRAILER_BYTES) != check_.version) {
+            return Fail("Footer version does not match the header");
+        }
+        if (std::memcmp(bytes_.data() + bytes_.size() - sizeof(FOOTER_MAGIC), FOOTER_MAGIC,
+                        sizeof(FOOTER_MAGIC)) != 0) {
+            return Fail("Footer magic missing");
+        }
+        return true;
+    }
+
+private:
+    uint32_t U32(size_t offset) const {
+        return static_cast<uint32_t>(bytes_[offset]) | static_cast<uint32_t>(bytes_[offset + 1]) << 8 |
+               static_cast<uint32_t>(bytes_[offset + 2]) << 16 | static_cast<uint32_t>(bytes_[offset + 3]) << 24;
+    }
+    uint64_t U64(size_t offset) const {
+        return static_cast<uint64_t>(U32(offset)) | static_cast<uint64_t>(U32(offset + 4)) << 32;
+    }
+    uint64_t Offset(size_t offset) const { return wide_ ? U64(offset) : U32(offset); }
+
+    bool Fail(const std::string& error) {
+        if (check_.error.empty()) {
+            check_.error = error;
+        }
+        return false;
+    }
+
+    // One node record and its children, ending at or before limit. A null
+    // record (all zeros) closes the enclosing list.
+    bool ReadRecord(size_t& offset, size_t limit, const std::string& parent, int depth, GeometryArrays* geometry,
+                    bool& isNull) {
+        const size_t headerBytes = wide_ ? 25 : 13;
+        if (offset + headerBytes > limit) {
+            return Fail("Record list under " + (parent.empty() ? std::string("the document") : parent) +
+                        " is not terminated");
+        }
+        const uint64_t end = Offset(offset);
+        const uint64_t propertyCount = Offset(offset + (wide_ ? 8 : 4));
+        const uint64_t propertyBytes = Offset(offset + (wide_ ? 16 : 8));
+        const size_t nameLength = bytes_[offset + headerBytes - 1];
+        if (end == 0 && propertyCount == 0 && propertyBytes == 0 && nameLength == 0) {
+            offset += headerBytes;
+            isNull = true;
+            return true;
+        }
+
+        const size_t nameStart = offset + headerBytes;
+        if (end <= nameStart || end > limit || nameStart + nameLength > end) {
+            return Fail("Record at offset " + std::to_string(offset) + " ends outside its parent");
+        }
+        const std::string name(reinterpret_cast<const char*>(bytes_.data() + nameStart), nameLength);
+        if (depth > MAX_DEPTH) {
+            return Fail("Records nest deeper than " + std::to_string(MAX_DEPTH) + " at " + name);
+        }
+
+        const size_t propertiesStart = nameStart + nameLength;
+        const size_t propertiesEnd = propertiesStart + propertyBytes;
+        if (propertyBytes > end - propertiesStart) {
+            return Fail(name + ": properties run past the record");
+        }
+
+        // Geometry objects collect their arrays from their children
+        GeometryArrays ownArrays;
+        const bool isGeometry = name == "Geometry" && parent == "Objects";
+        if (isGeometry) {
+            geometryUnread_ = false;
+        }
+        GeometryArrays* arrays = isGeometry ? &ownArrays : geometry;
+        std::vector<double>* wantDoubles = arrays && name == "Vertices" ? &arrays->vertices : nullptr;
+        std::vector<int32_t>* wantInts = arrays && name == "PolygonVertexIndex" ? &arrays->indices : nullptr;
+
+        size_t cursor = propertiesStart;
+        for (uint64_t i = 0; i < propertyCount; ++i) {
+            if (!ReadProperty(cursor, propertiesEnd, name, i == 0 ? wantDoubles : nullptr, i == 0 ? wantInts : nullptr)) {
+                return false;
+            }
+        }
+        if (cursor != propertiesEnd) {
+            return Fail(name + ": property list length does not match its properties");
+        }
+
+        cursor = propertiesEnd;
+        while (cursor < end) {
+            bool childNull = false;
+            if (!ReadRecord(cursor, end, name, depth + 1, isGeometry ? &ownArrays : geometry, childNull)) {
+                return false;
+            }
+            if (childNull) {
+                break;
+            }
+        }
+        if (cursor != end) {
+            return Fail(name + ": children do not end with the record");
+        }
+
+        if (isGeometry && !CheckGeometry(ownArrays)) {
+            return false;
+        }
+        offset = end;
+        return true;
+    }
+
+    bool ReadProperty(size_t& offset, size_t limit, const std::string& node, std::vector<double>* doubles,
+                      std::vector<int32_t>* ints) {
+        if (offset >= limit) {
+            return Fail(node + ": property list truncated");
+        }
+        const char type = static_cast<char>(bytes_[offset++]);
+        size_t size = 0;
+        switch (type) {
+        case 'C': size = 1; break;
+        case 'Y': size = 2; break;
+        case 'I': case 'F': size = 4; break;
+        case 'D': case 'L': size = 8; break;
+        case 'S': case 'R':
+            if (offset + 4 > limit) {
+                return Fail(node + ": property list truncated");
+            }
+            size = 4 + static_cast<size_t>(U32(offset));
+            break;
+        case 'b': case 'i': case 'f': case 'd': case 'l':
+            return ReadArray(offset, limit, node, type, doubles, ints);
+        default:
+            return Fail(node + ": unknown property type " + std::to_string(static_cast<int>(type)));
+        }
+        if (size > limit - offset) {
+            return Fail(node + ": property runs past the record");
+        }
+        offset += size;
+        return true;
+    }
+
+    // Count, encoding (0 raw, 1 deflate), stored bytes, data. Every array
+    // is decoded so broken compressed data is caught, not only the arrays
+    // the geometry checks read.
+    bool ReadArray(size_t& offset, size_t limit, const std::string& node, char type, std::vector<double>* doubles,
+                   std::vector<int32_t>* ints) {
+        if (offset + 12 > limit) {
+            return Fail(node + ": array header truncated");
+        }
+        const uint64_t count = U32(offset);
+        const uint32_t encoding = U32(offset + 4);
+        const uint64_t stored = U32(offset + 8);
+        offset += 12;
+        if (stored > limit - offset) {
+            return Fail(node + ": array runs past the record");
+        }
+        const size_t elementBytes = type == 'b' ? 1 : type == 'i' || type == 'f' ? 4 : 8;
+        const uint64_t rawBytes = count * elementBytes;
+        const uint8_t* data = bytes_.data() + offset;
+        offset += stored;
+
+        if (encoding == 0) {
+            if (stored != rawBytes) {
+                return Fail(node + ": array holds " + std::to_string(stored) + " bytes for " +
+                            std::to_string(count) + " elements");
+            }
+        } else if (encoding == 1) {
+            if (rawBytes / 1032 > stored + 1) {
+                return Fail(node + ": deflated array claims more elements than deflate can encode");
+            }
+#ifdef HAVE_ZLIB
+            inflated_.resize(static_cast<size_t>(rawBytes));
+            uLongf produced = static_cast<uLongf>(rawBytes);
+            const int result = uncompress(inflated_.data(), &produced, data, static_cast<uLong>(stored));
+            if (result != Z_OK || produced != rawBytes) {
+                return Fail(node + ": deflated array does not inflate to " + std::to_string(count) + " elements");
+            }
+            data = inflated_.data();
+#else
+            // Cannot be read back without zlib; the record structure is still checked
+            geometryUnread_ = geometryUnread_ || doubles || ints;
+            return true;
+#endif
+        } else {
+            return Fail(node + ": unknown array encoding " + std::to_string(encoding));
+        }
+
+        if (doubles && (type == 'd' || type == 'f')) {
+            doubles->resize(static_cast<size_t>(count));
+            for (size_t i = 0; i < doubles->size(); ++i) {
+                if (type == 'd') {
+                    const uint64_t bits = static_cast<uint64_t>(data[i * 8]) | static_cast<uint64_t>(data[i * 8 + 1]) << 8 |
+                                          static_cast<uint64_t>(data[i * 8 + 2]) << 16 |
+                                          static_cast<uint64_t>(data[i * 8 + 3]) << 24 |
+                                          static_cast<uint64_t>(data[i * 8 + 4]) << 32 |
+                                          static_cast<uint64_t>(data[i * 8 + 5]) << 40 |
+                                          static_cast<uint64_t>(data[i * 8 + 6]) << 48 |
+                                          static_cast<uint64_t>(data[i * 8 + 7]) << 56;
+                    std::memcpy(&(*doubles)[i], &bits, sizeof(double));
+                } else {
+                    const uint32_t bits = static_cast<uint32_t>(data[i * 4]) | static_cast<uint32_t>(data[i * 4 + 1]) << 8 |
+                                          static_cast<uint32_t>(data[i * 4 + 2]) << 16 |
+                                          static_cast<uint32_t>(data[i * 4 + 3]) << 24;
+                    float value;
+                    std::memcpy(&value, &bits, sizeof(float));
+                    (*doubles)[i] = value;
+                }
+            }
+        }
+        if (ints && type == 'i') {
+            ints->resize(static_cast<size_t>(count));
+            for (size_t i = 0; i < ints->size(); ++i) {
+                const uint32_t bits = static_cast<uint32_t>(data[i * 4]) | static_cast<uint32_t>(data[i * 4 + 1]) << 8 |
+                                      static_cast<uint32_t>(data[i * 4 + 2]) << 16 |
+                                      static_cast<uint32_t>(data[i * 4 + 3]) << 24;
+                (*ints)[i] = static_cast<int32_t>(bits);
+            }
+        }
+        return true;
+    }
+
+    // Finite x, y, z control points; polygons of at least three in-range
+    // indices, the last of each stored as ~index
+    bool CheckGeometry(const GeometryArrays& arrays) {
+        const size_t geometry = check_.geometries++;
+        const std::string label = "Geometry " + std::to_string(geometry);
+        if (geometryUnread_) {
+            return true;
+        }
+        if (arrays.vertices.size() % 3 != 0) {
+            return Fail(label + ": " + std::to_string(arrays.vertices.size()) + " vertex components");
+        }
+        for (double component : arrays.vertices) {
+            if (!std::isfinite(component)) {
+                return Fail(label + ": non-finite vertex coordinate");
+            }
+        }
+        const size_t vertexCount = arrays.vertices.size() / 3;
+
+        size_t polygonSize = 0;
+        for (size_t i = 0; i < arrays.indices.size(); ++i) {
+            const int32_t stored = arrays.indices[i];
+            const uint32_t index = static_cast<uint32_t>(stored < 0 ? ~stored : stored);
+            if (index >= vertexCount) {
+                return Fail(label + ": polygon index " + std::to_string(index) + " out of range (" +
+                            std::to_string(vertexCount) + " vertices)");
+            }
+            polygonSize++;
+            if (stored < 0) {
+                if (polygonSize < 3) {
+                    return Fail(label + ": polygon with " + std::to_string(polygonSize) + " vertices");
+                }
+                check_.polygons++;
+                polygonSize = 0;
+            }
+        }
+        if (polygonSize != 0) {
+            return Fail(label + ": last polygon is not closed");
+        }
+        check_.vertices += vertexCount;
+        return true;
+    }
+
+    ByteView bytes_;
+    FBXUtils::FBXFileCheck& check_;
+    bool wide_;
+    bool geometryUnread_;             // A checked array of the current Geometry stayed deflated
+    std::vector<uint8_t> inflated_;   // Scratch reused across arrays
+};
+
+} // namespace
+
+namespace FBXUtils {
+
+FBXFileCheck CheckFBXFile(const std::string& filePath) {
+    TIME_OPERATION("CheckFBXFile");
+    FBXFileCheck check;
+    MappedFile file;
+    if (!file.Open(filePath)) {
+        check.error = "Cannot open " + filePath;
+        return check;
+    }
+    const ByteView bytes = file.View();
+    check.fileBytes = bytes.size();
+    timer.AddBytes(bytes.size());
+
+    if (bytes.StartsWith(BINARY_MAGIC)) {
+        check.binary = true;
+        if (bytes.size() < HEADER_BYTES + FOOTER_TRAILER_BYTES) {
+            check.error = "File too short for a binary FBX document";
+            return check;
+        }
+        check.valid = BinaryFBXReader(bytes, check).Read();
+        return check;
+    }
+
+    // ASCII files: "; FBX 7.4.0 project file" on the first line
+    if (bytes.StartsWith("; FBX ")) {
+        int major = 0, minor = 0, patch = 0;
+        std::istringstream header(std::string(bytes.Subview(6, 16).AsStringView()));
+        char dot;
+        if (header >> major >> dot >> minor >> dot >> patch) {
+            check.version = static_cast<uint32_t>(major * 1000 + minor * 100 + patch * 10);
+        }
+        check.valid = check.version > 0;
+        if (!check.valid) {
+            check.error = "Unreadable ASCII FBX header";
+        }
+        return check;
+    }
+
+    check.error = "Not an FBX file";
+    return check;
+}
+
+bool IsValidFBXFile(const std::string& filePath) {
+    return CheckFBXFile(filePath).valid;
+}
+
+std::string GetFBXFileInfo(const std::string& filePath) {
+    FBXFileCheck check = CheckFBXFile(filePath);
+    std::ostringstream info;
+    if (check.version > 0) {
+        info << "FBX " << check.version << (check.binary ? " binary" : " ASCII") << ", " << check.fileBytes << " bytes";
+    }
+    if (check.binary && check.valid) {
+        info << ", " << check.topLevel << " top-level records, " << check.geometries << " geometries, "
+             << check.vertices << " vertices, " << check.polygons << " polygons";
+    }
+    if (!check.valid) {
+        info << (check.version > 0 ? ": " : "") << check.error;
+    }
+    return info.str();
+}
+
+} // namespace FBXUtils
+
+} // namespace X2FBX
@@ -0,0 +1,1083 @@
+#include "NativeFBXWriter.h"
+#include "CoordinateKernels.h"
+#include "BatchPipeline.h"
+#include "FBXExporter.h"
+#include "Logger.h"
+#include "ParallelDeflate.h"
+#include "TextureLibrary.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string_view>
+
+namespace X2FBX {
+
+namespace {
+
+constexpr double KTIME_PER_SECOND = 46186158000.0;   // FBX time unit
+constexpr size_t NULL_RECORD_BYTES = 13;             // Header of a node record with no name
+constexpr size_t NPOS = static_cast<size_t>(-1);
+
+// "Kaydara FBX Binary  ", NUL, 0x1a, NUL
+const char BINARY_MAGIC[23] = {'K', 'a', 'y', 'd', 'a', 'r', 'a', ' ', 'F', 'B', 'X', ' ',
+                               'B', 'i', 'n', 'a', 'r', 'y', ' ', ' ', 0x00, 0x1a, 0x00};
+
+// Fixed file id, creation time and footer id: readers check the three
+// against each other, and fixed values keep the output deterministic
+const uint8_t FILE_ID[16] = {0x28, 0xb3, 0x2a, 0xeb, 0xb6, 0x24, 0xcc, 0xc2,
+                             0xbf, 0xc8, 0xb0, 0x2a, 0xa9, 0x2b, 0xfc, 0xf1};
+const uint8_t FOOTER_ID[16] = {0xfa, 0xbc, 0xab, 0x09, 0xd0, 0xc8, 0xd4, 0x66,
+                               0xb1, 0x76, 0xfb, 0x83, 0x1c, 0xf7, 0x26, 0x7e};
+const uint8_t FOOTER_MAGIC[16] = {0xf8, 0x5a, 0x8c, 0x6a, 0xde, 0xf5, 0xd9, 0x7e,
+                                  0xec, 0xe9, 0x0c, 0xe3, 0x75, 0x8f, 0x29, 0x0b};
+const char CREATION_TIME[] = "1970-01-01 10:00:00:000";
+const char CREATOR[] = "X2FBX Converter";
+
+// AnimationCurve key attributes shared by every key: linear interpolation
+const int32_t KEY_ATTR_FLAGS_LINEAR = 24836;
+const float KEY_ATTR_DATA[4] = {0.0f, 0.0f, 9.419963346924634e-30f, 0.0f};
+
+int64_t ToKTime(double seconds) {
+    return static_cast<int64_t>(std::llround(seconds * KTIME_PER_SECOND));
+}
+
+bool IsHostLittleEndian() {
+    const uint16_t probe = 1;
+    uint8_t first;
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+// FbxTime::EMode of a frame rate; anything else is eCustom with the rate
+// in CustomFrameRate
+int32_t TimeModeForFrameRate(float frameRate) {
+    struct Mode { float rate; int32_t mode; };
+    static const Mode modes[] = {
+        {120.0f, 1}, {100.0f, 2}, {60.0f, 3}, {50.0f, 4}, {48.0f, 5}, {30.0f, 6},
+        {25.0f, 10}, {24.0f, 11}, {1000.0f, 12}, {96.0f, 15}, {72.0f, 16}
+    };
+    for (const Mode& mode : modes) {
+        if (std::fabs(frameRate - mode.rate) < 1e-3f) {
+            return mode.mode;
+        }
+    }
+    return 14;
+}
+
+// FBX object names carry their class after a NUL, 0x01 separator
+std::string ObjectName(std::string_view name, const char* className) {
+    std::string result(name);
+    result.push_back('\0');
+    result.push_back('\x01');
+    result += className;
+    return result;
+}
+
+// A binary FBX document built in memory. Node records are emitted with a
+// placeholder header that End patches once the record's size is known;
+// properties of a node must all come before its first child.
+class NodeStream {
+public:
+    NodeStream(bool compressArrays, int level, size_t threads)
+        : little_(IsHostLittleEndian()), overflow_(false),
+          compress_(compressArrays && ParallelDeflate::IsAvailable()), level_(level), threads_(threads) {}
+
+    std::vector<uint8_t>& Bytes() { return out_; }
+    // Offsets and array lengths are 32 bits in FBX 7.4
+    bool Overflowed() const { return overflow_ || out_.size() > std::numeric_limits<uint32_t>::max(); }
+
+    void Begin(const char* name) {
+        if (!stack_.empty() && stack_.back().propertiesEnd == NPOS) {
+            stack_.back().propertiesEnd = out_.size();
+        }
+        OpenNode node;
+        node.start = out_.size();
+        out_.resize(out_.size() + 12, 0);
+        const size_t nameLength = std::strlen(name);
+        out_.push_back(static_cast<uint8_t>(nameLength));
+        Append(name, nameLength);
+        node.propertiesBegin = out_.size();
+        node.propertiesEnd = NPOS;
+        node.propertyCount = 0;
+        stack_.push_back(node);
+    }
+
+    void End() {
+        OpenNode node = stack_.back();
+        stack_.pop_back();
+        const bool hasChildren = node.propertiesEnd != NPOS;
+        if (!hasChildren) {
+            node.propertiesEnd = out_.size();
+        }
+        if (hasChildren || node.propertyCount == 0) {
+            out_.resize(out_.size() + NULL_RECORD_BYTES, 0);
+        }
+        Patch32(node.start, out_.size());
+        Patch32(node.start + 4, node.propertyCount);
+        Patch32(node.start + 8, node.propertiesEnd - node.propertiesBegin);
+    }
+
+    // The null record closing the top-level node list
+    void EndDocument() { out_.resize(out_.size() + NULL_RECORD_BYTES, 0); }
+
+    void Bool(bool value) { Property('C'); out_.push_back(value ? 1 : 0); }
+    void Int32(int32_t value) { Property('I'); Put(value); }
+    void Int64(int64_t value) { Property('L'); Put(value); }
+    void Double(double value) { Property('D'); Put(value); }
+    void String(std::string_view value) {
+        Property('S');
+        Put32(value.size());
+        Append(value.data(), value.size());
+    }
+    void Raw(const void* data, size_t size) {
+        Property('R');
+        Put32(size);
+        Append(data, size);
+    }
+
+    void Array(const int32_t* data, size_t count) { PutArray('i', data, count); }
+    void Array(const int64_t* data, size_t count) { PutArray('l', data, count); }
+    void Array(const float* data, size_t count) { PutArray('f', data, count); }
+    void Array(const double* data, size_t count) { PutArray('d', data, count); }
+
+    void Append(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out_.insert(out_.end(), bytes, bytes + size);
+    }
+
+    void Put32(uint64_t value) {
+        if (value > std::numeric_limits<uint32_t>::max()) {
+            overflow_ = true;
+        }
+        Put(static_cast<uint32_t>(value));
+    }
+
+private:
+    struct OpenNode {
+        size_t start;
+        size_t propertiesBegin;
+        size_t propertiesEnd;      // NPOS until the first child
+        uint32_t propertyCount;
+    };
+
+    void Property(char type) {
+        stack_.back().propertyCount++;
+        out_.push_back(static_cast<uint8_t>(type));
+    }
+
+    template <typename T>
+    void Put(T value) {
+        uint8_t bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        if (!little_) {
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+        Append(bytes, sizeof(T));
+    }
+
+    void Patch32(size_t offset, uint64_t value) {
+        if (value > std::numeric_limits<uint32_t>::max()) {
+            overflow_ = true;
+        }
+        uint32_t narrow = static_cast<uint32_t>(value);
+        uint8_t bytes[4];
+        std::memcpy(bytes, &narrow, 4);
+        if (!little_) {
+            std::reverse(bytes, bytes + 4);
+        }
+        std::memcpy(&out_[offset], bytes, 4);
+    }
+
+    // Count, encoding (0 raw, 1 deflate), stored bytes, data
+    template <typename T>
+    void PutArray(char type, const T* data, size_t count) {
+        Property(type);
+        Put32(count);
+
+        const size_t size = count * sizeof(T);
+        const uint8_t* raw = reinterpret_cast<const uint8_t*>(data);
+        if (!little_) {
+            swapped_.assign(raw, raw + size);
+            for (size_t i = 0; i < size; i += sizeof(T)) {
+                std::reverse(swapped_.begin() + i, swapped_.begin() + i + sizeof(T));
+            }
+            raw = swapped_.data();
+        }
+
+        if (compress_ && size >= NativeFBXWriter::COMPRESS_MIN_BYTES &&
+            ParallelDeflate::Compress(raw, size, level_, threads_, packed_) && packed_.size() < size) {
+            Put32(1);
+            Put32(packed_.size());
+            Append(packed_.data(), packed_.size());
+            return;
+        }
+        Put32(0);
+        Put32(size);
+        Append(raw, size);
+    }
+
+    std::vector<uint8_t> out_;
+    std::vector<OpenNode> stack_;
+    std::vector<uint8_t> swapped_;     // Big-endian hosts only
+    std::vector<uint8_t> packed_;
+    bool little_;
+    bool overflow_;
+    bool compress_;
+    int level_;
+    size_t threads_;
+};
+
+// Properties70 entries: name, type, label and flags, then the values
+void BeginP(NodeStream& s, const char* name, const char* type, const char* label, const char* flags) {
+    s.Begin("P");
+    s.String(name);
+    s.String(type);
+    s.String(label);
+    s.String(flags);
+}
+
+void PropertyInt(NodeStream& s, const char* name, int32_t value) {
+    BeginP(s, name, "int", "Integer", "");
+    s.Int32(value);
+    s.End();
+}
+
+void PropertyEnum(NodeStream& s, const char* name, int32_t value) {
+    BeginP(s, name, "enum", "", "");
+    s.Int32(value);
+    s.End();
+}
+
+void PropertyDouble(NodeStream& s, const char* name, double value) {
+    BeginP(s, name, "double", "Number", "");
+    s.Double(value);
+    s.End();
+}
+
+void PropertyTime(NodeStream& s, const char* name, int64_t value) {
+    BeginP(s, name, "KTime", "Time", "");
+    s.Int64(value);
+    s.End();
+}
+
+void PropertyString(NodeStream& s, const char* name, std::string_view value) {
+    BeginP(s, name, "KString", "", "");
+    s.String(value);
+    s.End();
+}
+
+void PropertyVector(NodeStream& s, const char* name, const char* type, const char* flags, const XVector3& value) {
+    BeginP(s, name, type, "", flags);
+    s.Double(value.x);
+    s.Double(value.y);
+    s.Double(value.z);
+    s.End();
+}
+
+void MatrixToDoubles(const XMatrix4x4& matrix, double out[16]) {
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            out[row * 4 + column] = matrix.m[row][column];
+        }
+    }
+}
+
+// Writes one scene. Objects get deterministic ids in creation order, and
+// every connection is recorded while its objects are written.
+class SceneWriter {
+public:
+    SceneWriter(const NativeFBXScene& scene, const std::string& outputPath)
+        : scene_(scene), mesh_(*scene.mesh), outputDirectory_(std::filesystem::path(outputPath).parent_path()),
+          nextId_(1000000) {
+        materialCount_ = scene.exportMaterials ? mesh_.materials.size() : 0;
+        const bool poseUsable = scene.pose && scene.pose->local.size() == mesh_.bones.size() &&
+                                scene.pose->world.size() == mesh_.bones.size();
+        boneCount_ = scene.exportSkeleton && poseUsable ? mesh_.bones.size() : 0;
+        hasSkin_ = boneCount_ > 0 && mesh_.HasSkinWeights();
+    }
+
+    void Write(NodeStream& s) {
+        CountObjects();
+        WriteHeader(s);
+        WriteGlobalSettings(s);
+        WriteDocuments(s);
+        s.Begin("References");
+        s.End();
+        WriteDefinitions(s);
+        WriteObjects(s);
+        WriteConnections(s);
+        WriteTakes(s);
+        s.EndDocument();
+    }
+
+    // First problem scene.validate found; empty when valid or not checked
+    const std::string& GetValidationError() const { return validationError_; }
+
+private:
+    struct Connection {
+        const char* kind;          // "OO" object to object, "OP" object to property
+        int64_t child;
+        int64_t parent;
+        const char* property;      // OP only
+    };
+
+    int64_t NewId() { return nextId_++; }
+
+    void Connect(int64_t child, int64_t parent) { connections_.push_back({"OO", child, parent, nullptr}); }
+    void ConnectProperty(int64_t child, int64_t parent, const char* property) {
+        connections_.push_back({"OP", child, parent, property});
+    }
+
+    bool TrackIsExported(const XBoneTrack& track) const {
+        return track.boneId >= 0 && static_cast<size_t>(track.boneId) < boneCount_;
+    }
+
+    // One texture per material slot in use; materials sharing an image
+    // share its Video object
+    struct TextureSlot {
+        size_t material;
+        const char* property;       // Material property it is connected to
+        const char* suffix;         // Of the texture object name
+        const std::string* path;    // As parsed
+        std::shared_ptr<const TextureImage> image;
+        size_t video;               // Index into videos_, NPOS when not embedded
+    };
+
+    void CollectTextures() {
+        textures_.clear();
+        videos_.clear();
+        if (!scene_.exportTextures) {
+            return;
+        }
+        for (size_t i = 0; i < materialCount_; ++i) {
+            const XMaterial& material = mesh_.materials[i];
+            const struct { const char* property; const char* suffix; const std::string& path; } slots[] = {
+                {"DiffuseColor", "_texture", material.diffuseTexture},
+                {"NormalMap", "_normal", material.normalTexture},
+                {"SpecularColor", "_specular", material.specularTexture},
+            };
+            for (const auto& slot : slots) {
+                if (slot.path.empty()) {
+                    continue;
+                }
+                TextureSlot texture{i, slot.property, slot.suffix, &slot.path, nullptr, NPOS};
+                if (scene_.textures) {
+                    texture.image = scene_.textures->Get(slot.path);
+                }
+                if (scene_.embedTextures && texture.image && texture.image->content) {
+                    for (size_t v = 0; v < videos_.size() && texture.video == NPOS; ++v) {
+                        if (videos_[v]->resolvedPath == texture.image->resolvedPath) {
+                            texture.video = v;
+                        }
+                    }
+                    if (texture.video == NPOS) {
+                        texture.video = videos_.size();
+                        videos_.push_back(texture.image.get());
+                    }
+                }
+                textures_.push_back(std::move(texture));
+            }
+        }
+    }
+
+    // Resolved files are referenced absolutely and relative to the output
+    std::string TextureFileName(const TextureSlot& texture) const {
+        return texture.image && texture.image->IsResolved() ? texture.image->resolvedPath : *texture.path;
+    }
+
+    std::string TextureRelativeFileName(const TextureSlot& texture) const {
+        if (!texture.image || !texture.image->IsResolved() || outputDirectory_.empty()) {
+            return TextureFileName(texture);
+        }
+        std::error_code ec;
+        std::filesystem::path base = std::filesystem::absolute(outputDirectory_, ec).lexically_normal();
+        std::filesystem::path relative = std::filesystem::path(texture.image->resolvedPath).lexically_relative(base);
+        return ec || relative.empty() ? TextureFileName(texture) : relative.generic_string();
+    }
+
+    void CountObjects() {
+        CollectTextures();
+        curveNodeCount_ = 0;
+        if (boneCount_ == 0) {
+            return;
+        }
+        for (const XAnimationSet* animation : scene_.animations) {
+            for (const XBoneTrack& track : animation->tracks) {
+                if (TrackIsExported(track)) {
+                    curveNodeCount_ += (track.translation.IsEmpty() ? 0 : 1) +
+                                       (track.rotation.IsEmpty() ? 0 : 1) +
+                                       (track.scale.IsEmpty() ? 0 : 1);
+                }
+            }
+        }
+    }
+
+    size_t AnimationCount() const { return boneCount_ > 0 ? scene_.animations.size() : 0; }
+
+    double LongestAnimationSeconds() const {
+        double longest = 0.0;
+        for (size_t i = 0; i < AnimationCount(); ++i) {
+            longest = std::max(longest, static_cast<double>(scene_.animations[i]->GetDurationInSeconds()));
+        }
+        return longest;
+    }
+
+    void WriteHeader(NodeStream& s) {
+        s.Begin("FBXHeaderExtension");
+        s.Begin("FBXHeaderVersion"); s.Int32(1003); s.End();
+        s.Begin("FBXVersion"); s.Int32(static_cast<int32_t>(NativeFBXWriter::FBX_VERSION)); s.End();
+        s.Begin("EncryptionType"); s.Int32(0); s.End();
+        s.Begin("CreationTimeStamp");
+        const struct { const char* name; int32_t value; } stamp[] = {
+            {"Version", 1000}, {"Year", 1970}, {"Month", 1}, {"Day", 1},
+            {"Hour", 10}, {"Minute", 0}, {"Second", 0}, {"Millisecond", 0}
+        };
+        for (const auto& field : stamp) {
+            s.Begin(field.name); s.Int32(field.value); s.End();
+        }
+        s.End();
+        s.Begin("Creator"); s.String(CREATOR); s.End();
+        s.End();
+
+        s.Begin("FileId"); s.Raw(FILE_ID, sizeof(FILE_ID)); s.End();
+        s.Begin("CreationTime"); s.String(CREATION_TIME); s.End();
+        s.Begin("Creator"); s.String(CREATOR); s.End();
+    }
+
+    // Y up, Z front, X right and centimetres, as the SDK backend writes
+    void WriteGlobalSettings(NodeStream& s) {
+        s.Begin("GlobalSettings");
+        s.Begin("Version"); s.Int32(1000); s.End();
+        s.Begin("Properties70");
+        PropertyInt(s, "UpAxis", 1);
+        PropertyInt(s, "UpAxisSign", 1);
+        PropertyInt(s, "FrontAxis", 2);
+        PropertyInt(s, "FrontAxisSign", 1);
+        PropertyInt(s, "CoordAxis", 0);
+        PropertyInt(s, "CoordAxisSign", 1);
+        PropertyInt(s, "OriginalUpAxis", 1);
+        PropertyInt(s, "OriginalUpAxisSign", 1);
+        PropertyDouble(s, "UnitScaleFactor", 1.0);
+        PropertyDouble(s, "OriginalUnitScaleFactor", 1.0);
+        PropertyEnum(s, "TimeMode", TimeModeForFrameRate(scene_.frameRate));
+        PropertyTime(s, "TimeSpanStart", 0);
+        PropertyTime(s, "TimeSpanStop", ToKTime(LongestAnimationSeconds()));
+        BeginP(s, "CustomFrameRate", "double", "Number", "");
+        s.Double(scene_.frameRate);
+        s.End();
+        s.End();
+        s.End();
+    }
+
+    void WriteDocuments(NodeStream& s) {
+        s.Begin("Documents");
+        s.Begin("Count"); s.Int32(1); s.End();
+        s.Begin("Document");
+        s.Int64(NewId());
+        s.String("Scene");
+        s.String("Scene");
+        s.Begin("Properties70");
+        BeginP(s, "SourceObject", "object", "", "");
+        s.End();
+        PropertyString(s, "ActiveAnimStackName", AnimationCount() > 0 ? scene_.animations[0]->name : std::string());
+        s.End();
+        s.Begin("RootNode"); s.Int64(0); s.End();
+        s.End();
+        s.End();
+    }
+
+    void WriteDefinitions(NodeStream& s) {
+        const size_t textureCount = textures_.size();
+        const size_t animationCount = AnimationCount();
+        const struct { const char* type; size_t count; } types[] = {
+            {"GlobalSettings", 1},
+            {"Model", 1 + boneCount_},
+            {"Geometry", 1},
+            {"Material", materialCount_},
+            {"Texture", textureCount},
+            {"Video", videos_.size()},
+            {"NodeAttribute", boneCount_},
+            {"Deformer", hasSkin_ ? 1 + boneCount_ : 0},
+            {"Pose", boneCount_ > 0 ? size_t(1) : size_t(0)},
+            {"AnimationStack", animationCount},
+            {"AnimationLayer", animationCount},
+            {"AnimationCurveNode", curveNodeCount_},
+            {"AnimationCurve", curveNodeCount_ * 3},
+        };
+
+        size_t total = 0;
+        for (const auto& type : types) {
+            total += type.count;
+        }
+
+        s.Begin("Definitions");
+        s.Begin("Version"); s.Int32(100); s.End();
+        s.Begin("Count"); s.Int32(static_cast<int32_t>(total)); s.End();
+        for (const auto& type : types) {
+            if (type.count == 0) {
+                continue;
+            }
+            s.Begin("ObjectType");
+            s.String(type.type);
+            s.Begin("Count"); s.Int32(static_cast<int32_t>(type.count)); s.End();
+            s.End();
+        }
+        s.End();
+    }
+
+    void WriteObjects(NodeStream& s) {
+        s.Begin("Objects");
+        const int64_t geometryId = WriteGeometry(s);
+        meshModelId_ = WriteModel(s, scene_.meshName + "Node", "Mesh", nullptr);
+        Connect(meshModelId_, 0);
+        Connect(geometryId, meshModelId_);
+        WriteMaterials(s);
+        if (boneCount_ > 0) {
+            WriteSkeleton(s);
+            if (hasSkin_) {
+                WriteSkin(s, geometryId);
+            }
+            WriteBindPose(s);
+            for (size_t i = 0; i < AnimationCount(); ++i) {
+                WriteAnimation(s, *scene_.animations[i]);
+            }
+        }
+        s.End();
+    }
+
+    // Vectors as x, y, z doubles into doubles_: DirectX (x, y, z) -> FBX
+    // (x, z, -y) like the SDK backend, or as they are without convertAxes
+    void VectorsToDoubles(const XVector3* vectors, size_t count) {
+        if (scene_.convertAxes) {
+            CoordinateKernels::ConvertVectors(vectors, count, doubles_.data());
+            return;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            doubles_[i * 3] = vectors[i].x;
+            doubles_[i * 3 + 1] = vectors[i].y;
+            doubles_[i * 3 + 2] = vectors[i].z;
+        }
+    }
+
+    int64_t WriteGeometry(NodeStream& s) {
+        const int64_t id = NewId();
+        s.Begin("Geometry");
+        s.Int64(id);
+        s.String(ObjectName(scene_.meshName, "Geometry"));
+        s.String("Mesh");
+        s.Begin("GeometryVersion"); s.Int32(124); s.End();
+
+        const size_t vertexCount = mesh_.GetVertexCount();
+        doubles_.resize(vertexCount * 3);
+        VectorsToDoubles(mesh_.positions.data(), vertexCount);
+        s.Begin("Vertices"); s.Array(doubles_.data(), doubles_.size()); s.End();
+
+        // The last index of each polygon is stored as ~index
+        ints_.resize(mesh_.indices.size());
+        const uint32_t largestIndex = CoordinateKernels::TrianglesToPolygonIndices(
+            mesh_.indices.data(), mesh_.indices.size(), ints_.data(), scene_.reverseWinding);
+        s.Begin("PolygonVertexIndex"); s.Array(ints_.data(), ints_.size()); s.End();
+        if (scene_.validate) {
+            ValidateGeometry(largestIndex);
+        }
+
+        const bool hasNormals = mesh_.HasNormals() && mesh_.normals.size() == vertexCount;
+        if (hasNormals) {
+            VectorsToDoubles(mesh_.normals.data(), vertexCount);
+            s.Begin("LayerElementNormal");
+            s.Int32(0);
+            s.Begin("Version"); s.Int32(101); s.End();
+            s.Begin("Name"); s.String(""); s.End();
+            s.Begin("MappingInformationType"); s.String("ByVertice"); s.End();
+            s.Begin("ReferenceInformationType"); s.String("Direct"); s.End();
+            s.Begin("Normals"); s.Array(doubles_.data(), vertexCount * 3); s.End();
+            s.End();
+        }
+
+        const bool hasUVs = mesh_.HasTexCoords() && mesh_.texCoords.size() == vertexCount;
+        if (hasUVs) {
+            for (size_t i = 0; i < vertexCount; ++i) {
+                const XVector2& uv = mesh_.texCoords[i];
+                doubles_[i * 2] = uv.u;
+                doubles_[i * 2 + 1] = 1.0 - uv.v;   // Flip V
+            }
+            s.Begin("LayerElementUV");
+            s.Int32(0);
+            s.Begin("Version"); s.Int32(101); s.End();
+            s.Begin("Name"); s.String("UVSet"); s.End();
+            s.Begin("MappingInformationType"); s.String("ByVertice"); s.End();
+            s.Begin("ReferenceInformationType"); s.String("Direct"); s.End();
+            s.Begin("UV"); s.Array(doubles_.data(), vertexCount * 2); s.End();
+            s.End();
+        }
+
+        if (materialCount_ > 0) {
+            // Faces without a (valid) material use the first one
+            ints_.resize(mesh_.faceMaterials.size());
+            for (size_t i = 0; i < ints_.size(); ++i) {
+                const int material = mesh_.faceMaterials[i];
+                ints_[i] = material >= 0 && static_cast<size_t>(material) < materialCount_ ? material : 0;
+            }
+            s.Begin("LayerElementMaterial");
+            s.Int32(0);
+            s.Begin("Version"); s.Int32(101); s.End();
+            s.Begin("Name"); s.String(""); s.End();
+            s.Begin("MappingInformationType"); s.String("ByPolygon"); s.End();
+            s.Begin("ReferenceInformationType"); s.String("IndexToDirect"); s.End();
+            s.Begin("Materials"); s.Array(ints_.data(), ints_.size()); s.End();
+            s.End();
+        }
+
+        s.Begin("Layer");
+        s.Int32(0);
+        s.Begin("Version"); s.Int32(100); s.End();
+        const struct { bool present; const char* type; } elements[] = {
+            {hasNormals, "LayerElementNormal"},
+            {hasUVs, "LayerElementUV"},
+            {materialCount_ > 0, "LayerElementMaterial"},
+        };
+        for (const auto& element : elements) {
+            if (!element.present) {
+                continue;
+            }
+            s.Begin("LayerElement");
+            s.Begin("Type"); s.String(element.type); s.End();
+            s.Begin("TypedIndex"); s.Int32(0); s.End();
+            s.End();
+        }
+        s.End();
+
+        s.End();
+        return id;
+    }
+
+    // Cheap checks on what WriteGeometry already touched. Streams that do
+    // not match the vertex count are left out of the file, so they only warn.
+    void ValidateGeometry(uint32_t largestIndex) {
+        const size_t vertexCount = mesh_.GetVertexCount();
+        const size_t indexCount = mesh_.indices.size();
+        if (indexCount % 3 != 0) {
+            Invalid(std::to_string(indexCount) + " triangle indices is not a whole number of triangles");
+        } else if (indexCount > 0 && largestIndex >= vertexCount) {
+            Invalid("triangle index " + std::to_string(static_cast<int32_t>(largestIndex)) + " out of range (" +
+                    std::to_string(vertexCount) + " vertices)");
+        } else if (materialCount_ > 0 && mesh_.faceMaterials.size() != indexCount / 3) {
+            Invalid(std::to_string(mesh_.faceMaterials.size()) + " face materials for " +
+                    std::to_string(indexCount / 3) + " faces");
+        }
+        if (mesh_.HasNormals() && mesh_.normals.size() != vertexCount) {
+            LOG_WARNING(scene_.meshName + ": " + std::to_string(mesh_.normals.size()) + " normals for " +
+                        std::to_string(vertexCount) + " vertices; normals not written");
+        }
+        if (mesh_.HasTexCoords() && mesh_.texCoords.size() != vertexCount) {
+            LOG_WARNING(scene_.meshName + ": " + std::to_string(mesh_.texCoords.size()) + " UVs for " +
+                        std::to_string(vertexCount) + " vertices; UVs not written");
+        }
+    }
+
+    void Invalid(const std::string& error) {
+        if (validationError_.empty()) {
+            validationError_ = scene_.meshName + ": " + error;
+        }
+    }
+
+    int64_t WriteModel(NodeStream& s, const std::string& name, const char* type, const XMatrix4x4* local) {
+        const int64_t id = NewId();
+        s.Begin("Model");
+        s.Int64(id);
+        s.String(ObjectName(name, "Model"));
+        s.String(type);
+        s.Begin("Version"); s.Int32(232); s.End();
+        if (local) {
+            XVector3 translation, rotation, scale;
+            FBXUtils::DecomposeMatrix(*local, translation, rotation, scale);
+            s.Begin("Properties70");
+            PropertyVector(s, "Lcl Translation", "Lcl Translation", "A", translation);
+            PropertyVector(s, "Lcl Rotation", "Lcl Rotation", "A", rotation);
+            PropertyVector(s, "Lcl Scaling", "Lcl Scaling", "A", scale);
+            s.End();
+        }
+        s.Begin("Shading"); s.Bool(true); s.End();
+        s.Begin("Culling"); s.String("CullingOff"); s.End();
+        s.End();
+        return id;
+    }
+
+    void WriteVideos(NodeStream& s) {
+        videoIds_.resize(videos_.size());
+        for (size_t v = 0; v < videos_.size(); ++v) {
+            const TextureImage& image = *videos_[v];
+            const std::string name = std::filesystem::path(image.resolvedPath).filename().string();
+            videoIds_[v] = NewId();
+            s.Begin("Video");
+            s.Int64(videoIds_[v]);
+            s.String(ObjectName(name, "Video"));
+            s.String("Clip");
+            s.Begin("Type"); s.String("Clip"); s.End();
+            s.Begin("Properties70");
+            BeginP(s, "Path", "KString", "XRefUrl", "");
+            s.String(image.resolvedPath);
+            s.End();
+            s.End();
+            s.Begin("UseMipMap"); s.Int32(0); s.End();
+            s.Begin("Filename"); s.String(image.resolvedPath); s.End();
+            s.Begin("RelativeFilename"); s.String(name); s.End();
+            s.Begin("Content"); s.Raw(image.content->data(), image.content->size()); s.End();
+            s.End();
+        }
+    }
+
+    void WriteMaterials(NodeStream& s) {
+        WriteVideos(s);
+        size_t nextTexture = 0;
+        for (size_t i = 0; i < materialCount_; ++i) {
+            const XMaterial& material = mesh_.materials[i];
+            const std::string name = material.name.empty() ? "Material_" + std::to_string(i) : material.name;
+
+            const int64_t id = NewId();
+            s.Begin("Material");
+            s.Int64(id);
+            s.String(ObjectName(name, "Material"));
+            s.String("");
+            s.Begin("Version"); s.Int32(102); s.End();
+            s.Begin("ShadingModel"); s.String("phong"); s.End();
+            s.Begin("MultiLayer"); s.Int32(0); s.End();
+            s.Begin("Properties70");
+            PropertyVector(s, "DiffuseColor", "Color", "A", material.diffuseColor);
+            PropertyVector(s, "SpecularColor", "Color", "A", material.specularColor);
+            PropertyVector(s, "EmissiveColor", "Color", "A", material.emissiveColor);
+            BeginP(s, "Shininess", "Number", "", "A");
+            s.Double(material.shininess);
+            s.End();
+            BeginP(s, "TransparencyFactor", "Number", "", "A");
+            s.Double(material.transparency);
+            s.End();
+            s.End();
+            s.End();
+            Connect(id, meshModelId_);
+
+            for (; nextTexture < textures_.size() && textures_[nextTexture].material == i; ++nextTexture) {
+                const TextureSlot& texture = textures_[nextTexture];
+                const int64_t textureId = NewId();
+                const std::string textureName = ObjectName(name + texture.suffix, "Texture");
+                s.Begin("Texture");
+                s.Int64(textureId);
+                s.String(textureName);
+                s.String("");
+                s.Begin("Type"); s.String("TextureVideoClip"); s.End();
+                s.Begin("Version"); s.Int32(202); s.End();
+                s.Begin("TextureName"); s.String(textureName); s.End();
+                if (texture.video != NPOS) {
+                    const std::string videoName =
+                        std::filesystem::path(videos_[texture.video]->resolvedPath).filename().string();
+                    s.Begin("Media"); s.String(ObjectName(videoName, "Video")); s.End();
+                }
+                s.Begin("FileName"); s.String(TextureFileName(texture)); s.End();
+                s.Begin("RelativeFilename"); s.String(TextureRelativeFileName(texture)); s.End();
+                s.Begin("ModelUVTranslation"); s.Double(0.0); s.Double(0.0); s.End();
+                s.Begin("ModelUVScaling"); s.Double(1.0); s.Double(1.0); s.End();
+                s.Begin("Texture_Alpha_Source"); s.String("None"); s.End();
+                s.End();
+                ConnectProperty(textureId, id, texture.property);
+                if (texture.video != NPOS) {
+                    Connect(videoIds_[texture.video], textureId);
+                }
+            }
+        }
+    }
+
+    // Parents precede their children, so every parent model exists already
+    void WriteSkeleton(NodeStream& s) {
+        boneModelIds_.resize(boneCount_);
+        for (size_t i = 0; i < boneCount_; ++i) {
+            const std::string& name = mesh_.GetBoneName(i);
+            const int64_t attributeId = NewId();
+            s.Begin("NodeAttribute");
+            s.Int64(attributeId);
+            s.String(ObjectName(name, "NodeAttribute"));
+            s.String("LimbNode");
+            s.Begin("TypeFlags"); s.String("Skeleton"); s.End();
+            s.End();
+
+            boneModelIds_[i] = WriteModel(s, name, "LimbNode", &scene_.pose->local[i]);
+            const int parent = mesh_.bones[i].parentIndex;
+            Connect(boneModelIds_[i], parent >= 0 ? boneModelIds_[parent] : 0);
+            Connect(attributeId, boneModelIds_[i]);
+        }
+    }
+
+    // One cluster per bone. The mesh sits untransformed at the scene root,
+    // so each cluster's Transform is the inverse of its bone's bind matrix.
+    void WriteSkin(NodeStream& s, int64_t geometryId) {
+        FBXUtils::SkinClusters influences;
+        FBXUtils::BuildSkinClusters(mesh_, influences);
+
+        const int64_t skinId = NewId();
+        s.Begin("Deformer");
+        s.Int64(skinId);
+        s.String(ObjectName("Skin", "Deformer"));
+        s.String("Skin");
+        s.Begin("Version"); s.Int32(101); s.End();
+        s.Begin("Link_DeformAcuracy"); s.Double(50.0); s.End();
+        s.End();
+        Connect(skinId, geometryId);
+
+        double transform[16];
+        double transformLink[16];
+        for (size_t bone = 0; bone < boneCount_; ++bone) {
+            const int64_t clusterId = NewId();
+            s.Begin("Deformer");
+            s.Int64(clusterId);
+            s.String(ObjectName(mesh_.GetBoneName(bone) + "_cluster", "SubDeformer"));
+            s.String("Cluster");
+            s.Begin("Version"); s.Int32(100); s.End();
+            s.Begin("UserData"); s.String(""); s.String(""); s.End();
+            const size_t count = influences.GetInfluenceCount(bone);
+            if (count > 0) {
+                const size_t begin = influences.offsets[bone];
+                s.Begin("Indexes"); s.Array(influences.controlPoints.data() + begin, count); s.End();
+                s.Begin("Weights"); s.Array(influences.weights.data() + begin, count); s.End();
+            }
+            MatrixToDoubles(FBXUtils::InvertAffineMatrix(scene_.pose->world[bone]), transform);
+            MatrixToDoubles(scene_.pose->world[bone], transformLink);
+            s.Begin("Transform"); s.Array(transform, 16); s.End();
+            s.Begin("TransformLink"); s.Array(transformLink, 16); s.End();
+            s.End();
+            Connect(clusterId, skinId);
+            Connect(boneModelIds_[bone], clusterId);
+        }
+    }
+
+    void WriteBindPose(NodeStream& s) {
+        double matrix[16];
+        s.Begin("Pose");
+        s.Int64(NewId());
+        s.String(ObjectName("BindPose", "Pose"));
+        s.String("BindPose");
+        s.Begin("Type"); s.String("BindPose"); s.End();
+        s.Begin("Version"); s.Int32(100); s.End();
+        s.Begin("NbPoseNodes"); s.Int32(static_cast<int32_t>(boneCount_ + 1)); s.End();
+
+        MatrixToDoubles(XMatrix4x4::Identity(), matrix);
+        s.Begin("PoseNode");
+        s.Begin("Node"); s.Int64(meshModelId_); s.End();
+        s.Begin("Matrix"); s.Array(matrix, 16); s.End();
+        s.End();
+        for (size_t bone = 0; bone < boneCount_; ++bone) {
+            MatrixToDoubles(scene_.pose->world[bone], matrix);
+            s.Begin("PoseNode");
+            s.Begin("Node"); s.Int64(boneModelIds_[bone]); s.End();
+            s.Begin("Matrix"); s.Array(matrix, 16); s.End();
+            s.End();
+        }
+        s.End();
+    }
+
+    // A stack with one layer, and per keyed transform of a bone a curve
+    // node driving the Lcl property with one curve per axis
+    void WriteAnimation(NodeStream& s, const XAnimationSet& animation) {
+        const int64_t stop = ToKTime(animation.GetDurationInSeconds());
+        const int64_t stackId = NewId();
+        s.Begin("AnimationStack");
+        s.Int64(stackId);
+        s.String(ObjectName(animation.name, "AnimStack"));
+        s.String("");
+        s.Begin("Properties70");
+        PropertyTime(s, "LocalStart", 0);
+        PropertyTime(s, "LocalStop", stop);
+        PropertyTime(s, "ReferenceStart", 0);
+        PropertyTime(s, "ReferenceStop", stop);
+        s.End();
+        s.End();
+
+        const int64_t layerId = NewId();
+        s.Begin("AnimationLayer");
+        s.Int64(layerId);
+        s.String(ObjectName(animation.name + "_layer", "AnimLayer"));
+        s.String("");
+        s.End();
+        Connect(layerId, stackId);
+
+        static const char* const curveNodeNames[FBXUtils::CurveChannels::TRANSFORM_COUNT] = {"T", "R", "S"};
+        static const char* const properties[FBXUtils::CurveChannels::TRANSFORM_COUNT] = {
+            "Lcl Translation", "Lcl Rotation", "Lcl Scaling"
+        };
+        static const char* const components[3] = {"d|X", "d|Y", "d|Z"};
+
+        for (const XBoneTrack& track : animation.tracks) {
+            if (!TrackIsExported(track)) {
+                continue;
+            }
+            FBXUtils::BuildCurveChannels(track, animation.ticksPerSecond, channels_, scene_.convertAxes);
+
+            for (int transform = 0; transform < FBXUtils::CurveChannels::TRANSFORM_COUNT; ++transform) {
+                const std::vector<double>& times = channels_.times[transform];
+                if (times.empty()) {
+                    continue;   // Channel not keyed; the bone keeps its bind transform
+                }
+
+                const int64_t curveNodeId = NewId();
+                s.Begin("AnimationCurveNode");
+                s.Int64(curveNodeId);
+                s.String(ObjectName(curveNodeNames[transform], "AnimCurveNode"));
+                s.String("");
+                s.Begin("Properties70");
+                for (int axis = 0; axis < 3; ++axis) {
+                    BeginP(s, components[axis], "Number", "", "A");
+                    s.Double(channels_.values[transform * 3 + axis][0]);
+                    s.End();
+                }
+                s.End();
+                s.End();
+                Connect(curveNodeId, layerId);
+                ConnectProperty(curveNodeId, boneModelIds_[track.boneId], properties[transform]);
+
+                keyTimes_.resize(times.size());
+                for (size_t i = 0; i < times.size(); ++i) {
+                    keyTimes_[i] = ToKTime(times[i]);
+                }
+                const int32_t keyCount = static_cast<int32_t>(times.size());
+                for (int axis = 0; axis < 3; ++axis) {
+                    const std::vector<float>& values = channels_.values[transform * 3 + axis];
+                    const int64_t curveId = NewId();
+                    s.Begin("AnimationCurve");
+                    s.Int64(curveId);
+                    s.String(ObjectName("", "AnimCurve"));
+                    s.String("");
+                    s.Begin("Default"); s.Double(values[0]); s.End();
+                    s.Begin("KeyVer"); s.Int32(4008); s.End();
+                    s.Begin("KeyTime"); s.Array(keyTimes_.data(), keyTimes_.size()); s.End();
+                    s.Begin("KeyValueFloat"); s.Array(values.data(), values.size()); s.End();
+                    s.Begin("KeyAttrFlags"); s.Array(&KEY_ATTR_FLAGS_LINEAR, 1); s.End();
+                    s.Begin("KeyAttrDataFloat"); s.Array(KEY_ATTR_DATA, 4); s.End();
+                    s.Begin("KeyAttrRefCount"); s.Array(&keyCount, 1); s.End();
+                    s.End();
+                    ConnectProperty(curveId, curveNodeId, components[axis]);
+                }
+            }
+        }
+    }
+
+    void WriteConnections(NodeStream& s) {
+        s.Begin("Connections");
+        for (const Connection& connection : connections_) {
+            s.Begin("C");
+            s.String(connection.kind);
+            s.Int64(connection.child);
+            s.Int64(connection.parent);
+            if (connection.property) {
+                s.String(connection.property);
+            }
+            s.End();
+        }
+        s.End();
+    }
+
+    void WriteTakes(NodeStream& s) {
+        s.Begin("Takes");
+        s.Begin("Current"); s.String(AnimationCount() > 0 ? scene_.animations[0]->name : std::string()); s.End();
+        for (size_t i = 0; i < AnimationCount(); ++i) {
+            const XAnimationSet& animation = *scene_.animations[i];
+            const int64_t stop = ToKTime(animation.GetDurationInSeconds());
+            s.Begin("Take");
+            s.String(animation.name);
+            s.Begin("FileName"); s.String(animation.name + ".tak"); s.End();
+            s.Begin("LocalTime"); s.Int64(0); s.Int64(stop); s.End();
+            s.Begin("ReferenceTime"); s.Int64(0); s.Int64(stop); s.End();
+            s.End();
+        }
+        s.End();
+    }
+
+    const NativeFBXScene& scene_;
+    const XMeshData& mesh_;
+    std::filesystem::path outputDirectory_;
+    int64_t nextId_;
+    size_t materialCount_;
+    size_t boneCount_;
+    bool hasSkin_;
+    size_t curveNodeCount_ = 0;
+    int64_t meshModelId_ = 0;
+    std::vector<int64_t> boneModelIds_;
+    std::vector<TextureSlot> textures_;         // Material order
+    std::vector<const TextureImage*> videos_;   // Embedded images, owned by textures_
+    std::vector<int64_t> videoIds_;
+    std::vector<Connection> connections_;
+    std::string validationError_;
+
+    // Scratch reused across arrays
+    std::vector<double> doubles_;
+    std::vector<int32_t> ints_;
+    std::vector<int64_t> keyTimes_;
+    FBXUtils::CurveChannels channels_;
+};
+
+} // namespace
+
+bool NativeFBXWriter::Write(const NativeFBXScene& scene, const std::string& outputPath) {
+    TIME_OPERATION("NativeFBXWriter::Write");
+    error_.clear();
+    bytesWritten_ = 0;
+
+    if (!scene.mesh) {
+        error_ = "No mesh to write";
+        return false;
+    }
+    if (scene.exportSkeleton && !scene.mesh->bones.empty() && !scene.pose) {
+        LOG_WARNING("No skeleton pose for " + outputPath + "; bones, skin and animations are not written");
+    }
+
+    NodeStream stream(compressArrays_, compressionLevel_, compressionThreads_);
+    stream.Append(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    stream.Put32(FBX_VERSION);
+    SceneWriter sceneWriter(scene, outputPath);
+    sceneWriter.Write(stream);
+    if (!sceneWriter.GetValidationError().empty()) {
+        error_ = "Validation failed: " + sceneWriter.GetValidationError();
+        return false;
+    }
+
+    // Footer: id, padding to a 16 byte boundary (a full 16 when aligned),
+    // the version again and a fixed trailer
+    std::vector<uint8_t>& bytes = stream.Bytes();
+    stream.Append(FOOTER_ID, sizeof(FOOTER_ID));
+    bytes.resize(bytes.size() + 4, 0);
+    size_t padding = ((bytes.size() + 15) & ~static_cast<size_t>(15)) - bytes.size();
+    bytes.resize(bytes.size() + (padding == 0 ? 16 : padding), 0);
+    stream.Put32(FBX_VERSION);
+    bytes.resize(bytes.size() + 120, 0);
+    stream.Append(FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+
+    if (stream.Overflowed()) {
+        error_ = "Scene exceeds the 4 GiB limit of FBX " + std::to_string(FBX_VERSION);
+        return false;
+    }
+
+    if (outputWriter_) {
+        bytesWritten_ = bytes.size();
+        outputWriter_->Write(outputPath, std::move(bytes));
+        return true;
+    }
+
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        error_ = "Cannot create output file: " + outputPath;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    file.close();
+    if (!file) {
+        error_ = "Failed to write FBX file: " + outputPath;
+        return false;
+    }
+
+    bytesWritten_ = bytes.size();
+    timer.AddBytes(bytesWritten_);
+    return true;
+}
+
+} // namespace X2FBX
@@ -1,16 +1,33 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <filesystem>
 #include <chrono>
+#include <iomanip>
+#include <cstdio>
+#include <memory>
 
 // Project headers
 #include "XFileData.h"
 #include "XFileParser.h"
 #include "BinaryXFileParser.h"
 #include "FBXExporter.h"
+#include "AnimationResampler.h"
 #include "AnimationTimingCorrector.h"
+#include "ConversionCache.h"
+#include "ConversionStages.h"
+#include "KeyframeReducer.h"
+#include "MeshOptimizer.h"
+#include "StreamQuantizer.h"
+#include "XFileSnapshot.h"
+#include "BatchConverter.h"
+#include "ConversionMetrics.h"
+#include "ConversionReport.h"
+#include "ConversionServer.h"
 #include "Logger.h"
+#include "ProcessMemory.h"
+#include "Profiler.h"
 
 using namespace X2FBX;
 namespace fs = std::filesystem;
@@ -22,12 +39,42 @@ const std::string APP_NAME = "X2FBX Converter";
 // Command line options
 struct ConversionOptions {
     std::string inputFile;
+    std::string batchSource;         // Directory or list file for --batch mode
+    std::string serveSocket;         // Unix-domain socket for --serve mode
+    size_t jobs = 0;                 // Batch/animation export threads (0 = hardware threads)
     std::string outputDirectory = "./output";
     bool verboseLogging = false;
     bool strictMode = false;
     bool validateTiming = true;
     bool generateReport = true;
+    bool jsonReport = false;         // --report json: one NDJSON record per file (and one per batch)
+    std::string reportPath;          // --report-file (default <output>/x2fbx_report.ndjson, "-" = stdout)
+    bool reduceKeyframes = false;
+    KeyframeReductionOptions keyReduction;
+    bool resampleAnimations = false; // --resample <fps>: uniformly sampled clips
+    AnimationResampleOptions resampling;
+    bool optimizeMesh = true;        // Weld, drop degenerate triangles, cache-order
+    bool batchMaterials = false;     // --batch-materials: merge identical materials, group faces
+    bool quantize = false;           // --quantize: 16-bit streams, smallest-three rotation keys
+    FBXExportOptions::Backend fbxBackend = FBXExportOptions::Backend::AUTO;  // --fbx-backend
+    bool compressArrays = true;      // --no-compress-arrays turns deflate off
+    int compressionLevel = -1;       // --compression-level (-1 = zlib default)
+    std::vector<std::string> animationNames;  // --animations a,b: only these sets are decoded
+    DecompressionLimits decompressionLimits;  // --max-decompress-seconds / --max-decompressed-mb
+    ConversionCacheOptions cache;    // --cache <dir>: reuse outputs of identical inputs
+    bool resolveTextures = false;    // --resolve-textures: find material textures on disk
+    bool embedTextures = false;      // --embed-textures: also embed them
+    bool embedTexturesInClips = true;  // --reference-clip-textures: clip files reference them instead
+    TextureLibraryOptions textures;  // --texture-dir <dir>, repeatable
+    InputPrefetchOptions prefetch;   // --read-ahead-mb: batch inputs read ahead of the workers
+    OutputWriterOptions writes;      // --write-queue-mb: batch FBX files written on a writer thread
+    FBXExportOptions::Validation validation = FBXExportOptions::Validation::CHEAP;  // --validate
+    std::string snapshotPath;        // --snapshot <file>: save the parsed data for re-exports
     LogLevel logLevel = LogLevel::INFO;
+    std::string profilePath;         // JSON phase summary (--profile)
+    std::string tracePath;           // Chrome trace-event file (--trace)
+    std::string metricsPath;         // Prometheus text file rewritten while running (--metrics)
+    double metricsInterval = 5.0;    // Seconds between rewrites (--metrics-interval)
 
     ConversionOptions() = default;
 };
@@ -36,20 +83,32 @@ struct ConversionOptions {
 void PrintUsage(const std::string& programName);
 void PrintVersion();
 bool ParseCommandLine(int argc, char* argv[], ConversionOptions& options);
-bool ValidateInputFile(const std::string& filepath);
+bool ValidateInputFile(const std::string& filepath, XFileProbe& probe);
 bool CreateOutputDirectory(const std::string& dirPath);
-bool ConvertXFileToFBX(const ConversionOptions& options);
+bool ConvertXFileToFBX(const ConversionOptions& options, const XFileProbe& probe, ConversionRecord& record);
+std::string ResolveReportPath(const ConversionOptions& options);
+int RunBatchConversion(const ConversionOptions& options);
+int RunConversionServer(const ConversionOptions& options);
+void WriteProfileOutputs(const ConversionOptions& options);
 void PrintConversionSummary(const XFileData& fileData,
                            const std::vector<TimingCorrectionResult>& timingResults);
 
 int main(int argc, char* argv[]) {
+    // Parse command line arguments
+    ConversionOptions options;
+    bool parsed = ParseCommandLine(argc, argv, options);
+
+    // A report on stdout gets stdout to itself: the banner, progress lines
+    // and console logging go to stderr from here on
+    if (parsed && options.jsonReport && options.reportPath == "-") {
+        ConversionReportWriter::ReserveStdout();
+    }
+
     std::cout << APP_NAME << " v" << APP_VERSION << std::endl;
     std::cout << "Convert DirectX .x files to FBX with proper animation timing" << std::endl;
     std::cout << "===========================================================" << std::endl << std::endl;
 
-    // Parse command line arguments
-    ConversionOptions options;
-    if (!ParseCommandLine(argc, argv, options)) {
+    if (!parsed) {
         PrintUsage(argv[0]);
         return 1;
     }
@@ -64,12 +123,36 @@ int main(int argc, char* argv[]) {
         logger.SetLogLevel(LogLevel::DEBUG);
     }
 
+    if (!options.profilePath.empty() || !options.tracePath.empty()) {
+        Profiler::GetInstance().Enable(true, !options.tracePath.empty());
+    }
+
     LOG_INFO("Starting " + APP_NAME + " v" + APP_VERSION);
+
+    // Kept until main returns, so the last write has the final counters
+    std::unique_ptr<MetricsFileWriter> metricsWriter;
+    if (!options.metricsPath.empty()) {
+        metricsWriter = std::make_unique<MetricsFileWriter>(options.metricsPath, options.metricsInterval);
+    }
+
+    if (!options.serveSocket.empty()) {
+        int exitCode = RunConversionServer(options);
+        WriteProfileOutputs(options);
+        return exitCode;
+    }
+
+    if (!options.batchSource.empty()) {
+        int exitCode = RunBatchConversion(options);
+        WriteProfileOutputs(options);
+        return exitCode;
+    }
+
     LOG_INFO("Input file: " + options.inputFile);
     LOG_INFO("Output directory: " + options.outputDirectory);
 
-    // Validate input file
-    if (!ValidateInputFile(options.inputFile)) {
+    // Validate input file; the probed header picks the parse path later
+    XFileProbe inputProbe;
+    if (!ValidateInputFile(options.inputFile, inputProbe)) {
         LOG_CRITICAL("Input file validation failed");
         std::cerr << "Error: Invalid input file: " << options.inputFile << std::endl;
         return 1;
@@ -85,11 +168,28 @@ int main(int argc, char* argv[]) {
     // Perform conversion
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    bool success = ConvertXFileToFBX(options);
+    ConversionRecord record;
+    bool success = ConvertXFileToFBX(options, inputProbe, record);
+    WriteProfileOutputs(options);
+
+    if (options.jsonReport) {
+        record.success = success;
+        record.peakRssBytes = ProcessMemory::GetPeakRssBytes();
+        std::string reportPath = ResolveReportPath(options);
+        ConversionReportWriter reportWriter(reportPath);
+        if (reportWriter.IsOpen()) {
+            reportWriter.Write(record);
+        } else {
+            LOG_ERROR("Cannot write conversion report: " + reportPath);
+        }
+    }
 
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
+    // Let queued log lines reach the console before the summary
+    logger.Flush();
+
     if (success) {
         std::cout << std::endl << "✓ Conversion completed successfully!" << std::endl;
         std::cout << "Total time: " << duration.count() << " ms" << std::endl;
@@ -126,6 +226,238 @@ bool ParseCommandLine(int argc, char* argv[], ConversionOptions& options) {
             options.validateTiming = false;
         } else if (arg == "--no-report") {
             options.generateReport = false;
+        } else if (arg == "--report") {
+            if (i + 1 < argc && (std::string(argv[i + 1]) == "json" || std::string(argv[i + 1]) == "text")) {
+                options.jsonReport = std::string(argv[++i]) == "json";
+            } else {
+                std::cerr << "Error: --report requires a format (text, json)" << std::endl;
+                return false;
+            }
+        } else if (arg == "--report-file") {
+            if (i + 1 < argc) {
+                options.reportPath = argv[++i];
+            } else {
+                std::cerr << "Error: --report-file requires an output file path" << std::endl;
+                return false;
+            }
+        } else if (arg == "--no-mesh-optimize") {
+            options.optimizeMesh = false;
+        } else if (arg == "--batch-materials") {
+            options.batchMaterials = true;
+        } else if (arg == "--quantize") {
+            options.quantize = true;
+        } else if (arg == "--reduce-keyframes") {
+            options.reduceKeyframes = true;
+        } else if (arg == "--key-tolerance") {
+            // <position>,<rotation degrees>,<scale>
+            float position = 0.0f, rotation = 0.0f, scale = 0.0f;
+            char extra = 0;
+            if (i + 1 >= argc ||
+                std::sscanf(argv[i + 1], "%f,%f,%f%c", &position, &rotation, &scale, &extra) != 3 ||
+                position < 0.0f || rotation < 0.0f || scale < 0.0f) {
+                std::cerr << "Error: --key-tolerance requires <position>,<rotation>,<scale>" << std::endl;
+                return false;
+            }
+            i++;
+            options.reduceKeyframes = true;
+            options.keyReduction.positionTolerance = position;
+            options.keyReduction.rotationTolerance = rotation;
+            options.keyReduction.scaleTolerance = scale;
+        } else if (arg == "--resample") {
+            float frameRate = 0.0f;
+            char extra = 0;
+            if (i + 1 >= argc || std::sscanf(argv[i + 1], "%f%c", &frameRate, &extra) != 1 ||
+                frameRate <= 0.0f || frameRate > 1000.0f) {
+                std::cerr << "Error: --resample requires a frame rate between 0 and 1000" << std::endl;
+                return false;
+            }
+            i++;
+            options.resampleAnimations = true;
+            options.resampling.frameRate = frameRate;
+        } else if (arg == "--animations") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --animations requires a comma-separated list of names" << std::endl;
+                return false;
+            }
+            std::string list = argv[++i];
+            for (size_t start = 0; start <= list.size();) {
+                size_t end = std::min(list.find(',', start), list.size());
+                if (end > start) {
+                    options.animationNames.push_back(list.substr(start, end - start));
+                }
+                start = end + 1;
+            }
+            if (options.animationNames.empty()) {
+                std::cerr << "Error: --animations requires at least one animation name" << std::endl;
+                return false;
+            }
+        } else if (arg == "--snapshot") {
+            if (i + 1 < argc) {
+                options.snapshotPath = argv[++i];
+            } else {
+                std::cerr << "Error: --snapshot requires an output file path" << std::endl;
+                return false;
+            }
+        } else if (arg == "--cache") {
+            if (i + 1 < argc) {
+                options.cache.directory = argv[++i];
+            } else {
+                std::cerr << "Error: --cache requires a directory" << std::endl;
+                return false;
+            }
+        } else if (arg == "--cache-size") {
+            if (i + 1 < argc) {
+                try {
+                    long long megabytes = std::stoll(argv[++i]);
+                    if (megabytes <= 0) throw std::out_of_range("non-positive");
+                    options.cache.maxBytes = static_cast<uint64_t>(megabytes) * 1024 * 1024;
+                } catch (const std::exception&) {
+                    std::cerr << "Error: --cache-size requires a positive number of megabytes" << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "Error: --cache-size requires a size in megabytes" << std::endl;
+                return false;
+            }
+        } else if (arg == "--read-ahead-mb" || arg == "--write-queue-mb") {
+            if (i + 1 < argc) {
+                try {
+                    long long megabytes = std::stoll(argv[++i]);
+                    if (megabytes < 0) throw std::out_of_range("negative");
+                    uint64_t bytes = static_cast<uint64_t>(megabytes) * 1024 * 1024;
+                    (arg == "--read-ahead-mb" ? options.prefetch.maxBytes : options.writes.maxQueuedBytes) = bytes;
+                } catch (const std::exception&) {
+                    std::cerr << "Error: " << arg << " requires a non-negative number of megabytes" << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "Error: " << arg << " requires a size in megabytes" << std::endl;
+                return false;
+            }
+        } else if (arg == "--profile" || arg == "--trace") {
+            if (i + 1 < argc) {
+                (arg == "--profile" ? options.profilePath : options.tracePath) = argv[++i];
+            } else {
+                std::cerr << "Error: " << arg << " requires an output file path" << std::endl;
+                return false;
+            }
+        } else if (arg == "--metrics") {
+            if (i + 1 < argc) {
+                options.metricsPath = argv[++i];
+            } else {
+                std::cerr << "Error: --metrics requires an output file path" << std::endl;
+                return false;
+            }
+        } else if (arg == "--metrics-interval") {
+            double seconds = 0.0;
+            char trailing = 0;
+            if (i + 1 < argc && std::sscanf(argv[i + 1], "%lf%c", &seconds, &trailing) == 1 && seconds >= 0.1) {
+                options.metricsInterval = seconds;
+                ++i;
+            } else {
+                std::cerr << "Error: --metrics-interval requires a number of seconds (at least 0.1)" << std::endl;
+                return false;
+            }
+        } else if (arg == "--max-decompress-seconds" || arg == "--max-decompressed-mb") {
+            double limit = 0.0;
+            char trailing = 0;
+            if (i + 1 < argc && std::sscanf(argv[i + 1], "%lf%c", &limit, &trailing) == 1 && limit >= 0.0) {
+                if (arg == "--max-decompress-seconds") {
+                    options.decompressionLimits.maxSeconds = limit;
+                } else {
+                    options.decompressionLimits.maxOutputBytes = static_cast<uint64_t>(limit * 1024 * 1024);
+                }
+                ++i;
+            } else {
+                std::cerr << "Error: " << arg << " requires a non-negative number (0 = no limit)" << std::endl;
+                return false;
+            }
+        } else if (arg == "--batch") {
+            if (i + 1 < argc) {
+                options.batchSource = argv[++i];
+            } else {
+                std::cerr << "Error: --batch requires a directory or list file" << std::endl;
+                return false;
+            }
+        } else if (arg == "--serve") {
+            if (i + 1 < argc) {
+                options.serveSocket = argv[++i];
+            } else {
+                std::cerr << "Error: --serve requires a socket path" << std::endl;
+                return false;
+            }
+        } else if (arg == "--jobs" || arg == "-j") {
+            if (i + 1 < argc) {
+                try {
+                    int jobs = std::stoi(argv[++i]);
+                    if (jobs < 0) throw std::out_of_range("negative");
+                    options.jobs = static_cast<size_t>(jobs);
+                } catch (const std::exception&) {
+                    std::cerr << "Error: --jobs requires a non-negative number" << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "Error: --jobs requires a number of worker threads" << std::endl;
+                return false;
+            }
+        } else if (arg == "--no-compress-arrays") {
+            options.compressArrays = false;
+        } else if (arg == "--resolve-textures") {
+            options.resolveTextures = true;
+        } else if (arg == "--embed-textures") {
+            options.embedTextures = true;
+        } else if (arg == "--reference-clip-textures") {
+            options.embedTexturesInClips = false;
+        } else if (arg == "--texture-dir") {
+            if (i + 1 < argc) {
+                options.textures.searchDirectories.push_back(argv[++i]);
+                options.resolveTextures = true;
+            } else {
+                std::cerr << "Error: --texture-dir requires a directory" << std::endl;
+                return false;
+            }
+        } else if (arg == "--compression-level") {
+            if (i + 1 < argc) {
+                try {
+                    int level = std::stoi(argv[++i]);
+                    if (level < 0 || level > 9) throw std::out_of_range("level");
+                    options.compressionLevel = level;
+                } catch (const std::exception&) {
+                    std::cerr << "Error: --compression-level requires a level from 0 to 9" << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "Error: --compression-level requires a zlib level (0-9)" << std::endl;
+                return false;
+            }
+        } else if (arg == "--fbx-backend") {
+            if (i + 1 < argc) {
+                std::string backend = argv[++i];
+                if (backend == "auto") options.fbxBackend = FBXExportOptions::Backend::AUTO;
+                else if (backend == "sdk") options.fbxBackend = FBXExportOptions::Backend::FBX_SDK;
+                else if (backend == "native") options.fbxBackend = FBXExportOptions::Backend::NATIVE;
+                else {
+                    std::cerr << "Error: Invalid FBX backend: " << backend << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "Error: --fbx-backend requires a backend (auto, sdk, native)" << std::endl;
+                return false;
+            }
+        } else if (arg == "--validate") {
+            if (i + 1 < argc) {
+                std::string level = argv[++i];
+                if (level == "none") options.validation = FBXExportOptions::Validation::NONE;
+                else if (level == "cheap") options.validation = FBXExportOptions::Validation::CHEAP;
+                else if (level == "full") options.validation = FBXExportOptions::Validation::FULL;
+                else {
+                    std::cerr << "Error: Invalid validation level: " << level << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "Error: --validate requires a level (none, cheap, full)" << std::endl;
+                return false;
+            }
         } else if (arg == "--output" || arg == "-o") {
             if (i + 1 < argc) {
                 options.outputDirectory = argv[++i];
@@ -163,11 +495,23 @@ bool ParseCommandLine(int argc, char* argv[], ConversionOptions& options) {
         }
     }
 
-    return !options.inputFile.empty();
+    if (!options.batchSource.empty() && !options.inputFile.empty()) {
+        std::cerr << "Error: --batch cannot be combined with a single input file" << std::endl;
+        return false;
+    }
+
+    if (!options.serveSocket.empty() && (!options.inputFile.empty() || !options.batchSource.empty())) {
+        std::cerr << "Error: --serve takes its inputs from requests, not the command line" << std::endl;
+        return false;
+    }
+
+    return !options.inputFile.empty() || !options.batchSource.empty() || !options.serveSocket.empty();
 }
 
 void PrintUsage(const std::string& programName) {
-    std::cout << "Usage: " << programName << " [OPTIONS] <input.x>" << std::endl << std::endl;
+    std::cout << "Usage: " << programName << " [OPTIONS] <input.x>" << std::endl;
+    std::cout << "       " << programName << " [OPTIONS] --batch <directory|listfile>" << std::endl;
+    std::cout << "       " << programName << " [OPTIONS] --serve <socket>" << std::endl << std::endl;
     std::cout << "Convert DirectX .x files to FBX format with proper animation timing" << std::endl << std::endl;
 
     std::cout << "Options:" << std::endl;
@@ -178,12 +522,68 @@ void PrintUsage(const std::string& programName) {
     std::cout << "  --strict                      Enable strict parsing mode" << std::endl;
     std::cout << "  --no-timing-validation        Disable animation timing validation" << std::endl;
     std::cout << "  --no-report                   Don't generate conversion report" << std::endl;
+    std::cout << "  --report <format>             text (default) or json: also write one NDJSON record" << std::endl;
+    std::cout << "                                per file with stage times, memory and counts, and in" << std::endl;
+    std::cout << "                                batches a closing record with the totals" << std::endl;
+    std::cout << "  --report-file <file>          Where --report json writes (default:" << std::endl;
+    std::cout << "                                <output>/x2fbx_report.ndjson, - for stdout)" << std::endl;
     std::cout << "  --log-level <level>           Set log level (debug, info, warning, error)" << std::endl;
+    std::cout << "  --no-mesh-optimize            Export vertices and triangles exactly as parsed" << std::endl;
+    std::cout << "  --batch-materials             Merge identical materials and static meshes, one" << std::endl;
+    std::cout << "                                submesh per material (with mesh optimization)" << std::endl;
+    std::cout << "  --quantize                    Carry positions/UVs as 16-bit, normals octahedral and" << std::endl;
+    std::cout << "                                rotation keys smallest-three; errors are reported" << std::endl;
+    std::cout << "  --fbx-backend <backend>       FBX writer: sdk, native (built-in binary writer) or" << std::endl;
+    std::cout << "                                auto, the SDK when compiled in (default: auto)" << std::endl;
+    std::cout << "  --validate <level>            Output checks: none, cheap (indices checked while" << std::endl;
+    std::cout << "                                writing) or full (files read back; on a background" << std::endl;
+    std::cout << "                                thread in batches) (default: cheap)" << std::endl;
+    std::cout << "  --compression-level <0-9>     zlib level of compressed FBX arrays (default: 6)" << std::endl;
+    std::cout << "  --no-compress-arrays          Store FBX arrays uncompressed" << std::endl;
+    std::cout << "  --resolve-textures            Find material textures as written, next to the input" << std::endl;
+    std::cout << "                                or in --texture-dir directories" << std::endl;
+    std::cout << "  --texture-dir <directory>     Also look for textures here (repeatable)" << std::endl;
+    std::cout << "  --embed-textures              Embed resolved textures in the FBX files" << std::endl;
+    std::cout << "  --reference-clip-textures     With --embed-textures, only the static mesh file" << std::endl;
+    std::cout << "                                embeds; per-animation files reference the textures" << std::endl;
+    std::cout << "  --reduce-keyframes            Drop keys that interpolation reproduces" << std::endl;
+    std::cout << "  --key-tolerance <p>,<r>,<s>   Reduction tolerances: position, rotation (degrees)," << std::endl;
+    std::cout << "                                scale (default: 0.001,0.05,0.001)" << std::endl;
+    std::cout << "  --resample <fps>              Evaluate every bone track at a fixed rate (lerp/slerp)" << std::endl;
+    std::cout << "                                and export at that frame rate" << std::endl;
+    std::cout << "  --animations <name,...>       Only decode and export these animation sets" << std::endl;
+    std::cout << "  --snapshot <file.x2s>         Save the parsed data; pass the snapshot as input" << std::endl;
+    std::cout << "                                later to re-export without parsing" << std::endl;
+    std::cout << "  --cache <directory>           Reuse FBX outputs of inputs converted before" << std::endl;
+    std::cout << "  --cache-size <MB>             Cache size limit, least recently used entries are" << std::endl;
+    std::cout << "                                evicted first (default: 1024)" << std::endl;
+    std::cout << "  --profile <file.json>         Write a per-phase timing summary as JSON" << std::endl;
+    std::cout << "  --trace <file.json>           Write a Chrome trace-event file of every phase" << std::endl;
+    std::cout << "  --metrics <file.prom>         Keep progress counters and per-worker state in a" << std::endl;
+    std::cout << "                                Prometheus text file while running" << std::endl;
+    std::cout << "  --metrics-interval <s>        Seconds between metrics file updates (default: 5)" << std::endl;
+    std::cout << "  --max-decompress-seconds <s>  Fail a compressed file still decompressing after" << std::endl;
+    std::cout << "                                this long (default: 0, no limit)" << std::endl;
+    std::cout << "  --max-decompressed-mb <MB>    Fail a compressed file that inflates to more than" << std::endl;
+    std::cout << "                                this (default: 0, no limit)" << std::endl;
+    std::cout << "  --batch <dir|listfile>        Convert every .x file in a directory (recursive)" << std::endl;
+    std::cout << "                                or listed one per line in a text file" << std::endl;
+    std::cout << "  --read-ahead-mb <MB>          Batch inputs read ahead of the workers at most" << std::endl;
+    std::cout << "                                (default: 256, 0 = workers read their own)" << std::endl;
+    std::cout << "  --write-queue-mb <MB>         Batch FBX bytes queued for the writer thread at most" << std::endl;
+    std::cout << "                                (default: 256, 0 = workers write their own)" << std::endl;
+    std::cout << "  --serve <socket>              Stay running and convert JSON requests sent to a" << std::endl;
+    std::cout << "                                Unix-domain socket; the options above are defaults" << std::endl;
+    std::cout << "  -j, --jobs <n>                Worker threads for batch files or server connections," << std::endl;
+    std::cout << "                                or for parsing and exporting a single file" << std::endl;
+    std::cout << "                                (default: hardware threads)" << std::endl;
 
     std::cout << std::endl << "Examples:" << std::endl;
     std::cout << "  " << programName << " character.x" << std::endl;
     std::cout << "  " << programName << " --verbose --output ./fbx_files character.x" << std::endl;
     std::cout << "  " << programName << " --strict --log-level debug model.x" << std::endl;
+    std::cout << "  " << programName << " --batch ./assets --jobs 8 --output ./fbx_files" << std::endl;
+    std::cout << "  " << programName << " --serve /tmp/x2fbx.sock --jobs 4 --fbx-backend native" << std::endl;
 
     std::cout << std::endl << "Output:" << std::endl;
     std::cout << "  For each animation in the .x file, a separate .fbx file will be created:" << std::endl;
@@ -197,7 +597,7 @@ void PrintVersion() {
     std::cout << "Supports multiple animations, bone hierarchy preservation, and timing correction" << std::endl;
 }
 
-bool ValidateInputFile(const std::string& filepath) {
+bool ValidateInputFile(const std::string& filepath, XFileProbe& probe) {
     if (!fs::exists(filepath)) {
         std::cerr << "Error: Input file does not exist: " << filepath << std::endl;
         return false;
@@ -212,12 +612,13 @@ bool ValidateInputFile(const std::string& filepath) {
     std::string extension = fs::path(filepath).extension().string();
     std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
 
-    if (extension != ".x") {
+    if (extension != ".x" && extension != XFileSnapshot::FILE_EXTENSION) {
         std::cerr << "Warning: Input file does not have .x extension: " << extension << std::endl;
     }
 
-    // Validate .x file signature
-    if (!XFileParser::IsValidXFile(filepath)) {
+    // One read of the header covers .x signatures and snapshots of parsed files
+    probe = ProbeXFile(filepath);
+    if (!probe.recognized) {
         std::cerr << "Error: Input file is not a valid DirectX .x file" << std::endl;
         return false;
     }
@@ -241,111 +642,481 @@ bool CreateOutputDirectory(const std::string& dirPath) {
     }
 }
 
-bool ConvertXFileToFBX(const ConversionOptions& options) {
-    try {
-        std::cout << "Parsing DirectX .x file..." << std::endl;
+int RunBatchConversion(const ConversionOptions& options) {
+    BatchOptions batchOptions;
+    batchOptions.source = options.batchSource;
+    batchOptions.outputDirectory = options.outputDirectory;
+    batchOptions.jobs = options.jobs;
+    batchOptions.strictMode = options.strictMode;
+    batchOptions.verboseLogging = options.verboseLogging;
+    batchOptions.validateTiming = options.validateTiming;
+    batchOptions.reduceKeyframes = options.reduceKeyframes;
+    batchOptions.keyReduction = options.keyReduction;
+    batchOptions.resampleAnimations = options.resampleAnimations;
+    batchOptions.resampling = options.resampling;
+    batchOptions.optimizeMesh = options.optimizeMesh;
+    batchOptions.batchMaterials = options.batchMaterials;
+    batchOptions.quantize = options.quantize;
+    batchOptions.fbxBackend = options.fbxBackend;
+    batchOptions.compressArrays = options.compressArrays;
+    batchOptions.compressionLevel = options.compressionLevel;
+    batchOptions.animationNames = options.animationNames;
+    batchOptions.decompressionLimits = options.decompressionLimits;
+    batchOptions.cache = options.cache;
+    batchOptions.resolveTextures = options.resolveTextures;
+    batchOptions.embedTextures = options.embedTextures;
+    batchOptions.embedTexturesInClips = options.embedTexturesInClips;
+    batchOptions.textures = options.textures;
+    batchOptions.prefetch = options.prefetch;
+    batchOptions.writes = options.writes;
+    batchOptions.validation = options.validation;
 
-        // Parse the .x file
-        EnhancedXFileParser parser;
-        parser.SetStrictMode(options.strictMode);
-        parser.SetVerboseLogging(options.verboseLogging);
+    if (!CreateOutputDirectory(options.outputDirectory)) {
+        LOG_CRITICAL("Failed to create output directory");
+        std::cerr << "Error: Cannot create output directory: " << options.outputDirectory << std::endl;
+        return 1;
+    }
 
-        if (!parser.ParseFile(options.inputFile)) {
-            LOG_ERROR("Failed to parse .x file");
-            return false;
+    std::vector<std::string> inputFiles = BatchConverter::CollectInputFiles(batchOptions.source, batchOptions.recursive);
+    if (inputFiles.empty()) {
+        std::cerr << "Error: No .x files found in batch source: " << batchOptions.source << std::endl;
+        return 1;
+    }
+
+    std::cout << "Batch converting " << inputFiles.size() << " files..." << std::endl;
+
+    // Per-file log lines from many workers would drown the console; keep them in the log file
+    if (!options.verboseLogging) {
+        Logger::GetInstance().EnableConsoleOutput(false);
+    }
+
+    BatchConverter converter(batchOptions);
+    BatchSummary summary = converter.Run(inputFiles);
+
+    Logger::GetInstance().EnableConsoleOutput(true);
+    Logger::GetInstance().Flush();
+    BatchConverter::PrintSummary(summary);
+    if (options.jsonReport) {
+        std::string reportPath = ResolveReportPath(options);
+        if (BatchConverter::WriteReport(summary, reportPath) && reportPath != "-") {
+            std::cout << "Conversion report: " << reportPath << std::endl;
+        }
+    }
+
+    LOG_INFO("Batch conversion finished: " + std::to_string(summary.succeeded) + "/" +
+             std::to_string(summary.totalFiles) + " files succeeded");
+    return summary.failed == 0 ? 0 : 1;
+}
+
+int RunConversionServer(const ConversionOptions& options) {
+    if (!ConversionServer::IsSupported()) {
+        std::cerr << "Error: --serve is not supported on this platform" << std::endl;
+        return 1;
+    }
+
+    ConversionServerOptions serverOptions;
+    serverOptions.socketPath = options.serveSocket;
+    serverOptions.workers = options.jobs;
+    BatchOptions& defaults = serverOptions.defaults;
+    defaults.outputDirectory = options.outputDirectory;
+    defaults.strictMode = options.strictMode;
+    defaults.verboseLogging = options.verboseLogging;
+    defaults.validateTiming = options.validateTiming;
+    defaults.reduceKeyframes = options.reduceKeyframes;
+    defaults.keyReduction = options.keyReduction;
+    defaults.resampleAnimations = options.resampleAnimations;
+    defaults.resampling = options.resampling;
+    defaults.optimizeMesh = options.optimizeMesh;
+    defaults.batchMaterials = options.batchMaterials;
+    defaults.quantize = options.quantize;
+    defaults.fbxBackend = options.fbxBackend;
+    defaults.compressArrays = options.compressArrays;
+    defaults.compressionLevel = options.compressionLevel;
+    defaults.animationNames = options.animationNames;
+    defaults.decompressionLimits = options.decompressionLimits;
+    defaults.cache = options.cache;
+    defaults.resolveTextures = options.resolveTextures;
+    defaults.embedTextures = options.embedTextures;
+    defaults.embedTexturesInClips = options.embedTexturesInClips;
+    defaults.textures = options.textures;
+    defaults.validation = options.validation;
+
+    ConversionServer server(serverOptions);
+    if (!server.Start()) {
+        LOG_CRITICAL("Conversion server failed to start: " + server.GetError());
+        std::cerr << "Error: " << server.GetError() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Serving conversion requests on " << options.serveSocket << std::endl;
+
+    // As in batch mode, per-request log lines go to the log file only
+    if (!options.verboseLogging) {
+        Logger::GetInstance().EnableConsoleOutput(false);
+    }
+    server.Serve();
+    Logger::GetInstance().EnableConsoleOutput(true);
+    Logger::GetInstance().Flush();
+
+    std::cout << "Conversion server stopped after " << server.GetRequestsHandled() << " requests" << std::endl;
+    return 0;
+}
+
+std::string ResolveReportPath(const ConversionOptions& options) {
+    if (!options.reportPath.empty()) {
+        return options.reportPath;
+    }
+    return (fs::path(options.outputDirectory) / "x2fbx_report.ndjson").string();
+}
+
+void WriteProfileOutputs(const ConversionOptions& options) {
+    Profiler& profiler = Profiler::GetInstance();
+    if (!profiler.IsEnabled()) {
+        return;
+    }
+    if (!options.profilePath.empty() && profiler.WriteSummary(options.profilePath)) {
+        std::cout << "Profile summary: " << options.profilePath << std::endl;
+    }
+    if (!options.tracePath.empty() && profiler.WriteChromeTrace(options.tracePath)) {
+        std::cout << "Profile trace: " << options.tracePath << std::endl;
+    }
+}
+
+bool ConvertXFileToFBX(const ConversionOptions& options, const XFileProbe& probe, ConversionRecord& record) {
+    TIME_OPERATION("ConvertXFileToFBX");
+    // Ends as failed on every early return
+    MetricsWorkerSlot metrics;
+    metrics.BeginFile(options.inputFile);
+    // The only conversion running, so every thread's CPU time counts
+    StageRecorder costs(record, StageClock::Scope::PROCESS, &record.parse);
+    record.input = options.inputFile;
+    std::error_code sizeError;
+    record.inputBytes = fs::file_size(options.inputFile, sizeError);
+    record.SetInput(probe.header, probe.snapshot, XParseStatistics());
+    try {
+        FBXExportOptions exportOptions;
+        exportOptions.optimizeMesh = options.optimizeMesh;
+        exportOptions.batchMaterials = options.batchMaterials;
+        exportOptions.quantize = options.quantize;
+        exportOptions.backend = options.fbxBackend;
+        exportOptions.compressArrays = options.compressArrays;
+        exportOptions.compressionLevel = options.compressionLevel;
+        exportOptions.compressionThreads = options.jobs;
+        exportOptions.animationExportThreads = options.jobs;
+        exportOptions.skinClusterThreads = options.jobs;
+        exportOptions.embedTextures = options.embedTextures;
+        exportOptions.embedTexturesInClips = options.embedTexturesInClips;
+        exportOptions.validation = options.validation;
+        if (options.resampleAnimations) {
+            exportOptions.animationFrameRate = options.resampling.frameRate;
+        }
+        const AnimationResampleOptions* resampling = options.resampleAnimations ? &options.resampling : nullptr;
+
+        std::string baseName = fs::path(options.inputFile).stem().string();
+
+        // An identical input converted with the same options is restored
+        // without parsing (unless the parse itself is wanted as a snapshot,
+        // or texture files are read, which only the parse names)
+        const bool resolveTextures = options.resolveTextures || options.embedTextures;
+        TextureLibrary textureLibrary(options.textures);
+        ConversionCache cache(options.cache);
+        std::string cacheKey;
+        if (cache.IsEnabled() && options.snapshotPath.empty() && !resolveTextures) {
+            cacheKey = cache.ComputeKey(options.inputFile,
+                                        ConversionCache::Fingerprint(exportOptions, options.strictMode,
+                                                                     options.reduceKeyframes ? &options.keyReduction : nullptr,
+                                                                     options.animationNames, resampling));
+            CachedConversion cached;
+            if (cache.Restore(cacheKey, options.outputDirectory, baseName, cached)) {
+                record.cacheHit = true;
+                record.outputs = cached.outputPaths.size();
+                std::cout << "✓ Cache hit: reusing " << cached.outputPaths.size() << " FBX files" << std::endl;
+                for (const auto& outputPath : cached.outputPaths) {
+                    std::cout << "  ✓ Restored " << fs::path(outputPath).filename().string() << std::endl;
+                }
+                if (options.generateReport) {
+                    AnimationTimingCorrector::LogTimingReport(cached.timingReport);
+                }
+                metrics.EndFile(true);
+                return true;
+            }
+        }
+        CachedConversion produced;
+
+        // A miss on the whole conversion can still reuse earlier stages
+        metrics.EnterStage(ConversionStage::PARSE);
+        ConversionStages stages(cache);
+        MeshOptimizationOptions meshOptions;
+        meshOptions.batchMaterials = options.batchMaterials;
+        const MeshOptimizationOptions* optimization = options.optimizeMesh ? &meshOptions : nullptr;
+        StageKeys stageKeys;
+        if (cache.IsEnabled() && options.snapshotPath.empty()) {
+            stageKeys = stages.ComputeKeys(options.inputFile, options.strictMode, options.animationNames,
+                                           optimization,
+                                           options.reduceKeyframes ? &options.keyReduction : nullptr,
+                                           resampling, options.quantize);
         }
 
-        XFileData fileData = parser.TakeParsedData();
+        XFileData fileData;
+        bool prepared = stageKeys.IsValid() && stages.LoadData(stageKeys.prepare, fileData, &produced.timingReport);
+        record.parseSkipped = prepared;
+        if (prepared) {
+            std::cout << "✓ Reusing prepared data from cache (parse, mesh optimization and timing correction skipped)"
+                      << std::endl;
+            if (options.generateReport) {
+                AnimationTimingCorrector::LogTimingReport(produced.timingReport);
+            }
+        } else if (stageKeys.IsValid() && stages.LoadData(stageKeys.parse, fileData)) {
+            record.parseSkipped = true;
+            std::cout << "✓ Reusing parsed data from cache" << std::endl;
+        } else {
+            std::cout << "Parsing DirectX .x file..." << std::endl;
+
+            // Parse the .x file
+            EnhancedXFileParser parser;
+            parser.SetStrictMode(options.strictMode);
+            parser.SetVerboseLogging(options.verboseLogging);
+            // Unselected animation sets are only indexed, never decoded
+            parser.SetAnimationFilter(options.animationNames);
+            parser.SetParseThreads(options.jobs);
+            parser.SetDecompressionLimits(options.decompressionLimits);
+
+            bool parsed = parser.ParseFile(options.inputFile, probe);
+            record.SetInput(probe.header, probe.snapshot, parser.GetParsedData().statistics);
+            if (!parsed) {
+                LOG_ERROR("Failed to parse .x file");
+                record.error = "Failed to parse .x file";
+                return false;
+            }
+
+            fileData = parser.TakeParsedData();
+            if (stageKeys.IsValid()) {
+                stages.StoreData(stageKeys.parse, fileData);
+            }
+        }
 
         std::cout << "✓ Parsed " << fileData.meshData.GetVertexCount() << " vertices, "
                   << fileData.meshData.GetFaceCount() << " faces" << std::endl;
 
-        if (fileData.meshData.GetAnimationCount() > 0) {
+        if (!options.animationNames.empty()) {
+            // Snapshots carry every decoded set, so the filter is applied here too
+            auto& animations = fileData.meshData.animations;
+            animations.erase(std::remove_if(animations.begin(), animations.end(), [&](const XAnimationSet& anim) {
+                return !XFileUtils::MatchesAnimationFilter(options.animationNames, anim.name);
+            }), animations.end());
+
+            for (const auto& name : options.animationNames) {
+                bool found = std::any_of(fileData.animationSets.begin(), fileData.animationSets.end(),
+                                         [&](const XAnimationSetInfo& info) { return info.name == name; }) ||
+                             std::any_of(animations.begin(), animations.end(),
+                                         [&](const XAnimationSet& anim) { return anim.name == name; });
+                if (!found) {
+                    LOG_WARNING("Animation set not found: " + name);
+                }
+            }
+            std::cout << "✓ Selected " << animations.size() << " of "
+                      << std::max(fileData.animationSets.size(), animations.size()) << " animation sets" << std::endl;
+        }
+
+        // Saved before any correction, so re-exports start from the parse
+        if (!options.snapshotPath.empty()) {
+            if (!XFileSnapshot::Write(fileData, options.snapshotPath, options.quantize)) {
+                record.error = "Cannot write snapshot: " + options.snapshotPath;
+                return false;
+            }
+            std::cout << "✓ Snapshot saved: " << options.snapshotPath << std::endl;
+        }
+
+        if (resolveTextures) {
+            // Read in the background while the mesh is prepared
+            exportOptions.textures = textureLibrary.Request(fileData.meshData, options.inputFile, options.embedTextures);
+        }
+
+        const bool animated = fileData.meshData.GetAnimationCount() > 0;
+        if (animated) {
             std::cout << "✓ Found " << fileData.meshData.GetAnimationCount() << " animations" << std::endl;
+        }
+
+        std::vector<TimingCorrectionResult> timingResults;
+        costs.Enter(&record.correct);
+        if (!prepared) {
+            metrics.EnterStage(ConversionStage::PREPARE);
+            // Before export, so skin clusters are built from the welded vertices
+            if (optimization) {
+                MeshOptimizer optimizer(meshOptions);
+                MeshOptimizationResult optimized = optimizer.Optimize(fileData.meshData);
+                if (optimized.applied) {
+                    std::cout << "✓ Mesh optimization: " << optimized.remainingVertices << "/" << optimized.originalVertices
+                              << " vertices, " << optimized.degenerateTriangles << " degenerate triangles removed"
+                              << std::endl;
+                }
+                if (options.batchMaterials) {
+                    MeshMergeResult merged = optimizer.MergeMeshes(fileData.meshes);
+                    std::cout << "✓ Material batching: " << optimized.remainingMaterials << "/"
+                              << optimized.originalMaterials << " materials in " << optimized.submeshes
+                              << " submeshes";
+                    if (merged.originalMeshes > 0) {
+                        std::cout << ", " << merged.remainingMeshes << "/" << merged.originalMeshes << " extra meshes";
+                    }
+                    std::cout << std::endl;
+                }
+                if (options.generateReport) {
+                    optimizer.GenerateOptimizationReport(optimized);
+                }
+            }
 
-            // Correct animation timing
-            std::cout << "Correcting animation timing..." << std::endl;
+            if (animated) {
+                // Correct animation timing
+                std::cout << "Correcting animation timing..." << std::endl;
+
+                AnimationTimingCorrector timingCorrector;
+                timingCorrector.SetThreadCount(options.jobs);
+                timingResults = timingCorrector.CorrectAllAnimations(fileData.meshData.animations);
+
+                // Validate timing correction if requested
+                if (options.validateTiming) {
+                    std::cout << "Validating timing corrections..." << std::endl;
+
+                    int validCorrections = 0;
+                    for (const auto& result : timingResults) {
+                        if (result.isValid) {
+                            validCorrections++;
+                        } else {
+                            LOG_WARNING("Animation timing correction failed: " + result.errorDescription);
+                        }
+                    }
 
-            AnimationTimingCorrector timingCorrector;
-            std::vector<TimingCorrectionResult> timingResults =
-                timingCorrector.CorrectAllAnimations(fileData.meshData.animations);
+                    std::cout << "✓ " << validCorrections << "/" << timingResults.size()
+                              << " animations have valid timing" << std::endl;
+                }
 
-            // Validate timing correction if requested
-            if (options.validateTiming) {
-                std::cout << "Validating timing corrections..." << std::endl;
+                // Generate timing report
+                produced.timingReport = timingCorrector.BuildTimingReport(timingResults);
+                if (options.generateReport) {
+                    AnimationTimingCorrector::LogTimingReport(produced.timingReport);
+                }
 
-                int validCorrections = 0;
-                for (const auto& result : timingResults) {
-                    if (result.isValid) {
-                        validCorrections++;
-                    } else {
-                        LOG_WARNING("Animation timing correction failed: " + result.errorDescription);
+                if (options.reduceKeyframes) {
+                    KeyframeReductionOptions reduction = options.keyReduction;
+                    reduction.threads = options.jobs;
+                    KeyframeReductionResult reduced =
+                        KeyframeReducer(reduction).ReduceAllAnimations(fileData.meshData.animations);
+
+                    std::cout << "✓ Keyframe reduction removed " << reduced.RemovedKeys() << "/" << reduced.originalKeys
+                              << " keys (~" << reduced.BytesSaved() / 1024 << " KB of key data)" << std::endl;
+                    if (options.generateReport) {
+                        KeyframeReducer(reduction).GenerateReductionReport(reduced);
                     }
                 }
 
-                std::cout << "✓ " << validCorrections << "/" << timingResults.size()
-                          << " animations have valid timing" << std::endl;
+                // Last, so reduced tracks still come out uniformly sampled
+                if (resampling) {
+                    AnimationResampleOptions resample = *resampling;
+                    resample.threads = options.jobs;
+                    AnimationResampler resampler(resample);
+                    AnimationResampleResult resampled = resampler.ResampleAllAnimations(fileData.meshData.animations);
+
+                    std::cout << "✓ Resampled " << resampled.channels << " channels at " << resample.frameRate
+                              << " fps (" << resampled.originalKeys << " keys -> " << resampled.resampledKeys << ")"
+                              << std::endl;
+                    if (options.generateReport) {
+                        resampler.GenerateResampleReport(resampled);
+                    }
+                }
             }
 
-            // Generate timing report
-            if (options.generateReport) {
-                timingCorrector.GenerateTimingReport(timingResults);
+            // Last, so every pass above works at full precision
+            if (options.quantize) {
+                StreamQuantizer quantizer;
+                QuantizationResult quantized = quantizer.Quantize(fileData);
+                std::cout << "✓ Quantized " << quantized.vertices << " vertices and " << quantized.rotationKeys
+                          << " rotation keys (" << quantized.floatBytes / 1024 << " KB -> "
+                          << quantized.quantizedBytes / 1024 << " KB); max error position "
+                          << quantized.maxPositionError << ", uv " << quantized.maxTexCoordError << ", normal "
+                          << quantized.maxNormalErrorDegrees << " deg, rotation " << quantized.maxRotationErrorDegrees
+                          << " deg" << std::endl;
+                if (options.generateReport) {
+                    quantizer.GenerateQuantizationReport(quantized, options.inputFile);
+                }
+            }
+
+            if (stageKeys.IsValid()) {
+                stages.StoreData(stageKeys.prepare, fileData, produced.timingReport, options.quantize);
             }
+        }
 
+        // Before the static mesh is moved into its export
+        record.SetCounts(fileData);
+        costs.Enter(&record.exported);
+        metrics.EnterStage(ConversionStage::EXPORT);
+        if (animated) {
             // Print conversion summary
             PrintConversionSummary(fileData, timingResults);
 
-            // TODO: Export individual FBX files for each animation
             std::cout << "Exporting FBX files..." << std::endl;
 
-            std::string baseName = fs::path(options.inputFile).stem().string();
-
-            for (size_t i = 0; i < fileData.meshData.animations.size(); i++) {
-                const auto& animation = fileData.meshData.animations[i];
-
-                std::string outputFileName = baseName + "_" + animation.name + ".fbx";
-                std::string outputPath = (fs::path(options.outputDirectory) / outputFileName).string();
-
-                // For now, just create placeholder files (FBX export would go here)
-                std::ofstream placeholder(outputPath);
-                if (placeholder.is_open()) {
-                    placeholder << "# FBX file placeholder for animation: " << animation.name << std::endl;
-                    placeholder << "# Duration: " << animation.GetDurationInSeconds() << " seconds" << std::endl;
-                    placeholder << "# Keyframes: " << animation.keyframes.size() << std::endl;
-                    placeholder.close();
-
-                    std::cout << "  ✓ Created " << outputFileName << std::endl;
+            // One file per clip; clips are exported concurrently, unchanged
+            // ones are restored from the cache
+            FBXExporter exporter;
+            size_t restoredClips = 0;
+            std::vector<FBXExportResult> exportResults =
+                stages.ExportAnimations(exporter, fileData.meshData, options.outputDirectory, baseName, exportOptions,
+                                        restoredClips);
+
+            bool allExported = true;
+            for (size_t i = 0; i < exportResults.size(); i++) {
+                if (exportResults[i].success) {
+                    std::cout << "  ✓ Created " << fs::path(exportResults[i].outputPath).filename().string() << std::endl;
+                    produced.outputPaths.push_back(exportResults[i].outputPath);
                 } else {
-                    LOG_ERROR("Failed to create output file: " + outputPath);
-                    return false;
+                    LOG_ERROR("Failed to export animation '" + fileData.meshData.animations[i].name + "': " +
+                              exportResults[i].errorMessage);
+                    record.error = exportResults[i].errorMessage;
+                    allExported = false;
                 }
             }
+            if (!allExported) {
+                return false;
+            }
+            if (restoredClips > 0) {
+                std::cout << "✓ " << restoredClips << "/" << exportResults.size()
+                          << " clips unchanged, restored from cache" << std::endl;
+            }
 
         } else {
             std::cout << "No animations found, creating static mesh..." << std::endl;
 
-            std::string baseName = fs::path(options.inputFile).stem().string();
             std::string outputFileName = baseName + ".fbx";
-            std::string outputPath = (fs::path(options.outputDirectory) / outputFileName).string();
 
-            // Create static mesh placeholder
-            std::ofstream placeholder(outputPath);
-            if (placeholder.is_open()) {
-                placeholder << "# FBX file placeholder for static mesh" << std::endl;
-                placeholder << "# Vertices: " << fileData.meshData.GetVertexCount() << std::endl;
-                placeholder << "# Faces: " << fileData.meshData.GetFaceCount() << std::endl;
-                placeholder.close();
+            // The mesh is not needed afterwards; streaming it into the scene
+            // keeps large environments from being resident twice
+            FBXExporter exporter;
+            bool restored = false;
+            FBXExportResult exportResult = stages.ExportStaticMesh(exporter, std::move(fileData.meshData),
+                                                                   options.outputDirectory, baseName, exportOptions,
+                                                                   restored);
+            if (!exportResult.success) {
+                LOG_ERROR("Failed to export static mesh: " + exportResult.errorMessage);
+                record.error = exportResult.errorMessage;
+                return false;
+            }
 
-                std::cout << "  ✓ Created " << outputFileName << std::endl;
+            if (restored) {
+                std::cout << "  ✓ Restored " << outputFileName << " (mesh unchanged)" << std::endl;
             } else {
-                LOG_ERROR("Failed to create output file: " + outputPath);
-                return false;
+                std::cout << "  ✓ Created " << outputFileName << " (peak RSS "
+                          << exportResult.peakRssBytes / (1024 * 1024) << " MB)" << std::endl;
             }
+            produced.outputPaths.push_back(exportResult.outputPath);
         }
 
+        cache.Store(cacheKey, baseName, produced);
+        record.outputs = produced.outputPaths.size();
+        metrics.EndFile(true);
         return true;
 
     } catch (const std::exception& e) {
+        record.error = "Exception during conversion: " + std::string(e.what());
         LOG_CRITICAL("Exception during conversion: " + std::string(e.what()));
         std::cerr << "Exception: " << e.what() << std::endl;
         return false;
@@ -372,12 +1143,15 @@ void PrintConversionSummary(const XFileData& fileData,
             std::cout << "  - Global ticks/sec: " << fileData.meshData.globalTicksPerSecond << std::endl;
         }
 
+        size_t animationBytes = 0;
         for (size_t i = 0; i < fileData.meshData.animations.size(); i++) {
             const auto& anim = fileData.meshData.animations[i];
             std::cout << "  - '" << anim.name << "': "
                       << anim.GetDurationInSeconds() << "s ("
-                      << anim.keyframes.size() << " keyframes)" << std::endl;
+                      << anim.GetKeyCount() << " keyframes)" << std::endl;
+            animationBytes += anim.GetMemoryUsage();
         }
+        std::cout << "  - Key storage: " << animationBytes / 1024.0 << " KB" << std::endl;
 
         // Timing correction summary
         if (!timingResults.empty()) {
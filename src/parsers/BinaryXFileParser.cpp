@@ -1,9 +1,15 @@
 #include "BinaryXFileParser.h"
+#include "ConversionMetrics.h"
+#include "MappedFile.h"
+#include "MszipDecoder.h"
+#include "XFileSnapshot.h"
 #include <fstream>
 #include <iostream>
 #include <algorithm>
 #include <cstring>
 #include <cstdio>
+#include <chrono>
+#include <type_traits>
 
 #ifdef HAVE_BZIP2
 #include <bzlib.h>
@@ -19,78 +25,110 @@ namespace X2FBX {
 // BinaryReader Implementation
 // =============================================================================
 
-BinaryReader::BinaryReader(const uint8_t* data, size_t size, bool littleEndian)
-    : data_(data), size_(size), position_(0), littleEndian_(littleEndian) {
+namespace {
+
+// Bulk array reads grow their result in steps of this many elements, so a
+// corrupt count fails on missing data long before it exhausts memory
+constexpr size_t ARRAY_CHUNK = 1 << 16;
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool HOST_LITTLE_ENDIAN = false;
+#else
+constexpr bool HOST_LITTLE_ENDIAN = true;
+#endif
+
+template <size_t WordBytes>
+void SwapWords(uint8_t* bytes, size_t count) {
+    for (size_t i = 0; i < count; ++i, bytes += WordBytes) {
+        std::reverse(bytes, bytes + WordBytes);
+    }
 }
 
-uint8_t BinaryReader::ReadUInt8() {
-    if (position_ >= size_) {
-        throw std::runtime_error("BinaryReader: Read beyond end of data");
+// One word in file byte order; a plain load when it matches the host
+template <typename Word, bool LittleEndian>
+Word LoadWord(const uint8_t* bytes) {
+    Word value;
+    std::memcpy(&value, bytes, sizeof(Word));
+    if constexpr (LittleEndian != HOST_LITTLE_ENDIAN) {
+        SwapWords<sizeof(Word)>(reinterpret_cast<uint8_t*>(&value), 1);
     }
-    return data_[position_++];
+    return value;
 }
 
-uint16_t BinaryReader::ReadUInt16() {
-    if (position_ + 2 > size_) {
-        throw std::runtime_error("BinaryReader: Read beyond end of data");
+} // namespace
+
+BinaryReader::BinaryReader(const uint8_t* data, size_t size, bool littleEndian)
+    : data_(data), size_(size), position_(0), littleEndian_(littleEndian),
+      source_(nullptr), windowSize_(0), windowOffset_(0) {
+}
+
+BinaryReader::BinaryReader(ByteSource& source, size_t windowSize, bool littleEndian)
+    : data_(nullptr), size_(0), position_(0), littleEndian_(littleEndian),
+      source_(&source), windowSize_(std::max<size_t>(windowSize, 64)), windowOffset_(0) {
+    window_.reserve(windowSize_);
+    data_ = window_.data();
+}
+
+bool BinaryReader::Refill(size_t bytes) {
+    if (!source_) {
+        return false;
     }
 
-    uint16_t value;
-    if (littleEndian_) {
-        value = data_[position_] | (data_[position_ + 1] << 8);
-    } else {
-        value = (data_[position_] << 8) | data_[position_ + 1];
+    // Drop consumed bytes, then top the window up from the source. Single
+    // reads larger than the window (long strings) grow it temporarily.
+    size_t unread = size_ - position_;
+    if (position_ > 0) {
+        std::memmove(window_.data(), window_.data() + position_, unread);
+        windowOffset_ += position_;
+        position_ = 0;
+    }
+
+    size_t capacity = std::max({windowSize_, bytes, unread});
+    window_.resize(capacity);
+    const size_t kept = unread;
+    while (unread < bytes) {
+        size_t count = source_->Read(window_.data() + unread, capacity - unread);
+        if (count == 0) break;
+        unread += count;
+    }
+    ConversionMetrics::GetInstance().AddBytesDecompressed(unread - kept);
+
+    window_.resize(unread);
+    data_ = window_.data();
+    size_ = unread;
+
+    if (source_->HasError()) {
+        throw std::runtime_error("BinaryReader: " + source_->GetError());
     }
+    return unread >= bytes;
+}
+
+void BinaryReader::ThrowOutOfData(const char* operation) const {
+    throw std::runtime_error(std::string("BinaryReader: ") + operation + " beyond end of data");
+}
+
+uint8_t BinaryReader::ReadUInt8() {
+    Require(1, "Read");
+    return data_[position_++];
+}
+
+uint16_t BinaryReader::ReadUInt16() {
+    uint16_t value = PeekUInt16();
     position_ += 2;
     return value;
 }
 
 uint32_t BinaryReader::ReadUInt32() {
-    if (position_ + 4 > size_) {
-        throw std::runtime_error("BinaryReader: Read beyond end of data");
-    }
-
-    uint32_t value;
-    if (littleEndian_) {
-        value = data_[position_] |
-                (data_[position_ + 1] << 8) |
-                (data_[position_ + 2] << 16) |
-                (data_[position_ + 3] << 24);
-    } else {
-        value = (data_[position_] << 24) |
-                (data_[position_ + 1] << 16) |
-                (data_[position_ + 2] << 8) |
-                data_[position_ + 3];
-    }
+    uint32_t value = PeekUInt32();
     position_ += 4;
     return value;
 }
 
 uint64_t BinaryReader::ReadUInt64() {
-    if (position_ + 8 > size_) {
-        throw std::runtime_error("BinaryReader: Read beyond end of data");
-    }
-
-    uint64_t value;
-    if (littleEndian_) {
-        value = static_cast<uint64_t>(data_[position_]) |
-                (static_cast<uint64_t>(data_[position_ + 1]) << 8) |
-                (static_cast<uint64_t>(data_[position_ + 2]) << 16) |
-                (static_cast<uint64_t>(data_[position_ + 3]) << 24) |
-                (static_cast<uint64_t>(data_[position_ + 4]) << 32) |
-                (static_cast<uint64_t>(data_[position_ + 5]) << 40) |
-                (static_cast<uint64_t>(data_[position_ + 6]) << 48) |
-                (static_cast<uint64_t>(data_[position_ + 7]) << 56);
-    } else {
-        value = (static_cast<uint64_t>(data_[position_]) << 56) |
-                (static_cast<uint64_t>(data_[position_ + 1]) << 48) |
-                (static_cast<uint64_t>(data_[position_ + 2]) << 40) |
-                (static_cast<uint64_t>(data_[position_ + 3]) << 32) |
-                (static_cast<uint64_t>(data_[position_ + 4]) << 24) |
-                (static_cast<uint64_t>(data_[position_ + 5]) << 16) |
-                (static_cast<uint64_t>(data_[position_ + 6]) << 8) |
-                static_cast<uint64_t>(data_[position_ + 7]);
-    }
+    Require(8, "Read");
+
+    const uint8_t* bytes = data_ + position_;
+    uint64_t value = littleEndian_ ? LoadWord<uint64_t, true>(bytes) : LoadWord<uint64_t, false>(bytes);
     position_ += 8;
     return value;
 }
@@ -126,21 +164,27 @@ double BinaryReader::ReadDouble() {
 }
 
 std::string BinaryReader::ReadString(size_t length) {
-    if (position_ + length > size_) {
-        throw std::runtime_error("BinaryReader: Read beyond end of data");
-    }
+    Require(length, "Read");
 
     std::string result(reinterpret_cast<const char*>(data_ + position_), length);
     position_ += length;
     return result;
 }
 
+std::string_view BinaryReader::ReadStringView(size_t length) {
+    Require(length, "Read");
+
+    std::string_view result(reinterpret_cast<const char*>(data_ + position_), length);
+    position_ += length;
+    return result;
+}
+
 std::string BinaryReader::ReadNullTerminatedString() {
     std::string result;
-    while (position_ < size_ && data_[position_] != 0) {
+    while (CanRead(1) && data_[position_] != 0) {
         result += static_cast<char>(data_[position_++]);
     }
-    if (position_ < size_) {
+    if (CanRead(1)) {
         position_++; // Skip null terminator
     }
     return result;
@@ -152,193 +196,445 @@ std::string BinaryReader::ReadLengthPrefixedString() {
 }
 
 std::vector<uint8_t> BinaryReader::ReadBytes(size_t count) {
-    if (position_ + count > size_) {
-        throw std::runtime_error("BinaryReader: Read beyond end of data");
-    }
+    Require(count, "Read");
 
     std::vector<uint8_t> result(data_ + position_, data_ + position_ + count);
     position_ += count;
     return result;
 }
 
+void BinaryReader::ReadFloats(float* output, size_t count) {
+    static_assert(sizeof(float) == 4, "32-bit binary .x floats must be float");
+    littleEndian_ ? ReadWords<true, 4>(output, count) : ReadWords<false, 4>(output, count);
+}
+
+void BinaryReader::ReadUInt32s(uint32_t* output, size_t count) {
+    littleEndian_ ? ReadWords<true, 4>(output, count) : ReadWords<false, 4>(output, count);
+}
+
 std::vector<float> BinaryReader::ReadFloatArray(size_t count) {
     std::vector<float> result;
-    result.reserve(count);
-    for (size_t i = 0; i < count; ++i) {
-        result.push_back(ReadFloat());
+    while (result.size() < count) {
+        size_t offset = result.size();
+        result.resize(offset + std::min(count - offset, ARRAY_CHUNK));
+        ReadFloats(result.data() + offset, result.size() - offset);
     }
     return result;
 }
 
 std::vector<uint32_t> BinaryReader::ReadUInt32Array(size_t count) {
     std::vector<uint32_t> result;
-    result.reserve(count);
-    for (size_t i = 0; i < count; ++i) {
-        result.push_back(ReadUInt32());
+    while (result.size() < count) {
+        size_t offset = result.size();
+        result.resize(offset + std::min(count - offset, ARRAY_CHUNK));
+        ReadUInt32s(result.data() + offset, result.size() - offset);
     }
     return result;
 }
 
+template <bool LittleEndian, size_t WordBytes>
+void BinaryReader::ReadWords(void* output, size_t count) {
+    static_assert(WordBytes == 4 || WordBytes == 8, "binary .x words are 32 or 64 bits");
+
+    // In memory the whole array is checked once; a stream is copied one
+    // window at a time
+    if (!source_ && count > (size_ - position_) / WordBytes) {
+        ThrowOutOfData("Read");
+    }
+
+    uint8_t* out = static_cast<uint8_t*>(output);
+    while (count > 0) {
+        if (size_ - position_ < WordBytes) {
+            Require(WordBytes, "Read");
+        }
+        size_t chunk = std::min((size_ - position_) / WordBytes, count);
+        std::memcpy(out, data_ + position_, chunk * WordBytes);
+        if constexpr (LittleEndian != HOST_LITTLE_ENDIAN) {
+            SwapWords<WordBytes>(out, chunk);
+        }
+        position_ += chunk * WordBytes;
+        out += chunk * WordBytes;
+        count -= chunk;
+    }
+}
+
+void BinaryReader::ReadRemaining(std::vector<uint8_t>& output) {
+    output.insert(output.end(), data_ + position_, data_ + size_);
+    position_ = size_;
+
+    if (source_) {
+        // Straight into output, not through a second buffer
+        const size_t buffered = output.size();
+        if (!AppendAllBytes(*source_, output)) {
+            throw std::runtime_error("BinaryReader: " + source_->GetError());
+        }
+        const size_t rest = output.size() - buffered;
+        ConversionMetrics::GetInstance().AddBytesDecompressed(rest);
+        windowOffset_ += size_ + rest;
+        window_.clear();
+        data_ = window_.data();
+        size_ = position_ = 0;
+    }
+}
+
 void BinaryReader::Seek(size_t position) {
-    if (position > size_) {
-        throw std::runtime_error("BinaryReader: Seek beyond end of data");
+    if (position < windowOffset_) {
+        throw std::runtime_error("BinaryReader: Seek before start of stream window");
     }
-    position_ = position;
+    size_t target = position - windowOffset_;
+    if (target > size_) {
+        Skip(target - position_);
+        return;
+    }
+    position_ = target;
 }
 
 void BinaryReader::Skip(size_t bytes) {
-    if (position_ + bytes > size_) {
-        throw std::runtime_error("BinaryReader: Skip beyond end of data");
+    // Stream through large skips instead of growing the window
+    while (source_ && bytes > size_ - position_) {
+        bytes -= size_ - position_;
+        position_ = size_;
+        if (!Refill(std::min(bytes, windowSize_))) {
+            ThrowOutOfData("Skip");
+        }
     }
+    Require(bytes, "Skip");
     position_ += bytes;
 }
 
 uint8_t BinaryReader::PeekUInt8() {
-    if (position_ >= size_) {
-        throw std::runtime_error("BinaryReader: Peek beyond end of data");
-    }
+    Require(1, "Peek");
     return data_[position_];
 }
 
+uint16_t BinaryReader::PeekUInt16() {
+    Require(2, "Peek");
+
+    const uint8_t* bytes = data_ + position_;
+    return littleEndian_ ? LoadWord<uint16_t, true>(bytes) : LoadWord<uint16_t, false>(bytes);
+}
+
 uint32_t BinaryReader::PeekUInt32() {
-    if (position_ + 4 > size_) {
-        throw std::runtime_error("BinaryReader: Peek beyond end of data");
-    }
+    Require(4, "Peek");
+
+    const uint8_t* bytes = data_ + position_;
+    return littleEndian_ ? LoadWord<uint32_t, true>(bytes) : LoadWord<uint32_t, false>(bytes);
+}
+
+// =============================================================================
+// BinaryValueDecoder Implementation
+// =============================================================================
 
-    uint32_t value;
-    if (littleEndian_) {
-        value = data_[position_] |
-                (data_[position_ + 1] << 8) |
-                (data_[position_ + 2] << 16) |
-                (data_[position_ + 3] << 24);
+namespace {
+
+// Elements narrowed or converted on the way out are staged this many at a
+// time, so the conversion loop runs over a plain array
+constexpr size_t DECODE_CHUNK = 256;
+
+// count elements stored as Stored (words in file byte order) into Value
+template <bool LittleEndian, typename Stored, typename Value>
+void DecodeList(BinaryReader& reader, Value* output, size_t count) {
+    static_assert(sizeof(Stored) == 4 || sizeof(Stored) == 8, "binary .x values are 32 or 64 bits");
+    if constexpr (std::is_same_v<Stored, Value>) {
+        reader.ReadWords<LittleEndian, sizeof(Stored)>(output, count);
     } else {
-        value = (data_[position_] << 24) |
-                (data_[position_ + 1] << 16) |
-                (data_[position_ + 2] << 8) |
-                data_[position_ + 3];
+        Stored staged[DECODE_CHUNK];
+        while (count > 0) {
+            size_t chunk = std::min(count, DECODE_CHUNK);
+            reader.ReadWords<LittleEndian, sizeof(Stored)>(staged, chunk);
+            for (size_t i = 0; i < chunk; i++) {
+                output[i] = static_cast<Value>(staged[i]);
+            }
+            output += chunk;
+            count -= chunk;
+        }
     }
-    return value;
 }
 
-bool BinaryReader::CanRead(size_t bytes) const {
-    return position_ + bytes <= size_;
+template <bool LittleEndian, uint32_t FloatSize>
+BinaryValueDecoder MakeValueDecoder() {
+    using StoredFloat = std::conditional_t<FloatSize == 64, double, float>;
+    static_assert(sizeof(StoredFloat) * 8 == FloatSize, "float width must match the header");
+
+    BinaryValueDecoder decoder;
+    decoder.readFloats = &DecodeList<LittleEndian, StoredFloat, float>;
+    decoder.readFloatsAsUInts = &DecodeList<LittleEndian, StoredFloat, uint32_t>;
+    decoder.readUInts = &DecodeList<LittleEndian, uint32_t, uint32_t>;
+    decoder.readUIntsAsFloats = &DecodeList<LittleEndian, int32_t, float>;
+    decoder.floatBytes = sizeof(StoredFloat);
+    return decoder;
+}
+
+} // namespace
+
+BinaryValueDecoder BinaryValueDecoder::For(bool littleEndian, uint32_t floatSize) {
+    if (littleEndian) {
+        return floatSize == 64 ? MakeValueDecoder<true, 64>() : MakeValueDecoder<true, 32>();
+    }
+    return floatSize == 64 ? MakeValueDecoder<false, 64>() : MakeValueDecoder<false, 32>();
 }
 
 // =============================================================================
 // XFileDecompressor Implementation
 // =============================================================================
 
-XFileDecompressor::XFileDecompressor() : logger_(Logger::GetInstance()) {
+std::chrono::steady_clock::time_point DecompressionLimits::DeadlineFrom(std::chrono::steady_clock::time_point start) const {
+    if (maxSeconds <= 0.0) {
+        return std::chrono::steady_clock::time_point::max();
+    }
+    return start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                       std::chrono::duration<double>(maxSeconds));
 }
 
-bool XFileDecompressor::DecompressZipped(const std::vector<uint8_t>& compressedData,
-                                        std::vector<uint8_t>& decompressedData) {
-    // Placeholder implementation - would need zlib integration
-    logger_.Warning("Zip decompression not implemented");
-    return false;
+XFileDecompressor::XFileDecompressor() : logger_(Logger::GetInstance()), method_(""), attempts_(0) {
 }
 
-bool XFileDecompressor::DecompressBzip2(const std::vector<uint8_t>& compressedData,
-                                       std::vector<uint8_t>& decompressedData) {
-#ifdef HAVE_BZIP2
+bool XFileDecompressor::DecompressZipped(ByteView compressedData,
+                                         std::vector<uint8_t>& decompressedData) {
+    std::unique_ptr<ByteSource> stream = OpenZipStream(compressedData);
+    if (!stream) {
+        return false;
+    }
+
+    if (!ReadAllBytes(*stream, decompressedData, compressedData.size() * 2)) {
+        logger_.Error("Zip decompression failed: " + stream->GetError());
+        return false;
+    }
+
+    logger_.Info("Zip decompression completed: " + std::to_string(compressedData.size()) + " -> " +
+                std::to_string(decompressedData.size()) + " bytes");
+    return true;
+}
+
+bool XFileDecompressor::DecompressBzip2(ByteView compressedData,
+                                        std::vector<uint8_t>& decompressedData) {
     if (compressedData.empty()) {
         logger_.Error("BZip2: Empty input data");
         return false;
     }
 
-    // Verify bzip2 signature
-    if (!IsBzip2Compressed(compressedData)) {
-        logger_.Error("BZip2: Invalid file signature");
+    std::unique_ptr<ByteSource> stream = OpenBzip2Stream(compressedData);
+    if (!stream) {
+        return false;
+    }
+
+    // The output grows with the stream; there is no guessed size limit
+    if (!ReadAllBytes(*stream, decompressedData, compressedData.size() * 4)) {
+        logger_.Error("BZip2: Decompression failed: " + stream->GetError());
         return false;
     }
 
-    logger_.Info("Starting BZip2 decompression of " + std::to_string(compressedData.size()) + " bytes");
+    logger_.Info("BZip2 decompression completed successfully");
+    logger_.Info("Compressed: " + std::to_string(compressedData.size()) + " bytes -> " +
+                "Decompressed: " + std::to_string(decompressedData.size()) + " bytes");
+    return true;
+}
+
+std::unique_ptr<ByteSource> XFileDecompressor::OpenBzip2Stream(ByteView compressedData) {
+    if (!Bzip2ByteSource::IsAvailable()) {
+        // DirectX might be lying about the compression type
+        logger_.Warning("BZip2 not available - trying deflate decompression as fallback");
+        return OpenRawDeflateStream(compressedData);
+    }
 
-    // Initialize bzip2 decompression
-    bz_stream bzStream;
-    bzStream.bzalloc = nullptr;
-    bzStream.bzfree = nullptr;
-    bzStream.opaque = nullptr;
-    bzStream.next_in = const_cast<char*>(reinterpret_cast<const char*>(compressedData.data()));
-    bzStream.avail_in = static_cast<unsigned int>(compressedData.size());
+    if (!IsBzip2Compressed(compressedData)) {
+        logger_.Error("BZip2: Invalid file signature");
+        return nullptr;
+    }
 
-    int bzError = BZ2_bzDecompressInit(&bzStream, 0, 0);
-    if (bzError != BZ_OK) {
-        logger_.Warning("BZip2: Failed to initialize decompression (error: " + std::to_string(bzError) + ") - trying deflate fallback");
-        // Try deflate decompression as fallback - DirectX might be lying about compression type
-        return DecompressRawDeflate(compressedData, decompressedData);
+    BeginAttempt("bzip2");
+    auto stream = std::make_unique<Bzip2ByteSource>(compressedData);
+    if (stream->HasError()) {
+        logger_.Warning("BZip2: " + stream->GetError() + " - trying deflate fallback");
+        return OpenRawDeflateStream(compressedData);
     }
 
-    // Prepare output buffer - start with 4x the compressed size
-    const size_t initialBufferSize = compressedData.size() * 4;
-    const size_t maxBufferSize = compressedData.size() * 50; // Reasonable limit
-    decompressedData.resize(initialBufferSize);
+    logger_.Info("Streaming BZip2 decompression of " + std::to_string(compressedData.size()) + " bytes");
+    return stream;
+}
 
-    size_t totalDecompressed = 0;
-    int result = BZ_OK;
+std::unique_ptr<ByteSource> XFileDecompressor::OpenZipStream(ByteView compressedData) {
+    if (!InflateByteSource::IsAvailable()) {
+        logger_.Error("zlib support not compiled in - cannot decompress zip streams");
+        return nullptr;
+    }
 
-    while (result == BZ_OK) {
-        // Ensure we have space in the output buffer
-        if (totalDecompressed >= decompressedData.size()) {
-            size_t newSize = decompressedData.size() * 2;
-            if (newSize > maxBufferSize) {
-                logger_.Error("BZip2: Decompressed data exceeds maximum size limit");
-                BZ2_bzDecompressEnd(&bzStream);
-                return false;
-            }
-            decompressedData.resize(newSize);
-            logger_.Info("BZip2: Expanding output buffer to " + std::to_string(newSize) + " bytes");
+    // Zip archive: inflate the first entry from its local file header
+    BeginAttempt("zip");
+    if (IsZipCompressed(compressedData)) {
+        if (compressedData.size() < 30) {
+            logger_.Error("Zip: truncated local file header");
+            return nullptr;
+        }
+        auto readLE16 = [&](size_t offset) {
+            return static_cast<size_t>(compressedData[offset] | (compressedData[offset + 1] << 8));
+        };
+        size_t method = readLE16(8);
+        size_t dataOffset = 30 + readLE16(26) + readLE16(28);
+        if (dataOffset > compressedData.size()) {
+            logger_.Error("Zip: local file header runs past the end of the data");
+            return nullptr;
+        }
+        if (method == 0) {
+            return std::make_unique<MemoryByteSource>(compressedData.Subview(dataOffset));
         }
+        if (method != 8) {
+            logger_.Error("Zip: unsupported compression method " + std::to_string(method));
+            return nullptr;
+        }
+        return CreateInflateStream(compressedData.Subview(dataOffset), -15, "raw deflate");
+    }
+
+    // 15 + 32: accept zlib and gzip headers
+    return CreateInflateStream(compressedData, 15 + 32, "zlib");
+}
 
-        // Set up output buffer for this iteration
-        bzStream.next_out = reinterpret_cast<char*>(decompressedData.data() + totalDecompressed);
-        bzStream.avail_out = static_cast<unsigned int>(decompressedData.size() - totalDecompressed);
+std::unique_ptr<ByteSource> XFileDecompressor::OpenRawDeflateStream(ByteView compressedData) {
+    if (!InflateByteSource::IsAvailable()) {
+        logger_.Error("zlib support not compiled in - cannot decompress deflate streams");
+        return nullptr;
+    }
 
-        // Decompress
-        result = BZ2_bzDecompress(&bzStream);
+    BeginAttempt("deflate");
+    return CreateInflateStream(compressedData, -15, "raw deflate");
+}
 
-        if (result != BZ_OK && result != BZ_STREAM_END) {
-            logger_.Error("BZip2: Decompression failed with error: " + std::to_string(result));
-            BZ2_bzDecompressEnd(&bzStream);
-            return false;
-        }
+std::unique_ptr<ByteSource> XFileDecompressor::CreateInflateStream(ByteView compressedData, int windowBits,
+                                                                   const char* kind) {
+    auto stream = std::make_unique<InflateByteSource>(compressedData, windowBits);
+    if (stream->HasError()) {
+        logger_.Warning("Failed to initialize " + std::string(kind) + " decompression: " + stream->GetError());
+        return nullptr;
+    }
+    return stream;
+}
+
+std::unique_ptr<ByteSource> XFileDecompressor::OpenMszipStream(ByteView payload) {
+    if (!InflateByteSource::IsAvailable()) {
+        logger_.Error("zlib support not compiled in - cannot decompress MSZIP payloads");
+        return nullptr;
+    }
 
-        // Update total decompressed bytes
-        totalDecompressed = decompressedData.size() - bzStream.avail_out;
+    // The block table is validated up front, before anything is inflated
+    BeginAttempt("mszip");
+    auto stream = std::make_unique<MszipByteSource>(payload);
+    if (stream->HasError()) {
+        logger_.Error(stream->GetError());
+        return nullptr;
+    }
+    if (limits_.maxOutputBytes > 0 && stream->GetDecompressedSize() > limits_.maxOutputBytes) {
+        logger_.Error("MSZIP payload declares " + std::to_string(stream->GetDecompressedSize()) +
+                      " bytes, over the limit of " + std::to_string(limits_.maxOutputBytes));
+        return nullptr;
+    }
+
+    logger_.Info("MSZIP payload: " + std::to_string(stream->GetBlockCount()) + " blocks, " +
+                std::to_string(stream->GetDecompressedSize()) + " bytes decompressed");
+    return stream;
+}
 
-        // Log progress for large files
-        if (totalDecompressed % (1024 * 1024) == 0 && totalDecompressed > 0) {
-            logger_.Info("BZip2: Decompressed " + std::to_string(totalDecompressed / 1024) + " KB so far");
+bool XFileDecompressor::DecompressMszip(ByteView payload,
+                                        std::vector<uint8_t>& output,
+                                        size_t workerCount) {
+    BeginAttempt("mszip");
+    std::string error;
+    if (limits_.maxOutputBytes > 0) {
+        // The declared size is what DecodeParallel allocates
+        std::vector<Mszip::Block> blocks;
+        size_t declaredSize = 0;
+        if (Mszip::ReadBlockTable(payload, blocks, declaredSize, error) && declaredSize > limits_.maxOutputBytes) {
+            logger_.Error("MSZIP payload declares " + std::to_string(declaredSize) + " bytes, over the limit of " +
+                          std::to_string(limits_.maxOutputBytes));
+            return false;
         }
     }
+    if (!Mszip::DecodeParallel(payload, output, workerCount, error)) {
+        logger_.Error(error);
+        return false;
+    }
+
+    logger_.Info("MSZIP decompression completed: " + std::to_string(payload.size()) + " -> " +
+                std::to_string(output.size()) + " bytes");
+    return true;
+}
 
-    // Clean up
-    BZ2_bzDecompressEnd(&bzStream);
+bool XFileDecompressor::CheckPayloadPrefix(ByteView prefix, uint32_t floatSize, bool textPayload,
+                                           std::string& error) {
+    namespace Token = BinaryXFileUtils;
+    if (prefix.empty()) {
+        error = "decompressed payload is empty";
+        return false;
+    }
+    if (prefix.StartsWith("xof ")) {
+        return true;   // The header itself is checked by the parser
+    }
 
-    // Resize to actual decompressed size
-    decompressedData.resize(totalDecompressed);
+    if (textPayload) {
+        for (size_t i = 0; i < prefix.size(); i++) {
+            uint8_t c = prefix[i];
+            if (c < 0x20 && c != '\t' && c != '\n' && c != '\r') {
+                error = "decompressed payload is not .x text (byte " + std::to_string(c) + " at offset " +
+                        std::to_string(i) + ")";
+                return false;
+            }
+        }
+        return true;
+    }
 
-    logger_.Info("BZip2 decompression completed successfully");
-    logger_.Info("Compressed: " + std::to_string(compressedData.size()) + " bytes -> " +
-                "Decompressed: " + std::to_string(decompressedData.size()) + " bytes");
-    logger_.Info("Compression ratio: " +
-                std::to_string(static_cast<double>(compressedData.size()) / decompressedData.size() * 100.0) + "%");
+    // Walk the tokens; the first has to open a template or a data object
+    auto readUInt32 = [&](size_t offset) {
+        return static_cast<uint32_t>(prefix[offset]) | (static_cast<uint32_t>(prefix[offset + 1]) << 8) |
+               (static_cast<uint32_t>(prefix[offset + 2]) << 16) | (static_cast<uint32_t>(prefix[offset + 3]) << 24);
+    };
+    size_t position = 0;
+    for (bool first = true; position + 2 <= prefix.size(); first = false) {
+        uint16_t token = static_cast<uint16_t>(prefix[position] | (prefix[position + 1] << 8));
+        size_t tokenOffset = position;
+        position += 2;
+        bool known = token == Token::BINARY_TOKEN_NAME || token == Token::BINARY_TOKEN_STRING ||
+                     token == Token::BINARY_TOKEN_INTEGER || token == Token::BINARY_TOKEN_GUID ||
+                     token == Token::BINARY_TOKEN_INTEGER_LIST || token == Token::BINARY_TOKEN_FLOAT_LIST ||
+                     (token >= Token::BINARY_TOKEN_OBRACE && token <= Token::BINARY_TOKEN_SEMICOLON) ||
+                     token == Token::BINARY_TOKEN_TEMPLATE ||
+                     (token >= Token::BINARY_TOKEN_WORD && token <= Token::BINARY_TOKEN_ARRAY);
+        if (!known || (first && token != Token::BINARY_TOKEN_NAME && token != Token::BINARY_TOKEN_TEMPLATE)) {
+            error = "decompressed payload is not .x binary data (token " + std::to_string(token) + " at offset " +
+                    std::to_string(tokenOffset) + ")";
+            return false;
+        }
 
+        uint64_t dataBytes = 0;
+        if (token == Token::BINARY_TOKEN_INTEGER) {
+            dataBytes = 4;
+        } else if (token == Token::BINARY_TOKEN_GUID) {
+            dataBytes = 16;
+        } else if (token == Token::BINARY_TOKEN_NAME || token == Token::BINARY_TOKEN_STRING ||
+                   token == Token::BINARY_TOKEN_INTEGER_LIST || token == Token::BINARY_TOKEN_FLOAT_LIST) {
+            if (position + 4 > prefix.size()) {
+                break;
+            }
+            uint64_t count = readUInt32(position);
+            position += 4;
+            dataBytes = token == Token::BINARY_TOKEN_INTEGER_LIST ? count * 4
+                      : token == Token::BINARY_TOKEN_FLOAT_LIST  ? count * (floatSize / 8)
+                      : token == Token::BINARY_TOKEN_STRING      ? count + 2
+                                                                 : count;
+        }
+        if (dataBytes > prefix.size() - position) {
+            break;     // Runs past the prefix; the rest is the parser's to judge
+        }
+        position += static_cast<size_t>(dataBytes);
+    }
     return true;
-#else
-    // If bzip2 is not available, try deflate as fallback
-    logger_.Warning("BZip2 not available - trying deflate decompression as fallback");
-    return DecompressRawDeflate(compressedData, decompressedData);
-#endif
 }
 
-bool XFileDecompressor::IsZipCompressed(const std::vector<uint8_t>& data) {
+bool XFileDecompressor::IsZipCompressed(ByteView data) {
     if (data.size() < 4) return false;
     // ZIP file signature: 0x504B0304
     return data[0] == 0x50 && data[1] == 0x4B && data[2] == 0x03 && data[3] == 0x04;
 }
 
-bool XFileDecompressor::IsBzip2Compressed(const std::vector<uint8_t>& data) {
+bool XFileDecompressor::IsBzip2Compressed(ByteView data) {
     if (data.size() < 4) return false;
 
     // Bzip2 signature: "B" followed by version and block size
@@ -356,7 +652,7 @@ bool XFileDecompressor::IsBzip2Compressed(const std::vector<uint8_t>& data) {
     return false;
 }
 
-bool XFileDecompressor::IsDirectXLZCompressed(const std::vector<uint8_t>& data) {
+bool XFileDecompressor::IsDirectXLZCompressed(ByteView data) {
     if (data.size() < 8) return false;
 
     // Check for common DirectX LZ headers
@@ -369,1048 +665,1907 @@ bool XFileDecompressor::IsDirectXLZCompressed(const std::vector<uint8_t>& data)
 }
 
 bool XFileDecompressor::IsCompressionSupported() {
-#ifdef HAVE_BZIP2
+    // MSZIP (tzip/bzip) only needs zlib
+#if defined(HAVE_ZLIB) || defined(HAVE_BZIP2)
     return true;
 #else
     return false;
 #endif
 }
 
-bool XFileDecompressor::DecompressWithZlib(const std::vector<uint8_t>& input,
-                                          std::vector<uint8_t>& output) {
-    return false; // Placeholder
+bool XFileDecompressor::DecompressWithZlib(ByteView input,
+                                           std::vector<uint8_t>& output) {
+    return DecompressZipped(input, output);
 }
 
-bool XFileDecompressor::DecompressWithBzip2(const std::vector<uint8_t>& input,
-                                           std::vector<uint8_t>& output) {
+bool XFileDecompressor::DecompressWithBzip2(ByteView input,
+                                            std::vector<uint8_t>& output) {
     return DecompressBzip2(input, output);
 }
 
-bool XFileDecompressor::DecompressRawDeflate(const std::vector<uint8_t>& input,
-                                            std::vector<uint8_t>& output) {
-#ifdef HAVE_ZLIB
+bool XFileDecompressor::DecompressRawDeflate(ByteView input,
+                                             std::vector<uint8_t>& output) {
     // Try raw deflate decompression - this might be what DirectX is actually using
     logger_.Info("Attempting raw deflate decompression of " + std::to_string(input.size()) + " bytes");
 
-    z_stream zStream;
-    zStream.zalloc = Z_NULL;
-    zStream.zfree = Z_NULL;
-    zStream.opaque = Z_NULL;
-    zStream.next_in = const_cast<Bytef*>(input.data());
-    zStream.avail_in = static_cast<uInt>(input.size());
-
-    // Initialize for raw deflate (negative window bits = raw deflate)
-    int result = inflateInit2(&zStream, -15); // -15 = raw deflate
-    if (result != Z_OK) {
-        logger_.Warning("Failed to initialize raw deflate decompression: " + std::to_string(result));
+    std::unique_ptr<ByteSource> stream = OpenRawDeflateStream(input);
+    if (!stream) {
         return false;
     }
 
-    // Prepare output buffer
-    output.resize(input.size() * 10); // Start with 10x expansion
-    zStream.next_out = output.data();
-    zStream.avail_out = static_cast<uInt>(output.size());
-
-    result = inflate(&zStream, Z_FINISH);
-
-    if (result == Z_STREAM_END) {
-        size_t decompressedSize = output.size() - zStream.avail_out;
-        output.resize(decompressedSize);
-        inflateEnd(&zStream);
-
-        logger_.Info("Raw deflate decompression successful! Decompressed " +
-                    std::to_string(decompressedSize) + " bytes");
-
-        // Check if result looks like X-file content
-        if (decompressedSize > 16) {
-            std::string start(reinterpret_cast<const char*>(output.data()), std::min<size_t>(16, decompressedSize));
-            logger_.Info("Decompressed data starts with: " + start);
-
-            if (start.find("xof") == 0 || start.find("template") != std::string::npos) {
-                logger_.Info("Decompressed data appears to be valid X-file content!");
-                return true;
-            }
-        }
-
-        return true;
-    } else {
-        logger_.Warning("Raw deflate decompression failed with result: " + std::to_string(result));
-        inflateEnd(&zStream);
+    if (!ReadAllBytes(*stream, output, input.size() * 4)) {
+        logger_.Warning("Raw deflate decompression failed: " + stream->GetError());
         return false;
     }
-#else
-    (void)input; // Suppress unused parameter warning
-    (void)output; // Suppress unused parameter warning
-    logger_.Error("zlib support not compiled in - cannot decompress deflate streams");
-    return false;
-#endif
+
+    logger_.Info("Raw deflate decompression successful! Decompressed " +
+                std::to_string(output.size()) + " bytes");
+    return true;
 }
 
-bool XFileDecompressor::DecompressDirectXBzip(const std::vector<uint8_t>& input,
-                                              std::vector<uint8_t>& output) {
-#ifdef HAVE_ZLIB
-    // DirectX bzip0032 format analysis and custom decompression
-    logger_.Info("Attempting DirectX proprietary bzip0032 decompression of " + std::to_string(input.size()) + " bytes");
+bool XFileDecompressor::DecompressDirectXLZ(ByteView input,
+                                            std::vector<uint8_t>& output) {
+    logger_.Info("Attempting DirectX LZ decompression of " + std::to_string(input.size()) + " bytes");
 
-    if (input.size() < 20) {
-        logger_.Error("DirectX bzip: Input too small for DirectX compressed data");
+    if (input.size() < 8) {
+        logger_.Error("DirectX LZ: Input too small");
         return false;
     }
 
-    // Analyze DirectX header structure
-    // DirectX compressed files often have:
-    // - Custom headers with format indicators
-    // - Modified compression parameters
-    // - Different block structures
+    // Every attempt stops as soon as its first bytes cannot start a .x
+    // file, or when the output or the time runs over the limits
+    const auto deadline = limits_.DeadlineFrom(std::chrono::steady_clock::now());
+    const size_t maxOutput = limits_.maxOutputBytes > 0 ? static_cast<size_t>(limits_.maxOutputBytes) : SIZE_MAX;
+    auto looksLikeXFile = [&output]() {
+        std::string start(reinterpret_cast<const char*>(output.data()), std::min<size_t>(16, output.size()));
+        return start.find("xof") == 0 || start.find("template") != std::string::npos;
+    };
+    bool overLimit = false;
+    auto keepGoing = [&](bool& prefixChecked) {
+        if (!prefixChecked && output.size() >= 16) {
+            prefixChecked = true;
+            if (!looksLikeXFile()) {
+                return false;
+            }
+        }
+        if (output.size() > maxOutput || std::chrono::steady_clock::now() > deadline) {
+            overLimit = true;
+            return false;
+        }
+        return true;
+    };
 
-    // Try to detect the actual compression method used
-    // Some DirectX files use deflate but with custom headers
+    // Analyze the header structure
+    // Many DirectX files use a custom LZ format with specific headers
+    const uint8_t* data = input.data();
 
-    // Method 1: Try raw deflate with different window sizes
-    std::vector<int> windowSizes = {-15, -14, -13, -12, -11, -10, 15, 14, 13, 12, 11, 10};
+    // Check for common DirectX LZ signatures
+    uint32_t header = (data[3] << 24) | (data[2] << 16) | (data[1] << 8) | data[0];
 
-    for (int windowBits : windowSizes) {
-        logger_.Info("Trying deflate decompression with window bits: " + std::to_string(windowBits));
+    logger_.Info("DirectX LZ header analysis: 0x" +
+                std::to_string(header) + " (" +
+                std::to_string(data[0]) + " " +
+                std::to_string(data[1]) + " " +
+                std::to_string(data[2]) + " " +
+                std::to_string(data[3]) + ")");
 
-        z_stream zStream;
-        memset(&zStream, 0, sizeof(zStream));
+    // Method 1: Try Microsoft LZ decompression algorithm
+    // This is a simplified LZ77 implementation often used by DirectX
+    if (header == 0x00038760) { // Common DirectX LZ header
+        logger_.Info("Detected DirectX LZ format with signature 0x00038760");
+        BeginAttempt("directx-lz");
 
-        zStream.next_in = const_cast<Bytef*>(input.data());
-        zStream.avail_in = static_cast<uInt>(input.size());
+        size_t inputPos = 4; // Skip header
+        output.clear();
+        output.reserve(std::min(input.size() * 8, maxOutput)); // Reserve space
+        bool prefixChecked = false;
 
-        int result = inflateInit2(&zStream, windowBits);
-        if (result != Z_OK) {
-            continue; // Try next window size
-        }
+        while (inputPos < input.size() && keepGoing(prefixChecked)) {
+            uint8_t flag = data[inputPos++];
 
-        // Allocate output buffer
-        size_t outputSize = input.size() * 10; // Start with 10x expansion
-        output.resize(outputSize);
+            // Process 8 bits in the flag byte
+            for (int bit = 0; bit < 8 && inputPos < input.size(); ++bit) {
+                if (flag & (1 << bit)) {
+                    // Literal
+                    output.push_back(data[inputPos++]);
+                } else {
+                    // Match
+                    if (inputPos + 1 >= input.size()) break;
 
-        zStream.next_out = output.data();
-        zStream.avail_out = static_cast<uInt>(outputSize);
+                    uint16_t match = data[inputPos] | (data[inputPos + 1] << 8);
+                    inputPos += 2;
 
-        result = inflate(&zStream, Z_FINISH);
+                    int offset = (match >> 4) + 1;
+                    int length = (match & 0x0F) + 3;
 
-        if (result == Z_STREAM_END) {
-            // Success!
-            output.resize(zStream.total_out);
-            inflateEnd(&zStream);
+                    if (offset <= output.size()) {
+                        size_t start = output.size() - offset;
+                        for (int j = 0; j < length; ++j) {
+                            output.push_back(output[start + (j % offset)]);
+                        }
+                    }
+                }
+            }
+        }
 
-            logger_.Info("DirectX bzip decompression successful with window bits " +
-                        std::to_string(windowBits) + "! Decompressed " +
+        if (overLimit) {
+            logger_.Error("DirectX LZ: decompression ran over its size or time limit");
+            return false;
+        }
+        if (!output.empty()) {
+            logger_.Info("DirectX LZ decompression successful! Decompressed " +
                         std::to_string(output.size()) + " bytes");
 
             // Validate decompressed content
-            size_t decompressedSize = output.size();
-            std::string start(reinterpret_cast<const char*>(output.data()), std::min<size_t>(16, decompressedSize));
+            std::string start(reinterpret_cast<const char*>(output.data()),
+                            std::min<size_t>(16, output.size()));
             logger_.Info("Decompressed data starts with: " + start);
 
             if (start.find("xof") == 0 || start.find("template") != std::string::npos) {
                 logger_.Info("Decompressed data appears to be valid X-file content!");
                 return true;
             }
-
-            logger_.Warning("Decompressed data doesn't appear to be valid X-file content");
-            return false;
         }
-
-        inflateEnd(&zStream);
     }
 
-    // Method 2: Try skipping different header sizes
-    std::vector<size_t> skipSizes = {0, 4, 8, 12, 16, 20, 24, 28, 32};
+    // Method 2: Try LZSS decompression (another common DirectX format)
+    logger_.Info("Trying LZSS decompression variant...");
 
-    for (size_t skip : skipSizes) {
-        if (skip >= input.size()) continue;
+    output.clear();
+    size_t pos = 0;
 
-        logger_.Info("Trying deflate with " + std::to_string(skip) + " bytes header skip");
+    // Skip any header bytes and try direct LZSS
+    for (size_t headerSkip : {0, 4, 8, 12, 16}) {
+        if (headerSkip >= input.size()) continue;
 
-        const uint8_t* dataPtr = input.data() + skip;
-        size_t dataSize = input.size() - skip;
+        pos = headerSkip;
+        output.clear();
+        bool prefixChecked = false;
+        BeginAttempt("lzss");
 
-        z_stream zStream;
-        memset(&zStream, 0, sizeof(zStream));
+        while (pos < input.size() && keepGoing(prefixChecked)) {
+            uint8_t flags = data[pos++];
 
-        zStream.next_in = const_cast<Bytef*>(dataPtr);
-        zStream.avail_in = static_cast<uInt>(dataSize);
+            for (int i = 0; i < 8 && pos < input.size(); ++i) {
+                if (flags & (0x01 << i)) {
+                    // Literal
+                    output.push_back(data[pos++]);
+                } else {
+                    // Match
+                    if (pos + 1 >= input.size()) break;
 
-        // Try raw deflate first
-        int result = inflateInit2(&zStream, -15);
-        if (result != Z_OK) {
-            continue;
+                    uint16_t match = data[pos] | (data[pos + 1] << 8);
+                    pos += 2;
+
+                    int offset = (match >> 4) + 1;
+                    int length = (match & 0x0F) + 3;
+
+                    if (offset <= output.size()) {
+                        size_t start = output.size() - offset;
+                        for (int j = 0; j < length; ++j) {
+                            output.push_back(output[start + (j % offset)]);
+                        }
+                    }
+                }
+            }
         }
 
-        size_t outputSize = dataSize * 10;
-        output.resize(outputSize);
+        if (overLimit) {
+            logger_.Error("DirectX LZ: decompression ran over its size or time limit");
+            return false;
+        }
 
-        zStream.next_out = output.data();
-        zStream.avail_out = static_cast<uInt>(outputSize);
+        // Check if decompression was successful
+        if (output.size() > 100) { // Reasonable size check
+            std::string start(reinterpret_cast<const char*>(output.data()),
+                            std::min<size_t>(16, output.size()));
 
-        result = inflate(&zStream, Z_FINISH);
+            if (start.find("xof") == 0 || start.find("template") != std::string::npos) {
+                logger_.Info("LZSS decompression successful with " +
+                           std::to_string(headerSkip) + " byte skip! Decompressed " +
+                           std::to_string(output.size()) + " bytes");
+                return true;
+            }
+        }
+    }
 
-        if (result == Z_STREAM_END) {
-            output.resize(zStream.total_out);
-            inflateEnd(&zStream);
+    logger_.Warning("All DirectX LZ decompression methods failed");
+    return false;
+}
 
-            logger_.Info("DirectX bzip decompression successful with " +
-                        std::to_string(skip) + " byte skip! Decompressed " +
-                        std::to_string(output.size()) + " bytes");
-            return true;
+using namespace BinaryXFileUtils;
+
+// =============================================================================
+// Standard templates
+// =============================================================================
+
+namespace {
+
+struct StandardTemplate {
+    XTemplate id;
+    std::string_view name;
+    const char* guid;       // As written in rmxfguid.h; null for aliases and extensions
+};
+
+// Canonical names first, in XTemplate order, then spelling variants
+constexpr StandardTemplate STANDARD_TEMPLATES[] = {
+    {XTemplate::HEADER, "Header", "3D82AB43-62DA-11CF-AB39-0020AF71E433"},
+    {XTemplate::VECTOR, "Vector", "3D82AB5E-62DA-11CF-AB39-0020AF71E433"},
+    {XTemplate::COORDS2D, "Coords2d", "F6F23F44-7686-11CF-8F52-0040333594A3"},
+    {XTemplate::MATRIX4X4, "Matrix4x4", "F6F23F45-7686-11CF-8F52-0040333594A3"},
+    {XTemplate::COLOR_RGBA, "ColorRGBA", "35FF44E0-6C7C-11CF-8F52-0040333594A3"},
+    {XTemplate::COLOR_RGB, "ColorRGB", "D3E16E81-7835-11CF-8F52-0040333594A3"},
+    {XTemplate::INDEXED_COLOR, "IndexedColor", "1630B820-7842-11CF-8F52-0040333594A3"},
+    {XTemplate::BOOLEAN, "Boolean", "4885AE61-78E8-11CF-8F52-0040333594A3"},
+    {XTemplate::BOOLEAN2D, "Boolean2d", "4885AE63-78E8-11CF-8F52-0040333594A3"},
+    {XTemplate::MATERIAL_WRAP, "MaterialWrap", "4885AE60-78E8-11CF-8F52-0040333594A3"},
+    {XTemplate::TEXTURE_FILENAME, "TextureFilename", "A42790E1-7810-11CF-8F52-0040333594A3"},
+    {XTemplate::MATERIAL, "Material", "3D82AB4D-62DA-11CF-AB39-0020AF71E433"},
+    {XTemplate::MESH_FACE, "MeshFace", "3D82AB5F-62DA-11CF-AB39-0020AF71E433"},
+    {XTemplate::MESH_FACE_WRAPS, "MeshFaceWraps", "4885AE62-78E8-11CF-8F52-0040333594A3"},
+    {XTemplate::MESH_TEXTURE_COORDS, "MeshTextureCoords", "F6F23F40-7686-11CF-8F52-0040333594A3"},
+    {XTemplate::MESH_MATERIAL_LIST, "MeshMaterialList", "F6F23F42-7686-11CF-8F52-0040333594A3"},
+    {XTemplate::MESH_NORMALS, "MeshNormals", "F6F23F43-7686-11CF-8F52-0040333594A3"},
+    {XTemplate::MESH_VERTEX_COLORS, "MeshVertexColors", "1630B821-7842-11CF-8F52-0040333594A3"},
+    {XTemplate::MESH, "Mesh", "3D82AB44-62DA-11CF-AB39-0020AF71E433"},
+    {XTemplate::FRAME_TRANSFORM_MATRIX, "FrameTransformMatrix", "F6F23F41-7686-11CF-8F52-0040333594A3"},
+    {XTemplate::FRAME, "Frame", "3D82AB46-62DA-11CF-AB39-0020AF71E433"},
+    {XTemplate::FLOAT_KEYS, "FloatKeys", "10DD46A9-775B-11CF-8F52-0040333594A3"},
+    {XTemplate::TIMED_FLOAT_KEYS, "TimedFloatKeys", "F406B180-7B3B-11CF-8F52-0040333594A3"},
+    {XTemplate::ANIMATION_KEY, "AnimationKey", "10DD46A8-775B-11CF-8F52-0040333594A3"},
+    {XTemplate::ANIMATION_OPTIONS, "AnimationOptions", "E2BF56C0-840F-11CF-8F52-0040333594A3"},
+    {XTemplate::ANIMATION, "Animation", "3D82AB4F-62DA-11CF-AB39-0020AF71E433"},
+    {XTemplate::ANIMATION_SET, "AnimationSet", "3D82AB50-62DA-11CF-AB39-0020AF71E433"},
+    {XTemplate::XSKIN_MESH_HEADER, "XSkinMeshHeader", "3CF169CE-FF7C-44AB-93C0-F78F62D172E2"},
+    {XTemplate::VERTEX_DUPLICATION_INDICES, "VertexDuplicationIndices", "B8D65549-D7C9-4995-89CF-53A9A8B031E3"},
+    {XTemplate::SKIN_WEIGHTS, "SkinWeights", "6F0D123B-BAD2-4167-A0D0-80224F25FABB"},
+    {XTemplate::ANIM_TICKS_PER_SECOND, "AnimTicksPerSecond", "9E415A43-7BA6-4A73-8743-B73D47E88476"},
+    {XTemplate::DECL_DATA, "DeclData", "BF22E553-292C-4781-9FEA-62BD554BDD93"},
+    {XTemplate::NORMALMAP_FILENAME, "NormalmapFilename", nullptr},
+    {XTemplate::TEXTURE_FILENAME, "TextureFileName", nullptr},
+    {XTemplate::NORMALMAP_FILENAME, "NormalMapFilename", nullptr},
+};
+
+constexpr size_t STANDARD_TEMPLATE_COUNT = sizeof(STANDARD_TEMPLATES) / sizeof(STANDARD_TEMPLATES[0]);
+constexpr size_t CANONICAL_TEMPLATE_COUNT = static_cast<size_t>(XTemplate::COUNT) - 1;
+
+constexpr bool CanonicalNamesInOrder() {
+    for (size_t i = 0; i < CANONICAL_TEMPLATE_COUNT; i++) {
+        if (static_cast<size_t>(STANDARD_TEMPLATES[i].id) != i + 1) return false;
+    }
+    return true;
+}
+static_assert(CanonicalNamesInOrder(), "STANDARD_TEMPLATES must list one canonical name per XTemplate, in order");
+
+// Seeded FNV-1a. The seed is searched at compile time so every standard
+// name lands in its own slot: a lookup is one hash, one slot load and one
+// compare against the name stored there.
+constexpr uint32_t HashTemplateName(std::string_view name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : name) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+constexpr size_t NAME_SLOTS = 256;
+
+struct TemplateNameTable {
+    uint32_t seed = 0;
+    uint8_t slots[NAME_SLOTS] = {};     // STANDARD_TEMPLATES index + 1, 0 = empty
+};
+
+constexpr TemplateNameTable BuildTemplateNameTable() {
+    for (uint32_t seed = 0; seed < 4096; seed++) {
+        TemplateNameTable table;
+        table.seed = seed;
+        bool collision = false;
+        for (size_t i = 0; i < STANDARD_TEMPLATE_COUNT && !collision; i++) {
+            uint8_t& slot = table.slots[HashTemplateName(STANDARD_TEMPLATES[i].name, seed) % NAME_SLOTS];
+            collision = slot != 0;
+            slot = static_cast<uint8_t>(i + 1);
         }
+        if (!collision) {
+            return table;
+        }
+    }
+    return TemplateNameTable();
+}
+
+constexpr TemplateNameTable TEMPLATE_NAME_TABLE = BuildTemplateNameTable();
+static_assert(TEMPLATE_NAME_TABLE.slots[HashTemplateName("Mesh", TEMPLATE_NAME_TABLE.seed) % NAME_SLOTS] != 0,
+              "no collision-free seed for the standard template names");
 
-        inflateEnd(&zStream);
+int HexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return 0;
+}
+
+} // namespace
+
+XTemplate BinaryXFileUtils::FindStandardTemplate(std::string_view name) {
+    uint8_t slot = TEMPLATE_NAME_TABLE.slots[HashTemplateName(name, TEMPLATE_NAME_TABLE.seed) % NAME_SLOTS];
+    if (slot == 0 || STANDARD_TEMPLATES[slot - 1].name != name) {
+        return XTemplate::CUSTOM;
     }
+    return STANDARD_TEMPLATES[slot - 1].id;
+}
 
-    // Method 3: Try to detect Microsoft cabinet/LZX compression
-    // Some DirectX files use CAB-style compression
-    logger_.Info("Trying Microsoft CAB-style decompression detection...");
+const char* BinaryXFileUtils::GetTemplateName(XTemplate id) {
+    size_t index = static_cast<size_t>(id);
+    if (index == 0 || index > CANONICAL_TEMPLATE_COUNT) {
+        return "custom template";
+    }
+    return STANDARD_TEMPLATES[index - 1].name.data();
+}
 
-    // Look for CAB compression signatures
-    for (size_t i = 0; i < input.size() - 4; ++i) {
-        if (input[i] == 0x4D && input[i+1] == 0x53 && input[i+2] == 0x43 && input[i+3] == 0x46) {
-            logger_.Info("Found Microsoft CAB signature at offset " + std::to_string(i));
-            // This would need a CAB decompression library
-            break;
+bool BinaryXFileUtils::GetTemplateGuid(XTemplate id, uint8_t guid[16]) {
+    size_t index = static_cast<size_t>(id);
+    if (index == 0 || index > CANONICAL_TEMPLATE_COUNT || !STANDARD_TEMPLATES[index - 1].guid) {
+        return false;
+    }
+
+    // Data1-3 are stored little-endian, Data4 as written
+    const char* text = STANDARD_TEMPLATES[index - 1].guid;
+    uint8_t value[16];
+    size_t count = 0;
+    for (const char* c = text; *c && count < 16; c += 2) {
+        if (*c == '-') c++;
+        value[count++] = static_cast<uint8_t>(HexDigit(c[0]) << 4 | HexDigit(c[1]));
+    }
+    const uint8_t order[16] = {3, 2, 1, 0, 5, 4, 7, 6, 8, 9, 10, 11, 12, 13, 14, 15};
+    for (size_t i = 0; i < 16; i++) {
+        guid[i] = value[order[i]];
+    }
+    return true;
+}
+
+// =============================================================================
+// BinaryXFileParser Implementation
+// =============================================================================
+
+namespace {
+
+// Counts come from the file; cap up-front reservations so a corrupt count
+// cannot allocate gigabytes before the data runs out
+constexpr size_t MAX_RESERVE = 1 << 20;
+
+constexpr uint32_t XOF_SIGNATURE = 0x20666F78;  // "xof " read little-endian
+constexpr size_t BINARY_HEADER_SIZE = 16;         // Reader positions start after it
+
+} // namespace
+
+BinaryXFileParser::BinaryXFileParser()
+    : logger_(Logger::GetInstance()),
+      listToken_(0),
+      listRemaining_(0),
+      floatSize_(32),
+      decoder_(BinaryValueDecoder::For(true, 32)),
+      fileTicksPerSecond_(0.0f),
+      streamWindowBytes_(256 * 1024),
+      backgroundDecompression_(true),
+      decompressionWorkers_(1),
+      decompressionDeadline_(std::chrono::steady_clock::time_point::max()),
+      lazyAnimations_(false) {
+}
+
+BinaryXFileParser::~BinaryXFileParser() = default;
+
+void BinaryXFileParser::SetStreamingOptions(size_t windowBytes, bool backgroundDecompression) {
+    streamWindowBytes_ = windowBytes;
+    backgroundDecompression_ = backgroundDecompression;
+}
+
+void BinaryXFileParser::SetDecompressionWorkers(size_t workers) {
+    decompressionWorkers_ = workers;
+}
+
+bool BinaryXFileParser::ParseBinaryFile(const std::string& filepath) {
+    logger_.Info("Attempting to parse binary .x file: " + filepath);
+
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        logger_.Error("Failed to open file: " + filepath);
+        return false;
+    }
+    ConversionMetrics::GetInstance().AddBytesRead(file.GetSize());
+
+    bool success = ParseBinaryData(file.View());
+    animationSource_ = ByteView();   // The mapping closes here
+    return success;
+}
+
+bool BinaryXFileParser::ParseBinaryData(ByteView data) {
+    TIME_OPERATION("BinaryXFileParser::ParseBinaryData");
+    timer.AddBytes(data.size());
+    ResetBinaryParser();
+
+    if (data.size() < 16) {
+        AddBinaryParseError("File too small to be a valid .x file");
+        return false;
+    }
+
+    if (!ParseBinaryHeader(data.Subview(0, 16))) {
+        return false;
+    }
+
+    if (parsedData_.header.format != XFileHeader::BINARY) {
+        AddBinaryParseError("Not a binary .x file");
+        return false;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    animationSource_ = lazyAnimations_ ? data : ByteView();
+    reader_ = std::make_unique<BinaryReader>(data.data() + 16, data.size() - 16);
+    bool success = ParseBinaryContent();
+
+    parsedData_.statistics.inputBytes = data.size();
+    parsedData_.statistics.parseMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    reader_.reset();
+
+    return success;
+}
+
+bool BinaryXFileParser::ParseBinaryStream(ByteSource& source, uint32_t floatSize, bool textPayload) {
+    TIME_OPERATION("BinaryXFileParser::ParseBinaryStream");
+    ResetBinaryParser();
+
+    auto startTime = std::chrono::steady_clock::now();
+    reader_ = std::make_unique<BinaryReader>(source, streamWindowBytes_);
+    floatSize_ = floatSize;
+    parsedData_.header.format = textPayload ? XFileHeader::TEXT : XFileHeader::BINARY;
+
+    bool success = false;
+    try {
+        // Decompressed payloads may carry a header of their own
+        std::string header = textPayload ? "xof 0303txt " + std::string(floatSize == 64 ? "0064" : "0032") : "";
+        if (reader_->CanRead(16) && reader_->PeekUInt32() == XOF_SIGNATURE) {
+            header = reader_->ReadString(16);
+            if (!ParseBinaryHeader(ByteView(reinterpret_cast<const uint8_t*>(header.data()), header.size()))) {
+                return false;
+            }
+            if (parsedData_.header.format == XFileHeader::COMPRESSED) {
+                AddBinaryParseError("Nested compressed .x payloads are not supported");
+                return false;
+            }
+        }
+
+        if (parsedData_.header.format == XFileHeader::TEXT) {
+            // The text parser needs contiguous input; drain the stream
+            // after the header rather than shifting it in front
+            std::vector<uint8_t> text(header.begin(), header.end());
+            reader_->ReadRemaining(text);
+
+            XFileParser textParser;
+            textParser.SetAnimationFilter(animationFilter_);
+            success = textParser.ParseFromString(ByteView(text).AsStringView());
+            parsedData_ = textParser.TakeParsedData();
+            reader_.reset();
+            return success;
         }
+    } catch (const std::exception& e) {
+        AddBinaryParseError("Failed to read stream header: " + std::string(e.what()));
+        return false;
     }
 
-    logger_.Warning("All DirectX bzip decompression methods failed");
-    return false;
+    success = ParseBinaryContent();
 
-#else
-    logger_.Error("zlib support not available - cannot decompress DirectX bzip format");
-    return false;
-#endif
+    parsedData_.statistics.inputBytes = reader_->GetPosition();
+    timer.AddBytes(parsedData_.statistics.inputBytes);
+    parsedData_.statistics.parseMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    logger_.Info("Streamed " + std::to_string(parsedData_.statistics.inputBytes) + " decompressed bytes through a " +
+                std::to_string(streamWindowBytes_) + " byte window");
+    reader_.reset();
+
+    return success;
 }
 
-bool XFileDecompressor::DecompressBzip0032(const std::vector<uint8_t>& input,
-                                           std::vector<uint8_t>& output) {
-    logger_.Info("Attempting specialized bzip0032 DirectX format decompression");
+std::unique_ptr<ByteSource> BinaryXFileParser::LimitPayload(std::unique_ptr<ByteSource> source, uint32_t floatSize,
+                                                         bool textPayload) {
+    if (!source) {
+        return nullptr;
+    }
+    LimitedByteSource::PrefixCheck check;
+    if (decompressionLimits_.checkBytes > 0) {
+        check = [floatSize, textPayload](ByteView prefix, std::string& error) {
+            return XFileDecompressor::CheckPayloadPrefix(prefix, floatSize, textPayload, error);
+        };
+    }
+    return std::make_unique<LimitedByteSource>(std::move(source), decompressionLimits_.maxOutputBytes,
+                                               decompressionDeadline_, decompressionLimits_.checkBytes,
+                                               std::move(check));
+}
 
-    if (input.size() < 16) {
-        logger_.Error("bzip0032: Input too small for DirectX bzip0032 format");
+bool BinaryXFileParser::ParseDecompressedStream(std::unique_ptr<ByteSource> source, uint32_t floatSize,
+                                                bool textPayload) {
+    // Under the background thread, so a rejected payload stops inflating there
+    source = LimitPayload(std::move(source), floatSize, textPayload);
+    if (!source) {
         return false;
     }
 
-    // Log detailed header analysis
-    std::string hexHeader;
-    for (size_t i = 0; i < std::min<size_t>(32, input.size()); ++i) {
-        char hex[3];
-        sprintf(hex, "%02X", input[i]);
-        hexHeader += hex;
-        if (i < 31) hexHeader += " ";
+    // Decompress on a second thread so inflating the next chunk overlaps
+    // with parsing the current one
+    if (backgroundDecompression_) {
+        ThreadedByteSource threaded(std::move(source), std::max<size_t>(streamWindowBytes_ / 4, 4096));
+        return ParseBinaryStream(threaded, floatSize, textPayload);
+    }
+    return ParseBinaryStream(*source, floatSize, textPayload);
+}
+
+bool BinaryXFileParser::ParseBinaryHeader(ByteView header) {
+    if (header.size() < 16 || !header.StartsWith("xof ")) {
+        AddBinaryParseError("Invalid .x file signature");
+        return false;
     }
-    logger_.Info("Full header (32 bytes): " + hexHeader);
 
-    // DirectX bzip0032 specific analysis
-    // The format seems to be: "xof 0303bzip0032" + compressed data
-    const std::string expectedHeader = "xof 0303bzip0032";
+    std::string_view text = header.AsStringView();
+    auto digits = [&](size_t offset) {
+        char high = text[offset];
+        char low = text[offset + 1];
+        if (high < '0' || high > '9' || low < '0' || low > '9') return -1;
+        return (high - '0') * 10 + (low - '0');
+    };
 
-    if (input.size() >= expectedHeader.length()) {
-        std::string fileHeader(reinterpret_cast<const char*>(input.data()), expectedHeader.length());
-        if (fileHeader == expectedHeader) {
-            logger_.Info("Confirmed bzip0032 format header");
+    parsedData_.header.majorVersion = digits(4);
+    parsedData_.header.minorVersion = digits(6);
+    if (parsedData_.header.majorVersion < 0 || parsedData_.header.minorVersion < 0) {
+        AddBinaryParseError("Invalid .x file version: " + std::string(text.substr(4, 4)));
+        return false;
+    }
 
-            // Skip the header and try to decompress the remaining data
-            size_t dataOffset = expectedHeader.length();
-            std::vector<uint8_t> compressedData(input.begin() + dataOffset, input.end());
+    std::string_view format = text.substr(8, 4);
+    if (format == "bin ") {
+        parsedData_.header.format = XFileHeader::BINARY;
+    } else if (format == "txt ") {
+        parsedData_.header.format = XFileHeader::TEXT;
+    } else if (format == "bzip" || format == "tzip") {
+        parsedData_.header.format = XFileHeader::COMPRESSED;
+    } else {
+        AddBinaryParseError("Unknown .x file format: " + std::string(format));
+        return false;
+    }
 
-            logger_.Info("Attempting decompression of " + std::to_string(compressedData.size()) + " bytes after header");
+    std::string_view floatSize = text.substr(12, 4);
+    if (floatSize == "0032") {
+        floatSize_ = 32;
+    } else if (floatSize == "0064") {
+        floatSize_ = 64;
+    } else {
+        AddBinaryParseError("Invalid float size: " + std::string(floatSize));
+        return false;
+    }
+    parsedData_.header.floatSize = static_cast<int>(floatSize_);
 
-            // Try multiple decompression strategies for the data after header
-            return TryMultipleDecompressionMethods(compressedData, output);
+    return true;
+}
+
+bool BinaryXFileParser::ParseBinaryContent() {
+    // The header is read by now; everything after it decodes through the
+    // specialization for its byte order and float width
+    decoder_ = BinaryValueDecoder::For(reader_->IsLittleEndian(), floatSize_);
+
+    try {
+        if (!ParseDataObjects()) {
+            return false;
         }
+    } catch (const std::exception& e) {
+        AddBinaryParseError("Exception during binary parsing at offset " +
+                           std::to_string(reader_->GetPosition()) + ": " + e.what());
+        return false;
     }
 
-    // If header doesn't match exactly, try with different offsets
-    logger_.Info("Header doesn't match exactly, trying with offsets...");
+    return FinishBinaryParse();
+}
+
+// -----------------------------------------------------------------------------
+// Token level
+// -----------------------------------------------------------------------------
 
-    for (size_t offset = 16; offset <= 32 && offset < input.size(); offset += 4) {
-        std::vector<uint8_t> dataFromOffset(input.begin() + offset, input.end());
-        if (TryMultipleDecompressionMethods(dataFromOffset, output)) {
-            logger_.Info("Successfully decompressed data starting from offset " + std::to_string(offset));
-            return true;
+uint16_t BinaryXFileParser::ReadToken() {
+    DiscardList();
+    return reader_->ReadUInt16();
+}
+
+uint16_t BinaryXFileParser::PeekToken() {
+    DiscardList();
+    return reader_->PeekUInt16();
+}
+
+void BinaryXFileParser::SkipTokenData(uint16_t token) {
+    switch (token) {
+        case BINARY_TOKEN_NAME:
+            reader_->Skip(reader_->ReadUInt32());
+            break;
+        case BINARY_TOKEN_STRING:
+            reader_->Skip(reader_->ReadUInt32());
+            reader_->Skip(2);   // Terminator token
+            break;
+        case BINARY_TOKEN_INTEGER:
+            reader_->Skip(4);
+            break;
+        case BINARY_TOKEN_GUID:
+            reader_->Skip(16);
+            break;
+        case BINARY_TOKEN_INTEGER_LIST:
+        case BINARY_TOKEN_FLOAT_LIST:
+            listToken_ = token;
+            listRemaining_ = reader_->ReadUInt32();
+            DiscardList();
+            break;
+        default:
+            break;  // Punctuation and type keywords carry no data
+    }
+}
+
+bool BinaryXFileParser::SkipObjectBody() {
+    int depth = 1;
+    while (depth > 0) {
+        uint16_t token = ReadToken();
+        if (token == BINARY_TOKEN_OBRACE) {
+            depth++;
+        } else if (token == BINARY_TOKEN_CBRACE) {
+            depth--;
+        } else {
+            SkipTokenData(token);
         }
     }
+    return true;
+}
 
-    logger_.Warning("bzip0032: All specialized decompression attempts failed");
-    return false;
+bool BinaryXFileParser::ReadObjectHeader(std::string& name) {
+    uint16_t token = ReadToken();
+    if (token == BINARY_TOKEN_NAME) {
+        name = ReadName();
+        token = ReadToken();
+    }
+    if (token == BINARY_TOKEN_GUID) {
+        reader_->Skip(16);
+        token = ReadToken();
+    }
+    return token == BINARY_TOKEN_OBRACE;
 }
 
-bool XFileDecompressor::TryMultipleDecompressionMethods(const std::vector<uint8_t>& data,
-                                                       std::vector<uint8_t>& output) {
-#ifdef HAVE_ZLIB
-    if (data.empty()) return false;
+std::string BinaryXFileParser::ReadName() {
+    uint32_t length = reader_->ReadUInt32();
+    return reader_->ReadString(length);
+}
 
-    // Method 1: Try to detect if this might be zlib/deflate with custom wrapper
-    logger_.Info("Trying enhanced deflate detection...");
+XTemplate BinaryXFileParser::ReadObjectType() {
+    uint32_t length = reader_->ReadUInt32();
+    return FindStandardTemplate(reader_->ReadStringView(length));
+}
 
-    // Check for zlib header (0x78xx)
-    if (data.size() >= 2 && data[0] == 0x78) {
-        logger_.Info("Possible zlib header detected (0x78xx)");
-        if (TryZlibDecompression(data, output)) {
-            return true;
+// -----------------------------------------------------------------------------
+// Values
+// -----------------------------------------------------------------------------
+
+bool BinaryXFileParser::NextValue() {
+    if (!FillList()) {
+        return false;
+    }
+    listRemaining_--;
+    return true;
+}
+
+bool BinaryXFileParser::FillList() {
+    while (listRemaining_ == 0) {
+        uint16_t token = reader_->PeekUInt16();
+        if (token == BINARY_TOKEN_INTEGER) {
+            // A lone integer behaves like a one-element list
+            reader_->Skip(2);
+            listToken_ = BINARY_TOKEN_INTEGER_LIST;
+            listRemaining_ = 1;
+        } else if (token == BINARY_TOKEN_INTEGER_LIST || token == BINARY_TOKEN_FLOAT_LIST) {
+            reader_->Skip(2);
+            listToken_ = token;
+            listRemaining_ = reader_->ReadUInt32();
+        } else if (token == BINARY_TOKEN_SEMICOLON || token == BINARY_TOKEN_COMMA) {
+            reader_->Skip(2);
+        } else {
+            return false;
         }
     }
+    return true;
+}
 
-    // Method 2: Try raw deflate with all possible window sizes and offsets
-    std::vector<int> windowSizes = {-15, -14, -13, -12, -11, -10, 15, 14, 13, 12, 11, 10, 9, 8};
-    std::vector<size_t> offsets = {0, 1, 2, 3, 4, 8, 12, 16};
+bool BinaryXFileParser::ReadUInt(uint32_t& value) {
+    if (!NextValue()) {
+        return false;
+    }
+    (listToken_ == BINARY_TOKEN_INTEGER_LIST ? decoder_.readUInts : decoder_.readFloatsAsUInts)(*reader_, &value, 1);
+    return true;
+}
 
-    for (size_t offset : offsets) {
-        if (offset >= data.size()) continue;
+bool BinaryXFileParser::ReadFloat(float& value) {
+    if (!NextValue()) {
+        return false;
+    }
+    (listToken_ == BINARY_TOKEN_FLOAT_LIST ? decoder_.readFloats : decoder_.readUIntsAsFloats)(*reader_, &value, 1);
+    return true;
+}
 
-        for (int windowBits : windowSizes) {
-            if (TryDeflateWithParams(data, output, offset, windowBits)) {
-                logger_.Info("Success with offset " + std::to_string(offset) +
-                           " and window bits " + std::to_string(windowBits));
-                return true;
-            }
+bool BinaryXFileParser::ReadUInts(uint32_t* values, size_t count) {
+    while (count > 0) {
+        if (!FillList()) {
+            return false;
         }
+        size_t chunk = std::min<size_t>(listRemaining_, count);
+        (listToken_ == BINARY_TOKEN_INTEGER_LIST ? decoder_.readUInts : decoder_.readFloatsAsUInts)(*reader_, values,
+                                                                                                    chunk);
+        listRemaining_ -= static_cast<uint32_t>(chunk);
+        values += chunk;
+        count -= chunk;
     }
+    return true;
+}
 
-    // Method 3: Try to interpret as LZ77 variant
-    logger_.Info("Trying LZ77 variant decompression...");
-    if (TryLZ77Decompression(data, output)) {
-        return true;
+bool BinaryXFileParser::ReadFloats(float* values, size_t count) {
+    while (count > 0) {
+        if (!FillList()) {
+            return false;
+        }
+        size_t chunk = std::min<size_t>(listRemaining_, count);
+        (listToken_ == BINARY_TOKEN_FLOAT_LIST ? decoder_.readFloats : decoder_.readUIntsAsFloats)(*reader_, values,
+                                                                                                   chunk);
+        listRemaining_ -= static_cast<uint32_t>(chunk);
+        values += chunk;
+        count -= chunk;
     }
+    return true;
+}
 
-    // Method 4: Try reverse engineering approach - look for patterns
-    logger_.Info("Trying pattern-based decompression...");
-    if (TryPatternBasedDecompression(data, output)) {
+bool BinaryXFileParser::ReadString(std::string& value) {
+    while (true) {
+        uint16_t token = PeekToken();
+        if (token == BINARY_TOKEN_SEMICOLON || token == BINARY_TOKEN_COMMA) {
+            reader_->Skip(2);
+            continue;
+        }
+        if (token != BINARY_TOKEN_STRING && token != BINARY_TOKEN_NAME) {
+            return false;
+        }
+
+        reader_->Skip(2);
+        value = ReadName();
+        if (token == BINARY_TOKEN_STRING) {
+            reader_->Skip(2);   // Terminator token
+        }
         return true;
     }
+}
 
-#endif
-    return false;
+void BinaryXFileParser::DiscardList() {
+    if (listRemaining_ > 0) {
+        size_t elementSize = listToken_ == BINARY_TOKEN_INTEGER_LIST ? 4 : decoder_.floatBytes;
+        reader_->Skip(static_cast<size_t>(listRemaining_) * elementSize);
+        listRemaining_ = 0;
+    }
 }
 
-bool XFileDecompressor::TryZlibDecompression(const std::vector<uint8_t>& data,
-                                            std::vector<uint8_t>& output) {
-#ifdef HAVE_ZLIB
-    z_stream zStream;
-    memset(&zStream, 0, sizeof(zStream));
+// -----------------------------------------------------------------------------
+// Objects
+// -----------------------------------------------------------------------------
+
+bool BinaryXFileParser::ParseTemplate() {
+    // template <name> { <guid> members... } - only the identity is kept
+    if (ReadToken() != BINARY_TOKEN_NAME) {
+        AddBinaryParseError("Template: expected name");
+        return false;
+    }
+
+    BinaryTemplate templ;
+    templ.name = ReadName();
+    templ.standard = FindStandardTemplate(templ.name);
+    if (ReadToken() != BINARY_TOKEN_OBRACE) {
+        AddBinaryParseError("Template '" + templ.name + "': expected '{'");
+        return false;
+    }
 
-    zStream.next_in = const_cast<Bytef*>(data.data());
-    zStream.avail_in = static_cast<uInt>(data.size());
+    if (PeekToken() == BINARY_TOKEN_GUID) {
+        reader_->Skip(2);
+        std::string_view guid = reader_->ReadStringView(16);
+        std::memcpy(templ.guid, guid.data(), sizeof(templ.guid));
+        templ.hasGuid = true;
+    }
+
+    // Objects are dispatched by name, so a redefinition is parsed with the
+    // standard layout anyway
+    uint8_t standardGuid[16];
+    if (templ.hasGuid && GetTemplateGuid(templ.standard, standardGuid) &&
+        std::memcmp(standardGuid, templ.guid, sizeof(standardGuid)) != 0) {
+        AddBinaryParseWarning("Template '" + templ.name + "' redefines a standard template with another GUID");
+    }
 
-    int result = inflateInit(&zStream);
-    if (result != Z_OK) {
+    if (!SkipObjectBody()) {
         return false;
     }
 
-    size_t outputSize = data.size() * 20; // Try larger expansion
-    output.resize(outputSize);
+    templates_.push_back(std::move(templ));
+    return true;
+}
 
-    zStream.next_out = output.data();
-    zStream.avail_out = static_cast<uInt>(outputSize);
+bool BinaryXFileParser::ParseDataObjects() {
+    while (!reader_->IsAtEnd()) {
+        uint16_t token = ReadToken();
 
-    result = inflate(&zStream, Z_FINISH);
+        if (token == BINARY_TOKEN_TEMPLATE) {
+            if (!ParseTemplate()) {
+                return false;
+            }
+            continue;
+        }
 
-    if (result == Z_STREAM_END) {
-        output.resize(zStream.total_out);
-        inflateEnd(&zStream);
+        if (token == BINARY_TOKEN_OBRACE) {
+            // Top-level data reference - nothing to instantiate
+            SkipObjectBody();
+            continue;
+        }
 
-        // Validate the output
-        if (ValidateDecompressedContent(output)) {
-            logger_.Info("zlib decompression successful! Decompressed " +
-                        std::to_string(output.size()) + " bytes");
-            return true;
+        if (token != BINARY_TOKEN_NAME) {
+            AddBinaryParseWarning("Unexpected token " + std::to_string(token) + " at top level");
+            SkipTokenData(token);
+            continue;
         }
+
+        XTemplate objectType = ReadObjectType();
+        std::string objectName;
+        if (!ReadObjectHeader(objectName)) {
+            AddBinaryParseError(std::string("Expected '{' after ") + GetTemplateName(objectType));
+            return false;
+        }
+
+        if (!ParseDataObject(objectType, objectName, -1)) {
+            logger_.Error(std::string("Failed to parse ") + GetTemplateName(objectType) + " object near offset " +
+                          std::to_string(reader_->GetPosition()));
+            return false;
+        }
+        ConversionMetrics::GetInstance().AddObjectsParsed(1);
     }
 
-    inflateEnd(&zStream);
-#endif
-    return false;
+    return true;
 }
 
-bool XFileDecompressor::TryDeflateWithParams(const std::vector<uint8_t>& data,
-                                            std::vector<uint8_t>& output,
-                                            size_t offset, int windowBits) {
-#ifdef HAVE_ZLIB
-    if (offset >= data.size()) return false;
+bool BinaryXFileParser::ParseDataObject(XTemplate type, const std::string& name, int parentBone) {
+    switch (type) {
+        case XTemplate::MESH:
+            return ParseBinaryMesh(name);
+        case XTemplate::FRAME:
+            return ParseBinaryFrame(name, parentBone);
+        case XTemplate::ANIMATION_SET:
+            return ParseBinaryAnimationSet(name);
+        case XTemplate::MATERIAL: {
+            XMaterial material;
+            if (!ParseBinaryMaterial(name, material)) {
+                return false;
+            }
+            parsedData_.materials.push_back(material);
+            materialLibrary_[material.name] = material;
+            return true;
+        }
+        case XTemplate::ANIM_TICKS_PER_SECOND: {
+            uint32_t ticks = 0;
+            if (ReadUInt(ticks)) {
+                fileTicksPerSecond_ = static_cast<float>(ticks);
+            } else {
+                AddBinaryParseWarning("Malformed AnimTicksPerSecond object");
+            }
+            return SkipObjectBody();
+        }
+        default:
+            return SkipObjectBody();
+    }
+}
 
-    z_stream zStream;
-    memset(&zStream, 0, sizeof(zStream));
+bool BinaryXFileParser::ParseBinaryMesh(const std::string& name) {
+    XMeshData& meshData = parsedData_.meshData;
+    if (meshData.name.empty()) {
+        meshData.name = name;
+    }
 
-    zStream.next_in = const_cast<Bytef*>(data.data() + offset);
-    zStream.avail_in = static_cast<uInt>(data.size() - offset);
+    MeshParseContext mesh;
+    mesh.baseVertex = meshData.GetVertexCount();
+    mesh.baseMaterial = meshData.materials.size();
 
-    int result = inflateInit2(&zStream, windowBits);
-    if (result != Z_OK) {
+    uint32_t vertexCount = 0;
+    if (!ReadUInt(vertexCount)) {
+        AddBinaryParseError("Mesh: expected vertex count");
         return false;
     }
 
-    size_t outputSize = (data.size() - offset) * 15; // Even larger expansion
-    output.resize(outputSize);
+    if (!ReadVector3Array(vertexCount, meshData.positions)) {
+        AddBinaryParseError("Mesh: failed to read " + std::to_string(vertexCount) + " vertices");
+        return false;
+    }
+    mesh.vertexCount = vertexCount;
 
-    zStream.next_out = output.data();
-    zStream.avail_out = static_cast<uInt>(outputSize);
+    // Keep attribute streams of earlier meshes aligned with the new positions
+    meshData.ResizeVertices(meshData.positions.size());
 
-    result = inflate(&zStream, Z_FINISH);
+    uint32_t faceCount = 0;
+    if (!ReadUInt(faceCount)) {
+        AddBinaryParseError("Mesh: expected face count");
+        return false;
+    }
 
-    if (result == Z_STREAM_END) {
-        output.resize(zStream.total_out);
-        inflateEnd(&zStream);
+    // Polygons are triangulated as fans
+    size_t polygonReserve = std::min<size_t>(faceCount, MAX_RESERVE);
+    meshData.ReserveFaces(meshData.GetFaceCount() + polygonReserve);
+    mesh.polygonOffsets.reserve(polygonReserve + 1);
+    mesh.polygonFirstFace.reserve(polygonReserve + 1);
+    mesh.polygonIndices.reserve(polygonReserve * 3);
 
-        if (ValidateDecompressedContent(output)) {
-            return true;
+    for (uint32_t i = 0; i < faceCount; i++) {
+        uint32_t cornerCount = 0;
+        if (!ReadUInt(cornerCount)) {
+            AddBinaryParseError("Mesh: failed to read face " + std::to_string(i));
+            return false;
         }
-    }
 
-    inflateEnd(&zStream);
-#endif
-    return false;
-}
+        size_t first = mesh.polygonIndices.size();
+        mesh.polygonOffsets.push_back(first);
+        mesh.polygonFirstFace.push_back(meshData.GetFaceCount());
 
-bool XFileDecompressor::TryLZ77Decompression(const std::vector<uint8_t>& data,
-                                            std::vector<uint8_t>& output) {
-    // Simple LZ77 decompression attempt
-    // This is a basic implementation for DirectX-style LZ compression
+        // Corner indices land in the polygon buffer in one read
+        if (cornerCount > (1u << 16)) {
+            AddBinaryParseError("Mesh: face " + std::to_string(i) + " has " + std::to_string(cornerCount) + " corners");
+            return false;
+        }
+        mesh.polygonIndices.resize(first + cornerCount);
+        if (!ReadUInts(mesh.polygonIndices.data() + first, cornerCount)) {
+            AddBinaryParseError("Mesh: failed to read index of face " + std::to_string(i));
+            return false;
+        }
 
-    if (data.size() < 4) return false;
+        for (uint32_t c = 1; c + 1 < cornerCount; c++) {
+            meshData.AddTriangle(static_cast<int>(mesh.baseVertex + mesh.polygonIndices[first]),
+                                 static_cast<int>(mesh.baseVertex + mesh.polygonIndices[first + c]),
+                                 static_cast<int>(mesh.baseVertex + mesh.polygonIndices[first + c + 1]));
+        }
+    }
+    mesh.polygonOffsets.push_back(mesh.polygonIndices.size());
+    mesh.polygonFirstFace.push_back(meshData.GetFaceCount());
 
-    output.clear();
-    output.reserve(data.size() * 10);
+    // Nested objects (materials, normals, texture coords, etc.)
+    while (true) {
+        uint16_t token = ReadToken();
 
-    size_t pos = 0;
+        if (token == BINARY_TOKEN_CBRACE) {
+            return true;
+        }
 
-    while (pos < data.size()) {
-        uint8_t control = data[pos++];
+        if (token == BINARY_TOKEN_OBRACE) {
+            SkipObjectBody();
+            continue;
+        }
 
-        for (int bit = 0; bit < 8 && pos < data.size(); ++bit) {
-            if (control & (1 << bit)) {
-                // Literal byte
-                if (pos < data.size()) {
-                    output.push_back(data[pos++]);
-                }
-            } else {
-                // Length-distance pair
-                if (pos + 1 >= data.size()) break;
+        if (token != BINARY_TOKEN_NAME) {
+            SkipTokenData(token);
+            continue;
+        }
 
-                uint16_t lengthDistance = (data[pos + 1] << 8) | data[pos];
-                pos += 2;
+        XTemplate childType = ReadObjectType();
+        std::string childName;
+        if (!ReadObjectHeader(childName)) {
+            AddBinaryParseError(std::string("Mesh: expected '{' after ") + GetTemplateName(childType));
+            return false;
+        }
 
-                uint16_t distance = (lengthDistance >> 4) + 1;
-                uint16_t length = (lengthDistance & 0x0F) + 3;
+        bool childParsed = true;
+        switch (childType) {
+            case XTemplate::MESH_MATERIAL_LIST: childParsed = ParseBinaryMaterialList(mesh); break;
+            case XTemplate::MESH_NORMALS: childParsed = ParseBinaryNormals(mesh); break;
+            case XTemplate::MESH_TEXTURE_COORDS: childParsed = ParseBinaryTextureCoords(mesh); break;
+            case XTemplate::SKIN_WEIGHTS: childParsed = ParseBinarySkinWeights(mesh); break;
+            default:
+                // XSkinMeshHeader, VertexDuplicationIndices, DeclData, ...
+                childParsed = SkipObjectBody();
+                break;
+        }
 
-                if (distance > output.size()) {
-                    logger_.Warning("DirectX LZ: Invalid distance reference");
-                    break;
-                }
+        if (!childParsed) {
+            AddBinaryParseError(std::string("Mesh: failed to parse ") + GetTemplateName(childType));
+            return false;
+        }
+    }
+}
 
-                // Copy from the sliding window
-                size_t copyStart = output.size() - distance;
-                for (int i = 0; i < length; ++i) {
-                    if (copyStart + (i % distance) < output.size()) {
-                        output.push_back(output[copyStart + (i % distance)]);
-                    }
-                }
+bool BinaryXFileParser::ParseBinaryMaterialList(const MeshParseContext& mesh) {
+    XMeshData& meshData = parsedData_.meshData;
+
+    uint32_t materialCount = 0;
+    uint32_t indexCount = 0;
+    if (!ReadUInt(materialCount) || !ReadUInt(indexCount)) {
+        return false;
+    }
+
+    size_t polygonCount = mesh.polygonFirstFace.empty() ? 0 : mesh.polygonFirstFace.size() - 1;
+    uint32_t lastMaterial = 0;
+    for (uint32_t i = 0; i < indexCount; i++) {
+        uint32_t materialIndex = 0;
+        if (!ReadUInt(materialIndex)) {
+            return false;
+        }
+        if (i < polygonCount) {
+            for (size_t f = mesh.polygonFirstFace[i]; f < mesh.polygonFirstFace[i + 1]; f++) {
+                meshData.faceMaterials[f] = static_cast<int>(mesh.baseMaterial + materialIndex);
             }
         }
+        lastMaterial = materialIndex;
     }
 
-    if (ValidateDecompressedContent(output)) {
-        logger_.Info("LZ77 decompression successful! Decompressed " +
-                    std::to_string(output.size()) + " bytes");
-        return true;
+    // Fewer indices than faces: the last index applies to the remaining faces
+    for (size_t p = indexCount; p < polygonCount; p++) {
+        for (size_t f = mesh.polygonFirstFace[p]; f < mesh.polygonFirstFace[p + 1]; f++) {
+            meshData.faceMaterials[f] = static_cast<int>(mesh.baseMaterial + lastMaterial);
+        }
     }
 
-    return false;
-}
+    // Materials follow, either inline or as { Name } references
+    while (true) {
+        uint16_t token = ReadToken();
 
-bool XFileDecompressor::TryPatternBasedDecompression(const std::vector<uint8_t>& data,
-                                                   std::vector<uint8_t>& output) {
-    // Look for embedded X-file content or patterns
+        if (token == BINARY_TOKEN_CBRACE) {
+            break;
+        }
 
-    // Search for "xof" pattern within the data
-    for (size_t i = 0; i < data.size() - 3; ++i) {
-        if (data[i] == 'x' && data[i+1] == 'o' && data[i+2] == 'f' && data[i+3] == ' ') {
-            logger_.Info("Found embedded 'xof ' pattern at offset " + std::to_string(i));
+        if (token == BINARY_TOKEN_OBRACE) {
+            if (PeekToken() == BINARY_TOKEN_NAME) {
+                reader_->Skip(2);
+                std::string reference = ReadName();
+                auto it = materialLibrary_.find(reference);
+                if (it != materialLibrary_.end()) {
+                    meshData.materials.push_back(it->second);
+                } else {
+                    AddBinaryParseWarning("MeshMaterialList references unknown material: " + reference);
+                    XMaterial placeholder;
+                    placeholder.name = reference;
+                    placeholder.diffuseColor = XVector3(1.0f, 1.0f, 1.0f);
+                    placeholder.shininess = 0.0f;
+                    placeholder.transparency = 0.0f;
+                    meshData.materials.push_back(placeholder);
+                }
+            }
+            SkipObjectBody();
+            continue;
+        }
 
-            // Try to extract data from this point
-            output.assign(data.begin() + i, data.end());
+        if (token != BINARY_TOKEN_NAME) {
+            SkipTokenData(token);
+            continue;
+        }
 
-            if (ValidateDecompressedContent(output)) {
-                logger_.Info("Pattern-based extraction successful!");
-                return true;
+        XTemplate childType = ReadObjectType();
+        std::string childName;
+        if (!ReadObjectHeader(childName)) {
+            return false;
+        }
+
+        if (childType == XTemplate::MATERIAL) {
+            XMaterial material;
+            if (!ParseBinaryMaterial(childName, material)) {
+                return false;
             }
+            meshData.materials.push_back(std::move(material));
+        } else {
+            SkipObjectBody();
         }
     }
 
-    // Try to find template patterns
-    const std::string templatePattern = "template";
-    for (size_t i = 0; i <= data.size() - templatePattern.length(); ++i) {
-        if (std::memcmp(data.data() + i, templatePattern.c_str(), templatePattern.length()) == 0) {
-            logger_.Info("Found 'template' pattern at offset " + std::to_string(i));
+    if (meshData.materials.size() - mesh.baseMaterial != materialCount) {
+        AddBinaryParseWarning("MeshMaterialList declares " + std::to_string(materialCount) + " materials but provides " +
+                             std::to_string(meshData.materials.size() - mesh.baseMaterial));
+    }
 
-            // Extract from the beginning or from this point
-            if (i > 0) {
-                // Try from beginning with this as validation
-                output.assign(data.begin(), data.end());
-            } else {
-                output.assign(data.begin() + i, data.end());
-            }
+    return true;
+}
 
-            if (ValidateDecompressedContent(output)) {
-                logger_.Info("Template pattern extraction successful!");
-                return true;
+bool BinaryXFileParser::ParseBinaryNormals(const MeshParseContext& mesh) {
+    XMeshData& meshData = parsedData_.meshData;
+    meshData.EnsureNormals();
+
+    uint32_t normalCount = 0;
+    std::vector<XVector3> normals;
+    if (!ReadUInt(normalCount) || !ReadVector3Array(normalCount, normals)) {
+        return false;
+    }
+
+    // Face normal indices mirror the mesh polygons; map each corner's normal
+    // onto the vertex it references
+    uint32_t faceCount = 0;
+    if (!ReadUInt(faceCount)) {
+        return false;
+    }
+
+    size_t polygonCount = mesh.polygonOffsets.empty() ? 0 : mesh.polygonOffsets.size() - 1;
+    std::vector<uint32_t> normalIndices;
+    for (uint32_t f = 0; f < faceCount; f++) {
+        uint32_t cornerCount = 0;
+        if (!ReadUInt(cornerCount) || cornerCount > (1u << 16)) {
+            return false;
+        }
+        normalIndices.resize(cornerCount);
+        if (!ReadUInts(normalIndices.data(), cornerCount)) {
+            return false;
+        }
+        for (uint32_t c = 0; c < cornerCount; c++) {
+            uint32_t normalIndex = normalIndices[c];
+            if (f < polygonCount && normalIndex < normals.size() &&
+                mesh.polygonOffsets[f] + c < mesh.polygonOffsets[f + 1]) {
+                uint32_t vertex = mesh.polygonIndices[mesh.polygonOffsets[f] + c];
+                if (vertex < mesh.vertexCount) {
+                    meshData.normals[mesh.baseVertex + vertex] = normals[normalIndex];
+                }
             }
         }
     }
 
-    return false;
+    return SkipObjectBody();
 }
 
-bool XFileDecompressor::ValidateDecompressedContent(const std::vector<uint8_t>& data) {
-    if (data.empty()) return false;
+bool BinaryXFileParser::ParseBinaryTextureCoords(const MeshParseContext& mesh) {
+    XMeshData& meshData = parsedData_.meshData;
+    meshData.EnsureTexCoords();
 
-    // Check for X-file signatures
-    std::string start(reinterpret_cast<const char*>(data.data()),
-                     std::min<size_t>(16, data.size()));
+    uint32_t coordCount = 0;
+    if (!ReadUInt(coordCount)) {
+        return false;
+    }
 
-    logger_.Info("Validating decompressed content, starts with: '" + start + "'");
+    // Coordinates for this mesh's vertices go straight into the stream
+    uint32_t direct = std::min<uint32_t>(coordCount, static_cast<uint32_t>(mesh.vertexCount));
+    if (!ReadVector2Array(direct, meshData.texCoords.data() + mesh.baseVertex)) {
+        return false;
+    }
 
-    // Valid X-file should start with "xof " or contain "template"
-    if (start.find("xof ") == 0) {
-        logger_.Info("Valid X-file header found");
-        return true;
+    return SkipObjectBody();
+}
+
+bool BinaryXFileParser::ParseBinarySkinWeights(const MeshParseContext& mesh) {
+    PendingSkinWeights skin;
+
+    uint32_t weightCount = 0;
+    if (!ReadString(skin.boneName) || !ReadUInt(weightCount)) {
+        return false;
     }
 
-    if (data.size() > 100) {
-        std::string larger(reinterpret_cast<const char*>(data.data()),
-                          std::min<size_t>(100, data.size()));
-        if (larger.find("template") != std::string::npos) {
-            logger_.Info("X-file template found in content");
-            return true;
+    while (skin.vertexIndices.size() < weightCount) {
+        size_t offset = skin.vertexIndices.size();
+        skin.vertexIndices.resize(offset + std::min<size_t>(weightCount - offset, MAX_RESERVE));
+        if (!ReadUInts(skin.vertexIndices.data() + offset, skin.vertexIndices.size() - offset)) {
+            return false;
+        }
+    }
+    for (uint32_t& index : skin.vertexIndices) {
+        index += static_cast<uint32_t>(mesh.baseVertex);
+    }
+
+    while (skin.weights.size() < weightCount) {
+        size_t offset = skin.weights.size();
+        skin.weights.resize(offset + std::min<size_t>(weightCount - offset, MAX_RESERVE));
+        if (!ReadFloats(skin.weights.data() + offset, skin.weights.size() - offset)) {
+            return false;
         }
     }
 
-    // Check for binary X-file signature
-    if (data.size() >= 4) {
-        if ((data[0] == 'x' && data[1] == 'o' && data[2] == 'f' && data[3] == ' ') ||
-            (data[0] == 0x78 && data[1] == 0x6f && data[2] == 0x66 && data[3] == 0x20)) {
-            logger_.Info("Binary X-file signature detected");
+    if (!ReadMatrix4x4(skin.offsetMatrix)) {
+        return false;
+    }
+
+    pendingSkinWeights_.push_back(std::move(skin));
+    return SkipObjectBody();
+}
+
+bool BinaryXFileParser::ParseBinaryFrame(const std::string& name, int parentBone) {
+    // Every frame becomes a bone so animations and skin weights can target it
+    std::string frameName = name.empty()
+        ? "Frame_" + std::to_string(parsedData_.meshData.bones.size())
+        : name;
+
+    int boneIndex = parsedData_.meshData.AddBone(frameName);
+    if (parentBone >= 0) {
+        parsedData_.meshData.bones[boneIndex].parentIndex = parentBone;
+    }
+
+    while (true) {
+        uint16_t token = ReadToken();
+
+        if (token == BINARY_TOKEN_CBRACE) {
             return true;
         }
+
+        if (token == BINARY_TOKEN_OBRACE) {
+            SkipObjectBody();
+            continue;
+        }
+
+        if (token != BINARY_TOKEN_NAME) {
+            SkipTokenData(token);
+            continue;
+        }
+
+        XTemplate childType = ReadObjectType();
+        std::string childName;
+        if (!ReadObjectHeader(childName)) {
+            AddBinaryParseError("Frame '" + frameName + "': expected '{' after " + GetTemplateName(childType));
+            return false;
+        }
+
+        bool childParsed = true;
+        if (childType == XTemplate::FRAME_TRANSFORM_MATRIX) {
+            XMatrix4x4 matrix;
+            childParsed = ReadMatrix4x4(matrix) && SkipObjectBody();
+            if (childParsed) {
+                parsedData_.meshData.bones[boneIndex].bindPose = matrix;
+            }
+        } else {
+            childParsed = ParseDataObject(childType, childName, boneIndex);
+        }
+
+        if (!childParsed) {
+            AddBinaryParseError("Frame '" + frameName + "': failed to parse " + GetTemplateName(childType));
+            return false;
+        }
     }
+}
 
-    return false;
+bool BinaryXFileParser::DecodeAnimations(const std::vector<std::string>& names) {
+    TIME_OPERATION("BinaryXFileParser::DecodeAnimations");
+
+    XMeshData& meshData = parsedData_.meshData;
+    for (auto& info : parsedData_.animationSets) {
+        if (info.decoded || !XFileUtils::MatchesAnimationFilter(names, info.name)) {
+            continue;
+        }
+        if (animationSource_.size() < info.offset || animationSource_.size() - info.offset < info.length) {
+            AddBinaryParseError("AnimationSet '" + info.name + "' was not kept for lazy decoding");
+            return false;
+        }
+
+        XAnimationSet animSet;
+        animSet.name = info.name;
+        reader_ = std::make_unique<BinaryReader>(animationSource_.data() + info.offset, info.length);
+        listToken_ = 0;
+        listRemaining_ = 0;
+        bool success = false;
+        try {
+            success = ParseBinaryAnimationSetBody(animSet);
+        } catch (const std::exception& e) {
+            AddBinaryParseError("AnimationSet '" + info.name + "': " + e.what());
+        }
+        reader_.reset();
+        if (!success) {
+            return false;
+        }
+        timer.AddBytes(info.length);
+
+        info.decoded = true;
+        if (!animSet.tracks.empty()) {
+            animSet.ticksPerSecond = meshData.globalTicksPerSecond;
+            meshData.animations.push_back(std::move(animSet));
+        }
+    }
+    return true;
 }
 
-// Add new method to handle Microsoft LZ compression (commonly used in DirectX)
-bool XFileDecompressor::DecompressDirectXLZ(const std::vector<uint8_t>& input,
-                                           std::vector<uint8_t>& output) {
-    logger_.Info("Attempting DirectX LZ decompression of " + std::to_string(input.size()) + " bytes");
+bool BinaryXFileParser::ParseBinaryAnimationSet(const std::string& name) {
+    XAnimationSetInfo info;
+    info.name = name.empty()
+        ? "Animation_" + std::to_string(parsedData_.animationSets.size())
+        : name;
+    info.offset = BINARY_HEADER_SIZE + reader_->GetPosition();
+
+    // Only an in-memory input can be decoded later; a stream is consumed
+    bool deferred = !animationSource_.empty() && !reader_->IsStreaming();
+    if ((lazyAnimations_ && deferred) || !XFileUtils::MatchesAnimationFilter(animationFilter_, info.name)) {
+        if (!IndexBinaryAnimationSetBody(info)) {
+            return false;
+        }
+        info.length = BINARY_HEADER_SIZE + reader_->GetPosition() - info.offset;
+        parsedData_.animationSets.push_back(std::move(info));
+        return true;
+    }
 
-    if (input.size() < 8) {
-        logger_.Error("DirectX LZ: Input too small");
+    XAnimationSet animSet;
+    animSet.name = info.name;
+    if (!ParseBinaryAnimationSetBody(animSet)) {
         return false;
     }
 
-    // Analyze the header structure
-    // Many DirectX files use a custom LZ format with specific headers
-    const uint8_t* data = input.data();
+    info.length = BINARY_HEADER_SIZE + reader_->GetPosition() - info.offset;
+    info.trackCount = animSet.tracks.size();
+    info.keyCount = animSet.GetKeyCount();
+    info.decoded = true;
+    parsedData_.animationSets.push_back(std::move(info));
 
-    // Check for common DirectX LZ signatures
-    uint32_t header = (data[3] << 24) | (data[2] << 16) | (data[1] << 8) | data[0];
+    if (!animSet.tracks.empty()) {
+        parsedData_.meshData.animations.push_back(std::move(animSet));
+    }
+    return true;
+}
 
-    logger_.Info("DirectX LZ header analysis: 0x" +
-                std::to_string(header) + " (" +
-                std::to_string(data[0]) + " " +
-                std::to_string(data[1]) + " " +
-                std::to_string(data[2]) + " " +
-                std::to_string(data[3]) + ")");
+bool BinaryXFileParser::IndexBinaryAnimationSetBody(XAnimationSetInfo& info) {
+    // Counts Animation objects and reads AnimationKey headers; key lists
+    // are skipped by their token length
+    while (true) {
+        uint16_t token = ReadToken();
+        if (token == BINARY_TOKEN_CBRACE) {
+            return true;
+        }
+        if (token == BINARY_TOKEN_OBRACE) {
+            SkipObjectBody();
+            continue;
+        }
+        if (token != BINARY_TOKEN_NAME) {
+            SkipTokenData(token);
+            continue;
+        }
 
-    // Method 1: Try Microsoft LZ decompression algorithm
-    // This is a simplified LZ77 implementation often used by DirectX
-    if (header == 0x00038760) { // Common DirectX LZ header
-        logger_.Info("Detected DirectX LZ format with signature 0x00038760");
+        XTemplate childType = ReadObjectType();
+        std::string childName;
+        if (!ReadObjectHeader(childName)) {
+            AddBinaryParseError("AnimationSet '" + info.name + "': expected '{' after " + GetTemplateName(childType));
+            return false;
+        }
+        if (childType != XTemplate::ANIMATION) {
+            SkipObjectBody();
+            continue;
+        }
 
-        size_t inputPos = 4; // Skip header
-        output.clear();
-        output.reserve(input.size() * 8); // Reserve space
+        info.trackCount++;
+        while (true) {
+            token = ReadToken();
+            if (token == BINARY_TOKEN_CBRACE) {
+                break;
+            }
+            if (token == BINARY_TOKEN_OBRACE) {
+                SkipObjectBody();
+                continue;
+            }
+            if (token != BINARY_TOKEN_NAME) {
+                SkipTokenData(token);
+                continue;
+            }
+
+            XTemplate keyType = ReadObjectType();
+            if (!ReadObjectHeader(childName)) {
+                AddBinaryParseError(std::string("Animation: expected '{' after ") + GetTemplateName(keyType));
+                return false;
+            }
+            uint32_t type = 0;
+            uint32_t numKeys = 0;
+            if (keyType == XTemplate::ANIMATION_KEY && ReadUInt(type) && ReadUInt(numKeys)) {
+                info.keyCount += numKeys;
+            }
+            SkipObjectBody();
+        }
+    }
+}
 
-        while (inputPos < input.size()) {
-            if (inputPos >= input.size()) break;
+bool BinaryXFileParser::ParseBinaryAnimationSetBody(XAnimationSet& animSet) {
+    while (true) {
+        uint16_t token = ReadToken();
 
-            uint8_t flag = data[inputPos++];
+        if (token == BINARY_TOKEN_CBRACE) {
+            break;
+        }
 
-            // Process 8 bits in the flag byte
-            for (int bit = 0; bit < 8 && inputPos < input.size(); ++bit) {
-                if (flag & (1 << bit)) {
-                    // Literal
-                    output.push_back(data[inputPos++]);
-                } else {
-                    // Match
-                    if (inputPos + 1 >= input.size()) break;
+        if (token == BINARY_TOKEN_OBRACE) {
+            SkipObjectBody();
+            continue;
+        }
 
-                    uint16_t match = data[inputPos] | (data[inputPos + 1] << 8);
-                    inputPos += 2;
+        if (token != BINARY_TOKEN_NAME) {
+            SkipTokenData(token);
+            continue;
+        }
 
-                    int offset = (match >> 4) + 1;
-                    int length = (match & 0x0F) + 3;
+        XTemplate childType = ReadObjectType();
+        std::string childName;
+        if (!ReadObjectHeader(childName)) {
+            AddBinaryParseError("AnimationSet '" + animSet.name + "': expected '{' after " + GetTemplateName(childType));
+            return false;
+        }
 
-                    if (offset <= output.size()) {
-                        size_t start = output.size() - offset;
-                        for (int j = 0; j < length; ++j) {
-                            output.push_back(output[start + (j % offset)]);
-                        }
-                    }
-                }
+        bool childParsed = (childType == XTemplate::ANIMATION)
+            ? ParseBinaryAnimation(animSet)
+            : SkipObjectBody();
+        if (!childParsed) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BinaryXFileParser::ParseBinaryAnimation(XAnimationSet& animSet) {
+    std::string boneName;
+    XBoneTrack track;
+
+    while (true) {
+        uint16_t token = ReadToken();
+
+        if (token == BINARY_TOKEN_CBRACE) {
+            break;
+        }
+
+        if (token == BINARY_TOKEN_OBRACE) {
+            // Reference to the animated frame: { BoneName }
+            if (PeekToken() == BINARY_TOKEN_NAME) {
+                reader_->Skip(2);
+                boneName = ReadName();
             }
+            SkipObjectBody();
+            continue;
         }
 
-        if (!output.empty()) {
-            logger_.Info("DirectX LZ decompression successful! Decompressed " +
-                        std::to_string(output.size()) + " bytes");
+        if (token != BINARY_TOKEN_NAME) {
+            SkipTokenData(token);
+            continue;
+        }
 
-            // Validate decompressed content
-            std::string start(reinterpret_cast<const char*>(output.data()),
-                            std::min<size_t>(16, output.size()));
-            logger_.Info("Decompressed data starts with: " + start);
+        XTemplate childType = ReadObjectType();
+        std::string childName;
+        if (!ReadObjectHeader(childName)) {
+            AddBinaryParseError(std::string("Animation: expected '{' after ") + GetTemplateName(childType));
+            return false;
+        }
 
-            if (start.find("xof") == 0 || start.find("template") != std::string::npos) {
-                logger_.Info("Decompressed data appears to be valid X-file content!");
-                return true;
+        if (childType == XTemplate::ANIMATION_KEY) {
+            if (!ParseBinaryAnimationKey(track)) {
+                AddBinaryParseError("Animation: failed to parse AnimationKey");
+                return false;
+            }
+        } else {
+            // Inline frame instead of a reference
+            if (childType == XTemplate::FRAME && boneName.empty()) {
+                boneName = childName;
             }
+            SkipObjectBody();   // AnimationOptions, ...
         }
     }
 
-    // Method 2: Try LZSS decompression (another common DirectX format)
-    logger_.Info("Trying LZSS decompression variant...");
-
-    output.clear();
-    size_t pos = 0;
-
-    // Skip any header bytes and try direct LZSS
-    for (size_t headerSkip : {0, 4, 8, 12, 16}) {
-        if (headerSkip >= input.size()) continue;
-
-        pos = headerSkip;
-        output.clear();
-
-        while (pos < input.size()) {
-            if (pos >= input.size()) break;
+    if (track.GetKeyCount() > 0) {
+        // Frames declared after the animation find the bone added here
+        track.boneId = boneName.empty() ? -1 : parsedData_.meshData.AddBone(boneName);
+        animSet.duration = std::max(animSet.duration, track.GetEndTime());
+        animSet.AddTrack(std::move(track));
+    }
 
-            uint8_t flags = data[pos++];
+    return true;
+}
 
-            for (int i = 0; i < 8 && pos < input.size(); ++i) {
-                if (flags & (0x01 << i)) {
-                    // Literal
-                    output.push_back(data[pos++]);
-                } else {
-                    // Match
-                    if (pos + 1 >= input.size()) break;
+bool BinaryXFileParser::ParseBinaryAnimationKey(XBoneTrack& track) {
+    uint32_t keyType = 0;
+    uint32_t numKeys = 0;
+    if (!ReadUInt(keyType) || !ReadUInt(numKeys)) {
+        return false;
+    }
 
-                    uint16_t match = data[pos] | (data[pos + 1] << 8);
-                    pos += 2;
+    // Each key type fills its own channel; the others keep no data
+    XAnimationChannel* channel = nullptr;
+    size_t components = XBoneTrack::VECTOR_COMPONENTS;
+    switch (keyType) {
+        case 0: channel = &track.rotation; components = XBoneTrack::ROTATION_COMPONENTS; break;
+        case 1: channel = &track.scale; break;
+        case 2: channel = &track.translation; break;
+        case 4: channel = &track.translation; break;   // Matrix - only the translation row is kept
+        default: break;
+    }
+    if (channel) {
+        channel->Reserve(channel->GetKeyCount() + std::min<size_t>(numKeys, MAX_RESERVE), components);
+    }
 
-                    int offset = (match >> 4) + 1;
-                    int length = (match & 0x0F) + 3;
+    for (uint32_t i = 0; i < numKeys; i++) {
+        uint32_t tick = 0;
+        uint32_t valueCount = 0;
+        if (!ReadUInt(tick) || !ReadUInt(valueCount)) {
+            return false;
+        }
 
-                    if (offset <= output.size()) {
-                        size_t start = output.size() - offset;
-                        for (int j = 0; j < length; ++j) {
-                            output.push_back(output[start + (j % offset)]);
-                        }
-                    }
-                }
+        // The first 16 values in one bulk read; any beyond are dropped
+        float values[16] = {0};
+        float extra = 0.0f;
+        if (!ReadFloats(values, std::min<uint32_t>(valueCount, 16))) {
+            return false;
+        }
+        for (uint32_t v = 16; v < valueCount; v++) {
+            if (!ReadFloat(extra)) {
+                return false;
             }
         }
 
-        // Check if decompression was successful
-        if (output.size() > 100) { // Reasonable size check
-            std::string start(reinterpret_cast<const char*>(output.data()),
-                            std::min<size_t>(16, output.size()));
+        const size_t required = (keyType == 4) ? 16 : components;
+        if (!channel || valueCount < required) {
+            continue;
+        }
 
-            if (start.find("xof") == 0 || start.find("template") != std::string::npos) {
-                logger_.Info("LZSS decompression successful with " +
-                           std::to_string(headerSkip) + " byte skip! Decompressed " +
-                           std::to_string(output.size()) + " bytes");
-                return true;
-            }
+        float time = static_cast<float>(tick);
+        if (keyType == 0) {
+            // Quaternion stored w first
+            const float rotation[4] = {values[1], values[2], values[3], values[0]};
+            channel->AddKey(time, rotation, components);
+        } else {
+            channel->AddKey(time, keyType == 4 ? &values[12] : values, components);
         }
     }
 
-    logger_.Warning("All DirectX LZ decompression methods failed");
-    return false;
+    if (channel) {
+        channel->SortByTime(components);
+    }
+
+    return SkipObjectBody();
 }
 
-// =============================================================================
-// BinaryXFileParser Implementation
-// =============================================================================
+bool BinaryXFileParser::ParseBinaryMaterial(const std::string& name, XMaterial& material) {
+    material.name = name.empty()
+        ? "Material_" + std::to_string(parsedData_.materials.size() + parsedData_.meshData.materials.size())
+        : name;
+    material.shininess = 0.0f;
+    material.transparency = 0.0f;
+
+    // faceColor (RGBA), power, specularColor, emissiveColor
+    float alpha = 1.0f;
+    if (!ReadVector3(material.diffuseColor) || !ReadFloat(alpha) ||
+        !ReadFloat(material.shininess) ||
+        !ReadVector3(material.specularColor) ||
+        !ReadVector3(material.emissiveColor)) {
+        AddBinaryParseError("Material '" + material.name + "': incomplete color data");
+        return false;
+    }
+    material.transparency = 1.0f - alpha;
 
-BinaryXFileParser::BinaryXFileParser() : logger_(Logger::GetInstance()) {
-}
+    while (true) {
+        uint16_t token = ReadToken();
 
-BinaryXFileParser::~BinaryXFileParser() = default;
+        if (token == BINARY_TOKEN_CBRACE) {
+            return true;
+        }
 
-bool BinaryXFileParser::ParseBinaryFile(const std::string& filepath) {
-    logger_.Info("Attempting to parse binary .x file: " + filepath);
+        if (token == BINARY_TOKEN_OBRACE) {
+            SkipObjectBody();
+            continue;
+        }
 
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file.is_open()) {
-        logger_.Error("Failed to open file: " + filepath);
-        return false;
-    }
+        if (token != BINARY_TOKEN_NAME) {
+            SkipTokenData(token);
+            continue;
+        }
 
-    // Read file data
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
+        XTemplate childType = ReadObjectType();
+        std::string childName;
+        if (!ReadObjectHeader(childName)) {
+            return false;
+        }
 
-    std::vector<uint8_t> data(fileSize);
-    file.read(reinterpret_cast<char*>(data.data()), fileSize);
+        // TextureFilename / TextureFileName / NormalmapFilename
+        std::string filename;
+        bool isTexture = childType == XTemplate::TEXTURE_FILENAME;
+        bool isNormalMap = childType == XTemplate::NORMALMAP_FILENAME;
+        if ((isTexture || isNormalMap) && ReadString(filename)) {
+            (isTexture ? material.diffuseTexture : material.normalTexture) = filename;
+        }
 
-    return ParseBinaryData(data);
+        SkipObjectBody();
+    }
 }
 
-bool BinaryXFileParser::ParseBinaryData(const std::vector<uint8_t>& data) {
-    logger_.Warning("Binary .x file parsing not fully implemented");
+bool BinaryXFileParser::ReadVector3(XVector3& value) {
+    return ReadFloats(&value.x, 3);
+}
 
-    // Basic validation
-    if (data.size() < 16) {
-        logger_.Error("File too small to be a valid .x file");
-        return false;
-    }
+bool BinaryXFileParser::ReadMatrix4x4(XMatrix4x4& matrix) {
+    return ReadFloats(&matrix.m[0][0], 16);
+}
 
-    // Check for .x file signature
-    if (data.size() >= 4) {
-        std::string signature(data.begin(), data.begin() + 4);
-        if (signature != "xof ") {
-            logger_.Error("Invalid .x file signature");
+bool BinaryXFileParser::ReadVector3Array(uint32_t count, std::vector<XVector3>& values) {
+    static_assert(sizeof(XVector3) == 3 * sizeof(float), "XVector3 must be three packed floats");
+
+    // Straight into the destination, growing in bounded steps
+    size_t end = values.size() + count;
+    while (values.size() < end) {
+        size_t offset = values.size();
+        values.resize(offset + std::min(end - offset, MAX_RESERVE));
+        if (!ReadFloats(&values[offset].x, (values.size() - offset) * 3)) {
+            values.resize(offset);
             return false;
         }
     }
+    return true;
+}
 
-    // Placeholder - would implement full binary parsing here
-    return false;
+bool BinaryXFileParser::ReadVector2Array(uint32_t count, XVector2* values) {
+    static_assert(sizeof(XVector2) == 2 * sizeof(float), "XVector2 must be two packed floats");
+    return ReadFloats(&values->u, static_cast<size_t>(count) * 2);
 }
 
-bool BinaryXFileParser::ParseCompressedFile(const std::string& filepath) {
-    logger_.Info("Attempting to parse compressed .x file: " + filepath);
+// -----------------------------------------------------------------------------
+// Post-processing
+// -----------------------------------------------------------------------------
 
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file.is_open()) {
-        logger_.Error("Failed to open file: " + filepath);
-        return false;
+void BinaryXFileParser::ResolveSkinWeights() {
+    XMeshData& meshData = parsedData_.meshData;
+
+    if (!pendingSkinWeights_.empty()) {
+        meshData.EnsureSkinInfluences();
     }
 
-    // Read file data
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
+    size_t droppedInfluences = 0;
+    std::vector<uint32_t> overflowVertices;
 
-    std::vector<uint8_t> data(fileSize);
-    file.read(reinterpret_cast<char*>(data.data()), fileSize);
+    for (const auto& skin : pendingSkinWeights_) {
+        int boneIndex = meshData.AddBone(skin.boneName);
+        meshData.bones[boneIndex].offsetMatrix = skin.offsetMatrix;
 
-    XFileDecompressor decompressor;
-    std::vector<uint8_t> decompressedData;
-    std::vector<uint8_t> compressedData;
-
-    // Check if this is a DirectX .x file with compression
-    if (data.size() >= 16) {
-        std::string signature(data.begin(), data.begin() + 4);
-        if (signature == "xof ") {
-            std::string header(data.begin(), data.begin() + 16);
-            std::string formatStr = header.substr(8, 4);
-
-            logger_.Info("DirectX .x file detected with format: " + formatStr);
-
-            if (formatStr == "bzip") {
-                logger_.Info("DirectX .x file with bzip2 compression detected");
-
-                // DirectX .x compressed files have a more complex structure
-                // Let's analyze the file structure step by step
-                logger_.Info("Analyzing DirectX .x file structure...");
-                logger_.Info("File size: " + std::to_string(data.size()) + " bytes");
-
-                // Log the first 32 bytes for analysis
-                if (data.size() >= 32) {
-                    std::string hexDump = "First 32 bytes: ";
-                    for (size_t i = 0; i < 32; ++i) {
-                        char hex[4];
-                        sprintf(hex, "%02X ", data[i]);
-                        hexDump += hex;
-                    }
-                    logger_.Info(hexDump);
-                }
+        for (size_t i = 0; i < skin.vertexIndices.size(); i++) {
+            uint32_t vertex = skin.vertexIndices[i];
+            if (vertex >= meshData.GetVertexCount()) {
+                AddBinaryParseWarning("SkinWeights for '" + skin.boneName + "' reference invalid vertex " +
+                                     std::to_string(vertex));
+                continue;
+            }
+            if (!meshData.skinInfluences[vertex].Add(boneIndex, skin.weights[i])) {
+                droppedInfluences++;
+                overflowVertices.push_back(vertex);
+            }
+        }
+    }
 
-                // Try different offsets to find bzip2 data
-                bool found = false;
-                std::vector<size_t> offsetsToTry = {16, 20, 24, 28, 32, 40, 48, 64};
-
-                for (size_t offset : offsetsToTry) {
-                    if (data.size() > offset) {
-                        compressedData.assign(data.begin() + offset, data.end());
-
-                        logger_.Info("Trying offset " + std::to_string(offset) + " bytes...");
-                        if (compressedData.size() >= 4) {
-                            std::string firstBytes = "";
-                            size_t maxBytes = (compressedData.size() < 8) ? compressedData.size() : 8;
-                            for (size_t i = 0; i < maxBytes; ++i) {
-                                char hex[4];
-                                sprintf(hex, "%02X ", compressedData[i]);
-                                firstBytes += hex;
-                            }
-                            logger_.Info("Data at offset " + std::to_string(offset) + ": " + firstBytes);
-                        }
+    if (droppedInfluences > 0) {
+        std::sort(overflowVertices.begin(), overflowVertices.end());
+        overflowVertices.erase(std::unique(overflowVertices.begin(), overflowVertices.end()), overflowVertices.end());
+        for (uint32_t vertex : overflowVertices) {
+            meshData.skinInfluences[vertex].Normalize();
+        }
 
-                        if (decompressor.IsBzip2Compressed(compressedData)) {
-                            logger_.Info("Valid bzip2 compressed data found at offset " + std::to_string(offset));
-                            if (!decompressor.DecompressBzip2(compressedData, decompressedData)) {
-                                logger_.Error("Failed to decompress bzip2 data from DirectX .x file");
-                                return false;
-                            }
-                            found = true;
-                            break;
-                        }
-                    }
-                }
+        AddBinaryParseWarning(std::to_string(droppedInfluences) + " bone influences beyond " +
+                             std::to_string(XVertexInfluences::MAX_INFLUENCES) + " per vertex were dropped on " +
+                             std::to_string(overflowVertices.size()) + " vertices");
+    }
 
-                if (!found) {
-                    // Let's also try to search for 'BZ' signature anywhere in the file
-                    logger_.Info("Searching for BZ signature anywhere in the file...");
-                    for (size_t i = 0; i < data.size() - 2; ++i) {
-                        if (data[i] == 'B' && data[i + 1] == 'Z') {
-                            logger_.Info("Found 'BZ' signature at byte offset " + std::to_string(i));
-
-                            compressedData.assign(data.begin() + i, data.end());
-                            if (decompressor.IsBzip2Compressed(compressedData)) {
-                                logger_.Info("Valid bzip2 data found at offset " + std::to_string(i));
-                                if (!decompressor.DecompressBzip2(compressedData, decompressedData)) {
-                                    logger_.Error("Failed to decompress bzip2 data from DirectX .x file");
-                                    return false;
-                                }
-                                found = true;
-                                break;
-                            }
-                        }
-                    }
-                }
+    pendingSkinWeights_.clear();
+}
 
-                if (!found) {
-                    // This may be a DirectX proprietary compression format, not standard bzip2
-                    logger_.Warning("Standard bzip2 signature not found - this may be DirectX proprietary compression");
+bool BinaryXFileParser::FinishBinaryParse() {
+    XMeshData& meshData = parsedData_.meshData;
+    ResolveSkinWeights();
 
-                    // Try DirectX-specific bzip0032 decompression first
-                    logger_.Info("Attempting DirectX proprietary bzip0032 decompression...");
+    // Timing: AnimTicksPerSecond applies to the whole file
+    bool hasTiming = fileTicksPerSecond_ > 0;
+    float ticksPerSecond = hasTiming ? fileTicksPerSecond_ : 4800.0f;
+    meshData.globalTicksPerSecond = ticksPerSecond;
+    meshData.hasTimingInfo = hasTiming;
+    parsedData_.header.hasAnimationTimingInfo = hasTiming;
+    parsedData_.header.ticksPerSecond = ticksPerSecond;
+    for (auto& anim : meshData.animations) {
+        anim.ticksPerSecond = ticksPerSecond;
+    }
+    for (auto& info : parsedData_.animationSets) {
+        info.ticksPerSecond = ticksPerSecond;
+    }
 
-                    // Use the specialized bzip0032 method with the full data including header
-                    if (decompressor.DecompressBzip0032(data, decompressedData)) {
-                        logger_.Info("Successfully decompressed using specialized bzip0032 method!");
-                        return ParseBinaryData(decompressedData);
-                    }
+    // Parent indices were set while parsing frames; sorting parents first
+    // also fills in the child lists and makes world matrices one linear pass
+    std::vector<int> newIndex;
+    if (!meshData.SortBonesTopologically(newIndex)) {
+        AddBinaryParseWarning("Frame hierarchy has a parent cycle; bones left in file order");
+    }
 
-                    // Fallback to original method with payload only
-                    if (data.size() > 16) {
-                        std::vector<uint8_t> compressedPayload(data.begin() + 16, data.end());
-                        if (decompressor.DecompressDirectXBzip(compressedPayload, decompressedData)) {
-                            logger_.Info("Successfully decompressed using fallback DirectX bzip method!");
-                            return ParseBinaryData(decompressedData);
-                        }
+    std::vector<std::string> errors = meshData.GetValidationErrors();
+    for (const auto& error : errors) {
+        AddBinaryParseError(error);
+    }
+    if (!errors.empty()) {
+        return false;
+    }
 
-                        // If DirectX bzip fails, try DirectX LZ compression
-                        logger_.Info("DirectX bzip failed, trying DirectX LZ compression...");
-                        if (decompressor.DecompressDirectXLZ(compressedPayload, decompressedData)) {
-                            logger_.Info("Successfully decompressed using DirectX LZ method!");
-                            return ParseBinaryData(decompressedData);
-                        }
-                    }
-                }
-            } else if (formatStr == "tzip") {
-                logger_.Info("DirectX .x file with zip compression detected");
-
-                // Skip the DirectX header (16 bytes) to get to compressed data
-                if (data.size() > 16) {
-                    compressedData.assign(data.begin() + 16, data.end());
-
-                    if (decompressor.IsZipCompressed(compressedData)) {
-                        logger_.Info("Valid zip compressed data found after DirectX header");
-                        if (!decompressor.DecompressZipped(compressedData, decompressedData)) {
-                            logger_.Error("Failed to decompress zip data from DirectX .x file");
-                            return false;
-                        }
-                    } else {
-                        logger_.Error("Expected zip data not found after DirectX header");
-                        return false;
-                    }
-                } else {
-                    logger_.Error("File too small to contain compressed data after DirectX header");
-                    return false;
-                }
-            } else {
-                logger_.Error("Unsupported DirectX .x compression format: " + formatStr);
-                return false;
-            }
-        } else {
-            // Not a DirectX .x file, check for pure compression formats
-            if (decompressor.IsZipCompressed(data) || decompressor.IsBzip2Compressed(data) || decompressor.IsDirectXLZCompressed(data)) {
-                logger_.Info("Pure compression detected");
-
-                // Try to parse the compressed data as raw binary DirectX data
-                // Some DirectX .x files with "bzip" header use proprietary compression
-                if (data.size() > 16) {
-                    std::vector<uint8_t> rawData(data.begin() + 16, data.end());
-                    logger_.Info("Attempting to parse " + std::to_string(rawData.size()) + " bytes as raw DirectX binary data");
-
-                    // Try to parse it directly as binary data
-                    if (ParseBinaryData(rawData)) {
-                        logger_.Info("Successfully parsed as raw DirectX binary data");
-                        return true;
-                    }
+    parsedData_.parseSuccessful = true;
+    logger_.Info("Parsed binary .x: " + std::to_string(meshData.GetVertexCount()) + " vertices, " +
+                std::to_string(meshData.GetFaceCount()) + " faces, " +
+                std::to_string(meshData.GetBoneCount()) + " bones, " +
+                std::to_string(meshData.GetAnimationCount()) + " animations");
+    return true;
+}
 
-                    // If that fails, log more detailed analysis
-                    logger_.Warning("Could not parse as raw binary data either");
-                    logger_.Info("This file may require specialized DirectX compression handling");
-
-                    // Log some additional analysis
-                    if (rawData.size() >= 16) {
-                        std::string secondHexDump = "Next 16 bytes after header: ";
-                        for (size_t i = 0; i < 16; ++i) {
-                            char hex[4];
-                            sprintf(hex, "%02X ", rawData[i]);
-                            secondHexDump += hex;
-                        }
-                        logger_.Info(secondHexDump);
-                    }
+void BinaryXFileParser::AddBinaryParseError(const std::string& error) {
+    parsedData_.parseErrors.push_back(error);
+    logger_.Error("Binary parse error: " + error);
+}
 
-                    // Check if this might be zlib instead
-                    logger_.Info("Checking if data might be zlib compressed...");
-                    if (decompressor.IsZipCompressed(rawData)) {
-                        logger_.Info("Data appears to be zip/zlib compressed, attempting decompression...");
-                        if (decompressor.DecompressZipped(rawData, decompressedData)) {
-                            logger_.Info("Successfully decompressed as zip/zlib data");
-                            return ParseBinaryData(decompressedData);
-                        }
-                    }
+void BinaryXFileParser::AddBinaryParseWarning(const std::string& warning) {
+    parsedData_.parseWarnings.push_back(warning);
+    logger_.Warning("Binary parse warning: " + warning);
+}
 
-                    // Try raw deflate decompression (without zlib headers)
-                    logger_.Info("Attempting raw deflate decompression...");
-                    if (decompressor.DecompressRawDeflate(rawData, decompressedData)) {
-                        logger_.Info("Successfully decompressed using raw deflate!");
-                        return ParseBinaryData(decompressedData);
-                    } else {
-                        logger_.Warning("Raw deflate decompression also failed");
-                    }
+void BinaryXFileParser::ResetBinaryParser() {
+    reader_.reset();
+    parsedData_ = XFileData();
+    templates_.clear();
+    listToken_ = 0;
+    listRemaining_ = 0;
+    floatSize_ = 32;
+    decoder_ = BinaryValueDecoder::For(true, 32);
+    materialLibrary_.clear();
+    fileTicksPerSecond_ = 0.0f;
+    pendingSkinWeights_.clear();
+}
 
-                    // Last resort: try to parse as text format
-                    logger_.Info("Attempting to parse as text format...");
-                    std::string textData(rawData.begin(), rawData.end());
-                    if (textData.find("template") != std::string::npos ||
-                        textData.find("Mesh") != std::string::npos ||
-                        textData.find("{") != std::string::npos) {
-                        logger_.Info("Data appears to contain text-like DirectX content");
-                        logger_.Info("Attempting to parse with text parser...");
-
-                        // Try parsing with the text parser
-                        XFileParser tempTextParser;
-                        if (tempTextParser.ParseFromString(textData)) {
-                            logger_.Info("Successfully parsed as text format!");
-                            parsedData_ = tempTextParser.TakeParsedData();
-                            return true;
-                        } else {
-                            logger_.Warning("Text parser also failed - data might be corrupted or unknown format");
-                        }
-                    }
-                }
+bool BinaryXFileParser::ParseCompressedFile(const std::string& filepath) {
+    logger_.Info("Attempting to parse compressed .x file: " + filepath);
 
-                logger_.Error("Could not process DirectX .x file with bzip header");
-                logger_.Error("This may be a proprietary or unsupported compression variant");
-                return false;
-            } else {
-                logger_.Error("Unknown or unsupported .x file format");
-                return false;
-            }
-        }
-    } else {
-        logger_.Error("File too small to determine compression format");
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        logger_.Error("Failed to open file: " + filepath);
         return false;
     }
+    ConversionMetrics::GetInstance().AddBytesRead(file.GetSize());
 
-    logger_.Info("Successfully decompressed data, size: " + std::to_string(decompressedData.size()) + " bytes");
+    return ParseCompressedData(file.View());
+}
 
-    // Better analysis of decompressed content before trying to parse it as X-file
-    std::string start(reinterpret_cast<const char*>(decompressedData.data()),
-                     std::min<size_t>(32, decompressedData.size()));
-    logger_.Info("Decompressed data starts with: '" + start + "'");
+bool BinaryXFileParser::ParseCompressedData(ByteView data) {
+    return ParseCompressedData(data, ProbeXFileData(data).header);
+}
 
-    // Log more detailed information about the decompressed content
-    std::string hexStart;
-    for (size_t i = 0; i < std::min<size_t>(32, decompressedData.size()); ++i) {
-        char hex[3];
-        sprintf(hex, "%02X", decompressedData[i]);
-        hexStart += hex;
-        if (i < 31) hexStart += " ";
-    }
-    logger_.Info("Decompressed content (first 32 bytes hex): " + hexStart);
+bool BinaryXFileParser::ParseCompressedData(ByteView data, const XFileHeader& header) {
+    XFileDecompressor decompressor;
+    decompressor.SetLimits(decompressionLimits_);
+    decompressionDeadline_ = decompressionLimits_.DeadlineFrom(std::chrono::steady_clock::now());
+
+    // After the parse, which starts from fresh data
+    bool success = ParseCompressedPayload(data, header, decompressor);
+    parsedData_.statistics.decompressionMethod = decompressor.GetMethod();
+    parsedData_.statistics.decompressionAttempts = decompressor.GetAttempts();
+    return success;
+}
 
-    // Try to find valid X-file signatures within the decompressed data
-    bool foundXofSignature = false;
-    size_t xofOffset = 0;
+bool BinaryXFileParser::ParseCompressedPayload(ByteView data, const XFileHeader& header,
+                                               XFileDecompressor& decompressor) {
+    if (data.size() < XFILE_PROBE_BYTES) {
+        logger_.Error("File too small to determine compression format");
+        return false;
+    }
 
-    // Search for "xof " signature in the decompressed data
-    for (size_t i = 0; i <= decompressedData.size() - 4; ++i) {
-        if (decompressedData[i] == 'x' && decompressedData[i+1] == 'o' &&
-            decompressedData[i+2] == 'f' && decompressedData[i+3] == ' ') {
-            foundXofSignature = true;
-            xofOffset = i;
-            logger_.Info("Found 'xof ' signature at offset " + std::to_string(i) + " in decompressed data");
+    // A whole .x file inside a generic container; the payload carries its own header
+    switch (header.compression) {
+        case XFileHeader::BZIP2:
+            return ParseDecompressedStream(decompressor.OpenBzip2Stream(data), 32, false);
+        case XFileHeader::ZIP:
+            return ParseDecompressedStream(decompressor.OpenZipStream(data), 32, false);
+        case XFileHeader::DIRECTX_LZ: {
+            std::vector<uint8_t> decompressedData;
+            if (!decompressor.DecompressDirectXLZ(data, decompressedData)) {
+                return false;
+            }
+            LimitedByteSource source(std::make_unique<MemoryByteSource>(decompressedData), 0, decompressionDeadline_);
+            return ParseBinaryStream(source, 32, false);
+        }
+        case XFileHeader::MSZIP:
             break;
+        default:
+            if (data.StartsWith("xof ")) {
+                logger_.Error("Unsupported DirectX .x compression format: " +
+                              std::string(data.AsStringView().substr(8, 4)));
+            } else {
+                logger_.Error("Unknown or unsupported compressed .x file format");
+            }
+            return false;
+    }
+
+    // "tzip" holds text and "bzip" binary tokens, both MSZIP-compressed
+    uint32_t floatSize = static_cast<uint32_t>(header.floatSize);
+    ByteView payload = data.Subview(XFILE_PROBE_BYTES);
+
+    if (decompressionWorkers_ > 1) {
+        // The early check inflates only the first block, so a payload that
+        // is not .x data is dropped before the parallel decode
+        if (decompressionLimits_.checkBytes > 0) {
+            XFileDecompressor prober;   // Not an attempt of its own
+            prober.SetLimits(decompressionLimits_);
+            std::unique_ptr<ByteSource> probe = LimitPayload(prober.OpenMszipStream(payload), floatSize,
+                                                             header.textPayload);
+            uint8_t first = 0;
+            if (probe && probe->Read(&first, 1) == 0 && probe->HasError()) {
+                AddBinaryParseError("MSZIP payload rejected: " + probe->GetError());
+                return false;
+            }
+        }
+
+        // Trades the bounded window for decoding blocks on several threads
+        std::vector<uint8_t> decompressedData;
+        if (!decompressor.DecompressMszip(payload, decompressedData, decompressionWorkers_)) {
+            return false;
         }
+        LimitedByteSource source(std::make_unique<MemoryByteSource>(decompressedData), 0, decompressionDeadline_);
+        return ParseBinaryStream(source, floatSize, header.textPayload);
     }
 
-    if (foundXofSignature && xofOffset > 0) {
-        // Extract the X-file content starting from the xof signature
-        std::vector<uint8_t> xfileContent(decompressedData.begin() + xofOffset, decompressedData.end());
-        logger_.Info("Extracting X-file content from offset " + std::to_string(xofOffset) +
-                   ", new size: " + std::to_string(xfileContent.size()) + " bytes");
+    return ParseDecompressedStream(decompressor.OpenMszipStream(payload), floatSize, header.textPayload);
+}
 
-        std::string xfileStart(reinterpret_cast<const char*>(xfileContent.data()),
-                             std::min<size_t>(64, xfileContent.size()));
-        logger_.Info("X-file content starts with: '" + xfileStart + "'");
+bool BinaryXFileParser::IsBinaryXFile(const std::string& filepath) {
+    return ProbeXFile(filepath).header.format == XFileHeader::BINARY;
+}
 
-        return ParseBinaryData(xfileContent);
-    }
+bool BinaryXFileParser::IsCompressedXFile(const std::string& filepath) {
+    return ProbeXFile(filepath).header.format == XFileHeader::COMPRESSED;
+}
 
-    // If no xof signature found, try to interpret as binary X-file
-    if (!foundXofSignature) {
-        logger_.Info("No 'xof ' signature found, checking for binary X-file format...");
+// =============================================================================
+// Input probing
+// =============================================================================
 
-        // Check for binary X-file header patterns
-        if (decompressedData.size() >= 16) {
-            // Try different interpretations of the binary data
-            // Method 1: Try skipping potential metadata at the beginning
-            for (size_t skip = 0; skip < std::min<size_t>(256, decompressedData.size() - 16); skip += 4) {
-                std::vector<uint8_t> skippedData(decompressedData.begin() + skip, decompressedData.end());
+XFileProbe ProbeXFileData(ByteView data) {
+    XFileProbe probe;
+    probe.readable = true;
+    XFileHeader& header = probe.header;
 
-                // Check if this looks like X-file content
-                if (skippedData.size() >= 4) {
-                    std::string testStart(reinterpret_cast<const char*>(skippedData.data()),
-                                        std::min<size_t>(16, skippedData.size()));
+    if (XFileSnapshot::IsSnapshot(data)) {
+        probe.recognized = true;
+        probe.snapshot = true;
+        return probe;
+    }
+    if (data.size() < XFILE_PROBE_BYTES) {
+        return probe;   // Too short for any header; parsed as text
+    }
 
-                    if (testStart.find("xof") == 0 || testStart.find("template") != std::string::npos) {
-                        logger_.Info("Found potential X-file content at offset " + std::to_string(skip));
-                        logger_.Info("Content: '" + testStart + "'");
-                        return ParseBinaryData(skippedData);
-                    }
-                }
-            }
+    if (!data.StartsWith("xof ")) {
+        // Without a .x signature, only generic compression containers are known
+        if (XFileDecompressor::IsZipCompressed(data)) {
+            header.compression = XFileHeader::ZIP;
+        } else if (XFileDecompressor::IsBzip2Compressed(data)) {
+            header.compression = XFileHeader::BZIP2;
+        } else if (XFileDecompressor::IsDirectXLZCompressed(data)) {
+            header.compression = XFileHeader::DIRECTX_LZ;
+        } else {
+            return probe;
         }
+        header.format = XFileHeader::COMPRESSED;
+        probe.recognized = true;
+        return probe;
+    }
+    probe.recognized = true;
+
+    // "xof 0303txt 0032": version, format and float size
+    std::string_view text = data.AsStringView();
+    auto digits = [&](size_t offset) {
+        char high = text[offset];
+        char low = text[offset + 1];
+        if (high < '0' || high > '9' || low < '0' || low > '9') return -1;
+        return (high - '0') * 10 + (low - '0');
+    };
+    if (digits(4) >= 0 && digits(6) >= 0) {
+        header.majorVersion = digits(4);
+        header.minorVersion = digits(6);
+    }
+
+    std::string_view format = text.substr(8, 4);
+    if (format == "bin ") {
+        header.format = XFileHeader::BINARY;
+    } else if (format == "tzip" || format == "bzip") {
+        header.format = XFileHeader::COMPRESSED;
+        header.compression = XFileHeader::MSZIP;
+        header.textPayload = format == "tzip";
+    }
+    // Anything else, "txt " included, is parsed as text
+
+    header.floatSize = text.substr(12, 4) == "0064" ? 64 : 32;
+    return probe;
+}
 
-        // Method 2: Try to save decompressed data to file for manual inspection
-        logger_.Info("Saving decompressed data to 'decompressed_debug.bin' for analysis");
-        std::ofstream debugFile("decompressed_debug.bin", std::ios::binary);
-        if (debugFile.is_open()) {
-            debugFile.write(reinterpret_cast<const char*>(decompressedData.data()), decompressedData.size());
-            debugFile.close();
-            logger_.Info("Decompressed data saved to decompressed_debug.bin");
-        }
+XFileProbe ProbeXFile(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return XFileProbe();
     }
 
-    return ParseBinaryData(decompressedData);
+    uint8_t prefix[XFILE_PROBE_BYTES];
+    file.read(reinterpret_cast<char*>(prefix), static_cast<std::streamsize>(sizeof(prefix)));
+    return ProbeXFileData(ByteView(prefix, static_cast<size_t>(file.gcount())));
 }
 
 // =============================================================================
@@ -1421,73 +2576,71 @@ EnhancedXFileParser::EnhancedXFileParser()
     : logger_(Logger::GetInstance()),
       textParser_(),
       binaryParser_(),
-      decompressor_() {
+      decompressor_(),
+      usedTextParser_(true),
+      usedSnapshot_(false),
+      lazyAnimations_(false) {
 }
 
 EnhancedXFileParser::~EnhancedXFileParser() = default;
 
 bool EnhancedXFileParser::ParseFile(const std::string& filepath) {
+    return ParseFile(filepath, XFileProbe());
+}
+
+bool EnhancedXFileParser::ParseFile(const std::string& filepath, const XFileProbe& probe) {
     logger_.Info("Parsing .x file with enhanced parser: " + filepath);
 
-    // Detect file format
-    auto format = DetectFileFormat(filepath);
+    // Map the file once; parsing and decompression all read these bytes.
+    // Lazily indexed animation sets are decoded from the same mapping.
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        logger_.Error("Failed to open file: " + filepath);
+        return false;
+    }
+    ConversionMetrics::GetInstance().AddBytesRead(file.GetSize());
+    input_.Close();
 
-    switch (format) {
-        case XFileHeader::TEXT:
-            return ParseTextFormat(filepath);
-        case XFileHeader::BINARY:
-            return ParseBinaryFormat(filepath);
-        case XFileHeader::COMPRESSED:
-            return ParseCompressedFormat(filepath);
-        default:
-            logger_.Error("Unknown or unsupported .x file format");
-            return false;
+    // An unread probe means the caller has not looked at the header yet
+    ByteView data = file.View();
+    XFileProbe detected = probe.readable ? probe : ProbeXFileData(data);
+    bool success = ParseProbedData(data, detected);
+
+    // Compressed inputs are streamed and decode selected sets up front
+    if (success && lazyAnimations_ && !detected.snapshot && detected.header.format != XFileHeader::COMPRESSED) {
+        input_ = std::move(file);
     }
+    return success;
 }
 
-bool EnhancedXFileParser::ParseFromData(const std::vector<uint8_t>& data) {
-    auto format = DetectDataFormat(data);
+bool EnhancedXFileParser::ParseFromData(ByteView data) {
+    return ParseProbedData(data, ProbeXFileData(data));
+}
 
-    switch (format) {
-        case XFileHeader::TEXT: {
-            // Convert to string and parse
-            std::string textData(data.begin(), data.end());
-            return textParser_.ParseFromString(textData);
-        }
+bool EnhancedXFileParser::ParseProbedData(ByteView data, const XFileProbe& probe) {
+    if (probe.snapshot) {
+        return LoadSnapshot(data);
+    }
+    usedSnapshot_ = false;
+
+    switch (probe.header.format) {
+        case XFileHeader::TEXT:
+            return ParseTextFormat(data);
         case XFileHeader::BINARY:
-            return binaryParser_.ParseBinaryData(data);
-        case XFileHeader::COMPRESSED: {
-            std::vector<uint8_t> decompressedData;
-            if (decompressor_.IsZipCompressed(data)) {
-                if (!decompressor_.DecompressZipped(data, decompressedData)) {
-                    logger_.Error("Failed to decompress ZIP data");
-                    return false;
-                }
-            } else if (decompressor_.IsBzip2Compressed(data)) {
-                if (!decompressor_.DecompressBzip2(data, decompressedData)) {
-                    logger_.Error("Failed to decompress BZIP2 data");
-                    return false;
-                }
-            } else if (decompressor_.IsDirectXLZCompressed(data)) {
-                if (!decompressor_.DecompressDirectXLZ(data, decompressedData)) {
-                    logger_.Error("Failed to decompress DirectX LZ data");
-                    return false;
-                }
-            } else {
-                logger_.Error("Unknown compression format - not DirectX .x or recognizable compression");
-                return false;
-            }
-            return ParseFromData(decompressedData);
-        }
+            return ParseBinaryFormat(data);
+        case XFileHeader::COMPRESSED:
+            return ParseCompressedFormat(data, probe.header);
         default:
-            logger_.Error("Unknown data format");
+            logger_.Error("Unknown or unsupported .x file format");
             return false;
     }
 }
 
 const XFileData& EnhancedXFileParser::GetParsedData() const {
     // Return data from whichever parser was used
-    if (!textParser_.GetParsedData().meshes.empty()) {
+    if (usedSnapshot_) {
+        return snapshotData_;
+    } else if (usedTextParser_) {
         return textParser_.GetParsedData();
     } else {
         return binaryParser_.GetParsedData();
@@ -1496,55 +2649,31 @@ const XFileData& EnhancedXFileParser::GetParsedData() const {
 
 XFileData EnhancedXFileParser::TakeParsedData() {
     // Take data from whichever parser was used
-    if (!textParser_.GetParsedData().meshes.empty()) {
-        return textParser_.TakeParsedData();
+    XFileData data;
+    if (usedSnapshot_) {
+        data = std::move(snapshotData_);
+    } else if (usedTextParser_) {
+        data = textParser_.TakeParsedData();
     } else {
-        return binaryParser_.TakeParsedData();
+        data = binaryParser_.TakeParsedData();
     }
+    input_.Close();
+    return data;
 }
 
-XFileHeader::Format EnhancedXFileParser::DetectFileFormat(const std::string& filepath) {
-    std::vector<uint8_t> data = ReadFileToBytes(filepath);
-    if (data.empty()) {
-        return XFileHeader::TEXT;
+bool EnhancedXFileParser::DecodeAnimations(const std::vector<std::string>& names) {
+    if (usedSnapshot_) {
+        return true;   // Snapshots hold decoded animations only
     }
-
-    return DetectDataFormat(data);
+    return usedTextParser_ ? textParser_.DecodeAnimations(names) : binaryParser_.DecodeAnimations(names);
 }
 
-XFileHeader::Format EnhancedXFileParser::DetectDataFormat(const std::vector<uint8_t>& data) {
-    if (data.size() < 16) {
-        return XFileHeader::TEXT;
-    }
-
-    // Check .x file signature first
-    if (data.size() >= 4) {
-        std::string signature(data.begin(), data.begin() + 4);
-        if (signature != "xof ") {
-            // If no .x signature, check for pure compression formats
-            if (decompressor_.IsZipCompressed(data) || decompressor_.IsBzip2Compressed(data) || decompressor_.IsDirectXLZCompressed(data)) {
-                return XFileHeader::COMPRESSED;
-            }
-            return XFileHeader::TEXT;
-        }
-    }
-
-    // Check for format indicators in .x file header (positions 8-12)
-    if (data.size() >= 16) {
-        std::string header(data.begin(), data.begin() + 16);
-        std::string formatStr = header.substr(8, 4);
-
-        if (formatStr == "txt ") {
-            return XFileHeader::TEXT;
-        } else if (formatStr == "bin ") {
-            return XFileHeader::BINARY;
-        } else if (formatStr == "tzip" || formatStr == "bzip" || formatStr == "lz") {
-            return XFileHeader::COMPRESSED;
-        }
-    }
+XFileHeader::Format EnhancedXFileParser::DetectFileFormat(const std::string& filepath) {
+    return ProbeXFile(filepath).header.format;
+}
 
-    // Default to text if we can't determine
-    return XFileHeader::TEXT;
+XFileHeader::Format EnhancedXFileParser::DetectDataFormat(ByteView data) {
+    return ProbeXFileData(data).header.format;
 }
 
 void EnhancedXFileParser::SetStrictMode(bool strict) {
@@ -1557,43 +2686,61 @@ void EnhancedXFileParser::SetVerboseLogging(bool verbose) {
     // binaryParser_ would also support this if implemented
 }
 
-bool EnhancedXFileParser::ParseTextFormat(const std::string& filepath) {
-    return textParser_.ParseFile(filepath);
+void EnhancedXFileParser::SetStreamingOptions(size_t windowBytes, bool backgroundDecompression) {
+    binaryParser_.SetStreamingOptions(windowBytes, backgroundDecompression);
 }
 
-bool EnhancedXFileParser::ParseBinaryFormat(const std::string& filepath) {
-    logger_.Warning("Binary .x format not fully supported yet, falling back to text parser");
-    return textParser_.ParseFile(filepath);
+void EnhancedXFileParser::SetDecompressionWorkers(size_t workers) {
+    binaryParser_.SetDecompressionWorkers(workers);
 }
 
-bool EnhancedXFileParser::ParseCompressedFormat(const std::string& filepath) {
-    return binaryParser_.ParseCompressedFile(filepath);
+void EnhancedXFileParser::SetDecompressionLimits(const DecompressionLimits& limits) {
+    binaryParser_.SetDecompressionLimits(limits);
 }
 
-std::vector<uint8_t> EnhancedXFileParser::ReadFileToBytes(const std::string& filepath) {
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file.is_open()) {
-        logger_.Error("Failed to open file: " + filepath);
-        return {};
-    }
+void EnhancedXFileParser::SetAnimationFilter(const std::vector<std::string>& names) {
+    textParser_.SetAnimationFilter(names);
+    binaryParser_.SetAnimationFilter(names);
+}
+
+void EnhancedXFileParser::SetParseThreads(size_t threads) {
+    textParser_.SetParseThreads(threads);
+}
 
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
+void EnhancedXFileParser::SetLazyAnimations(bool lazy) {
+    lazyAnimations_ = lazy;
+    textParser_.SetLazyAnimations(lazy);
+    binaryParser_.SetLazyAnimations(lazy);
+}
 
-    std::vector<uint8_t> data(fileSize);
-    file.read(reinterpret_cast<char*>(data.data()), fileSize);
+bool EnhancedXFileParser::ParseTextFormat(ByteView data) {
+    usedTextParser_ = true;
+    return textParser_.ParseFromString(data.AsStringView());
+}
 
-    return data;
+bool EnhancedXFileParser::ParseBinaryFormat(ByteView data) {
+    usedTextParser_ = false;
+    return binaryParser_.ParseBinaryData(data);
 }
 
-bool EnhancedXFileParser::ValidateFileSignature(const std::vector<uint8_t>& data) {
-    if (data.size() < 4) {
+bool EnhancedXFileParser::ParseCompressedFormat(ByteView data, const XFileHeader& header) {
+    usedTextParser_ = false;
+    return binaryParser_.ParseCompressedData(data, header);
+}
+
+bool EnhancedXFileParser::LoadSnapshot(ByteView data) {
+    usedSnapshot_ = true;
+    XFileSnapshotView snapshot;
+    if (!snapshot.Open(data) || !snapshot.Load(snapshotData_)) {
+        logger_.Error("Invalid snapshot: " + snapshot.GetError());
         return false;
     }
+    logger_.Info("Loaded parsed data from snapshot (" + std::to_string(data.size()) + " bytes)");
+    return true;
+}
 
-    std::string signature(data.begin(), data.begin() + 4);
-    return signature == "xof ";
+bool EnhancedXFileParser::ValidateFileSignature(ByteView data) {
+    return data.StartsWith("xof ");
 }
 
 } // namespace X2FBX
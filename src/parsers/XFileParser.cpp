@@ -1,8 +1,12 @@
 #include "XFileParser.h"
-#include <sstream>
+#include "ConversionMetrics.h"
+#include "XFileTokenizer.h"
+#include "ParallelUtils.h"
 #include <algorithm>
+#include <chrono>
 #include <cctype>
 #include <iomanip>
+#include <memory>
 
 namespace X2FBX {
 
@@ -26,15 +30,23 @@ XFileParser::XFileParser()
     : logger_(Logger::GetInstance())
     , lineNumber_(0)
     , currentState_(ParseState::HEADER)
+    , arena_()
+    , dataObjects_(arena_.Resource())
     , strictMode_(false)
-    , verboseLogging_(false) {
+    , verboseLogging_(false)
+    , lazyAnimations_(false)
+    , parseThreads_(0)
+    , partialParse_(false)
+    , sourceOffset_(0)
+    , animationIndexBase_(0)
+    , boneFields_(arena_.Resource())
+    , materialLibrary_(arena_.Resource())
+    , pendingSkinWeights_(arena_.Resource())
+    , templates_(arena_.Resource())
+    , fileTicksPerSecond_(0.0f) {
 }
 
-XFileParser::~XFileParser() {
-    if (fileStream_ && fileStream_->is_open()) {
-        fileStream_->close();
-    }
-}
+XFileParser::~XFileParser() = default;
 
 bool XFileParser::ParseFile(const std::string& filepath) {
     TIME_OPERATION("XFileParser::ParseFile");
@@ -44,33 +56,88 @@ bool XFileParser::ParseFile(const std::string& filepath) {
     // Reset parser state
     ResetParserState();
 
-    // Validate file existence and format
-    if (!IsValidXFile(filepath)) {
-        AddParseError("Invalid or non-existent .x file: " + filepath);
+    // Map the file; the text is parsed in place instead of being copied into a string
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        AddParseError("Failed to open file: " + filepath);
         return false;
     }
+    ConversionMetrics::GetInstance().AddBytesRead(file.GetSize());
 
-    // Open file
-    fileStream_ = std::make_unique<std::ifstream>(filepath, std::ios::binary);
-    if (!fileStream_->is_open()) {
-        AddParseError("Failed to open file: " + filepath);
+    if (!file.View().StartsWith("xof ")) {
+        AddParseError("Invalid or non-existent .x file: " + filepath);
         return false;
     }
 
-    // Read entire file content
-    std::stringstream buffer;
-    buffer << fileStream_->rdbuf();
-    std::string content = buffer.str();
-    fileStream_->close();
-
-    LOG_INFO("File loaded, size: " + std::to_string(content.size()) + " bytes");
+    LOG_INFO("File loaded, size: " + std::to_string(file.GetSize()) + " bytes" +
+             (file.IsMapped() ? " (memory mapped)" : ""));
 
-    return ParseFromString(content);
+    bool success = ParseFromString(file.View().AsStringView());
+    animationSource_ = std::string_view();   // The mapping closes here
+    return success;
 }
 
-bool XFileParser::ParseFromString(const std::string& content) {
+bool XFileParser::ParseFromString(std::string_view content) {
     TIME_OPERATION("XFileParser::ParseFromString");
+    timer.AddBytes(content.size());
+
+    // Parse errors from ParseFile (if any) have already returned, so a reset
+    // here only drops results of a previous parse on this instance
+    ResetParserState();
+    animationSource_ = lazyAnimations_ ? content : std::string_view();
+
+    auto startTime = std::chrono::steady_clock::now();
+    bool success = ParseContent(content);
+
+    parsedData_.statistics.inputBytes = content.size();
+    parsedData_.statistics.arenaPeakBytes = arena_.GetPeakBytes();
+    parsedData_.statistics.parseMilliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    return success;
+}
+
+XFileData XFileParser::TakeParsedData() {
+    XFileData data = std::move(parsedData_);
+    parsedData_ = XFileData();
+    animationSource_ = std::string_view();
+    ReleaseParseArena();
+    return data;
+}
+
+bool XFileParser::DecodeAnimations(const std::vector<std::string>& names) {
+    TIME_OPERATION("DecodeAnimations");
+
+    XMeshData& meshData = parsedData_.meshData;
+    for (auto& info : parsedData_.animationSets) {
+        if (info.decoded || !XFileUtils::MatchesAnimationFilter(names, info.name)) {
+            continue;
+        }
+        if (animationSource_.size() < info.offset || animationSource_.size() - info.offset < info.length) {
+            AddParseError("AnimationSet '" + info.name + "' was not kept for lazy decoding");
+            return false;
+        }
+
+        XFileTokenizer tokenizer(animationSource_.substr(info.offset, info.length));
+        XAnimationSet animSet;
+        animSet.name = info.name;
+        if (!ParseAnimationSetBody(tokenizer, animSet)) {
+            return false;
+        }
+        timer.AddBytes(info.length);
+
+        info.decoded = true;
+        if (!animSet.tracks.empty()) {
+            if (animSet.ticksPerSecond <= 0) {
+                animSet.ticksPerSecond = meshData.globalTicksPerSecond;
+            }
+            meshData.animations.push_back(std::move(animSet));
+        }
+    }
+    return true;
+}
 
+bool XFileParser::ParseContent(std::string_view content) {
     if (content.empty()) {
         AddParseError("Empty file content");
         return false;
@@ -124,7 +191,8 @@ bool XFileParser::ParseFromString(const std::string& content) {
         LOG_INFO("Parsed: " + std::to_string(parsedData_.meshData.GetVertexCount()) + " vertices, " +
                 std::to_string(parsedData_.meshData.GetFaceCount()) + " faces, " +
                 std::to_string(parsedData_.meshData.GetBoneCount()) + " bones, " +
-                std::to_string(parsedData_.meshData.GetAnimationCount()) + " animations");
+                std::to_string(parsedData_.meshData.GetAnimationCount()) + " animations, " +
+                std::to_string(arena_.GetPeakBytes() / 1024) + " KB parse arena");
 
         return true;
 
@@ -134,7 +202,7 @@ bool XFileParser::ParseFromString(const std::string& content) {
     }
 }
 
-bool XFileParser::ParseHeader(const std::string& content) {
+bool XFileParser::ParseHeader(std::string_view content) {
     if (content.size() < 16) {
         return false;
     }
@@ -144,15 +212,18 @@ bool XFileParser::ParseHeader(const std::string& content) {
         return false;
     }
 
-    // Parse version (4 bytes)
-    std::string versionStr = content.substr(4, 4);
-    if (versionStr.size() >= 4) {
-        parsedData_.header.majorVersion = versionStr[0] - '0';
-        parsedData_.header.minorVersion = versionStr[2] - '0';
+    // Parse version (4 bytes, "0303" = major 03, minor 03)
+    std::string_view versionStr = content.substr(4, 4);
+    int majorVersion = 0;
+    int minorVersion = 0;
+    if (XFileTokenizer::ParseInt(versionStr.substr(0, 2), majorVersion) &&
+        XFileTokenizer::ParseInt(versionStr.substr(2, 2), minorVersion)) {
+        parsedData_.header.majorVersion = majorVersion;
+        parsedData_.header.minorVersion = minorVersion;
     }
 
     // Parse format (4 bytes) - should be "txt " for text format
-    std::string formatStr = content.substr(8, 4);
+    std::string formatStr(content.substr(8, 4));
     if (formatStr == "txt ") {
         parsedData_.header.format = XFileHeader::Format::TEXT;
     } else if (formatStr == "bin ") {
@@ -165,9 +236,9 @@ bool XFileParser::ParseHeader(const std::string& content) {
     }
 
     // Parse float size (4 bytes) - should be "0032" for 32-bit floats
-    std::string floatSize = content.substr(12, 4);
+    std::string_view floatSize = content.substr(12, 4);
     if (floatSize != "0032") {
-        LOG_WARNING("Non-standard float size: " + floatSize);
+        LOG_WARNING("Non-standard float size: " + std::string(floatSize));
     }
 
     LOG_INFO("Parsed header - Version: " + std::to_string(parsedData_.header.majorVersion) +
@@ -177,426 +248,1164 @@ bool XFileParser::ParseHeader(const std::string& content) {
     return true;
 }
 
-bool XFileParser::ParseTextFormat(const std::string& content) {
-    TIME_OPERATION("ParseTextFormat");
+namespace {
 
-    // Preprocess content - remove comments and normalize whitespace
-    std::string cleanContent = XFileUtils::PreprocessTextContent(content);
+// "xof 0303txt 0032"; object offsets inside the tokenizer are relative to its end
+constexpr size_t TEXT_HEADER_SIZE = 16;
 
-    // Skip header (first 16 bytes)
-    std::string dataContent = cleanContent.substr(16);
+// Which fields of a bone a Frame object set (see MergePartialParse)
+constexpr uint8_t BONE_HAS_PARENT = 1;
+constexpr uint8_t BONE_HAS_TRANSFORM = 2;
 
-    // Create string stream for parsing
-    std::stringstream stream(dataContent);
+// Starts the placeholder name of an unnamed frame in a partial parse; no
+// identifier can contain it
+constexpr char GENERATED_NAME_MARKER = '\x01';
 
-    // Parse template definitions first
-    if (!ParseTemplateDefinitions(dataContent)) {
-        LOG_WARNING("Template parsing failed, continuing with standard templates");
+// Append a per-vertex stream of a merged mesh, keeping streams that only
+// one side has aligned with the positions
+template <typename T>
+void AppendVertexStream(std::vector<T>& target, const std::vector<T>& source, size_t baseVertex, size_t addedVertices) {
+    if (target.empty() && source.empty()) {
+        return;
     }
+    target.resize(baseVertex);
+    if (source.empty()) {
+        target.resize(baseVertex + addedVertices);
+    } else {
+        target.insert(target.end(), source.begin(), source.end());
+    }
+}
 
-    // Parse data objects
-    return ParseDataObjects(dataContent);
+// Body of an AnimTicksPerSecond object; the '{' has already been consumed
+bool ReadTicksPerSecondBody(XFileTokenizer& tokenizer, float& ticksPerSecond) {
+    float ticks = 0.0f;
+    if (!tokenizer.ReadFloat(ticks) || ticks <= 0.0f) {
+        return false;
+    }
+    ticksPerSecond = ticks;
+    return true;
 }
 
-bool XFileParser::ParseBinaryFormat(const std::string& content) {
+} // namespace
+
+bool XFileParser::ParseTextFormat(std::string_view content) {
+    TIME_OPERATION("ParseTextFormat");
+
+    // Skip header (first 16 bytes); the tokenizer handles comments inline.
+    // Templates and AnimTicksPerSecond are picked up by the same pass.
+    std::string_view dataContent = content.substr(TEXT_HEADER_SIZE);
+
+    XFileTokenizer tokenizer(dataContent);
+    sourceOffset_ = TEXT_HEADER_SIZE;
+
+    // Splitting only pays off for large inputs with cores to spare
+    size_t threads = dataContent.size() >= PARALLEL_PARSE_MIN_BYTES
+        ? ParallelUtils::ResolveThreadCount(parseThreads_, static_cast<size_t>(-1))
+        : 1;
+    bool success = threads > 1 ? ParseDataObjectsParallel(tokenizer, threads) : ParseDataObjects(tokenizer);
+    lineNumber_ = tokenizer.GetLine();
+
+    if (success) {
+        ResolveSkinWeights();
+    }
+    return success;
+}
+
+bool XFileParser::ParseBinaryFormat(std::string_view content) {
     (void)content;  // Suppress unused parameter warning
     AddParseError("Binary format parsing not implemented in XFileParser, use BinaryXFileParser");
     return false;
 }
 
-bool XFileParser::ParseTemplateDefinitions(const std::string& content) {
-    // Simple template parsing - look for template definitions
-    std::regex templateRegex(R"(template\s+(\w+)\s*\{[^}]*\})");
-    std::sregex_iterator iter(content.begin(), content.end(), templateRegex);
-    std::sregex_iterator end;
-
-    for (; iter != end; ++iter) {
-        std::string templateName = (*iter)[1].str();
-        templates_[templateName] = (*iter).str();
-        LOG_DEBUG("Found template: " + templateName);
+bool XFileParser::ParseTemplateObject(XFileTokenizer& tokenizer, const XToken& keyword, std::string_view name) {
+    size_t start = tokenizer.OffsetOf(keyword);
+    if (!tokenizer.SkipBlock()) {
+        AddParseError("Unterminated template: " + std::string(name));
+        return false;
     }
 
+    std::string_view templateName = arena_.CopyString(name);
+    templates_[templateName] = arena_.CopyString(tokenizer.Slice(start, tokenizer.GetOffset()));
+    LOG_DEBUG("Found template: " + std::string(templateName));
     return true;
 }
 
-bool XFileParser::ParseDataObjects(const std::string& content) {
+bool XFileParser::ReadObjectHeader(XFileTokenizer& tokenizer, std::string_view& name) {
+    name = std::string_view();
+    if (tokenizer.Peek().Is(XTokenType::IDENTIFIER)) {
+        name = tokenizer.Next().text;
+    }
+    tokenizer.Accept(XTokenType::GUID);
+    return tokenizer.Accept(XTokenType::OPEN_BRACE);
+}
+
+bool XFileParser::ParseDataObjects(XFileTokenizer& tokenizer) {
     TIME_OPERATION("ParseDataObjects");
 
-    // Create a stream for parsing
-    std::stringstream stream(content);
-    std::string line;
-    lineNumber_ = 0;
+    while (true) {
+        XToken token = tokenizer.Next();
+
+        if (token.Is(XTokenType::END)) {
+            break;
+        }
 
-    while (std::getline(stream, line)) {
-        lineNumber_++;
-        line = TrimWhitespace(line);
+        if (token.Is(XTokenType::SEPARATOR)) {
+            continue;
+        }
 
-        if (line.empty() || line[0] == '/' || line.substr(0, 8) == "template") {
-            continue; // Skip empty lines, comments, and templates
+        if (token.Is(XTokenType::OPEN_BRACE)) {
+            // Top-level data reference - nothing to instantiate
+            tokenizer.SkipBlock();
+            continue;
         }
 
-        // Check for data object start
-        if (line.find('{') != std::string::npos) {
-            std::string objectType = line.substr(0, line.find_first_of(" \t{"));
-            objectType = TrimWhitespace(objectType);
+        if (!token.Is(XTokenType::IDENTIFIER)) {
+            lineNumber_ = token.line;
+            AddParseWarning("Unexpected token '" + std::string(token.text) + "' at top level");
+            continue;
+        }
 
-            if (objectType == "Mesh") {
-                if (!ParseMeshObject(stream)) {
-                    LOG_ERROR("Failed to parse Mesh object at line " + std::to_string(lineNumber_));
-                    return false;
-                }
-            } else if (objectType == "Frame") {
-                if (!ParseFrameObject(stream)) {
-                    LOG_ERROR("Failed to parse Frame object at line " + std::to_string(lineNumber_));
-                    return false;
-                }
-            } else if (objectType == "AnimationSet") {
-                if (!ParseAnimationSetObject(stream)) {
-                    LOG_ERROR("Failed to parse AnimationSet object at line " + std::to_string(lineNumber_));
-                    return false;
-                }
-            } else if (objectType == "Material") {
-                if (!ParseMaterialObject(stream)) {
-                    LOG_ERROR("Failed to parse Material object at line " + std::to_string(lineNumber_));
-                    return false;
-                }
-            } else {
-                LOG_DEBUG("Skipping unknown object type: " + objectType);
-                SkipToClosingBrace(stream);
+        lineNumber_ = token.line;
+        std::string_view objectName;
+        if (!ReadObjectHeader(tokenizer, objectName)) {
+            AddParseError("Expected '{' after " + std::string(token.text));
+            return false;
+        }
+
+        if (!ParseTopLevelObject(tokenizer, token, objectName)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool XFileParser::ParseTopLevelObject(XFileTokenizer& tokenizer, const XToken& token, std::string_view objectName) {
+    std::string_view objectType = token.text;
+    if (objectType != "template") {
+        ConversionMetrics::GetInstance().AddObjectsParsed(1);
+    }
+
+    if (objectType == "template") {
+        if (!ParseTemplateObject(tokenizer, token, objectName)) {
+            return false;
+        }
+    } else if (objectType == "AnimTicksPerSecond") {
+        if (!ReadTicksPerSecondBody(tokenizer, fileTicksPerSecond_)) {
+            AddParseWarning("Malformed AnimTicksPerSecond object");
+        }
+        tokenizer.SkipBlock();
+    } else if (objectType == "Mesh") {
+        if (!ParseMeshObject(tokenizer, objectName)) {
+            LOG_ERROR("Failed to parse Mesh object at line " + std::to_string(token.line));
+            return false;
+        }
+    } else if (objectType == "Frame") {
+        if (!ParseFrameObject(tokenizer, objectName, -1)) {
+            LOG_ERROR("Failed to parse Frame object at line " + std::to_string(token.line));
+            return false;
+        }
+    } else if (objectType == "AnimationSet") {
+        if (!ParseAnimationSetObject(tokenizer, objectName)) {
+            LOG_ERROR("Failed to parse AnimationSet object at line " + std::to_string(token.line));
+            return false;
+        }
+    } else if (objectType == "Material") {
+        XMaterial material;
+        if (!ParseMaterialObject(tokenizer, objectName, material)) {
+            LOG_ERROR("Failed to parse Material object at line " + std::to_string(token.line));
+            return false;
+        }
+        parsedData_.materials.push_back(material);
+        materialLibrary_[arena_.CopyString(material.name)] = material;
+    } else {
+        LOG_DEBUG("Skipping unknown object type: " + std::string(objectType));
+        tokenizer.SkipBlock();
+    }
+
+    return true;
+}
+
+bool XFileParser::ParseDataObjectsParallel(XFileTokenizer& tokenizer, size_t threads) {
+    TIME_OPERATION("ParseDataObjectsParallel");
+
+    // Phase one: find the top-level objects. Mesh, Frame and AnimationSet
+    // bodies are only brace-matched; everything else is cheap and parsed
+    // here, in order, so the materials a range may reference are known.
+    struct ObjectRange {
+        XToken keyword;
+        std::string_view name;
+        size_t begin;
+        size_t end;
+        size_t materialCount;      // Top-level materials declared before it
+        size_t animationIndex;     // AnimationSets before it
+    };
+    std::vector<ObjectRange> objects;
+    size_t animationCount = 0;
+
+    while (true) {
+        XToken token = tokenizer.Next();
+        if (token.Is(XTokenType::END)) {
+            break;
+        }
+        if (token.Is(XTokenType::SEPARATOR)) {
+            continue;
+        }
+        if (token.Is(XTokenType::OPEN_BRACE)) {
+            tokenizer.ScanBlock();
+            continue;
+        }
+        if (!token.Is(XTokenType::IDENTIFIER)) {
+            lineNumber_ = token.line;
+            AddParseWarning("Unexpected token '" + std::string(token.text) + "' at top level");
+            continue;
+        }
+
+        lineNumber_ = token.line;
+        std::string_view objectName;
+        if (!ReadObjectHeader(tokenizer, objectName)) {
+            AddParseError("Expected '{' after " + std::string(token.text));
+            return false;
+        }
+
+        if (token.text != "Mesh" && token.text != "Frame" && token.text != "AnimationSet") {
+            if (!ParseTopLevelObject(tokenizer, token, objectName)) {
+                return false;
             }
+            continue;
+        }
+
+        ObjectRange object{token, objectName, tokenizer.GetOffset(), 0, parsedData_.materials.size(), animationCount};
+        if (token.text == "AnimationSet") {
+            animationCount++;
+        }
+        if (!tokenizer.ScanBlock()) {
+            AddParseError("Unterminated " + std::string(token.text) + " object");
+            return false;
+        }
+        object.end = tokenizer.GetOffset();
+        objects.push_back(object);
+    }
+
+    // Phase two: every range on its own parser
+    std::vector<std::unique_ptr<XFileParser>> parts(objects.size());
+    std::vector<char> parsed(objects.size(), 0);
+    threads = ParallelUtils::ResolveThreadCount(threads, objects.size());
+    LOG_DEBUG("Parsing " + std::to_string(objects.size()) + " top-level objects on " +
+              std::to_string(threads) + " threads");
+
+    ParallelUtils::ParallelFor(objects.size(), threads, [&](size_t i, size_t) {
+        const ObjectRange& object = objects[i];
+        auto part = std::make_unique<XFileParser>();
+        part->strictMode_ = strictMode_;
+        part->verboseLogging_ = verboseLogging_;
+        part->animationFilter_ = animationFilter_;
+        part->lazyAnimations_ = lazyAnimations_;
+        part->partialParse_ = true;
+        part->sourceOffset_ = sourceOffset_ + object.begin;
+        part->animationIndexBase_ = object.animationIndex;
+        for (size_t m = 0; m < object.materialCount; m++) {
+            const XMaterial& material = parsedData_.materials[m];
+            part->materialLibrary_[part->arena_.CopyString(material.name)] = material;
         }
+
+        XFileTokenizer body(tokenizer.Slice(object.begin, object.end), object.keyword.line);
+        part->lineNumber_ = object.keyword.line;
+        parsed[i] = part->ParseTopLevelObject(body, object.keyword, object.name) ? 1 : 0;
+        parts[i] = std::move(part);
+    });
+
+    // Merge in file order, so the result matches a sequential parse
+    for (size_t i = 0; i < parts.size(); i++) {
+        MergePartialParse(*parts[i]);
+        if (!parsed[i]) {
+            return false;
+        }
+        parts[i].reset();
     }
 
     return true;
 }
 
-bool XFileParser::ParseMeshObject(std::stringstream& stream) {
-    TIME_OPERATION("ParseMeshObject");
+void XFileParser::MergePartialParse(XFileParser& part) {
+    XMeshData& meshData = parsedData_.meshData;
+    XMeshData& source = part.parsedData_.meshData;
+
+    // Bones first; the merged tracks refer to them by index. Replaying the
+    // part's bone creations reproduces the indices of a sequential parse.
+    std::vector<int> boneMap(source.bones.size());
+    for (size_t i = 0; i < source.bones.size(); i++) {
+        const std::string& name = source.GetBoneName(i);
+        if (!name.empty() && name[0] == GENERATED_NAME_MARKER) {
+            boneMap[i] = FindOrAddBone("Frame_" + std::to_string(meshData.bones.size()));
+        } else {
+            boneMap[i] = FindOrAddBone(name);
+        }
+    }
+    for (size_t i = 0; i < source.bones.size(); i++) {
+        const XBone& bone = source.bones[i];
+        int index = boneMap[i];
+        uint8_t fields = part.boneFields_[i];
+        if (fields & BONE_HAS_PARENT) {
+            meshData.bones[index].parentIndex = boneMap[bone.parentIndex];
+        }
+        if (fields & BONE_HAS_TRANSFORM) {
+            meshData.bones[index].bindPose = bone.bindPose;
+        }
+        boneFields_[index] |= fields;
+    }
 
-    std::string line;
+    // Mesh streams, offset by what earlier objects contributed
+    size_t baseVertex = meshData.positions.size();
+    size_t baseMaterial = meshData.materials.size();
+    size_t addedVertices = source.positions.size();
+    if (meshData.name.empty()) {
+        meshData.name = source.name;
+    }
+    meshData.positions.insert(meshData.positions.end(), source.positions.begin(), source.positions.end());
+    AppendVertexStream(meshData.normals, source.normals, baseVertex, addedVertices);
+    AppendVertexStream(meshData.texCoords, source.texCoords, baseVertex, addedVertices);
+    AppendVertexStream(meshData.skinInfluences, source.skinInfluences, baseVertex, addedVertices);
+
+    meshData.indices.reserve(meshData.indices.size() + source.indices.size());
+    for (int index : source.indices) {
+        meshData.indices.push_back(index + static_cast<int>(baseVertex));
+    }
+    meshData.faceMaterials.reserve(meshData.faceMaterials.size() + source.faceMaterials.size());
+    for (int material : source.faceMaterials) {
+        meshData.faceMaterials.push_back(material >= 0 ? material + static_cast<int>(baseMaterial) : material);
+    }
+    meshData.materials.insert(meshData.materials.end(), source.materials.begin(), source.materials.end());
 
-    // Read vertex count
-    if (!std::getline(stream, line)) return false;
-    lineNumber_++;
+    for (auto& animation : source.animations) {
+        for (auto& track : animation.tracks) {
+            if (track.boneId >= 0) {
+                track.boneId = boneMap[track.boneId];
+            }
+        }
+        meshData.animations.push_back(std::move(animation));
+    }
+    for (auto& info : part.parsedData_.animationSets) {
+        parsedData_.animationSets.push_back(std::move(info));
+    }
 
-    line = TrimWhitespace(line);
-    size_t semicolon = line.find(';');
-    if (semicolon != std::string::npos) {
-        line = line.substr(0, semicolon);
+    // Skin weights stay pending until every object is merged
+    for (const auto& pending : part.pendingSkinWeights_) {
+        PendingSkinWeights skin(arena_.Resource());
+        skin.boneName = arena_.CopyString(pending.boneName);
+        skin.vertexIndices.reserve(pending.vertexIndices.size());
+        for (uint32_t vertex : pending.vertexIndices) {
+            skin.vertexIndices.push_back(vertex + static_cast<uint32_t>(baseVertex));
+        }
+        skin.weights.assign(pending.weights.begin(), pending.weights.end());
+        skin.offsetMatrix = pending.offsetMatrix;
+        pendingSkinWeights_.push_back(std::move(skin));
     }
 
-    int vertexCount = std::stoi(line);
-    LOG_DEBUG("Parsing mesh with " + std::to_string(vertexCount) + " vertices");
+    auto& errors = part.parsedData_.parseErrors;
+    auto& warnings = part.parsedData_.parseWarnings;
+    parsedData_.parseErrors.insert(parsedData_.parseErrors.end(), errors.begin(), errors.end());
+    parsedData_.parseWarnings.insert(parsedData_.parseWarnings.end(), warnings.begin(), warnings.end());
+}
 
-    // Read vertices
-    parsedData_.meshData.vertices.reserve(vertexCount);
-    for (int i = 0; i < vertexCount; i++) {
-        if (!std::getline(stream, line)) return false;
-        lineNumber_++;
+bool XFileParser::ParseMeshObject(XFileTokenizer& tokenizer, std::string_view name) {
+    TIME_OPERATION("ParseMeshObject");
 
-        XVertex vertex = ParseVertexLine(line);
-        parsedData_.meshData.vertices.push_back(vertex);
+    XMeshData& meshData = parsedData_.meshData;
+    if (meshData.name.empty()) {
+        meshData.name = std::string(name);
     }
 
-    // Read face count
-    if (!std::getline(stream, line)) return false;
-    lineNumber_++;
+    MeshParseContext mesh(arena_.Resource());
+    mesh.baseVertex = meshData.GetVertexCount();
+    mesh.baseMaterial = meshData.materials.size();
+
+    // Read vertex count
+    uint32_t vertexCount = 0;
+    if (!tokenizer.ReadUInt(vertexCount)) {
+        AddParseError("Mesh: expected vertex count");
+        return false;
+    }
+    LOG_DEBUG("Parsing mesh with " + std::to_string(vertexCount) + " vertices");
 
-    line = TrimWhitespace(line);
-    semicolon = line.find(';');
-    if (semicolon != std::string::npos) {
-        line = line.substr(0, semicolon);
+    // Each vertex needs at least a few bytes of text; don't trust the count blindly
+    meshData.ReserveVertices(mesh.baseVertex + std::min<size_t>(vertexCount, tokenizer.GetSize() / 6));
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        XVector3 position;
+        if (!ReadVector3(tokenizer, position)) {
+            AddParseError("Mesh: failed to read vertex " + std::to_string(i));
+            return false;
+        }
+        meshData.positions.push_back(position);
     }
+    mesh.vertexCount = vertexCount;
 
-    int faceCount = std::stoi(line);
+    // Keep attribute streams of earlier meshes aligned with the new positions
+    meshData.ResizeVertices(meshData.positions.size());
+
+    // Read face count
+    uint32_t faceCount = 0;
+    if (!tokenizer.ReadUInt(faceCount)) {
+        AddParseError("Mesh: expected face count");
+        return false;
+    }
     LOG_DEBUG("Parsing " + std::to_string(faceCount) + " faces");
 
-    // Read faces
-    parsedData_.meshData.faces.reserve(faceCount);
-    for (int i = 0; i < faceCount; i++) {
-        if (!std::getline(stream, line)) return false;
-        lineNumber_++;
+    // Polygons are triangulated as fans
+    size_t polygonReserve = std::min<size_t>(faceCount, tokenizer.GetSize() / 8);
+    meshData.ReserveFaces(meshData.GetFaceCount() + polygonReserve);
+    mesh.polygonOffsets.reserve(polygonReserve + 1);
+    mesh.polygonFirstFace.reserve(polygonReserve + 1);
+    mesh.polygonIndices.reserve(polygonReserve * 3);
+
+    for (uint32_t i = 0; i < faceCount; i++) {
+        uint32_t cornerCount = 0;
+        if (!tokenizer.ReadUInt(cornerCount)) {
+            AddParseError("Mesh: failed to read face " + std::to_string(i));
+            return false;
+        }
+
+        mesh.polygonOffsets.push_back(mesh.polygonIndices.size());
+        mesh.polygonFirstFace.push_back(meshData.GetFaceCount());
 
-        XFace face = ParseFaceLine(line);
-        parsedData_.meshData.faces.push_back(face);
+        for (uint32_t c = 0; c < cornerCount; c++) {
+            uint32_t index = 0;
+            if (!tokenizer.ReadUInt(index)) {
+                AddParseError("Mesh: failed to read index of face " + std::to_string(i));
+                return false;
+            }
+            mesh.polygonIndices.push_back(index);
+        }
+
+        size_t first = mesh.polygonOffsets.back();
+        for (uint32_t c = 1; c + 1 < cornerCount; c++) {
+            meshData.AddTriangle(static_cast<int>(mesh.baseVertex + mesh.polygonIndices[first]),
+                                 static_cast<int>(mesh.baseVertex + mesh.polygonIndices[first + c]),
+                                 static_cast<int>(mesh.baseVertex + mesh.polygonIndices[first + c + 1]));
+        }
     }
+    mesh.polygonOffsets.push_back(mesh.polygonIndices.size());
+    mesh.polygonFirstFace.push_back(meshData.GetFaceCount());
 
     // Parse nested objects (materials, normals, texture coords, etc.)
-    while (std::getline(stream, line)) {
-        lineNumber_++;
-        line = TrimWhitespace(line);
+    while (true) {
+        tokenizer.SkipSeparators();
+        XToken token = tokenizer.Next();
 
-        if (line == "}") {
-            break; // End of mesh object
+        if (token.Is(XTokenType::CLOSE_BRACE)) {
+            return true;
         }
 
-        if (line.find("MeshMaterialList") != std::string::npos) {
-            ParseMeshMaterialList(stream);
-        } else if (line.find("MeshNormals") != std::string::npos) {
-            ParseMeshNormals(stream);
-        } else if (line.find("MeshTextureCoords") != std::string::npos) {
-            ParseMeshTextureCoords(stream);
-        } else if (line.find("XSkinMeshHeader") != std::string::npos) {
-            ParseSkinMeshHeader(stream);
-        } else if (line.find("SkinWeights") != std::string::npos) {
-            ParseSkinWeights(stream);
+        if (token.Is(XTokenType::END)) {
+            AddParseError("Mesh: unexpected end of file");
+            return false;
         }
-    }
 
-    return true;
+        if (token.Is(XTokenType::OPEN_BRACE)) {
+            tokenizer.SkipBlock();
+            continue;
+        }
+
+        if (!token.Is(XTokenType::IDENTIFIER)) {
+            lineNumber_ = token.line;
+            AddParseWarning("Mesh: unexpected token '" + std::string(token.text) + "'");
+            continue;
+        }
+
+        std::string_view childName;
+        if (!ReadObjectHeader(tokenizer, childName)) {
+            lineNumber_ = token.line;
+            AddParseError("Mesh: expected '{' after " + std::string(token.text));
+            return false;
+        }
+
+        bool childParsed = true;
+        if (token.text == "MeshMaterialList") {
+            childParsed = ParseMeshMaterialList(tokenizer, mesh);
+        } else if (token.text == "MeshNormals") {
+            childParsed = ParseMeshNormals(tokenizer, mesh);
+        } else if (token.text == "MeshTextureCoords") {
+            childParsed = ParseMeshTextureCoords(tokenizer, mesh);
+        } else if (token.text == "SkinWeights") {
+            childParsed = ParseSkinWeights(tokenizer, mesh);
+        } else {
+            // XSkinMeshHeader, VertexDuplicationIndices, DeclData, ...
+            childParsed = tokenizer.SkipBlock();
+        }
+
+        if (!childParsed) {
+            lineNumber_ = tokenizer.GetLine();
+            AddParseError("Mesh: failed to parse " + std::string(token.text));
+            return false;
+        }
+    }
 }
 
-bool XFileParser::ParseFrameObject(std::stringstream& stream) {
-    // Skip frame objects for now - they typically contain transformation matrices
-    // that aren't strictly necessary for basic mesh conversion
-    return SkipToClosingBrace(stream);
+bool XFileParser::ParseFrameObject(XFileTokenizer& tokenizer, std::string_view name, int parentBone) {
+    // Every frame becomes a bone so animations and skin weights can target it
+    std::string frameName = !name.empty() ? std::string(name)
+        : partialParse_ ? GENERATED_NAME_MARKER + std::to_string(parsedData_.meshData.bones.size())
+        : "Frame_" + std::to_string(parsedData_.meshData.bones.size());
+
+    int boneIndex = FindOrAddBone(frameName);
+    if (parentBone >= 0) {
+        parsedData_.meshData.bones[boneIndex].parentIndex = parentBone;
+        boneFields_[boneIndex] |= BONE_HAS_PARENT;
+    }
+
+    while (true) {
+        tokenizer.SkipSeparators();
+        XToken token = tokenizer.Next();
+
+        if (token.Is(XTokenType::CLOSE_BRACE)) {
+            return true;
+        }
+
+        if (token.Is(XTokenType::END)) {
+            AddParseError("Frame '" + frameName + "': unexpected end of file");
+            return false;
+        }
+
+        if (token.Is(XTokenType::OPEN_BRACE)) {
+            tokenizer.SkipBlock();
+            continue;
+        }
+
+        if (!token.Is(XTokenType::IDENTIFIER)) {
+            continue;
+        }
+
+        std::string_view childName;
+        if (!ReadObjectHeader(tokenizer, childName)) {
+            lineNumber_ = token.line;
+            AddParseError("Frame '" + frameName + "': expected '{' after " + std::string(token.text));
+            return false;
+        }
+
+        bool childParsed = true;
+        if (token.text == "FrameTransformMatrix") {
+            XMatrix4x4 matrix;
+            childParsed = ReadMatrix(tokenizer, matrix);
+            if (childParsed) {
+                parsedData_.meshData.bones[boneIndex].bindPose = matrix;
+                boneFields_[boneIndex] |= BONE_HAS_TRANSFORM;
+                tokenizer.SkipSeparators();
+                childParsed = tokenizer.Accept(XTokenType::CLOSE_BRACE);
+            }
+        } else if (token.text == "Frame") {
+            childParsed = ParseFrameObject(tokenizer, childName, boneIndex);
+        } else if (token.text == "Mesh") {
+            childParsed = ParseMeshObject(tokenizer, childName);
+        } else {
+            childParsed = tokenizer.SkipBlock();
+        }
+
+        if (!childParsed) {
+            lineNumber_ = tokenizer.GetLine();
+            AddParseError("Frame '" + frameName + "': failed to parse " + std::string(token.text));
+            return false;
+        }
+    }
 }
 
-bool XFileParser::ParseAnimationSetObject(std::stringstream& stream) {
+bool XFileParser::ParseAnimationSetObject(XFileTokenizer& tokenizer, std::string_view name) {
     TIME_OPERATION("ParseAnimationSetObject");
 
+    XAnimationSetInfo info;
+    info.name = name.empty()
+        ? "Animation_" + std::to_string(animationIndexBase_ + parsedData_.animationSets.size())
+        : std::string(name);
+    info.offset = sourceOffset_ + tokenizer.GetOffset();
+
+    // Unselected and lazy sets only record where their keys are
+    if (lazyAnimations_ || !XFileUtils::MatchesAnimationFilter(animationFilter_, info.name)) {
+        if (!IndexAnimationSetBody(tokenizer, info)) {
+            return false;
+        }
+        info.length = sourceOffset_ + tokenizer.GetOffset() - info.offset;
+        parsedData_.animationSets.push_back(std::move(info));
+        return true;
+    }
+
     XAnimationSet animSet;
-    animSet.name = "Animation_" + std::to_string(parsedData_.meshData.animations.size());
+    animSet.name = info.name;
+    if (!ParseAnimationSetBody(tokenizer, animSet)) {
+        return false;
+    }
 
-    std::string line;
-    while (std::getline(stream, line)) {
-        lineNumber_++;
-        line = TrimWhitespace(line);
+    info.length = sourceOffset_ + tokenizer.GetOffset() - info.offset;
+    info.trackCount = animSet.tracks.size();
+    info.keyCount = animSet.GetKeyCount();
+    info.decoded = true;
+    parsedData_.animationSets.push_back(std::move(info));
 
-        if (line == "}") {
+    if (!animSet.tracks.empty()) {
+        LOG_DEBUG("Parsed animation set: " + animSet.name + " with " +
+                  std::to_string(animSet.GetKeyCount()) + " keys, " +
+                  std::to_string(animSet.tracks.size()) + " tracks, " +
+                  std::to_string(animSet.GetMemoryUsage()) + " bytes");
+        parsedData_.meshData.animations.push_back(std::move(animSet));
+    }
+
+    return true;
+}
+
+bool XFileParser::ParseAnimationSetBody(XFileTokenizer& tokenizer, XAnimationSet& animSet) {
+    while (true) {
+        tokenizer.SkipSeparators();
+        XToken token = tokenizer.Next();
+
+        if (token.Is(XTokenType::CLOSE_BRACE)) {
             break; // End of animation set
         }
 
-        if (line.find("Animation") != std::string::npos && line.find('{') != std::string::npos) {
-            ParseAnimationObject(stream, animSet);
+        if (token.Is(XTokenType::END)) {
+            AddParseError("AnimationSet '" + animSet.name + "': unexpected end of file");
+            return false;
         }
-    }
 
-    if (!animSet.keyframes.empty()) {
-        parsedData_.meshData.animations.push_back(animSet);
-        LOG_DEBUG("Parsed animation set: " + animSet.name + " with " +
-                  std::to_string(animSet.keyframes.size()) + " keyframes");
+        if (token.Is(XTokenType::OPEN_BRACE)) {
+            tokenizer.SkipBlock();
+            continue;
+        }
+
+        if (!token.Is(XTokenType::IDENTIFIER)) {
+            continue;
+        }
+
+        std::string_view childName;
+        if (!ReadObjectHeader(tokenizer, childName)) {
+            lineNumber_ = token.line;
+            AddParseError("AnimationSet '" + animSet.name + "': expected '{' after " + std::string(token.text));
+            return false;
+        }
+
+        bool childParsed = (token.text == "Animation")
+            ? ParseAnimationObject(tokenizer, animSet)
+            : tokenizer.SkipBlock();
+        if (!childParsed) {
+            return false;
+        }
     }
 
     return true;
 }
 
-bool XFileParser::ParseAnimationObject(std::stringstream& stream, XAnimationSet& animSet) {
-    std::string line;
-    while (std::getline(stream, line)) {
-        lineNumber_++;
-        line = TrimWhitespace(line);
+bool XFileParser::IndexAnimationSetBody(XFileTokenizer& tokenizer, XAnimationSetInfo& info) {
+    // Animation objects are counted and their AnimationKey headers read;
+    // every key body is skipped without converting numbers
+    int depth = 1;
+    bool inAnimation = false;
+    while (depth > 0) {
+        XToken token = tokenizer.Next();
 
-        if (line == "}") {
-            break; // End of animation object
+        if (token.Is(XTokenType::END)) {
+            AddParseError("AnimationSet '" + info.name + "': unexpected end of file");
+            return false;
+        }
+        if (token.Is(XTokenType::OPEN_BRACE)) {
+            depth++;
+            continue;
+        }
+        if (token.Is(XTokenType::CLOSE_BRACE)) {
+            depth--;
+            if (depth == 1) {
+                inAnimation = false;
+            }
+            continue;
+        }
+        if (!token.Is(XTokenType::IDENTIFIER)) {
+            continue;
         }
 
-        if (line.find("AnimationKey") != std::string::npos && line.find('{') != std::string::npos) {
-            ParseAnimationKeyObject(stream, animSet);
+        std::string_view childName;
+        if (!ReadObjectHeader(tokenizer, childName)) {
+            continue;   // A frame reference or a value, not an object
+        }
+        depth++;
+
+        if (depth == 2 && token.text == "Animation") {
+            inAnimation = true;
+            info.trackCount++;
+        } else if (depth == 3 && inAnimation && token.text == "AnimationKey") {
+            int keyType = 0;
+            uint32_t numKeys = 0;
+            if (tokenizer.ReadInt(keyType) && tokenizer.ReadUInt(numKeys)) {
+                info.keyCount += numKeys;
+            }
         }
     }
-
     return true;
 }
 
-bool XFileParser::ParseAnimationKeyObject(std::stringstream& stream, XAnimationSet& animSet) {
-    std::string line;
+bool XFileParser::ParseAnimationObject(XFileTokenizer& tokenizer, XAnimationSet& animSet) {
+    std::string boneName;
+    XBoneTrack track;
 
-    // Read key type
-    if (!std::getline(stream, line)) return false;
-    lineNumber_++;
+    while (true) {
+        tokenizer.SkipSeparators();
+        XToken token = tokenizer.Next();
 
-    int keyType = std::stoi(TrimWhitespace(line.substr(0, line.find(';'))));
+        if (token.Is(XTokenType::CLOSE_BRACE)) {
+            break; // End of animation object
+        }
 
-    // Read number of keys
-    if (!std::getline(stream, line)) return false;
-    lineNumber_++;
+        if (token.Is(XTokenType::END)) {
+            AddParseError("Animation: unexpected end of file");
+            return false;
+        }
 
-    int numKeys = std::stoi(TrimWhitespace(line.substr(0, line.find(';'))));
+        if (token.Is(XTokenType::OPEN_BRACE)) {
+            // Reference to the animated frame: { BoneName }
+            if (tokenizer.Peek().Is(XTokenType::IDENTIFIER)) {
+                boneName = std::string(tokenizer.Next().text);
+            }
+            if (!tokenizer.SkipBlock()) {
+                AddParseError("Animation: unterminated frame reference");
+                return false;
+            }
+            continue;
+        }
 
-    // Read keyframes
-    for (int i = 0; i < numKeys; i++) {
-        if (!std::getline(stream, line)) return false;
-        lineNumber_++;
+        if (!token.Is(XTokenType::IDENTIFIER)) {
+            continue;
+        }
 
-        XKeyframe keyframe = ParseKeyframeLine(line, keyType);
-        animSet.keyframes.push_back(keyframe);
+        std::string_view childName;
+        if (!ReadObjectHeader(tokenizer, childName)) {
+            lineNumber_ = token.line;
+            AddParseError("Animation: expected '{' after " + std::string(token.text));
+            return false;
+        }
 
-        if (keyframe.time > animSet.duration) {
-            animSet.duration = keyframe.time;
+        if (token.text == "AnimationKey") {
+            if (!ParseAnimationKeyObject(tokenizer, track)) {
+                lineNumber_ = tokenizer.GetLine();
+                AddParseError("Animation: failed to parse AnimationKey");
+                return false;
+            }
+        } else if (token.text == "Frame") {
+            // Inline frame instead of a reference
+            if (boneName.empty()) {
+                boneName = childName.empty() ? "" : std::string(childName);
+            }
+            tokenizer.SkipBlock();
+        } else {
+            tokenizer.SkipBlock();   // AnimationOptions, ...
         }
     }
 
-    // Skip to closing brace
-    while (std::getline(stream, line)) {
-        lineNumber_++;
-        if (TrimWhitespace(line) == "}") break;
+    if (track.GetKeyCount() > 0) {
+        // Frames declared after the animation find the bone added here
+        track.boneId = boneName.empty() ? -1 : FindOrAddBone(boneName);
+        animSet.duration = std::max(animSet.duration, track.GetEndTime());
+        animSet.AddTrack(std::move(track));
     }
 
     return true;
 }
 
-bool XFileParser::ParseMaterialObject(std::stringstream& stream) {
-    XMaterial material;
-    std::string line;
-
-    // Read material properties
-    if (!std::getline(stream, line)) return false;
-    lineNumber_++;
-
-    // Parse diffuse color (r,g,b,a)
-    auto values = ParseFloatArray(line);
-    if (values.size() >= 3) {
-        material.diffuseColor = XVector3(values[0], values[1], values[2]);
+bool XFileParser::ParseAnimationKeyObject(XFileTokenizer& tokenizer, XBoneTrack& track) {
+    int keyType = 0;
+    uint32_t numKeys = 0;
+    if (!tokenizer.ReadInt(keyType) || !tokenizer.ReadUInt(numKeys)) {
+        return false;
     }
 
-    // Read other material properties...
-    while (std::getline(stream, line)) {
-        lineNumber_++;
-        line = TrimWhitespace(line);
+    // Each key type fills its own channel; the others keep no data
+    XAnimationChannel* channel = nullptr;
+    size_t components = XBoneTrack::VECTOR_COMPONENTS;
+    switch (keyType) {
+        case 0: channel = &track.rotation; components = XBoneTrack::ROTATION_COMPONENTS; break;
+        case 1: channel = &track.scale; break;
+        case 2: channel = &track.translation; break;
+        case 4: channel = &track.translation; break;   // Matrix - only the translation row is kept
+        default: break;
+    }
+    if (channel) {
+        channel->Reserve(channel->GetKeyCount() + std::min<size_t>(numKeys, tokenizer.GetSize() / 8), components);
+    }
 
-        if (line == "}") {
-            break;
+    for (uint32_t i = 0; i < numKeys; i++) {
+        float time = 0.0f;
+        uint32_t valueCount = 0;
+        if (!tokenizer.ReadFloat(time) || !tokenizer.ReadUInt(valueCount)) {
+            return false;
         }
 
-        if (line.find("TextureFilename") != std::string::npos) {
-            // Parse texture filename
-            if (std::getline(stream, line)) {
-                lineNumber_++;
-                material.diffuseTexture = ParseStringLine(line);
+        float values[16] = {0};
+        for (uint32_t v = 0; v < valueCount; v++) {
+            float value = 0.0f;
+            if (!tokenizer.ReadFloat(value)) {
+                return false;
             }
+            if (v < 16) values[v] = value;
         }
-    }
 
-    parsedData_.meshData.materials.push_back(material);
-    return true;
-}
+        const size_t required = (keyType == 4) ? 16 : components;
+        if (!channel || valueCount < required) {
+            continue;
+        }
 
-// Helper parsing methods
-XVertex XFileParser::ParseVertexLine(const std::string& line) {
-    XVertex vertex;
-    auto values = ParseFloatArray(line);
+        if (keyType == 0) {
+            // Quaternion stored w first
+            const float rotation[4] = {values[1], values[2], values[3], values[0]};
+            channel->AddKey(time, rotation, components);
+        } else {
+            channel->AddKey(time, keyType == 4 ? &values[12] : values, components);
+        }
+    }
 
-    if (values.size() >= 3) {
-        vertex.position = XVector3(values[0], values[1], values[2]);
+    if (channel) {
+        channel->SortByTime(components);
     }
 
-    return vertex;
+    tokenizer.SkipSeparators();
+    return tokenizer.Accept(XTokenType::CLOSE_BRACE);
 }
 
-XFace XFileParser::ParseFaceLine(const std::string& line) {
-    XFace face;
-    auto values = ParseIntArray(line);
+bool XFileParser::ParseMaterialObject(XFileTokenizer& tokenizer, std::string_view name, XMaterial& material) {
+    material.name = name.empty()
+        ? "Material_" + std::to_string(parsedData_.materials.size() + parsedData_.meshData.materials.size())
+        : std::string(name);
+    material.shininess = 0.0f;
+    material.transparency = 0.0f;
+
+    // faceColor (RGBA), power, specularColor, emissiveColor
+    float alpha = 1.0f;
+    if (!ReadColor(tokenizer, material.diffuseColor, &alpha) ||
+        !tokenizer.ReadFloat(material.shininess) ||
+        !ReadColor(tokenizer, material.specularColor) ||
+        !ReadColor(tokenizer, material.emissiveColor)) {
+        AddParseError("Material '" + material.name + "': incomplete color data");
+        return false;
+    }
+    material.transparency = 1.0f - alpha;
 
-    if (values.size() >= 4) {
-        // First value is vertex count (should be 3 for triangles)
-        if (values[0] == 3 && values.size() >= 4) {
-            face.indices[0] = values[1];
-            face.indices[1] = values[2];
-            face.indices[2] = values[3];
+    while (true) {
+        tokenizer.SkipSeparators();
+        XToken token = tokenizer.Next();
+
+        if (token.Is(XTokenType::CLOSE_BRACE)) {
+            return true;
+        }
+
+        if (token.Is(XTokenType::END)) {
+            AddParseError("Material '" + material.name + "': unexpected end of file");
+            return false;
+        }
+
+        if (token.Is(XTokenType::OPEN_BRACE)) {
+            tokenizer.SkipBlock();
+            continue;
+        }
+
+        if (!token.Is(XTokenType::IDENTIFIER)) {
+            continue;
+        }
+
+        std::string_view childName;
+        if (!ReadObjectHeader(tokenizer, childName)) {
+            return false;
+        }
+
+        // TextureFilename / TextureFileName / NormalmapFilename
+        std::string_view filename;
+        bool isTexture = token.text == "TextureFilename" || token.text == "TextureFileName";
+        bool isNormalMap = token.text == "NormalmapFilename" || token.text == "NormalMapFilename";
+        if ((isTexture || isNormalMap) && tokenizer.ReadString(filename)) {
+            (isTexture ? material.diffuseTexture : material.normalTexture) = std::string(filename);
         }
-    }
 
-    return face;
+        if (!tokenizer.SkipBlock()) {
+            return false;
+        }
+    }
 }
 
-XKeyframe XFileParser::ParseKeyframeLine(const std::string& line, int keyType) {
-    XKeyframe keyframe;
-    auto values = ParseFloatArray(line);
+bool XFileParser::ParseMeshMaterialList(XFileTokenizer& tokenizer, const MeshParseContext& mesh) {
+    XMeshData& meshData = parsedData_.meshData;
 
-    if (values.size() >= 1) {
-        keyframe.time = values[0];
+    uint32_t materialCount = 0;
+    uint32_t indexCount = 0;
+    if (!tokenizer.ReadUInt(materialCount) || !tokenizer.ReadUInt(indexCount)) {
+        return false;
     }
 
-    // Parse based on key type
-    switch (keyType) {
-        case 0: // Rotation (quaternion)
-            if (values.size() >= 5) {
-                keyframe.rotation = XQuaternion(values[2], values[3], values[4], values[1]);
+    size_t polygonCount = mesh.polygonFirstFace.empty() ? 0 : mesh.polygonFirstFace.size() - 1;
+    int lastMaterial = 0;
+    for (uint32_t i = 0; i < indexCount; i++) {
+        int materialIndex = 0;
+        if (!tokenizer.ReadInt(materialIndex)) {
+            return false;
+        }
+        if (i < polygonCount) {
+            for (size_t f = mesh.polygonFirstFace[i]; f < mesh.polygonFirstFace[i + 1]; f++) {
+                meshData.faceMaterials[f] = static_cast<int>(mesh.baseMaterial) + materialIndex;
             }
+        }
+        lastMaterial = materialIndex;
+    }
+
+    // Fewer indices than faces: the last index applies to the remaining faces
+    for (size_t p = indexCount; p < polygonCount; p++) {
+        for (size_t f = mesh.polygonFirstFace[p]; f < mesh.polygonFirstFace[p + 1]; f++) {
+            meshData.faceMaterials[f] = static_cast<int>(mesh.baseMaterial) + lastMaterial;
+        }
+    }
+
+    // Materials follow, either inline or as { Name } references
+    while (true) {
+        tokenizer.SkipSeparators();
+        XToken token = tokenizer.Next();
+
+        if (token.Is(XTokenType::CLOSE_BRACE)) {
             break;
-        case 1: // Scale
-            if (values.size() >= 4) {
-                keyframe.scale = XVector3(values[1], values[2], values[3]);
+        }
+
+        if (token.Is(XTokenType::END)) {
+            return false;
+        }
+
+        if (token.Is(XTokenType::OPEN_BRACE)) {
+            if (tokenizer.Peek().Is(XTokenType::IDENTIFIER)) {
+                std::string reference(tokenizer.Next().text);
+                auto it = materialLibrary_.find(reference);
+                if (it != materialLibrary_.end()) {
+                    meshData.materials.push_back(it->second);
+                } else {
+                    AddParseWarning("MeshMaterialList references unknown material: " + reference);
+                    XMaterial placeholder;
+                    placeholder.name = reference;
+                    placeholder.diffuseColor = XVector3(1.0f, 1.0f, 1.0f);
+                    placeholder.shininess = 0.0f;
+                    placeholder.transparency = 0.0f;
+                    meshData.materials.push_back(placeholder);
+                }
             }
-            break;
-        case 2: // Position
-            if (values.size() >= 4) {
-                keyframe.position = XVector3(values[1], values[2], values[3]);
+            if (!tokenizer.SkipBlock()) {
+                return false;
             }
-            break;
+            continue;
+        }
+
+        if (!token.Is(XTokenType::IDENTIFIER)) {
+            continue;
+        }
+
+        std::string_view childName;
+        if (!ReadObjectHeader(tokenizer, childName)) {
+            return false;
+        }
+
+        if (token.text == "Material") {
+            XMaterial material;
+            if (!ParseMaterialObject(tokenizer, childName, material)) {
+                return false;
+            }
+            meshData.materials.push_back(std::move(material));
+        } else if (!tokenizer.SkipBlock()) {
+            return false;
+        }
     }
 
-    return keyframe;
-}
+    if (meshData.materials.size() - mesh.baseMaterial != materialCount) {
+        AddParseWarning("MeshMaterialList declares " + std::to_string(materialCount) + " materials but provides " +
+                        std::to_string(meshData.materials.size() - mesh.baseMaterial));
+    }
 
-// Additional helper methods for nested mesh objects
-bool XFileParser::ParseMeshMaterialList(std::stringstream& stream) {
-    return SkipToClosingBrace(stream); // Basic implementation
+    return true;
 }
 
-bool XFileParser::ParseMeshNormals(std::stringstream& stream) {
-    return SkipToClosingBrace(stream); // Basic implementation
-}
+bool XFileParser::ParseMeshNormals(XFileTokenizer& tokenizer, const MeshParseContext& mesh) {
+    XMeshData& meshData = parsedData_.meshData;
+    meshData.EnsureNormals();
 
-bool XFileParser::ParseMeshTextureCoords(std::stringstream& stream) {
-    return SkipToClosingBrace(stream); // Basic implementation
-}
+    uint32_t normalCount = 0;
+    if (!tokenizer.ReadUInt(normalCount)) {
+        return false;
+    }
 
-bool XFileParser::ParseSkinMeshHeader(std::stringstream& stream) {
-    return SkipToClosingBrace(stream); // Basic implementation
-}
+    std::pmr::vector<XVector3> normals(arena_.Resource());
+    normals.reserve(std::min<size_t>(normalCount, tokenizer.GetSize() / 6));
+    for (uint32_t i = 0; i < normalCount; i++) {
+        XVector3 normal;
+        if (!ReadVector3(tokenizer, normal)) {
+            return false;
+        }
+        normals.push_back(normal);
+    }
+
+    // Face normal indices mirror the mesh polygons; map each corner's normal
+    // onto the vertex it references
+    uint32_t faceCount = 0;
+    if (!tokenizer.ReadUInt(faceCount)) {
+        return false;
+    }
+
+    size_t polygonCount = mesh.polygonOffsets.empty() ? 0 : mesh.polygonOffsets.size() - 1;
+    for (uint32_t f = 0; f < faceCount; f++) {
+        uint32_t cornerCount = 0;
+        if (!tokenizer.ReadUInt(cornerCount)) {
+            return false;
+        }
+        for (uint32_t c = 0; c < cornerCount; c++) {
+            uint32_t normalIndex = 0;
+            if (!tokenizer.ReadUInt(normalIndex)) {
+                return false;
+            }
+            if (f < polygonCount && normalIndex < normals.size() &&
+                mesh.polygonOffsets[f] + c < mesh.polygonOffsets[f + 1]) {
+                uint32_t vertex = mesh.polygonIndices[mesh.polygonOffsets[f] + c];
+                if (vertex < mesh.vertexCount) {
+                    meshData.normals[mesh.baseVertex + vertex] = normals[normalIndex];
+                }
+            }
+        }
+    }
 
-bool XFileParser::ParseSkinWeights(std::stringstream& stream) {
-    return SkipToClosingBrace(stream); // Basic implementation
+    tokenizer.SkipSeparators();
+    return tokenizer.Accept(XTokenType::CLOSE_BRACE);
 }
 
-bool XFileParser::SkipToClosingBrace(std::stringstream& stream) {
-    std::string line;
-    int braceCount = 1;
+bool XFileParser::ParseMeshTextureCoords(XFileTokenizer& tokenizer, const MeshParseContext& mesh) {
+    XMeshData& meshData = parsedData_.meshData;
+    meshData.EnsureTexCoords();
+
+    uint32_t coordCount = 0;
+    if (!tokenizer.ReadUInt(coordCount)) {
+        return false;
+    }
 
-    while (std::getline(stream, line) && braceCount > 0) {
-        lineNumber_++;
-        for (char c : line) {
-            if (c == '{') braceCount++;
-            else if (c == '}') braceCount--;
+    for (uint32_t i = 0; i < coordCount; i++) {
+        XVector2 uv;
+        if (!tokenizer.ReadFloat(uv.u) || !tokenizer.ReadFloat(uv.v)) {
+            return false;
+        }
+        if (i < mesh.vertexCount) {
+            meshData.texCoords[mesh.baseVertex + i] = uv;
         }
     }
 
-    return true;
+    tokenizer.SkipSeparators();
+    return tokenizer.Accept(XTokenType::CLOSE_BRACE);
 }
 
-std::string XFileParser::ParseStringLine(const std::string& line) {
-    std::string cleaned = TrimWhitespace(line);
+bool XFileParser::ParseSkinWeights(XFileTokenizer& tokenizer, const MeshParseContext& mesh) {
+    PendingSkinWeights skin(arena_.Resource());
 
-    // Remove quotes and semicolon
-    if (cleaned.front() == '"' && cleaned.back() == ';') {
-        cleaned = cleaned.substr(1, cleaned.length() - 3);
-    } else if (cleaned.front() == '"') {
-        cleaned = cleaned.substr(1, cleaned.length() - 2);
+    std::string_view boneName;
+    uint32_t weightCount = 0;
+    if (!tokenizer.ReadString(boneName) || !tokenizer.ReadUInt(weightCount)) {
+        return false;
     }
+    skin.boneName = arena_.CopyString(boneName);
+
+    size_t reserve = std::min<size_t>(weightCount, tokenizer.GetSize() / 2);
+    skin.vertexIndices.reserve(reserve);
+    skin.weights.reserve(reserve);
+
+    for (uint32_t i = 0; i < weightCount; i++) {
+        uint32_t index = 0;
+        if (!tokenizer.ReadUInt(index)) {
+            return false;
+        }
+        skin.vertexIndices.push_back(static_cast<uint32_t>(mesh.baseVertex) + index);
+    }
+
+    for (uint32_t i = 0; i < weightCount; i++) {
+        float weight = 0.0f;
+        if (!tokenizer.ReadFloat(weight)) {
+            return false;
+        }
+        skin.weights.push_back(weight);
+    }
+
+    if (!ReadMatrix(tokenizer, skin.offsetMatrix)) {
+        return false;
+    }
+
+    pendingSkinWeights_.push_back(std::move(skin));
+
+    tokenizer.SkipSeparators();
+    return tokenizer.Accept(XTokenType::CLOSE_BRACE);
+}
+
+bool XFileParser::ReadVector3(XFileTokenizer& tokenizer, XVector3& value) {
+    return tokenizer.ReadFloat(value.x) && tokenizer.ReadFloat(value.y) && tokenizer.ReadFloat(value.z);
+}
 
-    return cleaned;
+bool XFileParser::ReadMatrix(XFileTokenizer& tokenizer, XMatrix4x4& matrix) {
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 4; col++) {
+            if (!tokenizer.ReadFloat(matrix.m[row][col])) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
-std::string XFileParser::TrimWhitespace(const std::string& str) {
-    size_t start = str.find_first_not_of(" \t\n\r");
-    if (start == std::string::npos) return "";
+bool XFileParser::ReadColor(XFileTokenizer& tokenizer, XVector3& color, float* alpha) {
+    if (!ReadVector3(tokenizer, color)) {
+        return false;
+    }
+    return alpha ? tokenizer.ReadFloat(*alpha) : true;
+}
 
-    size_t end = str.find_last_not_of(" \t\n\r");
-    return str.substr(start, end - start + 1);
+int XFileParser::FindOrAddBone(std::string_view name) {
+    int index = parsedData_.meshData.AddBone(name);
+    if (static_cast<size_t>(index) == boneFields_.size()) {
+        boneFields_.push_back(0);
+    }
+    return index;
 }
 
-std::vector<std::string> XFileParser::SplitString(const std::string& str, char delimiter) {
-    std::vector<std::string> result;
-    std::stringstream ss(str);
-    std::string item;
+void XFileParser::ResolveSkinWeights() {
+    XMeshData& meshData = parsedData_.meshData;
 
-    while (std::getline(ss, item, delimiter)) {
-        result.push_back(TrimWhitespace(item));
+    if (!pendingSkinWeights_.empty()) {
+        meshData.EnsureSkinInfluences();
     }
 
-    return result;
+    size_t droppedInfluences = 0;
+    std::vector<uint32_t> overflowVertices;
+
+    for (const auto& skin : pendingSkinWeights_) {
+        std::string boneName(skin.boneName);
+        int boneIndex = FindOrAddBone(boneName);
+        meshData.bones[boneIndex].offsetMatrix = skin.offsetMatrix;
+
+        for (size_t i = 0; i < skin.vertexIndices.size(); i++) {
+            uint32_t vertex = skin.vertexIndices[i];
+            if (vertex >= meshData.GetVertexCount()) {
+                AddParseWarning("SkinWeights for '" + boneName + "' reference invalid vertex " +
+                                std::to_string(vertex));
+                continue;
+            }
+            if (!meshData.skinInfluences[vertex].Add(boneIndex, skin.weights[i])) {
+                droppedInfluences++;
+                overflowVertices.push_back(vertex);
+            }
+        }
+    }
+
+    // Vertices with more than MAX_INFLUENCES bones keep the strongest ones,
+    // renormalized so their weights still sum to one
+    if (droppedInfluences > 0) {
+        std::sort(overflowVertices.begin(), overflowVertices.end());
+        overflowVertices.erase(std::unique(overflowVertices.begin(), overflowVertices.end()), overflowVertices.end());
+
+        for (uint32_t vertex : overflowVertices) {
+            meshData.skinInfluences[vertex].Normalize();
+        }
+
+        AddParseWarning(std::to_string(droppedInfluences) + " bone influences beyond " +
+                        std::to_string(XVertexInfluences::MAX_INFLUENCES) + " per vertex were dropped on " +
+                        std::to_string(overflowVertices.size()) + " vertices");
+    }
+
+    pendingSkinWeights_.clear();
 }
 
 XDataObjectType XFileParser::StringToDataObjectType(const std::string& typeName) {
@@ -623,48 +1432,49 @@ bool XFileUtils::ValidateXFileSignature(const std::string& filepath) {
 }
 
 bool XFileUtils::ExtractTicksPerSecond(const std::string& content, float& ticksPerSecond) {
-    // Look for AnimTicksPerSecond
-    std::regex ticksRegex(R"(AnimTicksPerSecond\s*\{\s*([0-9.]+)\s*[;}])");
-    std::smatch match;
+    // Look for an AnimTicksPerSecond data object (not its template declaration)
+    XFileTokenizer tokenizer(content);
+
+    while (!tokenizer.AtEnd()) {
+        XToken token = tokenizer.Next();
+        if (!token.IsIdentifier("AnimTicksPerSecond")) {
+            continue;
+        }
 
-    if (std::regex_search(content, match, ticksRegex)) {
-        bool success;
-        ticksPerSecond = ParseFloat(match[1].str(), success);
-        return success;
+        if (tokenizer.Peek().Is(XTokenType::IDENTIFIER)) {
+            tokenizer.Next();
+        }
+        if (tokenizer.Accept(XTokenType::OPEN_BRACE) && ReadTicksPerSecondBody(tokenizer, ticksPerSecond)) {
+            return true;
+        }
     }
 
     return false;
 }
 
+bool XFileUtils::MatchesAnimationFilter(const std::vector<std::string>& filter, const std::string& name) {
+    return filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+}
+
 float XFileUtils::ParseFloat(const std::string& str, bool& success) {
-    try {
-        float value = std::stof(str);
-        success = true;
-        return value;
-    } catch (...) {
-        success = false;
-        return 0.0f;
-    }
+    float value = 0.0f;
+    success = XFileTokenizer::ParseFloat(str, value);
+    return success ? value : 0.0f;
 }
 
 int XFileUtils::ParseInt(const std::string& str, bool& success) {
-    try {
-        int value = std::stoi(str);
-        success = true;
-        return value;
-    } catch (...) {
-        success = false;
-        return 0;
-    }
+    int value = 0;
+    success = XFileTokenizer::ParseInt(str, value);
+    return success ? value : 0;
 }
 
-std::string XFileUtils::PreprocessTextContent(const std::string& content) {
+std::string XFileUtils::PreprocessTextContent(std::string_view content) {
     std::string result = RemoveComments(content);
     result = NormalizeWhitespace(result);
     return result;
 }
 
-std::string XFileUtils::RemoveComments(const std::string& content) {
+std::string XFileUtils::RemoveComments(std::string_view content) {
     std::string result;
     result.reserve(content.size());
 
@@ -730,69 +1540,25 @@ std::string XFileUtils::NormalizeWhitespace(const std::string& content) {
     return result;
 }
 
-std::vector<float> XFileParser::ParseFloatArray(const std::string& data) {
-    std::vector<float> result;
-    std::string cleanData = TrimWhitespace(data);
-
-    // Remove trailing semicolon and comma
-    if (!cleanData.empty() && (cleanData.back() == ';' || cleanData.back() == ',')) {
-        cleanData.pop_back();
-    }
-
-    std::stringstream ss(cleanData);
-    std::string token;
-
-    while (std::getline(ss, token, ';') || std::getline(ss, token, ',')) {
-        token = TrimWhitespace(token);
-        if (!token.empty()) {
-            bool success;
-            float value = XFileUtils::ParseFloat(token, success);
-            if (success) {
-                result.push_back(value);
-            }
-        }
-    }
-
-    return result;
-}
-
-std::vector<int> XFileParser::ParseIntArray(const std::string& data) {
-    std::vector<int> result;
-    std::string cleanData = TrimWhitespace(data);
-
-    // Remove trailing semicolon and comma
-    if (!cleanData.empty() && (cleanData.back() == ';' || cleanData.back() == ',')) {
-        cleanData.pop_back();
-    }
-
-    std::stringstream ss(cleanData);
-    std::string token;
-
-    while (std::getline(ss, token, ';') || std::getline(ss, token, ',')) {
-        token = TrimWhitespace(token);
-        if (!token.empty()) {
-            bool success;
-            int value = XFileUtils::ParseInt(token, success);
-            if (success) {
-                result.push_back(value);
-            }
-        }
-    }
-
-    return result;
-}
-
 bool XFileParser::ExtractTimingInformation() {
     // Try to extract timing information from parsed animations
     float globalTicks = 0;
     bool foundTiming = false;
 
-    // Check if any animation has explicit timing
+    // An AnimTicksPerSecond object applies to the whole file
+    if (fileTicksPerSecond_ > 0) {
+        globalTicks = fileTicksPerSecond_;
+        foundTiming = true;
+    }
+
+    // Otherwise check if any animation has explicit timing
     for (auto& anim : parsedData_.meshData.animations) {
+        if (foundTiming) {
+            break;
+        }
         if (anim.ticksPerSecond > 0) {
             globalTicks = anim.ticksPerSecond;
             foundTiming = true;
-            break;
         }
     }
 
@@ -815,48 +1581,38 @@ bool XFileParser::ExtractTimingInformation() {
             anim.ticksPerSecond = globalTicks;
         }
     }
+    for (auto& info : parsedData_.animationSets) {
+        info.ticksPerSecond = globalTicks;
+    }
 
     return true;
 }
 
 void XFileParser::BuildSkeletonHierarchy() {
-    // Basic skeleton building - link bones by parent names
-    for (size_t i = 0; i < parsedData_.meshData.bones.size(); i++) {
-        auto& bone = parsedData_.meshData.bones[i];
-
-        if (!bone.parentName.empty()) {
-            // Find parent bone
-            for (size_t j = 0; j < parsedData_.meshData.bones.size(); j++) {
-                if (parsedData_.meshData.bones[j].name == bone.parentName) {
-                    bone.parentIndex = static_cast<int>(j);
-                    parsedData_.meshData.bones[j].childIndices.push_back(static_cast<int>(i));
-                    break;
-                }
-            }
+    // Parent indices were set while parsing frames; sorting parents first
+    // also fills in the child lists and makes world matrices one linear pass
+    std::vector<int> newIndex;
+    if (!parsedData_.meshData.SortBonesTopologically(newIndex)) {
+        AddParseWarning("Frame hierarchy has a parent cycle; bones left in file order");
+    } else {
+        std::pmr::vector<uint8_t> fields(boneFields_.size(), 0, boneFields_.get_allocator());
+        for (size_t i = 0; i < boneFields_.size() && i < newIndex.size(); i++) {
+            fields[newIndex[i]] = boneFields_[i];
         }
+        boneFields_.swap(fields);
     }
 
     LOG_DEBUG("Built skeleton hierarchy with " + std::to_string(parsedData_.meshData.bones.size()) + " bones");
 }
 
 void XFileParser::ProcessAnimationHierarchy() {
-    // Link animations to skeleton bones
-    for (auto& anim : parsedData_.meshData.animations) {
-        // Process bone-specific keyframes
-        for (const auto& boneKF : anim.boneKeyframes) {
-            const std::string& boneName = boneKF.first;
-
-            // Find corresponding bone
-            bool boneFound = false;
-            for (const auto& bone : parsedData_.meshData.bones) {
-                if (bone.name == boneName) {
-                    boneFound = true;
-                    break;
-                }
-            }
-
-            if (!boneFound) {
-                LOG_WARNING("Animation references unknown bone: " + boneName);
+    // Tracks were bound to bone ids while parsing; keys without a target
+    // frame only feed timing analysis and are not exported
+    for (const auto& anim : parsedData_.meshData.animations) {
+        for (const auto& track : anim.tracks) {
+            if (track.boneId < 0) {
+                LOG_WARNING("Animation '" + anim.name + "' has keys without a target frame");
+                break;
             }
         }
     }
@@ -871,7 +1627,7 @@ bool XFileParser::ValidateParsedData() {
 
     // Additional validation for animations
     for (const auto& anim : parsedData_.meshData.animations) {
-        if (anim.keyframes.empty() && anim.boneKeyframes.empty()) {
+        if (anim.GetKeyCount() == 0) {
             AddParseWarning("Animation '" + anim.name + "' has no keyframes");
         }
 
@@ -897,26 +1653,20 @@ void XFileParser::ResetParserState() {
     lineNumber_ = 0;
     currentState_ = ParseState::HEADER;
     parsedData_ = XFileData();
-    templates_.clear();
+    fileTicksPerSecond_ = 0.0f;
+    ReleaseParseArena();
+    arena_.ResetPeak();
 }
 
-bool XFileParser::IsNumeric(const std::string& str) {
-    if (str.empty()) return false;
-
-    size_t start = 0;
-    if (str[0] == '-' || str[0] == '+') start = 1;
-
-    bool hasDecimal = false;
-    for (size_t i = start; i < str.size(); i++) {
-        if (str[i] == '.') {
-            if (hasDecimal) return false;
-            hasDecimal = true;
-        } else if (!std::isdigit(str[i])) {
-            return false;
-        }
-    }
-
-    return true;
+void XFileParser::ReleaseParseArena() {
+    // Containers must not hold arena memory when it is released; vectors
+    // keep their capacity after clear(), so swap in empty ones
+    std::pmr::vector<XDataObject*>(arena_.Resource()).swap(dataObjects_);
+    std::pmr::vector<PendingSkinWeights>(arena_.Resource()).swap(pendingSkinWeights_);
+    std::pmr::vector<uint8_t>(arena_.Resource()).swap(boneFields_);
+    templates_.clear();
+    materialLibrary_.clear();
+    arena_.Release();
 }
 
 std::string XFileParser::DataObjectTypeToString(XDataObjectType type) {
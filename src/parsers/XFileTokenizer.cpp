@@ -0,0 +1,307 @@
+#include "XFileTokenizer.h"
+#include <charconv>
+
+namespace X2FBX {
+
+namespace {
+
+inline bool IsIdentifierStart(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_';
+}
+
+inline bool IsIdentifierChar(char c) {
+    // Exporters commonly emit '-' and '.' inside frame and material names
+    return IsIdentifierStart(c) || (c >= '0' && c <= '9') || c == '-' || c == '.';
+}
+
+inline bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+XFileTokenizer::XFileTokenizer(std::string_view input, size_t startLine)
+    : begin_(input.data())
+    , cur_(input.data())
+    , end_(input.data() + input.size())
+    , line_(startLine)
+    , hasLookahead_(false) {
+}
+
+XToken XFileTokenizer::Next() {
+    if (hasLookahead_) {
+        hasLookahead_ = false;
+        return lookahead_;
+    }
+    return Lex();
+}
+
+const XToken& XFileTokenizer::Peek() {
+    if (!hasLookahead_) {
+        lookahead_ = Lex();
+        hasLookahead_ = true;
+    }
+    return lookahead_;
+}
+
+bool XFileTokenizer::Accept(XTokenType type) {
+    if (Peek().type == type) {
+        hasLookahead_ = false;
+        return true;
+    }
+    return false;
+}
+
+void XFileTokenizer::SkipSeparators() {
+    while (Accept(XTokenType::SEPARATOR)) {
+    }
+}
+
+bool XFileTokenizer::ReadInt(int& value) {
+    SkipSeparators();
+    if (Peek().type != XTokenType::NUMBER) {
+        return false;
+    }
+    XToken token = Next();
+    if (ParseInt(token.text, value)) {
+        return true;
+    }
+
+    // Some exporters write counts and indices as "3.000000"
+    float asFloat = 0.0f;
+    if (ParseFloat(token.text, asFloat)) {
+        value = static_cast<int>(asFloat);
+        return true;
+    }
+    return false;
+}
+
+bool XFileTokenizer::ReadUInt(uint32_t& value) {
+    int signedValue = 0;
+    if (!ReadInt(signedValue) || signedValue < 0) {
+        return false;
+    }
+    value = static_cast<uint32_t>(signedValue);
+    return true;
+}
+
+bool XFileTokenizer::ReadFloat(float& value) {
+    SkipSeparators();
+    if (Peek().type != XTokenType::NUMBER) {
+        return false;
+    }
+    return ParseFloat(Next().text, value);
+}
+
+bool XFileTokenizer::ReadString(std::string_view& value) {
+    SkipSeparators();
+    if (Peek().type != XTokenType::STRING) {
+        return false;
+    }
+    value = Next().text;
+    return true;
+}
+
+bool XFileTokenizer::SkipBlock() {
+    int depth = 1;
+    while (depth > 0) {
+        XToken token = Next();
+        switch (token.type) {
+            case XTokenType::OPEN_BRACE: depth++; break;
+            case XTokenType::CLOSE_BRACE: depth--; break;
+            case XTokenType::END: return false;
+            default: break;
+        }
+    }
+    return true;
+}
+
+bool XFileTokenizer::ScanBlock() {
+    int depth = 1;
+    if (hasLookahead_) {
+        XToken token = Next();
+        if (token.Is(XTokenType::CLOSE_BRACE)) {
+            return true;
+        }
+        if (token.Is(XTokenType::END)) {
+            return false;
+        }
+        if (token.Is(XTokenType::OPEN_BRACE)) {
+            depth++;
+        }
+    }
+
+    while (cur_ < end_) {
+        char c = *cur_++;
+        switch (c) {
+            case '{':
+                depth++;
+                break;
+            case '}':
+                if (--depth == 0) {
+                    return true;
+                }
+                break;
+            case '\n':
+                line_++;
+                break;
+            case '"':
+                while (cur_ < end_ && *cur_ != '"') {
+                    if (*cur_ == '\n') line_++;
+                    cur_++;
+                }
+                if (cur_ < end_) cur_++;
+                break;
+            case '<':
+                while (cur_ < end_ && *cur_ != '>') {
+                    cur_++;
+                }
+                if (cur_ < end_) cur_++;
+                break;
+            case '#':
+                while (cur_ < end_ && *cur_ != '\n') {
+                    cur_++;
+                }
+                break;
+            case '/':
+                if (cur_ < end_ && *cur_ == '/') {
+                    while (cur_ < end_ && *cur_ != '\n') {
+                        cur_++;
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+size_t XFileTokenizer::GetOffset() const {
+    const char* pos = hasLookahead_ && lookahead_.text.data() ? lookahead_.text.data() : cur_;
+    return static_cast<size_t>(pos - begin_);
+}
+
+std::string_view XFileTokenizer::Slice(size_t from, size_t to) const {
+    size_t size = GetSize();
+    from = from < size ? from : size;
+    to = to < size ? to : size;
+    return from < to ? std::string_view(begin_ + from, to - from) : std::string_view();
+}
+
+bool XFileTokenizer::ParseInt(std::string_view text, int& value) {
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+    if (first != last && *first == '+') {
+        first++;
+    }
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+bool XFileTokenizer::ParseFloat(std::string_view text, float& value) {
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+    if (first != last && *first == '+') {
+        first++;
+    }
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+void XFileTokenizer::SkipWhitespaceAndComments() {
+    while (cur_ < end_) {
+        char c = *cur_;
+        if (c == '\n') {
+            line_++;
+            cur_++;
+        } else if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+            cur_++;
+        } else if (c == '#' || (c == '/' && cur_ + 1 < end_ && cur_[1] == '/')) {
+            while (cur_ < end_ && *cur_ != '\n') {
+                cur_++;
+            }
+        } else {
+            break;
+        }
+    }
+}
+
+XToken XFileTokenizer::Lex() {
+    SkipWhitespaceAndComments();
+
+    XToken token;
+    token.line = line_;
+    if (cur_ >= end_) {
+        token.type = XTokenType::END;
+        return token;
+    }
+
+    const char* start = cur_;
+    char c = *cur_;
+
+    switch (c) {
+        case '{': token.type = XTokenType::OPEN_BRACE; cur_++; break;
+        case '}': token.type = XTokenType::CLOSE_BRACE; cur_++; break;
+        case '[': token.type = XTokenType::OPEN_BRACKET; cur_++; break;
+        case ']': token.type = XTokenType::CLOSE_BRACKET; cur_++; break;
+        case ';':
+        case ',': token.type = XTokenType::SEPARATOR; cur_++; break;
+
+        case '"': {
+            const char* content = ++cur_;
+            while (cur_ < end_ && *cur_ != '"') {
+                if (*cur_ == '\n') line_++;
+                cur_++;
+            }
+            token.type = XTokenType::STRING;
+            token.text = std::string_view(content, static_cast<size_t>(cur_ - content));
+            if (cur_ < end_) cur_++; // closing quote
+            return token;
+        }
+
+        case '<': {
+            const char* content = ++cur_;
+            while (cur_ < end_ && *cur_ != '>') {
+                cur_++;
+            }
+            token.type = XTokenType::GUID;
+            token.text = std::string_view(content, static_cast<size_t>(cur_ - content));
+            if (cur_ < end_) cur_++; // closing bracket
+            return token;
+        }
+
+        default:
+            if (IsDigit(c) || c == '-' || c == '+' ||
+                (c == '.' && cur_ + 1 < end_ && IsDigit(cur_[1]))) {
+                cur_++;
+                while (cur_ < end_) {
+                    char d = *cur_;
+                    if (IsDigit(d) || d == '.') {
+                        cur_++;
+                    } else if ((d == 'e' || d == 'E') && cur_ + 1 < end_ &&
+                               (IsDigit(cur_[1]) || cur_[1] == '-' || cur_[1] == '+')) {
+                        cur_ += 2;
+                    } else {
+                        break;
+                    }
+                }
+                token.type = XTokenType::NUMBER;
+            } else if (IsIdentifierStart(c)) {
+                cur_++;
+                while (cur_ < end_ && IsIdentifierChar(*cur_)) {
+                    cur_++;
+                }
+                token.type = XTokenType::IDENTIFIER;
+            } else {
+                token.type = XTokenType::INVALID;
+                cur_++;
+            }
+            break;
+    }
+
+    token.text = std::string_view(start, static_cast<size_t>(cur_ - start));
+    return token;
+}
+
+} // namespace X2FBX
@@ -0,0 +1,100 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace X2FBX {
+
+namespace AllocationTracker {
+
+namespace {
+
+std::atomic<bool> tracking(false);
+std::atomic<size_t> threshold(0);
+std::atomic<uint64_t> allocations(0);
+std::atomic<uint64_t> bytes(0);
+std::atomic<uint64_t> largeAllocations(0);
+std::atomic<uint64_t> largestBytes(0);
+
+} // namespace
+
+// Called by the replaced operator new; one relaxed load when not tracking
+void Record(size_t size) {
+    if (!tracking.load(std::memory_order_relaxed)) {
+        return;
+    }
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    if (size >= threshold.load(std::memory_order_relaxed)) {
+        largeAllocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t largest = largestBytes.load(std::memory_order_relaxed);
+    while (size > largest && !largestBytes.compare_exchange_weak(largest, size, std::memory_order_relaxed)) {
+    }
+}
+
+bool IsAvailable() {
+#ifdef X2FBX_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Start(size_t largeThreshold) {
+    tracking.store(false, std::memory_order_relaxed);
+    threshold.store(largeThreshold, std::memory_order_relaxed);
+    allocations.store(0, std::memory_order_relaxed);
+    bytes.store(0, std::memory_order_relaxed);
+    largeAllocations.store(0, std::memory_order_relaxed);
+    largestBytes.store(0, std::memory_order_relaxed);
+    tracking.store(true, std::memory_order_seq_cst);
+}
+
+Stats Stop() {
+    tracking.store(false, std::memory_order_seq_cst);
+    Stats stats;
+    stats.allocations = allocations.load(std::memory_order_relaxed);
+    stats.bytes = bytes.load(std::memory_order_relaxed);
+    stats.largeAllocations = largeAllocations.load(std::memory_order_relaxed);
+    stats.largestBytes = largestBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace AllocationTracker
+
+} // namespace X2FBX
+
+#ifdef X2FBX_TRACK_ALLOCATIONS
+
+// Aligned and nothrow forms keep their defaults; the containers the
+// pipeline hands along all go through these two
+void* operator new(std::size_t size) {
+    X2FBX::AllocationTracker::Record(size);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+#endif
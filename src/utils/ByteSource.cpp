@@ -0,0 +1,359 @@
+#include "ByteSource.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_BZIP2
+#include <bzlib.h>
+#endif
+
+namespace X2FBX {
+
+// =============================================================================
+// MemoryByteSource
+// =============================================================================
+
+size_t MemoryByteSource::Read(uint8_t* buffer, size_t maxBytes) {
+    size_t count = std::min(maxBytes, data_.size() - position_);
+    if (count > 0) {
+        std::memcpy(buffer, data_.data() + position_, count);
+        position_ += count;
+        bytesProduced_ += count;
+    }
+    return count;
+}
+
+// =============================================================================
+// InflateByteSource
+// =============================================================================
+
+#ifdef HAVE_ZLIB
+struct InflateByteSource::State {
+    z_stream stream;
+    bool initialized = false;
+    bool finished = false;
+};
+#else
+struct InflateByteSource::State {};
+#endif
+
+InflateByteSource::InflateByteSource(ByteView compressed, int windowBits)
+    : state_(std::make_unique<State>()) {
+#ifdef HAVE_ZLIB
+    std::memset(&state_->stream, 0, sizeof(z_stream));
+    state_->stream.next_in = const_cast<Bytef*>(compressed.data());
+    state_->stream.avail_in = static_cast<uInt>(compressed.size());
+
+    int result = inflateInit2(&state_->stream, windowBits);
+    if (result != Z_OK) {
+        error_ = "inflateInit2 failed: " + std::to_string(result);
+        return;
+    }
+    state_->initialized = true;
+#else
+    (void)compressed;
+    (void)windowBits;
+    error_ = "zlib support not compiled in";
+#endif
+}
+
+InflateByteSource::~InflateByteSource() {
+#ifdef HAVE_ZLIB
+    if (state_->initialized) {
+        inflateEnd(&state_->stream);
+    }
+#endif
+}
+
+size_t InflateByteSource::Read(uint8_t* buffer, size_t maxBytes) {
+#ifdef HAVE_ZLIB
+    if (!state_->initialized || state_->finished || HasError() || maxBytes == 0) {
+        return 0;
+    }
+
+    z_stream& stream = state_->stream;
+    stream.next_out = buffer;
+    stream.avail_out = static_cast<uInt>(std::min<size_t>(maxBytes, 1u << 30));
+
+    int result = inflate(&stream, Z_NO_FLUSH);
+    size_t produced = static_cast<size_t>(stream.next_out - buffer);
+
+    if (result == Z_STREAM_END) {
+        state_->finished = true;
+    } else if (result == Z_BUF_ERROR && stream.avail_in == 0) {
+        error_ = "Truncated deflate stream";
+    } else if (result != Z_OK && result != Z_BUF_ERROR) {
+        error_ = "inflate failed: " + std::to_string(result) + (stream.msg ? std::string(" (") + stream.msg + ")" : "");
+    }
+
+    bytesProduced_ += produced;
+    return produced;
+#else
+    (void)buffer;
+    (void)maxBytes;
+    return 0;
+#endif
+}
+
+bool InflateByteSource::IsAvailable() {
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+// =============================================================================
+// Bzip2ByteSource
+// =============================================================================
+
+#ifdef HAVE_BZIP2
+struct Bzip2ByteSource::State {
+    bz_stream stream;
+    bool initialized = false;
+    bool finished = false;
+};
+#else
+struct Bzip2ByteSource::State {};
+#endif
+
+Bzip2ByteSource::Bzip2ByteSource(ByteView compressed)
+    : state_(std::make_unique<State>()) {
+#ifdef HAVE_BZIP2
+    std::memset(&state_->stream, 0, sizeof(bz_stream));
+    state_->stream.next_in = const_cast<char*>(reinterpret_cast<const char*>(compressed.data()));
+    state_->stream.avail_in = static_cast<unsigned int>(compressed.size());
+
+    int result = BZ2_bzDecompressInit(&state_->stream, 0, 0);
+    if (result != BZ_OK) {
+        error_ = "BZ2_bzDecompressInit failed: " + std::to_string(result);
+        return;
+    }
+    state_->initialized = true;
+#else
+    (void)compressed;
+    error_ = "bzip2 support not compiled in";
+#endif
+}
+
+Bzip2ByteSource::~Bzip2ByteSource() {
+#ifdef HAVE_BZIP2
+    if (state_->initialized) {
+        BZ2_bzDecompressEnd(&state_->stream);
+    }
+#endif
+}
+
+size_t Bzip2ByteSource::Read(uint8_t* buffer, size_t maxBytes) {
+#ifdef HAVE_BZIP2
+    if (!state_->initialized || state_->finished || HasError() || maxBytes == 0) {
+        return 0;
+    }
+
+    bz_stream& stream = state_->stream;
+    stream.next_out = reinterpret_cast<char*>(buffer);
+    stream.avail_out = static_cast<unsigned int>(std::min<size_t>(maxBytes, 1u << 30));
+
+    int result = BZ2_bzDecompress(&stream);
+    size_t produced = static_cast<size_t>(reinterpret_cast<uint8_t*>(stream.next_out) - buffer);
+
+    if (result == BZ_STREAM_END) {
+        state_->finished = true;
+    } else if (result != BZ_OK) {
+        error_ = "BZ2_bzDecompress failed: " + std::to_string(result);
+    } else if (produced == 0 && stream.avail_in == 0) {
+        error_ = "Truncated bzip2 stream";
+    }
+
+    bytesProduced_ += produced;
+    return produced;
+#else
+    (void)buffer;
+    (void)maxBytes;
+    return 0;
+#endif
+}
+
+bool Bzip2ByteSource::IsAvailable() {
+#ifdef HAVE_BZIP2
+    return true;
+#else
+    return false;
+#endif
+}
+
+// =============================================================================
+// ThreadedByteSource
+// =============================================================================
+
+ThreadedByteSource::ThreadedByteSource(std::unique_ptr<ByteSource> inner, size_t chunkSize, size_t maxChunks)
+    : inner_(std::move(inner)),
+      chunkSize_(std::max<size_t>(chunkSize, 4096)),
+      maxChunks_(std::max<size_t>(maxChunks, 1)),
+      finished_(false),
+      cancelled_(false),
+      currentPosition_(0) {
+    worker_ = std::thread(&ThreadedByteSource::Produce, this);
+}
+
+ThreadedByteSource::~ThreadedByteSource() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+    }
+    consumed_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void ThreadedByteSource::Produce() {
+    while (true) {
+        std::vector<uint8_t> chunk(chunkSize_);
+        size_t filled = 0;
+        while (filled < chunk.size()) {
+            size_t count = inner_->Read(chunk.data() + filled, chunk.size() - filled);
+            if (count == 0) break;
+            filled += count;
+        }
+        chunk.resize(filled);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        consumed_.wait(lock, [this] { return cancelled_ || chunks_.size() < maxChunks_; });
+        if (cancelled_) {
+            return;
+        }
+        if (!chunk.empty()) {
+            chunks_.push_back(std::move(chunk));
+        }
+        if (filled == 0) {
+            finished_ = true;
+            innerError_ = inner_->GetError();
+            lock.unlock();
+            produced_.notify_all();
+            return;
+        }
+        lock.unlock();
+        produced_.notify_all();
+    }
+}
+
+size_t ThreadedByteSource::Read(uint8_t* buffer, size_t maxBytes) {
+    size_t total = 0;
+
+    while (total < maxBytes) {
+        if (currentPosition_ >= current_.size()) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            produced_.wait(lock, [this] { return !chunks_.empty() || finished_; });
+            if (chunks_.empty()) {
+                if (!innerError_.empty()) {
+                    error_ = innerError_;
+                }
+                break;
+            }
+            current_ = std::move(chunks_.front());
+            chunks_.pop_front();
+            currentPosition_ = 0;
+            lock.unlock();
+            consumed_.notify_one();
+        }
+
+        size_t count = std::min(maxBytes - total, current_.size() - currentPosition_);
+        std::memcpy(buffer + total, current_.data() + currentPosition_, count);
+        currentPosition_ += count;
+        total += count;
+    }
+
+    bytesProduced_ += total;
+    return total;
+}
+
+// =============================================================================
+// LimitedByteSource
+// =============================================================================
+
+LimitedByteSource::LimitedByteSource(std::unique_ptr<ByteSource> inner, uint64_t maxBytes,
+                                     std::chrono::steady_clock::time_point deadline,
+                                     size_t checkBytes, PrefixCheck check)
+    : inner_(std::move(inner)), maxBytes_(maxBytes), deadline_(deadline), checkBytes_(checkBytes),
+      check_(std::move(check)), checked_(!check_ || checkBytes == 0), prefixPosition_(0) {
+}
+
+bool LimitedByteSource::CheckPrefix() {
+    checked_ = true;
+    prefix_.resize(checkBytes_);
+    size_t filled = 0;
+    while (filled < prefix_.size()) {
+        size_t count = inner_->Read(prefix_.data() + filled, prefix_.size() - filled);
+        if (count == 0) {
+            break;
+        }
+        filled += count;
+    }
+    prefix_.resize(filled);
+    if (inner_->HasError()) {
+        error_ = inner_->GetError();
+        return false;
+    }
+    return check_(ByteView(prefix_), error_);
+}
+
+size_t LimitedByteSource::Read(uint8_t* buffer, size_t maxBytes) {
+    if (HasError() || (!checked_ && !CheckPrefix())) {
+        return 0;
+    }
+    if (std::chrono::steady_clock::now() > deadline_) {
+        error_ = "decompression ran past its time limit";
+        return 0;
+    }
+
+    size_t count = 0;
+    if (prefixPosition_ < prefix_.size()) {
+        count = std::min(maxBytes, prefix_.size() - prefixPosition_);
+        std::memcpy(buffer, prefix_.data() + prefixPosition_, count);
+        prefixPosition_ += count;
+    } else {
+        count = inner_->Read(buffer, maxBytes);
+        if (count == 0 && inner_->HasError()) {
+            error_ = inner_->GetError();
+        }
+    }
+
+    bytesProduced_ += count;
+    if (maxBytes_ > 0 && bytesProduced_ > maxBytes_) {
+        error_ = "decompressed data exceeds the limit of " + std::to_string(maxBytes_) + " bytes";
+        return 0;
+    }
+    return count;
+}
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+bool ReadAllBytes(ByteSource& source, std::vector<uint8_t>& output, size_t sizeHint) {
+    output.clear();
+    return AppendAllBytes(source, output, sizeHint);
+}
+
+bool AppendAllBytes(ByteSource& source, std::vector<uint8_t>& output, size_t sizeHint) {
+    size_t total = output.size();
+    output.resize(total + std::max<size_t>(sizeHint, 64 * 1024));
+
+    while (true) {
+        if (total == output.size()) {
+            output.resize(output.size() * 2);
+        }
+        size_t count = source.Read(output.data() + total, output.size() - total);
+        if (count == 0) break;
+        total += count;
+    }
+
+    output.resize(total);
+    return !source.HasError();
+}
+
+} // namespace X2FBX
@@ -0,0 +1,374 @@
+#include "ConversionMetrics.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace X2FBX {
+
+struct MetricsWorkerState {
+    size_t id = 0;
+    bool inUse = false;                 // Guarded by ConversionMetrics::workersMutex_
+    std::atomic<int> stage{static_cast<int>(ConversionStage::IDLE)};
+    std::atomic<uint64_t> fileStartTicks{0};
+    std::atomic<uint64_t> stageStartTicks{0};
+    std::atomic<uint64_t> lastProgressTicks{0};
+    std::atomic<uint64_t> files{0};
+    std::atomic<uint64_t> busyNanoseconds{0};
+    std::mutex fileMutex;
+    std::string file;
+};
+
+namespace {
+
+constexpr size_t STAGE_COUNT = static_cast<size_t>(ConversionStage::COUNT);
+
+// The worker converting on this thread, for progress marks
+thread_local MetricsWorkerState* currentWorker = nullptr;
+
+double Seconds(uint64_t nanoseconds) {
+    return nanoseconds / 1e9;
+}
+
+std::string EscapeLabel(const std::string& text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            default:   escaped += c;
+        }
+    }
+    return escaped;
+}
+
+void WriteHeader(std::ostream& out, const char* name, const char* type, const char* help) {
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " " << type << "\n";
+}
+
+template <typename T>
+void WriteMetric(std::ostream& out, const char* name, const char* type, const char* help, T value) {
+    WriteHeader(out, name, type, help);
+    out << name << " " << value << "\n";
+}
+
+} // namespace
+
+const char* ConversionStageName(ConversionStage stage) {
+    switch (stage) {
+        case ConversionStage::IDLE: return "idle";
+        case ConversionStage::CACHE: return "cache";
+        case ConversionStage::PARSE: return "parse";
+        case ConversionStage::PREPARE: return "prepare";
+        case ConversionStage::EXPORT: return "export";
+        default: return "unknown";
+    }
+}
+
+ConversionMetrics::ConversionMetrics()
+    : origin_(std::chrono::steady_clock::now())
+    , bytesRead_(0)
+    , bytesDecompressed_(0)
+    , objectsParsed_(0)
+    , keysExported_(0)
+    , filesQueued_(0)
+    , filesStarted_(0)
+    , filesConverted_(0)
+    , filesFailed_(0) {
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        stageNanoseconds_[i] = 0;
+        stageRuns_[i] = 0;
+    }
+}
+
+ConversionMetrics::~ConversionMetrics() = default;
+
+ConversionMetrics& ConversionMetrics::GetInstance() {
+    static ConversionMetrics instance;
+    return instance;
+}
+
+uint64_t ConversionMetrics::NowTicks() const {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin_).count());
+}
+
+void ConversionMetrics::AddBytesRead(uint64_t bytes) {
+    bytesRead_.fetch_add(bytes, std::memory_order_relaxed);
+    if (currentWorker) {
+        currentWorker->lastProgressTicks.store(NowTicks(), std::memory_order_relaxed);
+    }
+}
+
+void ConversionMetrics::AddBytesDecompressed(uint64_t bytes) {
+    bytesDecompressed_.fetch_add(bytes, std::memory_order_relaxed);
+    if (currentWorker) {
+        currentWorker->lastProgressTicks.store(NowTicks(), std::memory_order_relaxed);
+    }
+}
+
+void ConversionMetrics::AddObjectsParsed(uint64_t objects) {
+    objectsParsed_.fetch_add(objects, std::memory_order_relaxed);
+    if (currentWorker) {
+        currentWorker->lastProgressTicks.store(NowTicks(), std::memory_order_relaxed);
+    }
+}
+
+void ConversionMetrics::AddKeysExported(uint64_t keys) {
+    keysExported_.fetch_add(keys, std::memory_order_relaxed);
+    if (currentWorker) {
+        currentWorker->lastProgressTicks.store(NowTicks(), std::memory_order_relaxed);
+    }
+}
+
+void ConversionMetrics::RecordStage(ConversionStage stage, std::chrono::steady_clock::duration elapsed) {
+    size_t index = static_cast<size_t>(stage);
+    stageNanoseconds_[index].fetch_add(
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+        std::memory_order_relaxed);
+    stageRuns_[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+MetricsSnapshot ConversionMetrics::GetSnapshot() const {
+    MetricsSnapshot snapshot;
+    uint64_t now = NowTicks();
+    snapshot.uptimeSeconds = Seconds(now);
+    snapshot.bytesRead = bytesRead_.load(std::memory_order_relaxed);
+    snapshot.bytesDecompressed = bytesDecompressed_.load(std::memory_order_relaxed);
+    snapshot.objectsParsed = objectsParsed_.load(std::memory_order_relaxed);
+    snapshot.keysExported = keysExported_.load(std::memory_order_relaxed);
+    snapshot.filesQueued = filesQueued_.load(std::memory_order_relaxed);
+    snapshot.filesStarted = filesStarted_.load(std::memory_order_relaxed);
+    snapshot.filesConverted = filesConverted_.load(std::memory_order_relaxed);
+    snapshot.filesFailed = filesFailed_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < STAGE_COUNT; i++) {
+        snapshot.stageSeconds[i] = Seconds(stageNanoseconds_[i].load(std::memory_order_relaxed));
+        snapshot.stageRuns[i] = stageRuns_[i].load(std::memory_order_relaxed);
+    }
+
+    // Released slots stay listed, so their totals outlive the batch
+    std::lock_guard<std::mutex> lock(workersMutex_);
+    for (const auto& state : workers_) {
+        WorkerMetrics worker;
+        worker.id = state->id;
+        worker.stage = static_cast<ConversionStage>(state->stage.load(std::memory_order_relaxed));
+        worker.busy = worker.stage != ConversionStage::IDLE;
+        worker.files = state->files.load(std::memory_order_relaxed);
+        worker.busySeconds = Seconds(state->busyNanoseconds.load(std::memory_order_relaxed));
+        if (worker.busy) {
+            // Loaded after the stage; a file that just finished can read as
+            // a moment into the next one, never as negative time
+            uint64_t fileStart = state->fileStartTicks.load(std::memory_order_relaxed);
+            uint64_t lastProgress = state->lastProgressTicks.load(std::memory_order_relaxed);
+            worker.fileSeconds = now > fileStart ? Seconds(now - fileStart) : 0.0;
+            worker.secondsSinceProgress = now > lastProgress ? Seconds(now - lastProgress) : 0.0;
+            worker.busySeconds += worker.fileSeconds;
+            std::lock_guard<std::mutex> fileLock(state->fileMutex);
+            worker.file = state->file;
+        }
+        snapshot.workers.push_back(std::move(worker));
+    }
+    return snapshot;
+}
+
+std::string ConversionMetrics::FormatPrometheus() const {
+    MetricsSnapshot snapshot = GetSnapshot();
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(6);
+
+    WriteMetric(out, "x2fbx_uptime_seconds", "gauge", "Seconds since the process started collecting metrics.",
+                snapshot.uptimeSeconds);
+    WriteMetric(out, "x2fbx_bytes_read_total", "counter", "Input file bytes opened by the parsers.",
+                snapshot.bytesRead);
+    WriteMetric(out, "x2fbx_bytes_decompressed_total", "counter", "Bytes read out of decompression streams.",
+                snapshot.bytesDecompressed);
+    WriteMetric(out, "x2fbx_objects_parsed_total", "counter", "Top-level .x data objects parsed.",
+                snapshot.objectsParsed);
+    WriteMetric(out, "x2fbx_keys_exported_total", "counter", "Animation keys written to FBX files.",
+                snapshot.keysExported);
+    WriteMetric(out, "x2fbx_files_queued_total", "counter", "Files handed to batch conversions.",
+                snapshot.filesQueued);
+    WriteMetric(out, "x2fbx_files_started_total", "counter", "Files a worker started converting.",
+                snapshot.filesStarted);
+    WriteMetric(out, "x2fbx_files_converted_total", "counter", "Files converted successfully.",
+                snapshot.filesConverted);
+    WriteMetric(out, "x2fbx_files_failed_total", "counter", "Files that failed to convert.", snapshot.filesFailed);
+
+    WriteHeader(out, "x2fbx_stage_seconds_total", "counter", "Time workers spent in each conversion stage.");
+    for (size_t i = 1; i < STAGE_COUNT; i++) {
+        out << "x2fbx_stage_seconds_total{stage=\"" << ConversionStageName(static_cast<ConversionStage>(i)) << "\"} "
+            << snapshot.stageSeconds[i] << "\n";
+    }
+    WriteHeader(out, "x2fbx_stage_runs_total", "counter", "Times a worker entered each conversion stage.");
+    for (size_t i = 1; i < STAGE_COUNT; i++) {
+        out << "x2fbx_stage_runs_total{stage=\"" << ConversionStageName(static_cast<ConversionStage>(i)) << "\"} "
+            << snapshot.stageRuns[i] << "\n";
+    }
+
+    WriteMetric(out, "x2fbx_workers", "gauge", "Worker slots registered so far.", snapshot.workers.size());
+    WriteHeader(out, "x2fbx_worker_busy", "gauge", "1 while the worker is converting a file.");
+    for (const auto& worker : snapshot.workers) {
+        out << "x2fbx_worker_busy{worker=\"" << worker.id << "\"} " << (worker.busy ? 1 : 0) << "\n";
+    }
+    WriteHeader(out, "x2fbx_worker_stage", "gauge", "Stage and input of the file a busy worker is on.");
+    for (const auto& worker : snapshot.workers) {
+        if (worker.busy) {
+            out << "x2fbx_worker_stage{worker=\"" << worker.id << "\",stage=\"" << ConversionStageName(worker.stage)
+                << "\",file=\"" << EscapeLabel(worker.file) << "\"} 1\n";
+        }
+    }
+    WriteHeader(out, "x2fbx_worker_file_seconds", "gauge", "Time the worker has spent on its current file.");
+    for (const auto& worker : snapshot.workers) {
+        out << "x2fbx_worker_file_seconds{worker=\"" << worker.id << "\"} " << worker.fileSeconds << "\n";
+    }
+    WriteHeader(out, "x2fbx_worker_seconds_since_progress", "gauge",
+                "Time since a busy worker last read, decompressed, parsed or exported anything.");
+    for (const auto& worker : snapshot.workers) {
+        out << "x2fbx_worker_seconds_since_progress{worker=\"" << worker.id << "\"} " << worker.secondsSinceProgress
+            << "\n";
+    }
+    WriteHeader(out, "x2fbx_worker_files_total", "counter", "Files the worker finished.");
+    for (const auto& worker : snapshot.workers) {
+        out << "x2fbx_worker_files_total{worker=\"" << worker.id << "\"} " << worker.files << "\n";
+    }
+    WriteHeader(out, "x2fbx_worker_busy_seconds_total", "counter", "Time the worker spent converting files.");
+    for (const auto& worker : snapshot.workers) {
+        out << "x2fbx_worker_busy_seconds_total{worker=\"" << worker.id << "\"} " << worker.busySeconds << "\n";
+    }
+    return out.str();
+}
+
+bool ConversionMetrics::WriteFile(const std::string& path) const {
+    // Written next to the target and renamed over it, so a poller never
+    // sees a half-written file
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            return false;
+        }
+        out << FormatPrometheus();
+        if (!out) {
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temporaryPath, path, ec);
+    if (ec) {
+        fs::remove(temporaryPath, ec);
+        return false;
+    }
+    return true;
+}
+
+// MetricsWorkerSlot
+
+MetricsWorkerSlot::MetricsWorkerSlot()
+    : metrics_(ConversionMetrics::GetInstance())
+    , state_(nullptr) {
+    std::lock_guard<std::mutex> lock(metrics_.workersMutex_);
+    for (auto& state : metrics_.workers_) {
+        if (!state->inUse) {
+            state_ = state.get();
+            break;
+        }
+    }
+    if (!state_) {
+        metrics_.workers_.push_back(std::make_unique<MetricsWorkerState>());
+        state_ = metrics_.workers_.back().get();
+        state_->id = metrics_.workers_.size() - 1;
+    }
+    state_->inUse = true;
+}
+
+MetricsWorkerSlot::~MetricsWorkerSlot() {
+    if (state_->stage.load(std::memory_order_relaxed) != static_cast<int>(ConversionStage::IDLE)) {
+        EndFile(false);
+    }
+    std::lock_guard<std::mutex> lock(metrics_.workersMutex_);
+    state_->inUse = false;
+}
+
+size_t MetricsWorkerSlot::GetId() const {
+    return state_->id;
+}
+
+void MetricsWorkerSlot::BeginFile(const std::string& inputPath) {
+    {
+        std::lock_guard<std::mutex> lock(state_->fileMutex);
+        state_->file = inputPath;
+    }
+    uint64_t now = metrics_.NowTicks();
+    state_->fileStartTicks.store(now, std::memory_order_relaxed);
+    state_->lastProgressTicks.store(now, std::memory_order_relaxed);
+    metrics_.filesStarted_.fetch_add(1, std::memory_order_relaxed);
+    currentWorker = state_;
+    EnterStage(ConversionStage::CACHE);
+}
+
+void MetricsWorkerSlot::EnterStage(ConversionStage stage) {
+    uint64_t now = metrics_.NowTicks();
+    auto previous = static_cast<ConversionStage>(state_->stage.exchange(static_cast<int>(stage),
+                                                                         std::memory_order_relaxed));
+    uint64_t stageStart = state_->stageStartTicks.exchange(now, std::memory_order_relaxed);
+    if (previous != ConversionStage::IDLE) {
+        metrics_.RecordStage(previous, std::chrono::nanoseconds(now - stageStart));
+    }
+}
+
+void MetricsWorkerSlot::EndFile(bool success) {
+    EnterStage(ConversionStage::IDLE);
+    uint64_t now = metrics_.NowTicks();
+    state_->busyNanoseconds.fetch_add(now - state_->fileStartTicks.load(std::memory_order_relaxed),
+                                      std::memory_order_relaxed);
+    state_->files.fetch_add(1, std::memory_order_relaxed);
+    (success ? metrics_.filesConverted_ : metrics_.filesFailed_).fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(state_->fileMutex);
+        state_->file.clear();
+    }
+    if (currentWorker == state_) {
+        currentWorker = nullptr;
+    }
+}
+
+// MetricsFileWriter
+
+MetricsFileWriter::MetricsFileWriter(const std::string& path, double intervalSeconds)
+    : path_(path)
+    , interval_(std::chrono::milliseconds(static_cast<int64_t>(std::max(intervalSeconds, 0.1) * 1000.0)))
+    , stopping_(false) {
+    thread_ = std::thread([this]() {
+        bool warned = false;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            lock.unlock();
+            if (!ConversionMetrics::GetInstance().WriteFile(path_) && !warned) {
+                LOG_WARNING("Cannot write metrics file: " + path_);
+                warned = true;
+            }
+            lock.lock();
+            wake_.wait_for(lock, interval_, [this]() { return stopping_; });
+        }
+    });
+}
+
+MetricsFileWriter::~MetricsFileWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    thread_.join();
+    ConversionMetrics::GetInstance().WriteFile(path_);
+}
+
+} // namespace X2FBX
@@ -0,0 +1,271 @@
+#include "CoordinateKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define X2FBX_KERNELS_SSE2 1
+#endif
+
+namespace X2FBX {
+
+namespace CoordinateKernels {
+
+namespace {
+
+std::atomic<bool> scalarOnly(false);
+
+// Source row/column of output row/column k, and its sign
+constexpr int BASIS_SOURCE[4] = {0, 2, 1, 3};
+constexpr float BASIS_SIGN[4] = {1.0f, 1.0f, -1.0f, 1.0f};
+
+#ifdef X2FBX_KERNELS_SSE2
+// Flips the sign bit of lane 2
+inline __m128 NegateLane2() {
+    return _mm_castsi128_ps(_mm_set_epi32(0, static_cast<int>(0x80000000u), 0, 0));
+}
+#endif
+
+} // namespace
+
+bool UseSimd() {
+#ifdef X2FBX_KERNELS_SSE2
+    return !scalarOnly.load(std::memory_order_relaxed);
+#else
+    return false;
+#endif
+}
+
+const char* GetActiveKernels() {
+    return UseSimd() ? "SSE2" : "scalar";
+}
+
+void SetScalarOnly(bool enabled) {
+    scalarOnly.store(enabled, std::memory_order_relaxed);
+}
+
+// Scalar reference versions
+
+void Scalar::ConvertVectors(const XVector3* input, size_t count, double* output) {
+    for (size_t i = 0; i < count; ++i, output += 3) {
+        output[0] = input[i].x;
+        output[1] = input[i].z;
+        output[2] = -input[i].y;
+    }
+}
+
+void Scalar::ConvertVectors4(const XVector3* input, size_t count, double* output, double w) {
+    for (size_t i = 0; i < count; ++i, output += 4) {
+        output[0] = input[i].x;
+        output[1] = input[i].z;
+        output[2] = -input[i].y;
+        output[3] = w;
+    }
+}
+
+void Scalar::SplitVectorKeys(const float* xyz, size_t count, float* outX, float* outY, float* outZ, bool negateZ) {
+    for (size_t i = 0; i < count; ++i, xyz += 3) {
+        outX[i] = xyz[0];
+        outY[i] = xyz[2];
+        outZ[i] = negateZ ? -xyz[1] : xyz[1];
+    }
+}
+
+void Scalar::ConvertQuaternions(const float* input, size_t count, float* output) {
+    for (size_t i = 0; i < count; ++i, input += 4, output += 4) {
+        float qx = input[0];
+        float qy = input[2];
+        float qz = -input[1];
+        float qw = input[3];
+        float length = std::sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+        if (length > 0.0f) {
+            qx /= length; qy /= length; qz /= length; qw /= length;
+        } else {
+            qx = qy = qz = 0.0f;
+            qw = 1.0f;
+        }
+        output[0] = qx;
+        output[1] = qy;
+        output[2] = qz;
+        output[3] = qw;
+    }
+}
+
+void Scalar::ConvertMatrices(const XMatrix4x4* input, size_t count, XMatrix4x4* output) {
+    for (size_t i = 0; i < count; ++i) {
+        // B only permutes and negates, so B^T * M * B picks and signs
+        // elements. Adding zero turns -0 into +0 as the full product would.
+        XMatrix4x4 converted;
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                converted.m[row][column] = BASIS_SIGN[row] * BASIS_SIGN[column] *
+                                           input[i].m[BASIS_SOURCE[row]][BASIS_SOURCE[column]] + 0.0f;
+            }
+        }
+        output[i] = converted;
+    }
+}
+
+// Dispatching versions
+
+void ConvertVectors(const XVector3* input, size_t count, double* output) {
+    if (!UseSimd()) {
+        Scalar::ConvertVectors(input, count, output);
+        return;
+    }
+#ifdef X2FBX_KERNELS_SSE2
+    // A 4-float load reads one float past the vector, so the last one is scalar
+    const float* source = reinterpret_cast<const float*>(input);
+    const __m128 negate = NegateLane2();
+    size_t i = 0;
+    for (; i + 1 < count; ++i, source += 3, output += 3) {
+        __m128 v = _mm_loadu_ps(source);                                   // x y z -
+        v = _mm_xor_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 2, 0)), negate);  // x z -y -
+        _mm_storeu_pd(output, _mm_cvtps_pd(v));
+        _mm_store_sd(output + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    Scalar::ConvertVectors(input + i, count - i, output);
+#endif
+}
+
+void ConvertVectors4(const XVector3* input, size_t count, double* output, double w) {
+    if (!UseSimd()) {
+        Scalar::ConvertVectors4(input, count, output, w);
+        return;
+    }
+#ifdef X2FBX_KERNELS_SSE2
+    const float* source = reinterpret_cast<const float*>(input);
+    const __m128 negate = NegateLane2();
+    const __m128d fourth = _mm_set_sd(w);
+    size_t i = 0;
+    for (; i + 1 < count; ++i, source += 3, output += 4) {
+        __m128 v = _mm_loadu_ps(source);
+        v = _mm_xor_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 2, 0)), negate);
+        _mm_storeu_pd(output, _mm_cvtps_pd(v));
+        _mm_storeu_pd(output + 2, _mm_unpacklo_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), fourth));
+    }
+    Scalar::ConvertVectors4(input + i, count - i, output, w);
+#endif
+}
+
+void SplitVectorKeys(const float* xyz, size_t count, float* outX, float* outY, float* outZ, bool negateZ) {
+    if (!UseSimd()) {
+        Scalar::SplitVectorKeys(xyz, count, outX, outY, outZ, negateZ);
+        return;
+    }
+#ifdef X2FBX_KERNELS_SSE2
+    // Four keys per step: three loads deinterleaved into x, y and z lanes
+    const __m128 sign = negateZ ? _mm_set1_ps(-0.0f) : _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, xyz += 12) {
+        const __m128 m0 = _mm_loadu_ps(xyz);         // x0 y0 z0 x1
+        const __m128 m1 = _mm_loadu_ps(xyz + 4);     // y1 z1 x2 y2
+        const __m128 m2 = _mm_loadu_ps(xyz + 8);     // z2 x3 y3 z3
+
+        const __m128 x = _mm_shuffle_ps(m0, _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        const __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(m0, m1, _MM_SHUFFLE(0, 0, 1, 1)),
+                                        _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 1, 2, 2)),
+                                        _mm_shuffle_ps(m2, m2, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        _mm_storeu_ps(outX + i, x);
+        _mm_storeu_ps(outY + i, z);
+        _mm_storeu_ps(outZ + i, _mm_xor_ps(y, sign));
+    }
+    Scalar::SplitVectorKeys(xyz, count - i, outX + i, outY + i, outZ + i, negateZ);
+#endif
+}
+
+void ConvertQuaternions(const float* input, size_t count, float* output) {
+    if (!UseSimd()) {
+        Scalar::ConvertQuaternions(input, count, output);
+        return;
+    }
+#ifdef X2FBX_KERNELS_SSE2
+    const __m128 negate = NegateLane2();
+    const __m128 identity = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    for (size_t i = 0; i < count; ++i, input += 4, output += 4) {
+        __m128 q = _mm_loadu_ps(input);
+        q = _mm_xor_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 1, 2, 0)), negate);   // x z -y w
+
+        // Summed in the scalar order, ((x² + y²) + z²) + w², so the
+        // length is bit-identical
+        const __m128 squares = _mm_mul_ps(q, q);
+        __m128 sum = _mm_add_ss(squares, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(1, 1, 1, 1)));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(2, 2, 2, 2)));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(3, 3, 3, 3)));
+        const __m128 length = _mm_sqrt_ss(sum);
+
+        if (_mm_cvtss_f32(length) > 0.0f) {
+            q = _mm_div_ps(q, _mm_shuffle_ps(length, length, _MM_SHUFFLE(0, 0, 0, 0)));
+        } else {
+            q = identity;
+        }
+        _mm_storeu_ps(output, q);
+    }
+#endif
+}
+
+void ConvertMatrices(const XMatrix4x4* input, size_t count, XMatrix4x4* output) {
+    if (!UseSimd()) {
+        Scalar::ConvertMatrices(input, count, output);
+        return;
+    }
+#ifdef X2FBX_KERNELS_SSE2
+    // Output row r is source row BASIS_SOURCE[r] with its columns
+    // permuted the same way, signed by BASIS_SIGN[r] * BASIS_SIGN[column],
+    // plus zero like the scalar version
+    const __m128 columnSign = NegateLane2();
+    const __m128 rowSign = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+    for (size_t i = 0; i < count; ++i) {
+        const __m128 r0 = _mm_loadu_ps(input[i].m[0]);
+        const __m128 r1 = _mm_loadu_ps(input[i].m[1]);
+        const __m128 r2 = _mm_loadu_ps(input[i].m[2]);
+        const __m128 r3 = _mm_loadu_ps(input[i].m[3]);
+        auto permute = [&](__m128 row, __m128 sign) {
+            row = _mm_xor_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 1, 2, 0)), columnSign);
+            return _mm_add_ps(_mm_xor_ps(row, sign), zero);
+        };
+        _mm_storeu_ps(output[i].m[0], permute(r0, zero));
+        _mm_storeu_ps(output[i].m[1], permute(r2, zero));
+        _mm_storeu_ps(output[i].m[2], permute(r1, rowSign));
+        _mm_storeu_ps(output[i].m[3], permute(r3, zero));
+    }
+#endif
+}
+
+uint32_t TrianglesToPolygonIndices(const int* indices, size_t indexCount, int32_t* output, bool reverseWinding) {
+    // Plain loops; compilers vectorize the stride-3 pattern well enough
+    // that this never shows up next to the geometry conversion. The range
+    // check rides along in the same pass.
+    const size_t triangleEnd = indexCount - indexCount % 3;
+    uint32_t largest = 0;
+    auto copy = [&](size_t to, size_t from) {
+        largest = std::max(largest, static_cast<uint32_t>(indices[from]));
+        output[to] = indices[from];
+    };
+    if (reverseWinding) {
+        for (size_t i = 0; i < triangleEnd; i += 3) {
+            copy(i, i);
+            copy(i + 1, i + 2);
+            copy(i + 2, i + 1);
+            output[i + 2] = ~output[i + 2];
+        }
+    } else {
+        for (size_t i = 0; i < triangleEnd; i += 3) {
+            copy(i, i);
+            copy(i + 1, i + 1);
+            copy(i + 2, i + 2);
+            output[i + 2] = ~output[i + 2];
+        }
+    }
+    for (size_t i = triangleEnd; i < indexCount; ++i) {
+        copy(i, i);
+    }
+    return largest;
+}
+
+} // namespace CoordinateKernels
+
+} // namespace X2FBX
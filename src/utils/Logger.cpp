@@ -1,45 +1,144 @@
 #include "Logger.h"
+#include "Profiler.h"
 #include <iostream>
+#include <cmath>
+#include <cstddef>
 #include <iomanip>
 #include <sstream>
 
 namespace X2FBX {
 
-// Static members initialization
-std::unique_ptr<Logger> Logger::instance_ = nullptr;
-std::mutex Logger::mutex_;
+namespace {
+
+// Slots in the message ring; producers wait for the writer when it fills
+constexpr size_t QUEUE_CAPACITY = 4096;
+
+// Messages moved out of the ring per batch write
+constexpr size_t MAX_BATCH = 256;
+
+// The writer also wakes on its own, bounding the delay of a missed wakeup
+constexpr auto WRITER_IDLE_WAIT = std::chrono::milliseconds(50);
+
+} // namespace
+
+struct LogRecord {
+    LogLevel level = LogLevel::INFO;
+    std::chrono::system_clock::time_point time;
+    std::string message;
+    std::string file;                   // Only kept for DEBUG, the one level that prints it
+    int line = -1;
+    bool toConsole = false;             // Sinks are chosen when the message is logged
+    bool toFile = false;
+};
+
+// Bounded multi-producer single-consumer ring. Each slot carries a sequence
+// number telling producers and the writer whose turn it is, so neither side
+// takes a lock.
+class LogRingBuffer {
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        LogRecord record;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> enqueuePos_;
+    alignas(64) size_t dequeuePos_;     // Writer thread only
+
+public:
+    explicit LogRingBuffer(size_t capacity)
+        : slots_(new Slot[capacity])
+        , mask_(capacity - 1)
+        , enqueuePos_(0)
+        , dequeuePos_(0) {
+        for (size_t i = 0; i < capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool TryPush(LogRecord& record) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record = std::move(record);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;           // Full
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool TryPop(LogRecord& record) {
+        Slot& slot = slots_[dequeuePos_ & mask_];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != dequeuePos_ + 1) {
+            return false;               // Empty, or the producer is still copying in
+        }
+        record = std::move(slot.record);
+        slot.sequence.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+        dequeuePos_++;
+        return true;
+    }
+};
 
 Logger::Logger()
-    : currentLevel_(LogLevel::INFO)
+    : currentLevel_(static_cast<int>(LogLevel::INFO))
     , enableConsole_(true)
     , enableFile_(true)
-    , logFilePath_("x2fbx_converter.log") {
+    , logFilePath_("x2fbx_converter.log")
+    , queue_(new LogRingBuffer(QUEUE_CAPACITY))
+    , writerSleeping_(false)
+    , stopping_(false)
+    , enqueued_(0)
+    , written_(0) {
+    writer_ = std::thread(&Logger::WriterLoop, this);
 }
 
 Logger::~Logger() {
+    // The writer drains everything still queued before it exits
+    stopping_.store(true);
+    WakeWriter();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
     if (logFile_.is_open()) {
         logFile_.close();
     }
 }
 
 Logger& Logger::GetInstance() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (instance_ == nullptr) {
-        instance_ = std::unique_ptr<Logger>(new Logger());
-    }
-    return *instance_;
+    // Function-local static: thread-safe construction without a lock per call
+    static Logger instance;
+    return instance;
 }
 
 void Logger::Initialize(const std::string& logFilePath, LogLevel level) {
     Logger& logger = GetInstance();
-    logger.logFilePath_ = logFilePath;
-    logger.currentLevel_ = level;
-
-    if (logger.enableFile_) {
-        logger.logFile_.open(logFilePath, std::ios::out | std::ios::app);
-        if (!logger.logFile_.is_open()) {
-            std::cerr << "Warning: Could not open log file: " << logFilePath << std::endl;
-            logger.enableFile_ = false;
+    logger.SetLogLevel(level);
+
+    // Anything already queued belongs to the previous file
+    logger.Flush();
+    {
+        std::lock_guard<std::mutex> lock(logger.fileMutex_);
+        logger.logFilePath_ = logFilePath;
+        if (logger.logFile_.is_open()) {
+            logger.logFile_.close();
+        }
+        if (logger.enableFile_) {
+            logger.logFile_.open(logFilePath, std::ios::out | std::ios::app);
+            if (!logger.logFile_.is_open()) {
+                std::cerr << "Warning: Could not open log file: " << logFilePath << std::endl;
+                logger.enableFile_ = false;
+            }
         }
     }
 
@@ -49,28 +148,129 @@ void Logger::Initialize(const std::string& logFilePath, LogLevel level) {
 
 void Logger::Log(LogLevel level, const std::string& message,
                  const std::string& file, int line) {
-    if (level < currentLevel_) {
+    if (!IsEnabled(level)) {
+        return;
+    }
+    Enqueue(level, message, file, line);
+
+    // A critical message may be the last thing logged before the process dies
+    if (level == LogLevel::CRITICAL) {
+        Flush();
+    }
+}
+
+void Logger::Enqueue(LogLevel level, std::string message, const std::string& file, int line) {
+    LogRecord record;
+    record.level = level;
+    record.time = std::chrono::system_clock::now();
+    record.message = std::move(message);
+    if (level == LogLevel::DEBUG) {
+        record.file = file;
+        record.line = line;
+    }
+    record.toConsole = enableConsole_.load(std::memory_order_relaxed);
+    record.toFile = enableFile_.load(std::memory_order_relaxed);
+    if (!record.toConsole && !record.toFile) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    while (!queue_->TryPush(record)) {
+        // Ring is full: make sure the writer is running and let it catch up
+        WakeWriter();
+        std::this_thread::yield();
+    }
+    enqueued_.fetch_add(1);
+
+    if (writerSleeping_.load()) {
+        WakeWriter();
+    }
+}
+
+void Logger::WakeWriter() {
+    std::lock_guard<std::mutex> lock(wakeMutex_);
+    wakeCondition_.notify_one();
+}
+
+void Logger::WriterLoop() {
+    std::string consoleOut;
+    std::string consoleErr;
+    std::string fileOut;
+
+    for (;;) {
+        if (WriteBatch(consoleOut, consoleErr, fileOut) > 0) {
+            continue;
+        }
+
+        // Queue is empty: everything counted so far is now on its sinks
+        {
+            std::lock_guard<std::mutex> lock(fileMutex_);
+            if (logFile_.is_open()) {
+                logFile_.flush();
+            }
+        }
+        std::cout.flush();
+        std::cerr.flush();
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            drainedCondition_.notify_all();
+        }
+
+        if (stopping_.load()) {
+            // Producers that raced with shutdown may still have slipped a message in
+            if (WriteBatch(consoleOut, consoleErr, fileOut) == 0) {
+                break;
+            }
+            continue;
+        }
 
-    std::string formattedMessage = FormatLogMessage(level, message, file, line);
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        writerSleeping_.store(true);
+        wakeCondition_.wait_for(lock, WRITER_IDLE_WAIT, [this] {
+            return stopping_.load() || written_.load() < enqueued_.load();
+        });
+        writerSleeping_.store(false);
+    }
+}
 
-    // Console output
-    if (enableConsole_) {
-        if (level >= LogLevel::ERROR) {
-            std::cerr << formattedMessage << std::endl;
-        } else {
-            std::cout << formattedMessage << std::endl;
+size_t Logger::WriteBatch(std::string& consoleOut, std::string& consoleErr, std::string& fileOut) {
+    consoleOut.clear();
+    consoleErr.clear();
+    fileOut.clear();
+
+    LogRecord record;
+    size_t count = 0;
+    while (count < MAX_BATCH && queue_->TryPop(record)) {
+        std::string formatted = FormatLogMessage(record.level, record.time, record.message,
+                                                 record.file, record.line);
+        formatted += '\n';
+        if (record.toConsole) {
+            (record.level >= LogLevel::ERROR ? consoleErr : consoleOut) += formatted;
+        }
+        if (record.toFile) {
+            fileOut += formatted;
         }
+        count++;
+    }
+    if (count == 0) {
+        return 0;
     }
 
-    // File output
-    if (enableFile_ && logFile_.is_open()) {
-        logFile_ << formattedMessage << std::endl;
-        logFile_.flush();
+    // One write per sink per batch; streams are flushed once the queue runs dry
+    if (!consoleOut.empty()) {
+        std::cout.write(consoleOut.data(), static_cast<std::streamsize>(consoleOut.size()));
     }
+    if (!consoleErr.empty()) {
+        std::cerr.write(consoleErr.data(), static_cast<std::streamsize>(consoleErr.size()));
+    }
+    if (!fileOut.empty()) {
+        std::lock_guard<std::mutex> lock(fileMutex_);
+        if (logFile_.is_open()) {
+            logFile_.write(fileOut.data(), static_cast<std::streamsize>(fileOut.size()));
+        }
+    }
+
+    written_.fetch_add(count);
+    return count;
 }
 
 void Logger::Debug(const std::string& message, const std::string& file, int line) {
@@ -94,6 +294,9 @@ void Logger::Critical(const std::string& message, const std::string& file, int l
 }
 
 void Logger::LogTimingInfo(const std::string& operation, double durationMs) {
+    if (!IsEnabled(LogLevel::INFO)) {
+        return;
+    }
     std::stringstream ss;
     ss << "TIMING: " << operation << " completed in "
        << std::fixed << std::setprecision(3) << durationMs << " ms";
@@ -102,6 +305,9 @@ void Logger::LogTimingInfo(const std::string& operation, double durationMs) {
 
 void Logger::LogAnimationTiming(const std::string& animName, float originalDuration,
                                float convertedDuration, float ticksPerSecond) {
+    if (!IsEnabled(LogLevel::WARNING)) {
+        return;
+    }
     std::stringstream ss;
     ss << "ANIMATION_TIMING: '" << animName << "' - "
        << "Original: " << std::fixed << std::setprecision(3) << originalDuration << "s, "
@@ -130,7 +336,7 @@ void Logger::LogValidationResult(const std::string& component, bool isValid,
 }
 
 void Logger::LogProgress(const std::string& operation, int current, int total) {
-    if (total > 0) {
+    if (total > 0 && IsEnabled(LogLevel::INFO)) {
         float percentage = (static_cast<float>(current) / total) * 100.0f;
         std::stringstream ss;
         ss << "PROGRESS: " << operation << " - "
@@ -141,20 +347,23 @@ void Logger::LogProgress(const std::string& operation, int current, int total) {
 }
 
 void Logger::Flush() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (logFile_.is_open()) {
-        logFile_.flush();
+    if (std::this_thread::get_id() == writer_.get_id()) {
+        return;
     }
-    std::cout.flush();
-    std::cerr.flush();
+    const size_t target = enqueued_.load();
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    wakeCondition_.notify_one();
+    drainedCondition_.wait(lock, [this, target] {
+        return written_.load() >= target || !writer_.joinable();
+    });
 }
 
-std::string Logger::GetCurrentTimestamp() const {
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
+std::string Logger::FormatTimestamp(std::chrono::system_clock::time_point time) const {
+    auto time_t = std::chrono::system_clock::to_time_t(time);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+        time.time_since_epoch()) % 1000;
 
+    // localtime is only called from the writer thread
     std::stringstream ss;
     ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
     ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
@@ -173,12 +382,12 @@ std::string Logger::LogLevelToString(LogLevel level) const {
     }
 }
 
-std::string Logger::FormatLogMessage(LogLevel level, const std::string& message,
-                                    const std::string& file, int line) const {
+std::string Logger::FormatLogMessage(LogLevel level, std::chrono::system_clock::time_point time,
+                                    const std::string& message, const std::string& file, int line) const {
     std::stringstream ss;
 
     // Timestamp
-    ss << "[" << GetCurrentTimestamp() << "] ";
+    ss << "[" << FormatTimestamp(time) << "] ";
 
     // Log level
     ss << "[" << std::setw(8) << LogLevelToString(level) << "] ";
@@ -201,7 +410,12 @@ std::string Logger::FormatLogMessage(LogLevel level, const std::string& message,
 // TimingLogger implementation
 TimingLogger::TimingLogger(const std::string& operation)
     : operation_(operation)
-    , startTime_(std::chrono::high_resolution_clock::now()) {
+    , startTime_(std::chrono::high_resolution_clock::now())
+    , bytes_(0)
+    , profiled_(Profiler::GetInstance().IsEnabled()) {
+    if (profiled_) {
+        Profiler::GetInstance().BeginScope(operation_);
+    }
 }
 
 TimingLogger::~TimingLogger() {
@@ -210,6 +424,9 @@ TimingLogger::~TimingLogger() {
         endTime - startTime_);
     double durationMs = duration.count() / 1000.0;
 
+    if (profiled_) {
+        Profiler::GetInstance().EndScope(bytes_);
+    }
     Logger::GetInstance().LogTimingInfo(operation_, durationMs);
 }
 
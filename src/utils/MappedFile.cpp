@@ -0,0 +1,193 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace X2FBX {
+
+MappedFile::MappedFile()
+    : data_(nullptr)
+    , size_(0)
+    , mapped_(false)
+    , isOpen_(false)
+#ifdef _WIN32
+    , fileHandle_(nullptr)
+    , mappingHandle_(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : MappedFile() {
+    MoveFrom(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        MoveFrom(other);
+    }
+    return *this;
+}
+
+void MappedFile::MoveFrom(MappedFile& other) noexcept {
+    data_ = other.data_;
+    size_ = other.size_;
+    mapped_ = other.mapped_;
+    isOpen_ = other.isOpen_;
+    bool ownsBuffer = !other.mapped_ && !other.fallbackBuffer_.empty();
+    fallbackBuffer_ = std::move(other.fallbackBuffer_);
+    if (ownsBuffer) {
+        data_ = fallbackBuffer_.data();
+    }
+#ifdef _WIN32
+    fileHandle_ = other.fileHandle_;
+    mappingHandle_ = other.mappingHandle_;
+    other.fileHandle_ = nullptr;
+    other.mappingHandle_ = nullptr;
+#endif
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.mapped_ = false;
+    other.isOpen_ = false;
+}
+
+bool MappedFile::Open(const std::string& filepath) {
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return ReadIntoBuffer(filepath);
+    }
+
+    if (fileSize.QuadPart == 0) {
+        // Zero-length files cannot be mapped but are still valid (empty) input
+        CloseHandle(file);
+        isOpen_ = true;
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return ReadIntoBuffer(filepath);
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return ReadIntoBuffer(filepath);
+    }
+
+    fileHandle_ = file;
+    mappingHandle_ = mapping;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return ReadIntoBuffer(filepath);
+    }
+
+    if (st.st_size == 0) {
+        ::close(fd);
+        isOpen_ = true;
+        return true;
+    }
+
+    void* view = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return ReadIntoBuffer(filepath);
+    }
+
+    // Parsers walk the input front to back
+    ::madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<size_t>(st.st_size);
+#endif
+
+    mapped_ = true;
+    isOpen_ = true;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (mapped_ && data_) {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        if (mappingHandle_) CloseHandle(static_cast<HANDLE>(mappingHandle_));
+        if (fileHandle_) CloseHandle(static_cast<HANDLE>(fileHandle_));
+        mappingHandle_ = nullptr;
+        fileHandle_ = nullptr;
+#else
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+    }
+
+    fallbackBuffer_.clear();
+    fallbackBuffer_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    isOpen_ = false;
+}
+
+bool MappedFile::ReadIntoBuffer(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    fallbackBuffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data_ = fallbackBuffer_.data();
+    size_ = fallbackBuffer_.size();
+    mapped_ = false;
+    isOpen_ = true;
+    return true;
+}
+
+std::vector<uint8_t> MappedFile::ReadPrefix(const std::string& filepath, size_t maxBytes) {
+    std::vector<uint8_t> prefix(maxBytes);
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return {};
+    }
+
+    file.read(reinterpret_cast<char*>(prefix.data()), static_cast<std::streamsize>(maxBytes));
+    prefix.resize(static_cast<size_t>(file.gcount()));
+    return prefix;
+}
+
+} // namespace X2FBX
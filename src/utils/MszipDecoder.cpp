@@ -0,0 +1,284 @@
+#include "MszipDecoder.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace X2FBX {
+
+namespace {
+
+uint16_t ReadLE16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+uint32_t ReadLE32(const uint8_t* data) {
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+#ifdef HAVE_ZLIB
+// Raw inflate stream reused across blocks
+class BlockInflater {
+private:
+    z_stream stream_;
+    bool initialized_;
+
+public:
+    BlockInflater() : initialized_(false) {
+        std::memset(&stream_, 0, sizeof(stream_));
+        initialized_ = inflateInit2(&stream_, -15) == Z_OK;
+    }
+
+    ~BlockInflater() {
+        if (initialized_) {
+            inflateEnd(&stream_);
+        }
+    }
+
+    BlockInflater(const BlockInflater&) = delete;
+    BlockInflater& operator=(const BlockInflater&) = delete;
+
+    // Returns Z_OK when the block filled output exactly; Z_DATA_ERROR
+    // usually means the block needs a dictionary it was not given
+    int Inflate(ByteView input, ByteView dictionary, uint8_t* output, size_t outputSize, std::string& error) {
+        if (!initialized_) {
+            error = "inflateInit2 failed";
+            return Z_MEM_ERROR;
+        }
+
+        inflateReset(&stream_);
+        if (!dictionary.empty()) {
+            ByteView history = dictionary.Subview(dictionary.size() - std::min(dictionary.size(), Mszip::HISTORY_SIZE));
+            int result = inflateSetDictionary(&stream_, history.data(), static_cast<uInt>(history.size()));
+            if (result != Z_OK) {
+                error = "inflateSetDictionary failed: " + std::to_string(result);
+                return result;
+            }
+        }
+
+        stream_.next_in = const_cast<Bytef*>(input.data());
+        stream_.avail_in = static_cast<uInt>(input.size());
+        stream_.next_out = output;
+        stream_.avail_out = static_cast<uInt>(outputSize);
+
+        int result = inflate(&stream_, Z_FINISH);
+        size_t produced = outputSize - stream_.avail_out;
+
+        // A block ends either with the final-block bit or exactly at its
+        // declared size, depending on the compressor
+        if ((result == Z_STREAM_END || (result == Z_BUF_ERROR && stream_.avail_in == 0)) && produced == outputSize) {
+            return Z_OK;
+        }
+        if (result == Z_STREAM_END || result == Z_BUF_ERROR) {
+            error = "block inflated to " + std::to_string(produced) + " bytes, header declares " +
+                    std::to_string(outputSize);
+            return Z_DATA_ERROR;
+        }
+
+        error = std::string("inflate failed: ") + (stream_.msg ? stream_.msg : std::to_string(result));
+        return result == Z_OK ? Z_DATA_ERROR : result;
+    }
+};
+#endif
+
+} // namespace
+
+// =============================================================================
+// Block table
+// =============================================================================
+
+bool Mszip::ReadBlockTable(ByteView payload, std::vector<Block>& blocks,
+                           size_t& decompressedSize, std::string& error) {
+    blocks.clear();
+    decompressedSize = 0;
+
+    if (payload.size() < 4) {
+        error = "MSZIP: payload too small for size header";
+        return false;
+    }
+
+    uint32_t declaredSize = ReadLE32(payload.data());
+    if (declaredSize < 16) {
+        error = "MSZIP: invalid decompressed size " + std::to_string(declaredSize);
+        return false;
+    }
+    size_t expected = declaredSize - 16;   // The size counts the xof header
+
+    size_t offset = 4;
+    size_t output = 0;
+    while (output < expected) {
+        if (offset + 6 > payload.size()) {
+            error = "MSZIP: truncated block header at offset " + std::to_string(offset);
+            return false;
+        }
+
+        size_t blockSize = ReadLE16(payload.data() + offset);
+        size_t compressedSize = ReadLE16(payload.data() + offset + 2);
+        if (compressedSize < 2 || offset + 4 + compressedSize > payload.size()) {
+            error = "MSZIP: block at offset " + std::to_string(offset) + " runs past the end of the file";
+            return false;
+        }
+        if (payload[offset + 4] != 'C' || payload[offset + 5] != 'K') {
+            error = "MSZIP: missing CK signature at offset " + std::to_string(offset + 4);
+            return false;
+        }
+        if (blockSize == 0 || blockSize > HISTORY_SIZE || output + blockSize > expected) {
+            error = "MSZIP: invalid block size " + std::to_string(blockSize) + " at offset " + std::to_string(offset);
+            return false;
+        }
+
+        Block block;
+        block.offset = offset + 6;
+        block.compressedSize = compressedSize - 2;
+        block.decompressedSize = blockSize;
+        block.outputOffset = output;
+        blocks.push_back(block);
+
+        offset += 4 + compressedSize;
+        output += blockSize;
+    }
+
+    decompressedSize = expected;
+    return true;
+}
+
+bool Mszip::DecodeParallel(ByteView payload, std::vector<uint8_t>& output,
+                           size_t workerCount, std::string& error) {
+#ifdef HAVE_ZLIB
+    std::vector<Block> blocks;
+    size_t decompressedSize = 0;
+    if (!ReadBlockTable(payload, blocks, decompressedSize, error)) {
+        return false;
+    }
+
+    output.assign(decompressedSize, 0);
+    if (blocks.empty()) {
+        return true;
+    }
+
+    // Pass 1: every block without history. Success means the block only
+    // references its own output, so the result is final.
+    size_t threads = ParallelUtils::ResolveThreadCount(workerCount, blocks.size());
+    std::vector<std::unique_ptr<BlockInflater>> inflaters(threads);
+    std::vector<char> decoded(blocks.size(), 0);
+
+    ParallelUtils::ParallelFor(blocks.size(), threads, [&](size_t index, size_t workerId) {
+        if (!inflaters[workerId]) {
+            inflaters[workerId] = std::make_unique<BlockInflater>();
+        }
+        const Block& block = blocks[index];
+        std::string blockError;
+        decoded[index] = inflaters[workerId]->Inflate(payload.Subview(block.offset, block.compressedSize), ByteView(),
+                                                      output.data() + block.outputOffset, block.decompressedSize,
+                                                      blockError) == Z_OK;
+    });
+
+    // Pass 2: in order, blocks that need the preceding output
+    if (!inflaters[0]) {
+        inflaters[0] = std::make_unique<BlockInflater>();
+    }
+    BlockInflater& inflater = *inflaters[0];
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (decoded[i]) continue;
+
+        const Block& block = blocks[i];
+        ByteView history(output.data(), block.outputOffset);
+        if (inflater.Inflate(payload.Subview(block.offset, block.compressedSize), history,
+                             output.data() + block.outputOffset, block.decompressedSize, error) != Z_OK) {
+            error = "MSZIP: block " + std::to_string(i) + ": " + error;
+            return false;
+        }
+    }
+
+    return true;
+#else
+    (void)payload;
+    (void)output;
+    (void)workerCount;
+    error = "zlib support not compiled in";
+    return false;
+#endif
+}
+
+// =============================================================================
+// MszipByteSource
+// =============================================================================
+
+#ifdef HAVE_ZLIB
+struct MszipByteSource::State {
+    BlockInflater inflater;
+};
+#else
+struct MszipByteSource::State {};
+#endif
+
+MszipByteSource::MszipByteSource(ByteView payload)
+    : payload_(payload),
+      decompressedSize_(0),
+      nextBlock_(0),
+      blockPosition_(0),
+      state_(std::make_unique<State>()) {
+#ifdef HAVE_ZLIB
+    Mszip::ReadBlockTable(payload_, blocks_, decompressedSize_, error_);
+#else
+    error_ = "zlib support not compiled in";
+#endif
+}
+
+MszipByteSource::~MszipByteSource() = default;
+
+bool MszipByteSource::DecodeNextBlock() {
+#ifdef HAVE_ZLIB
+    // Previous output becomes the history for this block
+    if (block_.size() >= Mszip::HISTORY_SIZE) {
+        history_.assign(block_.end() - Mszip::HISTORY_SIZE, block_.end());
+    } else {
+        history_.insert(history_.end(), block_.begin(), block_.end());
+        if (history_.size() > Mszip::HISTORY_SIZE) {
+            history_.erase(history_.begin(), history_.end() - Mszip::HISTORY_SIZE);
+        }
+    }
+
+    const Mszip::Block& block = blocks_[nextBlock_];
+    block_.resize(block.decompressedSize);
+    blockPosition_ = 0;
+
+    std::string error;
+    if (state_->inflater.Inflate(payload_.Subview(block.offset, block.compressedSize), history_,
+                                 block_.data(), block_.size(), error) != Z_OK) {
+        error_ = "MSZIP: block " + std::to_string(nextBlock_) + ": " + error;
+        block_.clear();
+        return false;
+    }
+
+    nextBlock_++;
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t MszipByteSource::Read(uint8_t* buffer, size_t maxBytes) {
+    size_t total = 0;
+    while (total < maxBytes && !HasError()) {
+        if (blockPosition_ >= block_.size()) {
+            if (nextBlock_ >= blocks_.size() || !DecodeNextBlock()) {
+                break;
+            }
+        }
+
+        size_t count = std::min(maxBytes - total, block_.size() - blockPosition_);
+        std::memcpy(buffer + total, block_.data() + blockPosition_, count);
+        blockPosition_ += count;
+        total += count;
+    }
+
+    bytesProduced_ += total;
+    return total;
+}
+
+} // namespace X2FBX
@@ -0,0 +1,112 @@
+#include "ParallelDeflate.h"
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace X2FBX {
+
+namespace ParallelDeflate {
+
+bool IsAvailable() {
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef HAVE_ZLIB
+namespace {
+
+constexpr size_t WINDOW_BYTES = 32 * 1024;
+
+// Raw deflate of one chunk, primed with the window before it. Every chunk
+// but the last ends on a byte boundary with a sync flush, so the chunks
+// concatenate into one deflate stream.
+bool DeflateChunk(const uint8_t* data, size_t begin, size_t end, bool last, int level, std::vector<uint8_t>& out) {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    if (begin > 0) {
+        const size_t window = std::min(begin, WINDOW_BYTES);
+        deflateSetDictionary(&stream, data + begin - window, static_cast<uInt>(window));
+    }
+
+    // deflateBound covers Z_FINISH; a sync flush adds at most a few bytes
+    out.resize(deflateBound(&stream, static_cast<uLong>(end - begin)) + 16);
+    stream.next_in = const_cast<Bytef*>(data + begin);
+    stream.avail_in = static_cast<uInt>(end - begin);
+    stream.next_out = out.data();
+    stream.avail_out = static_cast<uInt>(out.size());
+    const int result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    const bool ok = last ? result == Z_STREAM_END : (result == Z_OK && stream.avail_in == 0);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return ok;
+}
+
+} // namespace
+#endif
+
+bool Compress(const uint8_t* data, size_t size, int level, size_t threads, std::vector<uint8_t>& out,
+              size_t chunkBytes) {
+#ifdef HAVE_ZLIB
+    chunkBytes = std::max(chunkBytes, WINDOW_BYTES);
+    const size_t chunkCount = size == 0 ? 1 : (size + chunkBytes - 1) / chunkBytes;
+
+    std::vector<std::vector<uint8_t>> packed(chunkCount);
+    std::vector<uLong> checksums(chunkCount, 0);
+    std::vector<char> ok(chunkCount, 0);
+    threads = ParallelUtils::ResolveThreadCount(threads, chunkCount);
+    ParallelUtils::ParallelFor(chunkCount, threads, [&](size_t chunk, size_t) {
+        const size_t begin = chunk * chunkBytes;
+        const size_t end = std::min(size, begin + chunkBytes);
+        checksums[chunk] = adler32(adler32(0L, Z_NULL, 0), data + begin, static_cast<uInt>(end - begin));
+        ok[chunk] = DeflateChunk(data, begin, end, chunk + 1 == chunkCount, level, packed[chunk]);
+    });
+
+    size_t total = 2 + 4;
+    uLong checksum = adler32(0L, Z_NULL, 0);
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        if (!ok[chunk]) {
+            return false;
+        }
+        total += packed[chunk].size();
+        const size_t begin = chunk * chunkBytes;
+        checksum = adler32_combine(checksum, checksums[chunk],
+                                   static_cast<z_off_t>(std::min(size, begin + chunkBytes) - begin));
+    }
+
+    // zlib header (deflate, 32 KiB window, no dictionary), the chunks and
+    // the big-endian Adler-32 of the whole input
+    out.clear();
+    out.reserve(total);
+    out.push_back(0x78);
+    out.push_back(0x9c);
+    for (const auto& chunk : packed) {
+        out.insert(out.end(), chunk.begin(), chunk.end());
+    }
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>(checksum >> shift));
+    }
+    return true;
+#else
+    (void)data;
+    (void)size;
+    (void)level;
+    (void)threads;
+    (void)out;
+    (void)chunkBytes;
+    return false;
+#endif
+}
+
+} // namespace ParallelDeflate
+
+} // namespace X2FBX
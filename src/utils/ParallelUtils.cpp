@@ -0,0 +1,72 @@
+#include "ParallelUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace X2FBX {
+namespace ParallelUtils {
+
+size_t GetDefaultThreadCount() {
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 0 ? static_cast<size_t>(hardwareThreads) : 1;
+}
+
+size_t ResolveThreadCount(size_t requested, size_t itemCount) {
+    size_t threads = requested > 0 ? requested : GetDefaultThreadCount();
+    return std::max<size_t>(1, std::min(threads, itemCount));
+}
+
+void ParallelFor(size_t count, size_t threads,
+                 const std::function<void(size_t index, size_t workerId)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    threads = ResolveThreadCount(threads, count);
+    if (threads == 1) {
+        for (size_t i = 0; i < count; i++) {
+            body(i, 0);
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextIndex(0);
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    auto worker = [&](size_t workerId) {
+        try {
+            for (size_t i = nextIndex.fetch_add(1); i < count; i = nextIndex.fetch_add(1)) {
+                body(i, workerId);
+            }
+        } catch (...) {
+            // Stop handing out work and rethrow the first failure on the caller
+            nextIndex.store(count);
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; t++) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+} // namespace ParallelUtils
+} // namespace X2FBX
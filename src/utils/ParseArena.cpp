@@ -0,0 +1,34 @@
+#include "ParseArena.h"
+#include <cstring>
+
+namespace X2FBX {
+
+void* ParseArena::TrackingResource::do_allocate(size_t bytes, size_t alignment) {
+    void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    bytesInUse += bytes;
+    if (bytesInUse > peakBytes) {
+        peakBytes = bytesInUse;
+    }
+    return p;
+}
+
+void ParseArena::TrackingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    bytesInUse -= bytes;
+}
+
+ParseArena::ParseArena(size_t initialBlockSize)
+    : upstream_(),
+      arena_(initialBlockSize, &upstream_) {
+}
+
+std::string_view ParseArena::CopyString(std::string_view text) {
+    if (text.empty()) {
+        return std::string_view();
+    }
+    char* memory = static_cast<char*>(arena_.allocate(text.size(), 1));
+    std::memcpy(memory, text.data(), text.size());
+    return std::string_view(memory, text.size());
+}
+
+} // namespace X2FBX
@@ -0,0 +1,71 @@
+#include "ProcessMemory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cstdio>
+#endif
+
+namespace X2FBX {
+namespace ProcessMemory {
+
+uint64_t GetPeakRssBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);          // Bytes on macOS
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;   // Kilobytes on Linux
+#endif
+#endif
+}
+
+uint64_t GetCurrentRssBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<uint64_t>(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) !=
+        KERN_SUCCESS) {
+        return 0;
+    }
+    return static_cast<uint64_t>(info.resident_size);
+#else
+    // Second field of statm: resident pages
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return 0;
+    }
+    unsigned long long totalPages = 0;
+    unsigned long long residentPages = 0;
+    int fields = std::fscanf(statm, "%llu %llu", &totalPages, &residentPages);
+    std::fclose(statm);
+    if (fields != 2) {
+        return 0;
+    }
+    return static_cast<uint64_t>(residentPages) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+} // namespace ProcessMemory
+} // namespace X2FBX
@@ -0,0 +1,247 @@
+#include "Profiler.h"
+#include "JsonUtils.h"
+#include "Logger.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace X2FBX {
+
+namespace {
+
+struct TraceEvent {
+    const std::string* path;            // Key in the owning thread's stats map
+    double startUs;
+    double durationUs;
+};
+
+struct OpenScope {
+    std::string path;
+    std::chrono::steady_clock::time_point start;
+    double childMs;
+};
+
+// Last component of a scope path
+std::string LeafName(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+void WriteScopes(std::ostream& out, const std::map<std::string, ProfileStats>& scopes, const char* indent) {
+    out << "[";
+    bool first = true;
+    for (const auto& entry : scopes) {
+        const ProfileStats& stats = entry.second;
+        double seconds = stats.totalMs / 1000.0;
+        double mbPerSecond = seconds > 0.0 ? stats.bytes / (1024.0 * 1024.0) / seconds : 0.0;
+
+        out << (first ? "\n" : ",\n") << indent << "{"
+            << "\"path\": \"" << EscapeJson(entry.first) << "\", "
+            << "\"name\": \"" << EscapeJson(LeafName(entry.first)) << "\", "
+            << "\"depth\": " << std::count(entry.first.begin(), entry.first.end(), '/') << ", "
+            << "\"count\": " << stats.count << ", "
+            << "\"totalMs\": " << stats.totalMs << ", "
+            << "\"selfMs\": " << stats.SelfMs() << ", "
+            << "\"minMs\": " << stats.minMs << ", "
+            << "\"maxMs\": " << stats.maxMs << ", "
+            << "\"bytes\": " << stats.bytes << ", "
+            << "\"mbPerSecond\": " << mbPerSecond << "}";
+        first = false;
+    }
+    out << "]";
+}
+
+} // namespace
+
+// Per-thread recording state. The owning thread is the only writer; the
+// mutex only orders it against summaries taken from another thread.
+struct ProfileThread {
+    size_t index = 0;
+    std::mutex mutex;
+    std::vector<OpenScope> stack;
+    std::map<std::string, ProfileStats> stats;
+    std::vector<TraceEvent> events;
+    uint64_t droppedEvents = 0;
+};
+
+void ProfileStats::Add(const ProfileStats& other) {
+    if (other.count == 0) {
+        return;
+    }
+    minMs = count == 0 ? other.minMs : std::min(minMs, other.minMs);
+    maxMs = count == 0 ? other.maxMs : std::max(maxMs, other.maxMs);
+    count += other.count;
+    totalMs += other.totalMs;
+    childMs += other.childMs;
+    bytes += other.bytes;
+}
+
+Profiler::Profiler()
+    : enabled_(false)
+    , recordTrace_(false)
+    , origin_(std::chrono::steady_clock::now()) {
+}
+
+Profiler::~Profiler() = default;
+
+Profiler& Profiler::GetInstance() {
+    static Profiler instance;
+    return instance;
+}
+
+void Profiler::Enable(bool enable, bool recordTrace) {
+    recordTrace_ = enable && recordTrace;
+    if (enable && !enabled_) {
+        origin_ = std::chrono::steady_clock::now();
+    }
+    enabled_ = enable;
+}
+
+void Profiler::Reset() {
+    std::lock_guard<std::mutex> lock(threadsMutex_);
+    for (auto& thread : threads_) {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        thread->events.clear();
+        thread->stats.clear();
+        thread->droppedEvents = 0;
+    }
+    origin_ = std::chrono::steady_clock::now();
+}
+
+ProfileThread& Profiler::CurrentThread() {
+    // Threads register once; the record outlives short-lived pool threads
+    // so their totals still appear in the summary
+    thread_local ProfileThread* current = nullptr;
+    if (!current) {
+        std::lock_guard<std::mutex> lock(threadsMutex_);
+        threads_.push_back(std::make_unique<ProfileThread>());
+        current = threads_.back().get();
+        current->index = threads_.size() - 1;
+    }
+    return *current;
+}
+
+void Profiler::BeginScope(const std::string& name) {
+    ProfileThread& thread = CurrentThread();
+    std::string path = thread.stack.empty() ? name : thread.stack.back().path + "/" + name;
+    thread.stack.push_back({std::move(path), std::chrono::steady_clock::now(), 0.0});
+}
+
+void Profiler::EndScope(uint64_t bytes) {
+    auto end = std::chrono::steady_clock::now();
+    ProfileThread& thread = CurrentThread();
+    if (thread.stack.empty()) {
+        return;
+    }
+
+    OpenScope scope = std::move(thread.stack.back());
+    thread.stack.pop_back();
+    double durationMs = std::chrono::duration<double, std::milli>(end - scope.start).count();
+    if (!thread.stack.empty()) {
+        thread.stack.back().childMs += durationMs;
+    }
+
+    std::lock_guard<std::mutex> lock(thread.mutex);
+    auto inserted = thread.stats.try_emplace(std::move(scope.path));
+    ProfileStats sample;
+    sample.count = 1;
+    sample.totalMs = durationMs;
+    sample.childMs = scope.childMs;
+    sample.minMs = durationMs;
+    sample.maxMs = durationMs;
+    sample.bytes = bytes;
+    inserted.first->second.Add(sample);
+
+    if (recordTrace_.load(std::memory_order_relaxed)) {
+        if (thread.events.size() < MAX_TRACE_EVENTS_PER_THREAD) {
+            double startUs = std::chrono::duration<double, std::micro>(scope.start - origin_).count();
+            thread.events.push_back({&inserted.first->first, startUs, durationMs * 1000.0});
+        } else {
+            thread.droppedEvents++;
+        }
+    }
+}
+
+std::map<std::string, ProfileStats> Profiler::GetTotals() const {
+    std::map<std::string, ProfileStats> totals;
+    std::lock_guard<std::mutex> lock(threadsMutex_);
+    for (const auto& thread : threads_) {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        for (const auto& entry : thread->stats) {
+            totals[entry.first].Add(entry.second);
+        }
+    }
+    return totals;
+}
+
+bool Profiler::WriteSummary(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        LOG_ERROR("Cannot write profile summary: " + path);
+        return false;
+    }
+
+    double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - origin_).count();
+    std::map<std::string, ProfileStats> totals = GetTotals();
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"wallMs\": " << wallMs << ",\n";
+    out << "  \"scopes\": ";
+    WriteScopes(out, totals, "    ");
+    out << ",\n  \"threads\": [";
+
+    std::lock_guard<std::mutex> lock(threadsMutex_);
+    bool first = true;
+    for (const auto& thread : threads_) {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        if (thread->stats.empty()) {
+            continue;
+        }
+        out << (first ? "\n" : ",\n") << "    {\"thread\": " << thread->index << ", \"scopes\": ";
+        WriteScopes(out, thread->stats, "      ");
+        out << "}";
+        first = false;
+    }
+    out << "]\n}\n";
+
+    LOG_INFO("Profile summary written: " + path);
+    return out.good();
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        LOG_ERROR("Cannot write profile trace: " + path);
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+    std::lock_guard<std::mutex> lock(threadsMutex_);
+    bool first = true;
+    uint64_t dropped = 0;
+    for (const auto& thread : threads_) {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        dropped += thread->droppedEvents;
+        for (const auto& event : thread->events) {
+            out << (first ? "\n" : ",\n")
+                << "{\"name\": \"" << EscapeJson(LeafName(*event.path)) << "\", "
+                << "\"cat\": \"x2fbx\", \"ph\": \"X\", "
+                << "\"ts\": " << event.startUs << ", \"dur\": " << event.durationUs << ", "
+                << "\"pid\": 1, \"tid\": " << thread->index << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+
+    if (dropped > 0) {
+        LOG_WARNING("Profile trace truncated: " + std::to_string(dropped) + " scope events not recorded");
+    }
+    LOG_INFO("Profile trace written: " + path);
+    return out.good();
+}
+
+} // namespace X2FBX
@@ -0,0 +1,758 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include "XFileData.h"
+#include "XFileParser.h"
+#include "AllocationTracker.h"
+#include "AnimationTimingCorrector.h"
+#include "BatchPipeline.h"
+#include "BinaryXFileParser.h"
+#include "CoordinateKernels.h"
+#include "FBXExporter.h"
+#include "FBXExporterPool.h"
+#include "Logger.h"
+#include "MeshOptimizer.h"
+#include "ParallelDeflate.h"
+#include "Profiler.h"
+#include "TextureLibrary.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+// Mesh data and the export path below the exporters' public entry points:
+// curve, skin and skeleton conversion, matrix and coordinate kernels, mesh
+// optimization, the native writer and its output checks, textures, and the
+// handoff, pooling and profiling around an export
+
+using namespace X2FBX;
+namespace fs = std::filesystem;
+
+// Test helper functions
+
+// An animated, skinned triangle: two bones, one two-key rotation track on
+// the child, and a textured material
+void BuildSkinnedTriangle(XMeshData& animatedMesh, XAnimationSet& wave) {
+    animatedMesh.positions = {XVector3(0, 0, 0), XVector3(1, 0, 0), XVector3(0, 1, 0)};
+    animatedMesh.normals.assign(3, XVector3(0, 0, -1));
+    animatedMesh.texCoords = {XVector2(0, 0), XVector2(1, 0), XVector2(0, 1)};
+    animatedMesh.AddTriangle(0, 1, 2, 0);
+    animatedMesh.materials.resize(1);
+    animatedMesh.materials[0].diffuseTexture = "skin.png";
+    int rootBone = animatedMesh.AddBone("Root");
+    int childBone = animatedMesh.AddBone("Child");
+    animatedMesh.bones[childBone].parentIndex = rootBone;
+    animatedMesh.bones[childBone].bindPose.m[3][1] = 1.0f;
+    animatedMesh.EnsureSkinInfluences();
+    for (auto& influences : animatedMesh.skinInfluences) {
+        influences.Add(rootBone, 0.5f);
+        influences.Add(childBone, 0.5f);
+    }
+    wave.name = "Wave";
+    wave.duration = 4800.0f;
+    XBoneTrack waveTrack;
+    waveTrack.boneId = childBone;
+    const float keyRotations[2][4] = {{0, 0, 0, 1}, {0, 0, 0.7071f, 0.7071f}};
+    waveTrack.rotation.AddKey(0.0f, keyRotations[0], XBoneTrack::ROTATION_COMPONENTS);
+    waveTrack.rotation.AddKey(4800.0f, keyRotations[1], XBoneTrack::ROTATION_COMPONENTS);
+    wave.AddTrack(waveTrack);
+}
+
+// Scale, then rotations about X, Y and Z (row vectors), then a translation
+XMatrix4x4 BuildAffineTestMatrix() {
+    const float degreesToRadians = 3.14159265358979f / 180.0f;
+    const float ax = 30.0f * degreesToRadians, ay = -20.0f * degreesToRadians, az = 45.0f * degreesToRadians;
+    XMatrix4x4 rotX = XMatrix4x4::Identity(), rotY = XMatrix4x4::Identity(), rotZ = XMatrix4x4::Identity();
+    rotX.m[1][1] = std::cos(ax); rotX.m[1][2] = std::sin(ax); rotX.m[2][1] = -std::sin(ax); rotX.m[2][2] = std::cos(ax);
+    rotY.m[0][0] = std::cos(ay); rotY.m[0][2] = -std::sin(ay); rotY.m[2][0] = std::sin(ay); rotY.m[2][2] = std::cos(ay);
+    rotZ.m[0][0] = std::cos(az); rotZ.m[0][1] = std::sin(az); rotZ.m[1][0] = -std::sin(az); rotZ.m[1][1] = std::cos(az);
+    XMatrix4x4 scaling = XMatrix4x4::Identity();
+    scaling.m[0][0] = 2.0f; scaling.m[1][1] = 3.0f; scaling.m[2][2] = 0.5f;
+    XMatrix4x4 affine = scaling * rotX * rotY * rotZ;   // Row vectors: scale, then X, Y, Z
+    affine.m[3][0] = 1.0f; affine.m[3][1] = -2.0f; affine.m[3][2] = 3.0f;
+    return affine;
+}
+
+// Test functions
+
+bool TestKeyframeCurves() {
+    std::cout << "Testing keyframe curve conversion..." << std::endl;
+
+    // Keyframe tracks convert to FBX curves in one pass: axis swap and
+    // quaternion to Euler degrees (DirectX Z becomes the FBX Y axis)
+    XBoneTrack track;
+    const float translations[6] = {0.0f, 0.0f, 0.0f, 1.0f, 2.0f, 3.0f};
+    const float rotations[12] = {
+        0.0f, 0.0f, 0.0f, 1.0f,
+        0.0f, 0.0f, std::sqrt(0.5f), std::sqrt(0.5f),
+        std::sin(0.2618f), 0.0f, 0.0f, std::cos(0.2618f)
+    };
+    for (int i = 0; i < 3; i++) {
+        track.rotation.AddKey(i * 2400.0f, &rotations[i * 4], XBoneTrack::ROTATION_COMPONENTS);
+    }
+    track.translation.AddKey(0.0f, &translations[0], XBoneTrack::VECTOR_COMPONENTS);
+    track.translation.AddKey(2400.0f, &translations[3], XBoneTrack::VECTOR_COMPONENTS);
+    FBXUtils::CurveChannels channels;
+    FBXUtils::BuildCurveChannels(track, 4800.0f, channels);
+    const auto& values = channels.values;
+    if (channels.times[FBXUtils::CurveChannels::ROTATION].size() != 3 ||
+        channels.times[FBXUtils::CurveChannels::TRANSLATION].size() != 2 ||
+        !channels.times[FBXUtils::CurveChannels::SCALE].empty() ||
+        channels.times[FBXUtils::CurveChannels::ROTATION][1] != 0.5 ||
+        values[FBXUtils::CurveChannels::TY][1] != 3.0f || values[FBXUtils::CurveChannels::TZ][1] != -2.0f ||
+        std::abs(values[FBXUtils::CurveChannels::RX][0]) > 1e-4f ||
+        std::abs(values[FBXUtils::CurveChannels::RY][1] - 90.0f) > 0.01f ||
+        std::abs(values[FBXUtils::CurveChannels::RZ][1]) > 0.01f ||
+        std::abs(values[FBXUtils::CurveChannels::RX][2] - 30.0f) > 0.01f) {
+        std::cout << "  FAIL: Keyframe curve conversion incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Keyframe curve conversion" << std::endl;
+    return true;
+}
+
+bool TestSkinClusters() {
+    std::cout << "Testing skin cluster grouping..." << std::endl;
+
+    // Skin influences regroup per bone in vertex order; out-of-range bones
+    // and zero weights are dropped
+    XMeshData skinned;
+    skinned.bones.resize(3);
+    skinned.skinInfluences.resize(4);
+    skinned.skinInfluences[0].Add(2, 1.0f);
+    skinned.skinInfluences[1].Add(0, 0.25f);
+    skinned.skinInfluences[1].Add(2, 0.75f);
+    skinned.skinInfluences[2].Add(5, 1.0f);
+    skinned.skinInfluences[3].Add(2, 0.5f);
+    skinned.skinInfluences[3].Add(0, 0.0f);
+    FBXUtils::SkinClusters skinClusters;
+    FBXUtils::BuildSkinClusters(skinned, skinClusters);
+    if (skinClusters.GetInfluenceCount(0) != 1 || skinClusters.GetInfluenceCount(1) != 0 ||
+        skinClusters.GetInfluenceCount(2) != 3 || skinClusters.controlPoints[0] != 1 ||
+        skinClusters.weights[0] != 0.25 || skinClusters.controlPoints[skinClusters.offsets[2] + 1] != 1 ||
+        skinClusters.controlPoints[skinClusters.offsets[2] + 2] != 3 ||
+        skinClusters.weights[skinClusters.offsets[2] + 2] != 0.5) {
+        std::cout << "  FAIL: Skin influences not grouped per bone" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Skin clusters" << std::endl;
+    return true;
+}
+
+bool TestBoneHierarchy() {
+    std::cout << "Testing bone hierarchy..." << std::endl;
+
+    // Bones sort parents first with every reference remapped; world
+    // matrices then follow in one pass (local first, then the parent)
+    XMeshData rig;
+    const char* rigNames[4] = {"Hand", "Root", "Spine", "Arm"};
+    const int rigParents[4] = {3, -1, 1, 2};
+    for (int i = 0; i < 4; i++) {
+        rig.AddBone(rigNames[i]);
+        rig.bones[i].parentIndex = rigParents[i];
+        rig.bones[i].bindPose = XMatrix4x4::Identity();
+        rig.bones[i].bindPose.m[3][0] = float(i + 1);   // Translation along x
+    }
+    rig.bones[2].bindPose.m[0][0] = 2.0f;                // Spine scales x
+    rig.skinInfluences.resize(1);
+    rig.skinInfluences[0].Add(0, 1.0f);
+    XAnimationSet rigAnimation;
+    XBoneTrack handTrack;
+    handTrack.boneId = 0;
+    rigAnimation.tracks.push_back(handTrack);
+    rig.animations.push_back(rigAnimation);
+    std::vector<int> newIndex;
+    std::vector<XMatrix4x4> world;
+    if (!rig.SortBonesTopologically(newIndex) || rig.GetBoneName(0) != "Root" || rig.GetBoneName(1) != "Spine" ||
+        rig.GetBoneName(3) != "Hand" || rig.FindBone("Hand") != 3 || rig.bones[3].parentIndex != 2 || newIndex[0] != 3 ||
+        rig.bones[2].childIndices.size() != 1 || rig.bones[2].childIndices[0] != 3 ||
+        rig.animations[0].tracks[0].boneId != 3 || rig.skinInfluences[0].boneIndices[0] != 3 ||
+        !rig.ComputeBoneWorldMatrices(world) || world[3].m[3][0] != (1.0f + 4.0f) * 2.0f + 3.0f + 2.0f) {
+        std::cout << "  FAIL: Skeleton not sorted parents first or world matrices wrong" << std::endl;
+        return false;
+    }
+
+    // Converted to FBX axes, the world matrix moves points like converted
+    // positions do
+    XMatrix4x4 fbxMatrix = FBXUtils::DirectXToFBXMatrix(world[3]);
+    if (fbxMatrix.m[3][0] != world[3].m[3][0] || fbxMatrix.m[3][1] != world[3].m[3][2] ||
+        fbxMatrix.m[3][2] != -world[3].m[3][1] || fbxMatrix.m[0][0] != 2.0f || fbxMatrix.m[1][1] != 1.0f) {
+        std::cout << "  FAIL: Matrix not converted to FBX axes" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Bone hierarchy" << std::endl;
+    return true;
+}
+
+bool TestMatrixMath() {
+    std::cout << "Testing matrix math..." << std::endl;
+
+    // The 4x4 product matches a reference triple loop
+    XMatrix4x4 a, b;
+    for (int i = 0; i < 16; i++) {
+        a.m[i / 4][i % 4] = float(i) * 0.5f - 3.0f;
+        b.m[i / 4][i % 4] = float((i * 7) % 16) - 8.0f;
+    }
+    XMatrix4x4 product = a * b;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            float expected = 0.0f;
+            for (int k = 0; k < 4; k++) {
+                expected += a.m[i][k] * b.m[k][j];
+            }
+            if (product.m[i][j] != expected) {
+                std::cout << "  FAIL: Matrix product incorrect" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    // Matrix decomposition recovers Euler angles and scale, and the affine
+    // inverse undoes the matrix
+    XMatrix4x4 affine = BuildAffineTestMatrix();
+    XVector3 translation, rotation, scale;
+    FBXUtils::DecomposeMatrix(affine, translation, rotation, scale);
+    XMatrix4x4 roundTrip = affine * FBXUtils::InvertAffineMatrix(affine);
+    bool inverseOk = true;
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 4; column++) {
+            inverseOk &= std::fabs(roundTrip.m[row][column] - (row == column ? 1.0f : 0.0f)) < 1e-4f;
+        }
+    }
+    if (std::fabs(rotation.x - 30.0f) > 1e-3f || std::fabs(rotation.y + 20.0f) > 1e-3f ||
+        std::fabs(rotation.z - 45.0f) > 1e-3f || std::fabs(scale.x - 2.0f) > 1e-4f || std::fabs(scale.y - 3.0f) > 1e-4f ||
+        std::fabs(scale.z - 0.5f) > 1e-4f || translation.y != -2.0f || !inverseOk) {
+        std::cout << "  FAIL: Matrix decomposition incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Matrix math" << std::endl;
+    return true;
+}
+
+bool TestMeshOptimizer() {
+    std::cout << "Testing mesh optimizer..." << std::endl;
+
+    // Mesh optimization: a triangle soup over an 8x8 quad grid welds back
+    // to the grid's 81 vertices, the degenerate triangle is dropped, and
+    // the cache-ordered buffer misses no more often than the input
+    XMeshData soup;
+    const int gridQuads = 8;
+    int materialOneFaces = 0;
+    auto addSoupVertex = [&soup](int x, int y) {
+        soup.positions.emplace_back(float(x), float(y), 0.0f);
+        soup.texCoords.emplace_back(x / float(gridQuads), y / float(gridQuads));
+        return static_cast<int>(soup.positions.size() - 1);
+    };
+    for (int y = 0; y < gridQuads; y++) {
+        for (int x = 0; x < gridQuads; x++) {
+            int material = (x + y) % 2;
+            materialOneFaces += material * 2;
+            soup.AddTriangle(addSoupVertex(x, y), addSoupVertex(x + 1, y), addSoupVertex(x + 1, y + 1), material);
+            soup.AddTriangle(addSoupVertex(x, y), addSoupVertex(x + 1, y + 1), addSoupVertex(x, y + 1), material);
+        }
+    }
+    soup.AddTriangle(0, 1, 1, 0);
+    MeshOptimizationResult optimized = MeshOptimizer().Optimize(soup);
+    int materialOneAfter = 0;
+    bool indicesInRange = true;
+    for (size_t face = 0; face < soup.GetFaceCount(); face++) {
+        materialOneAfter += soup.faceMaterials[face];
+        for (int corner = 0; corner < 3; corner++) {
+            indicesInRange &= soup.indices[face * 3 + corner] < static_cast<int>(soup.GetVertexCount());
+        }
+    }
+    if (!optimized.applied || soup.GetVertexCount() != 81 || soup.texCoords.size() != 81 ||
+        optimized.weldedVertices != 384 - 81 || optimized.degenerateTriangles != 1 ||
+        soup.GetFaceCount() != 128 || materialOneAfter != materialOneFaces || !indicesInRange ||
+        optimized.acmrAfter > optimized.acmrBefore) {
+        std::cout << "  FAIL: Mesh optimization incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Mesh optimizer" << std::endl;
+    return true;
+}
+
+bool TestMaterialBatching() {
+    std::cout << "Testing material batching..." << std::endl;
+
+    // Material batching: four materials of which two repeat the others
+    // become two, each material's triangles form one run, and of three
+    // meshes the two static ones merge
+    XMeshData batched;
+    XMaterial red{};
+    red.name = "Red";
+    red.diffuseColor = XVector3(1.0f, 0.0f, 0.0f);
+    XMaterial blue = red;
+    blue.name = "Blue";
+    batched.materials = {red, blue, red, blue};
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            int corner = static_cast<int>(batched.positions.size());
+            batched.positions.emplace_back(float(x), float(y), 0.0f);
+            batched.positions.emplace_back(float(x + 1), float(y), 0.0f);
+            batched.positions.emplace_back(float(x + 1), float(y + 1), 0.0f);
+            batched.AddTriangle(corner, corner + 1, corner + 2, (x + y) % 4);
+        }
+    }
+    MeshOptimizationOptions batching;
+    batching.batchMaterials = true;
+    MeshOptimizer batcher(batching);
+    MeshOptimizationResult batchedResult = batcher.Optimize(batched);
+    bool grouped = std::is_sorted(batched.faceMaterials.begin(), batched.faceMaterials.end()) &&
+                   std::count(batched.faceMaterials.begin(), batched.faceMaterials.end(), 0) == 8;
+
+    std::vector<XMeshData> scene(3);
+    for (size_t i = 0; i < scene.size(); i++) {
+        scene[i].name = "Part" + std::to_string(i);
+        scene[i].positions = {XVector3(0.0f, 0.0f, float(i)), XVector3(1.0f, 0.0f, float(i)), XVector3(0.0f, 1.0f, float(i))};
+        scene[i].materials = {i == 1 ? blue : red, red};
+        scene[i].AddTriangle(0, 1, 2, 0);
+        scene[i].AddTriangle(2, 1, 0, 1);
+    }
+    scene[2].bones.emplace_back();
+    MeshMergeResult mergedScene = batcher.MergeMeshes(scene);
+    if (!batchedResult.applied || batched.materials.size() != 2 || batchedResult.MergedMaterials() != 2 ||
+        batchedResult.submeshes != 2 || !grouped || mergedScene.remainingMeshes != 2 ||
+        scene[0].name != "Part0" || scene[0].GetVertexCount() != 6 || scene[0].materials.size() != 2 ||
+        scene[0].indices[6] != 5 || scene[0].faceMaterials != std::vector<int>({0, 0, 0, 1}) ||
+        scene[1].name != "Part2" || scene[1].materials.size() != 2) {
+        std::cout << "  FAIL: Material batching incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Material batching" << std::endl;
+    return true;
+}
+
+bool TestStreamingExport() {
+    std::cout << "Testing streaming static export..." << std::endl;
+
+    // Streaming static export leaves the source mesh empty and reports the
+    // process high-water mark
+    XMeshData streamedMesh;
+    streamedMesh.positions = {XVector3(0, 0, 0), XVector3(1, 0, 0), XVector3(0, 1, 0)};
+    streamedMesh.AddTriangle(0, 1, 2, 0);
+    const std::string streamedPath = (fs::temp_directory_path() / "x2fbx_test_streamed_export.fbx").string();
+    FBXExportResult streamed = FBXExporter().ExportStaticMesh(std::move(streamedMesh), streamedPath);
+    std::remove(streamedPath.c_str());
+    if (!streamed.success || !streamedMesh.positions.empty() || !streamedMesh.indices.empty() ||
+        streamedMesh.positions.capacity() != 0 || streamed.peakRssBytes == 0) {
+        std::cout << "  FAIL: Streaming static export incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Streaming static export" << std::endl;
+    return true;
+}
+
+bool TestCoordinateKernels() {
+    std::cout << "Testing coordinate kernels..." << std::endl;
+
+    // Coordinate kernels: the SIMD versions match the scalar ones bit for
+    // bit, including tails shorter than a vector, and matrices match the
+    // explicit basis change B^T * M * B
+    std::vector<XVector3> kernelVectors(7);
+    std::vector<float> kernelKeys(7 * 4);
+    for (size_t i = 0; i < kernelVectors.size(); i++) {
+        kernelVectors[i] = XVector3(0.5f * i - 1.0f, 1.0f / (i + 1.0f), -3.25f * i);
+    }
+    for (size_t i = 0; i < kernelKeys.size(); i++) {
+        kernelKeys[i] = std::sin(0.7f * i) * 2.0f;
+    }
+    kernelKeys[4] = kernelKeys[5] = kernelKeys[6] = kernelKeys[7] = 0.0f;   // Zero quaternion
+    std::vector<double> vectorsSimd(7 * 4), vectorsScalar(7 * 4);
+    std::vector<float> splitSimd(3 * 7), splitScalar(3 * 7), quatSimd(7 * 4), quatScalar(7 * 4);
+    CoordinateKernels::ConvertVectors4(kernelVectors.data(), 7, vectorsSimd.data());
+    CoordinateKernels::Scalar::ConvertVectors4(kernelVectors.data(), 7, vectorsScalar.data(), 1.0);
+    CoordinateKernels::SplitVectorKeys(kernelKeys.data(), 7, &splitSimd[0], &splitSimd[7], &splitSimd[14], true);
+    CoordinateKernels::Scalar::SplitVectorKeys(kernelKeys.data(), 7, &splitScalar[0], &splitScalar[7], &splitScalar[14], true);
+    CoordinateKernels::ConvertQuaternions(kernelKeys.data(), 7, quatSimd.data());
+    CoordinateKernels::Scalar::ConvertQuaternions(kernelKeys.data(), 7, quatScalar.data());
+    XMatrix4x4 affine = BuildAffineTestMatrix();
+    XMatrix4x4 basis;
+    basis.m[0][0] = 1.0f; basis.m[1][2] = -1.0f; basis.m[2][1] = 1.0f; basis.m[3][3] = 1.0f;
+    XMatrix4x4 basisTransposed = basis;
+    std::swap(basisTransposed.m[1][2], basisTransposed.m[2][1]);
+    XMatrix4x4 expectedBasis = basisTransposed * affine * basis;
+    XMatrix4x4 convertedAffine = FBXUtils::DirectXToFBXMatrix(affine);
+    bool matrixMatches = true;
+    for (int row = 0; row < 4; row++) {
+        for (int column = 0; column < 4; column++) {
+            matrixMatches &= convertedAffine.m[row][column] == expectedBasis.m[row][column];
+        }
+    }
+    const int triangles[7] = {0, 1, 2, 3, 4, 5, 6};
+    int32_t polygons[7];
+    const uint32_t largestIndex = CoordinateKernels::TrianglesToPolygonIndices(triangles, 7, polygons, true);
+    if (vectorsSimd != vectorsScalar || vectorsSimd[5] != kernelVectors[1].z || vectorsSimd[6] != -kernelVectors[1].y ||
+        vectorsSimd[7] != 1.0 || splitSimd != splitScalar || splitSimd[7 + 6] != kernelKeys[6 * 3 + 2] ||
+        quatSimd != quatScalar || quatSimd[4] != 0.0f || quatSimd[7] != 1.0f || !matrixMatches ||
+        polygons[1] != 2 || polygons[2] != ~1 || polygons[5] != ~4 || polygons[6] != 6 || largestIndex != 6) {
+        std::cout << "  FAIL: Coordinate kernels incorrect (" << CoordinateKernels::GetActiveKernels() << ")" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Coordinate kernels (" << CoordinateKernels::GetActiveKernels() << ")" << std::endl;
+    return true;
+}
+
+bool TestNativeFBXWriter() {
+    std::cout << "Testing native FBX writer..." << std::endl;
+
+    // Native writer: an animated, skinned triangle mesh becomes a binary FBX 7.4
+    // file whose top-level records chain up to the footer
+    XMeshData animatedMesh;
+    XAnimationSet wave;
+    BuildSkinnedTriangle(animatedMesh, wave);
+    FBXExportOptions nativeOptions;
+    nativeOptions.backend = FBXExportOptions::Backend::NATIVE;
+    const std::string nativePath = (fs::temp_directory_path() / "test_native_export.fbx").string();
+    FBXExportResult nativeResult = FBXExporter().ExportAnimatedMesh(animatedMesh, wave, nativePath, nativeOptions);
+    std::ifstream nativeFile(nativePath, std::ios::binary);
+    std::vector<unsigned char> fbxBytes((std::istreambuf_iterator<char>(nativeFile)), std::istreambuf_iterator<char>());
+    nativeFile.close();
+    std::remove(nativePath.c_str());
+    auto readU32 = [&fbxBytes](size_t offset) {
+        return static_cast<uint32_t>(fbxBytes[offset]) | static_cast<uint32_t>(fbxBytes[offset + 1]) << 8 |
+               static_cast<uint32_t>(fbxBytes[offset + 2]) << 16 | static_cast<uint32_t>(fbxBytes[offset + 3]) << 24;
+    };
+    const unsigned char footerMagic[4] = {0x75, 0x8f, 0x29, 0x0b};
+    bool nativeOk = nativeResult.success && nativeResult.bonesExported == 2 && nativeResult.animationsExported == 1 &&
+                    fbxBytes.size() > 200 && std::string(fbxBytes.begin(), fbxBytes.begin() + 18) == "Kaydara FBX Binary" &&
+                    readU32(23) == 7400 && std::equal(footerMagic, footerMagic + 4, fbxBytes.end() - 4);
+    std::vector<std::string> topLevel;
+    for (size_t offset = 27; nativeOk;) {
+        uint32_t end = offset + 13 <= fbxBytes.size() ? readU32(offset) : 0;
+        if (end == 0) {
+            break;   // Null record closing the node list
+        }
+        nativeOk = end > offset && end < fbxBytes.size();
+        if (nativeOk) {
+            topLevel.emplace_back(fbxBytes.begin() + offset + 13, fbxBytes.begin() + offset + 13 + fbxBytes[offset + 12]);
+            offset = end;
+        }
+    }
+    const std::vector<std::string> expectedTopLevel = {
+        "FBXHeaderExtension", "FileId", "CreationTime", "Creator", "GlobalSettings", "Documents",
+        "References", "Definitions", "Objects", "Connections", "Takes"
+    };
+    if (!nativeOk || topLevel != expectedTopLevel) {
+        std::cout << "  FAIL: Native FBX export incorrect" << std::endl;
+        return false;
+    }
+
+    // Without the coordinate conversion the vertices and the bind matrix of
+    // the child bone keep their DirectX axes (arrays left undeflated to be
+    // searchable)
+    FBXExportOptions dxAxesOptions = nativeOptions;
+    dxAxesOptions.convertCoordinateSystem = false;
+    dxAxesOptions.compressArrays = false;
+    const std::string dxAxesPath = (fs::temp_directory_path() / "x2fbx_test_dx_axes.fbx").string();
+    const bool dxAxesExported = FBXExporter().ExportAnimatedMesh(animatedMesh, wave, dxAxesPath, dxAxesOptions).success;
+    std::ifstream dxAxesFile(dxAxesPath, std::ios::binary);
+    std::vector<unsigned char> dxAxesBytes((std::istreambuf_iterator<char>(dxAxesFile)), std::istreambuf_iterator<char>());
+    dxAxesFile.close();
+    std::remove(dxAxesPath.c_str());
+    auto containsDoubles = [](const std::vector<unsigned char>& bytes, const std::vector<double>& values) {
+        const unsigned char* begin = reinterpret_cast<const unsigned char*>(values.data());
+        return std::search(bytes.begin(), bytes.end(), begin, begin + values.size() * sizeof(double)) != bytes.end();
+    };
+    const std::vector<double> dxVertices = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+    const std::vector<double> fbxVertices = {0, 0, -0.0, 1, 0, -0.0, 0, 0, -1};   // z = -y
+    const std::vector<double> dxChildBind = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1};
+    const std::vector<double> fbxChildBind = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, -1, 1};
+    if (!dxAxesExported || !containsDoubles(dxAxesBytes, dxVertices) || containsDoubles(dxAxesBytes, fbxVertices) ||
+        !containsDoubles(dxAxesBytes, dxChildBind) || containsDoubles(dxAxesBytes, fbxChildBind) ||
+        !containsDoubles(fbxBytes, fbxVertices)) {
+        std::cout << "  FAIL: Native export ignores convertCoordinateSystem" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Native FBX writer" << std::endl;
+    return true;
+}
+
+bool TestOutputValidation() {
+    std::cout << "Testing output validation..." << std::endl;
+
+    // Validation tiers: FULL reads the written file back, CHEAP rejects a
+    // bad index while writing, and the file check catches what NONE lets
+    // through as well as a truncated file
+    XMeshData animatedMesh;
+    XAnimationSet wave;
+    BuildSkinnedTriangle(animatedMesh, wave);
+    FBXExportOptions nativeOptions;
+    nativeOptions.backend = FBXExportOptions::Backend::NATIVE;
+    FBXExportOptions fullOptions = nativeOptions;
+    fullOptions.validation = FBXExportOptions::Validation::FULL;
+    const std::string checkedPath = (fs::temp_directory_path() / "x2fbx_test_checked.fbx").string();
+    const std::string brokenPath = (fs::temp_directory_path() / "x2fbx_test_broken.fbx").string();
+    const bool fullExported = FBXExporter().ExportAnimatedMesh(animatedMesh, wave, checkedPath, fullOptions).success;
+    FBXUtils::FBXFileCheck goodCheck = FBXUtils::CheckFBXFile(checkedPath);
+
+    animatedMesh.indices[2] = 3;
+    FBXExportOptions cheapOptions = nativeOptions;
+    FBXExportResult cheapResult = FBXExporter().ExportAnimatedMesh(animatedMesh, wave, brokenPath, cheapOptions);
+    FBXExportOptions uncheckedOptions = nativeOptions;
+    uncheckedOptions.validation = FBXExportOptions::Validation::NONE;
+    const bool uncheckedExported = FBXExporter().ExportAnimatedMesh(animatedMesh, wave, brokenPath, uncheckedOptions).success;
+    FBXUtils::FBXFileCheck badIndexCheck = FBXUtils::CheckFBXFile(brokenPath);
+    animatedMesh.indices[2] = 2;
+
+    fs::copy_file(checkedPath, brokenPath, fs::copy_options::overwrite_existing);
+    fs::resize_file(brokenPath, fs::file_size(brokenPath) - 200);
+    bool validatorOk = false;
+    {
+        OutputValidator validator;
+        bool goodJobRan = false, badJobRan = false;
+        validator.Submit(checkedPath);
+        validator.Submit(brokenPath);
+        validator.Then({checkedPath}, [&goodJobRan]() { goodJobRan = true; });
+        validator.Then({checkedPath, brokenPath}, [&badJobRan]() { badJobRan = true; });
+        validator.Flush();
+        validatorOk = validator.GetError(checkedPath).empty() && !validator.GetError(brokenPath).empty() &&
+                      goodJobRan && !badJobRan && validator.GetStatistics().items == 2;
+    }
+    const bool truncatedRejected = !FBXUtils::IsValidFBXFile(brokenPath);
+    std::remove(checkedPath.c_str());
+    std::remove(brokenPath.c_str());
+    if (!fullExported || !goodCheck.valid || !goodCheck.binary || goodCheck.version != 7400 || goodCheck.topLevel != 11 ||
+        goodCheck.geometries != 1 || goodCheck.vertices != 3 || goodCheck.polygons != 1 || cheapResult.success ||
+        cheapResult.errorMessage.find("Validation failed") != 0 || !uncheckedExported || badIndexCheck.valid ||
+        badIndexCheck.error.find("out of range") == std::string::npos || !truncatedRejected || !validatorOk) {
+        std::cout << "  FAIL: Output validation incorrect (" << goodCheck.error << ")" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Output validation" << std::endl;
+    return true;
+}
+
+bool TestTextureLibrary() {
+    std::cout << "Testing texture library..." << std::endl;
+
+    // Texture library: two meshes next to each other look up and read each
+    // file once; embedded files become Video content, referenced ones do not
+    XMeshData animatedMesh;
+    XAnimationSet wave;
+    BuildSkinnedTriangle(animatedMesh, wave);
+    FBXExportOptions nativeOptions;
+    nativeOptions.backend = FBXExportOptions::Backend::NATIVE;
+    fs::path textureRoot = fs::temp_directory_path() / "x2fbx_test_textures";
+    fs::remove_all(textureRoot);
+    fs::create_directories(textureRoot / "library");
+    const std::string skinBytes = "skin-image-bytes";
+    std::ofstream(textureRoot / "skin.png", std::ios::binary) << skinBytes;
+    std::ofstream(textureRoot / "library" / "bump.png", std::ios::binary) << "bump-image-bytes";
+    animatedMesh.materials[0].normalTexture = "C:\\art\\maps\\bump.png";
+    TextureLibraryOptions libraryOptions;
+    libraryOptions.searchDirectories = {(textureRoot / "library").string()};
+    std::vector<uint8_t> embeddedBytes, referencedBytes;
+    TextureLibraryStatistics textureStats;
+    bool texturesResolved = false;
+    {
+        TextureLibrary library(libraryOptions);
+        auto first = library.Request(animatedMesh, (textureRoot / "a.x").string(), true);
+        auto second = library.Request(animatedMesh, (textureRoot / "b.x").string(), true);
+        auto skin = second->Get("skin.png");
+        auto bump = second->Get(animatedMesh.materials[0].normalTexture);
+        texturesResolved = first->GetCount() == 2 && skin && skin->content &&
+                           std::string(skin->content->begin(), skin->content->end()) == skinBytes &&
+                           bump && bump->IsResolved() && first->Fingerprint() == second->Fingerprint();
+
+        for (bool embed : {true, false}) {
+            FBXExportOptions textureOptions = nativeOptions;
+            textureOptions.textures = second;
+            textureOptions.embedTextures = embed;
+            const std::string texturePath = (textureRoot / "textured.fbx").string();
+            FBXExporter().ExportAnimatedMesh(animatedMesh, wave, texturePath, textureOptions);
+            std::ifstream textured(texturePath, std::ios::binary);
+            (embed ? embeddedBytes : referencedBytes)
+                .assign(std::istreambuf_iterator<char>(textured), std::istreambuf_iterator<char>());
+        }
+        textureStats = library.GetStatistics();
+    }
+    auto contains = [](const std::vector<uint8_t>& bytes, const std::string& text) {
+        return std::search(bytes.begin(), bytes.end(), text.begin(), text.end()) != bytes.end();
+    };
+    fs::remove_all(textureRoot);
+    if (!texturesResolved || textureStats.requests != 4 || textureStats.lookups != 2 || textureStats.loads != 2 ||
+        textureStats.missing != 0 || !contains(embeddedBytes, skinBytes) || !contains(embeddedBytes, "Video") ||
+        !contains(embeddedBytes, "NormalMap") || contains(referencedBytes, skinBytes) ||
+        !contains(referencedBytes, "skin.png")) {
+        std::cout << "  FAIL: Texture resolution or embedding incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Texture library" << std::endl;
+    return true;
+}
+
+#ifdef HAVE_ZLIB
+bool TestParallelDeflate() {
+    std::cout << "Testing parallel deflate..." << std::endl;
+
+    // Chunked deflate joins into one zlib stream, whatever the thread count
+    std::vector<uint8_t> plain(600 * 1024);
+    for (size_t i = 0; i < plain.size(); i++) {
+        plain[i] = static_cast<uint8_t>((i * 7) ^ (i >> 9));
+    }
+    std::vector<uint8_t> packedSerial, packedParallel;
+    bool deflated = ParallelDeflate::Compress(plain.data(), plain.size(), 9, 1, packedSerial, 64 * 1024) &&
+                    ParallelDeflate::Compress(plain.data(), plain.size(), 9, 4, packedParallel, 64 * 1024);
+    std::vector<uint8_t> inflated(plain.size());
+    uLongf inflatedSize = static_cast<uLongf>(inflated.size());
+    if (!deflated || packedSerial != packedParallel || packedSerial.size() >= plain.size() ||
+        uncompress(inflated.data(), &inflatedSize, packedParallel.data(), packedParallel.size()) != Z_OK ||
+        inflatedSize != plain.size() || inflated != plain) {
+        std::cout << "  FAIL: Parallel deflate incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Parallel deflate" << std::endl;
+    return true;
+}
+#endif
+
+bool TestPipelineHandoff() {
+    std::cout << "Testing parse-to-export handoff..." << std::endl;
+
+    // Pipeline handoff: taking the parse, correcting the timing and
+    // handing the mesh on moves the streams; with allocation tracking
+    // built in, nothing as large as half the positions is allocated
+    fs::path handoffPath = fs::temp_directory_path() / "x2fbx_test_handoff.x";
+    const size_t handoffVertices = 100000;
+    {
+        std::ofstream handoff(handoffPath);
+        handoff << "xof 0303txt 0032\nFrame Root { Frame Arm { FrameTransformMatrix { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1;; }\n"
+                   "  Mesh Grid { " << handoffVertices << ";\n";
+        for (size_t i = 0; i < handoffVertices; i++) {
+            handoff << i % 100 << ";" << i / 100 << ";0;" << (i + 1 < handoffVertices ? "," : ";") << "\n";
+        }
+        handoff << "1; 3;0,1,2;; } } }\n"
+                   "AnimationSet Wave { Animation { { Arm } AnimationKey { 0; 2; 0;4;1,0,0,0;;, 4800;4;0.7071,0,0,0.7071;;; } } }\n";
+    }
+    EnhancedXFileParser handoffParser;
+    bool handoffParsed = handoffParser.ParseFile(handoffPath.string());
+    const size_t largeAllocation = handoffVertices * sizeof(XVector3) / 2;
+    AllocationTracker::Start(largeAllocation);
+    XFileData taken = handoffParser.TakeParsedData();
+    XFileData handed = std::move(taken);
+    AnimationTimingCorrector().CorrectAllAnimations(handed.meshData.animations);
+    XMeshData exported = std::move(handed.meshData);
+    AllocationTracker::Stats handoffAllocations = AllocationTracker::Stop();
+    fs::remove(handoffPath);
+    if (!handoffParsed || exported.positions.size() != handoffVertices || exported.animations.size() != 1 ||
+        !handed.meshData.positions.empty() ||
+        (AllocationTracker::IsAvailable() && handoffAllocations.largeAllocations != 0)) {
+        std::cout << "  FAIL: Parse-to-export handoff copied the mesh (" << handoffAllocations.largestBytes
+                  << " byte allocation)" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Parse-to-export handoff" << std::endl;
+    return true;
+}
+
+bool TestExporterPool() {
+    std::cout << "Testing exporter pool..." << std::endl;
+
+    // Exporter pool: a returned exporter is handed out again, and a
+    // second concurrent lease has to construct its own
+    FBXExporterPool& exporterPool = FBXExporterPool::GetInstance();
+    exporterPool.Clear();
+    FBXExporterPoolStatistics poolBefore = exporterPool.GetStatistics();
+    FBXExporter* firstExporter = nullptr;
+    {
+        FBXExporterPool::Lease first = exporterPool.Acquire();
+        firstExporter = first.get();
+    }
+    FBXExporterPool::Lease reused = exporterPool.Acquire();
+    FBXExporterPool::Lease concurrent = exporterPool.Acquire();
+    FBXExporterPoolStatistics poolLeased = exporterPool.GetStatistics();
+    bool reusedFirst = reused.get() == firstExporter && concurrent.get() != firstExporter;
+    reused.Reset();
+    concurrent.Reset();
+    FBXExporterPoolStatistics poolAfter = exporterPool.GetStatistics();
+    if (!reusedFirst || poolLeased.hits - poolBefore.hits != 1 || poolLeased.misses - poolBefore.misses != 2 ||
+        poolLeased.idle != 0 || poolAfter.idle != 2) {
+        std::cout << "  FAIL: Exporter pool reuse or counters incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Exporter pool" << std::endl;
+    return true;
+}
+
+bool TestProfiler() {
+    std::cout << "Testing profiler..." << std::endl;
+
+    // Profiler: TimingLogger scopes nest per thread and aggregate by path
+    Profiler& profiler = Profiler::GetInstance();
+    profiler.Enable(true);
+    profiler.Reset();
+    {
+        TimingLogger outer("ProfileOuter");
+        outer.AddBytes(100);
+        for (int i = 0; i < 2; i++) {
+            TIME_OPERATION("ProfileInner");
+        }
+        std::thread worker([]() { TIME_OPERATION("ProfileWorker"); });
+        worker.join();
+    }
+    profiler.Enable(false);
+    auto totals = profiler.GetTotals();
+    if (totals.size() != 3 || totals["ProfileOuter"].count != 1 || totals["ProfileOuter"].bytes != 100 ||
+        totals["ProfileOuter/ProfileInner"].count != 2 || totals["ProfileWorker"].count != 1 ||
+        totals["ProfileOuter"].SelfMs() < 0.0) {
+        std::cout << "  FAIL: Profiler scope aggregation incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Profiler scopes" << std::endl;
+    return true;
+}
+
+bool RunAllDataStructureTests() {
+    std::cout << "\n=== Data Structure Tests ===" << std::endl;
+
+    bool allPassed = true;
+
+    allPassed &= TestKeyframeCurves();
+    allPassed &= TestSkinClusters();
+    allPassed &= TestBoneHierarchy();
+    allPassed &= TestMatrixMath();
+    allPassed &= TestMeshOptimizer();
+    allPassed &= TestMaterialBatching();
+    allPassed &= TestStreamingExport();
+    allPassed &= TestCoordinateKernels();
+    allPassed &= TestNativeFBXWriter();
+    allPassed &= TestOutputValidation();
+    allPassed &= TestTextureLibrary();
+#ifdef HAVE_ZLIB
+    allPassed &= TestParallelDeflate();
+#endif
+    allPassed &= TestPipelineHandoff();
+    allPassed &= TestExporterPool();
+    allPassed &= TestProfiler();
+
+    if (allPassed) {
+        std::cout << "\n✓ All data structure tests PASSED!" << std::endl;
+    } else {
+        std::cout << "\n✗ Some data structure tests FAILED!" << std::endl;
+    }
+
+    return allPassed;
+}
@@ -1,9 +1,11 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <cmath>
 
 // Project headers
 #include "XFileData.h"
+#include "XFileParser.h"
 #include "AnimationTimingCorrector.h"
 #include "Logger.h"
 
@@ -13,6 +15,10 @@ using namespace X2FBX;
 bool TestTimingCorrector();
 bool TestXFileParser();
 bool TestDataStructures();
+bool RunAllXFileParserTests();
+bool RunAllDataStructureTests();
+bool RunAllTimingCorrectorTests();
+bool RunAllServiceTests();
 
 int main(int argc, char* argv[]) {
     std::cout << "X2FBX Converter Test Suite" << std::endl;
@@ -28,6 +34,7 @@ int main(int argc, char* argv[]) {
     bool runTiming = false;
     bool runParser = false;
     bool runData = false;
+    bool runServices = false;
 
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
@@ -40,6 +47,9 @@ int main(int argc, char* argv[]) {
         } else if (arg == "--test-data") {
             runData = true;
             runAll = false;
+        } else if (arg == "--test-services") {
+            runServices = true;
+            runAll = false;
         }
     }
 
@@ -73,6 +83,16 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    if (runAll || runServices) {
+        std::cout << "\nRunning Conversion Service Tests..." << std::endl;
+        if (RunAllServiceTests()) {
+            std::cout << "✓ Conversion Service Tests PASSED" << std::endl;
+        } else {
+            std::cout << "✗ Conversion Service Tests FAILED" << std::endl;
+            allTestsPassed = false;
+        }
+    }
+
     std::cout << "\n==========================" << std::endl;
     if (allTestsPassed) {
         std::cout << "All tests PASSED!" << std::endl;
@@ -116,15 +136,31 @@ bool TestDataStructures() {
     // Add basic valid data
     XVertex vertex;
     vertex.position = XVector3(0, 0, 0);
-    meshData.vertices.push_back(vertex);
-    meshData.vertices.push_back(XVertex());
-    meshData.vertices.push_back(XVertex());
+    meshData.AddVertex(vertex);
+    meshData.AddVertex(XVertex());
+    meshData.AddVertex(XVertex());
 
     XFace face;
     face.indices[0] = 0;
     face.indices[1] = 1;
     face.indices[2] = 2;
-    meshData.faces.push_back(face);
+    meshData.AddFace(face);
+
+    // Compatibility accessors read back from the flat streams
+    if (meshData.GetFace(0).indices[2] != 2 || meshData.indices.size() != 3 || meshData.HasNormals()) {
+        std::cout << "  FAIL: Face/vertex streams not stored as expected" << std::endl;
+        return false;
+    }
+
+    // Skin influences are capped at four; the weakest one is replaced
+    XVertexInfluences influences;
+    for (int bone = 0; bone < 4; bone++) {
+        influences.Add(bone, 0.1f + bone * 0.1f);
+    }
+    if (influences.Add(4, 0.5f) || influences.GetCount() != 4 || influences.boneIndices[0] != 4) {
+        std::cout << "  FAIL: Fifth influence should replace the weakest slot" << std::endl;
+        return false;
+    }
 
     if (!meshData.IsValid()) {
         auto errors = meshData.GetValidationErrors();
@@ -136,7 +172,9 @@ bool TestDataStructures() {
     }
 
     std::cout << "  Data structure tests completed successfully" << std::endl;
-    return true;
+
+    // Full data structure suite (test_data_structures.cpp)
+    return RunAllDataStructureTests();
 }
 
 bool TestTimingCorrector() {
@@ -149,17 +187,12 @@ bool TestTimingCorrector() {
     testAnim1.ticksPerSecond = 4800.0f;
 
     // Add some keyframes
-    XKeyframe keyframe1;
-    keyframe1.time = 0;
-    testAnim1.keyframes.push_back(keyframe1);
-
-    XKeyframe keyframe2;
-    keyframe2.time = 2400.0f;  // 0.5 seconds
-    testAnim1.keyframes.push_back(keyframe2);
-
-    XKeyframe keyframe3;
-    keyframe3.time = 4800.0f;  // 1.0 seconds
-    testAnim1.keyframes.push_back(keyframe3);
+    XBoneTrack track;
+    const float position[3] = {0.0f, 0.0f, 0.0f};
+    track.translation.AddKey(0, position, XBoneTrack::VECTOR_COMPONENTS);
+    track.translation.AddKey(2400.0f, position, XBoneTrack::VECTOR_COMPONENTS);  // 0.5 seconds
+    track.translation.AddKey(4800.0f, position, XBoneTrack::VECTOR_COMPONENTS);  // 1.0 seconds
+    testAnim1.tracks.push_back(track);
 
     TimingCorrectionResult result1 = corrector.CorrectAnimationTiming(testAnim1);
 
@@ -203,7 +236,7 @@ bool TestTimingCorrector() {
     }
 
     std::cout << "  Timing corrector tests completed successfully" << std::endl;
-    return true;
+    return RunAllTimingCorrectorTests();
 }
 
 bool TestXFileParser() {
@@ -265,5 +298,7 @@ bool TestXFileParser() {
     }
 
     std::cout << "  X File parser tests completed successfully" << std::endl;
-    return true;
+
+    // Full parser suite (test_xfile_parser.cpp)
+    return RunAllXFileParserTests();
 }
@@ -0,0 +1,468 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BatchConverter.h"
+#include "BatchPipeline.h"
+#include "ConversionCache.h"
+#include "ConversionMetrics.h"
+#include "ConversionReport.h"
+#include "ConversionServer.h"
+#include "Logger.h"
+
+// Conversion services around the parser and exporters: the conversion
+// cache and its stages, the batch pipeline, the conversion server,
+// progress metrics, conversion reports and the asynchronous logger
+
+using namespace X2FBX;
+namespace fs = std::filesystem;
+
+// Test helper functions
+
+// A skinned triangle with two clips; nodAngle changes the Nod clip only
+void WriteTwoClipRig(const fs::path& path, const char* nodAngle) {
+    std::ofstream(path) << "xof 0303txt 0032\n"
+        "Frame Root { Frame Arm { FrameTransformMatrix { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,1,0,1;; } }\n"
+        "  Mesh Tri { 3; 0;0;0;, 1;0;0;, 0;1;0;; 1; 3;0,1,2;;\n"
+        "    SkinWeights { \"Arm\"; 3; 0,1,2; 1,1,1; 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,-1,0,1;; } } }\n"
+        "AnimationSet Wave { Animation { { Arm } AnimationKey { 0; 2; 0;4;1,0,0,0;;, 4800;4;0.7071,0,0,0.7071;;; } } }\n"
+        "AnimationSet Nod { Animation { { Arm } AnimationKey { 0; 2; 0;4;1,0,0,0;;, 4800;4;"
+        << nodAngle << ",0.5,0,0;;; } } }\n";
+}
+
+// Test functions
+bool TestConversionCache() {
+    std::cout << "Testing conversion cache..." << std::endl;
+
+    // Outputs and report round-trip under a new base name, and least
+    // recently used entries go first past the size limit
+    if (ConversionCache::HashBytes(nullptr, 0) != 0xEF46DB3751D8E999ull) {
+        std::cout << "  FAIL: XXH64 of empty input incorrect" << std::endl;
+        return false;
+    }
+    fs::path cacheRoot = fs::temp_directory_path() / "x2fbx_test_cache";
+    fs::remove_all(cacheRoot);
+    fs::create_directories(cacheRoot / "out");
+    std::ofstream(cacheRoot / "walk_Run.fbx") << std::string(600, 'a');
+    std::ofstream(cacheRoot / "walk_Idle.fbx") << std::string(600, 'b');
+    ConversionCacheOptions cacheOptions;
+    cacheOptions.directory = (cacheRoot / "store").string();
+    cacheOptions.maxBytes = 3000;          // Room for two entries
+    ConversionCache cache(cacheOptions);
+    CachedConversion stored;
+    stored.outputPaths = {(cacheRoot / "walk_Run.fbx").string(), (cacheRoot / "walk_Idle.fbx").string()};
+    stored.timingReport.push_back({LogLevel::ERROR, "Failed to correct: 1 animations"});
+    CachedConversion restored;
+    bool cached = cache.Store("entry1", "walk", stored) &&
+                  cache.Restore("entry1", (cacheRoot / "out").string(), "run", restored);
+    bool restoredFiles = restored.outputPaths.size() == 2 && fs::file_size(cacheRoot / "out" / "run_Idle.fbx") == 600 &&
+                         restored.timingReport.size() == 1 && restored.timingReport[0].level == LogLevel::ERROR &&
+                         restored.timingReport[0].text == stored.timingReport[0].text;
+    // entry1 was just used, so storing a third entry evicts entry2
+    cache.Store("entry2", "walk", stored);
+    cache.Restore("entry1", (cacheRoot / "out").string(), "run", restored);
+    cache.Store("entry3", "walk", stored);
+    bool evicted = fs::exists(cacheRoot / "store" / "entry1") && !fs::exists(cacheRoot / "store" / "entry2") &&
+                   fs::exists(cacheRoot / "store" / "entry3") && cache.GetStatistics().evictions == 1 &&
+                   !cache.Restore("entry2", (cacheRoot / "out").string(), "run", restored);
+    // The running size matches a fresh scan of the directory at open
+    uint64_t runningBytes = cache.GetStatistics().bytes;
+    bool sized = runningBytes > 2 * 1200 && runningBytes <= cacheOptions.maxBytes &&
+                 ConversionCache(cacheOptions).GetStatistics().bytes == runningBytes;
+    fs::remove_all(cacheRoot);
+    if (!cached || !restoredFiles || !evicted || !sized) {
+        std::cout << "  FAIL: Conversion cache store/restore/eviction incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Conversion cache" << std::endl;
+    return true;
+}
+
+bool TestIncrementalConversion() {
+    std::cout << "Testing incremental conversion..." << std::endl;
+
+    // A changed export option reuses the prepared data, and after an edit
+    // only the clip whose keys changed is exported
+    fs::path stageRoot = fs::temp_directory_path() / "x2fbx_test_stages";
+    fs::remove_all(stageRoot);
+    fs::create_directories(stageRoot);
+    WriteTwoClipRig(stageRoot / "rig.x", "0.5");
+    ConversionCacheOptions stageCacheOptions;
+    stageCacheOptions.directory = (stageRoot / "cache").string();
+    ConversionCache stageCache(stageCacheOptions);
+    BatchOptions stageOptions;
+    stageOptions.fbxBackend = FBXExportOptions::Backend::NATIVE;
+    BatchWorker stageWorker;
+    std::string rigPath = (stageRoot / "rig.x").string();
+    std::string rigOutput = (stageRoot / "out").string();
+    BatchFileResult fresh = stageWorker.Convert(rigPath, rigOutput, stageOptions, stageCache);
+    stageOptions.compressionLevel = 1;
+    BatchFileResult reexported = stageWorker.Convert(rigPath, rigOutput, stageOptions, stageCache);
+    stageOptions.compressionLevel = FBXExportOptions().compressionLevel;
+    WriteTwoClipRig(stageRoot / "rig.x", "0.6");
+    BatchFileResult edited = stageWorker.Convert(rigPath, rigOutput, stageOptions, stageCache);
+    bool stagesReused = fresh.success && fresh.filesWritten == 2 && !fresh.parseSkipped && fresh.clipsRestored == 0 &&
+                        reexported.success && !reexported.cacheHit && reexported.parseSkipped &&
+                        reexported.clipsRestored == 0 &&
+                        edited.success && !edited.cacheHit && !edited.parseSkipped && edited.clipsRestored == 1 &&
+                        fs::exists(stageRoot / "out" / "rig_Wave.fbx") && fs::exists(stageRoot / "out" / "rig_Nod.fbx");
+    fs::remove_all(stageRoot);
+    if (!stagesReused) {
+        std::cout << "  FAIL: Incremental conversion stages not reused as expected" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Incremental conversion" << std::endl;
+    return true;
+}
+
+bool TestConversionServer() {
+    std::cout << "Testing conversion server requests..." << std::endl;
+
+    // Requests are parsed, answered and echo their id without a socket;
+    // failures come back as JSON rather than throwing
+    ConversionServerOptions serverOptions;
+    serverOptions.defaults.outputDirectory = (fs::temp_directory_path() / "x2fbx_test_server").string();
+    ConversionServer server(serverOptions);
+    BatchWorker serverWorker;
+    std::string missingFile = server.HandleRequest("{\"id\": \"m1\", \"input\": \"/nonexistent/x2fbx.x\", "
+                                                   "\"animations\": [\"Walk\"], \"compressionLevel\": 3}", serverWorker);
+    std::string malformed = server.HandleRequest("{\"input\": ", serverWorker);
+    std::string unknownField = server.HandleRequest("{\"input\": \"a.x\", \"speed\": 2}", serverWorker);
+    std::string ping = server.HandleRequest("{\"id\": 4, \"command\": \"ping\"}", serverWorker);
+    fs::remove_all(serverOptions.defaults.outputDirectory);
+    if (missingFile.find("\"id\": \"m1\", \"success\": false") != 1 ||
+        missingFile.find("\"exports\": []") == std::string::npos ||
+        malformed.find("\"success\": false") == std::string::npos ||
+        unknownField.find("Unknown or mistyped request field: speed") == std::string::npos ||
+        ping.find("\"id\": 4, \"success\": true, \"requests\": 4") != 1 || server.GetRequestsHandled() != 4) {
+        std::cout << "  FAIL: Conversion server request handling incorrect" << std::endl;
+        return false;
+    }
+
+    // Only strings and JSON numbers are echoed as the id; replies stay valid JSON
+    const char* rejectedIds[] = {"[]", "true", "nan", "0x1f", "01", "1."};
+    for (const char* rejectedId : rejectedIds) {
+        std::string reply = server.HandleRequest(std::string("{\"id\": ") + rejectedId + ", \"command\": \"ping\"}",
+                                                 serverWorker);
+        if (reply.find("{\"id\": null, \"success\": false") != 0) {
+            std::cout << "  FAIL: Server echoed invalid id " << rejectedId << ": " << reply << std::endl;
+            return false;
+        }
+    }
+    // \u takes exactly four hex digits
+    std::string badEscape = server.HandleRequest("{\"id\": 6, \"input\": \"a\\u00zzb.x\"}", serverWorker);
+    if (badEscape.find("{\"id\": null, \"success\": false, \"error\": \"Malformed request") != 0) {
+        std::cout << "  FAIL: Server accepted a malformed \\u escape: " << badEscape << std::endl;
+        return false;
+    }
+    std::string numberId = server.HandleRequest("{\"id\": -1.5e3, \"command\": \"ping\"}", serverWorker);
+    if (numberId.find("{\"id\": -1.5e3, \"success\": true") != 0) {
+        std::cout << "  FAIL: Server did not echo numeric id: " << numberId << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Conversion server requests" << std::endl;
+    return true;
+}
+
+bool TestConversionMetrics() {
+    std::cout << "Testing conversion metrics..." << std::endl;
+
+    // A conversion counts its bytes, objects, keys and stages, and its
+    // worker is listed idle afterwards; the text, the metrics file and the
+    // server's metrics command carry the same counters
+    fs::path metricsRoot = fs::temp_directory_path() / "x2fbx_test_metrics";
+    fs::remove_all(metricsRoot);
+    fs::create_directories(metricsRoot);
+    WriteTwoClipRig(metricsRoot / "rig.x", "0.5");
+    BatchOptions metricsOptions;
+    metricsOptions.fbxBackend = FBXExportOptions::Backend::NATIVE;
+    ConversionCache noCache{ConversionCacheOptions()};
+    BatchWorker worker;
+    MetricsSnapshot metricsBefore = ConversionMetrics::GetInstance().GetSnapshot();
+    BatchFileResult fresh = worker.Convert((metricsRoot / "rig.x").string(), (metricsRoot / "out").string(),
+                                           metricsOptions, noCache);
+    MetricsSnapshot metricsAfter = ConversionMetrics::GetInstance().GetSnapshot();
+    fs::remove_all(metricsRoot);
+
+    auto workerListed = [&](const MetricsSnapshot& snapshot) {
+        return std::any_of(snapshot.workers.begin(), snapshot.workers.end(), [&](const WorkerMetrics& listed) {
+            return listed.id == worker.metrics.GetId() && !listed.busy && listed.files > 0;
+        });
+    };
+    const size_t parseStage = static_cast<size_t>(ConversionStage::PARSE);
+    const size_t exportStage = static_cast<size_t>(ConversionStage::EXPORT);
+    std::string prometheus = ConversionMetrics::GetInstance().FormatPrometheus();
+    fs::path metricsPath = fs::temp_directory_path() / "x2fbx_test_metrics.prom";
+    { MetricsFileWriter writer(metricsPath.string(), 60.0); }
+    std::ifstream metricsFile(metricsPath);
+    std::string metricsText((std::istreambuf_iterator<char>(metricsFile)), std::istreambuf_iterator<char>());
+    metricsFile.close();
+    fs::remove(metricsPath);
+    ConversionServer server{ConversionServerOptions()};
+    BatchWorker serverWorker;
+    std::string metricsResponse = server.HandleRequest("{\"id\": 5, \"command\": \"metrics\"}", serverWorker);
+    std::string workerLine = "x2fbx_worker_busy{worker=\"" + std::to_string(worker.metrics.GetId()) + "\"} 0";
+    if (!fresh.success || metricsAfter.filesStarted - metricsBefore.filesStarted != 1 ||
+        metricsAfter.filesConverted - metricsBefore.filesConverted != 1 ||
+        metricsAfter.bytesRead - metricsBefore.bytesRead != fresh.inputBytes ||
+        metricsAfter.objectsParsed - metricsBefore.objectsParsed != 3 ||
+        metricsAfter.keysExported - metricsBefore.keysExported != 4 ||
+        metricsAfter.stageRuns[parseStage] - metricsBefore.stageRuns[parseStage] != 1 ||
+        metricsAfter.stageRuns[exportStage] - metricsBefore.stageRuns[exportStage] != 1 ||
+        !workerListed(metricsAfter) || prometheus.find(workerLine) == std::string::npos ||
+        prometheus.find("# TYPE x2fbx_keys_exported_total counter") == std::string::npos ||
+        metricsText.find("x2fbx_stage_seconds_total{stage=\"parse\"}") == std::string::npos ||
+        metricsResponse.find("\"id\": 5, \"success\": true, \"metrics\": \"# HELP x2fbx_uptime_seconds") != 1) {
+        std::cout << "  FAIL: Conversion metrics counters or output incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Conversion metrics" << std::endl;
+    return true;
+}
+
+bool TestBatchPipeline() {
+    std::cout << "Testing batch pipeline..." << std::endl;
+
+    // With a read-ahead budget of about one input and a write queue of one
+    // file, every input is still read ahead, every FBX file goes through
+    // the writer and the cache stores behind it land
+    fs::path pipelineRoot = fs::temp_directory_path() / "x2fbx_test_pipeline";
+    fs::remove_all(pipelineRoot);
+    fs::create_directories(pipelineRoot / "in");
+    const size_t pipelineFiles = 6;
+    for (size_t i = 0; i < pipelineFiles; i++) {
+        std::ofstream(pipelineRoot / "in" / ("tri" + std::to_string(i) + ".x"))
+            << "xof 0303txt 0032\nMesh Tri { 3; 0;0;0;, " << i + 1 << ";0;0;, 0;1;0;; 1; 3;0,1,2;; }\n";
+    }
+    BatchOptions pipelineOptions;
+    pipelineOptions.source = (pipelineRoot / "in").string();
+    pipelineOptions.outputDirectory = (pipelineRoot / "out").string();
+    pipelineOptions.jobs = 2;
+    pipelineOptions.fbxBackend = FBXExportOptions::Backend::NATIVE;
+    pipelineOptions.cache.directory = (pipelineRoot / "cache").string();
+    pipelineOptions.prefetch.maxBytes = 80;
+    pipelineOptions.writes.maxQueuedBytes = 1;
+    BatchSummary piped = BatchConverter(pipelineOptions).Run();
+    BatchSummary repeated = BatchConverter(pipelineOptions).Run();
+    bool pipelined = piped.succeeded == pipelineFiles && piped.readStage.items == pipelineFiles &&
+                     piped.writeStage.items == pipelineFiles && piped.convertStage.threads == 2 &&
+                     piped.convertStage.busySeconds > 0.0 && fs::exists(pipelineRoot / "out" / "tri5.fbx") &&
+                     repeated.cacheHits == pipelineFiles && repeated.writeStage.items == 0;
+
+    // A failed write is reported, and a job depending on it is skipped
+    bool dependentRan = false, independentRan = false;
+    std::string writeError;
+    {
+        OutputWriter writer;
+        const std::string badPath = (pipelineRoot / "missing" / "a.fbx").string();
+        writer.Write(badPath, std::vector<uint8_t>(16, 1));
+        writer.Then({badPath}, [&]() { dependentRan = true; });
+        writer.Then({}, [&]() { independentRan = true; });
+        writer.Flush();
+        writeError = writer.GetError(badPath);
+    }
+    fs::remove_all(pipelineRoot);
+    if (!pipelined || dependentRan || !independentRan || writeError.empty()) {
+        std::cout << "  FAIL: Batch pipeline stages incorrect (" << piped.succeeded << " converted, "
+                  << piped.readStage.items << " read ahead, " << piped.writeStage.items << " written)" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Batch pipeline" << std::endl;
+    return true;
+}
+
+bool TestBatchOutputPaths() {
+    std::cout << "Testing batch output paths..." << std::endl;
+
+    // Listed inputs mirror their directories below the directory they
+    // share, so a/hero.x and b/hero.x do not overwrite each other; the
+    // same input listed twice fails rather than racing on its outputs
+    fs::path root = fs::temp_directory_path() / "x2fbx_test_outputs";
+    fs::remove_all(root);
+    for (const char* directory : {"in/a", "in/b", "in/.assets"}) {
+        fs::create_directories(root / directory);
+        std::ofstream(root / directory / "hero.x") << "xof 0303txt 0032\nMesh Tri { 3; 0;0;0;, 1;0;0;, 0;1;0;; 1; 3;0,1,2;; }\n";
+    }
+    std::ofstream(root / "list.txt") << (root / "in/a/hero.x").string() << "\n" << (root / "in/b/hero.x").string()
+                                     << "\n" << (root / "in/a/hero.x").string() << "\n";
+    BatchOptions listOptions;
+    listOptions.source = (root / "list.txt").string();
+    listOptions.outputDirectory = (root / "listed").string();
+    listOptions.jobs = 2;
+    listOptions.fbxBackend = FBXExportOptions::Backend::NATIVE;
+    BatchSummary listed = BatchConverter(listOptions).Run();
+
+    // Dot-prefixed subdirectories of a scanned directory are mirrored too
+    BatchOptions scanOptions = listOptions;
+    scanOptions.source = (root / "in").string();
+    scanOptions.outputDirectory = (root / "scanned").string();
+    BatchSummary scanned = BatchConverter(scanOptions).Run();
+
+    bool separated = listed.succeeded == 2 && listed.failed == 1 && !listed.results[2].success &&
+                     listed.results[2].errorMessage.find("overwrite") != std::string::npos &&
+                     fs::exists(root / "listed" / "a" / "hero.fbx") && fs::exists(root / "listed" / "b" / "hero.fbx") &&
+                     scanned.succeeded == 3 && fs::exists(root / "scanned" / ".assets" / "hero.fbx");
+    fs::remove_all(root);
+    if (!separated) {
+        std::cout << "  FAIL: Batch outputs collide or are misplaced (" << listed.succeeded << " listed, "
+                  << scanned.succeeded << " scanned)" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Batch output paths" << std::endl;
+    return true;
+}
+
+bool TestConversionReport() {
+    std::cout << "Testing conversion report..." << std::endl;
+
+    // Stage laps add up to the total, and geometry counts every mesh
+    XMeshData triangle;
+    triangle.positions = {XVector3(0, 0, 0), XVector3(1, 0, 0), XVector3(0, 1, 0)};
+    triangle.indices = {0, 1, 2};
+    triangle.faceMaterials = {0};
+    ConversionRecord record;
+    record.input = "C:\\assets\\\"hero\".x";
+    {
+        StageRecorder costs(record, StageClock::Scope::THREAD, &record.parse);
+        costs.Enter(&record.correct);
+        costs.Enter(&record.exported);
+    }
+    XFileData countedFile;
+    countedFile.meshData = triangle.Clone();
+    countedFile.meshes.push_back(triangle.Clone());
+    record.SetCounts(countedFile);
+    double stageWallMs = record.parse.wallMs + record.correct.wallMs + record.exported.wallMs;
+    std::string recordJson = record.ToJson();
+    if (record.parse.wallMs < 0.0 || record.exported.cpuMs < 0.0 ||
+        std::abs(stageWallMs - record.total.wallMs) > 1e-6 || record.vertices != 2 * triangle.GetVertexCount() ||
+        record.faces != 2 * triangle.GetFaceCount() ||
+        recordJson.rfind("{\"type\": \"file\"", 0) != 0 || recordJson.back() != '}' ||
+        recordJson.find("\"export\": {\"wallMs\"") == std::string::npos ||
+        recordJson.find("\\\"hero\\\"") == std::string::npos) {
+        std::cout << "  FAIL: Conversion record incorrect: " << recordJson << std::endl;
+        return false;
+    }
+
+    // A batch report is one NDJSON line per file, in input order, then the batch
+    BatchSummary reportSummary;
+    for (int i = 0; i < 2; i++) {
+        BatchFileResult fileResult;
+        fileResult.success = i == 0;
+        fileResult.report = record;
+        fileResult.report.success = fileResult.success;
+        reportSummary.results.push_back(fileResult);
+    }
+    reportSummary.totalFiles = 2;
+    reportSummary.succeeded = 1;
+    reportSummary.failed = 1;
+    const std::string reportPath = (fs::temp_directory_path() / "x2fbx_test_report.ndjson").string();
+    if (!BatchConverter::WriteReport(reportSummary, reportPath)) {
+        std::cout << "  FAIL: Batch report not written" << std::endl;
+        return false;
+    }
+    std::vector<std::string> reportLines;
+    {
+        std::ifstream reportFile(reportPath);
+        for (std::string line; std::getline(reportFile, line);) {
+            reportLines.push_back(line);
+        }
+    }
+    std::remove(reportPath.c_str());
+    if (reportLines.size() != 3 || reportLines[1].find("\"success\": false") == std::string::npos ||
+        reportLines[2].rfind("{\"type\": \"batch\", \"files\": 2", 0) != 0) {
+        std::cout << "  FAIL: Batch report lines incorrect" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Conversion report" << std::endl;
+    return true;
+}
+
+bool TestAsyncLogging() {
+    std::cout << "Testing asynchronous logging..." << std::endl;
+
+    // Filtered messages are never built, and every message from
+    // concurrent producers reaches the file once Flush returns
+    Logger& logger = Logger::GetInstance();
+    int messagesBuilt = 0;
+    auto buildMessage = [&messagesBuilt]() { messagesBuilt++; return std::string("filtered"); };
+    logger.SetLogLevel(LogLevel::WARNING);
+    LOG_DEBUG(buildMessage());
+    LOG_INFO(buildMessage());
+    logger.SetLogLevel(LogLevel::DEBUG);
+    if (messagesBuilt != 0) {
+        std::cout << "  FAIL: Filtered log message was built" << std::endl;
+        return false;
+    }
+
+    const int producers = 4;
+    const int messagesPerProducer = 2500;
+    const std::string marker = "async-log-check " + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    logger.EnableConsoleOutput(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < messagesPerProducer; i++) {
+                LOG_INFO(marker);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.Flush();
+    logger.EnableConsoleOutput(true);
+
+    std::ifstream logFile("test_log.txt");
+    std::string line;
+    int markerLines = 0;
+    while (std::getline(logFile, line)) {
+        if (line.find(marker) != std::string::npos) {
+            markerLines++;
+        }
+    }
+    if (markerLines != producers * messagesPerProducer) {
+        std::cout << "  FAIL: Expected " << producers * messagesPerProducer << " logged lines, found "
+                  << markerLines << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Asynchronous logging" << std::endl;
+    return true;
+}
+
+bool RunAllServiceTests() {
+    std::cout << "\n=== Conversion Service Tests ===" << std::endl;
+
+    bool allPassed = true;
+
+    allPassed &= TestConversionCache();
+    allPassed &= TestIncrementalConversion();
+    allPassed &= TestConversionServer();
+    allPassed &= TestConversionMetrics();
+    allPassed &= TestBatchPipeline();
+    allPassed &= TestBatchOutputPaths();
+    allPassed &= TestConversionReport();
+    allPassed &= TestAsyncLogging();
+
+    if (allPassed) {
+        std::cout << "\n✓ All conversion service tests PASSED!" << std::endl;
+    } else {
+        std::cout << "\n✗ Some conversion service tests FAILED!" << std::endl;
+    }
+
+    return allPassed;
+}
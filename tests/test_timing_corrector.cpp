@@ -1,7 +1,12 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <algorithm>
+#include <chrono>
+#include "AnimationResampler.h"
 #include "AnimationTimingCorrector.h"
+#include "CoordinateKernels.h"
+#include "KeyframeReducer.h"
 #include "Logger.h"
 
 using namespace X2FBX;
@@ -18,14 +23,14 @@ XAnimationSet CreateTestAnimation(const std::string& name, float duration, float
     anim.ticksPerSecond = ticksPerSecond;
 
     // Add some test keyframes
+    XBoneTrack track;
     for (int i = 0; i <= 3; i++) {
-        XKeyframe keyframe;
-        keyframe.time = (duration / 3.0f) * i;
-        keyframe.position = XVector3(i * 1.0f, 0, 0);
-        keyframe.rotation = XQuaternion(0, 0, 0, 1);
-        keyframe.scale = XVector3(1, 1, 1);
-        anim.keyframes.push_back(keyframe);
+        const float position[3] = {i * 1.0f, 0, 0};
+        const float rotation[4] = {0, 0, 0, 1};
+        track.translation.AddKey((duration / 3.0f) * i, position, XBoneTrack::VECTOR_COMPONENTS);
+        track.rotation.AddKey((duration / 3.0f) * i, rotation, XBoneTrack::ROTATION_COMPONENTS);
     }
+    anim.tracks.push_back(track);
 
     return anim;
 }
@@ -114,6 +119,7 @@ bool TestBatchCorrection() {
     std::cout << "Testing batch animation correction..." << std::endl;
 
     AnimationTimingCorrector corrector;
+    corrector.SetThreadCount(2);
 
     // Create multiple test animations
     std::vector<XAnimationSet> animations;
@@ -207,34 +213,268 @@ bool TestKeyframeTimeConversion() {
     AnimationTimingCorrector corrector;
 
     // Create keyframes with known timing
-    std::vector<XKeyframe> originalKeyframes;
+    XAnimationChannel convertedKeyframes;
     for (int i = 0; i < 3; i++) {
-        XKeyframe kf;
-        kf.time = i * 1600.0f; // 1600 ticks intervals
-        originalKeyframes.push_back(kf);
+        const float position[3] = {0, 0, 0};
+        convertedKeyframes.AddKey(i * 1600.0f, position, XBoneTrack::VECTOR_COMPONENTS); // 1600 ticks intervals
     }
 
-    // Convert from 4800 ticks/sec to 30 fps
-    std::vector<XKeyframe> convertedKeyframes = corrector.ConvertKeyframeTiming(
-        originalKeyframes, 4800.0f, 30.0f);
+    // Convert from 4800 ticks/sec to 30 fps, in place
+    corrector.ConvertKeyframeTiming(convertedKeyframes, 4800.0f, 30.0f);
 
-    if (convertedKeyframes.size() != originalKeyframes.size()) {
+    if (convertedKeyframes.GetKeyCount() != 3) {
         std::cout << "  FAIL: Keyframe count mismatch after conversion" << std::endl;
         return false;
     }
 
     // Check timing conversion (1600 ticks @ 4800 ticks/sec = 1/3 second = 10 frames @ 30fps)
     float expectedTime = (1600.0f / 4800.0f) * 30.0f; // Should be 10.0
-    if (!FloatEqual(convertedKeyframes[1].time, expectedTime)) {
-        std::cout << "  FAIL: Incorrect time conversion: " << convertedKeyframes[1].time <<
+    if (!FloatEqual(convertedKeyframes.times[1], expectedTime)) {
+        std::cout << "  FAIL: Incorrect time conversion: " << convertedKeyframes.times[1] <<
                      " (expected " << expectedTime << ")" << std::endl;
         return false;
     }
 
+    // Every bone track is rescaled in place along with the duration
+    XAnimationSet anim = CreateTestAnimation("rescale", 4800.0f, 4800.0f);
+    anim.tracks.push_back(anim.tracks[0]);
+    anim.tracks[1].boneId = 1;
+    const float* firstTimes = anim.tracks[1].rotation.times.data();
+    corrector.RescaleAnimationTimes(anim, 0.25f);
+    if (!FloatEqual(anim.duration, 1200.0f) || !FloatEqual(anim.tracks[0].translation.times[3], 1200.0f) ||
+        !FloatEqual(anim.tracks[1].rotation.times[3], 1200.0f) || anim.tracks[1].rotation.times.data() != firstTimes) {
+        std::cout << "  FAIL: Bone tracks were not rescaled in place" << std::endl;
+        return false;
+    }
+
+    // Vector and scalar lanes must agree, including the odd tail
+    std::vector<float> times(19);
+    for (size_t i = 0; i < times.size(); i++) {
+        times[i] = i * 160.0f;
+    }
+    TimingUtils::ScaleTimes(times.data(), times.size(), 0.5f);
+    for (size_t i = 0; i < times.size(); i++) {
+        if (times[i] != i * 80.0f) {
+            std::cout << "  FAIL: Vectorized rescale wrong at " << i << ": " << times[i] << std::endl;
+            return false;
+        }
+    }
+
     std::cout << "  PASS: Keyframe time conversion" << std::endl;
     return true;
 }
 
+bool TestKeyframeReduction() {
+    std::cout << "Testing keyframe reduction..." << std::endl;
+
+    KeyframeReductionOptions options;
+    options.threads = 2;
+    KeyframeReducer reducer(options);
+
+    // Linear motion with a corner at key 5, plus a constant rotation about Y
+    const float halfAngle = 0.1f;
+    XBoneTrack arm;
+    arm.boneId = 0;
+    for (int i = 0; i <= 10; i++) {
+        const float position[3] = {i <= 5 ? i : 5.0f, i <= 5 ? 0.0f : (i - 5.0f), 0.0f};
+        const float rotation[4] = {0.0f, std::sin(halfAngle * i), 0.0f, std::cos(halfAngle * i)};
+        arm.translation.AddKey(i * 160.0f, position, XBoneTrack::VECTOR_COMPONENTS);
+        arm.rotation.AddKey(i * 160.0f, rotation, XBoneTrack::ROTATION_COMPONENTS);
+    }
+
+    XBoneTrack root;
+    root.boneId = 1;
+    for (int i = 0; i < 8; i++) {
+        const float position[3] = {0.0f, 1.0f, 0.0f};
+        root.translation.AddKey(i * 160.0f, position, XBoneTrack::VECTOR_COMPONENTS);
+    }
+
+    XAnimationSet animation;
+    animation.tracks.push_back(arm);
+    animation.tracks.push_back(root);
+    KeyframeReductionResult result = reducer.ReduceAnimation(animation);
+
+    const XAnimationChannel& armPosition = animation.tracks[0].translation;
+    if (armPosition.GetKeyCount() != 3 || !FloatEqual(armPosition.times[1], 800.0f) ||
+        !FloatEqual(armPosition.times[2], 1600.0f) ||
+        !FloatEqual(armPosition.GetValue(1, XBoneTrack::VECTOR_COMPONENTS)[0], 5.0f)) {
+        std::cout << "  FAIL: Expected first, corner and last keys, got " << armPosition.GetKeyCount() << " keys" << std::endl;
+        return false;
+    }
+
+    if (animation.tracks[0].rotation.GetKeyCount() != 2) {
+        std::cout << "  FAIL: Slerp-reproducible rotation kept " << animation.tracks[0].rotation.GetKeyCount() <<
+                     " keys" << std::endl;
+        return false;
+    }
+
+    if (animation.tracks[1].translation.GetKeyCount() != 1 || result.constantChannels != 1) {
+        std::cout << "  FAIL: Constant channel was not collapsed" << std::endl;
+        return false;
+    }
+
+    if (result.originalKeys != 30 || result.RemovedKeys() != 24 || result.channels != 3 ||
+        result.BytesSaved() != 24 * KeyframeReductionResult::BYTES_PER_EXPORTED_KEY) {
+        std::cout << "  FAIL: Unexpected reduction totals " << result.RemovedKeys() << "/" <<
+                     result.originalKeys << std::endl;
+        return false;
+    }
+
+    // A key off the interpolated path must survive
+    XBoneTrack bump;
+    for (int i = 0; i < 3; i++) {
+        const float position[3] = {0.0f, i == 1 ? 0.01f : 0.0f, 0.0f};
+        bump.translation.AddKey(i * 160.0f, position, XBoneTrack::VECTOR_COMPONENTS);
+    }
+    if (reducer.ReduceTrack(bump).RemovedKeys() != 0) {
+        std::cout << "  FAIL: Key outside tolerance was removed" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Keyframe reduction (" << result.RemovedKeys() << " keys removed)" << std::endl;
+    return true;
+}
+
+bool TestAnimationResampling() {
+    std::cout << "Testing fixed-rate resampling..." << std::endl;
+
+    // One second at 4800 ticks/s: a linear slide, a 90 degree turn about Y
+    // and a constant scale, plus a bone keyed only inside the clip
+    XAnimationSet animation;
+    animation.name = "Turn";
+    animation.duration = 4800.0f;
+    animation.ticksPerSecond = 4800.0f;
+    XBoneTrack arm;
+    arm.boneId = 0;
+    const float start[3] = {0.0f, 0.0f, 0.0f};
+    const float end[3] = {10.0f, 0.0f, -4.0f};
+    const float identity[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    const float quarterTurn[4] = {0.0f, std::sin(0.25f * 3.14159265f), 0.0f, std::cos(0.25f * 3.14159265f)};
+    const float scale[3] = {2.0f, 2.0f, 2.0f};
+    arm.translation.AddKey(0.0f, start, XBoneTrack::VECTOR_COMPONENTS);
+    arm.translation.AddKey(4800.0f, end, XBoneTrack::VECTOR_COMPONENTS);
+    arm.rotation.AddKey(0.0f, identity, XBoneTrack::ROTATION_COMPONENTS);
+    arm.rotation.AddKey(4800.0f, quarterTurn, XBoneTrack::ROTATION_COMPONENTS);
+    arm.scale.AddKey(0.0f, scale, XBoneTrack::VECTOR_COMPONENTS);
+    XBoneTrack hand;
+    hand.boneId = 1;
+    const float early[3] = {1.0f, 2.0f, 3.0f};
+    const float late[3] = {3.0f, 2.0f, 1.0f};
+    hand.translation.AddKey(1200.0f, early, XBoneTrack::VECTOR_COMPONENTS);
+    hand.translation.AddKey(2400.0f, late, XBoneTrack::VECTOR_COMPONENTS);
+    animation.tracks.push_back(arm);
+    animation.tracks.push_back(hand);
+
+    AnimationResampleOptions options;
+    options.frameRate = 10.0f;
+    options.threads = 2;
+    std::vector<XAnimationSet> resampled = {animation};
+    AnimationResampleResult result = AnimationResampler(options).ResampleAllAnimations(resampled);
+
+    const XBoneTrack& outArm = resampled[0].tracks[0];
+    const XBoneTrack& outHand = resampled[0].tracks[1];
+    const float* middle = outArm.rotation.GetValue(5, XBoneTrack::ROTATION_COMPONENTS);
+    if (result.frames != 11 || result.channels != 4 || result.originalKeys != 7 || result.resampledKeys != 44 ||
+        outArm.translation.times != outHand.translation.times || outArm.rotation.times != outArm.scale.times ||
+        !FloatEqual(outArm.translation.times[10], 4800.0f) ||
+        !FloatEqual(outArm.translation.GetValue(5, 3)[0], 5.0f) ||
+        !FloatEqual(outArm.translation.GetValue(5, 3)[2], -2.0f) ||
+        !FloatEqual(middle[1], std::sin(0.125f * 3.14159265f)) ||
+        !FloatEqual(middle[3], std::cos(0.125f * 3.14159265f)) ||
+        !FloatEqual(outArm.scale.GetValue(7, 3)[1], 2.0f) ||
+        !FloatEqual(outHand.translation.GetValue(0, 3)[0], 1.0f) ||
+        !FloatEqual(outHand.translation.GetValue(4, 3)[0], 2.2f) ||
+        !FloatEqual(outHand.translation.GetValue(10, 3)[0], 3.0f)) {
+        std::cout << "  FAIL: Resampled keys incorrect (" << result.frames << " frames)" << std::endl;
+        return false;
+    }
+
+    // Scalar and SSE2 blends agree exactly, and a clip that ends between
+    // frames gets one more frame past its end
+    std::vector<XAnimationSet> scalar = {animation};
+    CoordinateKernels::SetScalarOnly(true);
+    options.threads = 1;
+    AnimationResampler(options).ResampleAllAnimations(scalar);
+    CoordinateKernels::SetScalarOnly(false);
+    animation.duration = 4900.0f;
+    if (scalar[0].tracks[0].rotation.values != outArm.rotation.values ||
+        scalar[0].tracks[0].translation.values != outArm.translation.values ||
+        scalar[0].tracks[1].translation.values != outHand.translation.values ||
+        AnimationResampler(options).ComputeFrameTimes(animation).size() != 12) {
+        std::cout << "  FAIL: Resampling differs between scalar and " << CoordinateKernels::GetActiveKernels()
+                  << " blends" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Fixed-rate resampling (" << result.resampledKeys << " keys, "
+              << CoordinateKernels::GetActiveKernels() << ")" << std::endl;
+    return true;
+}
+
+// The per-candidate approach the interval summary replaced: every
+// candidate copies the key times and sorts a copy of the intervals
+float MedianIntervalPerCandidate(const XAnimationSet& anim, size_t candidates) {
+    float median = 0.0f;
+    for (size_t c = 0; c < candidates; c++) {
+        std::vector<float> times = anim.tracks[0].rotation.times;
+        std::vector<float> intervals;
+        for (size_t i = 1; i < times.size(); i++) {
+            intervals.push_back(times[i] - times[i - 1]);
+        }
+        std::vector<float> sorted = intervals;
+        std::sort(sorted.begin(), sorted.end());
+        size_t middle = sorted.size() / 2;
+        median = sorted.size() % 2 == 0 ? (sorted[middle - 1] + sorted[middle]) / 2.0f : sorted[middle];
+    }
+    return median;
+}
+
+bool TestIntervalSummaryBenchmark() {
+    std::cout << "Benchmarking key interval statistics..." << std::endl;
+
+    AnimationTimingCorrector corrector;
+
+    // Irregular sampling so the median is not trivially the first interval
+    XAnimationSet anim;
+    anim.name = "bench";
+    XBoneTrack track;
+    float time = 0.0f;
+    for (int i = 0; i < 2000; i++) {
+        const float rotation[4] = {0, 0, 0, 1};
+        track.rotation.AddKey(time, rotation, XBoneTrack::ROTATION_COMPONENTS);
+        time += (i % 7 == 0) ? 320.0f : 160.0f;
+    }
+    anim.tracks.push_back(track);
+    anim.duration = time;
+
+    KeyIntervalSummary summary = corrector.SummarizeKeyIntervals(anim);
+    const size_t candidates = corrector.GetCandidateTickRates(anim).size();
+    if (summary.intervalCount != 1999 || summary.minInterval != 160.0f || summary.maxInterval != 320.0f ||
+        summary.medianInterval != MedianIntervalPerCandidate(anim, 1) || summary.histogram[7] != 1713) {
+        std::cout << "  FAIL: Interval summary incorrect (median " << summary.medianInterval << ")" << std::endl;
+        return false;
+    }
+
+    const int clips = 200;
+    float sink = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < clips; i++) {
+        sink += MedianIntervalPerCandidate(anim, candidates);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < clips; i++) {
+        sink += corrector.SummarizeKeyIntervals(anim).medianInterval;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double perCandidateMs = std::chrono::duration<double, std::milli>(middle - start).count();
+    double summaryMs = std::chrono::duration<double, std::milli>(end - middle).count();
+    std::cout << "  PASS: Interval statistics for " << clips << " clips x " << candidates << " candidates: " <<
+                 perCandidateMs << " ms with per-candidate passes, " << summaryMs << " ms with one summary (checksum " <<
+                 sink << ")" << std::endl;
+    return true;
+}
+
 // Main test runner
 bool RunAllTimingCorrectorTests() {
     std::cout << "\n=== Animation Timing Corrector Tests ===" << std::endl;
@@ -248,6 +488,9 @@ bool RunAllTimingCorrectorTests() {
     allPassed &= TestTickRateDetection();
     allPassed &= TestCandidateRates();
     allPassed &= TestKeyframeTimeConversion();
+    allPassed &= TestKeyframeReduction();
+    allPassed &= TestAnimationResampling();
+    allPassed &= TestIntervalSummaryBenchmark();
 
     if (allPassed) {
         std::cout << "\n✓ All timing corrector tests PASSED!" << std::endl;
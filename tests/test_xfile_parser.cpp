@@ -2,10 +2,24 @@
 #include <sstream>
 #include <fstream>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iterator>
 #include "XFileParser.h"
+#include "XFileTokenizer.h"
 #include "BinaryXFileParser.h"
+#include "MszipDecoder.h"
+#include "XFileSnapshot.h"
+#include "StreamQuantizer.h"
 #include "Logger.h"
 
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 using namespace X2FBX;
 
 // Test helper functions
@@ -160,13 +174,15 @@ bool TestAnimationParsing() {
     }
 
     const auto& animation = data.meshData.animations[0];
-    if (animation.keyframes.empty()) {
+    if (animation.GetKeyCount() == 0) {
         std::cout << "  FAIL: Animation has no keyframes" << std::endl;
         return false;
     }
 
-    if (animation.keyframes.size() != 3) {
-        std::cout << "  FAIL: Expected 3 keyframes, got " << animation.keyframes.size() << std::endl;
+    // Position keys only: the other channels carry no data
+    if (animation.tracks.size() != 1 || animation.tracks[0].translation.GetKeyCount() != 3 ||
+        !animation.tracks[0].rotation.IsEmpty() || !animation.tracks[0].scale.IsEmpty()) {
+        std::cout << "  FAIL: Expected 3 position keys, got " << animation.GetKeyCount() << " keys" << std::endl;
         return false;
     }
 
@@ -176,7 +192,7 @@ bool TestAnimationParsing() {
         return false;
     }
 
-    std::cout << "  PASS: Animation parsing (" << animation.keyframes.size() << " keyframes)" << std::endl;
+    std::cout << "  PASS: Animation parsing (" << animation.GetKeyCount() << " keyframes)" << std::endl;
     return true;
 }
 
@@ -399,17 +415,1143 @@ bool TestEnhancedParser() {
         return false;
     }
 
+    // One probe of the header carries everything the parse path needs
+    const char bzipHeader[] = "xof 0302bzip0064";
+    XFileProbe compressed = ProbeXFileData(ByteView(reinterpret_cast<const uint8_t*>(bzipHeader), 16));
+    XFileProbe simple = ProbeXFile("test_simple.x");
+    if (!compressed.recognized || compressed.header.format != XFileHeader::COMPRESSED ||
+        compressed.header.compression != XFileHeader::MSZIP || compressed.header.textPayload ||
+        compressed.header.floatSize != 64 || compressed.header.minorVersion != 2 ||
+        !simple.recognized || simple.header.format != XFileHeader::TEXT || ProbeXFile("nonexistent.x").readable ||
+        !enhancedParser.ParseFile("test_simple.x", simple) || !enhancedParser.GetParsedData().IsValid()) {
+        std::cout << "  FAIL: Incorrect header probe" << std::endl;
+        return false;
+    }
+
     std::cout << "  PASS: Enhanced parser" << std::endl;
     return true;
 }
 
+bool TestTokenizer() {
+    std::cout << "Testing text tokenizer..." << std::endl;
+
+    XFileTokenizer tokenizer("Mesh m { <3D82AB44-62DA-11CF-AB39-0020AF71E433>\n"
+                             "  2; // count\n  -1.5e2;, +3; \"a b\"; }");
+
+    XToken token = tokenizer.Next();
+    if (!token.IsIdentifier("Mesh") || !tokenizer.Next().IsIdentifier("m")) {
+        std::cout << "  FAIL: Expected identifiers 'Mesh m'" << std::endl;
+        return false;
+    }
+
+    if (!tokenizer.Accept(XTokenType::OPEN_BRACE) || !tokenizer.Next().Is(XTokenType::GUID)) {
+        std::cout << "  FAIL: Expected '{' followed by GUID" << std::endl;
+        return false;
+    }
+
+    uint32_t count = 0;
+    float value = 0.0f;
+    int intValue = 0;
+    std::string_view text;
+    if (!tokenizer.ReadUInt(count) || count != 2 ||
+        !tokenizer.ReadFloat(value) || std::abs(value + 150.0f) > 0.001f ||
+        !tokenizer.ReadInt(intValue) || intValue != 3 ||
+        !tokenizer.ReadString(text) || text != "a b") {
+        std::cout << "  FAIL: Incorrect values read from token stream" << std::endl;
+        return false;
+    }
+
+    tokenizer.SkipSeparators();
+    if (tokenizer.GetLine() != 3 || !tokenizer.Accept(XTokenType::CLOSE_BRACE) || !tokenizer.AtEnd()) {
+        std::cout << "  FAIL: Incorrect line tracking or trailing tokens" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Text tokenizer" << std::endl;
+    return true;
+}
+
+bool TestMetadataObjects() {
+    std::cout << "Testing template and timing metadata..." << std::endl;
+
+    const std::string content = R"(xof 0303txt 0032
+template AnimTicksPerSecond {
+    <9E415A43-7BA6-4a73-8743-B73D47E88476>
+    DWORD AnimTicksPerSecond;
+}
+
+AnimTicksPerSecond {
+    30;
+}
+
+Mesh testMesh {
+    3;
+    0.0; 0.0; 0.0;,
+    1.0; 0.0; 0.0;,
+    0.5; 1.0; 0.0;;
+    1;
+    3; 0, 1, 2;;
+}
+)";
+
+    XFileParser parser;
+    parser.SetVerboseLogging(false);
+
+    if (!parser.ParseFromString(content)) {
+        std::cout << "  FAIL: Failed to parse content with metadata objects" << std::endl;
+        return false;
+    }
+
+    const XFileData& data = parser.GetParsedData();
+    if (!data.header.hasAnimationTimingInfo || std::abs(data.header.ticksPerSecond - 30.0f) > 0.001f) {
+        std::cout << "  FAIL: Expected 30 ticks per second, got " << data.header.ticksPerSecond << std::endl;
+        return false;
+    }
+
+    if (data.meshData.GetVertexCount() != 3) {
+        std::cout << "  FAIL: Mesh after metadata objects was not parsed" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Template and timing metadata" << std::endl;
+    return true;
+}
+
+bool TestSkinWeightParsing() {
+    std::cout << "Testing skin weight parsing..." << std::endl;
+
+    const std::string content = R"(xof 0303txt 0032
+Frame Root {
+    FrameTransformMatrix {
+        1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0;;
+    }
+    Frame Arm {
+    }
+    Mesh skinned {
+        3;
+        0.0; 0.0; 0.0;,
+        1.0; 0.0; 0.0;,
+        0.5; 1.0; 0.0;;
+        1;
+        3; 0, 1, 2;;
+        MeshNormals {
+            1;
+            0.0; 0.0; 1.0;;
+            1;
+            3; 0, 0, 0;;
+        }
+        SkinWeights {
+            "Root";
+            3;
+            0, 1, 2;
+            1.0, 0.25, 0.5;
+            1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0;;
+        }
+        SkinWeights {
+            "Arm";
+            2;
+            1, 2;
+            0.75, 0.5;
+            1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0;;
+        }
+    }
+}
+)";
+
+    XFileParser parser;
+    parser.SetVerboseLogging(false);
+
+    if (!parser.ParseFromString(content)) {
+        std::cout << "  FAIL: Failed to parse skinned mesh" << std::endl;
+        return false;
+    }
+
+    const XMeshData& mesh = parser.GetParsedData().meshData;
+    if (mesh.GetBoneCount() != 2 || mesh.bones[1].parentIndex != 0) {
+        std::cout << "  FAIL: Expected bone 'Arm' parented to 'Root'" << std::endl;
+        return false;
+    }
+
+    if (!mesh.HasNormals() || mesh.normals[2].z != 1.0f || !mesh.HasSkinWeights()) {
+        std::cout << "  FAIL: Normal or skin weight streams missing" << std::endl;
+        return false;
+    }
+
+    const XVertexInfluences& influences = mesh.skinInfluences[1];
+    if (influences.GetCount() != 2 || influences.boneIndices[1] != 1 ||
+        std::abs(influences.boneWeights[1] - 0.75f) > 0.001f) {
+        std::cout << "  FAIL: Incorrect influences on vertex 1" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Skin weight parsing" << std::endl;
+    return true;
+}
+
+bool TestTextParserThroughput() {
+    std::cout << "Testing text parser throughput..." << std::endl;
+
+    // Synthetic mesh large enough to time, small enough for a unit test
+    const int gridSize = 200;
+    std::ostringstream content;
+    content << std::fixed << std::setprecision(6);
+    content << "xof 0303txt 0032\n\nMesh grid {\n" << gridSize * gridSize << ";\n";
+    for (int i = 0; i < gridSize * gridSize; i++) {
+        content << (i % gridSize) * 0.5f << "; " << (i / gridSize) * 0.5f << "; " << std::sin(i * 0.01f)
+                << (i + 1 < gridSize * gridSize ? ";,\n" : ";;\n");
+    }
+    int quadCount = (gridSize - 1) * (gridSize - 1);
+    content << quadCount << ";\n";
+    for (int i = 0; i < quadCount; i++) {
+        int v = (i / (gridSize - 1)) * gridSize + i % (gridSize - 1);
+        content << "4; " << v << ", " << v + 1 << ", " << v + gridSize + 1 << ", " << v + gridSize
+                << (i + 1 < quadCount ? ";,\n" : ";;\n");
+    }
+    content << "}\n";
+    const std::string text = content.str();
+
+    XFileParser parser;
+    parser.SetVerboseLogging(false);
+
+    auto start = std::chrono::steady_clock::now();
+    bool parsed = parser.ParseFromString(text);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!parsed) {
+        std::cout << "  FAIL: Failed to parse synthetic mesh" << std::endl;
+        return false;
+    }
+
+    const XMeshData& mesh = parser.GetParsedData().meshData;
+    if (mesh.GetVertexCount() != static_cast<size_t>(gridSize * gridSize) ||
+        mesh.GetFaceCount() != static_cast<size_t>(quadCount * 2)) {
+        std::cout << "  FAIL: Expected " << gridSize * gridSize << " vertices and " << quadCount * 2
+                  << " faces, got " << mesh.GetVertexCount() << " and " << mesh.GetFaceCount() << std::endl;
+        return false;
+    }
+
+    // Scratch memory comes from the parse arena and is reported with the data
+    XFileData data = parser.TakeParsedData();
+    if (data.statistics.arenaPeakBytes == 0 || data.statistics.inputBytes != text.size() ||
+        data.meshData.GetVertexCount() != static_cast<size_t>(gridSize * gridSize)) {
+        std::cout << "  FAIL: Parse statistics missing or data lost when taken" << std::endl;
+        return false;
+    }
+
+    // Timing is informational only; machines vary too much to assert on it
+    double megabytes = text.size() / (1024.0 * 1024.0);
+    std::cout << "  PASS: Text parser throughput (" << std::fixed << std::setprecision(2) << megabytes << " MB in "
+              << seconds * 1000.0 << " ms, " << (seconds > 0 ? megabytes / seconds : 0.0) << " MB/s, "
+              << data.statistics.arenaPeakBytes / 1024.0 << " KB arena peak)" << std::endl;
+    return true;
+}
+
+bool TestParallelTextParsing() {
+    std::cout << "Testing parallel text parsing..." << std::endl;
+
+    // Many independent objects: frames with nested meshes (some unnamed), a
+    // shared top-level material, skin weights and animations that target
+    // frames declared on either side of them
+    std::ostringstream content;
+    content << std::fixed << std::setprecision(4);
+    content << "xof 0303txt 0032\n\nAnimTicksPerSecond { 30; }\n";
+    content << "Material shared { 0.5; 0.5; 0.5; 1.0;; 4.0; 1.0; 1.0; 1.0;; 0.0; 0.0; 0.0;; }\n";
+    content << "AnimationSet { Animation { { Part3 } AnimationKey { 2; 2; 0; 3; 0, 0, 0;; 30; 3; 1, 2, 3;; } } }\n";
+    const int partCount = 12;
+    const int gridSize = 60;
+    for (int part = 0; part < partCount; part++) {
+        std::string name = (part % 4 == 1) ? "" : "Part" + std::to_string(part);
+        content << "Frame " << name << " {\n FrameTransformMatrix { 1,0,0,0, 0,1,0,0, 0,0,1,0, " << part
+                << ",0,0,1;; }\n Frame { }\n Mesh {\n" << gridSize * gridSize << ";\n";
+        for (int i = 0; i < gridSize * gridSize; i++) {
+            content << i % gridSize << "; " << i / gridSize << "; " << part << (i + 1 < gridSize * gridSize ? ";,\n" : ";;\n");
+        }
+        int quads = (gridSize - 1) * (gridSize - 1);
+        content << quads << ";\n";
+        for (int i = 0; i < quads; i++) {
+            int v = (i / (gridSize - 1)) * gridSize + i % (gridSize - 1);
+            content << "4; " << v << ", " << v + 1 << ", " << v + gridSize + 1 << ", " << v + gridSize
+                    << (i + 1 < quads ? ";,\n" : ";;\n");
+        }
+        content << "  MeshMaterialList { 1; 1; 0;; { shared } }\n";
+        if (part % 3 == 0) {
+            content << "  MeshTextureCoords { 1; 0.5; 0.25;; }\n";
+        }
+        content << "  SkinWeights { \"Part0\"; 2; 0, 1; 1.0, 1.0; 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1;; }\n";
+        content << " }\n}\n";
+    }
+    content << "AnimationSet Wave { Animation { { Part0 } AnimationKey { 0; 1; 0; 4; 1, 0, 0, 0;; } } }\n";
+    const std::string text = content.str();
+    if (text.size() < XFileParser::PARALLEL_PARSE_MIN_BYTES) {
+        std::cout << "  FAIL: Test input too small to be split" << std::endl;
+        return false;
+    }
+
+    auto parseWith = [&](size_t threads, bool lazy, XFileData& data) {
+        XFileParser parser;
+        parser.SetParseThreads(threads);
+        parser.SetLazyAnimations(lazy);
+        if (!parser.ParseFromString(text) || !parser.DecodeAnimations({})) {
+            return false;
+        }
+        data = parser.TakeParsedData();
+        data.statistics = XParseStatistics();
+        return true;
+    };
+    auto readAll = [](const char* path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    };
+
+    // Eager and lazy animation decoding, each sequential and on four workers
+    XFileData parallel;
+    for (bool lazy : {false, true}) {
+        XFileData sequential;
+        if (!parseWith(1, lazy, sequential) || !parseWith(4, lazy, parallel)) {
+            std::cout << "  FAIL: Failed to parse multi-object scene" << std::endl;
+            return false;
+        }
+
+        // Identical snapshots mean identical meshes, bones, tracks and messages
+        if (!XFileSnapshot::Write(sequential, "test_parallel_a.x2s") ||
+            !XFileSnapshot::Write(parallel, "test_parallel_b.x2s")) {
+            std::cout << "  FAIL: Could not write snapshots" << std::endl;
+            return false;
+        }
+        bool sameSets = sequential.animationSets.size() == parallel.animationSets.size();
+        for (size_t i = 0; sameSets && i < sequential.animationSets.size(); i++) {
+            sameSets = sequential.animationSets[i].name == parallel.animationSets[i].name &&
+                       sequential.animationSets[i].offset == parallel.animationSets[i].offset &&
+                       sequential.animationSets[i].length == parallel.animationSets[i].length;
+        }
+        if (readAll("test_parallel_a.x2s") != readAll("test_parallel_b.x2s") || !sameSets) {
+            std::cout << "  FAIL: Parallel parse differs from the sequential one"
+                      << (lazy ? " (lazy animations)" : "") << std::endl;
+            return false;
+        }
+    }
+
+    // Lazily decoded tracks find the frames; unnamed frames are numbered
+    // by their bone index
+    const XMeshData& mesh = parallel.meshData;
+    if (mesh.GetVertexCount() != static_cast<size_t>(partCount * gridSize * gridSize) ||
+        mesh.GetAnimationCount() != 2 || mesh.animations[0].name != "Animation_0" ||
+        mesh.GetBoneName(mesh.animations[0].tracks[0].boneId) != "Part3" || mesh.GetBoneName(0) != "Part0" ||
+        mesh.GetBoneName(2) != "Frame_2" || mesh.bones[3].parentIndex != 2 || mesh.FindBone("Frame_2") != 2 ||
+        !mesh.HasSkinWeights()) {
+        std::cout << "  FAIL: Unexpected parallel parse result" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Parallel text parsing (" << partCount << " frames, " << mesh.GetBoneCount() << " bones)"
+              << std::endl;
+    return true;
+}
+
+// Writes binary .x tokens (little-endian, 32- or 64-bit floats)
+class BinaryXWriter {
+public:
+    std::vector<uint8_t> bytes;
+
+    explicit BinaryXWriter(bool withHeader = true, uint32_t floatSize = 32) : floatSize_(floatSize) {
+        if (withHeader) {
+            const std::string header = floatSize == 64 ? "xof 0303bin 0064" : "xof 0303bin 0032";
+            bytes.assign(header.begin(), header.end());
+        }
+    }
+
+    void Token(uint16_t token) { Raw(&token, 2); }
+    void Name(const std::string& name) {
+        Token(BinaryXFileUtils::BINARY_TOKEN_NAME);
+        Count(name.size());
+        Raw(name.data(), name.size());
+    }
+    void String(const std::string& text) {
+        Token(BinaryXFileUtils::BINARY_TOKEN_STRING);
+        Count(text.size());
+        Raw(text.data(), text.size());
+        Token(BinaryXFileUtils::BINARY_TOKEN_SEMICOLON);
+    }
+    void Integers(const std::vector<uint32_t>& values) {
+        Token(BinaryXFileUtils::BINARY_TOKEN_INTEGER_LIST);
+        Count(values.size());
+        Raw(values.data(), values.size() * 4);
+    }
+    void Floats(const std::vector<float>& values) {
+        Token(BinaryXFileUtils::BINARY_TOKEN_FLOAT_LIST);
+        Count(values.size());
+        if (floatSize_ == 64) {
+            std::vector<double> wide(values.begin(), values.end());
+            Raw(wide.data(), wide.size() * 8);
+        } else {
+            Raw(values.data(), values.size() * 4);
+        }
+    }
+    void Open(const std::string& type, const std::string& name = "") {
+        Name(type);
+        if (!name.empty()) Name(name);
+        Token(BinaryXFileUtils::BINARY_TOKEN_OBRACE);
+    }
+    void Close() { Token(BinaryXFileUtils::BINARY_TOKEN_CBRACE); }
+
+private:
+    uint32_t floatSize_;
+
+    void Count(size_t count) {
+        uint32_t value = static_cast<uint32_t>(count);
+        Raw(&value, 4);
+    }
+    void Raw(const void* data, size_t size) {
+        const uint8_t* begin = static_cast<const uint8_t*>(data);
+        bytes.insert(bytes.end(), begin, begin + size);
+    }
+};
+
+// A skinned quad under a frame, with one animation
+void WriteBinaryTestScene(BinaryXWriter& writer) {
+    writer.Token(BinaryXFileUtils::BINARY_TOKEN_TEMPLATE);
+    writer.Name("Vector");
+    writer.Token(BinaryXFileUtils::BINARY_TOKEN_OBRACE);
+    writer.Token(BinaryXFileUtils::BINARY_TOKEN_FLOAT);
+    writer.Name("x");
+    writer.Token(BinaryXFileUtils::BINARY_TOKEN_SEMICOLON);
+    writer.Close();
+
+    writer.Open("AnimTicksPerSecond");
+    writer.Integers({30});
+    writer.Close();
+
+    writer.Open("Frame", "Root");
+    writer.Open("FrameTransformMatrix");
+    writer.Floats({1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 5, 0, 0, 1});
+    writer.Close();
+
+    writer.Open("Mesh", "quad");
+    writer.Integers({4});
+    writer.Floats({0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0});
+    writer.Integers({1, 4, 0, 1, 2, 3});
+
+    writer.Open("MeshTextureCoords");
+    writer.Integers({4});
+    writer.Floats({0, 0, 1, 0, 1, 1, 0, 1});
+    writer.Close();
+
+    writer.Open("MeshMaterialList");
+    writer.Integers({1, 1, 0});
+    writer.Open("Material", "red");
+    writer.Floats({1, 0, 0, 1, 8, 1, 1, 1, 0, 0, 0});
+    writer.Open("TextureFilename");
+    writer.String("red.png");
+    writer.Close();
+    writer.Close();
+    writer.Close();
+
+    writer.Open("SkinWeights");
+    writer.String("Root");
+    writer.Integers({2, 0, 1});
+    writer.Floats({1.0f, 1.0f, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1});
+    writer.Close();
+    writer.Close();   // Mesh
+    writer.Close();   // Frame
+
+    writer.Open("AnimationSet", "Walk");
+    writer.Open("Animation");
+    writer.Token(BinaryXFileUtils::BINARY_TOKEN_OBRACE);
+    writer.Name("Root");
+    writer.Token(BinaryXFileUtils::BINARY_TOKEN_CBRACE);
+    writer.Open("AnimationKey");
+    writer.Integers({2, 2, 0, 3});
+    writer.Floats({0, 0, 0});
+    writer.Integers({60, 3});
+    writer.Floats({2, 0, 0});
+    writer.Close();
+    writer.Close();
+    writer.Close();
+}
+
+bool CheckBinaryTestScene(const XFileData& data, const std::string& label) {
+    const XMeshData& mesh = data.meshData;
+    if (!data.parseSuccessful || mesh.GetVertexCount() != 4 || mesh.GetFaceCount() != 2) {
+        std::cout << "  FAIL: " << label << ": expected 4 vertices and 2 faces, got "
+                  << mesh.GetVertexCount() << " and " << mesh.GetFaceCount() << std::endl;
+        return false;
+    }
+    if (mesh.positions[2].x != 1.0f || mesh.positions[2].y != 1.0f || !mesh.HasTexCoords() ||
+        mesh.texCoords[3].v != 1.0f || mesh.faceMaterials[1] != 0) {
+        std::cout << "  FAIL: " << label << ": incorrect vertex streams" << std::endl;
+        return false;
+    }
+    if (mesh.materials.size() != 1 || mesh.materials[0].diffuseTexture != "red.png" ||
+        mesh.materials[0].shininess != 8.0f) {
+        std::cout << "  FAIL: " << label << ": incorrect material" << std::endl;
+        return false;
+    }
+    if (mesh.GetBoneCount() != 1 || mesh.bones[0].bindPose.m[3][0] != 5.0f || !mesh.HasSkinWeights() ||
+        mesh.skinInfluences[1].boneIndices[0] != 0 || mesh.skinInfluences[2].GetCount() != 0) {
+        std::cout << "  FAIL: " << label << ": incorrect frame or skin weights" << std::endl;
+        return false;
+    }
+    if (mesh.GetAnimationCount() != 1 || mesh.globalTicksPerSecond != 30.0f ||
+        mesh.animations[0].tracks.size() != 1 || mesh.animations[0].tracks[0].boneId != 0 ||
+        mesh.animations[0].tracks[0].translation.GetValue(1, XBoneTrack::VECTOR_COMPONENTS)[0] != 2.0f) {
+        std::cout << "  FAIL: " << label << ": incorrect animation" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool TestBinaryParsing() {
+    std::cout << "Testing binary .x parsing..." << std::endl;
+
+    BinaryXWriter writer;
+    WriteBinaryTestScene(writer);
+
+    BinaryXFileParser parser;
+    if (!parser.ParseBinaryData(writer.bytes) || !CheckBinaryTestScene(parser.GetParsedData(), "in-memory")) {
+        std::cout << "  FAIL: Binary token stream not parsed" << std::endl;
+        return false;
+    }
+
+    // The same tokens pulled through a window far smaller than the input
+    BinaryXWriter body(false);
+    WriteBinaryTestScene(body);
+    MemoryByteSource source(body.bytes);
+    parser.SetStreamingOptions(64, false);
+    if (!parser.ParseBinaryStream(source) || !CheckBinaryTestScene(parser.GetParsedData(), "streamed")) {
+        return false;
+    }
+
+    // 64-bit floats, from a "0064" header or as a headerless payload
+    BinaryXWriter wide(true, 64);
+    WriteBinaryTestScene(wide);
+    if (!parser.ParseBinaryData(wide.bytes) || parser.GetParsedData().header.floatSize != 64 ||
+        !CheckBinaryTestScene(parser.GetParsedData(), "64-bit floats")) {
+        return false;
+    }
+    BinaryXWriter wideBody(false, 64);
+    WriteBinaryTestScene(wideBody);
+    MemoryByteSource wideSource(wideBody.bytes);
+    if (!parser.ParseBinaryStream(wideSource, 64) || !CheckBinaryTestScene(parser.GetParsedData(), "streamed 64-bit")) {
+        return false;
+    }
+
+    // Truncated input fails cleanly
+    writer.bytes.resize(writer.bytes.size() / 2);
+    if (parser.ParseBinaryData(writer.bytes)) {
+        std::cout << "  FAIL: Truncated binary file should fail" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Binary .x parsing" << std::endl;
+    return true;
+}
+
+bool TestBinaryReaderBulkReads() {
+    std::cout << "Testing bulk binary array reads..." << std::endl;
+
+    std::vector<float> values(1000);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<float>(i) * 0.25f - 17.0f;
+    }
+    std::vector<uint8_t> little(values.size() * 4);
+    std::memcpy(little.data(), values.data(), little.size());
+    std::vector<uint8_t> big(little);
+    for (size_t i = 0; i < big.size(); i += 4) {
+        std::swap(big[i], big[i + 3]);
+        std::swap(big[i + 1], big[i + 2]);
+    }
+
+    // In memory, byte-swapped, and streamed through a window far smaller than the array
+    std::vector<float> direct(values.size());
+    BinaryReader reader(little.data(), little.size());
+    reader.ReadFloats(direct.data(), direct.size());
+
+    BinaryReader swapped(big.data(), big.size(), false);
+    std::vector<float> fromBigEndian = swapped.ReadFloatArray(values.size());
+
+    MemoryByteSource source(little);
+    BinaryReader streamed(source, 64);
+    std::vector<float> fromStream(values.size());
+    streamed.ReadFloats(fromStream.data(), 3);
+    streamed.ReadFloats(fromStream.data() + 3, fromStream.size() - 3);
+
+    if (direct != values || fromBigEndian != values || fromStream != values || !streamed.IsAtEnd()) {
+        std::cout << "  FAIL: Bulk reads do not match the source floats" << std::endl;
+        return false;
+    }
+
+    BinaryReader truncated(little.data(), little.size());
+    try {
+        truncated.ReadUInt32Array(values.size() + 1);
+        std::cout << "  FAIL: Reading past the end should throw" << std::endl;
+        return false;
+    } catch (const std::runtime_error&) {
+    }
+    if (truncated.GetPosition() != 0) {
+        std::cout << "  FAIL: Failed bulk read should not consume input" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Bulk binary array reads" << std::endl;
+    return true;
+}
+
+bool TestBinaryTemplateDispatch() {
+    std::cout << "Testing binary template dispatch..." << std::endl;
+
+    using BinaryXFileUtils::XTemplate;
+    for (size_t i = 1; i < static_cast<size_t>(XTemplate::COUNT); i++) {
+        XTemplate id = static_cast<XTemplate>(i);
+        if (BinaryXFileUtils::FindStandardTemplate(BinaryXFileUtils::GetTemplateName(id)) != id) {
+            std::cout << "  FAIL: " << BinaryXFileUtils::GetTemplateName(id) << " does not resolve to itself" << std::endl;
+            return false;
+        }
+    }
+    if (BinaryXFileUtils::FindStandardTemplate("TextureFileName") != XTemplate::TEXTURE_FILENAME ||
+        BinaryXFileUtils::FindStandardTemplate("NormalMapFilename") != XTemplate::NORMALMAP_FILENAME ||
+        BinaryXFileUtils::FindStandardTemplate("mesh") != XTemplate::CUSTOM ||
+        BinaryXFileUtils::FindStandardTemplate("MeshX") != XTemplate::CUSTOM ||
+        BinaryXFileUtils::FindStandardTemplate("") != XTemplate::CUSTOM) {
+        std::cout << "  FAIL: Variants or custom names resolve to the wrong template" << std::endl;
+        return false;
+    }
+
+    // {3D82AB44-62DA-11CF-AB39-0020AF71E433} as stored in a file
+    const uint8_t meshGuid[16] = {0x44, 0xAB, 0x82, 0x3D, 0xDA, 0x62, 0xCF, 0x11,
+                                  0xAB, 0x39, 0x00, 0x20, 0xAF, 0x71, 0xE4, 0x33};
+    uint8_t guid[16];
+    if (!BinaryXFileUtils::GetTemplateGuid(XTemplate::MESH, guid) || std::memcmp(guid, meshGuid, 16) != 0 ||
+        BinaryXFileUtils::GetTemplateGuid(XTemplate::NORMALMAP_FILENAME, guid) ||
+        BinaryXFileUtils::GetTemplateGuid(XTemplate::CUSTOM, guid)) {
+        std::cout << "  FAIL: Incorrect standard template GUIDs" << std::endl;
+        return false;
+    }
+
+    // A custom template and object around the scene, and a Mesh
+    // redeclaration with a foreign GUID
+    BinaryXWriter writer;
+    writer.Token(BinaryXFileUtils::BINARY_TOKEN_TEMPLATE);
+    writer.Name("Mesh");
+    writer.Token(BinaryXFileUtils::BINARY_TOKEN_OBRACE);
+    writer.Token(BinaryXFileUtils::BINARY_TOKEN_GUID);
+    std::vector<uint8_t> foreignGuid(16, 0x5A);
+    writer.bytes.insert(writer.bytes.end(), foreignGuid.begin(), foreignGuid.end());
+    writer.Close();
+    writer.Open("GameProps", "props");
+    writer.Integers({7});
+    writer.Open("Mesh", "nested");
+    writer.Integers({0, 0});
+    writer.Close();
+    writer.Close();
+    WriteBinaryTestScene(writer);
+
+    BinaryXFileParser parser;
+    if (!parser.ParseBinaryData(writer.bytes) ||
+        !CheckBinaryTestScene(parser.GetParsedData(), "custom templates")) {
+        return false;
+    }
+    const auto& warnings = parser.GetParsedData().parseWarnings;
+    if (warnings.size() != 1 || warnings[0].find("another GUID") == std::string::npos) {
+        std::cout << "  FAIL: Expected one warning for the redefined Mesh template" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Binary template dispatch" << std::endl;
+    return true;
+}
+
+bool TestStreamingDecompression() {
+    std::cout << "Testing streaming decompression..." << std::endl;
+
+#ifdef HAVE_ZLIB
+    // Compressed payload with its own binary header, as a decompressor would produce it
+    BinaryXWriter writer;
+    WriteBinaryTestScene(writer);
+
+    uLongf compressedSize = compressBound(writer.bytes.size());
+    std::vector<uint8_t> compressed(compressedSize);
+    if (compress2(compressed.data(), &compressedSize, writer.bytes.data(), writer.bytes.size(), 9) != Z_OK) {
+        std::cout << "  FAIL: Could not compress test payload" << std::endl;
+        return false;
+    }
+    compressed.resize(compressedSize);
+
+    // Decompression runs on its own thread with tiny chunks, so the parser
+    // has to wait on the producer many times
+    auto inflater = std::make_unique<InflateByteSource>(compressed, 15);
+    ThreadedByteSource threaded(std::move(inflater), 4096, 2);
+
+    BinaryXFileParser parser;
+    parser.SetStreamingOptions(128, false);
+    if (!parser.ParseBinaryStream(threaded) || !CheckBinaryTestScene(parser.GetParsedData(), "threaded")) {
+        return false;
+    }
+    if (parser.GetParsedData().statistics.inputBytes != writer.bytes.size()) {
+        std::cout << "  FAIL: Expected " << writer.bytes.size() << " streamed bytes, got "
+                  << parser.GetParsedData().statistics.inputBytes << std::endl;
+        return false;
+    }
+
+    // A corrupt stream surfaces as a parse error instead of a crash
+    compressed[compressed.size() / 2] ^= 0xFF;
+    InflateByteSource corrupt(compressed, 15);
+    if (parser.ParseBinaryStream(corrupt)) {
+        std::cout << "  FAIL: Corrupt deflate stream should fail" << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> drained;
+    XFileDecompressor decompressor;
+    compressed[compressed.size() / 2] ^= 0xFF;
+    if (!decompressor.DecompressZipped(compressed, drained) || drained != writer.bytes) {
+        std::cout << "  FAIL: Drained stream does not match the original payload" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Streaming decompression" << std::endl;
+#else
+    std::cout << "  SKIP: zlib support not compiled in" << std::endl;
+#endif
+    return true;
+}
+
+#ifdef HAVE_ZLIB
+// Compresses a payload the way D3DX writes tzip/bzip files: 32 KB blocks,
+// each deflated with the previous 32 KB as its dictionary
+std::vector<uint8_t> WriteMszipFile(const std::string& format, const std::vector<uint8_t>& payload) {
+    const std::string header = "xof 0303" + format + "0032";
+    std::vector<uint8_t> file(header.begin(), header.end());
+
+    uint32_t declaredSize = static_cast<uint32_t>(payload.size() + 16);
+    file.insert(file.end(), reinterpret_cast<uint8_t*>(&declaredSize), reinterpret_cast<uint8_t*>(&declaredSize) + 4);
+
+    for (size_t offset = 0; offset < payload.size(); offset += Mszip::HISTORY_SIZE) {
+        size_t blockSize = std::min(Mszip::HISTORY_SIZE, payload.size() - offset);
+        size_t historySize = std::min(Mszip::HISTORY_SIZE, offset);
+
+        z_stream stream{};
+        deflateInit2(&stream, 9, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        if (historySize > 0) {
+            deflateSetDictionary(&stream, payload.data() + offset - historySize, static_cast<uInt>(historySize));
+        }
+        std::vector<uint8_t> block(deflateBound(&stream, blockSize));
+        stream.next_in = const_cast<Bytef*>(payload.data() + offset);
+        stream.avail_in = static_cast<uInt>(blockSize);
+        stream.next_out = block.data();
+        stream.avail_out = static_cast<uInt>(block.size());
+        deflate(&stream, Z_FINISH);
+        block.resize(stream.total_out);
+        deflateEnd(&stream);
+
+        uint16_t sizes[2] = {static_cast<uint16_t>(blockSize), static_cast<uint16_t>(block.size() + 2)};
+        file.insert(file.end(), reinterpret_cast<uint8_t*>(sizes), reinterpret_cast<uint8_t*>(sizes) + 4);
+        file.push_back('C');
+        file.push_back('K');
+        file.insert(file.end(), block.begin(), block.end());
+    }
+    return file;
+}
+#endif
+
+bool TestMszipDecompression() {
+    std::cout << "Testing MSZIP decompression..." << std::endl;
+
+#ifdef HAVE_ZLIB
+    // Text spanning several blocks, repetitive enough that later blocks
+    // reference earlier ones
+    std::ostringstream content;
+    const int vertexCount = 4000;
+    content << "\nMesh strip {\n" << vertexCount << ";\n";
+    for (int i = 0; i < vertexCount; i++) {
+        content << i % 100 << ".000000; " << i / 100 << ".000000; 0.000000" << (i + 1 < vertexCount ? ";,\n" : ";;\n");
+    }
+    content << vertexCount / 2 - 1 << ";\n";
+    for (int i = 0; i + 2 < vertexCount; i += 2) {
+        content << "3; " << i << ", " << i + 1 << ", " << i + 2 << (i + 4 < vertexCount ? ";,\n" : ";;\n");
+    }
+    content << "}\n";
+    const std::string text = content.str();
+    std::vector<uint8_t> textFile = WriteMszipFile("tzip", std::vector<uint8_t>(text.begin(), text.end()));
+
+    BinaryXFileParser parser;
+    if (!parser.ParseCompressedData(textFile) ||
+        parser.GetParsedData().meshData.GetVertexCount() != static_cast<size_t>(vertexCount)) {
+        std::cout << "  FAIL: tzip payload not parsed" << std::endl;
+        return false;
+    }
+
+    BinaryXWriter body(false);
+    WriteBinaryTestScene(body);
+    std::vector<uint8_t> binaryFile = WriteMszipFile("bzip", body.bytes);
+    if (!parser.ParseCompressedData(binaryFile) || !CheckBinaryTestScene(parser.GetParsedData(), "bzip")) {
+        return false;
+    }
+    if (parser.GetParsedData().statistics.decompressionMethod != "mszip" ||
+        parser.GetParsedData().statistics.decompressionAttempts == 0) {
+        std::cout << "  FAIL: Decompression method not recorded: "
+                  << parser.GetParsedData().statistics.decompressionMethod << std::endl;
+        return false;
+    }
+
+    // Parallel decoding matches the streamed blocks
+    ByteView payload = ByteView(textFile).Subview(16);
+    MszipByteSource streamed(payload);
+    std::vector<uint8_t> sequential;
+    std::vector<uint8_t> parallel;
+    std::string error;
+    if (streamed.GetBlockCount() < 4 || !ReadAllBytes(streamed, sequential) ||
+        !Mszip::DecodeParallel(payload, parallel, 4, error) || parallel != sequential ||
+        std::string(sequential.begin(), sequential.end()) != text) {
+        std::cout << "  FAIL: Parallel and streamed MSZIP output differ " << error << std::endl;
+        return false;
+    }
+
+    parser.SetDecompressionWorkers(4);
+    if (!parser.ParseCompressedData(binaryFile) || !CheckBinaryTestScene(parser.GetParsedData(), "bzip parallel")) {
+        return false;
+    }
+
+    // A damaged block table is rejected up front
+    std::vector<Mszip::Block> blocks;
+    size_t decompressedSize = 0;
+    textFile[16 + 4 + 4] = 'X';
+    if (Mszip::ReadBlockTable(ByteView(textFile).Subview(16), blocks, decompressedSize, error) ||
+        parser.ParseCompressedData(textFile)) {
+        std::cout << "  FAIL: Missing CK signature should fail" << std::endl;
+        return false;
+    }
+    textFile[16 + 4 + 4] = 'C';
+    textFile[16] ^= 0x01;
+    if (Mszip::ReadBlockTable(ByteView(textFile).Subview(16), blocks, decompressedSize, error)) {
+        std::cout << "  FAIL: Size mismatch should fail" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: MSZIP decompression (" << streamed.GetBlockCount() << " blocks)" << std::endl;
+#else
+    std::cout << "  SKIP: zlib support not compiled in" << std::endl;
+#endif
+    return true;
+}
+
+bool TestDecompressionLimits() {
+    std::cout << "Testing decompression limits..." << std::endl;
+
+#ifdef HAVE_ZLIB
+    BinaryXWriter body(false);
+    WriteBinaryTestScene(body);
+    std::vector<uint8_t> binaryFile = WriteMszipFile("bzip", body.bytes);
+    DecompressionLimits limits;
+    limits.maxOutputBytes = body.bytes.size() + 16;
+    limits.maxSeconds = 60.0;
+    BinaryXFileParser parser;
+    parser.SetDecompressionLimits(limits);
+    if (!parser.ParseCompressedData(binaryFile) || !CheckBinaryTestScene(parser.GetParsedData(), "bzip limited")) {
+        return false;
+    }
+
+    // Payloads that cannot be .x data are rejected after the first block
+    std::vector<uint8_t> noise(256 * 1024);
+    for (size_t i = 0; i < noise.size(); i++) {
+        noise[i] = static_cast<uint8_t>((i * 2654435761u) >> 13);
+    }
+    std::vector<uint8_t> noiseFile = WriteMszipFile("bzip", noise);
+    auto inner = std::make_unique<MszipByteSource>(ByteView(noiseFile).Subview(16));
+    MszipByteSource* innerStream = inner.get();
+    LimitedByteSource checked(std::move(inner), 0, std::chrono::steady_clock::time_point::max(), 4096,
+                              [](ByteView prefix, std::string& error) {
+                                  return XFileDecompressor::CheckPayloadPrefix(prefix, 32, false, error);
+                              });
+    uint8_t byte = 0;
+    bool rejectedEarly = checked.Read(&byte, 1) == 0 && checked.GetError().find("not .x binary") != std::string::npos &&
+                         innerStream->GetBytesProduced() <= Mszip::HISTORY_SIZE;
+    parser.SetDecompressionLimits(DecompressionLimits());
+    std::vector<uint8_t> binaryAsText = WriteMszipFile("tzip", body.bytes);
+    bool textRejected = !parser.ParseCompressedData(binaryAsText) &&
+                        parser.GetParsedData().parseErrors.back().find("not .x text") != std::string::npos;
+    parser.SetDecompressionWorkers(4);
+    bool parallelRejected = !parser.ParseCompressedData(noiseFile) &&
+                            parser.GetParsedData().parseErrors.back().find("MSZIP payload rejected") != std::string::npos;
+    parser.SetDecompressionWorkers(1);
+    if (!rejectedEarly || !textRejected || !parallelRejected) {
+        std::cout << "  FAIL: Non-.x payloads not rejected early (" << innerStream->GetBytesProduced()
+                  << " bytes inflated)" << std::endl;
+        return false;
+    }
+
+    // Prefixes ending inside a token pass; a bad first token does not
+    std::vector<uint8_t> truncatedName = {BinaryXFileUtils::BINARY_TOKEN_NAME, 0, 200, 0, 0, 0, 'M', 'e'};
+    std::vector<uint8_t> integerFirst = {BinaryXFileUtils::BINARY_TOKEN_INTEGER, 0, 1, 0, 0, 0};
+    std::string error;
+    if (!XFileDecompressor::CheckPayloadPrefix(truncatedName, 32, false, error) ||
+        XFileDecompressor::CheckPayloadPrefix(integerFirst, 32, false, error)) {
+        std::cout << "  FAIL: Binary token prefix check incorrect" << std::endl;
+        return false;
+    }
+
+    // Size and time caps, streamed and parallel
+    limits.maxOutputBytes = body.bytes.size() / 2;
+    parser.SetDecompressionLimits(limits);
+    bool sizeCapped = !parser.ParseCompressedData(binaryFile);
+    parser.SetDecompressionWorkers(4);
+    sizeCapped = sizeCapped && !parser.ParseCompressedData(binaryFile);
+    parser.SetDecompressionWorkers(1);
+    limits.maxOutputBytes = 0;
+    limits.maxSeconds = 1e-9;
+    parser.SetDecompressionLimits(limits);
+    bool timeCapped = !parser.ParseCompressedData(binaryFile) &&
+                      parser.GetParsedData().parseErrors.back().find("time limit") != std::string::npos;
+    if (!sizeCapped || !timeCapped) {
+        std::cout << "  FAIL: Decompression size or time limit not enforced" << std::endl;
+        return false;
+    }
+
+    // DirectX LZ stops an attempt once its output cannot start a .x file
+    std::vector<uint8_t> lz = {0x60, 0x87, 0x03, 0x00};
+    const std::string lzText = "xof 0303txt 0032\n" + std::string(200, ' ');
+    for (size_t i = 0; i < lzText.size(); i += 8) {
+        lz.push_back(0xFF);
+        lz.insert(lz.end(), lzText.begin() + i, lzText.begin() + std::min(i + 8, lzText.size()));
+    }
+    std::vector<uint8_t> lzOutput;
+    XFileDecompressor decompressor;
+    bool lzDecoded = decompressor.DecompressDirectXLZ(lz, lzOutput) && lzOutput.size() == lzText.size();
+    std::fill(lz.begin() + 5, lz.begin() + 13, 'z');
+    limits.maxSeconds = 0.0;
+    decompressor.SetLimits(limits);
+    bool lzRejected = !decompressor.DecompressDirectXLZ(lz, lzOutput) && lzOutput.size() < 64;
+    if (!lzDecoded || !lzRejected) {
+        std::cout << "  FAIL: DirectX LZ early rejection incorrect (" << lzOutput.size() << " bytes)" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Decompression limits" << std::endl;
+#else
+    std::cout << "  SKIP: zlib support not compiled in" << std::endl;
+#endif
+    return true;
+}
+
 // Cleanup function
+bool TestLazyAnimationDecoding() {
+    std::cout << "Testing lazy animation decoding..." << std::endl;
+
+    // Two sets; the second one targets a frame with rotation and position keys
+    std::string content = ANIMATED_MESH_X_FILE + R"(
+AnimationSet Run {
+    Animation {
+        { Hips }
+        AnimationKey {
+            0;
+            2;
+            0; 4; 1.0, 0.0, 0.0, 0.0;;
+            30; 4; 1.0, 0.0, 0.0, 0.0;;
+        }
+        AnimationKey {
+            2;
+            1;
+            0; 3; 0.0, 1.0, 0.0;;
+        }
+    }
+}
+)";
+
+    // Unselected sets are indexed with their key counts but not decoded
+    XFileParser parser;
+    parser.SetAnimationFilter({"Run"});
+    if (!parser.ParseFromString(content)) {
+        std::cout << "  FAIL: Failed to parse filtered file" << std::endl;
+        return false;
+    }
+    const XFileData& filtered = parser.GetParsedData();
+    if (filtered.animationSets.size() != 2 || filtered.meshData.GetAnimationCount() != 1 ||
+        filtered.meshData.animations[0].name != "Run" || filtered.animationSets[0].decoded ||
+        filtered.animationSets[0].keyCount != 3 || filtered.animationSets[0].trackCount != 1 ||
+        !filtered.animationSets[1].decoded || filtered.animationSets[1].keyCount != 3) {
+        std::cout << "  FAIL: Animation filter did not index the sets" << std::endl;
+        return false;
+    }
+
+    // Lazy mode decodes on request from the retained input
+    EnhancedXFileParser enhanced;
+    enhanced.SetLazyAnimations(true);
+    ByteView input(reinterpret_cast<const uint8_t*>(content.data()), content.size());
+    if (!enhanced.ParseFromData(input) || enhanced.GetParsedData().meshData.GetAnimationCount() != 0 ||
+        !enhanced.DecodeAnimations({"Run"})) {
+        std::cout << "  FAIL: Lazy parse did not defer the animation sets" << std::endl;
+        return false;
+    }
+    XFileData lazy = enhanced.TakeParsedData();
+    const XMeshData& mesh = lazy.meshData;
+    if (mesh.GetAnimationCount() != 1 || mesh.animations[0].tracks.size() != 1 ||
+        mesh.animations[0].tracks[0].rotation.GetKeyCount() != 2 ||
+        mesh.animations[0].tracks[0].translation.GetKeyCount() != 1 ||
+        mesh.animations[0].tracks[0].boneId < 0 || mesh.GetBoneName(mesh.animations[0].tracks[0].boneId) != "Hips" ||
+        !lazy.animationSets[1].decoded || lazy.animationSets[0].decoded) {
+        std::cout << "  FAIL: Lazily decoded set differs from the file" << std::endl;
+        return false;
+    }
+
+    // Binary sets are decoded from the same byte range
+    BinaryXWriter writer;
+    WriteBinaryTestScene(writer);
+    BinaryXFileParser binary;
+    binary.SetLazyAnimations(true);
+    if (!binary.ParseBinaryData(writer.bytes) || binary.GetParsedData().meshData.GetAnimationCount() != 0 ||
+        binary.GetParsedData().animationSets.size() != 1 || binary.GetParsedData().animationSets[0].keyCount != 2 ||
+        !binary.DecodeAnimations({}) || !CheckBinaryTestScene(binary.GetParsedData(), "lazy binary")) {
+        std::cout << "  FAIL: Lazy binary animation set not decoded" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Lazy animation decoding" << std::endl;
+    return true;
+}
+
+bool TestSnapshotRoundTrip() {
+    std::cout << "Testing parsed-data snapshots..." << std::endl;
+
+    XFileParser parser;
+    parser.SetVerboseLogging(false);
+    if (!parser.ParseFromString(ANIMATED_MESH_X_FILE)) {
+        std::cout << "  FAIL: Failed to parse animated mesh" << std::endl;
+        return false;
+    }
+    XFileData original = parser.TakeParsedData();
+    XMaterial material;
+    material.name = "snapshotMaterial";
+    material.diffuseColor = XVector3(0.25f, 0.5f, 1.0f);
+    material.shininess = 8.0f;
+    material.transparency = 0.0f;
+    material.diffuseTexture = "skin.png";
+    original.meshData.materials.push_back(material);
+    original.meshData.AddBone("Root");
+    original.meshData.AddBone("Arm");
+    original.meshData.bones[1].parentIndex = 0;
+    original.meshData.bones[0].childIndices.push_back(1);
+    original.meshData.EnsureSkinInfluences();
+    original.meshData.skinInfluences[2].Add(1, 0.75f);
+    original.metadata["author"] = "snapshot test";
+    original.meshes.push_back(original.meshData.Clone());
+    original.meshes[0].name = "second";
+
+    if (!XFileSnapshot::Write(original, "test_snapshot.x2s")) {
+        std::cout << "  FAIL: Could not write snapshot" << std::endl;
+        return false;
+    }
+
+    // The enhanced parser recognizes the snapshot and skips parsing
+    EnhancedXFileParser enhanced;
+    if (!enhanced.ParseFile("test_snapshot.x2s")) {
+        std::cout << "  FAIL: Could not load snapshot" << std::endl;
+        return false;
+    }
+    XFileData loaded = enhanced.TakeParsedData();
+    const XMeshData& mesh = loaded.meshData;
+    const XAnimationChannel& originalKeys = original.meshData.animations[0].tracks[0].translation;
+    const XAnimationChannel& loadedKeys = mesh.animations.empty() || mesh.animations[0].tracks.empty() ?
+        XAnimationChannel() : mesh.animations[0].tracks[0].translation;
+    if (mesh.name != original.meshData.name || mesh.positions.size() != 3 || mesh.positions[2].x != 0.5f ||
+        mesh.indices != original.meshData.indices || mesh.faceMaterials != original.meshData.faceMaterials ||
+        mesh.materials.size() != 1 || mesh.materials[0].diffuseTexture != "skin.png" ||
+        mesh.materials[0].diffuseColor.y != 0.5f || mesh.bones.size() != 2 || mesh.GetBoneName(1) != "Arm" ||
+        mesh.FindBone("Arm") != 1 || mesh.bones[0].childIndices.size() != 1 || mesh.skinInfluences.size() != 3 ||
+        mesh.skinInfluences[2].boneWeights[0] != 0.75f || loadedKeys.times != originalKeys.times ||
+        loadedKeys.values != originalKeys.values || mesh.animations[0].name != "testAnimation" ||
+        loaded.meshes.size() != 1 || loaded.meshes[0].name != "second" ||
+        loaded.metadata["author"] != "snapshot test" || loaded.parseSuccessful != original.parseSuccessful) {
+        std::cout << "  FAIL: Snapshot did not round-trip the parsed data" << std::endl;
+        return false;
+    }
+
+    // A truncated snapshot is rejected rather than read past its end
+    std::vector<uint8_t> bytes;
+    {
+        std::ifstream in("test_snapshot.x2s", std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    bytes.resize(bytes.size() - 16);
+    XFileSnapshotView view;
+    XFileData rejected;
+    if (view.Open(bytes) && view.Load(rejected)) {
+        std::cout << "  FAIL: Truncated snapshot accepted" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Snapshot round trip (" << bytes.size() + 16 << " bytes)" << std::endl;
+    return true;
+}
+
+bool TestQuantizedSnapshot() {
+    std::cout << "Testing quantized streams and snapshots..." << std::endl;
+
+    XFileParser parser;
+    parser.SetVerboseLogging(false);
+    if (!parser.ParseFromString(ANIMATED_MESH_X_FILE)) {
+        std::cout << "  FAIL: Failed to parse animated mesh" << std::endl;
+        return false;
+    }
+    XFileData data = parser.TakeParsedData();
+    XMeshData& mesh = data.meshData;
+    mesh.normals = {XVector3(0.0f, 0.0f, 1.0f), XVector3(0.6f, 0.0f, -0.8f), XVector3(-0.48f, 0.6f, -0.64f)};
+    mesh.texCoords = {XVector2(0.0f, 0.0f), XVector2(1.0f, 0.25f), XVector2(0.3f, 1.0f)};
+    XAnimationChannel& rotation = mesh.animations[0].tracks[0].rotation;
+    const float turn[4] = {0.0f, 0.38268343f, 0.0f, -0.92387953f};
+    const float tilt[4] = {0.5f, -0.5f, 0.5f, 0.5f};
+    rotation.AddKey(0.0f, turn, XBoneTrack::ROTATION_COMPONENTS);
+    rotation.AddKey(4800.0f, tilt, XBoneTrack::ROTATION_COMPONENTS);
+    if (!XFileSnapshot::Write(data, "test_snapshot_float.x2s")) {
+        std::cout << "  FAIL: Could not write float snapshot" << std::endl;
+        return false;
+    }
+
+    QuantizationResult quantized = StreamQuantizer().Quantize(data);
+    if (quantized.vertices != 3 || quantized.rotationKeys != 2 || quantized.maxPositionError > 1e-4 ||
+        quantized.maxTexCoordError > 1e-4 || quantized.maxNormalErrorDegrees > 0.01 ||
+        quantized.maxRotationErrorDegrees > 0.001 || quantized.quantizedBytes >= quantized.floatBytes) {
+        std::cout << "  FAIL: Quantization error bounds out of range" << std::endl;
+        return false;
+    }
+
+    // Quantized data is stored and reloaded without further loss
+    if (!XFileSnapshot::Write(data, "test_snapshot.x2s", true)) {
+        std::cout << "  FAIL: Could not write quantized snapshot" << std::endl;
+        return false;
+    }
+    XFileData loaded;
+    if (!XFileSnapshot::Read("test_snapshot.x2s", loaded)) {
+        std::cout << "  FAIL: Could not read quantized snapshot" << std::endl;
+        return false;
+    }
+    const XMeshData& reloaded = loaded.meshData;
+    auto sameBytes = [](const auto& a, const auto& b) {
+        return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(a[0])) == 0;
+    };
+    std::error_code ec;
+    if (!sameBytes(reloaded.positions, mesh.positions) || !sameBytes(reloaded.normals, mesh.normals) ||
+        !sameBytes(reloaded.texCoords, mesh.texCoords) || reloaded.indices != mesh.indices ||
+        reloaded.animations.empty() || reloaded.animations[0].tracks[0].rotation.values != rotation.values ||
+        reloaded.animations[0].tracks[0].translation.values != mesh.animations[0].tracks[0].translation.values ||
+        std::filesystem::file_size("test_snapshot.x2s", ec) >= std::filesystem::file_size("test_snapshot_float.x2s", ec)) {
+        std::cout << "  FAIL: Quantized snapshot did not round-trip" << std::endl;
+        return false;
+    }
+
+    std::cout << "  PASS: Quantized streams (max position error " << quantized.maxPositionError << ", rotation "
+              << quantized.maxRotationErrorDegrees << " deg)" << std::endl;
+    return true;
+}
+
 void CleanupTestFiles() {
     std::remove("test_simple.x");
     std::remove("test_animated.x");
     std::remove("test_materials.x");
     std::remove("test_invalid.x");
     std::remove("test_malformed.x");
+    std::remove("test_snapshot.x2s");
+    std::remove("test_snapshot_float.x2s");
+    std::remove("test_parallel_a.x2s");
+    std::remove("test_parallel_b.x2s");
 }
 
 // Main test runner
@@ -426,6 +1568,20 @@ bool RunAllXFileParserTests() {
     allPassed &= TestFileValidation();
     allPassed &= TestErrorHandling();
     allPassed &= TestEnhancedParser();
+    allPassed &= TestTokenizer();
+    allPassed &= TestMetadataObjects();
+    allPassed &= TestSkinWeightParsing();
+    allPassed &= TestTextParserThroughput();
+    allPassed &= TestParallelTextParsing();
+    allPassed &= TestBinaryParsing();
+    allPassed &= TestBinaryReaderBulkReads();
+    allPassed &= TestBinaryTemplateDispatch();
+    allPassed &= TestStreamingDecompression();
+    allPassed &= TestMszipDecompression();
+    allPassed &= TestDecompressionLimits();
+    allPassed &= TestLazyAnimationDecoding();
+    allPassed &= TestSnapshotRoundTrip();
+    allPassed &= TestQuantizedSnapshot();
 
     // Cleanup
     CleanupTestFiles();